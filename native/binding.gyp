@@ -9,6 +9,17 @@
         "chunker/src/chunker.cpp",
         "chunker/src/tokenizer.cpp",
         "chunker/src/boundaries.cpp",
+        "chunker/src/stream.cpp",
+        "chunker/src/cache.cpp",
+        "chunker/src/export.cpp",
+        "chunker/src/normalize.cpp",
+        "chunker/src/structure.cpp",
+        "chunker/src/symbols.cpp",
+        "chunker/src/xref.cpp",
+        "chunker/src/ast.cpp",
+        "chunker/src/parse_cache.cpp",
+        "chunker/src/symbol_table.cpp",
+        "chunker/src/pack.cpp",
         "chunker/src/binding.cpp"
       ],
       "include_dirs": [
@@ -52,6 +63,8 @@
         "indexer/src/indexer.cpp",
         "indexer/src/hasher.cpp",
         "indexer/src/merkle.cpp",
+        "indexer/src/shared_index.cpp",
+        "indexer/src/merge.cpp",
         "indexer/src/binding.cpp"
       ],
       "include_dirs": [
@@ -63,6 +76,53 @@
         "NAPI_VERSION=8",
         "NAPI_DISABLE_CPP_EXCEPTIONS"
       ],
+      "conditions": [
+        ["OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1,
+              "AdditionalOptions": ["/std:c++17", "/O2", "/EHsc"]
+            }
+          },
+          "defines": ["_CRT_SECURE_NO_WARNINGS"]
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LIBRARY": "libc++",
+            "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+            "MACOSX_DEPLOYMENT_TARGET": "10.15"
+          }
+        }],
+        ["OS=='linux'", {
+          "cflags_cc": ["-fexceptions"],
+          "libraries": ["-lrt"]
+        }]
+      ]
+    },
+    {
+      "target_name": "archicore_graph",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "cflags_cc": ["-std=c++17", "-O3", "-Wall", "-Wextra"],
+      "sources": [
+        "graph/src/reachability.cpp",
+        "graph/src/analytics.cpp",
+        "graph/src/cycles.cpp",
+        "graph/src/rules.cpp",
+        "graph/src/export.cpp",
+        "graph/src/import.cpp",
+        "graph/src/binding.cpp"
+      ],
+      "include_dirs": [
+        "<!@(node -p \"require('node-addon-api').include\")",
+        "common/include",
+        "graph/include"
+      ],
+      "defines": [
+        "NAPI_VERSION=8",
+        "NAPI_DISABLE_CPP_EXCEPTIONS"
+      ],
       "conditions": [
         ["OS=='win'", {
           "msvs_settings": {
@@ -86,5 +146,63 @@
         }]
       ]
     }
+  ],
+  "conditions": [
+    ["OS!='win'", {
+      "targets": [
+        {
+          "target_name": "archicore_daemon",
+          "type": "executable",
+          "cflags!": ["-fno-exceptions"],
+          "cflags_cc!": ["-fno-exceptions"],
+          "cflags_cc": ["-std=c++17", "-O3", "-Wall", "-Wextra"],
+          "sources": [
+            "daemon/src/protocol.cpp",
+            "daemon/src/watcher.cpp",
+            "daemon/src/daemon.cpp",
+            "daemon/src/main.cpp",
+            "indexer/src/indexer.cpp",
+            "indexer/src/hasher.cpp",
+            "indexer/src/merkle.cpp",
+            "indexer/src/shared_index.cpp",
+            "chunker/src/chunker.cpp",
+            "chunker/src/tokenizer.cpp",
+            "chunker/src/boundaries.cpp",
+            "chunker/src/stream.cpp",
+            "chunker/src/cache.cpp",
+            "chunker/src/export.cpp",
+            "chunker/src/normalize.cpp",
+            "chunker/src/structure.cpp",
+            "chunker/src/symbols.cpp",
+            "chunker/src/xref.cpp",
+            "chunker/src/ast.cpp",
+            "chunker/src/parse_cache.cpp",
+            "chunker/src/symbol_table.cpp",
+            "chunker/src/pack.cpp"
+          ],
+          "include_dirs": [
+            "common/include",
+            "indexer/include",
+            "chunker/include",
+            "daemon/include"
+          ],
+          "libraries": ["-lpthread"],
+          "conditions": [
+            ["OS=='mac'", {
+              "xcode_settings": {
+                "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+                "CLANG_CXX_LIBRARY": "libc++",
+                "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+                "MACOSX_DEPLOYMENT_TARGET": "10.15"
+              }
+            }],
+            ["OS=='linux'", {
+              "cflags_cc": ["-fexceptions"],
+              "libraries": ["-lrt"]
+            }]
+          ]
+        }
+      ]
+    }]
   ]
 }
@@ -9,6 +9,8 @@
  * - Semantic boundary detection (functions, classes, blocks)
  * - tiktoken-compatible token counting
  * - Metadata for each chunk (line numbers, type, context)
+ * - Identifier cross-reference index (definitions, imports, references)
+ * - Compact arena storage for parsed syntax trees
  */
 
 #ifndef ARCHICORE_CHUNKER_H
@@ -35,6 +37,16 @@ struct ChunkerConfig {
     bool include_context = true;           // Include context from parent scope
     bool preserve_imports = true;          // Keep imports with related code
     Language language = Language::UNKNOWN; // Source language (auto-detect if UNKNOWN)
+    uint32_t stream_window_bytes = 1024 * 1024;  // ChunkStream window size
+    uint32_t stream_lookahead_bytes = 64 * 1024; // Look-ahead for window cut point
+    bool embed_text = false;               // Build embedding text for each chunk
+    bool embed_strip_comments = true;      // Drop comments from embedding text
+    bool embed_collapse_whitespace = true; // Collapse indentation and blank lines
+    bool embed_context_header = true;      // Prefix path, scope and imports
+    uint32_t boundary_time_budget_ms = 500;    // Per-file boundary detection time (0 = unlimited)
+    uint32_t boundary_step_budget = 1000000;   // Per-file pattern attempts (0 = unlimited)
+    bool classify_files = false;           // Skip binary files, window minified/generated ones
+    bool hash_symbols = false;             // Hash each function/class/method (ChunkResult::symbols)
 };
 
 /**
@@ -57,6 +69,24 @@ struct CodeChunk {
     ChunkContext context;          // Context information
     uint32_t chunk_index;          // Index in the sequence
     std::string hash;              // Content hash for deduplication
+    std::string id;                // Stable identity (path, semantic name, normalized content)
+    uint32_t embed_offset = 0;     // Embedding text offset in ChunkResult::embed_pool
+    uint32_t embed_length = 0;     // Embedding text length in bytes
+    uint32_t embed_token_count = 0; // Tokens in the embedding text
+};
+
+/**
+ * @brief Format-insensitive hash of one function, class or method
+ */
+struct SymbolHash {
+    std::string name;              // Declared name ("" if anonymous)
+    std::string qualified_name;    // Enclosing symbols joined by '.', "#n" on repeats
+    ChunkType type = ChunkType::UNKNOWN;
+    uint32_t line_start = 0;       // 1-based
+    uint32_t line_end = 0;
+    uint64_t byte_offset = 0;      // 64-bit, as in SourceLocation
+    uint64_t byte_length = 0;
+    uint64_t hash = 0;             // Token stream of the body, nested symbols by name only
 };
 
 /**
@@ -68,6 +98,12 @@ struct ChunkResult {
     uint32_t total_lines;
     double chunking_time_ms;
     std::string error;
+    Language language = Language::UNKNOWN; // Language the source was chunked as
+    std::string embed_pool;        // Embedding texts of all chunks, back to back
+    bool degraded = false;         // Boundary budget ran out; chunked by braces/lines
+    uint8_t file_flags = 0;        // FileFlags the file was chunked with
+    bool skipped = false;          // Binary or high-entropy file; no chunks produced
+    std::vector<SymbolHash> symbols; // Per-symbol hashes, in file order (hash_symbols)
 };
 
 /**
@@ -97,6 +133,9 @@ struct SemanticBoundary {
 // Forward declarations
 class Tokenizer;
 class BoundaryDetector;
+class ChunkStream;
+class ChunkCache;
+class IdentifierIndex;
 
 /**
  * @brief Main Chunker class
@@ -121,6 +160,39 @@ public:
      */
     ChunkResult chunk_file(const std::string& filepath);
 
+    /**
+     * @brief Chunk source code, reusing cached chunks for known content
+     * @param source The source code to chunk
+     * @param filepath Path to the file (for language detection)
+     * @param content_hash Content hash of source (0 disables caching)
+     * @param file_flags FileEntry::flags of the file (0 = classify here)
+     * @return ChunkResult containing the chunks
+     */
+    ChunkResult chunk(const std::string& source, const std::string& filepath, uint64_t content_hash,
+                      uint8_t file_flags = 0);
+
+    /**
+     * @brief Chunk a file, skipping all work when its content is cached
+     * @param filepath Path to the source file
+     * @param content_hash FileEntry::content_hash of the file (0 disables caching)
+     * @param file_flags FileEntry::flags of the file (0 = classify here)
+     * @return ChunkResult containing the chunks
+     */
+    ChunkResult chunk_file(const std::string& filepath, uint64_t content_hash,
+                           uint8_t file_flags = 0);
+
+    /**
+     * @brief Attach a chunk cache (nullptr detaches)
+     * @param cache Cache shared between chunkers
+     */
+    void set_cache(std::shared_ptr<ChunkCache> cache);
+
+    /**
+     * @brief Record identifier occurrences of every chunked file (nullptr detaches)
+     * @param index Index shared between chunkers
+     */
+    void set_identifier_index(std::shared_ptr<IdentifierIndex> index);
+
     /**
      * @brief Update chunker configuration
      * @param config New configuration
@@ -137,6 +209,15 @@ private:
     ChunkerConfig config_;
     std::unique_ptr<Tokenizer> tokenizer_;
     std::unique_ptr<BoundaryDetector> boundary_detector_;
+    std::shared_ptr<ChunkCache> cache_;
+    std::shared_ptr<IdentifierIndex> identifier_index_;
+
+    ChunkResult chunk_classified(const std::string& source, const std::string& filepath, uint8_t file_flags,
+                                 uint64_t content_hash = 0);
+    uint64_t cache_fingerprint(const std::string& filepath) const;
+    void put_in_cache(uint64_t content_hash, uint64_t fingerprint, ChunkResult& result);
+    void index_cached(const std::string& filepath, const std::string& source, const ChunkResult& result,
+                      uint64_t content_hash);
 
     std::vector<CodeChunk> create_chunks_with_boundaries(
         const std::string& source,
@@ -158,6 +239,476 @@ private:
     std::string compute_hash(const std::string& content);
 };
 
+/**
+ * @brief Chunk cache statistics
+ */
+struct ChunkCacheStats {
+    uint64_t hits;           // Lookups served from memory
+    uint64_t spill_hits;     // Lookups served from the spill store
+    uint64_t misses;         // Lookups that required chunking
+    uint64_t evictions;      // Entries evicted from memory
+    uint64_t bytes_used;     // Estimated bytes held in memory
+    uint64_t byte_budget;    // Memory budget
+    uint32_t entries;        // Entries held in memory
+    uint32_t spilled;        // Entries held in the spill store
+    uint64_t spill_bytes;    // Size of the spill store file
+    uint64_t compactions;    // Spill store rewrites that dropped stale records
+};
+
+/**
+ * @brief Byte-budgeted LRU cache of ChunkResults
+ *
+ * Keyed by (content_hash, config fingerprint). Entries evicted from memory
+ * are optionally appended to an on-disk spill store, which is memory-mapped
+ * for reads and reloaded on construction so it survives restarts. When the
+ * store outgrows its budget it is rewritten with the most recently used
+ * half of its records. Thread-safe.
+ */
+class ChunkCache {
+public:
+    /**
+     * @param byte_budget Estimated bytes of resident entries
+     * @param spill_path Spill store file ("" disables spilling)
+     * @param spill_budget Spill store size bound (0 = 4 x byte_budget)
+     */
+    explicit ChunkCache(uint64_t byte_budget = 64ull * 1024 * 1024,
+                        const std::string& spill_path = "",
+                        uint64_t spill_budget = 0);
+    ~ChunkCache();
+
+    /**
+     * @brief Look up cached chunks
+     * @param content_hash Content hash of the source
+     * @param fingerprint Config fingerprint
+     * @param out Receives the cached result on hit
+     * @return true on hit
+     */
+    bool get(uint64_t content_hash, uint64_t fingerprint, ChunkResult& out);
+
+    /**
+     * @brief Insert chunks, evicting least recently used entries over budget
+     * @param content_hash Content hash of the source
+     * @param fingerprint Config fingerprint
+     * @param result Chunking result to cache
+     */
+    void put(uint64_t content_hash, uint64_t fingerprint, const ChunkResult& result);
+
+    /**
+     * @brief Write resident entries to the spill store and flush it
+     * @return true on success (or when spilling is disabled)
+     */
+    bool flush();
+
+    /**
+     * @brief Drop all entries, including the spill store
+     */
+    void clear();
+
+    /**
+     * @brief Get cache statistics
+     */
+    ChunkCacheStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Fingerprint of the config fields that affect chunk output
+ * @param config Chunker configuration
+ * @return Stable 64-bit fingerprint
+ */
+uint64_t config_fingerprint(const ChunkerConfig& config);
+
+/**
+ * @brief Serialize a ChunkResult to a compact binary form
+ * @param result Result to serialize
+ * @return Serialized bytes
+ */
+std::vector<uint8_t> serialize_chunks(const ChunkResult& result);
+
+/**
+ * @brief Deserialize a ChunkResult
+ * @param data Serialized bytes
+ * @param size Number of bytes
+ * @param out Receives the result
+ * @return true on success
+ */
+bool deserialize_chunks(const uint8_t* data, size_t size, ChunkResult& out);
+
+/**
+ * @brief Assigns deterministic chunk IDs
+ *
+ * An ID hashes the file path, the chunk's semantic name (type and parent)
+ * and its whitespace-normalized content, plus an ordinal that separates
+ * identical chunks within one file. Unlike chunk_index it does not shift
+ * when code above the chunk changes.
+ */
+class ChunkIdAssigner {
+public:
+    explicit ChunkIdAssigner(const std::string& filepath);
+
+    /**
+     * @brief Set chunk.id; call in file order
+     */
+    void assign(CodeChunk& chunk);
+
+private:
+    std::string filepath_;
+    std::unordered_map<uint64_t, uint32_t> occurrences_;
+};
+
+/**
+ * @brief Assign deterministic IDs to every chunk of a file
+ * @param result Chunks of one file, in file order
+ * @param filepath Path of the file
+ */
+void assign_chunk_ids(ChunkResult& result, const std::string& filepath);
+
+/**
+ * @brief Build the embedding text of every chunk into result.embed_pool
+ *
+ * Strips comments and collapses whitespace as configured, prefixes a
+ * path/scope/imports header, and records each chunk's slice of the pool
+ * and its token count. Runs after context extraction.
+ *
+ * @param result Chunks of one file
+ * @param filepath Path of the file
+ * @param language Source language (selects the comment syntax)
+ * @param config Chunker configuration (embed_* fields)
+ * @param tokenizer Tokenizer used for the token counts
+ */
+void build_embedding_text(ChunkResult& result, const std::string& filepath,
+                          Language language, const ChunkerConfig& config,
+                          Tokenizer& tokenizer);
+
+/**
+ * @brief Changes between two chunkings of the same file
+ */
+struct ChunkDelta {
+    std::vector<CodeChunk> upserts;   // New IDs: need embedding
+    std::vector<CodeChunk> updates;   // Known IDs whose location or exact content changed
+    std::vector<std::string> deletes; // IDs no longer present
+    uint32_t unchanged = 0;           // IDs present and identical in both
+};
+
+/**
+ * @brief Compute upsert/delete sets between two results
+ * @param before Previous result of the file
+ * @param after Current result of the file
+ * @return Delta keyed by chunk ID
+ */
+ChunkDelta diff_chunks(const ChunkResult& before, const ChunkResult& after);
+
+/**
+ * @brief Hash every function, class and method of a source
+ *
+ * Extents come from the source rather than the boundaries: the matching
+ * brace of the first body brace, or the indented block in Python. Each
+ * hash covers the symbol's token stream with whitespace and comments
+ * dropped (TokenNormalizer) and nested symbols reduced to their names, so
+ * editing a method changes the method's hash but not its class's.
+ *
+ * @param source Source text
+ * @param boundaries Boundaries detected in source
+ * @param language Source language
+ * @return Symbols in file order
+ */
+std::vector<SymbolHash> hash_symbols(const std::string& source,
+                                     const std::vector<SemanticBoundary>& boundaries,
+                                     Language language);
+
+/**
+ * @brief SymbolInfo::flags bits
+ */
+enum SymbolFlags : uint8_t {
+    SYMBOL_FLAG_EXPORTED = 1 << 0   // Visible outside its file (export, pub, public, capitalized)
+};
+
+/**
+ * @brief Declaration of one function, class or other named scope
+ */
+struct SymbolInfo {
+    std::string name;              // Declared name ("" if anonymous)
+    ChunkType type = ChunkType::UNKNOWN;
+    uint32_t line_start = 0;       // 1-based
+    uint32_t line_end = 0;
+    uint32_t byte_offset = 0;
+    uint32_t byte_length = 0;
+    int32_t parent = -1;           // Index of the enclosing symbol, -1 at top level
+    uint8_t flags = 0;             // SymbolFlags
+};
+
+/**
+ * @brief List the symbols of a source with extents, nesting and visibility
+ *
+ * Same symbols and extents as hash_symbols, without hashing.
+ *
+ * @param source Source text
+ * @param boundaries Boundaries detected in source
+ * @param language Source language
+ * @return Symbols in file order (parents before their children)
+ */
+std::vector<SymbolInfo> extract_symbols(const std::string& source,
+                                        const std::vector<SemanticBoundary>& boundaries,
+                                        Language language);
+
+/**
+ * @brief Symbol table build configuration
+ */
+struct SymbolTableConfig {
+    uint32_t num_workers = 4;
+    uint32_t boundary_time_budget_ms = 500;     // Per-file boundary detection time (0 = unlimited)
+    uint32_t boundary_step_budget = 1000000;    // Per-file pattern attempts (0 = unlimited)
+    uint64_t max_file_size = 10 * 1024 * 1024;  // Larger files contribute no symbols
+};
+
+/**
+ * @brief Symbols of many files in columnar form
+ *
+ * Row i is one symbol; the rows of file f are [file_offsets[f],
+ * file_offsets[f + 1]) in file order. Names are packed into one pool
+ * delimited by name_offsets (rows + 1 entries). parent is a row index
+ * into the same table (-1 at top level).
+ */
+struct SymbolTable {
+    std::vector<uint32_t> file;
+    std::vector<uint8_t> kind;          // ChunkType
+    std::vector<uint8_t> flags;         // SymbolFlags
+    std::vector<int32_t> parent;
+    std::vector<uint32_t> line_start;   // 1-based
+    std::vector<uint32_t> line_end;
+    std::vector<uint32_t> byte_offset;
+    std::vector<uint32_t> byte_length;
+    std::vector<uint32_t> name_offsets;
+    std::string names;
+
+    std::vector<uint32_t> file_offsets;   // files + 1 entries
+    std::vector<uint8_t> file_language;   // Language per file
+    std::vector<uint8_t> file_flags;      // FileEntry flags per file (classification)
+    std::vector<std::pair<uint32_t, std::string>> errors;  // (file, message)
+
+    size_t size() const { return kind.size(); }
+};
+
+/**
+ * @brief Extract the symbols of a batch of files on a worker pool
+ *
+ * Each worker memory-maps its files and runs its own BoundaryDetector;
+ * the per-file results are concatenated in input order, so the table is
+ * the same for any worker count. Binary, high-entropy, minified and
+ * generated files contribute no symbols.
+ *
+ * @param paths Files to read
+ * @param config Build configuration
+ * @return Columnar symbol table
+ */
+SymbolTable build_symbol_table(const std::vector<std::string>& paths,
+                               const SymbolTableConfig& config = SymbolTableConfig{});
+
+/**
+ * @brief Candidate piece of context for a prompt
+ */
+struct ContextSnippet {
+    std::string text;
+    double score = 0;              // Relevance; higher is better
+    std::string source;            // File the snippet comes from ("" = never overlaps)
+    uint32_t line_start = 0;       // 1-based line range in source (0 = unknown)
+    uint32_t line_end = 0;
+    bool pinned = false;           // Always included while it fits
+};
+
+/**
+ * @brief Context packing options
+ */
+struct PackOptions {
+    uint32_t token_budget = 4096;
+    uint32_t snippet_overhead = 0;       // Tokens added per selected snippet (headers, fences)
+    uint64_t max_dp_cells = 4000000;     // DP table size limit; costs are scaled above it
+};
+
+/**
+ * @brief Selected context
+ */
+struct PackResult {
+    std::vector<uint32_t> selected;      // Indices into the input, ascending
+    std::vector<uint32_t> token_counts;  // Token count of every input snippet (without overhead)
+    uint32_t total_tokens = 0;           // Including overhead
+    double total_score = 0;
+    uint32_t duplicates = 0;             // Snippets dropped as exact duplicates
+    bool exact = false;                  // Selection is optimal (unscaled DP, no overlap groups)
+};
+
+/**
+ * @brief Select the highest-scoring snippets that fit a token budget
+ *
+ * Costs are exact token counts (Tokenizer) plus the per-snippet overhead.
+ * Exact duplicates keep only their best copy, and snippets whose line
+ * ranges overlap in the same source are never selected together. Pinned
+ * snippets are taken first. The rest is chosen by the better of a
+ * score-density greedy pass and a knapsack DP over overlap groups (at most
+ * one snippet per group), then topped up greedily.
+ *
+ * @param snippets Candidates
+ * @param options Budget and limits
+ * @return Selection
+ */
+PackResult pack_context(const std::vector<ContextSnippet>& snippets, const PackOptions& options);
+
+/**
+ * @brief A symbol present in both versions of a file
+ */
+struct SymbolChange {
+    SymbolHash before;
+    SymbolHash after;
+};
+
+/**
+ * @brief Changes between the symbol hashes of two versions of a file
+ */
+struct SymbolDelta {
+    std::vector<SymbolHash> added;
+    std::vector<SymbolHash> removed;
+    std::vector<SymbolChange> changed;  // Same qualified name, different hash
+    std::vector<SymbolChange> moved;    // Same hash, new location or new qualified name
+    uint32_t unchanged = 0;
+};
+
+/**
+ * @brief Compare the symbol hashes of two versions of a file
+ *
+ * Symbols are matched by qualified name first. Leftover removed and added
+ * symbols with equal hashes are reported as moved (renamed scope or
+ * relocation), not as a removal plus an addition.
+ *
+ * @param before Symbols of the previous version
+ * @param after Symbols of the current version
+ * @return Delta in the order of after (removed in the order of before)
+ */
+SymbolDelta diff_symbols(const std::vector<SymbolHash>& before, const std::vector<SymbolHash>& after);
+
+/**
+ * @brief Export a file's chunks in a compact binary form
+ * @param result Chunks of the file (with IDs)
+ * @param filepath Path of the file
+ * @return Bytes: magic, version, path, serialized chunks
+ */
+std::vector<uint8_t> export_chunks(const ChunkResult& result, const std::string& filepath);
+
+/**
+ * @brief Read an export produced by export_chunks
+ * @param data Exported bytes
+ * @param size Number of bytes
+ * @param out Receives the chunks
+ * @param filepath Receives the file path
+ * @return true on success
+ */
+bool import_chunks(const uint8_t* data, size_t size, ChunkResult& out, std::string& filepath);
+
+/**
+ * @brief Pull-based chunk iterator over a memory-mapped file
+ *
+ * Chunks the file one window at a time instead of copying it whole into a
+ * std::string. Each window is cut at a top-level line boundary found within
+ * the look-ahead range, so peak memory is bounded by
+ * stream_window_bytes + stream_lookahead_bytes regardless of file size.
+ * Locations and chunk indices are absolute within the file.
+ */
+class ChunkStream {
+public:
+    explicit ChunkStream(const std::string& filepath,
+                         const ChunkerConfig& config = ChunkerConfig{});
+    ~ChunkStream();
+
+    // Disable copy
+    ChunkStream(const ChunkStream&) = delete;
+    ChunkStream& operator=(const ChunkStream&) = delete;
+
+    /**
+     * @brief Check whether the file was opened successfully
+     * @return true if the stream can be read
+     */
+    bool is_open() const { return error_.empty(); }
+
+    /**
+     * @brief Get the open error, if any
+     * @return Error message (empty on success)
+     */
+    const std::string& error() const { return error_; }
+
+    /**
+     * @brief Pull the next chunk
+     * @param out Receives the chunk
+     * @return false once the file is exhausted
+     */
+    bool next(CodeChunk& out);
+
+    /**
+     * @brief Pull all chunks of the next window
+     * @param out Receives the chunks (cleared first)
+     * @return false once the file is exhausted
+     */
+    bool next_window(std::vector<CodeChunk>& out);
+
+    /**
+     * @brief Check whether all chunks have been consumed
+     * @return true when no more chunks are available
+     */
+    bool done() const;
+
+    /**
+     * @brief Bytes of the file consumed so far
+     */
+    uint64_t bytes_consumed() const { return window_start_; }
+
+    /**
+     * @brief Total file size in bytes
+     */
+    uint64_t total_bytes() const { return file_.size(); }
+
+    /**
+     * @brief Whether any window so far ran out of boundary detection budget
+     */
+    bool degraded() const { return degraded_; }
+
+    /**
+     * @brief Whether the file was classified as binary and skipped
+     */
+    bool skipped() const { return skipped_; }
+
+    /**
+     * @brief Embedding texts of the current window (embed_text only)
+     *
+     * Chunks from next() and next_window() index it through embed_offset;
+     * it is replaced when the stream moves to the next window.
+     */
+    const std::string& embed_pool() const { return embed_pool_; }
+
+private:
+    MappedFile file_;
+    Chunker chunker_;
+    ChunkerConfig config_;
+    std::string filepath_;
+    std::string error_;
+    std::vector<CodeChunk> pending_;
+    std::vector<std::string> carried_imports_;
+    size_t pending_pos_ = 0;
+    ChunkIdAssigner ids_;
+    size_t window_start_ = 0;
+    uint32_t line_base_ = 0;
+    uint32_t next_index_ = 0;
+    bool degraded_ = false;
+    bool skipped_ = false;
+    uint8_t file_flags_ = 0;
+    bool embed_ = false;
+    std::string embed_pool_;
+    std::unique_ptr<Tokenizer> tokenizer_;
+
+    bool fill();
+    size_t find_cut(size_t target) const;
+};
+
 /**
  * @brief Tokenizer for counting tokens (tiktoken-compatible)
  *
@@ -176,6 +727,14 @@ public:
      */
     uint32_t count_tokens(const std::string& text);
 
+    /**
+     * @brief Count tokens in a byte range (e.g. a slice of a pooled buffer)
+     * @param data Start of the text
+     * @param length Number of bytes
+     * @return Number of tokens
+     */
+    uint32_t count_tokens(const char* data, size_t length);
+
     /**
      * @brief Encode text to token IDs
      * @param text The text to encode
@@ -191,6 +750,453 @@ public:
      */
     size_t find_token_boundary(const std::string& text, uint32_t target_tokens);
 
+    /**
+     * @brief Find byte offset at token boundary in a byte range
+     * @param data Start of the text
+     * @param length Length of the text in bytes
+     * @param target_tokens Target token count
+     * @return Byte offset closest to target token count
+     */
+    size_t find_token_boundary(const char* data, size_t length, uint32_t target_tokens);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Bitmask index of where code, literals and brackets are in a source
+ *
+ * Built once per file over 64-byte blocks, simdjson-style: character classes
+ * are compared 16 bytes at a time (SSE2 where available) into 64-bit masks,
+ * and a small state machine that visits only quote, escape, comment-marker
+ * and newline positions resolves which bytes are inside string literals or
+ * comments. Boundary detectors then jump between identifier starts and
+ * brackets outside literals, and line/column lookups are O(1).
+ * The index points into the source, which must outlive it.
+ */
+class StructuralIndex {
+public:
+    // Position kinds for next()
+    static constexpr uint32_t IDENT_START = 1;    // First byte of an identifier or directive
+    static constexpr uint32_t BRACE = 2;          // '{' or '}' outside literals
+    static constexpr uint32_t PAREN = 4;          // '(' or ')' outside literals
+    static constexpr uint32_t SQUARE = 8;         // '[' or ']' outside literals
+    static constexpr uint32_t COMMENT_START = 16; // First byte of a comment
+
+    StructuralIndex(const std::string& source, Language language);
+
+    /**
+     * @brief Find the next position of the given kinds
+     * @param pos Start position (inclusive)
+     * @param kinds Bitwise OR of kind constants
+     * @return Position, or the source size if there is none
+     */
+    size_t next(size_t pos, uint32_t kinds) const;
+
+    /**
+     * @brief Whether the byte is inside a string literal or comment
+     */
+    bool in_literal(size_t pos) const {
+        return pos < size_ && ((blocks_[pos >> 6].literal >> (pos & 63)) & 1);
+    }
+
+    /**
+     * @brief Whether a comment starts at the byte
+     */
+    bool is_comment_start(size_t pos) const {
+        return pos < size_ && ((blocks_[pos >> 6].comment_start >> (pos & 63)) & 1);
+    }
+
+    /**
+     * @brief First position at or after pos that is outside literals
+     */
+    size_t literal_end(size_t pos) const;
+
+    /**
+     * @brief Find the bracket matching the one at pos, skipping literals
+     * @param pos Position of an opening '{', '(' or '['
+     * @return Position after the matching close, or the source size
+     */
+    size_t find_matching(size_t pos) const;
+
+    /**
+     * @brief 1-based line and column of a byte offset
+     */
+    std::pair<uint32_t, uint32_t> line_col(size_t pos) const;
+
+    /**
+     * @brief 1-based line of a byte offset
+     */
+    uint32_t line(size_t pos) const;
+
+    size_t size() const { return size_; }
+
+private:
+    struct Block {
+        uint64_t newline = 0;
+        uint64_t literal = 0;
+        uint64_t ident_start = 0;
+        uint64_t comment_start = 0;
+        uint64_t brace = 0;
+        uint64_t paren = 0;
+        uint64_t square = 0;
+    };
+
+    const char* data_;
+    size_t size_;
+    std::vector<Block> blocks_;
+    std::vector<uint32_t> lines_before_;  // Newlines before each block
+    std::vector<size_t> line_starts_;     // Start of the line holding each block's first byte
+
+    uint64_t kind_mask(const Block& block, uint32_t kinds) const;
+};
+
+/**
+ * @brief How an identifier occurrence uses the name
+ */
+enum class OccurrenceRole : uint8_t {
+    REFERENCE = 1,      // Any other use
+    DEFINITION = 2,     // Directly after a declaration keyword (const x, def f, class C)
+    IMPORT = 4          // Inside an import or use statement
+};
+
+/**
+ * @brief One occurrence of an identifier
+ */
+struct IdentifierOccurrence {
+    uint32_t file;          // File index (see IdentifierIndex::file_path)
+    uint32_t offset;        // Byte offset in the file
+    uint32_t line;          // 1-based
+    uint32_t column;        // 1-based, in bytes
+    OccurrenceRole role;
+};
+
+/**
+ * @brief A call of a named function
+ */
+struct CallSite {
+    uint32_t file;          // File index (see IdentifierIndex::file_path)
+    uint32_t offset;        // Byte offset of the callee name in the file
+    uint32_t line;          // 1-based
+    uint32_t column;        // 1-based, in bytes
+    std::string callee;
+    std::string caller;     // Innermost enclosing function ("" outside functions)
+};
+
+/**
+ * @brief Identifier index statistics
+ */
+struct IdentifierIndexStats {
+    uint32_t file_count = 0;
+    uint32_t identifier_count = 0;      // Distinct names ever interned
+    uint64_t occurrence_count = 0;
+    uint64_t call_count = 0;            // Occurrences that are call sites
+    uint32_t updates = 0;               // Files (re)indexed
+    uint32_t skipped_updates = 0;       // Updates skipped for an unchanged content hash
+    double index_time_ms = 0;           // Total scanning time
+};
+
+/**
+ * @brief Cross-reference index of identifier occurrences across files
+ *
+ * Identifiers outside string literals and comments (found with a
+ * StructuralIndex) are interned, and each file keeps its occurrences
+ * sorted by identifier, so the occurrences of a name in a file are one
+ * binary search away. Per identifier, the sorted list of files that
+ * contain it bounds every lookup to those files.
+ *
+ * References followed by '(' are call sites. Each one records the
+ * innermost function boundary around it as its caller, so callers and
+ * callees of a function are index lookups as well.
+ *
+ * update_file() replaces a file's occurrences; an unchanged non-zero
+ * content hash skips the work. Language keywords are not indexed.
+ * Scanning runs outside the lock, so chunkers on several threads can
+ * share one index. Thread-safe.
+ */
+class IdentifierIndex {
+public:
+    static constexpr uint32_t ALL_ROLES = 7;
+
+    IdentifierIndex();
+    ~IdentifierIndex();
+
+    /**
+     * @brief Index or re-index a file
+     * @param path File path
+     * @param source File content
+     * @param language Source language (UNKNOWN = detect from path)
+     * @param content_hash Content hash (0 = always re-index)
+     * @param boundaries Boundaries of source for call attribution (nullptr = detect here)
+     * @param detector Detector for that, with its budget (nullptr = an unbudgeted one)
+     * @param file_flags FileFlags of the file (0 = classify here); minified,
+     *        generated and binary files are indexed without occurrences
+     * @return false if skipped because the content hash is unchanged
+     */
+    bool update_file(const std::string& path, const std::string& source, Language language,
+                     uint64_t content_hash = 0, const std::vector<SemanticBoundary>* boundaries = nullptr,
+                     BoundaryDetector* detector = nullptr, uint8_t file_flags = 0);
+
+    /**
+     * @brief Whether the file is indexed with this content hash
+     */
+    bool has_file(const std::string& path, uint64_t content_hash) const;
+
+    /**
+     * @brief Drop a file's occurrences
+     * @return false if the file is not indexed
+     */
+    bool remove_file(const std::string& path);
+
+    /**
+     * @brief Move a file's occurrences to a new path
+     * @return false if old_path is not indexed
+     */
+    bool rename_file(const std::string& old_path, const std::string& new_path);
+
+    /**
+     * @brief Occurrences of a name, by file index then offset
+     * @param name Identifier
+     * @param roles Bitwise OR of OccurrenceRole values
+     * @param path Only this file (empty = all files)
+     */
+    std::vector<IdentifierOccurrence> occurrences(const std::string& name, uint32_t roles = ALL_ROLES,
+                                                  const std::string& path = "") const;
+
+    /**
+     * @brief Number of occurrences of a name
+     * @param name Identifier
+     * @param roles Bitwise OR of OccurrenceRole values
+     * @param path Only this file (empty = all files)
+     */
+    uint32_t count(const std::string& name, uint32_t roles = ALL_ROLES, const std::string& path = "") const;
+
+    /**
+     * @brief Calls of a name, by file index then offset
+     * @param name Callee identifier
+     * @param path Only this file (empty = all files)
+     */
+    std::vector<CallSite> call_sites(const std::string& name, const std::string& path = "") const;
+
+    /**
+     * @brief Calls made inside functions with this name, by file index then offset
+     * @param name Caller identifier
+     * @param path Only this file (empty = all files)
+     */
+    std::vector<CallSite> callees(const std::string& name, const std::string& path = "") const;
+
+    /**
+     * @brief Files with at least one occurrence of a name in the given roles
+     * @return File paths, in file index order
+     */
+    std::vector<std::string> files(const std::string& name, uint32_t roles = ALL_ROLES) const;
+
+    /**
+     * @brief Path of a file index (empty if unknown or removed)
+     */
+    std::string file_path(uint32_t file) const;
+
+    void clear();
+
+    IdentifierIndexStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Syntax tree node as passed to AstArena::set_file
+ *
+ * Nodes are given in preorder; parent is an index into the same array
+ * and positions are in UTF-16 code units, as reported by tree-sitter.
+ */
+struct AstNodeInput {
+    uint32_t kind;          // Index into the file's kind name table
+    uint32_t parent;        // AstArena::NO_NODE for the root
+    uint32_t start;
+    uint32_t end;
+    uint32_t start_row;
+    uint32_t start_column;
+    uint32_t end_row;
+    uint32_t end_column;
+    uint32_t name_node;     // Node whose text is this node's name, or NO_NODE
+    bool error;             // ERROR or missing node
+};
+
+/**
+ * @brief One stored node, resolved for a caller
+ */
+struct AstNodeInfo {
+    uint32_t kind;          // Global kind id (see AstArena::kind_name)
+    uint32_t parent;
+    uint32_t first_child;
+    uint32_t next_sibling;
+    uint32_t subtree_end;   // One past the last descendant, in preorder
+    uint32_t child_count;
+    uint32_t start;
+    uint32_t end;
+    uint32_t start_row;
+    uint32_t start_column;
+    uint32_t end_row;
+    uint32_t end_column;
+    uint32_t name;          // Interned name id, or NO_NODE
+    bool has_error;         // The subtree contains an error
+};
+
+/**
+ * @brief Arena statistics
+ */
+struct AstArenaStats {
+    uint32_t file_count = 0;
+    uint64_t node_count = 0;
+    uint32_t kind_count = 0;
+    uint32_t name_count = 0;
+    uint64_t source_bytes = 0;
+    uint64_t node_bytes = 0;
+};
+
+/**
+ * @brief Flat storage for the syntax trees of many files
+ *
+ * Each file keeps its nodes in preorder as parallel arrays (kind, parent,
+ * first child, next sibling, subtree end, ranges, name), so a subtree is
+ * a contiguous index range and a query is a linear scan without pointer
+ * chasing. Kind names and node names are interned across files. The
+ * source is kept as UTF-16 to slice node text on demand. Thread-safe.
+ */
+class AstArena {
+public:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    AstArena();
+    ~AstArena();
+
+    /**
+     * @brief Store or replace the tree of a file
+     * @param path File path
+     * @param source File content (UTF-16)
+     * @param kinds Kind names referenced by AstNodeInput::kind
+     * @param nodes Nodes in preorder, root first
+     * @param error Set when the nodes are not a valid preorder tree
+     * @return false on invalid input (the previous tree is kept)
+     */
+    bool set_file(const std::string& path, std::u16string source, const std::vector<std::string>& kinds,
+                  const std::vector<AstNodeInput>& nodes, std::string& error);
+
+    bool remove_file(const std::string& path);
+    bool has_file(const std::string& path) const;
+    std::vector<std::string> files() const;
+
+    /**
+     * @brief Number of nodes of a file (0 if unknown)
+     */
+    uint32_t node_count(const std::string& path) const;
+
+    /**
+     * @brief Resolve one node
+     * @return false if the file or node is unknown
+     */
+    bool node(const std::string& path, uint32_t id, AstNodeInfo& out) const;
+
+    /**
+     * @brief Direct children of a node, in order
+     */
+    std::vector<uint32_t> children(const std::string& path, uint32_t id) const;
+
+    /**
+     * @brief Nodes of the given kinds in a subtree, in preorder
+     * @param kinds Kind names
+     * @param root Subtree root (0 = whole file)
+     * @param first_only Stop at the first match
+     */
+    std::vector<uint32_t> find(const std::string& path, const std::vector<std::string>& kinds,
+                               uint32_t root = 0, bool first_only = false) const;
+
+    /**
+     * @brief Nodes of a subtree in preorder with their depth below root
+     * @param max_depth Deepest level to include (UINT32_MAX = all)
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> walk(const std::string& path, uint32_t root,
+                                                    uint32_t max_depth = UINT32_MAX) const;
+
+    /**
+     * @brief Source text of a node, cut to max_length code units (0 = all)
+     */
+    std::u16string text(const std::string& path, uint32_t id, uint32_t max_length = 0) const;
+
+    std::string kind_name(uint32_t kind) const;
+    std::u16string name(uint32_t name) const;
+
+    void clear();
+
+    AstArenaStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Parse cache statistics
+ */
+struct ParseCacheStats {
+    uint64_t hits = 0;        // Lookups served from the store
+    uint64_t misses = 0;      // Lookups that required parsing
+    uint64_t stores = 0;      // Records appended since open
+    uint32_t entries = 0;     // Records in the store
+    uint64_t file_bytes = 0;  // Size of the store on disk
+};
+
+/**
+ * @brief Persistent store of parse results keyed by content hash
+ *
+ * Maps (FileEntry::content_hash, parser fingerprint) to an opaque payload
+ * (a serialised syntax tree or symbol list). The store is append-only and
+ * memory-mapped on open, so a restarted server re-parses only files whose
+ * content has not been seen before. Thread-safe.
+ */
+class ParseCache {
+public:
+    explicit ParseCache(const std::string& path);
+    ~ParseCache();
+
+    /**
+     * @brief Whether the backing file could be opened
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Look up a payload
+     * @param content_hash Content hash of the source
+     * @param fingerprint Parser fingerprint (grammar/format version)
+     * @param out Receives the payload on hit
+     * @return true on hit
+     */
+    bool get(uint64_t content_hash, uint64_t fingerprint, std::vector<uint8_t>& out);
+
+    bool contains(uint64_t content_hash, uint64_t fingerprint) const;
+
+    /**
+     * @brief Append a payload (no-op when the key is already stored)
+     * @return true on success
+     */
+    bool put(uint64_t content_hash, uint64_t fingerprint, const uint8_t* data, size_t size);
+
+    bool flush();
+
+    void clear();
+
+    /**
+     * @brief Rewrite the store keeping only records of live content hashes
+     * @param live_hashes Content hashes still present in the project
+     * @return Number of dropped records
+     */
+    uint32_t compact(const std::vector<uint64_t>& live_hashes);
+
+    ParseCacheStats stats() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -215,18 +1221,34 @@ public:
         Language language
     );
 
+    /**
+     * @brief Limit the work of the precise detectors per detect() call
+     * @param time_budget_ms Wall-clock budget in milliseconds (0 = unlimited)
+     * @param step_budget Budget of pattern match attempts (0 = unlimited)
+     *
+     * Once either is exceeded, detect() falls back to linear brace detection,
+     * which gets the time budget once more and leaves the rest of the file
+     * without boundaries when that runs out too.
+     */
+    void set_budget(uint32_t time_budget_ms, uint64_t step_budget);
+
+    /**
+     * @brief Whether the last detect() ran out of budget and fell back
+     */
+    bool degraded() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
 
-    std::vector<SemanticBoundary> detect_javascript(const std::string& source);
-    std::vector<SemanticBoundary> detect_typescript(const std::string& source);
-    std::vector<SemanticBoundary> detect_python(const std::string& source);
-    std::vector<SemanticBoundary> detect_rust(const std::string& source);
-    std::vector<SemanticBoundary> detect_go(const std::string& source);
-    std::vector<SemanticBoundary> detect_java(const std::string& source);
-    std::vector<SemanticBoundary> detect_cpp(const std::string& source);
-    std::vector<SemanticBoundary> detect_generic(const std::string& source);
+    std::vector<SemanticBoundary> detect_javascript(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_typescript(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_python(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_rust(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_go(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_java(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_cpp(const std::string& source, const StructuralIndex& index);
+    std::vector<SemanticBoundary> detect_generic(const std::string& source, const StructuralIndex& index);
 };
 
 } // namespace chunker
@@ -0,0 +1,358 @@
+/**
+ * @file ast.cpp
+ * @brief Compact arena storage for parsed syntax trees
+ * @version 1.0.0
+ *
+ * Trees arrive flattened in preorder (tree-sitter parses on the JS side)
+ * and are stored as structure-of-arrays per file. Preorder makes every
+ * subtree the index range [id, subtree_end), which all queries scan.
+ */
+
+#include "chunker.h"
+#include <mutex>
+
+namespace archicore {
+namespace chunker {
+
+namespace {
+
+struct FileTree {
+    std::u16string source;
+    std::vector<uint16_t> kind;
+    std::vector<uint8_t> has_error;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> first_child;
+    std::vector<uint32_t> next_sibling;
+    std::vector<uint32_t> subtree_end;
+    std::vector<uint32_t> start;
+    std::vector<uint32_t> end;
+    std::vector<uint32_t> start_row;
+    std::vector<uint32_t> start_column;
+    std::vector<uint32_t> end_row;
+    std::vector<uint32_t> end_column;
+    std::vector<uint32_t> name;
+
+    size_t size() const { return kind.size(); }
+
+    uint64_t node_bytes() const {
+        return static_cast<uint64_t>(size()) * (sizeof(uint16_t) + sizeof(uint8_t) + 12 * sizeof(uint32_t));
+    }
+};
+
+} // namespace
+
+struct AstArena::Impl {
+    std::unordered_map<std::string, FileTree> files;
+
+    std::vector<std::string> kind_names;
+    std::unordered_map<std::string, uint16_t> kind_index;
+    std::vector<std::u16string> names;
+    std::unordered_map<std::u16string, uint32_t> name_index;
+
+    uint64_t node_count = 0;
+    uint64_t source_bytes = 0;
+    uint64_t node_bytes = 0;
+    mutable std::mutex mutex;
+
+    const FileTree* find_file(const std::string& path) const {
+        auto it = files.find(path);
+        return it == files.end() ? nullptr : &it->second;
+    }
+
+    uint32_t intern_name(const std::u16string& name) {
+        auto it = name_index.find(name);
+        if (it != name_index.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        name_index.emplace(name, id);
+        return id;
+    }
+
+    void forget(const FileTree& tree) {
+        node_count -= tree.size();
+        source_bytes -= tree.source.size() * sizeof(char16_t);
+        node_bytes -= tree.node_bytes();
+    }
+};
+
+AstArena::AstArena() : impl_(std::make_unique<Impl>()) {}
+AstArena::~AstArena() = default;
+
+bool AstArena::set_file(const std::string& path, std::u16string source, const std::vector<std::string>& kinds,
+                        const std::vector<AstNodeInput>& nodes, std::string& error) {
+    size_t n = nodes.size();
+    if (n == 0 || n >= NO_NODE) {
+        error = "Tree must have between 1 and 2^32 - 2 nodes";
+        return false;
+    }
+
+    FileTree tree;
+    tree.kind.resize(n);
+    tree.has_error.resize(n);
+    tree.parent.resize(n);
+    tree.first_child.assign(n, NO_NODE);
+    tree.next_sibling.assign(n, NO_NODE);
+    tree.subtree_end.resize(n);
+    tree.start.resize(n);
+    tree.end.resize(n);
+    tree.start_row.resize(n);
+    tree.start_column.resize(n);
+    tree.end_row.resize(n);
+    tree.end_column.resize(n);
+    tree.name.assign(n, NO_NODE);
+
+    // Validate and link outside the lock; open ancestors live on a stack
+    std::vector<uint32_t> open;
+    std::vector<uint32_t> last_child(n, NO_NODE);
+    for (uint32_t i = 0; i < n; i++) {
+        const AstNodeInput& node = nodes[i];
+        if (node.kind >= kinds.size()) {
+            error = "Node " + std::to_string(i) + " has an unknown kind";
+            return false;
+        }
+        if (node.start > node.end || node.end > source.size()) {
+            error = "Node " + std::to_string(i) + " is out of the source range";
+            return false;
+        }
+        if (node.name_node != NO_NODE && node.name_node >= n) {
+            error = "Node " + std::to_string(i) + " has an unknown name node";
+            return false;
+        }
+
+        if (i == 0) {
+            if (node.parent != NO_NODE) {
+                error = "The first node must be the root";
+                return false;
+            }
+        } else {
+            while (!open.empty() && open.back() != node.parent) {
+                tree.subtree_end[open.back()] = i;
+                open.pop_back();
+            }
+            if (open.empty()) {
+                error = "Node " + std::to_string(i) + " is not in preorder";
+                return false;
+            }
+            if (last_child[node.parent] == NO_NODE) {
+                tree.first_child[node.parent] = i;
+            } else {
+                tree.next_sibling[last_child[node.parent]] = i;
+            }
+            last_child[node.parent] = i;
+        }
+        open.push_back(i);
+
+        tree.parent[i] = node.parent;
+        tree.has_error[i] = node.error ? 1 : 0;
+        tree.start[i] = node.start;
+        tree.end[i] = node.end;
+        tree.start_row[i] = node.start_row;
+        tree.start_column[i] = node.start_column;
+        tree.end_row[i] = node.end_row;
+        tree.end_column[i] = node.end_column;
+    }
+    for (uint32_t id : open) tree.subtree_end[id] = static_cast<uint32_t>(n);
+
+    // An error anywhere below marks every ancestor, like tree-sitter's hasError
+    for (size_t i = n - 1; i > 0; i--) {
+        if (tree.has_error[i]) tree.has_error[tree.parent[i]] = 1;
+    }
+
+    tree.source = std::move(source);
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+
+    std::vector<uint16_t> kind_map(kinds.size());
+    for (size_t k = 0; k < kinds.size(); k++) {
+        auto it = d.kind_index.find(kinds[k]);
+        if (it == d.kind_index.end()) {
+            if (d.kind_names.size() >= UINT16_MAX) {
+                error = "Too many distinct node kinds";
+                return false;
+            }
+            it = d.kind_index.emplace(kinds[k], static_cast<uint16_t>(d.kind_names.size())).first;
+            d.kind_names.push_back(kinds[k]);
+        }
+        kind_map[k] = it->second;
+    }
+    for (size_t i = 0; i < n; i++) {
+        tree.kind[i] = kind_map[nodes[i].kind];
+        uint32_t name_node = nodes[i].name_node;
+        if (name_node != NO_NODE) {
+            tree.name[i] = d.intern_name(tree.source.substr(nodes[name_node].start,
+                                                            nodes[name_node].end - nodes[name_node].start));
+        }
+    }
+
+    auto it = d.files.find(path);
+    if (it != d.files.end()) {
+        d.forget(it->second);
+        it->second = std::move(tree);
+    } else {
+        it = d.files.emplace(path, std::move(tree)).first;
+    }
+    d.node_count += it->second.size();
+    d.source_bytes += it->second.source.size() * sizeof(char16_t);
+    d.node_bytes += it->second.node_bytes();
+    return true;
+}
+
+bool AstArena::remove_file(const std::string& path) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->files.find(path);
+    if (it == impl_->files.end()) return false;
+    impl_->forget(it->second);
+    impl_->files.erase(it);
+    return true;
+}
+
+bool AstArena::has_file(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->find_file(path) != nullptr;
+}
+
+std::vector<std::string> AstArena::files() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<std::string> result;
+    result.reserve(impl_->files.size());
+    for (const auto& entry : impl_->files) result.push_back(entry.first);
+    return result;
+}
+
+uint32_t AstArena::node_count(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const FileTree* tree = impl_->find_file(path);
+    return tree ? static_cast<uint32_t>(tree->size()) : 0;
+}
+
+bool AstArena::node(const std::string& path, uint32_t id, AstNodeInfo& out) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const FileTree* tree = impl_->find_file(path);
+    if (!tree || id >= tree->size()) return false;
+
+    out.kind = tree->kind[id];
+    out.parent = tree->parent[id];
+    out.first_child = tree->first_child[id];
+    out.next_sibling = tree->next_sibling[id];
+    out.subtree_end = tree->subtree_end[id];
+    out.child_count = 0;
+    for (uint32_t c = tree->first_child[id]; c != NO_NODE; c = tree->next_sibling[c]) out.child_count++;
+    out.start = tree->start[id];
+    out.end = tree->end[id];
+    out.start_row = tree->start_row[id];
+    out.start_column = tree->start_column[id];
+    out.end_row = tree->end_row[id];
+    out.end_column = tree->end_column[id];
+    out.name = tree->name[id];
+    out.has_error = tree->has_error[id] != 0;
+    return true;
+}
+
+std::vector<uint32_t> AstArena::children(const std::string& path, uint32_t id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<uint32_t> result;
+    const FileTree* tree = impl_->find_file(path);
+    if (!tree || id >= tree->size()) return result;
+    for (uint32_t c = tree->first_child[id]; c != NO_NODE; c = tree->next_sibling[c]) result.push_back(c);
+    return result;
+}
+
+std::vector<uint32_t> AstArena::find(const std::string& path, const std::vector<std::string>& kinds,
+                                     uint32_t root, bool first_only) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    std::vector<uint32_t> result;
+    const FileTree* tree = d.find_file(path);
+    if (!tree || root >= tree->size()) return result;
+
+    std::vector<bool> wanted(d.kind_names.size(), false);
+    bool any = false;
+    for (const auto& kind : kinds) {
+        auto it = d.kind_index.find(kind);
+        if (it != d.kind_index.end()) {
+            wanted[it->second] = true;
+            any = true;
+        }
+    }
+    if (!any) return result;
+
+    for (uint32_t id = root, stop = tree->subtree_end[root]; id < stop; id++) {
+        if (!wanted[tree->kind[id]]) continue;
+        result.push_back(id);
+        if (first_only) break;
+    }
+    return result;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> AstArena::walk(const std::string& path, uint32_t root,
+                                                          uint32_t max_depth) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<std::pair<uint32_t, uint32_t>> result;
+    const FileTree* tree = impl_->find_file(path);
+    if (!tree || root >= tree->size()) return result;
+
+    // Subtree ends of the open ancestors give each node's depth
+    std::vector<uint32_t> ends;
+    uint32_t stop = tree->subtree_end[root];
+    for (uint32_t id = root; id < stop;) {
+        while (!ends.empty() && ends.back() <= id) ends.pop_back();
+        uint32_t depth = static_cast<uint32_t>(ends.size());
+        result.emplace_back(id, depth);
+        if (depth >= max_depth) {
+            id = tree->subtree_end[id];
+            continue;
+        }
+        ends.push_back(tree->subtree_end[id]);
+        id++;
+    }
+    return result;
+}
+
+std::u16string AstArena::text(const std::string& path, uint32_t id, uint32_t max_length) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const FileTree* tree = impl_->find_file(path);
+    if (!tree || id >= tree->size()) return std::u16string();
+    uint32_t length = tree->end[id] - tree->start[id];
+    if (max_length > 0 && length > max_length) length = max_length;
+    return tree->source.substr(tree->start[id], length);
+}
+
+std::string AstArena::kind_name(uint32_t kind) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return kind < impl_->kind_names.size() ? impl_->kind_names[kind] : std::string();
+}
+
+std::u16string AstArena::name(uint32_t name) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return name < impl_->names.size() ? impl_->names[name] : std::u16string();
+}
+
+void AstArena::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    d.files.clear();
+    d.kind_names.clear();
+    d.kind_index.clear();
+    d.names.clear();
+    d.name_index.clear();
+    d.node_count = 0;
+    d.source_bytes = 0;
+    d.node_bytes = 0;
+}
+
+AstArenaStats AstArena::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    AstArenaStats s;
+    s.file_count = static_cast<uint32_t>(d.files.size());
+    s.node_count = d.node_count;
+    s.kind_count = static_cast<uint32_t>(d.kind_names.size());
+    s.name_count = static_cast<uint32_t>(d.names.size());
+    s.source_bytes = d.source_bytes;
+    s.node_bytes = d.node_bytes;
+    return s;
+}
+
+} // namespace chunker
+} // namespace archicore
@@ -8,10 +8,38 @@
 
 #include <napi.h>
 #include "chunker.h"
+#include <cstring>
 
 namespace archicore {
 namespace chunker {
 
+/**
+ * @brief Per-environment addon data
+ */
+struct AddonData {
+    Napi::FunctionReference chunker_constructor;
+    Napi::FunctionReference chunk_cache_constructor;
+    Napi::FunctionReference identifier_index_constructor;
+};
+
+/**
+ * @brief Parse a decimal content hash string (as produced by the indexer)
+ * @return Parsed hash, or 0 when absent or malformed
+ */
+static uint64_t content_hash_from_js(const Napi::Value& value) {
+    if (!value.IsString()) return 0;
+    std::string str = value.As<Napi::String>().Utf8Value();
+    char* end = nullptr;
+    unsigned long long hash = std::strtoull(str.c_str(), &end, 10);
+    return (end && *end == '\0') ? static_cast<uint64_t>(hash) : 0;
+}
+
+// FileEntry.flags from the indexer (0 when absent: the chunker classifies)
+static uint8_t file_flags_from_js(const Napi::Value& value) {
+    if (!value.IsNumber()) return 0;
+    return static_cast<uint8_t>(value.As<Napi::Number>().Uint32Value());
+}
+
 /**
  * @brief Convert ChunkConfig from JS object
  */
@@ -36,21 +64,39 @@ ChunkerConfig config_from_js(const Napi::Object& obj) {
     if (obj.Has("preserveImports")) {
         config.preserve_imports = obj.Get("preserveImports").As<Napi::Boolean>().Value();
     }
+    if (obj.Has("streamWindowBytes")) {
+        config.stream_window_bytes = obj.Get("streamWindowBytes").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("streamLookaheadBytes")) {
+        config.stream_lookahead_bytes = obj.Get("streamLookaheadBytes").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("embedText")) {
+        config.embed_text = obj.Get("embedText").As<Napi::Boolean>().Value();
+    }
+    if (obj.Has("embedStripComments")) {
+        config.embed_strip_comments = obj.Get("embedStripComments").As<Napi::Boolean>().Value();
+    }
+    if (obj.Has("embedCollapseWhitespace")) {
+        config.embed_collapse_whitespace = obj.Get("embedCollapseWhitespace").As<Napi::Boolean>().Value();
+    }
+    if (obj.Has("embedContextHeader")) {
+        config.embed_context_header = obj.Get("embedContextHeader").As<Napi::Boolean>().Value();
+    }
+    if (obj.Has("boundaryTimeBudgetMs")) {
+        config.boundary_time_budget_ms = obj.Get("boundaryTimeBudgetMs").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("boundaryStepBudget")) {
+        config.boundary_step_budget = obj.Get("boundaryStepBudget").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("classifyFiles")) {
+        config.classify_files = obj.Get("classifyFiles").As<Napi::Boolean>().Value();
+    }
+    if (obj.Has("hashSymbols")) {
+        config.hash_symbols = obj.Get("hashSymbols").As<Napi::Boolean>().Value();
+    }
     if (obj.Has("language")) {
         std::string lang = obj.Get("language").As<Napi::String>().Utf8Value();
-        if (lang == "javascript") config.language = Language::JAVASCRIPT;
-        else if (lang == "typescript") config.language = Language::TYPESCRIPT;
-        else if (lang == "python") config.language = Language::PYTHON;
-        else if (lang == "rust") config.language = Language::RUST;
-        else if (lang == "go") config.language = Language::GO;
-        else if (lang == "java") config.language = Language::JAVA;
-        else if (lang == "cpp" || lang == "c++") config.language = Language::CPP;
-        else if (lang == "c") config.language = Language::C;
-        else if (lang == "csharp" || lang == "c#") config.language = Language::CSHARP;
-        else if (lang == "ruby") config.language = Language::RUBY;
-        else if (lang == "php") config.language = Language::PHP;
-        else if (lang == "swift") config.language = Language::SWIFT;
-        else if (lang == "kotlin") config.language = Language::KOTLIN;
+        config.language = language_from_string(lang);
     }
 
     return config;
@@ -65,7 +111,7 @@ Napi::Object location_to_js(Napi::Env env, const SourceLocation& loc) {
     obj.Set("lineEnd", Napi::Number::New(env, loc.line_end));
     obj.Set("columnStart", Napi::Number::New(env, loc.column_start));
     obj.Set("columnEnd", Napi::Number::New(env, loc.column_end));
-    obj.Set("byteOffset", Napi::Number::New(env, loc.byte_offset));
+    obj.Set("byteOffset", Napi::Number::New(env, static_cast<double>(loc.byte_offset)));
     obj.Set("byteLength", Napi::Number::New(env, loc.byte_length));
     return obj;
 }
@@ -89,8 +135,9 @@ Napi::Object context_to_js(Napi::Env env, const ChunkContext& ctx) {
 
 /**
  * @brief Convert CodeChunk to JS object
+ * @param with_embedding Include the chunk's slice of the embedding pool
  */
-Napi::Object chunk_to_js(Napi::Env env, const CodeChunk& chunk) {
+Napi::Object chunk_to_js(Napi::Env env, const CodeChunk& chunk, bool with_embedding = false) {
     Napi::Object obj = Napi::Object::New(env);
 
     obj.Set("content", Napi::String::New(env, chunk.content));
@@ -100,52 +147,1043 @@ Napi::Object chunk_to_js(Napi::Env env, const CodeChunk& chunk) {
     obj.Set("context", context_to_js(env, chunk.context));
     obj.Set("chunkIndex", Napi::Number::New(env, chunk.chunk_index));
     obj.Set("hash", Napi::String::New(env, chunk.hash));
+    obj.Set("id", Napi::String::New(env, chunk.id));
+
+    if (with_embedding) {
+        obj.Set("embedOffset", Napi::Number::New(env, chunk.embed_offset));
+        obj.Set("embedLength", Napi::Number::New(env, chunk.embed_length));
+        obj.Set("embedTokenCount", Napi::Number::New(env, chunk.embed_token_count));
+    }
+
+    return obj;
+}
 
+/**
+ * @brief Convert SymbolHash to JS object (hash as 16 hex digits)
+ */
+Napi::Object symbol_to_js(Napi::Env env, const SymbolHash& symbol) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("name", Napi::String::New(env, symbol.name));
+    obj.Set("qualifiedName", Napi::String::New(env, symbol.qualified_name));
+    obj.Set("type", Napi::String::New(env, chunk_type_to_string(symbol.type)));
+    obj.Set("lineStart", Napi::Number::New(env, symbol.line_start));
+    obj.Set("lineEnd", Napi::Number::New(env, symbol.line_end));
+    obj.Set("byteOffset", Napi::Number::New(env, static_cast<double>(symbol.byte_offset)));
+    obj.Set("byteLength", Napi::Number::New(env, static_cast<double>(symbol.byte_length)));
+
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(symbol.hash));
+    obj.Set("hash", Napi::String::New(env, std::string(buf, 16)));
     return obj;
 }
 
+static Napi::Array symbols_to_js(Napi::Env env, const std::vector<SymbolHash>& symbols) {
+    Napi::Array arr = Napi::Array::New(env, symbols.size());
+    for (size_t i = 0; i < symbols.size(); i++) {
+        arr.Set(i, symbol_to_js(env, symbols[i]));
+    }
+    return arr;
+}
+
 /**
  * @brief Convert ChunkResult to JS object
  */
 Napi::Object result_to_js(Napi::Env env, const ChunkResult& result) {
     Napi::Object obj = Napi::Object::New(env);
 
+    bool with_embedding = !result.embed_pool.empty();
+
     Napi::Array chunks = Napi::Array::New(env, result.chunks.size());
     for (size_t i = 0; i < result.chunks.size(); i++) {
-        chunks.Set(i, chunk_to_js(env, result.chunks[i]));
+        chunks.Set(i, chunk_to_js(env, result.chunks[i], with_embedding));
     }
     obj.Set("chunks", chunks);
 
     obj.Set("totalTokens", Napi::Number::New(env, result.total_tokens));
     obj.Set("totalLines", Napi::Number::New(env, result.total_lines));
     obj.Set("chunkingTimeMs", Napi::Number::New(env, result.chunking_time_ms));
+    obj.Set("language", Napi::String::New(env, language_to_string(result.language)));
+    obj.Set("degraded", Napi::Boolean::New(env, result.degraded));
+    obj.Set("fileFlags", Napi::Number::New(env, result.file_flags));
+    obj.Set("skipped", Napi::Boolean::New(env, result.skipped));
+
+    if (!result.symbols.empty()) {
+        obj.Set("symbols", symbols_to_js(env, result.symbols));
+    }
+
+    // One buffer for all embedding texts; chunks carry offsets into it
+    if (with_embedding) {
+        obj.Set("embedText", Napi::Buffer<char>::Copy(env, result.embed_pool.data(), result.embed_pool.size()));
+    }
+
+    if (!result.error.empty()) {
+        obj.Set("error", Napi::String::New(env, result.error));
+    }
+
+    return obj;
+}
+
+/**
+ * @brief Convert ChunkType from its string name
+ */
+static ChunkType chunk_type_from_string(const std::string& name) {
+    for (uint8_t i = 0; i <= static_cast<uint8_t>(ChunkType::STATEMENT); i++) {
+        if (name == chunk_type_to_string(static_cast<ChunkType>(i))) {
+            return static_cast<ChunkType>(i);
+        }
+    }
+    return ChunkType::UNKNOWN;
+}
+
+static std::string string_field(const Napi::Object& obj, const char* key) {
+    Napi::Value value = obj.Get(key);
+    return value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+}
+
+static uint32_t uint_field(const Napi::Object& obj, const char* key) {
+    Napi::Value value = obj.Get(key);
+    return value.IsNumber() ? value.As<Napi::Number>().Uint32Value() : 0;
+}
+
+static uint64_t offset_field(const Napi::Object& obj, const char* key) {
+    Napi::Value value = obj.Get(key);
+    if (!value.IsNumber()) return 0;
+    int64_t v = value.As<Napi::Number>().Int64Value();
+    return v > 0 ? static_cast<uint64_t>(v) : 0;
+}
+
+/**
+ * @brief Convert CodeChunk from JS object
+ * @return false (with a pending JS exception) on invalid input
+ */
+static bool chunk_from_js(Napi::Env env, const Napi::Value& value, CodeChunk& chunk) {
+    if (!value.IsObject()) {
+        Napi::TypeError::New(env, "Chunk object expected").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    chunk.content = string_field(obj, "content");
+    chunk.token_count = uint_field(obj, "tokenCount");
+    chunk.type = chunk_type_from_string(string_field(obj, "type"));
+    chunk.chunk_index = uint_field(obj, "chunkIndex");
+    chunk.hash = string_field(obj, "hash");
+    chunk.id = string_field(obj, "id");
+
+    if (obj.Get("location").IsObject()) {
+        Napi::Object loc = obj.Get("location").As<Napi::Object>();
+        chunk.location.line_start = uint_field(loc, "lineStart");
+        chunk.location.line_end = uint_field(loc, "lineEnd");
+        chunk.location.column_start = uint_field(loc, "columnStart");
+        chunk.location.column_end = uint_field(loc, "columnEnd");
+        chunk.location.byte_offset = offset_field(loc, "byteOffset");
+        chunk.location.byte_length = uint_field(loc, "byteLength");
+    }
+
+    if (obj.Get("context").IsObject()) {
+        Napi::Object ctx = obj.Get("context").As<Napi::Object>();
+        chunk.context.parent_name = string_field(ctx, "parentName");
+        chunk.context.namespace_name = string_field(ctx, "namespaceName");
+        if (ctx.Get("imports").IsArray()) {
+            Napi::Array imports = ctx.Get("imports").As<Napi::Array>();
+            for (uint32_t i = 0; i < imports.Length(); i++) {
+                Napi::Value import_line = imports.Get(i);
+                if (!import_line.IsString()) {
+                    Napi::TypeError::New(env, "Chunk context imports must be strings")
+                        .ThrowAsJavaScriptException();
+                    return false;
+                }
+                chunk.context.imports.push_back(import_line.As<Napi::String>().Utf8Value());
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Convert SymbolHash from JS object
+ */
+SymbolHash symbol_from_js(const Napi::Object& obj) {
+    SymbolHash symbol;
+    symbol.name = string_field(obj, "name");
+    symbol.qualified_name = string_field(obj, "qualifiedName");
+    symbol.type = chunk_type_from_string(string_field(obj, "type"));
+    symbol.line_start = uint_field(obj, "lineStart");
+    symbol.line_end = uint_field(obj, "lineEnd");
+    symbol.byte_offset = offset_field(obj, "byteOffset");
+    symbol.byte_length = offset_field(obj, "byteLength");
+    symbol.hash = std::strtoull(string_field(obj, "hash").c_str(), nullptr, 16);
+    return symbol;
+}
+
+static void symbols_from_js(const Napi::Value& value, std::vector<SymbolHash>& out) {
+    if (!value.IsArray()) return;
+    Napi::Array arr = value.As<Napi::Array>();
+    out.reserve(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Value item = arr.Get(i);
+        if (item.IsObject()) out.push_back(symbol_from_js(item.As<Napi::Object>()));
+    }
+}
+
+/**
+ * @brief Convert ChunkResult from a JS object or a buffer from exportChunks
+ * @return false (with a pending JS exception) on invalid input
+ */
+static bool result_from_js(Napi::Env env, const Napi::Value& value, ChunkResult& out) {
+    if (value.IsBuffer()) {
+        Napi::Buffer<uint8_t> buffer = value.As<Napi::Buffer<uint8_t>>();
+        std::string filepath;
+        if (!import_chunks(buffer.Data(), buffer.Length(), out, filepath)) {
+            Napi::Error::New(env, "Invalid chunk export").ThrowAsJavaScriptException();
+            return false;
+        }
+        return true;
+    }
+
+    if (!value.IsObject() || !value.As<Napi::Object>().Get("chunks").IsArray()) {
+        Napi::TypeError::New(env, "ChunkResult or chunk export buffer expected")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    Napi::Array chunks = obj.Get("chunks").As<Napi::Array>();
+    out.chunks.resize(chunks.Length());
+    for (uint32_t i = 0; i < chunks.Length(); i++) {
+        if (!chunk_from_js(env, chunks.Get(i), out.chunks[i])) return false;
+    }
+    symbols_from_js(obj.Get("symbols"), out.symbols);
+    out.total_tokens = uint_field(obj, "totalTokens");
+    out.total_lines = uint_field(obj, "totalLines");
+    out.chunking_time_ms = 0;
+    return true;
+}
+
+/**
+ * @brief Convert ChunkDelta to JS object
+ */
+Napi::Object delta_to_js(Napi::Env env, const ChunkDelta& delta) {
+    Napi::Object obj = Napi::Object::New(env);
+
+    Napi::Array upserts = Napi::Array::New(env, delta.upserts.size());
+    for (size_t i = 0; i < delta.upserts.size(); i++) {
+        upserts.Set(i, chunk_to_js(env, delta.upserts[i]));
+    }
+    obj.Set("upserts", upserts);
+
+    Napi::Array updates = Napi::Array::New(env, delta.updates.size());
+    for (size_t i = 0; i < delta.updates.size(); i++) {
+        updates.Set(i, chunk_to_js(env, delta.updates[i]));
+    }
+    obj.Set("updates", updates);
+
+    Napi::Array deletes = Napi::Array::New(env, delta.deletes.size());
+    for (size_t i = 0; i < delta.deletes.size(); i++) {
+        deletes.Set(i, Napi::String::New(env, delta.deletes[i]));
+    }
+    obj.Set("deletes", deletes);
+
+    obj.Set("unchanged", Napi::Number::New(env, delta.unchanged));
+    return obj;
+}
+
+/**
+ * @brief Convert SymbolDelta to JS object
+ */
+Napi::Object symbol_delta_to_js(Napi::Env env, const SymbolDelta& delta) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("added", symbols_to_js(env, delta.added));
+    obj.Set("removed", symbols_to_js(env, delta.removed));
+
+    auto changes_to_js = [&](const std::vector<SymbolChange>& changes) {
+        Napi::Array arr = Napi::Array::New(env, changes.size());
+        for (size_t i = 0; i < changes.size(); i++) {
+            Napi::Object change = Napi::Object::New(env);
+            change.Set("before", symbol_to_js(env, changes[i].before));
+            change.Set("after", symbol_to_js(env, changes[i].after));
+            arr.Set(i, change);
+        }
+        return arr;
+    };
+    obj.Set("changed", changes_to_js(delta.changed));
+    obj.Set("moved", changes_to_js(delta.moved));
+
+    obj.Set("unchanged", Napi::Number::New(env, delta.unchanged));
+    return obj;
+}
+
+/**
+ * @brief Wrapper class for ChunkCache
+ */
+class ChunkCacheWrapper : public Napi::ObjectWrap<ChunkCacheWrapper> {
+public:
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "ChunkCache", {
+            InstanceMethod("stats", &ChunkCacheWrapper::Stats),
+            InstanceMethod("flush", &ChunkCacheWrapper::Flush),
+            InstanceMethod("clear", &ChunkCacheWrapper::Clear),
+        });
+
+        exports.Set("ChunkCache", func);
+        return func;
+    }
+
+    ChunkCacheWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<ChunkCacheWrapper>(info) {
+        uint64_t byte_budget = 64ull * 1024 * 1024;
+        std::string spill_path;
+        uint64_t spill_budget = 0;
+
+        if (info.Length() > 0 && info[0].IsObject()) {
+            Napi::Object opts = info[0].As<Napi::Object>();
+            if (opts.Has("byteBudget")) {
+                byte_budget = static_cast<uint64_t>(opts.Get("byteBudget").As<Napi::Number>().DoubleValue());
+            }
+            if (opts.Has("spillPath") && opts.Get("spillPath").IsString()) {
+                spill_path = opts.Get("spillPath").As<Napi::String>().Utf8Value();
+            }
+            if (opts.Has("spillBudget") && opts.Get("spillBudget").IsNumber()) {
+                spill_budget = static_cast<uint64_t>(opts.Get("spillBudget").As<Napi::Number>().DoubleValue());
+            }
+        }
+
+        cache_ = std::make_shared<ChunkCache>(byte_budget, spill_path, spill_budget);
+    }
+
+    std::shared_ptr<ChunkCache> get_cache() const { return cache_; }
+
+private:
+    std::shared_ptr<ChunkCache> cache_;
+
+    /**
+     * @brief stats(): ChunkCacheStats
+     */
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        ChunkCacheStats stats = cache_->stats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+        obj.Set("spillHits", Napi::Number::New(env, static_cast<double>(stats.spill_hits)));
+        obj.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+        obj.Set("evictions", Napi::Number::New(env, static_cast<double>(stats.evictions)));
+        obj.Set("bytesUsed", Napi::Number::New(env, static_cast<double>(stats.bytes_used)));
+        obj.Set("byteBudget", Napi::Number::New(env, static_cast<double>(stats.byte_budget)));
+        obj.Set("entries", Napi::Number::New(env, stats.entries));
+        obj.Set("spilled", Napi::Number::New(env, stats.spilled));
+        obj.Set("spillBytes", Napi::Number::New(env, static_cast<double>(stats.spill_bytes)));
+        obj.Set("compactions", Napi::Number::New(env, static_cast<double>(stats.compactions)));
+        return obj;
+    }
+
+    /**
+     * @brief flush(): boolean
+     */
+    Napi::Value Flush(const Napi::CallbackInfo& info) {
+        return Napi::Boolean::New(info.Env(), cache_->flush());
+    }
+
+    /**
+     * @brief clear(): void
+     */
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        cache_->clear();
+        return info.Env().Undefined();
+    }
+};
+
+/**
+ * @brief Wrapper class for ParseCache
+ */
+class ParseCacheWrapper : public Napi::ObjectWrap<ParseCacheWrapper> {
+public:
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "ParseCache", {
+            InstanceMethod("get", &ParseCacheWrapper::Get),
+            InstanceMethod("has", &ParseCacheWrapper::Has),
+            InstanceMethod("put", &ParseCacheWrapper::Put),
+            InstanceMethod("flush", &ParseCacheWrapper::Flush),
+            InstanceMethod("clear", &ParseCacheWrapper::Clear),
+            InstanceMethod("compact", &ParseCacheWrapper::Compact),
+            InstanceMethod("stats", &ParseCacheWrapper::Stats),
+        });
+
+        exports.Set("ParseCache", func);
+        return func;
+    }
+
+    ParseCacheWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<ParseCacheWrapper>(info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsObject() ||
+            !info[0].As<Napi::Object>().Get("path").IsString()) {
+            Napi::TypeError::New(env, "Options with a path string expected").ThrowAsJavaScriptException();
+            return;
+        }
+
+        std::string path = info[0].As<Napi::Object>().Get("path").As<Napi::String>().Utf8Value();
+        cache_ = std::make_unique<ParseCache>(path);
+        if (!cache_->is_open()) {
+            Napi::Error::New(env, "Cannot open parse cache: " + path).ThrowAsJavaScriptException();
+        }
+    }
+
+private:
+    std::unique_ptr<ParseCache> cache_;
+
+    /**
+     * @brief get(contentHash: string, fingerprint: string): Buffer | null
+     */
+    Napi::Value Get(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        uint64_t content_hash = info.Length() > 0 ? content_hash_from_js(info[0]) : 0;
+        uint64_t fingerprint = info.Length() > 1 ? content_hash_from_js(info[1]) : 0;
+
+        std::vector<uint8_t> payload;
+        if (content_hash == 0 || !cache_->get(content_hash, fingerprint, payload)) {
+            return env.Null();
+        }
+        return Napi::Buffer<uint8_t>::Copy(env, payload.data(), payload.size());
+    }
+
+    /**
+     * @brief has(contentHash: string, fingerprint: string): boolean
+     */
+    Napi::Value Has(const Napi::CallbackInfo& info) {
+        uint64_t content_hash = info.Length() > 0 ? content_hash_from_js(info[0]) : 0;
+        uint64_t fingerprint = info.Length() > 1 ? content_hash_from_js(info[1]) : 0;
+        return Napi::Boolean::New(info.Env(), content_hash != 0 && cache_->contains(content_hash, fingerprint));
+    }
+
+    /**
+     * @brief put(contentHash: string, fingerprint: string, payload: Buffer): boolean
+     */
+    Napi::Value Put(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 3 || !info[2].IsBuffer()) {
+            Napi::TypeError::New(env, "Content hash, fingerprint and Buffer expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint64_t content_hash = content_hash_from_js(info[0]);
+        uint64_t fingerprint = content_hash_from_js(info[1]);
+        Napi::Buffer<uint8_t> payload = info[2].As<Napi::Buffer<uint8_t>>();
+        return Napi::Boolean::New(env, cache_->put(content_hash, fingerprint, payload.Data(), payload.Length()));
+    }
+
+    /**
+     * @brief flush(): boolean
+     */
+    Napi::Value Flush(const Napi::CallbackInfo& info) {
+        return Napi::Boolean::New(info.Env(), cache_->flush());
+    }
+
+    /**
+     * @brief clear(): void
+     */
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        cache_->clear();
+        return info.Env().Undefined();
+    }
+
+    /**
+     * @brief compact(liveHashes: string[]): number
+     */
+    Napi::Value Compact(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of content hashes expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array arr = info[0].As<Napi::Array>();
+        std::vector<uint64_t> live;
+        live.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            uint64_t hash = content_hash_from_js(arr.Get(i));
+            if (hash != 0) live.push_back(hash);
+        }
+        return Napi::Number::New(env, cache_->compact(live));
+    }
+
+    /**
+     * @brief stats(): ParseCacheStats
+     */
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        ParseCacheStats stats = cache_->stats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+        obj.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+        obj.Set("stores", Napi::Number::New(env, static_cast<double>(stats.stores)));
+        obj.Set("entries", Napi::Number::New(env, stats.entries));
+        obj.Set("fileBytes", Napi::Number::New(env, static_cast<double>(stats.file_bytes)));
+        return obj;
+    }
+};
+
+/**
+ * @brief Role names used on the JS side
+ */
+static const char* role_to_string(OccurrenceRole role) {
+    switch (role) {
+        case OccurrenceRole::DEFINITION: return "definition";
+        case OccurrenceRole::IMPORT: return "import";
+        default: return "reference";
+    }
+}
+
+// Role mask from a role name array (all roles when absent)
+static uint32_t roles_from_js(const Napi::Value& value) {
+    if (!value.IsArray()) return IdentifierIndex::ALL_ROLES;
+    Napi::Array arr = value.As<Napi::Array>();
+    uint32_t roles = 0;
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        std::string name = arr.Get(i).As<Napi::String>().Utf8Value();
+        if (name == "definition") roles |= static_cast<uint32_t>(OccurrenceRole::DEFINITION);
+        else if (name == "import") roles |= static_cast<uint32_t>(OccurrenceRole::IMPORT);
+        else if (name == "reference") roles |= static_cast<uint32_t>(OccurrenceRole::REFERENCE);
+    }
+    return roles;
+}
+
+/**
+ * @brief Wrapper class for IdentifierIndex
+ */
+class IdentifierIndexWrapper : public Napi::ObjectWrap<IdentifierIndexWrapper> {
+public:
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "IdentifierIndex", {
+            InstanceMethod("updateFile", &IdentifierIndexWrapper::UpdateFile),
+            InstanceMethod("removeFile", &IdentifierIndexWrapper::RemoveFile),
+            InstanceMethod("renameFile", &IdentifierIndexWrapper::RenameFile),
+            InstanceMethod("occurrences", &IdentifierIndexWrapper::Occurrences),
+            InstanceMethod("count", &IdentifierIndexWrapper::Count),
+            InstanceMethod("files", &IdentifierIndexWrapper::Files),
+            InstanceMethod("callSites", &IdentifierIndexWrapper::CallSites),
+            InstanceMethod("callees", &IdentifierIndexWrapper::Callees),
+            InstanceMethod("stats", &IdentifierIndexWrapper::Stats),
+            InstanceMethod("clear", &IdentifierIndexWrapper::Clear),
+        });
+
+        exports.Set("IdentifierIndex", func);
+        return func;
+    }
+
+    IdentifierIndexWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<IdentifierIndexWrapper>(info),
+          index_(std::make_shared<IdentifierIndex>()) {}
+
+    std::shared_ptr<IdentifierIndex> get_index() const { return index_; }
+
+private:
+    std::shared_ptr<IdentifierIndex> index_;
+
+    /**
+     * @brief updateFile(path: string, source: string, language?: string, contentHash?: string): boolean
+     */
+    Napi::Value UpdateFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+            Napi::TypeError::New(env, "Path and source strings expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string path = info[0].As<Napi::String>().Utf8Value();
+        std::string source = info[1].As<Napi::String>().Utf8Value();
+        Language language = info.Length() > 2 && info[2].IsString()
+            ? language_from_string(info[2].As<Napi::String>().Utf8Value())
+            : Language::UNKNOWN;
+        uint64_t content_hash = info.Length() > 3 ? content_hash_from_js(info[3]) : 0;
+
+        return Napi::Boolean::New(env, index_->update_file(path, source, language, content_hash));
+    }
+
+    /**
+     * @brief removeFile(path: string): boolean
+     */
+    Napi::Value RemoveFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Path string expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        return Napi::Boolean::New(env, index_->remove_file(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    /**
+     * @brief renameFile(oldPath: string, newPath: string): boolean
+     */
+    Napi::Value RenameFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+            Napi::TypeError::New(env, "Old and new path strings expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        return Napi::Boolean::New(env, index_->rename_file(info[0].As<Napi::String>().Utf8Value(),
+                                                           info[1].As<Napi::String>().Utf8Value()));
+    }
+
+    // Name, role mask and file filter of a query: (name, { roles?, file? })
+    bool query_from_js(const Napi::CallbackInfo& info, std::string& name, uint32_t& roles, std::string& path) {
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(info.Env(), "Identifier name expected").ThrowAsJavaScriptException();
+            return false;
+        }
+        name = info[0].As<Napi::String>().Utf8Value();
+        roles = IdentifierIndex::ALL_ROLES;
+        if (info.Length() > 1 && info[1].IsObject()) {
+            Napi::Object opts = info[1].As<Napi::Object>();
+            roles = roles_from_js(opts.Get("roles"));
+            if (opts.Get("file").IsString()) path = opts.Get("file").As<Napi::String>().Utf8Value();
+        }
+        return true;
+    }
+
+    /**
+     * @brief occurrences(name: string, options?: { roles?: string[], file?: string }): IdentifierOccurrence[]
+     */
+    Napi::Value Occurrences(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string name, path;
+        uint32_t roles;
+        if (!query_from_js(info, name, roles, path)) return env.Undefined();
+
+        std::vector<IdentifierOccurrence> found = index_->occurrences(name, roles, path);
+        Napi::Array arr = Napi::Array::New(env, found.size());
+        uint32_t last_file = UINT32_MAX;
+        Napi::String file_str;
+        for (size_t i = 0; i < found.size(); i++) {
+            const IdentifierOccurrence& occurrence = found[i];
+            // Occurrences come grouped by file; convert each path once
+            if (occurrence.file != last_file) {
+                last_file = occurrence.file;
+                file_str = Napi::String::New(env, index_->file_path(occurrence.file));
+            }
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("file", file_str);
+            obj.Set("offset", Napi::Number::New(env, occurrence.offset));
+            obj.Set("line", Napi::Number::New(env, occurrence.line));
+            obj.Set("column", Napi::Number::New(env, occurrence.column));
+            obj.Set("role", Napi::String::New(env, role_to_string(occurrence.role)));
+            arr.Set(static_cast<uint32_t>(i), obj);
+        }
+        return arr;
+    }
+
+    /**
+     * @brief count(name: string, options?: { roles?: string[], file?: string }): number
+     */
+    Napi::Value Count(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string name, path;
+        uint32_t roles;
+        if (!query_from_js(info, name, roles, path)) return env.Undefined();
+        return Napi::Number::New(env, index_->count(name, roles, path));
+    }
+
+    /**
+     * @brief files(name: string, options?: { roles?: string[] }): string[]
+     */
+    Napi::Value Files(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string name, path;
+        uint32_t roles;
+        if (!query_from_js(info, name, roles, path)) return env.Undefined();
+
+        std::vector<std::string> paths = index_->files(name, roles);
+        Napi::Array arr = Napi::Array::New(env, paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            arr.Set(static_cast<uint32_t>(i), Napi::String::New(env, paths[i]));
+        }
+        return arr;
+    }
+
+    Napi::Array call_sites_to_js(Napi::Env env, const std::vector<CallSite>& sites) {
+        Napi::Array arr = Napi::Array::New(env, sites.size());
+        uint32_t last_file = UINT32_MAX;
+        Napi::String file_str;
+        for (size_t i = 0; i < sites.size(); i++) {
+            const CallSite& site = sites[i];
+            if (site.file != last_file) {
+                last_file = site.file;
+                file_str = Napi::String::New(env, index_->file_path(site.file));
+            }
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("file", file_str);
+            obj.Set("offset", Napi::Number::New(env, site.offset));
+            obj.Set("line", Napi::Number::New(env, site.line));
+            obj.Set("column", Napi::Number::New(env, site.column));
+            obj.Set("callee", Napi::String::New(env, site.callee));
+            obj.Set("caller", site.caller.empty() ? env.Null() : Napi::String::New(env, site.caller));
+            arr.Set(static_cast<uint32_t>(i), obj);
+        }
+        return arr;
+    }
+
+    /**
+     * @brief callSites(name: string, options?: { file?: string }): CallSite[]
+     */
+    Napi::Value CallSites(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string name, path;
+        uint32_t roles;
+        if (!query_from_js(info, name, roles, path)) return env.Undefined();
+        return call_sites_to_js(env, index_->call_sites(name, path));
+    }
+
+    /**
+     * @brief callees(name: string, options?: { file?: string }): CallSite[]
+     */
+    Napi::Value Callees(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string name, path;
+        uint32_t roles;
+        if (!query_from_js(info, name, roles, path)) return env.Undefined();
+        return call_sites_to_js(env, index_->callees(name, path));
+    }
+
+    /**
+     * @brief stats(): IdentifierIndexStats
+     */
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        IdentifierIndexStats stats = index_->stats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("files", Napi::Number::New(env, stats.file_count));
+        obj.Set("identifiers", Napi::Number::New(env, stats.identifier_count));
+        obj.Set("occurrences", Napi::Number::New(env, static_cast<double>(stats.occurrence_count)));
+        obj.Set("calls", Napi::Number::New(env, static_cast<double>(stats.call_count)));
+        obj.Set("updates", Napi::Number::New(env, static_cast<double>(stats.updates)));
+        obj.Set("skippedUpdates", Napi::Number::New(env, static_cast<double>(stats.skipped_updates)));
+        obj.Set("indexTimeMs", Napi::Number::New(env, stats.index_time_ms));
+        return obj;
+    }
+
+    /**
+     * @brief clear(): void
+     */
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        index_->clear();
+        return info.Env().Undefined();
+    }
+};
+
+/**
+ * @brief Wrapper class for AstArena
+ *
+ * Trees are passed flat: a kind name table plus a Uint32Array with
+ * AST_NODE_STRIDE values per node in preorder (see setFile).
+ */
+class AstArenaWrapper : public Napi::ObjectWrap<AstArenaWrapper> {
+public:
+    static constexpr uint32_t AST_NODE_STRIDE = 9;
+    static constexpr uint32_t AST_ERROR_BIT = 0x80000000u;
+
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "AstArena", {
+            InstanceMethod("setFile", &AstArenaWrapper::SetFile),
+            InstanceMethod("removeFile", &AstArenaWrapper::RemoveFile),
+            InstanceMethod("hasFile", &AstArenaWrapper::HasFile),
+            InstanceMethod("files", &AstArenaWrapper::Files),
+            InstanceMethod("nodeCount", &AstArenaWrapper::NodeCount),
+            InstanceMethod("node", &AstArenaWrapper::Node),
+            InstanceMethod("children", &AstArenaWrapper::Children),
+            InstanceMethod("find", &AstArenaWrapper::Find),
+            InstanceMethod("walk", &AstArenaWrapper::Walk),
+            InstanceMethod("text", &AstArenaWrapper::Text),
+            InstanceMethod("stats", &AstArenaWrapper::Stats),
+            InstanceMethod("clear", &AstArenaWrapper::Clear),
+        });
+
+        exports.Set("AstArena", func);
+        return func;
+    }
+
+    AstArenaWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<AstArenaWrapper>(info),
+          arena_(std::make_unique<AstArena>()) {}
+
+private:
+    std::unique_ptr<AstArena> arena_;
+
+    // (path, id) arguments shared by the node queries
+    bool node_args(const Napi::CallbackInfo& info, std::string& path, uint32_t& id) {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+            Napi::TypeError::New(info.Env(), "File path and node id expected").ThrowAsJavaScriptException();
+            return false;
+        }
+        path = info[0].As<Napi::String>().Utf8Value();
+        id = info[1].As<Napi::Number>().Uint32Value();
+        return true;
+    }
+
+    static Napi::Uint32Array ids_to_js(Napi::Env env, const std::vector<uint32_t>& ids) {
+        Napi::Uint32Array arr = Napi::Uint32Array::New(env, ids.size());
+        if (!ids.empty()) std::memcpy(arr.Data(), ids.data(), ids.size() * sizeof(uint32_t));
+        return arr;
+    }
+
+    /**
+     * @brief setFile(path: string, source: string, kinds: string[], nodes: Uint32Array): void
+     *
+     * Per node: kind (| AST_ERROR_BIT), parent, start, end, startRow,
+     * startColumn, endRow, endColumn, nameNode; 0xFFFFFFFF for none.
+     */
+    Napi::Value SetFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 4 || !info[0].IsString() || !info[1].IsString() ||
+            !info[2].IsArray() || !info[3].IsTypedArray()) {
+            Napi::TypeError::New(env, "Path, source, kind names and node array expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string path = info[0].As<Napi::String>().Utf8Value();
+        Napi::Array kinds_arr = info[2].As<Napi::Array>();
+        std::vector<std::string> kinds;
+        kinds.reserve(kinds_arr.Length());
+        for (uint32_t i = 0; i < kinds_arr.Length(); i++) {
+            kinds.push_back(kinds_arr.Get(i).As<Napi::String>().Utf8Value());
+        }
+
+        Napi::Uint32Array packed = info[3].As<Napi::Uint32Array>();
+        if (packed.ElementLength() % AST_NODE_STRIDE != 0) {
+            Napi::RangeError::New(env, "Node array length must be a multiple of 9").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        const uint32_t* data = packed.Data();
+        std::vector<AstNodeInput> nodes(packed.ElementLength() / AST_NODE_STRIDE);
+        for (size_t i = 0; i < nodes.size(); i++, data += AST_NODE_STRIDE) {
+            nodes[i].kind = data[0] & ~AST_ERROR_BIT;
+            nodes[i].error = (data[0] & AST_ERROR_BIT) != 0;
+            nodes[i].parent = data[1];
+            nodes[i].start = data[2];
+            nodes[i].end = data[3];
+            nodes[i].start_row = data[4];
+            nodes[i].start_column = data[5];
+            nodes[i].end_row = data[6];
+            nodes[i].end_column = data[7];
+            nodes[i].name_node = data[8];
+        }
+
+        std::string error;
+        if (!arena_->set_file(path, info[1].As<Napi::String>().Utf16Value(), kinds, nodes, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    /**
+     * @brief removeFile(path: string): boolean
+     */
+    Napi::Value RemoveFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "File path expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        return Napi::Boolean::New(env, arena_->remove_file(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    /**
+     * @brief hasFile(path: string): boolean
+     */
+    Napi::Value HasFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "File path expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        return Napi::Boolean::New(env, arena_->has_file(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    /**
+     * @brief files(): string[]
+     */
+    Napi::Value Files(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::vector<std::string> paths = arena_->files();
+        Napi::Array arr = Napi::Array::New(env, paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            arr.Set(static_cast<uint32_t>(i), Napi::String::New(env, paths[i]));
+        }
+        return arr;
+    }
+
+    /**
+     * @brief nodeCount(path: string): number
+     */
+    Napi::Value NodeCount(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "File path expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        return Napi::Number::New(env, arena_->node_count(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    /**
+     * @brief node(path: string, id: number): AstNodeInfo | null
+     */
+    Napi::Value Node(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string path;
+        uint32_t id;
+        if (!node_args(info, path, id)) return env.Undefined();
+
+        AstNodeInfo node;
+        if (!arena_->node(path, id, node)) return env.Null();
+
+        auto index = [&env](uint32_t value) {
+            return Napi::Number::New(env, value == AstArena::NO_NODE ? -1.0 : static_cast<double>(value));
+        };
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("id", Napi::Number::New(env, id));
+        obj.Set("type", Napi::String::New(env, arena_->kind_name(node.kind)));
+        obj.Set("name", node.name == AstArena::NO_NODE
+            ? Napi::String::New(env, "") : Napi::String::New(env, arena_->name(node.name)));
+        obj.Set("parent", index(node.parent));
+        obj.Set("firstChild", index(node.first_child));
+        obj.Set("nextSibling", index(node.next_sibling));
+        obj.Set("subtreeEnd", Napi::Number::New(env, node.subtree_end));
+        obj.Set("childCount", Napi::Number::New(env, node.child_count));
+        obj.Set("start", Napi::Number::New(env, node.start));
+        obj.Set("end", Napi::Number::New(env, node.end));
+        obj.Set("startLine", Napi::Number::New(env, node.start_row));
+        obj.Set("startColumn", Napi::Number::New(env, node.start_column));
+        obj.Set("endLine", Napi::Number::New(env, node.end_row));
+        obj.Set("endColumn", Napi::Number::New(env, node.end_column));
+        obj.Set("hasError", Napi::Boolean::New(env, node.has_error));
+        return obj;
+    }
+
+    /**
+     * @brief children(path: string, id: number): Uint32Array
+     */
+    Napi::Value Children(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string path;
+        uint32_t id;
+        if (!node_args(info, path, id)) return env.Undefined();
+        return ids_to_js(env, arena_->children(path, id));
+    }
+
+    /**
+     * @brief find(path: string, kinds: string[], root?: number, firstOnly?: boolean): Uint32Array
+     */
+    Napi::Value Find(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+            Napi::TypeError::New(env, "File path and kind names expected").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string path = info[0].As<Napi::String>().Utf8Value();
+        Napi::Array kinds_arr = info[1].As<Napi::Array>();
+        std::vector<std::string> kinds;
+        for (uint32_t i = 0; i < kinds_arr.Length(); i++) {
+            kinds.push_back(kinds_arr.Get(i).As<Napi::String>().Utf8Value());
+        }
+        uint32_t root = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value() : 0;
+        bool first_only = info.Length() > 3 && info[3].IsBoolean() && info[3].As<Napi::Boolean>().Value();
+
+        return ids_to_js(env, arena_->find(path, kinds, root, first_only));
+    }
+
+    /**
+     * @brief walk(path: string, root: number, maxDepth?: number): { ids: Uint32Array, depths: Uint32Array }
+     */
+    Napi::Value Walk(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string path;
+        uint32_t root;
+        if (!node_args(info, path, root)) return env.Undefined();
+        uint32_t max_depth = info.Length() > 2 && info[2].IsNumber()
+            ? info[2].As<Napi::Number>().Uint32Value() : UINT32_MAX;
+
+        auto walked = arena_->walk(path, root, max_depth);
+        Napi::Uint32Array ids = Napi::Uint32Array::New(env, walked.size());
+        Napi::Uint32Array depths = Napi::Uint32Array::New(env, walked.size());
+        for (size_t i = 0; i < walked.size(); i++) {
+            ids.Data()[i] = walked[i].first;
+            depths.Data()[i] = walked[i].second;
+        }
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("ids", ids);
+        obj.Set("depths", depths);
+        return obj;
+    }
+
+    /**
+     * @brief text(path: string, id: number, maxLength?: number): string
+     */
+    Napi::Value Text(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string path;
+        uint32_t id;
+        if (!node_args(info, path, id)) return env.Undefined();
+        uint32_t max_length = info.Length() > 2 && info[2].IsNumber()
+            ? info[2].As<Napi::Number>().Uint32Value() : 0;
+        return Napi::String::New(env, arena_->text(path, id, max_length));
+    }
+
+    /**
+     * @brief stats(): AstArenaStats
+     */
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        AstArenaStats stats = arena_->stats();
 
-    if (!result.error.empty()) {
-        obj.Set("error", Napi::String::New(env, result.error));
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("files", Napi::Number::New(env, stats.file_count));
+        obj.Set("nodes", Napi::Number::New(env, static_cast<double>(stats.node_count)));
+        obj.Set("kinds", Napi::Number::New(env, stats.kind_count));
+        obj.Set("names", Napi::Number::New(env, stats.name_count));
+        obj.Set("sourceBytes", Napi::Number::New(env, static_cast<double>(stats.source_bytes)));
+        obj.Set("nodeBytes", Napi::Number::New(env, static_cast<double>(stats.node_bytes)));
+        return obj;
     }
 
-    return obj;
-}
+    /**
+     * @brief clear(): void
+     */
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        arena_->clear();
+        return info.Env().Undefined();
+    }
+};
 
 /**
  * @brief Wrapper class for Chunker
  */
 class ChunkerWrapper : public Napi::ObjectWrap<ChunkerWrapper> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
         Napi::Function func = DefineClass(env, "Chunker", {
             InstanceMethod("chunk", &ChunkerWrapper::Chunk),
             InstanceMethod("chunkFile", &ChunkerWrapper::ChunkFile),
+            InstanceMethod("chunkFileExport", &ChunkerWrapper::ChunkFileExport),
+            InstanceMethod("embedFiles", &ChunkerWrapper::EmbedFiles),
+            InstanceMethod("setCache", &ChunkerWrapper::SetCache),
+            InstanceMethod("setIdentifierIndex", &ChunkerWrapper::SetIdentifierIndex),
             InstanceMethod("setConfig", &ChunkerWrapper::SetConfig),
             InstanceMethod("getConfig", &ChunkerWrapper::GetConfig),
         });
 
-        Napi::FunctionReference* constructor = new Napi::FunctionReference();
-        *constructor = Napi::Persistent(func);
-        env.SetInstanceData(constructor);
-
         exports.Set("Chunker", func);
-        return exports;
+        return func;
     }
 
     ChunkerWrapper(const Napi::CallbackInfo& info)
@@ -162,9 +1200,10 @@ public:
 
 private:
     std::unique_ptr<Chunker> chunker_;
+    Tokenizer tokenizer_;
 
     /**
-     * @brief chunk(source: string, filepath?: string): ChunkResult
+     * @brief chunk(source: string, filepath?: string, contentHash?: string, fileFlags?: number): ChunkResult
      */
     Napi::Value Chunk(const Napi::CallbackInfo& info) {
         Napi::Env env = info.Env();
@@ -182,12 +1221,15 @@ private:
             filepath = info[1].As<Napi::String>().Utf8Value();
         }
 
-        ChunkResult result = chunker_->chunk(source, filepath);
+        uint64_t content_hash = info.Length() > 2 ? content_hash_from_js(info[2]) : 0;
+        uint8_t file_flags = info.Length() > 3 ? file_flags_from_js(info[3]) : 0;
+
+        ChunkResult result = chunker_->chunk(source, filepath, content_hash, file_flags);
         return result_to_js(env, result);
     }
 
     /**
-     * @brief chunkFile(filepath: string): ChunkResult
+     * @brief chunkFile(filepath: string, contentHash?: string, fileFlags?: number): ChunkResult
      */
     Napi::Value ChunkFile(const Napi::CallbackInfo& info) {
         Napi::Env env = info.Env();
@@ -199,7 +1241,9 @@ private:
         }
 
         std::string filepath = info[0].As<Napi::String>().Utf8Value();
-        ChunkResult result = chunker_->chunk_file(filepath);
+        uint64_t content_hash = info.Length() > 1 ? content_hash_from_js(info[1]) : 0;
+        uint8_t file_flags = info.Length() > 2 ? file_flags_from_js(info[2]) : 0;
+        ChunkResult result = chunker_->chunk_file(filepath, content_hash, file_flags);
 
         if (!result.error.empty()) {
             Napi::Error::New(env, result.error).ThrowAsJavaScriptException();
@@ -209,6 +1253,168 @@ private:
         return result_to_js(env, result);
     }
 
+    /**
+     * @brief chunkFileExport(filepath: string, contentHash?: string, fileFlags?: number): Buffer
+     *
+     * Same as chunkFile, but returns the compact binary export without
+     * materializing chunk objects in JS.
+     */
+    Napi::Value ChunkFileExport(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "File path expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string filepath = info[0].As<Napi::String>().Utf8Value();
+        uint64_t content_hash = info.Length() > 1 ? content_hash_from_js(info[1]) : 0;
+        uint8_t file_flags = info.Length() > 2 ? file_flags_from_js(info[2]) : 0;
+        ChunkResult result = chunker_->chunk_file(filepath, content_hash, file_flags);
+
+        if (!result.error.empty()) {
+            Napi::Error::New(env, result.error).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::vector<uint8_t> bytes = export_chunks(result, filepath);
+        return Napi::Buffer<uint8_t>::Copy(env, bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief embedFiles(filepaths: string[], contentHashes?: string[], fileFlags?: number[]): EmbeddingBatch
+     *
+     * Chunks several files and packs the embedding text of every chunk into
+     * one buffer, with parallel typed arrays for offsets, token counts and
+     * the owning file. Builds embedding text even when embedText is off.
+     */
+    Napi::Value EmbedFiles(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of file paths expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array paths = info[0].As<Napi::Array>();
+        Napi::Array hashes = (info.Length() > 1 && info[1].IsArray())
+            ? info[1].As<Napi::Array>() : Napi::Array::New(env);
+        Napi::Array flags = (info.Length() > 2 && info[2].IsArray())
+            ? info[2].As<Napi::Array>() : Napi::Array::New(env);
+
+        std::vector<std::string> filepaths(paths.Length());
+        std::vector<ChunkResult> results(paths.Length());
+        size_t total_chunks = 0;
+        size_t total_bytes = 0;
+
+        for (uint32_t i = 0; i < paths.Length(); i++) {
+            filepaths[i] = paths.Get(i).As<Napi::String>().Utf8Value();
+            uint64_t content_hash = i < hashes.Length() ? content_hash_from_js(hashes.Get(i)) : 0;
+            uint8_t file_flags = i < flags.Length() ? file_flags_from_js(flags.Get(i)) : 0;
+
+            ChunkResult& result = results[i];
+            result = chunker_->chunk_file(filepaths[i], content_hash, file_flags);
+            if (result.error.empty() && result.embed_pool.empty() && !result.chunks.empty()) {
+                build_embedding_text(result, filepaths[i], result.language,
+                                     chunker_->get_config(), tokenizer_);
+            }
+            total_chunks += result.chunks.size();
+            total_bytes += result.embed_pool.size();
+        }
+
+        Napi::Buffer<char> text = Napi::Buffer<char>::New(env, total_bytes);
+        Napi::Uint32Array offsets = Napi::Uint32Array::New(env, total_chunks + 1);
+        Napi::Uint32Array token_counts = Napi::Uint32Array::New(env, total_chunks);
+        Napi::Uint32Array file_index = Napi::Uint32Array::New(env, total_chunks);
+        Napi::Array ids = Napi::Array::New(env, total_chunks);
+        Napi::Array errors = Napi::Array::New(env);
+
+        size_t chunk_pos = 0;
+        size_t byte_pos = 0;
+        for (size_t i = 0; i < results.size(); i++) {
+            const ChunkResult& result = results[i];
+            if (!result.error.empty()) {
+                Napi::Object err = Napi::Object::New(env);
+                err.Set("filepath", Napi::String::New(env, filepaths[i]));
+                err.Set("error", Napi::String::New(env, result.error));
+                errors.Set(errors.Length(), err);
+                continue;
+            }
+
+            if (!result.embed_pool.empty()) {
+                std::memcpy(text.Data() + byte_pos, result.embed_pool.data(), result.embed_pool.size());
+            }
+            for (const auto& chunk : result.chunks) {
+                offsets.Data()[chunk_pos] = static_cast<uint32_t>(byte_pos + chunk.embed_offset);
+                token_counts.Data()[chunk_pos] = chunk.embed_token_count;
+                file_index.Data()[chunk_pos] = static_cast<uint32_t>(i);
+                ids.Set(static_cast<uint32_t>(chunk_pos), Napi::String::New(env, chunk.id));
+                chunk_pos++;
+            }
+            byte_pos += result.embed_pool.size();
+        }
+        offsets.Data()[chunk_pos] = static_cast<uint32_t>(byte_pos);
+
+        Napi::Object batch = Napi::Object::New(env);
+        batch.Set("text", text);
+        batch.Set("offsets", offsets);
+        batch.Set("tokenCounts", token_counts);
+        batch.Set("fileIndex", file_index);
+        batch.Set("ids", ids);
+        batch.Set("errors", errors);
+        return batch;
+    }
+
+    /**
+     * @brief setCache(cache: ChunkCache | null): void
+     */
+    Napi::Value SetCache(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined()) {
+            chunker_->set_cache(nullptr);
+            return env.Undefined();
+        }
+
+        AddonData* data = env.GetInstanceData<AddonData>();
+        if (!info[0].IsObject() ||
+            !info[0].As<Napi::Object>().InstanceOf(data->chunk_cache_constructor.Value())) {
+            Napi::TypeError::New(env, "ChunkCache instance expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        ChunkCacheWrapper* wrapper = ChunkCacheWrapper::Unwrap(info[0].As<Napi::Object>());
+        chunker_->set_cache(wrapper->get_cache());
+        return env.Undefined();
+    }
+
+    /**
+     * @brief setIdentifierIndex(index: IdentifierIndex | null): void
+     */
+    Napi::Value SetIdentifierIndex(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || info[0].IsNull() || info[0].IsUndefined()) {
+            chunker_->set_identifier_index(nullptr);
+            return env.Undefined();
+        }
+
+        AddonData* data = env.GetInstanceData<AddonData>();
+        if (!info[0].IsObject() ||
+            !info[0].As<Napi::Object>().InstanceOf(data->identifier_index_constructor.Value())) {
+            Napi::TypeError::New(env, "IdentifierIndex instance expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        IdentifierIndexWrapper* wrapper = IdentifierIndexWrapper::Unwrap(info[0].As<Napi::Object>());
+        chunker_->set_identifier_index(wrapper->get_index());
+        return env.Undefined();
+    }
+
     /**
      * @brief setConfig(config: ChunkerConfig): void
      */
@@ -242,11 +1448,165 @@ private:
         obj.Set("respectBoundaries", Napi::Boolean::New(env, config.respect_boundaries));
         obj.Set("includeContext", Napi::Boolean::New(env, config.include_context));
         obj.Set("preserveImports", Napi::Boolean::New(env, config.preserve_imports));
+        obj.Set("streamWindowBytes", Napi::Number::New(env, config.stream_window_bytes));
+        obj.Set("streamLookaheadBytes", Napi::Number::New(env, config.stream_lookahead_bytes));
+        obj.Set("embedText", Napi::Boolean::New(env, config.embed_text));
+        obj.Set("embedStripComments", Napi::Boolean::New(env, config.embed_strip_comments));
+        obj.Set("embedCollapseWhitespace", Napi::Boolean::New(env, config.embed_collapse_whitespace));
+        obj.Set("embedContextHeader", Napi::Boolean::New(env, config.embed_context_header));
+        obj.Set("boundaryTimeBudgetMs", Napi::Number::New(env, config.boundary_time_budget_ms));
+        obj.Set("boundaryStepBudget", Napi::Number::New(env, config.boundary_step_budget));
+        obj.Set("classifyFiles", Napi::Boolean::New(env, config.classify_files));
+        obj.Set("hashSymbols", Napi::Boolean::New(env, config.hash_symbols));
 
         return obj;
     }
 };
 
+/**
+ * @brief Background pull of the next ChunkStream window
+ */
+class ChunkStreamWorker : public Napi::AsyncWorker {
+public:
+    ChunkStreamWorker(Napi::Env env, ChunkStream* stream, Napi::Object owner, bool* busy)
+        : Napi::AsyncWorker(env)
+        , deferred_(Napi::Promise::Deferred::New(env))
+        , owner_(Napi::Persistent(owner))
+        , stream_(stream)
+        , busy_(busy)
+        , has_chunks_(false) {}
+
+    Napi::Promise GetPromise() const { return deferred_.Promise(); }
+
+protected:
+    void Execute() override {
+        has_chunks_ = stream_->next_window(chunks_);
+        embed_pool_ = stream_->embed_pool();
+    }
+
+    void OnOK() override {
+        Napi::Env env = Env();
+        *busy_ = false;
+
+        if (!has_chunks_) {
+            deferred_.Resolve(env.Null());
+            return;
+        }
+
+        // Streamed chunks have no result to hold a shared embedding buffer,
+        // so each carries its own text
+        Napi::Array arr = Napi::Array::New(env, chunks_.size());
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            const CodeChunk& chunk = chunks_[i];
+            Napi::Object obj = chunk_to_js(env, chunk);
+            if (!embed_pool_.empty()) {
+                obj.Set("embedText", Napi::String::New(env, embed_pool_.data() + chunk.embed_offset,
+                                                       chunk.embed_length));
+                obj.Set("embedTokenCount", Napi::Number::New(env, chunk.embed_token_count));
+            }
+            arr.Set(i, obj);
+        }
+        deferred_.Resolve(arr);
+    }
+
+    void OnError(const Napi::Error& e) override {
+        *busy_ = false;
+        deferred_.Reject(e.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference owner_;  // Keeps the stream alive while queued
+    ChunkStream* stream_;
+    bool* busy_;
+    bool has_chunks_;
+    std::vector<CodeChunk> chunks_;
+    std::string embed_pool_;
+};
+
+/**
+ * @brief Wrapper class for ChunkStream
+ */
+class ChunkStreamWrapper : public Napi::ObjectWrap<ChunkStreamWrapper> {
+public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "ChunkStream", {
+            InstanceMethod("nextBatch", &ChunkStreamWrapper::NextBatch),
+            InstanceMethod("bytesConsumed", &ChunkStreamWrapper::BytesConsumed),
+            InstanceMethod("totalBytes", &ChunkStreamWrapper::TotalBytes),
+            InstanceMethod("degraded", &ChunkStreamWrapper::Degraded),
+        });
+
+        exports.Set("ChunkStream", func);
+        return exports;
+    }
+
+    ChunkStreamWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<ChunkStreamWrapper>(info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "File path expected")
+                .ThrowAsJavaScriptException();
+            return;
+        }
+
+        std::string filepath = info[0].As<Napi::String>().Utf8Value();
+
+        ChunkerConfig config;
+        if (info.Length() > 1 && info[1].IsObject()) {
+            config = config_from_js(info[1].As<Napi::Object>());
+        }
+
+        stream_ = std::make_unique<ChunkStream>(filepath, config);
+        if (!stream_->is_open()) {
+            Napi::Error::New(env, stream_->error()).ThrowAsJavaScriptException();
+        }
+    }
+
+private:
+    std::unique_ptr<ChunkStream> stream_;
+    bool busy_ = false;
+
+    /**
+     * @brief nextBatch(): Promise<CodeChunk[] | null>
+     */
+    Napi::Value NextBatch(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (!stream_ || !stream_->is_open()) {
+            Napi::Error::New(env, "Stream is not open").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        if (busy_) {
+            Napi::Error::New(env, "nextBatch() called while a previous call is pending")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        busy_ = true;
+        auto* worker = new ChunkStreamWorker(env, stream_.get(), info.This().As<Napi::Object>(), &busy_);
+        Napi::Promise promise = worker->GetPromise();
+        worker->Queue();
+        return promise;
+    }
+
+    Napi::Value BytesConsumed(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        return Napi::Number::New(env, static_cast<double>(stream_ ? stream_->bytes_consumed() : 0));
+    }
+
+    Napi::Value TotalBytes(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        return Napi::Number::New(env, static_cast<double>(stream_ ? stream_->total_bytes() : 0));
+    }
+
+    Napi::Value Degraded(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        return Napi::Boolean::New(env, stream_ && stream_->degraded());
+    }
+};
+
 /**
  * @brief Standalone function: chunk(source, options?)
  */
@@ -329,15 +1689,266 @@ Napi::Value CountTokens(const Napi::CallbackInfo& info) {
     return Napi::Number::New(env, count);
 }
 
+/**
+ * @brief Standalone function: exportChunks(result, filepath)
+ */
+Napi::Value ExportChunks(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "ChunkResult and file path expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    ChunkResult result;
+    if (!result_from_js(env, info[0], result)) {
+        return env.Undefined();
+    }
+
+    std::vector<uint8_t> bytes = export_chunks(result, info[1].As<Napi::String>().Utf8Value());
+    return Napi::Buffer<uint8_t>::Copy(env, bytes.data(), bytes.size());
+}
+
+/**
+ * @brief Standalone function: importChunks(buffer)
+ */
+Napi::Value ImportChunks(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Buffer expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Buffer<uint8_t> buffer = info[0].As<Napi::Buffer<uint8_t>>();
+    ChunkResult result;
+    std::string filepath;
+    if (!import_chunks(buffer.Data(), buffer.Length(), result, filepath)) {
+        Napi::Error::New(env, "Invalid chunk export").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Object obj = result_to_js(env, result);
+    obj.Set("filepath", Napi::String::New(env, filepath));
+    return obj;
+}
+
+/**
+ * @brief Standalone function: diffChunks(before, after)
+ */
+Napi::Value DiffChunks(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "Two chunk results expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    ChunkResult before, after;
+    if (!result_from_js(env, info[0], before) || !result_from_js(env, info[1], after)) {
+        return env.Undefined();
+    }
+
+    return delta_to_js(env, diff_chunks(before, after));
+}
+
+/**
+ * @brief Standalone function: diffSymbols(before, after)
+ *
+ * Each side is a symbol array, a ChunkResult or a chunk export buffer.
+ */
+Napi::Value DiffSymbols(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2) {
+        Napi::TypeError::New(env, "Two symbol lists expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    ChunkResult before, after;
+    for (size_t i = 0; i < 2; i++) {
+        ChunkResult& side = i == 0 ? before : after;
+        if (info[i].IsArray()) {
+            symbols_from_js(info[i], side.symbols);
+        } else if (!result_from_js(env, info[i], side)) {
+            return env.Undefined();
+        }
+    }
+
+    return symbol_delta_to_js(env, diff_symbols(before.symbols, after.symbols));
+}
+
+/**
+ * @brief Copy a column into a new typed array
+ */
+template<typename T>
+static Napi::TypedArrayOf<T> column_to_js(Napi::Env env, const std::vector<T>& column) {
+    Napi::TypedArrayOf<T> arr = Napi::TypedArrayOf<T>::New(env, column.size());
+    if (!column.empty()) std::memcpy(arr.Data(), column.data(), column.size() * sizeof(T));
+    return arr;
+}
+
+/**
+ * @brief Standalone function: buildSymbolTable(filepaths, options?)
+ *
+ * Extracts the symbols of all files on a worker pool and returns them as
+ * columns (typed arrays) plus one UTF-8 name pool.
+ */
+Napi::Value BuildSymbolTable(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Array of file paths expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<std::string> paths(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        paths[i] = arr.Get(i).As<Napi::String>().Utf8Value();
+    }
+
+    SymbolTableConfig config;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object opts = info[1].As<Napi::Object>();
+        if (opts.Has("numWorkers")) {
+            config.num_workers = opts.Get("numWorkers").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("boundaryTimeBudgetMs")) {
+            config.boundary_time_budget_ms = opts.Get("boundaryTimeBudgetMs").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("boundaryStepBudget")) {
+            config.boundary_step_budget = opts.Get("boundaryStepBudget").As<Napi::Number>().Uint32Value();
+        }
+        if (opts.Has("maxFileSize")) {
+            config.max_file_size = static_cast<uint64_t>(opts.Get("maxFileSize").As<Napi::Number>().DoubleValue());
+        }
+    }
+
+    SymbolTable table = build_symbol_table(paths, config);
+
+    Napi::Array languages = Napi::Array::New(env, table.file_language.size());
+    for (size_t i = 0; i < table.file_language.size(); i++) {
+        languages.Set(static_cast<uint32_t>(i),
+                      Napi::String::New(env, language_to_string(static_cast<Language>(table.file_language[i]))));
+    }
+
+    Napi::Array errors = Napi::Array::New(env, table.errors.size());
+    for (size_t i = 0; i < table.errors.size(); i++) {
+        Napi::Object err = Napi::Object::New(env);
+        err.Set("filepath", Napi::String::New(env, paths[table.errors[i].first]));
+        err.Set("error", Napi::String::New(env, table.errors[i].second));
+        errors.Set(static_cast<uint32_t>(i), err);
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("file", column_to_js(env, table.file));
+    obj.Set("kind", column_to_js(env, table.kind));
+    obj.Set("flags", column_to_js(env, table.flags));
+    obj.Set("parent", column_to_js(env, table.parent));
+    obj.Set("lineStart", column_to_js(env, table.line_start));
+    obj.Set("lineEnd", column_to_js(env, table.line_end));
+    obj.Set("byteOffset", column_to_js(env, table.byte_offset));
+    obj.Set("byteLength", column_to_js(env, table.byte_length));
+    obj.Set("nameOffsets", column_to_js(env, table.name_offsets));
+    obj.Set("names", Napi::Buffer<char>::Copy(env, table.names.data(), table.names.size()));
+    obj.Set("fileOffsets", column_to_js(env, table.file_offsets));
+    obj.Set("fileFlags", column_to_js(env, table.file_flags));
+    obj.Set("languages", languages);
+    obj.Set("errors", errors);
+    return obj;
+}
+
+/**
+ * @brief Standalone function: packContext(snippets, options)
+ *
+ * Selects the snippets that maximise total score within a token budget.
+ * Each snippet is { text, score, source?, lineStart?, lineEnd?, pinned? }.
+ */
+Napi::Value PackContext(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "Array of snippets and options expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<ContextSnippet> snippets(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Value item = arr.Get(i);
+        if (!item.IsObject()) {
+            Napi::TypeError::New(env, "Snippet must be an object").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        Napi::Object obj = item.As<Napi::Object>();
+        ContextSnippet& snippet = snippets[i];
+        snippet.text = obj.Get("text").As<Napi::String>().Utf8Value();
+        snippet.score = obj.Get("score").As<Napi::Number>().DoubleValue();
+        if (obj.Has("source") && obj.Get("source").IsString()) {
+            snippet.source = obj.Get("source").As<Napi::String>().Utf8Value();
+        }
+        if (obj.Has("lineStart") && obj.Get("lineStart").IsNumber()) {
+            snippet.line_start = obj.Get("lineStart").As<Napi::Number>().Uint32Value();
+        }
+        if (obj.Has("lineEnd") && obj.Get("lineEnd").IsNumber()) {
+            snippet.line_end = obj.Get("lineEnd").As<Napi::Number>().Uint32Value();
+        }
+        if (obj.Has("pinned") && obj.Get("pinned").IsBoolean()) {
+            snippet.pinned = obj.Get("pinned").As<Napi::Boolean>().Value();
+        }
+    }
+
+    PackOptions options;
+    Napi::Object opts = info[1].As<Napi::Object>();
+    if (opts.Has("tokenBudget")) {
+        options.token_budget = opts.Get("tokenBudget").As<Napi::Number>().Uint32Value();
+    }
+    if (opts.Has("snippetOverhead")) {
+        options.snippet_overhead = opts.Get("snippetOverhead").As<Napi::Number>().Uint32Value();
+    }
+
+    PackResult result = pack_context(snippets, options);
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("selected", column_to_js(env, result.selected));
+    obj.Set("tokenCounts", column_to_js(env, result.token_counts));
+    obj.Set("totalTokens", Napi::Number::New(env, result.total_tokens));
+    obj.Set("totalScore", Napi::Number::New(env, result.total_score));
+    obj.Set("duplicates", Napi::Number::New(env, result.duplicates));
+    obj.Set("exact", Napi::Boolean::New(env, result.exact));
+    return obj;
+}
+
 /**
  * @brief Module initialization
  */
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
-    ChunkerWrapper::Init(env, exports);
+    AddonData* data = new AddonData();
+    data->chunker_constructor = Napi::Persistent(ChunkerWrapper::Init(env, exports));
+    data->chunk_cache_constructor = Napi::Persistent(ChunkCacheWrapper::Init(env, exports));
+    data->identifier_index_constructor = Napi::Persistent(IdentifierIndexWrapper::Init(env, exports));
+    env.SetInstanceData(data);
+
+    ChunkStreamWrapper::Init(env, exports);
+    AstArenaWrapper::Init(env, exports);
+    ParseCacheWrapper::Init(env, exports);
 
     exports.Set("chunk", Napi::Function::New(env, ChunkSource));
     exports.Set("chunkFile", Napi::Function::New(env, ChunkFile));
     exports.Set("countTokens", Napi::Function::New(env, CountTokens));
+    exports.Set("exportChunks", Napi::Function::New(env, ExportChunks));
+    exports.Set("importChunks", Napi::Function::New(env, ImportChunks));
+    exports.Set("diffChunks", Napi::Function::New(env, DiffChunks));
+    exports.Set("diffSymbols", Napi::Function::New(env, DiffSymbols));
+    exports.Set("buildSymbolTable", Napi::Function::New(env, BuildSymbolTable));
+    exports.Set("packContext", Napi::Function::New(env, PackContext));
 
     // Version info
     exports.Set("version", Napi::String::New(env, "1.0.0"));
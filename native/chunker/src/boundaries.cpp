@@ -19,28 +19,15 @@
 #include <regex>
 #include <stack>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace archicore {
 namespace chunker {
 
 struct BoundaryDetector::Impl {
-    // Helper to find line and column from byte offset
-    static std::pair<uint32_t, uint32_t> offset_to_line_col(
-        const std::string& source,
-        size_t offset
-    ) {
-        uint32_t line = 1;
-        uint32_t col = 1;
-        for (size_t i = 0; i < offset && i < source.size(); i++) {
-            if (source[i] == '\n') {
-                line++;
-                col = 1;
-            } else {
-                col++;
-            }
-        }
-        return {line, col};
-    }
+    // Longest text a boundary pattern is matched against
+    static constexpr size_t MATCH_WINDOW = 200;
 
     // Skip whitespace and return new position
     static size_t skip_whitespace(const std::string& source, size_t pos) {
@@ -52,112 +39,100 @@ struct BoundaryDetector::Impl {
 
     // Skip to end of line
     static size_t skip_to_eol(const std::string& source, size_t pos) {
-        while (pos < source.size() && source[pos] != '\n') {
-            pos++;
-        }
-        return pos;
+        const void* eol = pos < source.size()
+            ? std::memchr(source.data() + pos, '\n', source.size() - pos)
+            : nullptr;
+        return eol ? static_cast<size_t>(static_cast<const char*>(eol) - source.data()) : source.size();
     }
 
-    // Skip string literal
-    static size_t skip_string(const std::string& source, size_t pos, char quote) {
-        pos++; // Skip opening quote
-        while (pos < source.size()) {
-            if (source[pos] == '\\' && pos + 1 < source.size()) {
-                pos += 2; // Skip escaped char
-            } else if (source[pos] == quote) {
-                return pos + 1;
-            } else {
-                pos++;
-            }
+    // Whether the identifier (or #directive) at pos is one of the keywords.
+    // Patterns only ever start with a keyword, so this gates the regexes.
+    static bool keyword_at(const std::string& source, size_t pos,
+                           std::initializer_list<std::string_view> keywords) {
+        size_t end = pos;
+        if (end < source.size() && source[end] == '#') end++;
+        while (end < source.size()) {
+            unsigned char c = static_cast<unsigned char>(source[end]);
+            if (!std::isalnum(c) && c != '_' && c != '$') break;
+            end++;
         }
-        return pos;
+        std::string_view word(source.data() + pos, end - pos);
+        return std::find(keywords.begin(), keywords.end(), word) != keywords.end();
     }
 
-    // Skip template string (backtick)
-    static size_t skip_template_string(const std::string& source, size_t pos) {
-        pos++; // Skip opening backtick
-        while (pos < source.size()) {
-            if (source[pos] == '\\' && pos + 1 < source.size()) {
-                pos += 2;
-            } else if (source[pos] == '$' && pos + 1 < source.size() && source[pos + 1] == '{') {
-                // Skip ${...} expression
-                int depth = 1;
-                pos += 2;
-                while (pos < source.size() && depth > 0) {
-                    if (source[pos] == '{') depth++;
-                    else if (source[pos] == '}') depth--;
-                    pos++;
-                }
-            } else if (source[pos] == '`') {
-                return pos + 1;
-            } else {
-                pos++;
-            }
-        }
-        return pos;
+    // The clock is read once per this many pattern attempts
+    static constexpr uint64_t CLOCK_CHECK_INTERVAL = 256;
+
+    // ... and once per this many scanned positions, which are far cheaper
+    static constexpr uint64_t VISIT_CHECK_INTERVAL = 4096;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Per-file budget of the precise detectors (0 = unlimited)
+    uint32_t time_budget_ms = 0;
+    uint64_t step_budget = 0;
+
+    // State of the current detect() call
+    Clock::time_point deadline;
+    uint64_t steps = 0;
+    uint64_t visits = 0;
+    bool exhausted = false;
+    bool degraded = false;
+
+    void start_budget() {
+        steps = 0;
+        visits = 0;
+        exhausted = false;
+        degraded = false;
+        deadline = Clock::now() + std::chrono::milliseconds(time_budget_ms);
     }
 
-    // Skip comment
-    static size_t skip_comment(const std::string& source, size_t pos) {
-        if (pos + 1 >= source.size()) return pos;
-
-        if (source[pos] == '/' && source[pos + 1] == '/') {
-            // Line comment
-            return skip_to_eol(source, pos);
-        } else if (source[pos] == '/' && source[pos + 1] == '*') {
-            // Block comment
-            pos += 2;
-            while (pos + 1 < source.size()) {
-                if (source[pos] == '*' && source[pos + 1] == '/') {
-                    return pos + 2;
-                }
-                pos++;
-            }
-        } else if (source[pos] == '#') {
-            // Python-style comment
-            return skip_to_eol(source, pos);
+    // Count one pattern attempt; false once the budget is spent
+    bool charge() {
+        if (exhausted) return false;
+        steps++;
+        if (step_budget > 0 && steps > step_budget) {
+            exhausted = true;
+        } else if (time_budget_ms > 0 && steps % CLOCK_CHECK_INTERVAL == 0 && Clock::now() > deadline) {
+            exhausted = true;
         }
-        return pos;
+        return !exhausted;
     }
 
-    // Extract identifier at position
-    static std::string extract_identifier(const std::string& source, size_t pos) {
-        std::string id;
-        while (pos < source.size()) {
-            char c = source[pos];
-            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$') {
-                id += c;
-                pos++;
-            } else {
-                break;
-            }
+    // The fallback gets a budget of its own, so that a spent budget still
+    // yields brace boundaries for the start of the file, within bounded time
+    void start_fallback() {
+        visits = 0;
+        exhausted = false;
+        deadline = Clock::now() + std::chrono::milliseconds(time_budget_ms);
+    }
+
+    // Count one iteration of a detector's scanning loop. Loops advance at
+    // least one byte per iteration, so they are linear in the file size;
+    // this keeps them under the time budget even between pattern attempts.
+    bool visit() {
+        if (exhausted) return false;
+        if (time_budget_ms > 0 && ++visits % VISIT_CHECK_INTERVAL == 0 && Clock::now() > deadline) {
+            exhausted = true;
         }
-        return id;
+        return !exhausted;
     }
 
-    // Find matching brace
-    static size_t find_matching_brace(const std::string& source, size_t pos, char open, char close) {
-        if (pos >= source.size() || source[pos] != open) return pos;
+    // Match a pattern anchored at pos, looking at most window bytes ahead.
+    // Every attempt is charged to the budget; none succeed once it is spent.
+    bool match_at(const std::string& source, size_t pos, const std::regex& pattern,
+                  std::smatch& match, size_t window = MATCH_WINDOW) {
+        if (!charge()) return false;
+        auto begin = source.cbegin() + static_cast<std::ptrdiff_t>(pos);
+        auto end = source.cbegin() + static_cast<std::ptrdiff_t>(std::min(source.size(), pos + window));
+        return std::regex_search(begin, end, match, pattern, std::regex_constants::match_continuous);
+    }
 
-        int depth = 1;
-        pos++;
-        while (pos < source.size() && depth > 0) {
-            char c = source[pos];
-            if (c == open) {
-                depth++;
-            } else if (c == close) {
-                depth--;
-            } else if (c == '"' || c == '\'') {
-                pos = skip_string(source, pos, c);
-                continue;
-            } else if (c == '`') {
-                pos = skip_template_string(source, pos);
-                continue;
-            } else if (c == '/' && pos + 1 < source.size() && (source[pos + 1] == '/' || source[pos + 1] == '*')) {
-                pos = skip_comment(source, pos);
-                continue;
-            }
-            pos++;
+    // Next '{' outside strings and comments
+    static size_t next_open_brace(const std::string& source, const StructuralIndex& index, size_t pos) {
+        pos = index.next(pos, StructuralIndex::BRACE);
+        while (pos < source.size() && source[pos] != '{') {
+            pos = index.next(pos + 1, StructuralIndex::BRACE);
         }
         return pos;
     }
@@ -167,95 +142,119 @@ BoundaryDetector::BoundaryDetector() : impl_(std::make_unique<Impl>()) {}
 
 BoundaryDetector::~BoundaryDetector() = default;
 
+void BoundaryDetector::set_budget(uint32_t time_budget_ms, uint64_t step_budget) {
+    impl_->time_budget_ms = time_budget_ms;
+    impl_->step_budget = step_budget;
+}
+
+bool BoundaryDetector::degraded() const {
+    return impl_->degraded;
+}
+
 std::vector<SemanticBoundary> BoundaryDetector::detect(
     const std::string& source,
     Language language
 ) {
+    // One structural pass; detectors then only visit code positions
+    StructuralIndex index(source, language);
+    impl_->start_budget();
+
+    std::vector<SemanticBoundary> boundaries;
     switch (language) {
         case Language::JAVASCRIPT:
-            return detect_javascript(source);
+            boundaries = detect_javascript(source, index);
+            break;
         case Language::TYPESCRIPT:
-            return detect_typescript(source);
+            boundaries = detect_typescript(source, index);
+            break;
         case Language::PYTHON:
-            return detect_python(source);
+            boundaries = detect_python(source, index);
+            break;
         case Language::RUST:
-            return detect_rust(source);
+            boundaries = detect_rust(source, index);
+            break;
         case Language::GO:
-            return detect_go(source);
+            boundaries = detect_go(source, index);
+            break;
         case Language::JAVA:
         case Language::KOTLIN:
-            return detect_java(source);
+            boundaries = detect_java(source, index);
+            break;
         case Language::CPP:
         case Language::C:
         case Language::CSHARP:
-            return detect_cpp(source);
+            boundaries = detect_cpp(source, index);
+            break;
         default:
-            return detect_generic(source);
+            boundaries = detect_generic(source, index);
+            impl_->degraded = impl_->exhausted;
+            return boundaries;
+    }
+
+    // Budget spent: partial results are unreliable, so fall back to the
+    // linear brace splitter. Braces do not delimit Python blocks (only dict
+    // and set literals), so Python gets no boundaries and therefore
+    // line-based windows.
+    if (impl_->exhausted) {
+        impl_->degraded = true;
+        if (language == Language::PYTHON) return {};
+        impl_->start_fallback();
+        return detect_generic(source, index);
     }
+    return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
     size_t pos = 0;
     int scope_depth = 0;
     std::stack<std::pair<size_t, ChunkType>> scope_stack;
 
     // Regular expressions for JavaScript patterns
-    std::regex func_regex(R"((?:async\s+)?function\s*(\*?)\s*([a-zA-Z_$][a-zA-Z0-9_$]*)?\s*\()");
-    std::regex arrow_regex(R"((?:const|let|var)\s+([a-zA-Z_$][a-zA-Z0-9_$]*)\s*=\s*(?:async\s+)?\([^)]*\)\s*=>)");
-    std::regex class_regex(R"(class\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
-    std::regex method_regex(R"((?:async\s+)?([a-zA-Z_$][a-zA-Z0-9_$]*)\s*\([^)]*\)\s*\{)");
-    std::regex import_regex(R"(import\s+)");
-    std::regex export_regex(R"(export\s+(?:default\s+)?(?:async\s+)?(?:function|class|const|let|var))");
-
-    while (pos < source.size()) {
-        // Skip whitespace
-        pos = Impl::skip_whitespace(source, pos);
+    static const std::regex func_regex(R"((?:async\s+)?function\s*(\*?)\s*([a-zA-Z_$][a-zA-Z0-9_$]*)?\s*\()");
+    static const std::regex arrow_regex(R"((?:const|let|var)\s+([a-zA-Z_$][a-zA-Z0-9_$]*)\s*=\s*(?:async\s+)?\([^)]*\)\s*=>)");
+    static const std::regex class_regex(R"(class\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
+    static const std::regex import_regex(R"(import\s+)");
+    static const std::regex export_regex(R"(export\s+(?:default\s+)?(?:async\s+)?(?:function|class|const|let|var))");
+
+    const uint32_t kinds = StructuralIndex::IDENT_START | StructuralIndex::BRACE |
+                           StructuralIndex::COMMENT_START;
+
+    while (pos < source.size() && impl_->visit()) {
+        // Jump to the next identifier, brace or comment outside literals
+        pos = index.next(pos, kinds);
         if (pos >= source.size()) break;
 
         char c = source[pos];
 
-        // Skip comments
-        if (c == '/' && pos + 1 < source.size()) {
-            if (source[pos + 1] == '/' || source[pos + 1] == '*') {
-                size_t comment_start = pos;
-                pos = Impl::skip_comment(source, pos);
+        if (index.is_comment_start(pos)) {
+            size_t comment_start = pos;
+            pos = index.literal_end(pos);
 
-                // Track doc comments as potential boundaries
-                if (pos - comment_start > 50) {
-                    auto [line, col] = Impl::offset_to_line_col(source, comment_start);
-                    boundaries.push_back({
-                        static_cast<uint32_t>(line),
-                        static_cast<uint32_t>(col),
-                        static_cast<uint32_t>(comment_start),
-                        ChunkType::COMMENT,
-                        "",
-                        scope_depth,
-                        true
-                    });
-                }
-                continue;
+            // Track doc comments as potential boundaries
+            if (pos - comment_start > 50) {
+                auto [line, col] = index.line_col(comment_start);
+                boundaries.push_back({
+                    static_cast<uint32_t>(line),
+                    static_cast<uint32_t>(col),
+                    static_cast<uint32_t>(comment_start),
+                    ChunkType::COMMENT,
+                    "",
+                    scope_depth,
+                    true
+                });
             }
-        }
-
-        // Skip string literals
-        if (c == '"' || c == '\'') {
-            pos = Impl::skip_string(source, pos, c);
-            continue;
-        }
-        if (c == '`') {
-            pos = Impl::skip_template_string(source, pos);
             continue;
         }
 
         // Check for patterns
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(200))));
         std::smatch match;
+        bool keyword = Impl::keyword_at(source, pos,
+            {"import", "export", "class", "function", "async", "const", "let", "var"});
 
         // Check for import
-        if (std::regex_search(remaining_str, match, import_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (keyword && impl_->match_at(source, pos, import_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -270,8 +269,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
         }
 
         // Check for export
-        if (std::regex_search(remaining_str, match, export_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (keyword && impl_->match_at(source, pos, export_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -286,8 +285,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
         }
 
         // Check for class
-        if (std::regex_search(remaining_str, match, class_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (keyword && impl_->match_at(source, pos, class_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             std::string name = match[1].str();
             boundaries.push_back({
                 static_cast<uint32_t>(line),
@@ -301,7 +300,7 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
             pos += match.length();
 
             // Find the opening brace
-            while (pos < source.size() && source[pos] != '{') pos++;
+            pos = Impl::next_open_brace(source, index, pos);
             if (pos < source.size()) {
                 scope_stack.push({pos, ChunkType::CLASS});
                 scope_depth++;
@@ -311,8 +310,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
         }
 
         // Check for function
-        if (std::regex_search(remaining_str, match, func_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (keyword && impl_->match_at(source, pos, func_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             std::string name = match[2].str();
             if (name.empty()) name = "<anonymous>";
             boundaries.push_back({
@@ -327,7 +326,7 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
             pos += match.length();
 
             // Find the opening brace
-            while (pos < source.size() && source[pos] != '{') pos++;
+            pos = Impl::next_open_brace(source, index, pos);
             if (pos < source.size()) {
                 scope_stack.push({pos, ChunkType::FUNCTION});
                 scope_depth++;
@@ -337,8 +336,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
         }
 
         // Check for arrow function
-        if (std::regex_search(remaining_str, match, arrow_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (keyword && impl_->match_at(source, pos, arrow_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             std::string name = match[1].str();
             boundaries.push_back({
                 static_cast<uint32_t>(line),
@@ -374,7 +373,7 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
 
                 // Add end boundary for functions and classes
                 if (type == ChunkType::FUNCTION || type == ChunkType::CLASS) {
-                    auto [line, col] = Impl::offset_to_line_col(source, pos);
+                    auto [line, col] = index.line_col(pos);
                     boundaries.push_back({
                         static_cast<uint32_t>(line),
                         static_cast<uint32_t>(col),
@@ -401,24 +400,29 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_javascript(const std::str
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_typescript(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_typescript(const std::string& source, const StructuralIndex& index) {
     // TypeScript extends JavaScript, so we use the same base detection
     // and add TypeScript-specific patterns
-    std::vector<SemanticBoundary> boundaries = detect_javascript(source);
+    std::vector<SemanticBoundary> boundaries = detect_javascript(source, index);
 
     // Additional TypeScript patterns
-    std::regex interface_regex(R"(interface\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
-    std::regex type_regex(R"(type\s+([a-zA-Z_$][a-zA-Z0-9_$]*)\s*=)");
-    std::regex enum_regex(R"(enum\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
+    static const std::regex interface_regex(R"(interface\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
+    static const std::regex type_regex(R"(type\s+([a-zA-Z_$][a-zA-Z0-9_$]*)\s*=)");
+    static const std::regex enum_regex(R"(enum\s+([a-zA-Z_$][a-zA-Z0-9_$]*))");
 
     size_t pos = 0;
-    while (pos < source.size()) {
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(200))));
+    while (pos < source.size() && impl_->visit()) {
+        pos = index.next(pos, StructuralIndex::IDENT_START);
+        if (pos >= source.size()) break;
+
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"interface", "enum"})) {
+            pos++;
+            continue;
+        }
 
-        if (std::regex_search(remaining_str, match, interface_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, interface_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -432,8 +436,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_typescript(const std::str
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, enum_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, enum_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -458,17 +462,17 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_typescript(const std::str
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    std::regex func_regex(R"((?:async\s+)?def\s+([a-zA-Z_][a-zA-Z0-9_]*)\s*\()");
-    std::regex class_regex(R"(class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex import_regex(R"((?:from\s+[.\w]+\s+)?import\s+)");
+    static const std::regex func_regex(R"((?:async\s+)?def\s+([a-zA-Z_][a-zA-Z0-9_]*)\s*\()");
+    static const std::regex class_regex(R"(class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex import_regex(R"((?:from\s+[.\w]+\s+)?import\s+)");
 
     size_t pos = 0;
     int current_indent = 0;
 
-    while (pos < source.size()) {
+    while (pos < source.size() && impl_->visit()) {
         // Track indentation
         size_t line_start = pos;
         int indent = 0;
@@ -484,7 +488,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string&
             pos++;
             continue;
         }
-        if (source[pos] == '#') {
+        // Comment lines and lines inside multi-line strings (docstrings)
+        if (index.in_literal(pos)) {
             pos = Impl::skip_to_eol(source, pos);
             pos++;
             continue;
@@ -492,13 +497,16 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string&
 
         current_indent = indent;
 
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(200))));
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"class", "def", "async", "from", "import"})) {
+            pos = Impl::skip_to_eol(source, pos);
+            if (pos < source.size()) pos++;
+            continue;
+        }
 
         // Check for class
-        if (std::regex_search(remaining_str, match, class_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, line_start);
+        if (impl_->match_at(source, pos, class_regex, match)) {
+            auto [line, col] = index.line_col(line_start);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -510,8 +518,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string&
             });
         }
         // Check for function
-        else if (std::regex_search(remaining_str, match, func_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, line_start);
+        else if (impl_->match_at(source, pos, func_regex, match)) {
+            auto [line, col] = index.line_col(line_start);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -523,8 +531,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string&
             });
         }
         // Check for import
-        else if (std::regex_search(remaining_str, match, import_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, line_start);
+        else if (impl_->match_at(source, pos, import_regex, match)) {
+            auto [line, col] = index.line_col(line_start);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -544,36 +552,31 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_python(const std::string&
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    std::regex fn_regex(R"((?:pub\s+)?(?:async\s+)?fn\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex struct_regex(R"((?:pub\s+)?struct\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex enum_regex(R"((?:pub\s+)?enum\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex impl_regex(R"(impl(?:<[^>]+>)?\s+(?:([a-zA-Z_][a-zA-Z0-9_]*)\s+for\s+)?([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex trait_regex(R"((?:pub\s+)?trait\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex mod_regex(R"((?:pub\s+)?mod\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex use_regex(R"(use\s+)");
+    static const std::regex fn_regex(R"((?:pub\s+)?(?:async\s+)?fn\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex struct_regex(R"((?:pub\s+)?struct\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex enum_regex(R"((?:pub\s+)?enum\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex impl_regex(R"(impl(?:<[^>]+>)?\s+(?:([a-zA-Z_][a-zA-Z0-9_]*)\s+for\s+)?([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex trait_regex(R"((?:pub\s+)?trait\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex mod_regex(R"((?:pub\s+)?mod\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex use_regex(R"(use\s+)");
 
     size_t pos = 0;
-    while (pos < source.size()) {
-        pos = Impl::skip_whitespace(source, pos);
+    while (pos < source.size() && impl_->visit()) {
+        // Jump to the next identifier outside strings and comments
+        pos = index.next(pos, StructuralIndex::IDENT_START);
         if (pos >= source.size()) break;
 
-        // Skip comments
-        if (source[pos] == '/' && pos + 1 < source.size()) {
-            if (source[pos + 1] == '/' || source[pos + 1] == '*') {
-                pos = Impl::skip_comment(source, pos);
-                continue;
-            }
-        }
-
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(200))));
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"pub", "async", "fn", "struct", "enum", "impl", "trait", "mod", "use"})) {
+            pos++;
+            continue;
+        }
 
-        if (std::regex_search(remaining_str, match, fn_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, fn_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -587,8 +590,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, struct_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, struct_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -602,8 +605,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, enum_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, enum_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -617,8 +620,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, impl_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, impl_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             std::string name = match[2].str();
             if (!match[1].str().empty()) {
                 name = match[1].str() + " for " + name;
@@ -636,8 +639,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, trait_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, trait_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -651,8 +654,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, mod_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, mod_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -666,8 +669,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, use_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, use_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -687,33 +690,28 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_rust(const std::string& s
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    std::regex func_regex(R"(func\s+(?:\([^)]+\)\s+)?([a-zA-Z_][a-zA-Z0-9_]*)\s*\()");
-    std::regex type_regex(R"(type\s+([a-zA-Z_][a-zA-Z0-9_]*)\s+(struct|interface))");
-    std::regex import_regex(R"(import\s+)");
-    std::regex package_regex(R"(package\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex func_regex(R"(func\s+(?:\([^)]+\)\s+)?([a-zA-Z_][a-zA-Z0-9_]*)\s*\()");
+    static const std::regex type_regex(R"(type\s+([a-zA-Z_][a-zA-Z0-9_]*)\s+(struct|interface))");
+    static const std::regex import_regex(R"(import\s+)");
+    static const std::regex package_regex(R"(package\s+([a-zA-Z_][a-zA-Z0-9_]*))");
 
     size_t pos = 0;
-    while (pos < source.size()) {
-        pos = Impl::skip_whitespace(source, pos);
+    while (pos < source.size() && impl_->visit()) {
+        // Jump to the next identifier outside strings and comments
+        pos = index.next(pos, StructuralIndex::IDENT_START);
         if (pos >= source.size()) break;
 
-        // Skip comments
-        if (source[pos] == '/' && pos + 1 < source.size()) {
-            if (source[pos + 1] == '/' || source[pos + 1] == '*') {
-                pos = Impl::skip_comment(source, pos);
-                continue;
-            }
-        }
-
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(200))));
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"package", "func", "type", "import"})) {
+            pos++;
+            continue;
+        }
 
-        if (std::regex_search(remaining_str, match, package_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, package_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -727,8 +725,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& sou
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, func_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, func_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -742,8 +740,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& sou
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, type_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, type_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             ChunkType type = (match[2].str() == "struct") ? ChunkType::STRUCT : ChunkType::INTERFACE;
             boundaries.push_back({
                 static_cast<uint32_t>(line),
@@ -758,8 +756,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& sou
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, import_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, import_regex, match)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -773,7 +771,7 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& sou
             // Handle import block
             pos = Impl::skip_whitespace(source, pos);
             if (pos < source.size() && source[pos] == '(') {
-                pos = Impl::find_matching_brace(source, pos, '(', ')');
+                pos = index.find_matching(pos);
             }
             continue;
         }
@@ -784,35 +782,30 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_go(const std::string& sou
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    std::regex class_regex(R"((?:public\s+|private\s+|protected\s+)?(?:abstract\s+)?(?:final\s+)?class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex interface_regex(R"((?:public\s+)?interface\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex enum_regex(R"((?:public\s+)?enum\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex method_regex(R"((?:public\s+|private\s+|protected\s+)?(?:static\s+)?(?:final\s+)?(?:synchronized\s+)?(?:<[^>]+>\s+)?[a-zA-Z_][a-zA-Z0-9_<>,\s]*\s+([a-zA-Z_][a-zA-Z0-9_]*)\s*\([^)]*\)\s*(?:throws\s+[^{]+)?\{)");
-    std::regex import_regex(R"(import\s+)");
-    std::regex package_regex(R"(package\s+)");
+    static const std::regex class_regex(R"((?:public\s+|private\s+|protected\s+)?(?:abstract\s+)?(?:final\s+)?class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex interface_regex(R"((?:public\s+)?interface\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex enum_regex(R"((?:public\s+)?enum\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex import_regex(R"(import\s+)");
+    static const std::regex package_regex(R"(package\s+)");
 
     size_t pos = 0;
-    while (pos < source.size()) {
-        pos = Impl::skip_whitespace(source, pos);
+    while (pos < source.size() && impl_->visit()) {
+        // Jump to the next identifier outside strings and comments
+        pos = index.next(pos, StructuralIndex::IDENT_START);
         if (pos >= source.size()) break;
 
-        // Skip comments
-        if (source[pos] == '/' && pos + 1 < source.size()) {
-            if (source[pos + 1] == '/' || source[pos + 1] == '*') {
-                pos = Impl::skip_comment(source, pos);
-                continue;
-            }
-        }
-
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(300))));
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"package", "import", "public", "private", "protected", "abstract", "final",
+                                       "class", "interface", "enum"})) {
+            pos++;
+            continue;
+        }
 
-        if (std::regex_search(remaining_str, match, package_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, package_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -826,8 +819,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, import_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, import_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -841,8 +834,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, class_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, class_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -856,8 +849,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, interface_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, interface_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -871,8 +864,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& s
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, enum_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, enum_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -892,35 +885,28 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_java(const std::string& s
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    std::regex class_regex(R"((?:template\s*<[^>]+>\s*)?class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex struct_regex(R"((?:template\s*<[^>]+>\s*)?struct\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex namespace_regex(R"(namespace\s+([a-zA-Z_][a-zA-Z0-9_]*))");
-    std::regex func_regex(R"((?:[a-zA-Z_][a-zA-Z0-9_:*&<>,\s]*\s+)?([a-zA-Z_][a-zA-Z0-9_]*)\s*\([^)]*\)\s*(?:const\s*)?(?:override\s*)?(?:final\s*)?\{)");
-    std::regex include_regex(R"(#include\s+)");
-    std::regex define_regex(R"(#define\s+)");
+    static const std::regex class_regex(R"((?:template\s*<[^>]+>\s*)?class\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex struct_regex(R"((?:template\s*<[^>]+>\s*)?struct\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex namespace_regex(R"(namespace\s+([a-zA-Z_][a-zA-Z0-9_]*))");
+    static const std::regex include_regex(R"(#include\s+)");
 
     size_t pos = 0;
-    while (pos < source.size()) {
-        pos = Impl::skip_whitespace(source, pos);
+    while (pos < source.size() && impl_->visit()) {
+        // Jump to the next identifier outside strings and comments
+        pos = index.next(pos, StructuralIndex::IDENT_START);
         if (pos >= source.size()) break;
 
-        // Skip comments
-        if (source[pos] == '/' && pos + 1 < source.size()) {
-            if (source[pos + 1] == '/' || source[pos + 1] == '*') {
-                pos = Impl::skip_comment(source, pos);
-                continue;
-            }
-        }
-
-        std::string_view remaining(source.data() + pos, source.size() - pos);
-        std::string remaining_str(remaining.substr(0, std::min(remaining.size(), size_t(300))));
         std::smatch match;
+        if (!Impl::keyword_at(source, pos, {"#include", "namespace", "template", "class", "struct"})) {
+            pos++;
+            continue;
+        }
 
-        if (std::regex_search(remaining_str, match, include_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, include_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -934,8 +920,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& so
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, namespace_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, namespace_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -949,8 +935,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& so
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, class_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, class_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -964,8 +950,8 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& so
             continue;
         }
 
-        if (std::regex_search(remaining_str, match, struct_regex, std::regex_constants::match_continuous)) {
-            auto [line, col] = Impl::offset_to_line_col(source, pos);
+        if (impl_->match_at(source, pos, struct_regex, match, 300)) {
+            auto [line, col] = index.line_col(pos);
             boundaries.push_back({
                 static_cast<uint32_t>(line),
                 static_cast<uint32_t>(col),
@@ -985,20 +971,22 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_cpp(const std::string& so
     return boundaries;
 }
 
-std::vector<SemanticBoundary> BoundaryDetector::detect_generic(const std::string& source) {
+std::vector<SemanticBoundary> BoundaryDetector::detect_generic(const std::string& source, const StructuralIndex& index) {
     std::vector<SemanticBoundary> boundaries;
 
-    // Generic boundary detection based on braces and common patterns
+    // Generic boundary detection based on braces outside strings and comments.
+    // Once the budget is spent the rest of the file gets no boundaries.
     size_t pos = 0;
     int brace_depth = 0;
-    uint32_t line = 1;
 
-    while (pos < source.size()) {
+    while (pos < source.size() && impl_->visit()) {
+        pos = index.next(pos, StructuralIndex::BRACE);
+        if (pos >= source.size()) break;
+
         char c = source[pos];
+        uint32_t line = index.line(pos);
 
-        if (c == '\n') {
-            line++;
-        } else if (c == '{') {
+        if (c == '{') {
             if (brace_depth == 0) {
                 // Potential block start
                 boundaries.push_back({
@@ -1031,6 +1019,11 @@ std::vector<SemanticBoundary> BoundaryDetector::detect_generic(const std::string
         pos++;
     }
 
+    // A block cut off by the budget has no end to pair with
+    if (impl_->exhausted && !boundaries.empty() && boundaries.back().is_start) {
+        boundaries.pop_back();
+    }
+
     return boundaries;
 }
 
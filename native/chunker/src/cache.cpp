@@ -0,0 +1,547 @@
+/**
+ * @file cache.cpp
+ * @brief Byte-budgeted LRU cache of chunking results
+ * @version 1.0.0
+ *
+ * Lets re-indexing skip tokenization and boundary detection for files whose
+ * content hash has been chunked before with the same configuration:
+ * - In-memory LRU bounded by an estimated byte budget
+ * - Optional append-only spill store, memory-mapped for reads and
+ *   compacted to its most recently used records when over budget
+ * - Hit/miss/eviction counters
+ */
+
+// Prevent Windows min/max macros from conflicting with std::min/std::max
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include "chunker.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace archicore {
+namespace chunker {
+
+// Bump when chunking output changes so that spilled results are invalidated
+static constexpr uint32_t CHUNK_FORMAT_VERSION = 9;
+
+static constexpr uint32_t SPILL_MAGIC = 0x43434853;  // "CCHS"
+static constexpr size_t SPILL_HEADER_SIZE = 8;
+static constexpr size_t SPILL_RECORD_HEADER_SIZE = 20;
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t config_fingerprint(const ChunkerConfig& config) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = fnv1a(hash, &CHUNK_FORMAT_VERSION, sizeof(CHUNK_FORMAT_VERSION));
+    hash = fnv1a(hash, &config.max_chunk_tokens, sizeof(config.max_chunk_tokens));
+    hash = fnv1a(hash, &config.min_chunk_tokens, sizeof(config.min_chunk_tokens));
+    hash = fnv1a(hash, &config.overlap_tokens, sizeof(config.overlap_tokens));
+
+    uint8_t flags[6] = {
+        static_cast<uint8_t>(config.respect_boundaries),
+        static_cast<uint8_t>(config.include_context),
+        static_cast<uint8_t>(config.preserve_imports),
+        static_cast<uint8_t>(config.language),
+        static_cast<uint8_t>(config.classify_files),
+        static_cast<uint8_t>(config.hash_symbols)
+    };
+    return fnv1a(hash, flags, sizeof(flags));
+}
+
+// ----------------------------------------------------------------------------
+// Serialization
+// ----------------------------------------------------------------------------
+
+namespace {
+
+void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    out.insert(out.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 4);
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t v) {
+    out.insert(out.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 8);
+}
+
+void put_str(std::vector<uint8_t>& out, const std::string& s) {
+    put_u32(out, static_cast<uint32_t>(s.size()));
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool u32(uint32_t& v) {
+        if (end - p < 4) return false;
+        memcpy(&v, p, 4);
+        p += 4;
+        return true;
+    }
+
+    bool u64(uint64_t& v) {
+        if (end - p < 8) return false;
+        memcpy(&v, p, 8);
+        p += 8;
+        return true;
+    }
+
+    bool u8(uint8_t& v) {
+        if (p >= end) return false;
+        v = *p++;
+        return true;
+    }
+
+    bool str(std::string& s) {
+        uint32_t len;
+        if (!u32(len) || static_cast<size_t>(end - p) < len) return false;
+        s.assign(reinterpret_cast<const char*>(p), len);
+        p += len;
+        return true;
+    }
+};
+
+} // namespace
+
+std::vector<uint8_t> serialize_chunks(const ChunkResult& result) {
+    std::vector<uint8_t> out;
+    put_u32(out, static_cast<uint32_t>(result.chunks.size()));
+    put_u32(out, result.total_tokens);
+    put_u32(out, result.total_lines);
+    out.push_back(static_cast<uint8_t>(result.language));
+    out.push_back(result.file_flags);
+    out.push_back(static_cast<uint8_t>(result.skipped));
+
+    for (const auto& chunk : result.chunks) {
+        put_str(out, chunk.content);
+        put_u32(out, chunk.token_count);
+        put_u32(out, chunk.location.line_start);
+        put_u32(out, chunk.location.line_end);
+        put_u32(out, chunk.location.column_start);
+        put_u32(out, chunk.location.column_end);
+        put_u64(out, chunk.location.byte_offset);
+        put_u32(out, chunk.location.byte_length);
+        out.push_back(static_cast<uint8_t>(chunk.type));
+        put_str(out, chunk.context.parent_name);
+        put_str(out, chunk.context.namespace_name);
+        put_u32(out, static_cast<uint32_t>(chunk.context.imports.size()));
+        for (const auto& import_line : chunk.context.imports) {
+            put_str(out, import_line);
+        }
+        put_u32(out, chunk.chunk_index);
+        put_str(out, chunk.hash);
+        put_str(out, chunk.id);
+    }
+
+    put_u32(out, static_cast<uint32_t>(result.symbols.size()));
+    for (const auto& symbol : result.symbols) {
+        put_str(out, symbol.name);
+        put_str(out, symbol.qualified_name);
+        out.push_back(static_cast<uint8_t>(symbol.type));
+        put_u32(out, symbol.line_start);
+        put_u32(out, symbol.line_end);
+        put_u64(out, symbol.byte_offset);
+        put_u64(out, symbol.byte_length);
+        put_u64(out, symbol.hash);
+    }
+
+    return out;
+}
+
+bool deserialize_chunks(const uint8_t* data, size_t size, ChunkResult& out) {
+    Reader r{data, data + size};
+
+    uint32_t count;
+    uint8_t language, skipped;
+    if (!r.u32(count) || !r.u32(out.total_tokens) || !r.u32(out.total_lines) || !r.u8(language) ||
+        !r.u8(out.file_flags) || !r.u8(skipped)) {
+        return false;
+    }
+    out.language = static_cast<Language>(language);
+    out.skipped = skipped != 0;
+
+    out.chunks.clear();
+    out.chunks.reserve(count);
+    out.chunking_time_ms = 0;
+    out.error.clear();
+    out.embed_pool.clear();
+
+    for (uint32_t i = 0; i < count; i++) {
+        CodeChunk chunk;
+        uint8_t type;
+        uint32_t import_count;
+
+        if (!r.str(chunk.content) || !r.u32(chunk.token_count) ||
+            !r.u32(chunk.location.line_start) || !r.u32(chunk.location.line_end) ||
+            !r.u32(chunk.location.column_start) || !r.u32(chunk.location.column_end) ||
+            !r.u64(chunk.location.byte_offset) || !r.u32(chunk.location.byte_length) ||
+            !r.u8(type) || !r.str(chunk.context.parent_name) ||
+            !r.str(chunk.context.namespace_name) || !r.u32(import_count)) {
+            return false;
+        }
+        chunk.type = static_cast<ChunkType>(type);
+
+        chunk.context.imports.resize(import_count);
+        for (auto& import_line : chunk.context.imports) {
+            if (!r.str(import_line)) return false;
+        }
+        if (!r.u32(chunk.chunk_index) || !r.str(chunk.hash) || !r.str(chunk.id)) return false;
+
+        out.chunks.push_back(std::move(chunk));
+    }
+
+    uint32_t symbol_count;
+    if (!r.u32(symbol_count)) return false;
+    out.symbols.clear();
+    out.symbols.reserve(symbol_count);
+    for (uint32_t i = 0; i < symbol_count; i++) {
+        SymbolHash symbol;
+        uint8_t type;
+        if (!r.str(symbol.name) || !r.str(symbol.qualified_name) || !r.u8(type) ||
+            !r.u32(symbol.line_start) || !r.u32(symbol.line_end) ||
+            !r.u64(symbol.byte_offset) || !r.u64(symbol.byte_length) || !r.u64(symbol.hash)) {
+            return false;
+        }
+        symbol.type = static_cast<ChunkType>(type);
+        out.symbols.push_back(std::move(symbol));
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// ChunkCache
+// ----------------------------------------------------------------------------
+
+struct ChunkCache::Impl {
+    struct Key {
+        uint64_t content_hash;
+        uint64_t fingerprint;
+
+        bool operator==(const Key& other) const {
+            return content_hash == other.content_hash && fingerprint == other.fingerprint;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            return static_cast<size_t>(k.content_hash ^ (k.fingerprint * 0x9E3779B185EBCA87ULL));
+        }
+    };
+
+    struct Entry {
+        Key key;
+        ChunkResult result;
+        uint64_t bytes;
+    };
+
+    struct SpillLocation {
+        uint64_t offset;     // Payload offset in the spill file
+        uint32_t length;     // Payload length
+        uint64_t last_used;  // Recency tick, for compaction
+    };
+
+    uint64_t byte_budget;
+    uint64_t spill_budget;
+    std::string spill_path;
+    uint64_t tick = 0;
+
+    std::list<Entry> lru;  // Most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+    std::unordered_map<Key, SpillLocation, KeyHash> spilled;
+
+    std::ofstream spill_out;
+    MappedFile spill_map;
+    uint64_t spill_size = 0;
+
+    ChunkCacheStats stats{};
+    mutable std::mutex mutex;
+
+    static uint64_t estimate_bytes(const ChunkResult& result) {
+        uint64_t bytes = sizeof(ChunkResult);
+        for (const auto& chunk : result.chunks) {
+            bytes += sizeof(CodeChunk);
+            bytes += chunk.content.capacity() + chunk.hash.capacity() + chunk.id.capacity();
+            bytes += chunk.context.parent_name.capacity() + chunk.context.namespace_name.capacity();
+            for (const auto& import_line : chunk.context.imports) {
+                bytes += sizeof(std::string) + import_line.capacity();
+            }
+        }
+        bytes += result.embed_pool.capacity() + result.error.capacity();
+        for (const auto& symbol : result.symbols) {
+            bytes += sizeof(SymbolHash) + symbol.name.capacity() + symbol.qualified_name.capacity();
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Load the spill index from an existing spill file
+     */
+    void open_spill() {
+        if (spill_path.empty()) return;
+
+        MappedFile existing;
+        bool valid = false;
+        uint64_t existing_size = 0;
+        if (existing.open(spill_path) && existing.size() >= SPILL_HEADER_SIZE) {
+            existing_size = existing.size();
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(existing.data());
+            uint32_t magic, version;
+            memcpy(&magic, data, 4);
+            memcpy(&version, data + 4, 4);
+            valid = (magic == SPILL_MAGIC && version == CHUNK_FORMAT_VERSION);
+
+            uint64_t pos = SPILL_HEADER_SIZE;
+            while (valid && pos + SPILL_RECORD_HEADER_SIZE <= existing.size()) {
+                Key key;
+                uint32_t length;
+                memcpy(&key.content_hash, data + pos, 8);
+                memcpy(&key.fingerprint, data + pos + 8, 8);
+                memcpy(&length, data + pos + 16, 4);
+                if (pos + SPILL_RECORD_HEADER_SIZE + length > existing.size()) break;
+
+                // Later records of a key supersede earlier ones and count as newer
+                spilled[key] = {pos + SPILL_RECORD_HEADER_SIZE, length, ++tick};
+                pos += SPILL_RECORD_HEADER_SIZE + length;
+            }
+            spill_size = pos;
+        }
+        existing.close();
+
+        if (!valid) {
+            // Missing or incompatible store: start a fresh one
+            spilled.clear();
+            std::ofstream fresh(spill_path, std::ios::binary | std::ios::trunc);
+            uint32_t header[2] = {SPILL_MAGIC, CHUNK_FORMAT_VERSION};
+            fresh.write(reinterpret_cast<const char*>(header), sizeof(header));
+            spill_size = fresh ? SPILL_HEADER_SIZE : 0;
+            if (!fresh) spill_path.clear();
+        } else if (spill_size < existing_size) {
+            // Drop a truncated tail record left by an interrupted write
+            std::error_code ec;
+            std::filesystem::resize_file(spill_path, spill_size, ec);
+        }
+    }
+
+    bool write_spill(const Key& key, const ChunkResult& result) {
+        if (spill_path.empty() || spilled.count(key)) return true;
+
+        if (!spill_out.is_open()) {
+            // Never map and write the store at once: Windows refuses to open
+            // a file for writing while a read-only mapping shares it
+            spill_map.close();
+            spill_out.open(spill_path, std::ios::binary | std::ios::app);
+            if (!spill_out.is_open()) return false;
+        }
+
+        std::vector<uint8_t> payload = serialize_chunks(result);
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        spill_out.write(reinterpret_cast<const char*>(&key.content_hash), 8);
+        spill_out.write(reinterpret_cast<const char*>(&key.fingerprint), 8);
+        spill_out.write(reinterpret_cast<const char*>(&length), 4);
+        spill_out.write(reinterpret_cast<const char*>(payload.data()), length);
+        if (!spill_out) return false;
+
+        spilled[key] = {spill_size + SPILL_RECORD_HEADER_SIZE, length, ++tick};
+        spill_size += SPILL_RECORD_HEADER_SIZE + length;
+
+        if (spill_size > spill_budget) compact_spill();
+        return true;
+    }
+
+    /**
+     * @brief Rewrite the spill store with its most recently used records
+     *
+     * Keeps records until half the budget is used, so that appends do not
+     * trigger a rewrite each time. Records are copied through a temporary
+     * file that then replaces the store.
+     */
+    void compact_spill() {
+        spill_out.close();
+        if (!spill_map.open(spill_path)) return;
+
+        std::vector<std::pair<Key, SpillLocation>> order(spilled.begin(), spilled.end());
+        std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+            return a.second.last_used > b.second.last_used;
+        });
+
+        std::string tmp_path = spill_path + ".tmp";
+        std::ofstream tmp(tmp_path, std::ios::binary | std::ios::trunc);
+        uint32_t header[2] = {SPILL_MAGIC, CHUNK_FORMAT_VERSION};
+        tmp.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        const char* data = spill_map.data();
+        std::unordered_map<Key, SpillLocation, KeyHash> kept;
+        uint64_t size = SPILL_HEADER_SIZE;
+        for (const auto& [key, loc] : order) {
+            uint64_t record = SPILL_RECORD_HEADER_SIZE + loc.length;
+            if (size + record > spill_budget / 2) break;
+            if (loc.offset + loc.length > spill_map.size()) continue;
+            tmp.write(data + loc.offset - SPILL_RECORD_HEADER_SIZE, static_cast<std::streamsize>(record));
+            kept[key] = {size + SPILL_RECORD_HEADER_SIZE, loc.length, loc.last_used};
+            size += record;
+        }
+        tmp.close();
+        spill_map.close();
+
+        std::error_code ec;
+        if (!tmp) {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+        std::filesystem::rename(tmp_path, spill_path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+
+        spilled = std::move(kept);
+        spill_size = size;
+        stats.compactions++;
+    }
+
+    bool read_spill(const SpillLocation& loc, ChunkResult& out) {
+        if (spill_map.size() < loc.offset + loc.length) {
+            // The store grew since it was mapped: close the writer and remap
+            if (spill_out.is_open()) spill_out.close();
+            if (!spill_map.open(spill_path)) return false;
+            if (spill_map.size() < loc.offset + loc.length) return false;
+        }
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(spill_map.data());
+        return deserialize_chunks(data + loc.offset, loc.length, out);
+    }
+
+    void evict_to_budget() {
+        while (stats.bytes_used > byte_budget && !lru.empty()) {
+            Entry& victim = lru.back();
+            write_spill(victim.key, victim.result);
+            stats.bytes_used -= victim.bytes;
+            stats.evictions++;
+            entries.erase(victim.key);
+            lru.pop_back();
+        }
+    }
+
+    void insert(const Key& key, ChunkResult result) {
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            stats.bytes_used -= it->second->bytes;
+            lru.erase(it->second);
+            entries.erase(it);
+        }
+
+        uint64_t bytes = estimate_bytes(result);
+        if (bytes > byte_budget) {
+            // Too large to keep resident: go straight to the spill store
+            write_spill(key, result);
+            return;
+        }
+
+        lru.push_front(Entry{key, std::move(result), bytes});
+        entries[key] = lru.begin();
+        stats.bytes_used += bytes;
+        evict_to_budget();
+    }
+};
+
+ChunkCache::ChunkCache(uint64_t byte_budget, const std::string& spill_path, uint64_t spill_budget)
+    : impl_(std::make_unique<Impl>())
+{
+    impl_->byte_budget = byte_budget;
+    impl_->spill_budget = spill_budget ? spill_budget : std::max<uint64_t>(byte_budget * 4, 1 << 20);
+    impl_->spill_path = spill_path;
+    impl_->stats.byte_budget = byte_budget;
+    impl_->open_spill();
+}
+
+ChunkCache::~ChunkCache() {
+    flush();
+}
+
+bool ChunkCache::get(uint64_t content_hash, uint64_t fingerprint, ChunkResult& out) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl::Key key{content_hash, fingerprint};
+
+    auto it = impl_->entries.find(key);
+    if (it != impl_->entries.end()) {
+        impl_->lru.splice(impl_->lru.begin(), impl_->lru, it->second);
+        out = it->second->result;
+        impl_->stats.hits++;
+        return true;
+    }
+
+    auto spill_it = impl_->spilled.find(key);
+    if (spill_it != impl_->spilled.end() && impl_->read_spill(spill_it->second, out)) {
+        spill_it->second.last_used = ++impl_->tick;
+        impl_->stats.spill_hits++;
+        impl_->insert(key, out);
+        return true;
+    }
+
+    impl_->stats.misses++;
+    return false;
+}
+
+void ChunkCache::put(uint64_t content_hash, uint64_t fingerprint, const ChunkResult& result) {
+    if (!result.error.empty()) return;
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->insert(Impl::Key{content_hash, fingerprint}, result);
+}
+
+bool ChunkCache::flush() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->spill_path.empty()) return true;
+
+    bool ok = true;
+    for (const auto& entry : impl_->lru) {
+        ok = impl_->write_spill(entry.key, entry.result) && ok;
+    }
+    if (impl_->spill_out.is_open()) {
+        impl_->spill_out.flush();
+        ok = ok && static_cast<bool>(impl_->spill_out);
+    }
+    return ok;
+}
+
+void ChunkCache::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->lru.clear();
+    impl_->entries.clear();
+    impl_->stats.bytes_used = 0;
+
+    if (!impl_->spill_path.empty()) {
+        impl_->spill_out.close();
+        impl_->spill_map.close();
+        impl_->spilled.clear();
+
+        std::ofstream fresh(impl_->spill_path, std::ios::binary | std::ios::trunc);
+        uint32_t header[2] = {SPILL_MAGIC, CHUNK_FORMAT_VERSION};
+        fresh.write(reinterpret_cast<const char*>(header), sizeof(header));
+        impl_->spill_size = SPILL_HEADER_SIZE;
+    }
+}
+
+ChunkCacheStats ChunkCache::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    ChunkCacheStats s = impl_->stats;
+    s.entries = static_cast<uint32_t>(impl_->entries.size());
+    s.spilled = static_cast<uint32_t>(impl_->spilled.size());
+    s.spill_bytes = impl_->spill_path.empty() ? 0 : impl_->spill_size;
+    return s;
+}
+
+} // namespace chunker
+} // namespace archicore
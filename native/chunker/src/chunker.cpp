@@ -39,6 +39,10 @@ static std::string compute_content_hash(const std::string& content) {
     return std::string(buf);
 }
 
+// Furthest a window end is moved forward to reach the end of its line when
+// classifying files; without classification windows always end on a line
+static constexpr size_t MAX_LINE_SNAP_BYTES = 512;
+
 // Helper to count lines in a string
 static uint32_t count_lines(const std::string& str) {
     uint32_t lines = 1;
@@ -84,15 +88,40 @@ Chunker::Chunker(const ChunkerConfig& config)
     , tokenizer_(std::make_unique<Tokenizer>())
     , boundary_detector_(std::make_unique<BoundaryDetector>())
 {
+    boundary_detector_->set_budget(config_.boundary_time_budget_ms, config_.boundary_step_budget);
 }
 
 Chunker::~Chunker() = default;
 
 void Chunker::set_config(const ChunkerConfig& config) {
     config_ = config;
+    boundary_detector_->set_budget(config_.boundary_time_budget_ms, config_.boundary_step_budget);
+}
+
+void Chunker::set_cache(std::shared_ptr<ChunkCache> cache) {
+    cache_ = std::move(cache);
+}
+
+void Chunker::set_identifier_index(std::shared_ptr<IdentifierIndex> index) {
+    identifier_index_ = std::move(index);
+}
+
+uint64_t Chunker::cache_fingerprint(const std::string& filepath) const {
+    // Extension-based detection is path-dependent, so it is part of the key;
+    // content-based detection is already covered by the content hash.
+    ChunkerConfig keyed = config_;
+    if (keyed.language == Language::UNKNOWN && !filepath.empty()) {
+        keyed.language = detect_language(filepath);
+    }
+    return config_fingerprint(keyed);
 }
 
 ChunkResult Chunker::chunk(const std::string& source, const std::string& filepath) {
+    return chunk_classified(source, filepath, 0);
+}
+
+ChunkResult Chunker::chunk_classified(const std::string& source, const std::string& filepath,
+                                      uint8_t file_flags, uint64_t content_hash) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
     ChunkResult result;
@@ -105,20 +134,54 @@ ChunkResult Chunker::chunk(const std::string& source, const std::string& filepat
         return result;
     }
 
-    // Detect language
+    // Detect language (extension table, then content sniffing)
     Language language = config_.language;
-    if (language == Language::UNKNOWN && !filepath.empty()) {
-        language = detect_language(filepath);
+    if (language == Language::UNKNOWN) {
+        language = filepath.empty() ? sniff_language(source) : detect_language(filepath, source);
+    }
+    result.language = language;
+
+    // Classification from the index is reused; otherwise sniff the head here
+    if (config_.classify_files) {
+        if (!(file_flags & FILE_FLAG_CLASSIFIED)) {
+            file_flags = classify_content(filepath, source);
+        }
+        result.file_flags = file_flags;
+
+        // Nothing worth searching in binary or near-random content
+        if (file_flags & (FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY)) {
+            if (identifier_index_ && !filepath.empty()) identifier_index_->remove_file(filepath);
+            result.skipped = true;
+            auto end_time = std::chrono::high_resolution_clock::now();
+            result.chunking_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+            return result;
+        }
     }
 
+    // Minified and generated code has no useful structure: plain windows
+    bool structured = !(result.file_flags & (FILE_FLAG_MINIFIED | FILE_FLAG_GENERATED));
+
     // Detect semantic boundaries
     std::vector<SemanticBoundary> boundaries;
-    if (config_.respect_boundaries) {
+    if (config_.respect_boundaries && structured) {
         boundaries = boundary_detector_->detect(source, language);
+        result.degraded = boundary_detector_->degraded();
+    }
+
+    if (identifier_index_ && !filepath.empty()) {
+        // Reuse the boundaries for call attribution; unstructured files get none
+        bool detected = config_.respect_boundaries || !structured;
+        identifier_index_->update_file(filepath, source, language, content_hash,
+                                       detected ? &boundaries : nullptr, boundary_detector_.get(),
+                                       result.file_flags);
+    }
+
+    if (config_.hash_symbols && !boundaries.empty()) {
+        result.symbols = hash_symbols(source, boundaries, language);
     }
 
     // Create chunks
-    if (config_.respect_boundaries && !boundaries.empty()) {
+    if (!boundaries.empty()) {
         result.chunks = create_chunks_with_boundaries(source, boundaries, language);
     } else {
         result.chunks = create_sliding_window_chunks(source, language);
@@ -131,6 +194,12 @@ ChunkResult Chunker::chunk(const std::string& source, const std::string& filepat
             extract_context(chunk, source, boundaries);
         }
     }
+    assign_chunk_ids(result, filepath);
+
+    // Embedding text needs the final context, so it comes last
+    if (config_.embed_text) {
+        build_embedding_text(result, filepath, language, config_, *tokenizer_);
+    }
 
     auto end_time = std::chrono::high_resolution_clock::now();
     result.chunking_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
@@ -139,15 +208,111 @@ ChunkResult Chunker::chunk(const std::string& source, const std::string& filepat
 }
 
 ChunkResult Chunker::chunk_file(const std::string& filepath) {
+    return chunk_file(filepath, 0, 0);
+}
+
+void Chunker::put_in_cache(uint64_t content_hash, uint64_t fingerprint, ChunkResult& result) {
+    // The embedding text is rebuilt on every hit, so it is not cached
+    std::string pool = std::move(result.embed_pool);
+    result.embed_pool.clear();
+    cache_->put(content_hash, fingerprint, result);
+    result.embed_pool = std::move(pool);
+}
+
+// Index the identifiers of a file whose chunks came from the cache, with
+// the same budgeted detection as a miss; unstructured files get no boundaries
+void Chunker::index_cached(const std::string& filepath, const std::string& source, const ChunkResult& result,
+                           uint64_t content_hash) {
+    static const std::vector<SemanticBoundary> none;
+    bool structured = !(result.file_flags & (FILE_FLAG_MINIFIED | FILE_FLAG_GENERATED));
+    identifier_index_->update_file(filepath, source, result.language, content_hash,
+                                   structured ? nullptr : &none, boundary_detector_.get(), result.file_flags);
+}
+
+ChunkResult Chunker::chunk(const std::string& source, const std::string& filepath, uint64_t content_hash,
+                           uint8_t file_flags) {
+    if (!cache_ || content_hash == 0) {
+        return chunk_classified(source, filepath, file_flags);
+    }
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    uint64_t fingerprint = cache_fingerprint(filepath);
+
+    ChunkResult result;
+    if (cache_->get(content_hash, fingerprint, result)) {
+        if (identifier_index_ && !filepath.empty() && !result.skipped) {
+            index_cached(filepath, source, result, content_hash);
+        }
+        // Entries are shared by files with equal content; IDs and embedding
+        // text headers are per path
+        assign_chunk_ids(result, filepath);
+        if (config_.embed_text) {
+            build_embedding_text(result, filepath, result.language, config_, *tokenizer_);
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.chunking_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        return result;
+    }
+
+    result = chunk_classified(source, filepath, file_flags, content_hash);
+    // A degraded result depends on timing, so it is never cached
+    if (!result.degraded) {
+        put_in_cache(content_hash, fingerprint, result);
+    }
+    return result;
+}
+
+ChunkResult Chunker::chunk_file(const std::string& filepath, uint64_t content_hash,
+                                uint8_t file_flags) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    bool cached = cache_ && content_hash != 0;
+    uint64_t fingerprint = cached ? cache_fingerprint(filepath) : 0;
+
+    ChunkResult result;
+
+    // A hit never touches the file, unless the identifier index lacks it
+    if (cached && cache_->get(content_hash, fingerprint, result)) {
+        if (identifier_index_ && !result.skipped && !identifier_index_->has_file(filepath, content_hash)) {
+            MappedFile file;
+            if (file.open(filepath)) {
+                index_cached(filepath, std::string(file.data(), file.size()), result, content_hash);
+            }
+        }
+        // Entries are shared by files with equal content; IDs and embedding
+        // text headers are per path
+        assign_chunk_ids(result, filepath);
+        if (config_.embed_text) {
+            build_embedding_text(result, filepath, result.language, config_, *tokenizer_);
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.chunking_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        return result;
+    }
+
+    // Known binary files are skipped without being read
+    if (config_.classify_files && (file_flags & FILE_FLAG_CLASSIFIED) &&
+        (file_flags & (FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY))) {
+        result.language = config_.language != Language::UNKNOWN ? config_.language : detect_language(filepath);
+        result.file_flags = file_flags;
+        result.skipped = true;
+        auto end_time = std::chrono::high_resolution_clock::now();
+        result.chunking_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        return result;
+    }
+
     MappedFile file;
     if (!file.open(filepath)) {
-        ChunkResult result;
         result.error = "Failed to open file: " + filepath;
         return result;
     }
 
     std::string source(file.data(), file.size());
-    return chunk(source, filepath);
+    result = chunk_classified(source, filepath, file_flags, content_hash);
+    // A degraded result depends on timing, so it is never cached
+    if (cached && !result.degraded) {
+        put_in_cache(content_hash, fingerprint, result);
+    }
+    return result;
 }
 
 std::vector<CodeChunk> Chunker::create_chunks_with_boundaries(
@@ -312,6 +477,7 @@ std::vector<CodeChunk> Chunker::create_sliding_window_chunks(
 
     size_t pos = 0;
     size_t overlap_bytes = 0;
+    size_t max_snap = config_.classify_files ? MAX_LINE_SNAP_BYTES : source.size();
 
     while (pos < source.size()) {
         // Calculate chunk start with overlap
@@ -321,17 +487,20 @@ std::vector<CodeChunk> Chunker::create_sliding_window_chunks(
         }
 
         // Find chunk end based on token count
-        std::string remaining = source.substr(chunk_start);
         size_t chunk_byte_len = tokenizer_->find_token_boundary(
-            remaining,
+            source.data() + chunk_start,
+            source.size() - chunk_start,
             config_.max_chunk_tokens
         );
 
-        // Adjust to line boundary
+        // Adjust to line boundary, unless the line runs on (minified code)
         size_t chunk_end = chunk_start + chunk_byte_len;
         if (chunk_end < source.size()) {
-            chunk_end = find_line_end(source, chunk_end);
-            if (chunk_end < source.size()) chunk_end++; // Include newline
+            size_t line_end = find_line_end(source, chunk_end);
+            if (line_end - chunk_end <= max_snap) {
+                chunk_end = line_end;
+                if (chunk_end < source.size()) chunk_end++; // Include newline
+            }
         }
         chunk_end = std::min(chunk_end, source.size());
 
@@ -341,11 +510,12 @@ std::vector<CodeChunk> Chunker::create_sliding_window_chunks(
         uint32_t chunk_tokens = tokenizer_->count_tokens(chunk_content);
         if (chunk_tokens < config_.min_chunk_tokens && chunk_end < source.size()) {
             // Extend to next line
-            chunk_end = find_line_end(source, chunk_end + 1);
-            if (chunk_end < source.size()) chunk_end++;
-            chunk_end = std::min(chunk_end, source.size());
-            chunk_content = source.substr(chunk_start, chunk_end - chunk_start);
-            chunk_tokens = tokenizer_->count_tokens(chunk_content);
+            size_t line_end = find_line_end(source, chunk_end + 1);
+            if (line_end - chunk_end <= max_snap) {
+                chunk_end = std::min(line_end + 1, source.size());
+                chunk_content = source.substr(chunk_start, chunk_end - chunk_start);
+                chunk_tokens = tokenizer_->count_tokens(chunk_content);
+            }
         }
 
         auto [line_start, col_start] = offset_to_location(source, chunk_start);
@@ -0,0 +1,180 @@
+/**
+ * @file export.cpp
+ * @brief Deterministic chunk IDs, chunk deltas and binary export
+ * @version 1.0.0
+ *
+ * Gives chunks a stable identity so that an embedding pipeline only
+ * re-embeds and re-upserts what actually changed:
+ * - IDs hash path, semantic name and whitespace-normalized content
+ * - diff_chunks splits a re-chunked file into upserts, updates and deletes
+ * - export_chunks writes a compact binary form to keep between runs
+ */
+
+#include "chunker.h"
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
+
+namespace archicore {
+namespace chunker {
+
+static constexpr uint32_t EXPORT_MAGIC = 0x43484B58;  // "CHKX"
+// Bump together with CHUNK_FORMAT_VERSION (cache.cpp), which versions the payload
+static constexpr uint32_t EXPORT_VERSION = 7;
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+static inline uint64_t fnv1a_byte(uint64_t hash, uint8_t c) {
+    return (hash ^ c) * FNV_PRIME;
+}
+
+static uint64_t fnv1a(uint64_t hash, const std::string& s) {
+    for (unsigned char c : s) {
+        hash = fnv1a_byte(hash, c);
+    }
+    return fnv1a_byte(hash, 0);
+}
+
+static inline bool is_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Hash content with whitespace runs collapsed to one space and trimmed,
+// so that re-indentation and trailing whitespace keep the ID
+static uint64_t hash_normalized(uint64_t hash, const std::string& content) {
+    bool pending_space = false;
+    bool started = false;
+    for (unsigned char c : content) {
+        if (is_space(c)) {
+            pending_space = started;
+            continue;
+        }
+        if (pending_space) {
+            hash = fnv1a_byte(hash, ' ');
+            pending_space = false;
+        }
+        hash = fnv1a_byte(hash, c);
+        started = true;
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+// ChunkIdAssigner
+// ----------------------------------------------------------------------------
+
+ChunkIdAssigner::ChunkIdAssigner(const std::string& filepath)
+    : filepath_(filepath)
+{
+}
+
+void ChunkIdAssigner::assign(CodeChunk& chunk) {
+    uint64_t hash = fnv1a(FNV_OFFSET, filepath_);
+    hash = fnv1a_byte(hash, static_cast<uint8_t>(chunk.type));
+    hash = fnv1a(hash, chunk.context.parent_name);
+    hash = hash_normalized(hash, chunk.content);
+
+    // Identical chunks in one file are told apart by their order
+    uint32_t ordinal = occurrences_[hash]++;
+    for (int i = 0; i < 4; i++) {
+        hash = fnv1a_byte(hash, static_cast<uint8_t>(ordinal >> (i * 8)));
+    }
+
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    chunk.id.assign(buf, 16);
+}
+
+void assign_chunk_ids(ChunkResult& result, const std::string& filepath) {
+    ChunkIdAssigner assigner(filepath);
+    for (auto& chunk : result.chunks) {
+        assigner.assign(chunk);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Delta
+// ----------------------------------------------------------------------------
+
+static bool same_payload(const CodeChunk& a, const CodeChunk& b) {
+    return a.hash == b.hash &&
+           a.location.line_start == b.location.line_start &&
+           a.location.line_end == b.location.line_end &&
+           a.location.byte_offset == b.location.byte_offset &&
+           a.location.byte_length == b.location.byte_length &&
+           a.context.namespace_name == b.context.namespace_name;
+}
+
+ChunkDelta diff_chunks(const ChunkResult& before, const ChunkResult& after) {
+    ChunkDelta delta;
+
+    std::unordered_map<std::string, const CodeChunk*> old_by_id;
+    old_by_id.reserve(before.chunks.size());
+    for (const auto& chunk : before.chunks) {
+        old_by_id.emplace(chunk.id, &chunk);
+    }
+
+    std::unordered_set<std::string> seen;
+    seen.reserve(after.chunks.size());
+
+    for (const auto& chunk : after.chunks) {
+        seen.insert(chunk.id);
+
+        auto it = old_by_id.find(chunk.id);
+        if (it == old_by_id.end()) {
+            delta.upserts.push_back(chunk);
+        } else if (!same_payload(*it->second, chunk)) {
+            delta.updates.push_back(chunk);
+        } else {
+            delta.unchanged++;
+        }
+    }
+
+    for (const auto& chunk : before.chunks) {
+        if (seen.find(chunk.id) == seen.end()) {
+            delta.deletes.push_back(chunk.id);
+        }
+    }
+
+    return delta;
+}
+
+// ----------------------------------------------------------------------------
+// Binary export
+// ----------------------------------------------------------------------------
+
+std::vector<uint8_t> export_chunks(const ChunkResult& result, const std::string& filepath) {
+    std::vector<uint8_t> payload = serialize_chunks(result);
+
+    std::vector<uint8_t> out(12 + filepath.size() + payload.size());
+    uint8_t* p = out.data();
+    uint32_t path_len = static_cast<uint32_t>(filepath.size());
+
+    memcpy(p, &EXPORT_MAGIC, 4);
+    memcpy(p + 4, &EXPORT_VERSION, 4);
+    memcpy(p + 8, &path_len, 4);
+    memcpy(p + 12, filepath.data(), filepath.size());
+    memcpy(p + 12 + filepath.size(), payload.data(), payload.size());
+
+    return out;
+}
+
+bool import_chunks(const uint8_t* data, size_t size, ChunkResult& out, std::string& filepath) {
+    if (size < 12) return false;
+
+    uint32_t magic, version, path_len;
+    memcpy(&magic, data, 4);
+    memcpy(&version, data + 4, 4);
+    memcpy(&path_len, data + 8, 4);
+
+    if (magic != EXPORT_MAGIC || version != EXPORT_VERSION || size - 12 < path_len) {
+        return false;
+    }
+
+    filepath.assign(reinterpret_cast<const char*>(data + 12), path_len);
+    return deserialize_chunks(data + 12 + path_len, size - 12 - path_len, out);
+}
+
+} // namespace chunker
+} // namespace archicore
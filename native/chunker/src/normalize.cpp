@@ -0,0 +1,243 @@
+/**
+ * @file normalize.cpp
+ * @brief Embedding text normalization
+ * @version 1.0.0
+ *
+ * Produces the text that is actually sent to the embedding model:
+ * - Comments stripped using the language's comment syntax
+ * - Indentation, whitespace runs and blank lines collapsed
+ * - A short path/scope/imports header prepended
+ * All chunks of a file are written into one pooled buffer.
+ */
+
+#include "chunker.h"
+#include <algorithm>
+#include <cctype>
+
+namespace archicore {
+namespace chunker {
+
+// Budget for the imports line of the context header
+static constexpr size_t MAX_HEADER_IMPORT_BYTES = 256;
+
+namespace {
+
+/**
+ * @brief Appends text to the pool, collapsing whitespace on the fly
+ */
+class Writer {
+public:
+    Writer(std::string& out, bool collapse) : out_(out), collapse_(collapse) {}
+
+    void put(char c) {
+        if (!collapse_) {
+            out_ += c;
+            return;
+        }
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+            pending_space_ = !at_line_start_;
+            return;
+        }
+        if (c == '\n') {
+            if (!at_line_start_) {
+                out_ += '\n';
+                at_line_start_ = true;
+            }
+            pending_space_ = false;
+            return;
+        }
+        if (pending_space_) {
+            out_ += ' ';
+            pending_space_ = false;
+        }
+        out_ += c;
+        at_line_start_ = false;
+    }
+
+    void put(const char* data, size_t len) {
+        for (size_t i = 0; i < len; i++) put(data[i]);
+    }
+
+    // Stand-in for a removed comment: keeps tokens apart, never adds a line
+    void separator() {
+        if (collapse_) {
+            pending_space_ = !at_line_start_;
+        } else {
+            out_ += ' ';
+        }
+    }
+
+private:
+    std::string& out_;
+    bool collapse_;
+    bool at_line_start_ = true;
+    bool pending_space_ = false;
+};
+
+size_t skip_quoted(const std::string& s, size_t pos, char quote) {
+    pos++;
+    while (pos < s.size()) {
+        char c = s[pos];
+        if (c == '\\') {
+            pos += 2;
+            continue;
+        }
+        pos++;
+        if (c == quote) break;
+        // Unterminated single-line literal: stop at the line end
+        if (c == '\n' && quote != '`') break;
+    }
+    return std::min(pos, s.size());
+}
+
+size_t skip_triple_quoted(const std::string& s, size_t pos) {
+    char quote = s[pos];
+    size_t end = s.find(std::string(3, quote), pos + 3);
+    return end == std::string::npos ? s.size() : end + 3;
+}
+
+void append_code(Writer& w, const std::string& s, const LexicalSyntax& syntax, bool strip_comments) {
+    size_t pos = 0;
+    size_t len = s.size();
+
+    while (pos < len) {
+        char c = s[pos];
+        char next = pos + 1 < len ? s[pos + 1] : '\0';
+
+        if (strip_comments) {
+            if (c == '/' && next == '/' && syntax.slash_line) {
+                while (pos < len && s[pos] != '\n') pos++;
+                w.separator();
+                continue;
+            }
+            if (c == '/' && next == '*' && syntax.slash_block) {
+                size_t end = s.find("*/", pos + 2);
+                pos = end == std::string::npos ? len : end + 2;
+                w.separator();
+                continue;
+            }
+            if (c == '#' && syntax.hash_line) {
+                while (pos < len && s[pos] != '\n') pos++;
+                w.separator();
+                continue;
+            }
+        }
+
+        size_t end = pos;
+        if (c == '/' && next != '/' && next != '*' && syntax.regex_literals &&
+            detail::starts_regex(s.data(), pos)) {
+            // Quotes and '//' inside a regex literal are neither strings nor comments
+            end = detail::skip_regex(s.data(), len, pos);
+        } else if ((c == '"' || c == '\'') && syntax.triple_quotes &&
+            pos + 2 < len && s[pos + 1] == c && s[pos + 2] == c) {
+            end = skip_triple_quoted(s, pos);
+        } else if ((c == '"' && syntax.double_quotes) || (c == '\'' && syntax.single_quotes) ||
+                   (c == '`' && (syntax.backtick_template || syntax.backtick_raw))) {
+            end = skip_quoted(s, pos, c);
+        }
+
+        if (end > pos) {
+            // Literals are copied through; only their whitespace may collapse
+            w.put(s.data() + pos, end - pos);
+            pos = end;
+            continue;
+        }
+
+        w.put(c);
+        pos++;
+    }
+}
+
+// "import { A } from './a';" -> "./a"; lines without a quoted module are kept whole
+std::string_view import_label(std::string_view line) {
+    size_t close = line.find_last_of("'\"");
+    if (close != std::string_view::npos && close > 0) {
+        size_t open = line.find_last_of(line[close], close - 1);
+        if (open != std::string_view::npos && close > open + 1) {
+            return line.substr(open + 1, close - open - 1);
+        }
+    }
+    while (!line.empty() && (line.back() == ';' || std::isspace(static_cast<unsigned char>(line.back())))) {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+void append_header(std::string& out, const CodeChunk& chunk, const std::string& filepath) {
+    size_t start = out.size();
+
+    if (!filepath.empty()) {
+        out += "File: ";
+        out += filepath;
+        out += '\n';
+    }
+
+    const ChunkContext& ctx = chunk.context;
+    if (!ctx.namespace_name.empty() || !ctx.parent_name.empty()) {
+        out += "Scope: ";
+        out += ctx.namespace_name;
+        if (!ctx.namespace_name.empty() && !ctx.parent_name.empty()) out += '.';
+        out += ctx.parent_name;
+        out += '\n';
+    }
+
+    // An import chunk already lists its imports
+    if (!ctx.imports.empty() && chunk.type != ChunkType::IMPORT) {
+        size_t line_start = out.size();
+        out += "Imports: ";
+        for (size_t i = 0; i < ctx.imports.size(); i++) {
+            std::string_view label = import_label(ctx.imports[i]);
+            if (out.size() - line_start + label.size() > MAX_HEADER_IMPORT_BYTES) {
+                out += i > 0 ? ", ..." : "...";
+                break;
+            }
+            if (i > 0) out += ", ";
+            out += label;
+        }
+        out += '\n';
+    }
+
+    if (out.size() > start) {
+        out += '\n';
+    }
+}
+
+} // namespace
+
+void build_embedding_text(ChunkResult& result, const std::string& filepath,
+                          Language language, const ChunkerConfig& config,
+                          Tokenizer& tokenizer) {
+    std::string& pool = result.embed_pool;
+    pool.clear();
+
+    size_t estimate = 0;
+    for (const auto& chunk : result.chunks) {
+        estimate += chunk.content.size();
+        if (config.embed_context_header) estimate += filepath.size() + 64;
+    }
+    pool.reserve(estimate);
+
+    LexicalSyntax syntax = lexical_syntax(language);
+
+    for (auto& chunk : result.chunks) {
+        size_t start = pool.size();
+
+        if (config.embed_context_header) {
+            append_header(pool, chunk, filepath);
+        }
+
+        Writer writer(pool, config.embed_collapse_whitespace);
+        append_code(writer, chunk.content, syntax, config.embed_strip_comments);
+
+        while (pool.size() > start && pool.back() == '\n') {
+            pool.pop_back();
+        }
+
+        chunk.embed_offset = static_cast<uint32_t>(start);
+        chunk.embed_length = static_cast<uint32_t>(pool.size() - start);
+        chunk.embed_token_count = tokenizer.count_tokens(pool.data() + start, chunk.embed_length);
+    }
+}
+
+} // namespace chunker
+} // namespace archicore
@@ -0,0 +1,261 @@
+/**
+ * @file pack.cpp
+ * @brief Token-budgeted selection of context snippets
+ * @version 1.0.0
+ *
+ * Fills an LLM prompt with the most relevant context that fits:
+ * - Exact token costs from the cl100k tokenizer
+ * - Duplicate and overlapping snippets are never paid for twice
+ * - Greedy by score density, refined by a knapsack DP over overlap groups
+ */
+
+// Prevent Windows min/max macros from conflicting with std::min/std::max
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include "chunker.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace archicore {
+namespace chunker {
+
+namespace {
+
+bool has_range(const ContextSnippet& s) {
+    return !s.source.empty() && s.line_start > 0;
+}
+
+uint32_t range_end(const ContextSnippet& s) {
+    return std::max(s.line_start, s.line_end);
+}
+
+bool overlaps(const ContextSnippet& a, const ContextSnippet& b) {
+    if (!has_range(a) || !has_range(b) || a.source != b.source) return false;
+    return a.line_start <= range_end(b) && b.line_start <= range_end(a);
+}
+
+/**
+ * @brief Selection under construction with pairwise overlap checks
+ */
+struct Selection {
+    const std::vector<ContextSnippet>& snippets;
+    const std::vector<uint32_t>& cost;
+    std::unordered_map<std::string, std::vector<uint32_t>> by_source;
+    std::vector<uint32_t> items;
+    uint64_t tokens = 0;
+    double score = 0;
+
+    Selection(const std::vector<ContextSnippet>& s, const std::vector<uint32_t>& c)
+        : snippets(s), cost(c) {}
+
+    bool conflicts(uint32_t i) const {
+        if (!has_range(snippets[i])) return false;
+        auto it = by_source.find(snippets[i].source);
+        if (it == by_source.end()) return false;
+        for (uint32_t j : it->second) {
+            if (overlaps(snippets[i], snippets[j])) return true;
+        }
+        return false;
+    }
+
+    bool try_add(uint32_t i, uint64_t budget) {
+        if (tokens + cost[i] > budget || conflicts(i)) return false;
+        add(i);
+        return true;
+    }
+
+    void add(uint32_t i) {
+        if (has_range(snippets[i])) by_source[snippets[i].source].push_back(i);
+        items.push_back(i);
+        tokens += cost[i];
+        score += snippets[i].score;
+    }
+};
+
+/**
+ * @brief Group candidates whose line ranges overlap, transitively, per source
+ */
+std::vector<std::vector<uint32_t>> overlap_groups(const std::vector<ContextSnippet>& snippets,
+                                                  const std::vector<uint32_t>& candidates) {
+    std::vector<uint32_t> ranged;
+    std::vector<std::vector<uint32_t>> groups;
+    for (uint32_t i : candidates) {
+        if (has_range(snippets[i])) {
+            ranged.push_back(i);
+        } else {
+            groups.push_back({i});
+        }
+    }
+
+    std::sort(ranged.begin(), ranged.end(), [&](uint32_t a, uint32_t b) {
+        const ContextSnippet& sa = snippets[a];
+        const ContextSnippet& sb = snippets[b];
+        if (sa.source != sb.source) return sa.source < sb.source;
+        if (sa.line_start != sb.line_start) return sa.line_start < sb.line_start;
+        return a < b;
+    });
+
+    uint32_t group_end = 0;
+    for (size_t k = 0; k < ranged.size(); k++) {
+        const ContextSnippet& s = snippets[ranged[k]];
+        bool joins = k > 0 && snippets[ranged[k - 1]].source == s.source && s.line_start <= group_end;
+        if (joins) {
+            groups.back().push_back(ranged[k]);
+            group_end = std::max(group_end, range_end(s));
+        } else {
+            groups.push_back({ranged[k]});
+            group_end = range_end(s);
+        }
+    }
+    return groups;
+}
+
+/**
+ * @brief Multiple-choice knapsack: at most one snippet per group
+ *
+ * Costs are rounded up to multiples of `unit` so the table stays within
+ * max_cells; rounding up keeps every DP solution within the real budget.
+ */
+std::vector<uint32_t> knapsack(const std::vector<ContextSnippet>& snippets,
+                               const std::vector<uint32_t>& cost,
+                               const std::vector<std::vector<uint32_t>>& groups,
+                               uint64_t budget, uint64_t max_cells, uint64_t& unit) {
+    uint64_t g = groups.size();
+    unit = std::max<uint64_t>(1, (g * (budget + 1) + max_cells - 1) / std::max<uint64_t>(max_cells, 1));
+    size_t capacity = static_cast<size_t>(budget / unit);
+
+    std::vector<double> best(capacity + 1, 0.0);
+    std::vector<double> next(capacity + 1);
+    // choice[group][c] = 1 + position in group of the snippet taken at capacity c, 0 = none
+    std::vector<uint32_t> choice(groups.size() * (capacity + 1), 0);
+
+    for (size_t gi = 0; gi < groups.size(); gi++) {
+        next = best;
+        uint32_t* row = choice.data() + gi * (capacity + 1);
+        for (size_t m = 0; m < groups[gi].size(); m++) {
+            uint32_t idx = groups[gi][m];
+            uint64_t w = (cost[idx] + unit - 1) / unit;
+            if (w > capacity) continue;
+            double value = snippets[idx].score;
+            for (size_t c = capacity; c >= w; c--) {
+                double candidate = best[c - w] + value;
+                if (candidate > next[c]) {
+                    next[c] = candidate;
+                    row[c] = static_cast<uint32_t>(m + 1);
+                }
+                if (c == 0) break;
+            }
+        }
+        best.swap(next);
+    }
+
+    std::vector<uint32_t> taken;
+    size_t c = capacity;
+    for (size_t gi = groups.size(); gi-- > 0;) {
+        uint32_t m = choice[gi * (capacity + 1) + c];
+        if (m == 0) continue;
+        uint32_t idx = groups[gi][m - 1];
+        taken.push_back(idx);
+        c -= static_cast<size_t>((cost[idx] + unit - 1) / unit);
+    }
+    return taken;
+}
+
+} // namespace
+
+PackResult pack_context(const std::vector<ContextSnippet>& snippets, const PackOptions& options) {
+    PackResult result;
+    const uint32_t n = static_cast<uint32_t>(snippets.size());
+    const uint64_t budget = options.token_budget;
+
+    Tokenizer tokenizer;
+    result.token_counts.resize(n);
+    std::vector<uint32_t> cost(n);
+    for (uint32_t i = 0; i < n; i++) {
+        result.token_counts[i] = tokenizer.count_tokens(snippets[i].text);
+        cost[i] = result.token_counts[i] + options.snippet_overhead;
+    }
+
+    // Keep one copy of identical text: pinned first, then the best score
+    std::vector<bool> alive(n, true);
+    std::vector<bool> pinned(n, false);
+    std::unordered_map<std::string, uint32_t> first_copy;
+    for (uint32_t i = 0; i < n; i++) {
+        pinned[i] = snippets[i].pinned;
+        auto inserted = first_copy.emplace(snippets[i].text, i);
+        if (inserted.second) continue;
+
+        uint32_t& kept = inserted.first->second;
+        bool pin = pinned[kept] || pinned[i];
+        bool replace = (pinned[i] && !pinned[kept]) ||
+                       (pinned[i] == pinned[kept] && snippets[i].score > snippets[kept].score);
+        if (replace) {
+            alive[kept] = false;
+            kept = i;
+        } else {
+            alive[i] = false;
+        }
+        pinned[kept] = pin;
+        result.duplicates++;
+    }
+
+    Selection chosen(snippets, cost);
+    for (uint32_t i = 0; i < n; i++) {
+        if (alive[i] && pinned[i]) chosen.try_add(i, budget);
+    }
+    const uint64_t remaining = budget - chosen.tokens;
+
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < n; i++) {
+        if (alive[i] && !pinned[i] && snippets[i].score > 0 && cost[i] <= remaining && !chosen.conflicts(i)) {
+            candidates.push_back(i);
+        }
+    }
+
+    // Score density order, ties broken by input order for determinism
+    std::vector<uint32_t> by_density = candidates;
+    std::stable_sort(by_density.begin(), by_density.end(), [&](uint32_t a, uint32_t b) {
+        double da = snippets[a].score / std::max<uint32_t>(cost[a], 1);
+        double db = snippets[b].score / std::max<uint32_t>(cost[b], 1);
+        return da > db;
+    });
+
+    Selection greedy(snippets, cost);
+    for (uint32_t i : by_density) greedy.try_add(i, remaining);
+
+    std::vector<std::vector<uint32_t>> groups = overlap_groups(snippets, candidates);
+    uint64_t unit = 1;
+    std::vector<uint32_t> dp_items;
+    if (!groups.empty() && remaining > 0) {
+        dp_items = knapsack(snippets, cost, groups, remaining, options.max_dp_cells, unit);
+    }
+    double dp_score = 0;
+    for (uint32_t i : dp_items) dp_score += snippets[i].score;
+
+    Selection refined(snippets, cost);
+    const std::vector<uint32_t>& base = dp_score > greedy.score ? dp_items : greedy.items;
+    for (uint32_t i : base) refined.add(i);
+    // Fill what rounding or the one-per-group restriction left unused
+    std::vector<bool> used(n, false);
+    for (uint32_t i : refined.items) used[i] = true;
+    for (uint32_t i : by_density) {
+        if (!used[i]) refined.try_add(i, remaining);
+    }
+
+    for (uint32_t i : refined.items) chosen.add(i);
+
+    result.selected = chosen.items;
+    std::sort(result.selected.begin(), result.selected.end());
+    result.total_tokens = static_cast<uint32_t>(chosen.tokens);
+    result.total_score = chosen.score;
+    result.exact = unit == 1 && std::all_of(groups.begin(), groups.end(), [](const std::vector<uint32_t>& g) {
+        return g.size() == 1;
+    });
+    return result;
+}
+
+} // namespace chunker
+} // namespace archicore
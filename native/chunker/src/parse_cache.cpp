@@ -0,0 +1,287 @@
+/**
+ * @file parse_cache.cpp
+ * @brief Persistent content-hash keyed store of parse results
+ * @version 1.0.0
+ *
+ * Lets a restarted server skip parsing for files whose content was parsed
+ * before:
+ * - Append-only record file, memory-mapped on open to rebuild the index
+ * - Payloads are opaque (serialised syntax trees or symbols)
+ * - Compaction drops records of content no longer in the project
+ */
+
+// Prevent Windows min/max macros from conflicting with std::min/std::max
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include "chunker.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace archicore {
+namespace chunker {
+
+// Bump when the record layout changes; payload changes are covered by fingerprints
+static constexpr uint32_t PARSE_CACHE_VERSION = 1;
+
+static constexpr uint32_t PARSE_CACHE_MAGIC = 0x53435041;  // "APCS"
+static constexpr size_t PARSE_CACHE_HEADER_SIZE = 8;
+static constexpr size_t PARSE_RECORD_HEADER_SIZE = 20;
+
+struct ParseCache::Impl {
+    struct Key {
+        uint64_t content_hash;
+        uint64_t fingerprint;
+
+        bool operator==(const Key& other) const {
+            return content_hash == other.content_hash && fingerprint == other.fingerprint;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            return static_cast<size_t>(k.content_hash ^ (k.fingerprint * 0x9E3779B185EBCA87ULL));
+        }
+    };
+
+    struct Location {
+        uint64_t offset;  // Payload offset in the store
+        uint32_t length;  // Payload length
+    };
+
+    std::string path;
+    std::unordered_map<Key, Location, KeyHash> records;
+
+    std::ofstream out;
+    MappedFile map;
+    uint64_t size = 0;
+
+    ParseCacheStats stats{};
+    mutable std::mutex mutex;
+
+    bool write_header(const std::string& target) {
+        std::ofstream fresh(target, std::ios::binary | std::ios::trunc);
+        uint32_t header[2] = {PARSE_CACHE_MAGIC, PARSE_CACHE_VERSION};
+        fresh.write(reinterpret_cast<const char*>(header), sizeof(header));
+        return static_cast<bool>(fresh);
+    }
+
+    /**
+     * @brief Rebuild the index from the store, starting a fresh one if invalid
+     */
+    void open() {
+        records.clear();
+        size = 0;
+        if (path.empty()) return;
+
+        bool valid = false;
+        uint64_t existing_size = 0;
+        if (map.open(path) && map.size() >= PARSE_CACHE_HEADER_SIZE) {
+            existing_size = map.size();
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(map.data());
+            uint32_t magic, version;
+            memcpy(&magic, data, 4);
+            memcpy(&version, data + 4, 4);
+            valid = (magic == PARSE_CACHE_MAGIC && version == PARSE_CACHE_VERSION);
+
+            uint64_t pos = PARSE_CACHE_HEADER_SIZE;
+            while (valid && pos + PARSE_RECORD_HEADER_SIZE <= existing_size) {
+                Key key;
+                uint32_t length;
+                memcpy(&key.content_hash, data + pos, 8);
+                memcpy(&key.fingerprint, data + pos + 8, 8);
+                memcpy(&length, data + pos + 16, 4);
+                if (pos + PARSE_RECORD_HEADER_SIZE + length > existing_size) break;
+
+                records[key] = {pos + PARSE_RECORD_HEADER_SIZE, length};
+                pos += PARSE_RECORD_HEADER_SIZE + length;
+            }
+            size = pos;
+        }
+
+        if (!valid) {
+            // Missing or incompatible store: start a fresh one
+            map.close();
+            records.clear();
+            if (write_header(path)) {
+                size = PARSE_CACHE_HEADER_SIZE;
+            } else {
+                path.clear();
+            }
+        } else if (size < existing_size) {
+            // Drop a truncated tail record left by an interrupted write
+            map.close();
+            std::error_code ec;
+            std::filesystem::resize_file(path, size, ec);
+        }
+    }
+
+    bool append(const Key& key, const uint8_t* data, uint32_t length) {
+        if (!out.is_open()) {
+            // The mapping may deny write sharing (Windows); it is remapped on the next read
+            map.close();
+            out.open(path, std::ios::binary | std::ios::app);
+            if (!out.is_open()) return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&key.content_hash), 8);
+        out.write(reinterpret_cast<const char*>(&key.fingerprint), 8);
+        out.write(reinterpret_cast<const char*>(&length), 4);
+        out.write(reinterpret_cast<const char*>(data), length);
+        if (!out) return false;
+
+        records[key] = {size + PARSE_RECORD_HEADER_SIZE, length};
+        size += PARSE_RECORD_HEADER_SIZE + length;
+        return true;
+    }
+
+    const uint8_t* read(const Location& loc) {
+        if (map.size() < loc.offset + loc.length) {
+            // The store grew since it was mapped: flush the writer and remap
+            if (out.is_open()) out.close();
+            if (!map.open(path)) return nullptr;
+            if (map.size() < loc.offset + loc.length) return nullptr;
+        }
+        return reinterpret_cast<const uint8_t*>(map.data()) + loc.offset;
+    }
+};
+
+ParseCache::ParseCache(const std::string& path)
+    : impl_(std::make_unique<Impl>())
+{
+    impl_->path = path;
+    impl_->open();
+}
+
+ParseCache::~ParseCache() {
+    flush();
+}
+
+bool ParseCache::is_open() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return !impl_->path.empty();
+}
+
+bool ParseCache::get(uint64_t content_hash, uint64_t fingerprint, std::vector<uint8_t>& out) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    auto it = impl_->records.find(Impl::Key{content_hash, fingerprint});
+    if (it != impl_->records.end()) {
+        const uint8_t* data = impl_->read(it->second);
+        if (data) {
+            out.assign(data, data + it->second.length);
+            impl_->stats.hits++;
+            return true;
+        }
+    }
+
+    impl_->stats.misses++;
+    return false;
+}
+
+bool ParseCache::contains(uint64_t content_hash, uint64_t fingerprint) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->records.count(Impl::Key{content_hash, fingerprint}) != 0;
+}
+
+bool ParseCache::put(uint64_t content_hash, uint64_t fingerprint, const uint8_t* data, size_t size) {
+    if (content_hash == 0 || size > UINT32_MAX) return false;
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->path.empty()) return false;
+
+    Impl::Key key{content_hash, fingerprint};
+    if (impl_->records.count(key)) return true;
+
+    if (!impl_->append(key, data, static_cast<uint32_t>(size))) return false;
+    impl_->stats.stores++;
+    return true;
+}
+
+bool ParseCache::flush() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->out.is_open()) return true;
+    impl_->out.flush();
+    return static_cast<bool>(impl_->out);
+}
+
+void ParseCache::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->path.empty()) return;
+
+    impl_->out.close();
+    impl_->map.close();
+    impl_->records.clear();
+    impl_->size = impl_->write_header(impl_->path) ? PARSE_CACHE_HEADER_SIZE : 0;
+}
+
+uint32_t ParseCache::compact(const std::vector<uint64_t>& live_hashes) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->path.empty()) return 0;
+
+    std::unordered_set<uint64_t> live(live_hashes.begin(), live_hashes.end());
+    uint32_t dropped = 0;
+    for (const auto& record : impl_->records) {
+        if (!live.count(record.first.content_hash)) dropped++;
+    }
+    if (dropped == 0) return 0;
+
+    if (impl_->out.is_open()) impl_->out.close();
+    if (!impl_->map.open(impl_->path)) return 0;
+
+    // Copy live records in file order into a temporary store, then swap it in
+    std::vector<std::pair<Impl::Key, Impl::Location>> kept;
+    kept.reserve(impl_->records.size() - dropped);
+    for (const auto& record : impl_->records) {
+        if (live.count(record.first.content_hash)) kept.push_back(record);
+    }
+    std::sort(kept.begin(), kept.end(), [](const auto& a, const auto& b) {
+        return a.second.offset < b.second.offset;
+    });
+
+    std::string tmp_path = impl_->path + ".tmp";
+    {
+        std::ofstream tmp(tmp_path, std::ios::binary | std::ios::trunc);
+        uint32_t header[2] = {PARSE_CACHE_MAGIC, PARSE_CACHE_VERSION};
+        tmp.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(impl_->map.data());
+        for (const auto& record : kept) {
+            tmp.write(reinterpret_cast<const char*>(data + record.second.offset - PARSE_RECORD_HEADER_SIZE),
+                      PARSE_RECORD_HEADER_SIZE + record.second.length);
+        }
+        if (!tmp) {
+            tmp.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp_path, ec);
+            return 0;
+        }
+    }
+
+    impl_->map.close();
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, impl_->path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return 0;
+    }
+
+    impl_->open();
+    return dropped;
+}
+
+ParseCacheStats ParseCache::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    ParseCacheStats s = impl_->stats;
+    s.entries = static_cast<uint32_t>(impl_->records.size());
+    s.file_bytes = impl_->size;
+    return s;
+}
+
+} // namespace chunker
+} // namespace archicore
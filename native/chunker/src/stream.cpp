@@ -0,0 +1,208 @@
+/**
+ * @file stream.cpp
+ * @brief Streaming chunk iterator over memory-mapped files
+ * @version 1.0.0
+ *
+ * Chunks huge files window by window so that memory stays bounded:
+ * - Each window is cut at a top-level line found within the look-ahead
+ * - Locations are rebased to absolute file offsets and line numbers
+ * - Imports seen in earlier windows are carried into later chunks
+ * - Chunk IDs are assigned across windows, as for a whole-file chunk
+ * - The file is classified and its language detected once; binary files
+ *   yield no chunks
+ * - Embedding text is built per window, after imports are carried in
+ */
+
+// Prevent Windows min/max macros from conflicting with std::min/std::max
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include "chunker.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace archicore {
+namespace chunker {
+
+// Upper bound on import lines carried across windows
+static constexpr size_t MAX_CARRIED_IMPORTS = 64;
+
+ChunkStream::ChunkStream(const std::string& filepath, const ChunkerConfig& config)
+    : chunker_(config)
+    , config_(config)
+    , filepath_(filepath)
+    , ids_(filepath)
+    , tokenizer_(std::make_unique<Tokenizer>())
+{
+    if (!file_.open(filepath)) {
+        error_ = "Failed to open file: " + filepath;
+    }
+
+    // Classify once from the file head rather than per window; binary
+    // content is skipped as a whole
+    if (error_.empty() && config_.classify_files) {
+        file_flags_ = classify_content(filepath, file_.view());
+        if (file_flags_ & (FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY)) {
+            skipped_ = true;
+            window_start_ = file_.size();
+        }
+    }
+
+    if (config_.stream_window_bytes == 0) {
+        config_.stream_window_bytes = ChunkerConfig{}.stream_window_bytes;
+    }
+
+    // Likewise the language: sniffed per window, an extensionless script
+    // would lose it after the window holding its shebang
+    bool pinned = false;
+    if (error_.empty() && config_.language == Language::UNKNOWN) {
+        config_.language = detect_language(filepath, file_.view());
+        pinned = config_.language != Language::UNKNOWN;
+    }
+
+    // Embedding text needs the carried imports and absolute chunk IDs, so
+    // it is built here per window rather than by the window's chunker
+    if (config_.embed_text) {
+        embed_ = true;
+        config_.embed_text = false;
+    }
+    if (pinned || embed_) {
+        chunker_.set_config(config_);
+    }
+}
+
+ChunkStream::~ChunkStream() = default;
+
+size_t ChunkStream::find_cut(size_t target) const {
+    const char* data = file_.data();
+    size_t size = file_.size();
+    size_t limit = std::min(size, target + config_.stream_lookahead_bytes);
+
+    // Prefer a line that starts a new top-level construct: a newline followed
+    // by a non-indented character that does not close a previous scope.
+    size_t last_newline = size;
+    size_t pos = target;
+    while (pos < limit) {
+        const void* hit = std::memchr(data + pos, '\n', limit - pos);
+        if (!hit) break;
+
+        size_t q = static_cast<size_t>(static_cast<const char*>(hit) - data);
+        if (q + 1 >= limit) break;
+
+        unsigned char next = static_cast<unsigned char>(data[q + 1]);
+        if (!std::isspace(next) && next != '}' && next != ')' && next != ']') {
+            return q + 1;
+        }
+        last_newline = q;
+        pos = q + 1;
+    }
+
+    if (last_newline < size) {
+        return last_newline + 1;
+    }
+
+    // No newline in the look-ahead: fall back to the last newline in the window
+    for (size_t q = target; q > window_start_; q--) {
+        if (data[q - 1] == '\n') return q;
+    }
+
+    // One giant line (minified code): hard cut, but never inside a UTF-8 sequence
+    size_t cut = limit;
+    while (cut > window_start_ + 1 && cut < size &&
+           (static_cast<unsigned char>(data[cut]) & 0xC0) == 0x80) {
+        cut--;
+    }
+    return cut;
+}
+
+bool ChunkStream::fill() {
+    size_t size = file_.size();
+    if (!error_.empty() || window_start_ >= size) return false;
+
+    size_t target = window_start_ + config_.stream_window_bytes;
+    size_t cut = (target >= size) ? size : find_cut(target);
+
+    std::string window(file_.data() + window_start_, cut - window_start_);
+    ChunkResult result = chunker_.chunk(window, filepath_, 0, file_flags_);
+    degraded_ = degraded_ || result.degraded;
+
+    std::vector<std::string> window_imports;
+    for (auto& chunk : result.chunks) {
+        for (const auto& import_line : chunk.context.imports) {
+            if (std::find(window_imports.begin(), window_imports.end(), import_line) == window_imports.end()) {
+                window_imports.push_back(import_line);
+            }
+        }
+
+        chunk.location.byte_offset += window_start_;
+        chunk.location.line_start += line_base_;
+        chunk.location.line_end += line_base_;
+        chunk.chunk_index = next_index_++;
+        ids_.assign(chunk);
+
+        if (config_.include_context && config_.preserve_imports && !carried_imports_.empty()) {
+            // Carried imports first, minus those this window repeats
+            std::vector<std::string> imports;
+            imports.reserve(carried_imports_.size() + chunk.context.imports.size());
+            for (const auto& import_line : carried_imports_) {
+                if (std::find(chunk.context.imports.begin(), chunk.context.imports.end(), import_line) ==
+                    chunk.context.imports.end()) {
+                    imports.push_back(import_line);
+                }
+            }
+            imports.insert(imports.end(), std::make_move_iterator(chunk.context.imports.begin()),
+                           std::make_move_iterator(chunk.context.imports.end()));
+            chunk.context.imports = std::move(imports);
+        }
+    }
+
+    for (auto& import_line : window_imports) {
+        if (carried_imports_.size() >= MAX_CARRIED_IMPORTS) break;
+        if (std::find(carried_imports_.begin(), carried_imports_.end(), import_line) == carried_imports_.end()) {
+            carried_imports_.push_back(std::move(import_line));
+        }
+    }
+
+    if (embed_) {
+        build_embedding_text(result, filepath_, result.language, config_, *tokenizer_);
+    }
+    embed_pool_ = std::move(result.embed_pool);
+
+    line_base_ += static_cast<uint32_t>(std::count(window.begin(), window.end(), '\n'));
+    window_start_ = cut;
+
+    pending_ = std::move(result.chunks);
+    pending_pos_ = 0;
+    return true;
+}
+
+bool ChunkStream::next(CodeChunk& out) {
+    while (pending_pos_ >= pending_.size()) {
+        if (!fill()) return false;
+    }
+    out = std::move(pending_[pending_pos_++]);
+    return true;
+}
+
+bool ChunkStream::next_window(std::vector<CodeChunk>& out) {
+    out.clear();
+    while (pending_pos_ >= pending_.size()) {
+        if (!fill()) return false;
+    }
+    out.insert(out.end(),
+               std::make_move_iterator(pending_.begin() + pending_pos_),
+               std::make_move_iterator(pending_.end()));
+    pending_.clear();
+    pending_pos_ = 0;
+    return true;
+}
+
+bool ChunkStream::done() const {
+    return pending_pos_ >= pending_.size() &&
+           (!error_.empty() || window_start_ >= file_.size());
+}
+
+} // namespace chunker
+} // namespace archicore
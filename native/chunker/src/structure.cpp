@@ -0,0 +1,435 @@
+/**
+ * @file structure.cpp
+ * @brief Structural bitmask pre-pass for boundary detection
+ * @version 1.0.0
+ *
+ * Classifies a source file once, 64 bytes at a time:
+ * - Stage 1 turns character classes into 64-bit masks (SSE2 compares
+ *   where available, a scalar loop otherwise)
+ * - Stage 2 walks only the quote/escape/comment/newline bits of each block
+ *   to mark string literals and comments
+ * - Stage 3 removes literal bytes from the identifier and bracket masks
+ * Queries then jump between set bits with count-trailing-zeros.
+ */
+
+#include "chunker.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARCHICORE_STRUCTURE_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace archicore {
+namespace chunker {
+
+namespace {
+
+inline int leading_zeros(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(mask);
+#endif
+}
+
+// Bits [from, 64)
+inline uint64_t mask_from(size_t bit) {
+    return bit >= 64 ? 0 : ~0ULL << bit;
+}
+
+/**
+ * @brief Character-class masks of one 64-byte block
+ */
+struct RawMasks {
+    uint64_t dquote, squote, backtick, backslash;
+    uint64_t slash, star, hash, newline, dollar;
+    uint64_t lbrace, rbrace, lparen, rparen, lsquare, rsquare;
+    uint64_t ident_first;  // [A-Za-z_$]
+    uint64_t ident;        // [A-Za-z0-9_$]
+};
+
+#ifdef ARCHICORE_STRUCTURE_SSE2
+
+inline uint64_t eq_mask(const __m128i v[4], char c) {
+    __m128i needle = _mm_set1_epi8(c);
+    uint64_t m0 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[0], needle)));
+    uint64_t m1 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[1], needle)));
+    uint64_t m2 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[2], needle)));
+    uint64_t m3 = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v[3], needle)));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+
+// Bytes in [lo, hi]; signed compares are fine since both bounds are ASCII
+inline uint64_t range_mask(const __m128i v[4], char lo, char hi) {
+    __m128i below = _mm_set1_epi8(static_cast<char>(lo - 1));
+    __m128i above = _mm_set1_epi8(static_cast<char>(hi + 1));
+    uint64_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i in = _mm_and_si128(_mm_cmpgt_epi8(v[i], below), _mm_cmplt_epi8(v[i], above));
+        result |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(in))) << (i * 16);
+    }
+    return result;
+}
+
+void classify(const char* block, RawMasks& m) {
+    __m128i v[4];
+    __m128i lower[4];
+    for (int i = 0; i < 4; i++) {
+        v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        lower[i] = _mm_or_si128(v[i], _mm_set1_epi8(0x20));
+    }
+
+    m.dquote = eq_mask(v, '"');
+    m.squote = eq_mask(v, '\'');
+    m.backtick = eq_mask(v, '`');
+    m.backslash = eq_mask(v, '\\');
+    m.slash = eq_mask(v, '/');
+    m.star = eq_mask(v, '*');
+    m.hash = eq_mask(v, '#');
+    m.newline = eq_mask(v, '\n');
+    m.dollar = eq_mask(v, '$');
+    m.lbrace = eq_mask(v, '{');
+    m.rbrace = eq_mask(v, '}');
+    m.lparen = eq_mask(v, '(');
+    m.rparen = eq_mask(v, ')');
+    m.lsquare = eq_mask(v, '[');
+    m.rsquare = eq_mask(v, ']');
+
+    uint64_t letter = range_mask(lower, 'a', 'z');
+    m.ident_first = letter | eq_mask(v, '_') | m.dollar;
+    m.ident = m.ident_first | range_mask(v, '0', '9');
+}
+
+#else
+
+void classify(const char* block, RawMasks& m) {
+    m = RawMasks{};
+    for (int i = 0; i < 64; i++) {
+        unsigned char c = static_cast<unsigned char>(block[i]);
+        uint64_t bit = 1ULL << i;
+        switch (c) {
+            case '"': m.dquote |= bit; break;
+            case '\'': m.squote |= bit; break;
+            case '`': m.backtick |= bit; break;
+            case '\\': m.backslash |= bit; break;
+            case '/': m.slash |= bit; break;
+            case '*': m.star |= bit; break;
+            case '#': m.hash |= bit; break;
+            case '\n': m.newline |= bit; break;
+            case '$': m.dollar |= bit; break;
+            case '{': m.lbrace |= bit; break;
+            case '}': m.rbrace |= bit; break;
+            case '(': m.lparen |= bit; break;
+            case ')': m.rparen |= bit; break;
+            case '[': m.lsquare |= bit; break;
+            case ']': m.rsquare |= bit; break;
+            default: break;
+        }
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (letter || c == '_' || c == '$') m.ident_first |= bit;
+        if (letter || c == '_' || c == '$' || (c >= '0' && c <= '9')) m.ident |= bit;
+    }
+}
+
+#endif
+
+} // namespace
+
+StructuralIndex::StructuralIndex(const std::string& source, Language language)
+    : data_(source.data())
+    , size_(source.size())
+{
+    const LexicalSyntax syntax = lexical_syntax(language);
+    size_t block_count = (size_ + 63) / 64;
+    blocks_.resize(block_count);
+    lines_before_.resize(block_count + 1);
+    line_starts_.resize(block_count + 1);
+
+    std::vector<RawMasks> raw(block_count);
+
+    // Sets literal bits for [from, to)
+    auto mark = [&](size_t from, size_t to) {
+        while (from < to) {
+            size_t block = from >> 6;
+            size_t end = std::min(to, (block + 1) << 6);
+            uint64_t bits = mask_from(from & 63);
+            if ((end & 63) != 0) bits &= ~mask_from(end & 63);
+            blocks_[block].literal |= bits;
+            from = end;
+        }
+    };
+
+    enum class State { CODE, LINE_COMMENT, BLOCK_COMMENT, STRING, TRIPLE, TEMPLATE, RAW };
+    State state = State::CODE;
+    char quote = 0;
+    size_t literal_start = 0;
+    size_t skip_until = 0;
+    std::vector<uint32_t> template_braces;  // Open braces per ${...} being scanned
+
+    auto at = [&](size_t pos) -> char { return pos < size_ ? data_[pos] : '\0'; };
+
+    char tail[64];
+    uint32_t lines = 0;
+    size_t line_start = 0;
+
+    for (size_t b = 0; b < block_count; b++) {
+        size_t base = b << 6;
+        const char* block = data_ + base;
+        if (size_ - base < 64) {
+            std::fill(tail, tail + 64, '\0');
+            std::copy(block, data_ + size_, tail);
+            block = tail;
+        }
+
+        RawMasks& m = raw[b];
+        classify(block, m);
+        blocks_[b].newline = m.newline;
+        lines_before_[b] = lines;
+        line_starts_[b] = line_start;
+        lines += popcount(m.newline);
+        if (m.newline) line_start = base + static_cast<size_t>(63 - leading_zeros(m.newline)) + 1;
+
+        // Stage 2: visit only the characters that can change literal state
+        uint64_t special = m.newline | m.backslash;
+        if (syntax.double_quotes) special |= m.dquote;
+        if (syntax.single_quotes) special |= m.squote;
+        if (syntax.backtick_template || syntax.backtick_raw) special |= m.backtick;
+        if (syntax.slash_line || syntax.slash_block) special |= m.slash;
+        if (syntax.slash_block) special |= m.star;
+        if (syntax.hash_line) special |= m.hash;
+        if (syntax.backtick_template) special |= m.dollar | m.lbrace | m.rbrace;
+
+        while (special) {
+            size_t pos = base + static_cast<size_t>(trailing_zeros(special));
+            special &= special - 1;
+            if (pos < skip_until || pos >= size_) continue;
+
+            char c = data_[pos];
+            switch (state) {
+                case State::CODE:
+                    if (c == '/' && syntax.slash_line && at(pos + 1) == '/') {
+                        state = State::LINE_COMMENT;
+                    } else if (c == '/' && syntax.slash_block && at(pos + 1) == '*') {
+                        state = State::BLOCK_COMMENT;
+                        skip_until = pos + 2;
+                    } else if (c == '/' && syntax.regex_literals && detail::starts_regex(data_, pos)) {
+                        // Regex literals are short: scan them directly
+                        skip_until = detail::skip_regex(data_, size_, pos);
+                        mark(pos, skip_until);
+                        break;
+                    } else if (c == '#' && syntax.hash_line) {
+                        state = State::LINE_COMMENT;
+                    } else if ((c == '"' && syntax.double_quotes) || (c == '\'' && syntax.single_quotes)) {
+                        quote = c;
+                        if (syntax.triple_quotes && at(pos + 1) == c && at(pos + 2) == c) {
+                            state = State::TRIPLE;
+                            skip_until = pos + 3;
+                        } else {
+                            state = State::STRING;
+                        }
+                    } else if (c == '`' && syntax.backtick_template) {
+                        state = State::TEMPLATE;
+                    } else if (c == '`' && syntax.backtick_raw) {
+                        state = State::RAW;
+                    } else if (c == '{' && !template_braces.empty()) {
+                        template_braces.back()++;
+                        break;
+                    } else if (c == '}' && !template_braces.empty()) {
+                        if (template_braces.back() > 0) {
+                            template_braces.back()--;
+                            break;
+                        }
+                        // End of ${...}: back inside the template
+                        template_braces.pop_back();
+                        state = State::TEMPLATE;
+                        literal_start = pos;
+                        break;
+                    } else {
+                        break;
+                    }
+                    literal_start = pos;
+                    if (state == State::LINE_COMMENT || state == State::BLOCK_COMMENT) {
+                        blocks_[b].comment_start |= 1ULL << (pos & 63);
+                    }
+                    break;
+
+                case State::LINE_COMMENT:
+                    if (c == '\n') {
+                        mark(literal_start, pos);
+                        state = State::CODE;
+                    }
+                    break;
+
+                case State::BLOCK_COMMENT:
+                    if (c == '*' && at(pos + 1) == '/') {
+                        mark(literal_start, pos + 2);
+                        state = State::CODE;
+                        skip_until = pos + 2;
+                    }
+                    break;
+
+                case State::STRING:
+                    if (c == '\\') {
+                        skip_until = pos + 2;
+                    } else if (c == quote) {
+                        mark(literal_start, pos + 1);
+                        state = State::CODE;
+                    } else if (c == '\n') {
+                        // Unterminated literal: do not let it swallow the file
+                        mark(literal_start, pos);
+                        state = State::CODE;
+                    }
+                    break;
+
+                case State::TRIPLE:
+                    if (c == '\\') {
+                        skip_until = pos + 2;
+                    } else if (c == quote && at(pos + 1) == quote && at(pos + 2) == quote) {
+                        mark(literal_start, pos + 3);
+                        state = State::CODE;
+                        skip_until = pos + 3;
+                    }
+                    break;
+
+                case State::TEMPLATE:
+                    if (c == '\\') {
+                        skip_until = pos + 2;
+                    } else if (c == '`') {
+                        mark(literal_start, pos + 1);
+                        state = State::CODE;
+                    } else if (c == '$' && at(pos + 1) == '{') {
+                        mark(literal_start, pos + 2);
+                        template_braces.push_back(0);
+                        state = State::CODE;
+                        skip_until = pos + 2;
+                    }
+                    break;
+
+                case State::RAW:
+                    if (c == '`') {
+                        mark(literal_start, pos + 1);
+                        state = State::CODE;
+                    }
+                    break;
+            }
+        }
+    }
+    lines_before_[block_count] = lines;
+    line_starts_[block_count] = line_start;
+
+    if (state != State::CODE) {
+        mark(literal_start, size_);
+    }
+
+    // Stage 3: structural positions outside literals
+    uint64_t prev_ident = 0;
+    for (size_t b = 0; b < block_count; b++) {
+        const RawMasks& m = raw[b];
+        Block& block = blocks_[b];
+        uint64_t code = ~block.literal;
+        if (b == block_count - 1 && (size_ & 63) != 0) {
+            code &= ~mask_from(size_ & 63);
+        }
+
+        // '#' starts a directive (#include) where it is not a comment
+        uint64_t first = m.ident_first | (syntax.hash_line ? 0 : m.hash);
+        uint64_t follows_ident = (m.ident << 1) | prev_ident;
+        block.ident_start = first & ~follows_ident & code;
+        prev_ident = m.ident >> 63;
+
+        block.brace = (m.lbrace | m.rbrace) & code;
+        block.paren = (m.lparen | m.rparen) & code;
+        block.square = (m.lsquare | m.rsquare) & code;
+    }
+}
+
+uint64_t StructuralIndex::kind_mask(const Block& block, uint32_t kinds) const {
+    uint64_t mask = 0;
+    if (kinds & IDENT_START) mask |= block.ident_start;
+    if (kinds & BRACE) mask |= block.brace;
+    if (kinds & PAREN) mask |= block.paren;
+    if (kinds & SQUARE) mask |= block.square;
+    if (kinds & COMMENT_START) mask |= block.comment_start;
+    return mask;
+}
+
+size_t StructuralIndex::next(size_t pos, uint32_t kinds) const {
+    if (pos >= size_) return size_;
+
+    size_t b = pos >> 6;
+    uint64_t mask = kind_mask(blocks_[b], kinds) & mask_from(pos & 63);
+    while (!mask) {
+        if (++b >= blocks_.size()) return size_;
+        mask = kind_mask(blocks_[b], kinds);
+    }
+    return (b << 6) + static_cast<size_t>(trailing_zeros(mask));
+}
+
+size_t StructuralIndex::literal_end(size_t pos) const {
+    if (pos >= size_) return size_;
+
+    size_t b = pos >> 6;
+    uint64_t code = ~blocks_[b].literal & mask_from(pos & 63);
+    while (!code) {
+        if (++b >= blocks_.size()) return size_;
+        code = ~blocks_[b].literal;
+    }
+    return std::min(size_, (b << 6) + static_cast<size_t>(trailing_zeros(code)));
+}
+
+size_t StructuralIndex::find_matching(size_t pos) const {
+    if (pos >= size_ || in_literal(pos)) return pos;
+
+    char open = data_[pos];
+    char close;
+    uint32_t kind;
+    switch (open) {
+        case '{': close = '}'; kind = BRACE; break;
+        case '(': close = ')'; kind = PAREN; break;
+        case '[': close = ']'; kind = SQUARE; break;
+        default: return pos;
+    }
+
+    int depth = 1;
+    pos = next(pos + 1, kind);
+    while (pos < size_) {
+        if (data_[pos] == open) {
+            depth++;
+        } else if (data_[pos] == close && --depth == 0) {
+            return pos + 1;
+        }
+        pos = next(pos + 1, kind);
+    }
+    return size_;
+}
+
+std::pair<uint32_t, uint32_t> StructuralIndex::line_col(size_t pos) const {
+    pos = std::min(pos, size_);
+    size_t b = pos >> 6;
+    uint64_t newlines = (b < blocks_.size()) ? blocks_[b].newline & ~mask_from(pos & 63) : 0;
+    uint32_t line = 1 + lines_before_[b] + popcount(newlines);
+
+    // Column: distance from the last newline before pos, in this block or before it
+    size_t line_start = newlines ? (b << 6) + static_cast<size_t>(63 - leading_zeros(newlines)) + 1
+                                 : line_starts_[b];
+    return {line, static_cast<uint32_t>(pos - line_start + 1)};
+}
+
+uint32_t StructuralIndex::line(size_t pos) const {
+    pos = std::min(pos, size_);
+    size_t b = pos >> 6;
+    uint64_t newlines = (b < blocks_.size()) ? blocks_[b].newline & ~mask_from(pos & 63) : 0;
+    return 1 + lines_before_[b] + popcount(newlines);
+}
+
+} // namespace chunker
+} // namespace archicore
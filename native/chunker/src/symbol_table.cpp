@@ -0,0 +1,141 @@
+/**
+ * @file symbol_table.cpp
+ * @brief Parallel columnar symbol extraction for batches of files
+ * @version 1.0.0
+ *
+ * Produces the symbols of a whole project without building ASTs:
+ * - Files are memory-mapped and classified; noise files are skipped
+ * - Boundary detection and symbol extents run on a worker pool
+ * - Results are packed into flat columns in input order
+ */
+
+// Prevent Windows min/max macros from conflicting with std::min/std::max
+#ifdef _WIN32
+#define NOMINMAX
+#endif
+
+#include "chunker.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace archicore {
+namespace chunker {
+
+namespace {
+
+struct FileSymbols {
+    std::vector<SymbolInfo> symbols;
+    Language language = Language::UNKNOWN;
+    uint8_t flags = 0;
+    std::string error;
+};
+
+void extract_file(const std::string& path, BoundaryDetector& detector, uint64_t max_file_size,
+                  FileSymbols& out) {
+    MappedFile file;
+    if (!file.open(path)) {
+        out.error = "Cannot open file";
+        return;
+    }
+    if (file.size() > max_file_size) {
+        out.error = "File too large";
+        return;
+    }
+
+    std::string source(file.data(), file.size());
+    file.close();
+
+    out.language = detect_language(path, source);
+    out.flags = classify_content(path, source);
+    if (out.flags & (FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY | FILE_FLAG_MINIFIED | FILE_FLAG_GENERATED)) {
+        return;
+    }
+
+    std::vector<SemanticBoundary> boundaries = detector.detect(source, out.language);
+    out.symbols = extract_symbols(source, boundaries, out.language);
+}
+
+} // namespace
+
+SymbolTable build_symbol_table(const std::vector<std::string>& paths, const SymbolTableConfig& config) {
+    std::vector<FileSymbols> results(paths.size());
+
+    uint32_t num_workers = std::min(config.num_workers, std::thread::hardware_concurrency());
+    num_workers = std::max(num_workers, 1u);
+    num_workers = static_cast<uint32_t>(std::min<size_t>(num_workers, paths.size()));
+
+    auto worker = [&](std::atomic<size_t>& next) {
+        BoundaryDetector detector;
+        detector.set_budget(config.boundary_time_budget_ms, config.boundary_step_budget);
+        size_t idx;
+        while ((idx = next.fetch_add(1)) < paths.size()) {
+            extract_file(paths[idx], detector, config.max_file_size, results[idx]);
+        }
+    };
+
+    std::atomic<size_t> next_index{0};
+    if (num_workers <= 1) {
+        worker(next_index);
+    } else {
+        std::vector<std::future<void>> futures;
+        for (uint32_t w = 0; w < num_workers; w++) {
+            futures.push_back(std::async(std::launch::async, worker, std::ref(next_index)));
+        }
+        for (auto& f : futures) f.wait();
+    }
+
+    SymbolTable table;
+    size_t rows = 0;
+    size_t name_bytes = 0;
+    for (const auto& result : results) {
+        rows += result.symbols.size();
+        for (const auto& symbol : result.symbols) name_bytes += symbol.name.size();
+    }
+
+    table.file.reserve(rows);
+    table.kind.reserve(rows);
+    table.flags.reserve(rows);
+    table.parent.reserve(rows);
+    table.line_start.reserve(rows);
+    table.line_end.reserve(rows);
+    table.byte_offset.reserve(rows);
+    table.byte_length.reserve(rows);
+    table.name_offsets.reserve(rows + 1);
+    table.names.reserve(name_bytes);
+    table.file_offsets.reserve(paths.size() + 1);
+    table.file_language.reserve(paths.size());
+    table.file_flags.reserve(paths.size());
+
+    for (size_t f = 0; f < results.size(); f++) {
+        const FileSymbols& result = results[f];
+        uint32_t base = static_cast<uint32_t>(table.kind.size());
+        table.file_offsets.push_back(base);
+        table.file_language.push_back(static_cast<uint8_t>(result.language));
+        table.file_flags.push_back(result.flags);
+        if (!result.error.empty()) {
+            table.errors.emplace_back(static_cast<uint32_t>(f), result.error);
+        }
+
+        for (const auto& symbol : result.symbols) {
+            table.file.push_back(static_cast<uint32_t>(f));
+            table.kind.push_back(static_cast<uint8_t>(symbol.type));
+            table.flags.push_back(symbol.flags);
+            table.parent.push_back(symbol.parent < 0 ? -1 : static_cast<int32_t>(base) + symbol.parent);
+            table.line_start.push_back(symbol.line_start);
+            table.line_end.push_back(symbol.line_end);
+            table.byte_offset.push_back(symbol.byte_offset);
+            table.byte_length.push_back(symbol.byte_length);
+            table.name_offsets.push_back(static_cast<uint32_t>(table.names.size()));
+            table.names += symbol.name;
+        }
+    }
+    table.file_offsets.push_back(static_cast<uint32_t>(table.kind.size()));
+    table.name_offsets.push_back(static_cast<uint32_t>(table.names.size()));
+
+    return table;
+}
+
+} // namespace chunker
+} // namespace archicore
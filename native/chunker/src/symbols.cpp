@@ -0,0 +1,489 @@
+/**
+ * @file symbols.cpp
+ * @brief Per-symbol semantic hashes and symbol deltas
+ * @version 1.0.0
+ *
+ * Narrows a modified file down to the functions, classes and methods that
+ * actually changed:
+ * - hash_symbols gives each symbol a whitespace/comment-insensitive hash
+ * - diff_symbols compares two versions into added, removed, changed, moved
+ * - extract_symbols lists symbols with nesting and visibility, unhashed
+ */
+
+#include "chunker.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace archicore {
+namespace chunker {
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+namespace {
+
+/**
+ * @brief FNV-1a sink for TokenNormalizer
+ */
+struct FnvSink {
+    uint64_t hash = FNV_OFFSET;
+
+    void put(char c) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+    }
+};
+
+bool is_symbol_type(ChunkType type) {
+    switch (type) {
+        case ChunkType::FUNCTION:
+        case ChunkType::CLASS:
+        case ChunkType::STRUCT:
+        case ChunkType::INTERFACE:
+        case ChunkType::ENUM:
+        case ChunkType::MODULE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+size_t skip_word(const std::string& source, size_t pos, const char* word) {
+    size_t len = std::strlen(word);
+    if (source.compare(pos, len, word) != 0) return pos;
+    size_t end = pos + len;
+    if (end < source.size() && detail::is_ident_char(source[end])) return pos;
+    while (end < source.size() && is_blank(source[end])) end++;
+    return end;
+}
+
+/**
+ * @brief Resolve a JavaScript/TypeScript export boundary to its declaration
+ *
+ * The detector reports "export class X" and "export function f" as EXPORT
+ * boundaries. Exported classes, functions and function-valued bindings
+ * become symbols; other exports do not.
+ */
+bool export_declaration(const std::string& source, size_t pos, ChunkType& type, std::string& name) {
+    pos = skip_word(source, pos, "export");
+    pos = skip_word(source, pos, "default");
+    pos = skip_word(source, pos, "async");
+
+    size_t after;
+    bool binding = false;
+    if ((after = skip_word(source, pos, "class")) != pos) {
+        type = ChunkType::CLASS;
+    } else if ((after = skip_word(source, pos, "function")) != pos) {
+        type = ChunkType::FUNCTION;
+        if (after < source.size() && source[after] == '*') after++;
+    } else if ((after = skip_word(source, pos, "const")) != pos ||
+               (after = skip_word(source, pos, "let")) != pos ||
+               (after = skip_word(source, pos, "var")) != pos) {
+        type = ChunkType::FUNCTION;
+        binding = true;
+    } else {
+        return false;
+    }
+
+    while (after < source.size() && is_blank(source[after])) after++;
+    size_t end = after;
+    while (end < source.size() && detail::is_ident_char(source[end])) end++;
+    name = source.substr(after, end - after);
+
+    if (binding) {
+        // Only "= function", "= (...) =>" and "= x =>" bind a function
+        size_t stop = source.find_first_of(";\n", end);
+        std::string_view rest(source.data() + end, (stop == std::string::npos ? source.size() : stop) - end);
+        return rest.find("=>") != std::string_view::npos ||
+               rest.find("function") != std::string_view::npos;
+    }
+    return true;
+}
+
+// Move end back over trailing whitespace, not past start
+size_t trim_end(const std::string& source, size_t start, size_t end) {
+    while (end > start && is_blank(source[end - 1])) end--;
+    return end;
+}
+
+/**
+ * @brief Extent of a declaration in a brace language
+ *
+ * Parameter lists and brackets in the header are skipped whole. The body is
+ * the first '{' after that, unless a ';' ends the declaration first, the
+ * enclosing scope closes, or the next symbol starts.
+ */
+size_t brace_extent(const std::string& source, const StructuralIndex& index, size_t start, size_t limit) {
+    size_t pos = start;
+    while (pos < limit) {
+        size_t bracket = index.next(pos, StructuralIndex::BRACE | StructuralIndex::PAREN |
+                                         StructuralIndex::SQUARE);
+        size_t stop = std::min(bracket, limit);
+
+        for (size_t i = pos; i < stop; i++) {
+            if (source[i] == ';' && !index.in_literal(i)) return i + 1;
+        }
+        if (bracket >= limit) break;
+
+        char c = source[bracket];
+        if (c == '{') return index.find_matching(bracket);
+        if (c == '(' || c == '[') {
+            pos = index.find_matching(bracket);
+            continue;
+        }
+        // A closing bracket: the enclosing scope ends before any body
+        return trim_end(source, start, bracket);
+    }
+    return trim_end(source, start, limit);
+}
+
+size_t line_indent(const std::string& source, size_t line_begin, size_t& first) {
+    size_t width = 0;
+    first = line_begin;
+    while (first < source.size() && (source[first] == ' ' || source[first] == '\t')) {
+        width += source[first] == '\t' ? 8 - (width % 8) : 1;
+        first++;
+    }
+    return width;
+}
+
+/**
+ * @brief Extent of a Python def or class: its header and the indented block
+ */
+size_t indent_extent(const std::string& source, const StructuralIndex& index, size_t start) {
+    size_t line_begin = source.rfind('\n', start);
+    line_begin = line_begin == std::string::npos ? 0 : line_begin + 1;
+    size_t first;
+    size_t base = line_indent(source, line_begin, first);
+
+    // The header ends at the first ':' outside brackets and literals
+    size_t pos = start;
+    while (pos < source.size()) {
+        char c = source[pos];
+        if (index.in_literal(pos)) {
+            pos = index.literal_end(pos);
+            continue;
+        }
+        if (c == '(' || c == '[' || c == '{') {
+            pos = index.find_matching(pos);
+            continue;
+        }
+        if (c == ':') break;
+        pos++;
+    }
+
+    // The block ends before the next code line indented no deeper than the header
+    size_t line = source.find('\n', pos);
+    size_t end = line == std::string::npos ? source.size() : line;
+    while (line != std::string::npos) {
+        size_t next_begin = line + 1;
+        size_t code = next_begin;
+        size_t width = line_indent(source, next_begin, code);
+        bool blank = code >= source.size() || source[code] == '\n' || source[code] == '\r' ||
+                     source[code] == '#';
+        if (!blank && !index.in_literal(code) && width <= base) break;
+        end = source.find('\n', next_begin);
+        if (end == std::string::npos) end = source.size();
+        line = end < source.size() ? end : std::string::npos;
+    }
+    return trim_end(source, start, end);
+}
+
+/**
+ * @brief Declarations among the boundaries, in file order, one per offset
+ * @param exported Receives per symbol whether it came from an EXPORT boundary
+ */
+std::vector<SymbolHash> collect_symbols(const std::string& source,
+                                        const std::vector<SemanticBoundary>& boundaries,
+                                        Language language, std::vector<bool>& exported) {
+    bool exports = language == Language::JAVASCRIPT || language == Language::TYPESCRIPT;
+
+    std::vector<std::pair<SymbolHash, bool>> found;
+    for (const auto& boundary : boundaries) {
+        if (!boundary.is_start || boundary.byte_offset >= source.size()) continue;
+
+        SymbolHash symbol;
+        symbol.byte_offset = boundary.byte_offset;
+        bool from_export = false;
+        if (is_symbol_type(boundary.type)) {
+            symbol.name = boundary.name;
+            symbol.type = boundary.type;
+        } else if (exports && boundary.type == ChunkType::EXPORT &&
+                   export_declaration(source, boundary.byte_offset, symbol.type, symbol.name)) {
+            from_export = true;
+        } else {
+            continue;
+        }
+        found.emplace_back(std::move(symbol), from_export);
+    }
+
+    std::stable_sort(found.begin(), found.end(), [](const auto& a, const auto& b) {
+        return a.first.byte_offset < b.first.byte_offset;
+    });
+
+    // Detectors may report a declaration twice; the first report wins
+    std::vector<SymbolHash> symbols;
+    symbols.reserve(found.size());
+    exported.clear();
+    for (auto& entry : found) {
+        if (!symbols.empty() && symbols.back().byte_offset == entry.first.byte_offset) continue;
+        symbols.push_back(std::move(entry.first));
+        exported.push_back(entry.second);
+    }
+    return symbols;
+}
+
+/**
+ * @brief Extents, nesting, qualified names and line ranges of collected symbols
+ * @param ends Receives the end offset of each symbol
+ * @param parent Receives the enclosing symbol of each symbol (-1 at top level)
+ * @param children Receives the directly nested symbols of each symbol
+ */
+void locate_symbols(const std::string& source, const StructuralIndex& index, Language language,
+                    std::vector<SymbolHash>& symbols, std::vector<size_t>& ends,
+                    std::vector<int64_t>& parent, std::vector<std::vector<size_t>>& children) {
+    bool indentation = language == Language::PYTHON;
+
+    ends.assign(symbols.size(), 0);
+    for (size_t i = 0; i < symbols.size(); i++) {
+        size_t start = symbols[i].byte_offset;
+        size_t end;
+        if (indentation) {
+            end = indent_extent(source, index, start);
+        } else {
+            size_t limit = i + 1 < symbols.size() ? symbols[i + 1].byte_offset : source.size();
+            end = brace_extent(source, index, start, limit);
+        }
+        ends[i] = std::max(end, start + 1);
+    }
+
+    // Nesting follows from containment; children are visited in file order
+    parent.assign(symbols.size(), -1);
+    children.assign(symbols.size(), {});
+    std::vector<size_t> stack;
+    std::unordered_map<std::string, uint32_t> seen;
+
+    for (size_t i = 0; i < symbols.size(); i++) {
+        size_t start = symbols[i].byte_offset;
+        while (!stack.empty() && ends[stack.back()] <= start) stack.pop_back();
+
+        // An overlapping extent (a body that ran past its parent's) is clipped
+        if (!stack.empty()) {
+            parent[i] = static_cast<int64_t>(stack.back());
+            children[stack.back()].push_back(i);
+            ends[i] = std::min(ends[i], ends[stack.back()]);
+        }
+        stack.push_back(i);
+
+        std::string leaf = symbols[i].name.empty() ? "<anonymous>" : symbols[i].name;
+        std::string qualified = parent[i] < 0 ? leaf : symbols[parent[i]].qualified_name + "." + leaf;
+        uint32_t repeat = seen[qualified]++;
+        if (repeat > 0) qualified += "#" + std::to_string(repeat + 1);
+        symbols[i].qualified_name = std::move(qualified);
+    }
+
+    for (size_t i = 0; i < symbols.size(); i++) {
+        symbols[i].byte_length = static_cast<uint64_t>(ends[i] - symbols[i].byte_offset);
+        symbols[i].line_start = index.line_col(symbols[i].byte_offset).first;
+        symbols[i].line_end = index.line_col(ends[i] - 1).first;
+    }
+}
+
+bool has_word(std::string_view text, std::string_view word) {
+    size_t pos = 0;
+    while ((pos = text.find(word, pos)) != std::string_view::npos) {
+        bool before = pos == 0 || !detail::is_ident_char(text[pos - 1]);
+        size_t end = pos + word.size();
+        bool after = end == text.size() || !detail::is_ident_char(text[end]);
+        // Rust "pub(crate)" and "pub(super)" are not visible outside the crate
+        if (before && after && !(word == "pub" && end < text.size() && text[end] == '(')) return true;
+        pos = end;
+    }
+    return false;
+}
+
+/**
+ * @brief Whether a symbol is visible outside its file or package
+ *
+ * Decided from the declaration header (the line up to the symbol's name)
+ * with each language's visibility convention.
+ */
+bool is_exported(const std::string& source, const SymbolHash& symbol, bool from_export,
+                 bool top_level, bool in_namespace, Language language) {
+    size_t line_begin = symbol.byte_offset == 0 ? std::string::npos : source.rfind('\n', symbol.byte_offset - 1);
+    line_begin = line_begin == std::string::npos ? 0 : line_begin + 1;
+    size_t line_end = source.find('\n', symbol.byte_offset);
+    if (line_end == std::string::npos) line_end = source.size();
+    std::string_view line(source.data() + line_begin, line_end - line_begin);
+    size_t name_pos = symbol.name.empty() ? std::string_view::npos
+                                          : line.find(symbol.name, symbol.byte_offset - line_begin);
+    std::string_view header = line.substr(0, name_pos);
+
+    switch (language) {
+        case Language::JAVASCRIPT:
+        case Language::TYPESCRIPT:
+            return from_export || (top_level && has_word(header, "export"));
+        case Language::RUST:
+            return has_word(header, "pub");
+        case Language::GO:
+            return !symbol.name.empty() && symbol.name[0] >= 'A' && symbol.name[0] <= 'Z';
+        case Language::JAVA:
+        case Language::CSHARP:
+        case Language::KOTLIN:
+        case Language::SWIFT:
+        case Language::PHP:
+            return has_word(header, "public");
+        case Language::PYTHON:
+            return top_level && !symbol.name.empty() && symbol.name[0] != '_';
+        case Language::C:
+        case Language::CPP:
+            return (top_level || in_namespace) && !has_word(header, "static");
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+std::vector<SymbolHash> hash_symbols(const std::string& source,
+                                     const std::vector<SemanticBoundary>& boundaries,
+                                     Language language) {
+    std::vector<bool> exported;
+    std::vector<SymbolHash> symbols = collect_symbols(source, boundaries, language, exported);
+    if (symbols.empty()) return symbols;
+
+    StructuralIndex index(source, language);
+    std::vector<size_t> ends;
+    std::vector<int64_t> parent;
+    std::vector<std::vector<size_t>> children;
+    locate_symbols(source, index, language, symbols, ends, parent, children);
+
+    std::string text;
+    for (size_t i = 0; i < symbols.size(); i++) {
+        SymbolHash& symbol = symbols[i];
+        size_t start = symbol.byte_offset;
+        size_t end = ends[i];
+
+        // Nested symbols stand in by name: their own hashes cover their bodies
+        text.clear();
+        size_t pos = start;
+        for (size_t child : children[i]) {
+            text.append(source, pos, symbols[child].byte_offset - pos);
+            text += '\x03';
+            text += symbols[child].name;
+            text += '\x03';
+            pos = ends[child];
+        }
+        text.append(source, pos, end - pos);
+
+        FnvSink sink;
+        sink.put(static_cast<char>(symbol.type));
+        TokenNormalizer<FnvSink> normalizer(language, sink);
+        normalizer.run(text);
+        symbol.hash = sink.hash;
+    }
+
+    return symbols;
+}
+
+std::vector<SymbolInfo> extract_symbols(const std::string& source,
+                                        const std::vector<SemanticBoundary>& boundaries,
+                                        Language language) {
+    std::vector<SymbolInfo> out;
+    std::vector<bool> exported;
+    std::vector<SymbolHash> symbols = collect_symbols(source, boundaries, language, exported);
+    if (symbols.empty()) return out;
+
+    StructuralIndex index(source, language);
+    std::vector<size_t> ends;
+    std::vector<int64_t> parent;
+    std::vector<std::vector<size_t>> children;
+    locate_symbols(source, index, language, symbols, ends, parent, children);
+
+    out.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); i++) {
+        SymbolHash& symbol = symbols[i];
+        bool top_level = parent[i] < 0;
+        bool in_namespace = !top_level && symbols[parent[i]].type == ChunkType::MODULE;
+
+        SymbolInfo info;
+        info.type = symbol.type;
+        info.line_start = symbol.line_start;
+        info.line_end = symbol.line_end;
+        // Whole in-memory sources, indexed with 32-bit offsets like the identifier index
+        info.byte_offset = static_cast<uint32_t>(symbol.byte_offset);
+        info.byte_length = static_cast<uint32_t>(symbol.byte_length);
+        info.parent = static_cast<int32_t>(parent[i]);
+        if (is_exported(source, symbol, exported[i], top_level, in_namespace, language)) {
+            info.flags |= SYMBOL_FLAG_EXPORTED;
+        }
+        info.name = std::move(symbol.name);
+        out.push_back(std::move(info));
+    }
+    return out;
+}
+
+SymbolDelta diff_symbols(const std::vector<SymbolHash>& before, const std::vector<SymbolHash>& after) {
+    SymbolDelta delta;
+
+    std::unordered_map<std::string, size_t> old_by_name;
+    old_by_name.reserve(before.size());
+    for (size_t i = 0; i < before.size(); i++) {
+        old_by_name.emplace(before[i].qualified_name, i);
+    }
+
+    std::vector<bool> old_matched(before.size(), false);
+    std::vector<size_t> unmatched;
+
+    for (size_t i = 0; i < after.size(); i++) {
+        const SymbolHash& symbol = after[i];
+        auto it = old_by_name.find(symbol.qualified_name);
+        if (it == old_by_name.end()) {
+            unmatched.push_back(i);
+            continue;
+        }
+
+        const SymbolHash& old_symbol = before[it->second];
+        old_matched[it->second] = true;
+        if (old_symbol.hash != symbol.hash) {
+            delta.changed.push_back({old_symbol, symbol});
+        } else if (old_symbol.line_start != symbol.line_start ||
+                   old_symbol.line_end != symbol.line_end) {
+            delta.moved.push_back({old_symbol, symbol});
+        } else {
+            delta.unchanged++;
+        }
+    }
+
+    // Leftovers with an equal body moved to another scope or were renamed
+    // along with their parent
+    std::unordered_multimap<uint64_t, size_t> old_by_hash;
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!old_matched[i]) old_by_hash.emplace(before[i].hash, i);
+    }
+
+    for (size_t i : unmatched) {
+        auto it = old_by_hash.find(after[i].hash);
+        if (it != old_by_hash.end()) {
+            old_matched[it->second] = true;
+            delta.moved.push_back({before[it->second], after[i]});
+            old_by_hash.erase(it);
+        } else {
+            delta.added.push_back(after[i]);
+        }
+    }
+
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!old_matched[i]) delta.removed.push_back(before[i]);
+    }
+
+    return delta;
+}
+
+} // namespace chunker
+} // namespace archicore
@@ -50,7 +50,7 @@ struct Tokenizer::Impl {
     static constexpr double CHARS_PER_TOKEN_TEXT = 4.0;
 
     // Token estimation with pattern awareness
-    uint32_t estimate_tokens(const std::string& text) {
+    uint32_t estimate_tokens(std::string_view text) {
         if (text.empty()) return 0;
 
         uint32_t token_count = 0;
@@ -258,7 +258,7 @@ struct Tokenizer::Impl {
     }
 
     // Find byte offset at token boundary
-    size_t find_boundary(const std::string& text, uint32_t target_tokens) {
+    size_t find_boundary(std::string_view text, uint32_t target_tokens) {
         if (text.empty() || target_tokens == 0) return 0;
 
         uint32_t token_count = 0;
@@ -361,6 +361,10 @@ uint32_t Tokenizer::count_tokens(const std::string& text) {
     return impl_->estimate_tokens(text);
 }
 
+uint32_t Tokenizer::count_tokens(const char* data, size_t length) {
+    return impl_->estimate_tokens(std::string_view(data, length));
+}
+
 std::vector<uint32_t> Tokenizer::encode(const std::string& text) {
     return impl_->encode_precise(text);
 }
@@ -369,5 +373,9 @@ size_t Tokenizer::find_token_boundary(const std::string& text, uint32_t target_t
     return impl_->find_boundary(text, target_tokens);
 }
 
+size_t Tokenizer::find_token_boundary(const char* data, size_t length, uint32_t target_tokens) {
+    return impl_->find_boundary(std::string_view(data, length), target_tokens);
+}
+
 } // namespace chunker
 } // namespace archicore
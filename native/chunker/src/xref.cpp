@@ -0,0 +1,698 @@
+/**
+ * @file xref.cpp
+ * @brief Identifier cross-reference index (definitions, imports, references)
+ * @version 1.0.0
+ *
+ * Identifiers are found with the StructuralIndex, so string literals and
+ * comments are skipped without re-tokenizing; template interpolations
+ * count as code. Roles are decided from the preceding token only:
+ * - DEFINITION: directly after a declaration keyword (whitespace between)
+ * - IMPORT: anywhere in an import / use / from-import statement
+ * - REFERENCE: everything else, including member names after '.'
+ *
+ * A reference directly followed by '(' is a call site; its caller is the
+ * innermost named function boundary (BoundaryDetector) around it.
+ */
+
+#include "chunker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+
+namespace archicore {
+namespace chunker {
+
+namespace {
+
+// Files indexed without occurrences
+constexpr uint8_t UNINDEXED_FILE_FLAGS =
+    FILE_FLAG_BINARY | FILE_FLAG_MINIFIED | FILE_FLAG_GENERATED | FILE_FLAG_HIGH_ENTROPY;
+
+bool is_word_byte(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
+
+bool is_word_start(char c) {
+    return is_word_byte(c) && !(c >= '0' && c <= '9');
+}
+
+// Keywords that introduce a declared name
+const std::unordered_set<std::string_view>& definition_keywords() {
+    static const std::unordered_set<std::string_view> words = {
+        "const", "let", "var", "function", "class", "interface", "type", "enum", "struct",
+        "trait", "union", "def", "fn", "func", "fun", "val", "module", "mod", "namespace", "record",
+    };
+    return words;
+}
+
+// Keywords of import statements; never indexed
+const std::unordered_set<std::string_view>& import_keywords() {
+    static const std::unordered_set<std::string_view> words = {"import", "use", "from"};
+    return words;
+}
+
+// Other keywords across the supported languages; never indexed
+const std::unordered_set<std::string_view>& plain_keywords() {
+    static const std::unordered_set<std::string_view> words = {
+        "if", "else", "elif", "for", "while", "do", "return", "switch", "case", "default", "break",
+        "continue", "new", "delete", "this", "self", "super", "true", "false", "null", "nullptr",
+        "undefined", "None", "True", "False", "try", "catch", "except", "finally", "throw", "throws",
+        "raise", "async", "await", "yield", "typeof", "instanceof", "in", "of", "is", "not", "and",
+        "or", "void", "static", "public", "private", "protected", "internal", "readonly", "abstract",
+        "final", "override", "virtual", "extends", "implements", "package", "pub", "mut", "ref",
+        "where", "match", "with", "as", "lambda", "pass", "global", "nonlocal", "go", "defer",
+        "chan", "select", "range", "goto", "sizeof", "extern", "inline", "export", "impl", "crate",
+        "using", "template", "typename", "require", "end", "then", "unless", "begin",
+    };
+    return words;
+}
+
+struct ScannedOccurrence {
+    std::string_view name;
+    uint32_t offset;
+    uint32_t line;
+    uint32_t column;
+    OccurrenceRole role;
+    bool call;
+};
+
+// Byte range of a function, from its name to the end of its body
+struct FunctionExtent {
+    std::string_view name;
+    uint32_t start;
+    uint32_t end;
+    uint32_t line;
+};
+
+/**
+ * @brief Body following the parameter list at `open`
+ *
+ * Methods declared without a keyword (`run() {`, `void run() {`) look like
+ * calls up to their closing parenthesis.
+ *
+ * @return Offset of the body's '{', or npos if `open` starts a call
+ */
+size_t body_after_parameters(const std::string& source, const StructuralIndex& index, size_t open) {
+    static constexpr size_t MAX_PARAMETER_BYTES = 4096;
+    size_t limit = std::min(source.size(), open + MAX_PARAMETER_BYTES);
+    int depth = 0;
+    size_t pos = open;
+    for (; pos < limit; pos++) {
+        if (index.in_literal(pos)) continue;
+        if (source[pos] == '(') {
+            depth++;
+        } else if (source[pos] == ')' && --depth == 0) {
+            break;
+        }
+    }
+    if (pos >= limit) return std::string::npos;
+
+    auto skip_space = [&](size_t p) {
+        while (p < source.size() && (source[p] == ' ' || source[p] == '\t' || source[p] == '\r' || source[p] == '\n')) p++;
+        return p;
+    };
+    pos = skip_space(pos + 1);
+
+    // Return type (`): T {`, `) -> T {`) or throws clause (`) throws E {`)
+    bool annotated = false;
+    if (pos < source.size() && source[pos] == ':' && (pos + 1 >= source.size() || source[pos + 1] != ':')) {
+        annotated = true;
+        pos++;
+    } else if (source.compare(pos, 2, "->") == 0) {
+        annotated = true;
+        pos += 2;
+    } else if (source.compare(pos, 6, "throws") == 0) {
+        annotated = true;
+        pos += 6;
+    }
+    if (annotated) {
+        static constexpr size_t MAX_TYPE_BYTES = 256;
+        size_t type_limit = std::min(source.size(), pos + MAX_TYPE_BYTES);
+        while (pos < type_limit && (is_word_byte(source[pos]) || std::strchr("<>[].,|&? \t\r\n", source[pos]))) pos++;
+    }
+    return pos < source.size() && source[pos] == '{' ? pos : std::string::npos;
+}
+
+/**
+ * @brief Offset just past the '}' matching the '{' at `open` (end of source if unbalanced)
+ */
+size_t matching_brace_end(const std::string& source, const StructuralIndex& index, size_t open) {
+    int depth = 0;
+    for (size_t pos = open; pos < source.size(); pos++) {
+        if (index.in_literal(pos)) continue;
+        if (source[pos] == '{') {
+            depth++;
+        } else if (source[pos] == '}' && --depth == 0) {
+            return pos + 1;
+        }
+    }
+    return source.size();
+}
+
+/**
+ * @brief Identifier occurrences of a source outside literals and comments
+ */
+std::vector<ScannedOccurrence> scan_identifiers(const std::string& source, Language language,
+                                                std::vector<FunctionExtent>& bodies) {
+    std::vector<ScannedOccurrence> found;
+    StructuralIndex index(source, language);
+    const auto& definitions = definition_keywords();
+    const auto& imports = import_keywords();
+    const auto& keywords = plain_keywords();
+
+    size_t pos = 0;
+    size_t gap_start = 0;           // End of the previous word
+    bool after_definition = false;  // Previous word declares the next name
+    bool in_import = false;
+    int import_depth = 0;           // Bracket depth inside the import statement
+    bool statement_start = true;    // No word since the last ';' or newline
+    uint32_t line = 1;              // Line and start of the line at gap_start
+    size_t line_start = 0;
+
+    while (true) {
+        pos = index.next(pos, StructuralIndex::IDENT_START);
+        if (pos >= source.size()) break;
+
+        // Directives (#include, #define) are skipped whole
+        bool directive = source[pos] == '#';
+        size_t start = directive ? pos + 1 : pos;
+        size_t end = start;
+        while (end < source.size() && is_word_byte(source[end])) end++;
+
+        // Gap since the previous word: statement ends and whitespace-only check
+        bool blank_gap = true;
+        bool member = false;
+        for (size_t i = gap_start; i < pos; i++) {
+            // Words hold no newlines, so the gaps see all of them
+            if (source[i] == '\n') {
+                line++;
+                line_start = i + 1;
+            }
+            if (index.in_literal(i)) {
+                blank_gap = false;
+                continue;
+            }
+            char c = source[i];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                if (c == '\n') {
+                    if (in_import && import_depth <= 0) in_import = false;
+                    statement_start = true;
+                }
+                continue;
+            }
+            blank_gap = false;
+            member = c == '.' && i + 1 == pos;
+            if (c == ';') {
+                in_import = false;
+                statement_start = true;
+            } else if (in_import && (c == '{' || c == '(')) {
+                import_depth++;
+            } else if (in_import && (c == '}' || c == ')')) {
+                import_depth--;
+            }
+        }
+        gap_start = end;
+        pos = end;
+        if (directive || start == end || !is_word_start(source[start])) {
+            after_definition = false;
+            statement_start = false;
+            continue;
+        }
+
+        std::string_view word(source.data() + start, end - start);
+        bool was_statement_start = statement_start;
+        statement_start = false;
+
+        if (!member) {
+            if (definitions.count(word)) {
+                after_definition = true;
+                continue;
+            }
+            // 'from' opens an import only at the start of a statement (Python)
+            if (imports.count(word)) {
+                if (!in_import && (word != "from" || was_statement_start)) {
+                    import_depth = 0;
+                    in_import = true;
+                }
+                after_definition = false;
+                continue;
+            }
+            if (keywords.count(word)) {
+                after_definition = false;
+                continue;
+            }
+        }
+
+        OccurrenceRole role = OccurrenceRole::REFERENCE;
+        if (in_import) {
+            role = OccurrenceRole::IMPORT;
+        } else if (after_definition && blank_gap && !member) {
+            role = OccurrenceRole::DEFINITION;
+        }
+        after_definition = false;
+
+        bool call = false;
+        if (role == OccurrenceRole::REFERENCE) {
+            size_t next = end;
+            while (next < source.size() && (source[next] == ' ' || source[next] == '\t')) next++;
+            call = next < source.size() && source[next] == '(' && !index.in_literal(next);
+            size_t body = call ? body_after_parameters(source, index, next) : std::string::npos;
+            if (body != std::string::npos) {
+                call = false;
+                bodies.push_back({word, static_cast<uint32_t>(start),
+                                  static_cast<uint32_t>(matching_brace_end(source, index, body)),
+                                  line});
+            }
+        }
+
+        uint32_t column = static_cast<uint32_t>(start - line_start + 1);
+        found.push_back({word, static_cast<uint32_t>(start), line, column, role, call});
+    }
+
+    return found;
+}
+
+/**
+ * @brief Innermost named function around each call site
+ * @param scanned Occurrences; calls on their function's own declaration line are cleared
+ * @param symbols Symbols from the boundary detector
+ * @param bodies Keyword-less method bodies found by the scan
+ * @return Function name per scanned occurrence (empty for non-calls and top-level calls)
+ */
+std::vector<std::string_view> attribute_calls(std::vector<ScannedOccurrence>& scanned,
+                                              const std::vector<SymbolInfo>& symbols,
+                                              std::vector<FunctionExtent> bodies) {
+    std::vector<std::string_view> callers(scanned.size());
+    std::vector<FunctionExtent>& functions = bodies;
+    for (const auto& symbol : symbols) {
+        if (symbol.type == ChunkType::FUNCTION && !symbol.name.empty()) {
+            functions.push_back({symbol.name, symbol.byte_offset, symbol.byte_offset + symbol.byte_length,
+                                 symbol.line_start});
+        }
+    }
+    if (functions.empty()) return callers;
+
+    // Extents nest: sweep in offset order with a stack, outer extents first
+    std::sort(functions.begin(), functions.end(), [](const FunctionExtent& a, const FunctionExtent& b) {
+        return a.start != b.start ? a.start < b.start : a.end > b.end;
+    });
+    std::vector<const FunctionExtent*> open;
+    size_t next = 0;
+    for (size_t i = 0; i < scanned.size(); i++) {
+        ScannedOccurrence& occurrence = scanned[i];
+        if (!occurrence.call) continue;
+        while (next < functions.size() && functions[next].start <= occurrence.offset) {
+            while (!open.empty() && open.back()->end <= functions[next].start) open.pop_back();
+            open.push_back(&functions[next++]);
+        }
+        while (!open.empty() && open.back()->end <= occurrence.offset) open.pop_back();
+        if (open.empty()) continue;
+
+        // A declaration the detector reported is not a call of itself
+        const FunctionExtent* caller = open.back();
+        if (caller->line == occurrence.line && caller->name == occurrence.name) {
+            occurrence.call = false;
+            continue;
+        }
+        callers[i] = caller->name;
+    }
+    return callers;
+}
+
+struct Posting {
+    uint32_t ident;
+    uint32_t offset;
+    uint32_t line;
+    uint32_t column;
+    uint32_t caller;        // Enclosing function ident of a call, UINT32_MAX if none
+    OccurrenceRole role;
+    bool call;
+};
+
+struct FileData {
+    std::string path;
+    uint64_t content_hash = 0;
+    bool live = false;
+    std::vector<Posting> postings;  // Sorted by (ident, offset)
+    std::vector<uint32_t> calls;    // Posting indices of call sites, sorted by (caller, offset)
+};
+
+bool sorted_insert(std::vector<uint32_t>& list, uint32_t value) {
+    auto it = std::lower_bound(list.begin(), list.end(), value);
+    if (it != list.end() && *it == value) return false;
+    list.insert(it, value);
+    return true;
+}
+
+void sorted_erase(std::vector<uint32_t>& list, uint32_t value) {
+    auto it = std::lower_bound(list.begin(), list.end(), value);
+    if (it != list.end() && *it == value) list.erase(it);
+}
+
+} // namespace
+
+struct IdentifierIndex::Impl {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> name_index;
+    std::vector<std::vector<uint32_t>> ident_files;     // Ident -> files containing it, ascending
+
+    std::vector<FileData> files;
+    std::unordered_map<std::string, uint32_t> file_index;
+    std::vector<uint32_t> free_files;
+
+    IdentifierIndexStats stats;
+    mutable std::mutex mutex;
+
+    uint32_t find_file(const std::string& path) const {
+        auto it = file_index.find(path);
+        return it == file_index.end() ? UINT32_MAX : it->second;
+    }
+
+    uint32_t find_name(const std::string& name) const {
+        auto it = name_index.find(name);
+        return it == name_index.end() ? UINT32_MAX : it->second;
+    }
+
+    uint32_t intern(std::string_view name) {
+        auto it = name_index.find(std::string(name));
+        if (it != name_index.end()) return it->second;
+        uint32_t ident = static_cast<uint32_t>(names.size());
+        names.emplace_back(name);
+        name_index.emplace(names.back(), ident);
+        ident_files.emplace_back();
+        return ident;
+    }
+
+    void drop_postings(uint32_t file) {
+        FileData& data = files[file];
+        uint32_t last = UINT32_MAX;
+        for (const auto& posting : data.postings) {
+            if (posting.ident == last) continue;
+            last = posting.ident;
+            sorted_erase(ident_files[posting.ident], file);
+        }
+        // Callers whose name does not occur in the file are listed too
+        last = UINT32_MAX;
+        for (uint32_t c : data.calls) {
+            uint32_t caller = data.postings[c].caller;
+            if (caller == last || caller == UINT32_MAX) continue;
+            last = caller;
+            sorted_erase(ident_files[caller], file);
+        }
+        stats.occurrence_count -= data.postings.size();
+        stats.call_count -= data.calls.size();
+        data.postings.clear();
+        data.calls.clear();
+    }
+
+    uint32_t allocate_file(const std::string& path) {
+        uint32_t file;
+        if (!free_files.empty()) {
+            file = free_files.back();
+            free_files.pop_back();
+        } else {
+            file = static_cast<uint32_t>(files.size());
+            files.emplace_back();
+        }
+        files[file].path = path;
+        files[file].live = true;
+        file_index.emplace(path, file);
+        return file;
+    }
+
+    void release_file(uint32_t file) {
+        drop_postings(file);
+        file_index.erase(files[file].path);
+        files[file] = FileData{};
+        free_files.push_back(file);
+    }
+
+    // Postings of one identifier in one file
+    std::pair<const Posting*, const Posting*> range(uint32_t file, uint32_t ident) const {
+        const auto& postings = files[file].postings;
+        auto less = [](const Posting& p, uint32_t id) { return p.ident < id; };
+        auto first = std::lower_bound(postings.begin(), postings.end(), ident, less);
+        auto last = first;
+        while (last != postings.end() && last->ident == ident) ++last;
+        return {postings.data() + (first - postings.begin()), postings.data() + (last - postings.begin())};
+    }
+
+    // Call sites inside functions named ident in one file
+    std::pair<const uint32_t*, const uint32_t*> calls_from(uint32_t file, uint32_t ident) const {
+        const auto& data = files[file];
+        auto less = [&](uint32_t p, uint32_t id) { return data.postings[p].caller < id; };
+        auto first = std::lower_bound(data.calls.begin(), data.calls.end(), ident, less);
+        auto last = first;
+        while (last != data.calls.end() && data.postings[*last].caller == ident) ++last;
+        return {data.calls.data() + (first - data.calls.begin()), data.calls.data() + (last - data.calls.begin())};
+    }
+
+    // Files to search for an identifier: one path or all that contain it
+    std::vector<uint32_t> candidates(uint32_t ident, const std::string& path) const {
+        if (path.empty()) return ident_files[ident];
+        uint32_t file = find_file(path);
+        if (file == UINT32_MAX) return {};
+        return std::binary_search(ident_files[ident].begin(), ident_files[ident].end(), file)
+            ? std::vector<uint32_t>{file} : std::vector<uint32_t>{};
+    }
+};
+
+IdentifierIndex::IdentifierIndex() : impl_(std::make_unique<Impl>()) {}
+IdentifierIndex::~IdentifierIndex() = default;
+
+bool IdentifierIndex::update_file(const std::string& path, const std::string& source, Language language,
+                                  uint64_t content_hash, const std::vector<SemanticBoundary>* boundaries,
+                                  BoundaryDetector* detector, uint8_t file_flags) {
+    if (has_file(path, content_hash)) {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->stats.skipped_updates++;
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (language == Language::UNKNOWN) language = detect_language(path, source);
+    if (!(file_flags & FILE_FLAG_CLASSIFIED)) file_flags = classify_content(path, source);
+
+    // Bundles, generated code and binary content are indexed empty: their
+    // names are noise, and one minified line can be as long as a project
+    std::vector<FunctionExtent> bodies;
+    std::vector<ScannedOccurrence> scanned;
+    if (!(file_flags & UNINDEXED_FILE_FLAGS)) scanned = scan_identifiers(source, language, bodies);
+
+    std::vector<SymbolInfo> symbols;
+    bool has_calls = std::any_of(scanned.begin(), scanned.end(), [](const ScannedOccurrence& o) { return o.call; });
+    if (has_calls) {
+        std::vector<SemanticBoundary> detected;
+        if (!boundaries) {
+            BoundaryDetector local;
+            detected = (detector ? *detector : local).detect(source, language);
+            boundaries = &detected;
+        }
+        symbols = extract_symbols(source, *boundaries, language);
+    }
+    std::vector<std::string_view> callers = attribute_calls(scanned, symbols, std::move(bodies));
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+
+    uint32_t file = d.find_file(path);
+    if (file == UINT32_MAX) {
+        file = d.allocate_file(path);
+    } else {
+        d.drop_postings(file);
+    }
+
+    // Names repeat within a file; intern each once
+    std::unordered_map<std::string_view, uint32_t> local;
+    auto intern_local = [&](std::string_view name) {
+        auto it = local.find(name);
+        return it != local.end() ? it->second : local.emplace(name, d.intern(name)).first->second;
+    };
+    std::vector<Posting>& postings = d.files[file].postings;
+    postings.reserve(scanned.size());
+    for (size_t i = 0; i < scanned.size(); i++) {
+        const ScannedOccurrence& occurrence = scanned[i];
+        uint32_t ident = intern_local(occurrence.name);
+        uint32_t caller = callers[i].empty() ? UINT32_MAX : intern_local(callers[i]);
+        postings.push_back({ident, occurrence.offset, occurrence.line, occurrence.column, caller,
+                            occurrence.role, occurrence.call});
+    }
+    // Offsets are already ascending, so a stable sort keeps them in order per name
+    std::stable_sort(postings.begin(), postings.end(),
+                     [](const Posting& a, const Posting& b) { return a.ident < b.ident; });
+    for (const auto& entry : local) sorted_insert(d.ident_files[entry.second], file);
+
+    std::vector<uint32_t>& calls = d.files[file].calls;
+    for (uint32_t p = 0; p < postings.size(); p++) {
+        if (postings[p].call) calls.push_back(p);
+    }
+    std::sort(calls.begin(), calls.end(), [&](uint32_t a, uint32_t b) {
+        if (postings[a].caller != postings[b].caller) return postings[a].caller < postings[b].caller;
+        return postings[a].offset < postings[b].offset;
+    });
+
+    d.files[file].content_hash = content_hash;
+    d.stats.occurrence_count += postings.size();
+    d.stats.call_count += calls.size();
+    d.stats.updates++;
+    d.stats.index_time_ms += std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
+
+bool IdentifierIndex::has_file(const std::string& path, uint64_t content_hash) const {
+    if (content_hash == 0) return false;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint32_t file = impl_->find_file(path);
+    return file != UINT32_MAX && impl_->files[file].content_hash == content_hash;
+}
+
+bool IdentifierIndex::remove_file(const std::string& path) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint32_t file = impl_->find_file(path);
+    if (file == UINT32_MAX) return false;
+    impl_->release_file(file);
+    return true;
+}
+
+bool IdentifierIndex::rename_file(const std::string& old_path, const std::string& new_path) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    uint32_t file = d.find_file(old_path);
+    if (file == UINT32_MAX) return false;
+    if (old_path == new_path) return true;
+
+    uint32_t existing = d.find_file(new_path);
+    if (existing != UINT32_MAX) d.release_file(existing);
+
+    d.file_index.erase(old_path);
+    d.file_index.emplace(new_path, file);
+    d.files[file].path = new_path;
+    return true;
+}
+
+std::vector<IdentifierOccurrence> IdentifierIndex::occurrences(const std::string& name, uint32_t roles,
+                                                               const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    std::vector<IdentifierOccurrence> result;
+
+    uint32_t ident = d.find_name(name);
+    if (ident == UINT32_MAX) return result;
+
+    for (uint32_t file : d.candidates(ident, path)) {
+        auto [first, last] = d.range(file, ident);
+        for (const Posting* p = first; p != last; ++p) {
+            if (static_cast<uint32_t>(p->role) & roles) {
+                result.push_back({file, p->offset, p->line, p->column, p->role});
+            }
+        }
+    }
+    return result;
+}
+
+uint32_t IdentifierIndex::count(const std::string& name, uint32_t roles, const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+
+    uint32_t ident = d.find_name(name);
+    if (ident == UINT32_MAX) return 0;
+
+    uint32_t total = 0;
+    for (uint32_t file : d.candidates(ident, path)) {
+        auto [first, last] = d.range(file, ident);
+        for (const Posting* p = first; p != last; ++p) {
+            if (static_cast<uint32_t>(p->role) & roles) total++;
+        }
+    }
+    return total;
+}
+
+std::vector<CallSite> IdentifierIndex::call_sites(const std::string& name, const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    std::vector<CallSite> result;
+
+    uint32_t ident = d.find_name(name);
+    if (ident == UINT32_MAX) return result;
+
+    for (uint32_t file : d.candidates(ident, path)) {
+        auto [first, last] = d.range(file, ident);
+        for (const Posting* p = first; p != last; ++p) {
+            if (!p->call) continue;
+            result.push_back({file, p->offset, p->line, p->column, name,
+                              p->caller == UINT32_MAX ? std::string() : d.names[p->caller]});
+        }
+    }
+    return result;
+}
+
+std::vector<CallSite> IdentifierIndex::callees(const std::string& name, const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    std::vector<CallSite> result;
+
+    uint32_t ident = d.find_name(name);
+    if (ident == UINT32_MAX) return result;
+
+    // A function's own name occurs in its file, so the name's files bound the search
+    for (uint32_t file : d.candidates(ident, path)) {
+        auto [first, last] = d.calls_from(file, ident);
+        for (const uint32_t* c = first; c != last; ++c) {
+            const Posting& p = d.files[file].postings[*c];
+            result.push_back({file, p.offset, p.line, p.column, d.names[p.ident], name});
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> IdentifierIndex::files(const std::string& name, uint32_t roles) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const Impl& d = *impl_;
+    std::vector<std::string> result;
+
+    uint32_t ident = d.find_name(name);
+    if (ident == UINT32_MAX) return result;
+
+    for (uint32_t file : d.ident_files[ident]) {
+        auto [first, last] = d.range(file, ident);
+        for (const Posting* p = first; p != last; ++p) {
+            if (static_cast<uint32_t>(p->role) & roles) {
+                result.push_back(d.files[file].path);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+std::string IdentifierIndex::file_path(uint32_t file) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return file < impl_->files.size() && impl_->files[file].live ? impl_->files[file].path : std::string();
+}
+
+void IdentifierIndex::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    d.names.clear();
+    d.name_index.clear();
+    d.ident_files.clear();
+    d.files.clear();
+    d.file_index.clear();
+    d.free_files.clear();
+    d.stats = IdentifierIndexStats{};
+}
+
+IdentifierIndexStats IdentifierIndex::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    IdentifierIndexStats s = impl_->stats;
+    s.file_count = static_cast<uint32_t>(impl_->file_index.size());
+    s.identifier_count = static_cast<uint32_t>(impl_->names.size());
+    return s;
+}
+
+} // namespace chunker
+} // namespace archicore
@@ -18,14 +18,23 @@
 #endif
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <functional>
 #include <optional>
 #include <chrono>
 #include <filesystem>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace archicore {
 
 /**
@@ -64,7 +73,7 @@ struct SourceLocation {
     uint32_t line_end;
     uint32_t column_start;
     uint32_t column_end;
-    uint32_t byte_offset;
+    uint64_t byte_offset;          // 64-bit: streamed files may exceed 4 GB
     uint32_t byte_length;
 };
 
@@ -127,34 +136,993 @@ enum class Language : uint8_t {
 };
 
 /**
- * @brief Detect language from file extension
+ * @brief Convert Language to string
+ */
+inline const char* language_to_string(Language lang) {
+    switch (lang) {
+        case Language::JAVASCRIPT: return "javascript";
+        case Language::TYPESCRIPT: return "typescript";
+        case Language::PYTHON: return "python";
+        case Language::RUST: return "rust";
+        case Language::GO: return "go";
+        case Language::JAVA: return "java";
+        case Language::CPP: return "cpp";
+        case Language::C: return "c";
+        case Language::CSHARP: return "csharp";
+        case Language::RUBY: return "ruby";
+        case Language::PHP: return "php";
+        case Language::SWIFT: return "swift";
+        case Language::KOTLIN: return "kotlin";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Parse a language name (also accepts common aliases)
  */
-inline Language detect_language(const std::string& path) {
-    namespace fs = std::filesystem;
-    std::string ext = fs::path(path).extension().string();
-
-    // Convert to lowercase
-    for (auto& c : ext) {
-        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-    }
-
-    if (ext == ".js" || ext == ".mjs" || ext == ".cjs") return Language::JAVASCRIPT;
-    if (ext == ".ts" || ext == ".tsx" || ext == ".mts") return Language::TYPESCRIPT;
-    if (ext == ".py" || ext == ".pyw") return Language::PYTHON;
-    if (ext == ".rs") return Language::RUST;
-    if (ext == ".go") return Language::GO;
-    if (ext == ".java") return Language::JAVA;
-    if (ext == ".cpp" || ext == ".cc" || ext == ".cxx" || ext == ".hpp" || ext == ".hxx" || ext == ".h") return Language::CPP;
-    if (ext == ".c") return Language::C;
-    if (ext == ".cs") return Language::CSHARP;
-    if (ext == ".rb") return Language::RUBY;
-    if (ext == ".php") return Language::PHP;
-    if (ext == ".swift") return Language::SWIFT;
-    if (ext == ".kt" || ext == ".kts") return Language::KOTLIN;
+inline Language language_from_string(std::string_view name) {
+    if (name == "javascript" || name == "js" || name == "node") return Language::JAVASCRIPT;
+    if (name == "typescript" || name == "ts") return Language::TYPESCRIPT;
+    if (name == "python" || name == "py") return Language::PYTHON;
+    if (name == "rust" || name == "rs") return Language::RUST;
+    if (name == "go" || name == "golang") return Language::GO;
+    if (name == "java") return Language::JAVA;
+    if (name == "cpp" || name == "c++") return Language::CPP;
+    if (name == "c") return Language::C;
+    if (name == "csharp" || name == "c#" || name == "cs") return Language::CSHARP;
+    if (name == "ruby" || name == "rb") return Language::RUBY;
+    if (name == "php") return Language::PHP;
+    if (name == "swift") return Language::SWIFT;
+    if (name == "kotlin" || name == "kt") return Language::KOTLIN;
+    return Language::UNKNOWN;
+}
+
+namespace detail {
+
+// Pack up to 8 extension bytes into an integer key. Distinct extensions get
+// distinct keys, so a switch over these keys is a perfect hash table.
+constexpr uint64_t ext_key(const char* ext) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8 && ext[i] != '\0'; i++) {
+        key = (key << 8) | static_cast<uint8_t>(ext[i]);
+    }
+    return key;
+}
+
+inline bool starts_with(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline bool contains(std::string_view s, std::string_view needle) {
+    return s.find(needle) != std::string_view::npos;
+}
+
+inline bool is_ident_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '+' || c == '#';
+}
+
+// Language named by a shebang interpreter ("python3.11", "node", ...)
+inline Language language_from_interpreter(std::string_view interp) {
+    if (starts_with(interp, "python")) return Language::PYTHON;
+    if (interp == "node" || interp == "nodejs" || interp == "bun") return Language::JAVASCRIPT;
+    if (interp == "deno" || interp == "ts-node" || interp == "tsx") return Language::TYPESCRIPT;
+    if (starts_with(interp, "ruby")) return Language::RUBY;
+    if (starts_with(interp, "php")) return Language::PHP;
+    if (interp == "swift") return Language::SWIFT;
+    if (interp == "kotlin" || interp == "kotlinc") return Language::KOTLIN;
+    return Language::UNKNOWN;
+}
+
+inline Language sniff_shebang(std::string_view head) {
+    size_t eol = head.find('\n');
+    std::string_view line = head.substr(2, eol == std::string_view::npos ? head.size() - 2 : eol - 2);
+
+    // Walk the words of the line, skipping "env" and its flags
+    size_t pos = 0;
+    while (pos < line.size()) {
+        while (pos < line.size() && std::isspace(static_cast<unsigned char>(line[pos]))) pos++;
+        size_t end = pos;
+        while (end < line.size() && !std::isspace(static_cast<unsigned char>(line[end]))) end++;
+        if (end == pos) break;
+
+        std::string_view word = line.substr(pos, end - pos);
+        size_t slash = word.rfind('/');
+        if (slash != std::string_view::npos) word = word.substr(slash + 1);
+        pos = end;
+
+        if (word.empty() || word == "env" || word[0] == '-') continue;
+        return language_from_interpreter(word);
+    }
+    return Language::UNKNOWN;
+}
+
+// Emacs "-*- mode: python -*-" or vim "vim: set ft=python" modelines
+inline Language sniff_modeline(std::string_view head) {
+    static constexpr std::string_view keys[] = {"mode:", "filetype=", "ft=", "syntax="};
+    for (std::string_view key : keys) {
+        size_t at = head.find(key);
+        if (at == std::string_view::npos) continue;
+        if (key != "mode:" && !contains(head, "vim:") && !contains(head, "vi:") && !contains(head, "ex:")) {
+            continue;
+        }
 
+        size_t pos = at + key.size();
+        while (pos < head.size() && head[pos] == ' ') pos++;
+        size_t end = pos;
+        while (end < head.size() && is_ident_char(head[end])) end++;
+
+        std::string name(head.substr(pos, end - pos));
+        for (auto& c : name) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        Language lang = language_from_string(name);
+        if (lang != Language::UNKNOWN) return lang;
+    }
     return Language::UNKNOWN;
 }
 
+// Code of a C-family head with comments blanked and literals emptied, so
+// that words inside them ("a class of errors") are not taken for syntax
+inline std::string strip_c_comments(std::string_view head) {
+    std::string code;
+    code.reserve(head.size());
+    size_t i = 0;
+    while (i < head.size()) {
+        char c = head[i];
+        if (c == '/' && i + 1 < head.size() && head[i + 1] == '/') {
+            while (i < head.size() && head[i] != '\n') i++;
+        } else if (c == '/' && i + 1 < head.size() && head[i + 1] == '*') {
+            size_t end = head.find("*/", i + 2);
+            i = (end == std::string_view::npos) ? head.size() : end + 2;
+            code.push_back(' ');
+        } else if (c == '"' || c == '\'') {
+            code.push_back(c);
+            for (i++; i < head.size() && head[i] != c && head[i] != '\n'; i++) {
+                if (head[i] == '\\') i++;
+            }
+            if (i < head.size() && head[i] == c) code.push_back(c), i++;
+        } else {
+            code.push_back(c);
+            i++;
+        }
+    }
+    return code;
+}
+
+// Whole-word occurrence of needle (needle may end in punctuation)
+inline bool contains_word(std::string_view s, std::string_view needle) {
+    for (size_t at = s.find(needle); at != std::string_view::npos; at = s.find(needle, at + 1)) {
+        if (at == 0 || !is_ident_char(s[at - 1])) return true;
+    }
+    return false;
+}
+
+// C++-only constructs that distinguish a C++ header from a C header
+inline bool looks_like_cpp(std::string_view head) {
+    // "#include <iostream>" is the one signal read from a literal-like span
+    if (contains(head, "#include <iostream>")) return true;
+
+    std::string code = strip_c_comments(head);
+    return contains_word(code, "namespace ") || contains_word(code, "template<") ||
+           contains_word(code, "template <") || contains_word(code, "std::") ||
+           contains_word(code, "public:") || contains_word(code, "private:") ||
+           contains_word(code, "class ");
+}
+
+} // namespace detail
+
+/**
+ * @brief Number of leading bytes inspected by content sniffing
+ */
+constexpr size_t LANGUAGE_SNIFF_BYTES = 1024;
+
+/**
+ * @brief Detect language from file extension
+ *
+ * Allocation-free: the lowercased extension is packed into an integer key
+ * and looked up through a compiled switch. ".h" is reported as C; use the
+ * content-aware overload to promote C++ headers.
+ */
+inline Language detect_language(std::string_view path) {
+    size_t name_start = path.find_last_of("/\\");
+    name_start = (name_start == std::string_view::npos) ? 0 : name_start + 1;
+
+    size_t dot = path.rfind('.');
+    if (dot == std::string_view::npos || dot <= name_start) return Language::UNKNOWN;
+
+    std::string_view ext = path.substr(dot + 1);
+    if (ext.empty() || ext.size() > 8) return Language::UNKNOWN;
+
+    uint64_t key = 0;
+    for (char c : ext) {
+        key = (key << 8) | static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    using detail::ext_key;
+    switch (key) {
+        case ext_key("js"): case ext_key("mjs"): case ext_key("cjs"): case ext_key("jsx"):
+            return Language::JAVASCRIPT;
+        case ext_key("ts"): case ext_key("tsx"): case ext_key("mts"): case ext_key("cts"):
+            return Language::TYPESCRIPT;
+        case ext_key("py"): case ext_key("pyw"): case ext_key("pyi"):
+            return Language::PYTHON;
+        case ext_key("rs"):
+            return Language::RUST;
+        case ext_key("go"):
+            return Language::GO;
+        case ext_key("java"):
+            return Language::JAVA;
+        case ext_key("cpp"): case ext_key("cc"): case ext_key("cxx"): case ext_key("c++"):
+        case ext_key("hpp"): case ext_key("hxx"): case ext_key("hh"): case ext_key("ipp"):
+            return Language::CPP;
+        case ext_key("c"): case ext_key("h"):
+            return Language::C;
+        case ext_key("cs"):
+            return Language::CSHARP;
+        case ext_key("rb"): case ext_key("rake"):
+            return Language::RUBY;
+        case ext_key("php"):
+            return Language::PHP;
+        case ext_key("swift"):
+            return Language::SWIFT;
+        case ext_key("kt"): case ext_key("kts"):
+            return Language::KOTLIN;
+        default:
+            return Language::UNKNOWN;
+    }
+}
+
+/**
+ * @brief Detect language from the first bytes of a file
+ *
+ * Checks, in order: shebang line, editor modelines, and cheap line-start
+ * heuristics over the first LANGUAGE_SNIFF_BYTES bytes.
+ */
+inline Language sniff_language(std::string_view content) {
+    std::string_view head = content.substr(0, std::min(content.size(), LANGUAGE_SNIFF_BYTES));
+    if (head.empty()) return Language::UNKNOWN;
+
+    if (detail::starts_with(head, "#!")) {
+        Language lang = detail::sniff_shebang(head);
+        if (lang != Language::UNKNOWN) return lang;
+    }
+
+    Language modeline = detail::sniff_modeline(head);
+    if (modeline != Language::UNKNOWN) return modeline;
+
+    if (detail::contains(head, "<?php")) return Language::PHP;
+
+    // Score line-start keywords
+    int score[16] = {0};
+    auto vote = [&score](Language lang, int weight) {
+        score[static_cast<size_t>(lang)] += weight;
+    };
+
+    size_t pos = 0;
+    while (pos < head.size()) {
+        size_t eol = head.find('\n', pos);
+        if (eol == std::string_view::npos) eol = head.size();
+        std::string_view line = head.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        size_t indent = 0;
+        while (indent < line.size() && (line[indent] == ' ' || line[indent] == '\t')) indent++;
+        line = line.substr(indent);
+        if (line.empty()) continue;
+
+        using detail::starts_with;
+        using detail::contains;
+        bool ends_colon = line.back() == ':' || (line.size() > 1 && line.back() == '\r' && line[line.size() - 2] == ':');
+        bool ends_semi = line.back() == ';' || (line.size() > 1 && line.back() == '\r' && line[line.size() - 2] == ';');
+
+        if (starts_with(line, "#include")) { vote(Language::C, 2); vote(Language::CPP, 2); }
+        if (starts_with(line, "package ")) {
+            if (ends_semi) { vote(Language::JAVA, 2); vote(Language::KOTLIN, 1); }
+            else { vote(Language::GO, 2); vote(Language::KOTLIN, 1); }
+        }
+        if (starts_with(line, "func ")) { vote(Language::GO, 2); vote(Language::SWIFT, 1); }
+        if (starts_with(line, "fun ")) vote(Language::KOTLIN, 3);
+        if (starts_with(line, "def ")) vote(ends_colon ? Language::PYTHON : Language::RUBY, 3);
+        if (starts_with(line, "from ") && contains(line, " import ")) vote(Language::PYTHON, 3);
+        if (starts_with(line, "class ") && ends_colon) vote(Language::PYTHON, 2);
+        if (starts_with(line, "fn ") || starts_with(line, "pub fn ") ||
+            starts_with(line, "impl ") || starts_with(line, "let mut ")) vote(Language::RUST, 3);
+        if (starts_with(line, "use ") && contains(line, "::")) vote(Language::RUST, 2);
+        if (starts_with(line, "using ") && ends_semi) vote(Language::CSHARP, 2);
+        if (starts_with(line, "namespace ")) { vote(Language::CPP, 1); vote(Language::CSHARP, 1); }
+        if (starts_with(line, "import java.") || starts_with(line, "public class ")) vote(Language::JAVA, 3);
+        if (starts_with(line, "require ") || starts_with(line, "require_relative ")) vote(Language::RUBY, 3);
+        if (starts_with(line, "import ") && contains(line, " from ")) { vote(Language::JAVASCRIPT, 2); vote(Language::TYPESCRIPT, 2); }
+        if (contains(line, "require(") || starts_with(line, "module.exports")) vote(Language::JAVASCRIPT, 2);
+        if (starts_with(line, "interface ") || starts_with(line, "export interface ") ||
+            starts_with(line, "export type ")) vote(Language::TYPESCRIPT, 3);
+        if (starts_with(line, "import Foundation") || starts_with(line, "import UIKit")) vote(Language::SWIFT, 4);
+    }
+
+    if (score[static_cast<size_t>(Language::CPP)] > 0 && detail::looks_like_cpp(head)) {
+        vote(Language::CPP, 1);
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < 16; i++) {
+        if (score[i] > score[best]) best = i;
+    }
+    return score[best] >= 2 ? static_cast<Language>(best) : Language::UNKNOWN;
+}
+
+/**
+ * @brief Detect language from path and file content
+ *
+ * Uses the extension table first, promotes C++ ".h" headers, and falls back
+ * to content sniffing for unknown or missing extensions.
+ */
+inline Language detect_language(std::string_view path, std::string_view content) {
+    Language lang = detect_language(path);
+
+    if (lang == Language::C && path.size() >= 2 &&
+        (path.back() == 'h' || path.back() == 'H') && path[path.size() - 2] == '.') {
+        std::string_view head = content.substr(0, std::min(content.size(), LANGUAGE_SNIFF_BYTES));
+        return detail::looks_like_cpp(head) ? Language::CPP : Language::C;
+    }
+
+    if (lang == Language::UNKNOWN) {
+        lang = sniff_language(content);
+    }
+    return lang;
+}
+
+/**
+ * @brief Literal and comment syntax of a language
+ */
+struct LexicalSyntax {
+    bool double_quotes;      // "..." is a string
+    bool slash_line;         // "// ..." comments
+    bool slash_block;        // "/* ... */" comments
+    bool hash_line;          // "# ..." comments
+    bool single_quotes;      // '...' is a string or char literal
+    bool backtick_template;  // `...${expr}...` (JavaScript/TypeScript)
+    bool backtick_raw;       // `...` without escapes (Go)
+    bool triple_quotes;      // """...""" and '''...''' (Python)
+    bool regex_literals;     // /.../ where an operand is expected (JavaScript/TypeScript)
+};
+
+/**
+ * @brief Get the lexical syntax of a language
+ */
+inline LexicalSyntax lexical_syntax(Language language) {
+    //       "     //     /* */  #      '      `${}`  `raw`  """    /re/
+    switch (language) {
+        case Language::JAVASCRIPT:
+        case Language::TYPESCRIPT:
+            return {true, true, true, false, true, true, false, false, true};
+        case Language::GO:
+            return {true, true, true, false, true, false, true, false, false};
+        case Language::RUST:
+            // '\'' is ambiguous with lifetimes ('a), so it is not treated as a quote
+            return {true, true, true, false, false, false, false, false, false};
+        case Language::JAVA:
+        case Language::CPP:
+        case Language::C:
+        case Language::CSHARP:
+        case Language::SWIFT:
+        case Language::KOTLIN:
+            return {true, true, true, false, true, false, false, false, false};
+        case Language::PYTHON:
+            return {true, false, false, true, true, false, false, true, false};
+        case Language::RUBY:
+            return {true, false, false, true, true, false, false, false, false};
+        case Language::PHP:
+            return {true, true, true, true, true, false, false, false, false};
+        default:
+            return {false, false, false, false, false, false, false, false, false};
+    }
+}
+
+/**
+ * @brief File classification flags (FileEntry::flags, ChunkResult::file_flags)
+ */
+enum FileFlags : uint8_t {
+    FILE_FLAG_BINARY       = 1 << 0,  // NUL bytes or mostly control bytes
+    FILE_FLAG_MINIFIED     = 1 << 1,  // Very long lines (bundles, minified code)
+    FILE_FLAG_GENERATED    = 1 << 2,  // Generated-code marker, lockfile or stub name
+    FILE_FLAG_HIGH_ENTROPY = 1 << 3,  // Near-random bytes (compressed or encoded data)
+    FILE_FLAG_CLASSIFIED   = 1 << 7   // Classification ran; the other bits are meaningful
+};
+
+/**
+ * @brief Number of leading bytes inspected by classify_content
+ */
+constexpr size_t CLASSIFY_SNIFF_BYTES = 8192;
+
+namespace detail {
+
+inline bool ends_with(std::string_view s, std::string_view suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Lockfiles and code generator outputs recognizable by name alone
+inline bool generated_name(std::string_view path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string_view name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+
+    static constexpr std::string_view lockfiles[] = {
+        "package-lock.json", "yarn.lock", "pnpm-lock.yaml", "Cargo.lock",
+        "Gemfile.lock", "poetry.lock", "composer.lock", "go.sum", "Pipfile.lock"
+    };
+    for (std::string_view lock : lockfiles) {
+        if (name == lock) return true;
+    }
+
+    static constexpr std::string_view suffixes[] = {
+        ".pb.go", ".pb.cc", ".pb.h", "_pb2.py", "_pb2_grpc.py", ".pb.ts",
+        "_pb.js", "_pb.d.ts", ".g.dart", ".designer.cs", ".generated.ts"
+    };
+    for (std::string_view suffix : suffixes) {
+        if (ends_with(name, suffix)) return true;
+    }
+    return false;
+}
+
+inline bool minified_name(std::string_view path) {
+    return contains(path, ".min.") || contains(path, "-min.");
+}
+
+// Valid UTF-8 with at least one multi-byte sequence. A sequence cut off by
+// the end of the sniff window still counts as valid.
+inline bool multibyte_utf8(std::string_view s) {
+    bool multibyte = false;
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (len == 0) return false;
+        for (size_t k = 1; k < len; k++) {
+            if (i + k >= s.size()) return multibyte;
+            if ((static_cast<unsigned char>(s[i + k]) & 0xC0) != 0x80) return false;
+        }
+        multibyte = multibyte || len > 1;
+        i += len;
+    }
+    return multibyte;
+}
+
+inline bool is_ident_byte(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return std::isalnum(u) || c == '_' || c == '$';
+}
+
+// Whether a '/' at pos starts a regex literal rather than a division: it
+// does where an operand is expected, judged by the previous token
+inline bool starts_regex(const char* data, size_t pos) {
+    size_t i = pos;
+    while (i > 0 && std::isspace(static_cast<unsigned char>(data[i - 1]))) i--;
+    if (i == 0) return true;
+
+    char prev = data[i - 1];
+    if (prev == ')' || prev == ']' || prev == '}' || prev == '"' || prev == '\'' || prev == '`') {
+        return false;
+    }
+    if (!is_ident_byte(prev)) return true;
+
+    size_t end = i;
+    while (i > 0 && is_ident_byte(data[i - 1])) i--;
+    std::string_view word(data + i, end - i);
+    static constexpr std::string_view operators[] = {
+        "return", "typeof", "instanceof", "in", "of", "new", "delete",
+        "void", "throw", "case", "yield", "await", "else", "do"
+    };
+    return std::find(std::begin(operators), std::end(operators), word) != std::end(operators);
+}
+
+// End of the regex literal starting at pos (after its flags)
+inline size_t skip_regex(const char* data, size_t size, size_t pos) {
+    bool in_class = false;
+    for (pos++; pos < size; pos++) {
+        char c = data[pos];
+        if (c == '\\') {
+            pos++;
+        } else if (c == '[') {
+            in_class = true;
+        } else if (c == ']') {
+            in_class = false;
+        } else if (c == '/' && !in_class) {
+            pos++;
+            while (pos < size && is_ident_byte(data[pos])) pos++;
+            return pos;
+        } else if (c == '\n') {
+            return pos;
+        }
+    }
+    return size;
+}
+
+} // namespace detail
+
+/**
+ * @brief Classify a file as binary, minified, generated or high-entropy
+ *
+ * Looks only at the path and the first CLASSIFY_SNIFF_BYTES bytes, so it can
+ * run on a mapped file while it is being hashed. The result always has
+ * FILE_FLAG_CLASSIFIED set.
+ */
+inline uint8_t classify_content(std::string_view path, std::string_view content) {
+    uint8_t flags = FILE_FLAG_CLASSIFIED;
+    std::string_view head = content.substr(0, std::min(content.size(), CLASSIFY_SNIFF_BYTES));
+
+    if (detail::generated_name(path)) flags |= FILE_FLAG_GENERATED;
+    if (detail::minified_name(path)) flags |= FILE_FLAG_MINIFIED;
+    if (head.empty()) return flags;
+
+    uint32_t histogram[256] = {0};
+    for (unsigned char c : head) histogram[c]++;
+
+    // Binary: any NUL, or more than 10% control bytes other than whitespace
+    uint32_t control = 0;
+    for (unsigned c = 1; c < 32; c++) {
+        if (c != '\t' && c != '\n' && c != '\r' && c != '\f' && c != 0x1B) control += histogram[c];
+    }
+    if (histogram[0] > 0 || control * 10 > head.size()) {
+        return flags | FILE_FLAG_BINARY;
+    }
+
+    // Shannon entropy in bits per byte: source code stays around 4.5-5.5,
+    // base64 is ~6 and compressed data approaches 8. Encoded blobs also lack
+    // the whitespace that any code has. Byte entropy says nothing about
+    // multi-byte text (CJK sources exceed 6.2), so valid UTF-8 beyond ASCII
+    // is exempt; ASCII (base64, hex) and non-UTF-8 bytes are tested.
+    if (head.size() >= 1024 && !detail::multibyte_utf8(head)) {
+        double entropy = 0;
+        double total = static_cast<double>(head.size());
+        for (uint32_t count : histogram) {
+            if (count == 0) continue;
+            double p = count / total;
+            entropy -= p * std::log2(p);
+        }
+        uint32_t whitespace = histogram[static_cast<unsigned char>(' ')] +
+                              histogram[static_cast<unsigned char>('\t')] +
+                              histogram[static_cast<unsigned char>('\n')];
+        if (entropy > 6.2 || (entropy > 5.7 && whitespace * 100 < head.size())) {
+            flags |= FILE_FLAG_HIGH_ENTROPY;
+        }
+    }
+
+    // Minified: long average lines with at least one very long line, or a
+    // full sniff window without a single newline
+    size_t lines = histogram[static_cast<unsigned char>('\n')];
+    if (lines == 0) {
+        if (head.size() == CLASSIFY_SNIFF_BYTES) flags |= FILE_FLAG_MINIFIED;
+    } else {
+        size_t longest = 0;
+        size_t start = 0;
+        while (start < head.size()) {
+            size_t eol = head.find('\n', start);
+            if (eol == std::string_view::npos) eol = head.size();
+            longest = std::max(longest, eol - start);
+            start = eol + 1;
+        }
+        if (head.size() / lines > 250 && longest >= 1000) flags |= FILE_FLAG_MINIFIED;
+    }
+
+    // Generator markers conventionally sit in the header comment
+    std::string_view top = head.substr(0, std::min(head.size(), size_t{1024}));
+    if (detail::contains(top, "@generated") || detail::contains(top, "DO NOT EDIT") ||
+        detail::contains(top, "Code generated by") || detail::contains(top, "auto-generated") ||
+        detail::contains(top, "autogenerated") || detail::contains(top, "<auto-generated") ||
+        detail::contains(top, "Generated by the protocol buffer compiler")) {
+        flags |= FILE_FLAG_GENERATED;
+    }
+
+    return flags;
+}
+
+/**
+ * @brief Streams a source's token text, without whitespace and comments, into a sink
+ *
+ * Literals (strings, templates, JavaScript regexes) pass through verbatim.
+ * Whitespace only survives as one separator where dropping it would merge
+ * two tokens ("a b", "- -"). Python keeps its block structure as
+ * indent/dedent markers ('\x01', '\x02') and logical line ends, but not the
+ * indentation width. Where a line break can end a statement (JavaScript and
+ * TypeScript ASI, Go, Kotlin, Swift, Ruby, C-family preprocessor lines) it
+ * is kept as a '\n' token. Two sources that differ only in formatting or
+ * comments produce the same stream.
+ *
+ * Sink must provide put(char).
+ */
+template <typename Sink>
+class TokenNormalizer {
+public:
+    TokenNormalizer(Language language, Sink& sink)
+        : syntax_(lexical_syntax(language))
+        , indentation_(language == Language::PYTHON)
+        , newlines_(newline_mode(language))
+        , directives_(language == Language::C || language == Language::CPP || language == Language::CSHARP)
+        , line_splicing_(language == Language::PYTHON || language == Language::RUBY ||
+                         language == Language::C || language == Language::CPP)
+        , sink_(sink)
+    {
+    }
+
+    void run(std::string_view src) {
+        src_ = src;
+        size_t pos = 0;
+        bool line_start = true;
+
+        while (pos < src_.size()) {
+            if (line_start && indentation_ && open_.empty()) {
+                pos = indent(pos);
+                line_start = false;
+                continue;
+            }
+
+            char c = src_[pos];
+            char next = pos + 1 < src_.size() ? src_[pos + 1] : '\0';
+
+            if (c == '\n') {
+                end_line();
+                line_start = true;
+                pos++;
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                pending_space_ = true;
+                pos++;
+                continue;
+            }
+            if (c == '\\' && line_splicing_ && (next == '\n' || next == '\r')) {
+                // Explicit line joining
+                pos += 2;
+                if (next == '\r' && pos < src_.size() && src_[pos] == '\n') pos++;
+                pending_space_ = true;
+                continue;
+            }
+
+            if ((c == '/' && next == '/' && syntax_.slash_line) || (c == '#' && syntax_.hash_line)) {
+                while (pos < src_.size() && src_[pos] != '\n') pos++;
+                pending_space_ = true;
+                continue;
+            }
+            if (c == '/' && next == '*' && syntax_.slash_block) {
+                size_t end = src_.find("*/", pos + 2);
+                end = end == std::string_view::npos ? src_.size() : end + 2;
+                // A comment spanning lines ends the line like a line break would
+                if (src_.substr(pos, end - pos).find('\n') != std::string_view::npos) end_line();
+                pos = end;
+                pending_space_ = true;
+                continue;
+            }
+
+            size_t end = literal_end(pos);
+            if (end > pos) {
+                token(c);
+                for (size_t i = pos + 1; i < end; i++) put(src_[i]);
+                pos = end;
+                continue;
+            }
+
+            if (c == '(' || c == '[' || c == '{') open_.push_back(c);
+            if ((c == ')' || c == ']' || c == '}') && !open_.empty()) open_.pop_back();
+            token(c);
+            pos++;
+        }
+    }
+
+private:
+    // Which line breaks can end a statement
+    enum class Newlines {
+        NONE,     // None: statements end with ';' or '}'
+        LOGICAL,  // Outside any brackets (Python)
+        BLOCKS,   // Outside parentheses and brackets (JavaScript, TypeScript, Kotlin, Swift)
+        ALWAYS    // Anywhere (Go, Ruby)
+    };
+
+    static Newlines newline_mode(Language language) {
+        switch (language) {
+            case Language::PYTHON:
+                return Newlines::LOGICAL;
+            case Language::JAVASCRIPT:
+            case Language::TYPESCRIPT:
+            case Language::KOTLIN:
+            case Language::SWIFT:
+                return Newlines::BLOCKS;
+            case Language::GO:
+            case Language::RUBY:
+                return Newlines::ALWAYS;
+            default:
+                return Newlines::NONE;
+        }
+    }
+
+    LexicalSyntax syntax_;
+    bool indentation_;
+    Newlines newlines_;
+    bool directives_;     // '#' lines end at the line break (C preprocessor, C# directives)
+    bool line_splicing_;  // Backslash-newline joins lines
+    Sink& sink_;
+    std::string_view src_;
+    char last_ = '\0';
+    bool pending_space_ = false;
+    bool line_has_code_ = false;
+    bool directive_line_ = false;
+    bool line_end_ = false;  // A statement-ending line break awaits the next token
+    std::string open_;  // Open brackets, innermost last
+    std::vector<size_t> indents_{0};
+
+    enum class CharClass { WORD, OPERATOR, OTHER };
+
+    static CharClass char_class(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isalnum(u) || c == '_' || c == '$' || u >= 0x80) return CharClass::WORD;
+        if (std::strchr("+-*/%<>=!&|^~?:.#@", c) != nullptr) return CharClass::OPERATOR;
+        return CharClass::OTHER;
+    }
+
+    void put(char c) {
+        sink_.put(c);
+        last_ = c;
+    }
+
+    // Emit the first byte of a token, keeping a separator where one matters
+    void token(char c) {
+        if (pending_space_ && last_ != '\0') {
+            CharClass a = char_class(last_);
+            if (a != CharClass::OTHER && a == char_class(c)) put(' ');
+        }
+        flush_line_end();
+        if (c == '#' && directives_ && !line_has_code_) directive_line_ = true;
+        pending_space_ = false;
+        line_has_code_ = true;
+        put(c);
+    }
+
+    // A line break after code: keep it as a token where it can end a
+    // statement. Blank and comment-only lines never count, and neither does
+    // the final line break, since the token is only written before the next.
+    void end_line() {
+        pending_space_ = true;
+        if (!line_has_code_) return;
+
+        bool ends = directive_line_;
+        switch (newlines_) {
+            case Newlines::NONE:
+                break;
+            case Newlines::LOGICAL:
+                ends = ends || open_.empty();
+                break;
+            case Newlines::BLOCKS:
+                ends = ends || ((open_.empty() || open_.back() == '{') && continues_after(last_));
+                break;
+            case Newlines::ALWAYS:
+                ends = ends || continues_after(last_);
+                break;
+        }
+        if (!ends) return;
+
+        line_end_ = true;
+        line_has_code_ = false;
+        directive_line_ = false;
+    }
+
+    void flush_line_end() {
+        if (!line_end_) return;
+        line_end_ = false;
+        put('\n');
+    }
+
+    // Whether a line ending in c may still end a statement: after a
+    // separator or an opening bracket the statement always continues
+    static bool continues_after(char c) {
+        return std::strchr(",;([{", c) == nullptr;
+    }
+
+    // Python block structure: compare the indentation of a code line with
+    // the enclosing blocks; blank and comment-only lines do not count
+    size_t indent(size_t pos) {
+        size_t width = 0;
+        while (pos < src_.size() && (src_[pos] == ' ' || src_[pos] == '\t')) {
+            width += src_[pos] == '\t' ? 8 - (width % 8) : 1;
+            pos++;
+        }
+        if (pos >= src_.size() || src_[pos] == '\n' || src_[pos] == '\r' || src_[pos] == '#') {
+            return pos;
+        }
+
+        flush_line_end();
+        if (width > indents_.back()) {
+            indents_.push_back(width);
+            put('\x01');
+        } else {
+            while (indents_.size() > 1 && width < indents_.back()) {
+                indents_.pop_back();
+                put('\x02');
+            }
+        }
+        pending_space_ = false;
+        return pos;
+    }
+
+    // End of the string or regex literal at pos (pos itself when there is none)
+    size_t literal_end(size_t pos) const {
+        char c = src_[pos];
+        if (c == '/' && syntax_.regex_literals && detail::starts_regex(src_.data(), pos)) {
+            return detail::skip_regex(src_.data(), src_.size(), pos);
+        }
+        if ((c == '"' || c == '\'') && syntax_.triple_quotes && pos + 2 < src_.size() &&
+            src_[pos + 1] == c && src_[pos + 2] == c) {
+            size_t end = src_.find(std::string(3, c), pos + 3);
+            return end == std::string_view::npos ? src_.size() : end + 3;
+        }
+
+        bool quoted = (c == '"' && syntax_.double_quotes) || (c == '\'' && syntax_.single_quotes) ||
+                      (c == '`' && (syntax_.backtick_template || syntax_.backtick_raw));
+        if (!quoted) return pos;
+
+        bool escapes = !(c == '`' && syntax_.backtick_raw);
+        for (size_t i = pos + 1; i < src_.size(); i++) {
+            if (src_[i] == '\\' && escapes) {
+                i++;
+            } else if (src_[i] == c) {
+                return i + 1;
+            } else if (src_[i] == '\n' && c != '`') {
+                return i;  // Unterminated: stop at the line end
+            }
+        }
+        return src_.size();
+    }
+};
+
+/**
+ * @brief Index of the lowest set bit (mask must be nonzero)
+ */
+inline int trailing_zeros(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+/**
+ * @brief Number of set bits
+ */
+inline uint32_t popcount(uint64_t mask) {
+#ifdef _MSC_VER
+    return static_cast<uint32_t>(__popcnt64(mask));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(mask));
+#endif
+}
+
+/**
+ * @brief Glob pattern compiled once for repeated path matching
+ *
+ * '**' matches any characters including separators, '*' any run without
+ * a separator ('/' or '\\'), '?' one non-separator character; everything
+ * else is literal. Matching is ASCII case-insensitive and covers the
+ * whole path. The pattern runs as a small NFA, one pass over the path
+ * with no backtracking.
+ */
+class GlobMatcher {
+public:
+    explicit GlobMatcher(std::string_view pattern) : pattern_(pattern) {
+        for (size_t i = 0; i < pattern.size(); i++) {
+            char c = pattern[i];
+            if (c == '*') {
+                bool deep = i + 1 < pattern.size() && pattern[i + 1] == '*';
+                if (deep) i++;
+                Op op = deep ? Op::ANY_DEEP : Op::ANY;
+                // Adjacent stars collapse; '**' absorbs '*'
+                if (!ops_.empty() && (ops_.back().op == Op::ANY || ops_.back().op == Op::ANY_DEEP)) {
+                    if (op == Op::ANY_DEEP) ops_.back().op = Op::ANY_DEEP;
+                    continue;
+                }
+                ops_.push_back({op, 0});
+            } else if (c == '?') {
+                ops_.push_back({Op::ONE, 0});
+            } else {
+                ops_.push_back({Op::CHAR, fold(c)});
+            }
+        }
+
+        // Patterns of up to 63 steps run bit-parallel: bit i is state i
+        if (ops_.size() < 64) {
+            for (size_t i = 0; i < ops_.size(); i++) {
+                uint64_t bit = uint64_t(1) << i;
+                switch (ops_[i].op) {
+                    case Op::CHAR: char_masks_[static_cast<uint8_t>(ops_[i].c)] |= bit; break;
+                    case Op::ONE: one_mask_ |= bit; break;
+                    case Op::ANY: star_mask_ |= bit; break;
+                    case Op::ANY_DEEP: star_mask_ |= bit; deep_mask_ |= bit; break;
+                }
+            }
+        }
+    }
+
+    bool match(std::string_view path) const {
+        return ops_.size() < 64 ? match_bits(path) : match_states(path);
+    }
+
+    const std::string& pattern() const { return pattern_; }
+
+private:
+    enum class Op : uint8_t { CHAR, ONE, ANY, ANY_DEEP };
+
+    struct Step {
+        Op op;
+        char c;     // Folded character for CHAR
+    };
+
+    static char fold(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    static bool is_separator(char c) {
+        return c == '/' || c == '\\';
+    }
+
+    // Stars never follow each other, so one shift closes over empty matches
+    uint64_t close_bits(uint64_t states) const {
+        return states | ((states & star_mask_) << 1);
+    }
+
+    bool match_bits(std::string_view path) const {
+        uint64_t states = close_bits(1);
+        for (char raw : path) {
+            char c = fold(raw);
+            bool separator = is_separator(c);
+            uint64_t advance = char_masks_[static_cast<uint8_t>(c)] | (separator ? 0 : one_mask_);
+            uint64_t stay = states & (separator ? deep_mask_ : star_mask_);
+            states = close_bits(((states & advance) << 1) | stay);
+            if (states == 0) return false;
+        }
+        return (states >> ops_.size()) & 1;
+    }
+
+    bool match_states(std::string_view path) const {
+        size_t m = ops_.size();
+        std::vector<uint8_t> current(m + 1, 0);
+        std::vector<uint8_t> next(m + 1, 0);
+        current[0] = 1;
+        close_states(current);
+
+        for (char raw : path) {
+            char c = fold(raw);
+            bool separator = is_separator(c);
+            std::fill(next.begin(), next.end(), 0);
+
+            bool any = false;
+            for (size_t i = 0; i < m; i++) {
+                if (!current[i]) continue;
+                const Step& step = ops_[i];
+                bool advance = (step.op == Op::CHAR && step.c == c) || (step.op == Op::ONE && !separator);
+                bool stay = step.op == Op::ANY_DEEP || (step.op == Op::ANY && !separator);
+                if (advance) next[i + 1] = 1;
+                if (stay) next[i] = 1;
+                any = any || advance || stay;
+            }
+            if (!any) return false;
+            close_states(next);
+            current.swap(next);
+        }
+        return current[m] != 0;
+    }
+
+    void close_states(std::vector<uint8_t>& states) const {
+        for (size_t i = 0; i < ops_.size(); i++) {
+            if (states[i] && (ops_[i].op == Op::ANY || ops_[i].op == Op::ANY_DEEP)) states[i + 1] = 1;
+        }
+    }
+
+    std::string pattern_;
+    std::vector<Step> ops_;
+    uint64_t char_masks_[256] = {};
+    uint64_t one_mask_ = 0;
+    uint64_t star_mask_ = 0;
+    uint64_t deep_mask_ = 0;
+};
+
 /**
  * @brief Get current timestamp in milliseconds
  */
@@ -0,0 +1,282 @@
+/**
+ * @file daemon.h
+ * @brief Long-running indexing daemon for ArchiCore
+ * @version 1.0.0
+ *
+ * Keeps a repository hot in memory between CLI invocations:
+ * - FileIndex and its Merkle tree, refreshed from an inotify watch
+ * - Chunk results in a ChunkCache keyed by content hash
+ * - Identifier cross-reference index for search
+ * - Scan, diff, chunk and search requests over a local Unix socket
+ *
+ * Wire format: every frame is a 9-byte header (u32 payload length,
+ * u8 opcode or reply status, u32 request id; little-endian) followed by
+ * the payload. Payload integers are LEB128 varints, hashes are fixed
+ * 8-byte little-endian, strings are a varint length and UTF-8 bytes.
+ *
+ * Requests and replies (payload fields in order):
+ *   PING      -> varint version, varint pid
+ *   STATUS    -> str root, varint generation, varint files, u64 merkle root,
+ *                u8 watching, varint watches, varint identifier files,
+ *                varint identifiers, varint occurrences, varint chunk hits,
+ *                varint chunk misses, varint chunk entries, varint uptime ms,
+ *                varint startup ms, varint n, n x str include, varint n,
+ *                n x str exclude, u8 semantic hash, u8 search, str shared index
+ *   SCAN      str prefix
+ *             -> varint generation, u64 merkle root, varint count,
+ *                count x (str path, u64 hash, varint size, varint mtime,
+ *                u8 language, u8 flags, u64 semantic hash)
+ *   DIFF      varint since generation
+ *             -> varint generation, u8 complete, varint count,
+ *                count x (u8 type, u8 kind, str path, str old path,
+ *                u64 old hash, u64 new hash)
+ *   CHUNK     str path
+ *             -> u8 language, u8 file flags, u8 result flags, varint total tokens,
+ *                varint total lines, varint time us, varint count,
+ *                count x (str content, varint tokens, 6 x varint location,
+ *                u8 type, str parent, str namespace, varint n, n x str import,
+ *                varint index, str hash, str id)
+ *   SEARCH    str name, u8 mode, u8 roles, str path, varint limit
+ *             -> varint total, varint count, count x (str path, varint offset,
+ *                varint line, varint column, u8 role, str callee, str caller)
+ *   SHUTDOWN  -> (empty)
+ * An ERROR reply carries one string, the message.
+ */
+
+#ifndef ARCHICORE_DAEMON_H
+#define ARCHICORE_DAEMON_H
+
+#include "common.h"
+#include "indexer.h"
+#include "chunker.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace archicore {
+namespace daemon {
+
+constexpr uint32_t PROTOCOL_VERSION = 2;
+constexpr size_t FRAME_HEADER_SIZE = 9;
+constexpr uint32_t MAX_FRAME_SIZE = 64u * 1024 * 1024;
+
+/**
+ * @brief Request opcodes
+ */
+enum class Opcode : uint8_t {
+    PING = 1,
+    STATUS = 2,
+    SCAN = 3,
+    DIFF = 4,
+    CHUNK = 5,
+    SEARCH = 6,
+    SHUTDOWN = 7
+};
+
+/**
+ * @brief Reply status, in place of the opcode
+ */
+enum class ReplyStatus : uint8_t {
+    OK = 0,
+    ERROR = 1
+};
+
+/**
+ * @brief What a SEARCH request looks up
+ */
+enum class SearchMode : uint8_t {
+    OCCURRENCES = 0,    // Identifier occurrences in the requested roles
+    CALL_SITES = 1,     // Calls of the name
+    CALLEES = 2         // Calls made inside functions with the name
+};
+
+/**
+ * @brief CHUNK reply result flags
+ */
+enum ChunkResultFlags : uint8_t {
+    CHUNK_SKIPPED = 1 << 0,     // Binary or high-entropy; no chunks
+    CHUNK_DEGRADED = 1 << 1     // Boundary budget ran out
+};
+
+/**
+ * @brief Decoded frame header
+ */
+struct FrameHeader {
+    uint32_t length = 0;        // Payload bytes after the header
+    uint8_t code = 0;           // Opcode (requests) or ReplyStatus (replies)
+    uint32_t request_id = 0;    // Echoed in the reply
+};
+
+/**
+ * @brief Decode a frame header
+ * @return false if fewer than FRAME_HEADER_SIZE bytes are available
+ */
+bool read_frame_header(const char* data, size_t size, FrameHeader& out);
+
+/**
+ * @brief Encode a complete frame
+ */
+std::string encode_frame(uint8_t code, uint32_t request_id, std::string_view payload);
+
+/**
+ * @brief Appends payload fields
+ */
+class PayloadWriter {
+public:
+    void u8(uint8_t value);
+    void u64(uint64_t value);
+    void varint(uint64_t value);
+    void str(std::string_view value);
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+};
+
+/**
+ * @brief Reads payload fields; every read fails past the end
+ */
+class PayloadReader {
+public:
+    explicit PayloadReader(std::string_view data) : data_(data) {}
+
+    bool u8(uint8_t& value);
+    bool u64(uint64_t& value);
+    bool varint(uint64_t& value);
+    bool str(std::string& value);
+
+    bool at_end() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief A change under the watched root
+ */
+struct WatchEvent {
+    std::string path;           // Relative to the root
+    bool is_dir = false;
+    bool removed = false;       // Deleted or moved away
+};
+
+/**
+ * @brief Recursive directory watch
+ *
+ * inotify on Linux, one watch per directory; elsewhere unavailable, and
+ * the daemon rescans on demand instead.
+ */
+class TreeWatcher {
+public:
+    explicit TreeWatcher(const std::string& root);
+    ~TreeWatcher();
+
+    /**
+     * @brief Whether the platform supports watching and the watch is alive
+     */
+    bool available() const;
+
+    /**
+     * @brief Descriptor to poll for events (-1 if unavailable)
+     */
+    int fd() const;
+
+    /**
+     * @brief Watch a directory and its subdirectories
+     * @param rel_dir Directory relative to the root ("" = root)
+     * @param skip_dir Returns true for directories not to enter
+     * @param files Receives the files found under rel_dir
+     * @return false if the watch limit was reached (the watch is dropped)
+     */
+    bool add_tree(const std::string& rel_dir,
+                  const std::function<bool(const std::string&)>& skip_dir,
+                  std::vector<std::string>& files);
+
+    /**
+     * @brief Drain pending events without blocking
+     * @param events Receives the events
+     * @return false if the kernel queue overflowed and events were lost
+     */
+    bool read_events(std::vector<WatchEvent>& events);
+
+    /**
+     * @brief Number of watched directories
+     */
+    size_t watch_count() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Daemon configuration
+ */
+struct DaemonConfig {
+    std::string root;                           // Repository root
+    std::string socket_path;                    // Unix socket to listen on
+    indexer::IndexerConfig indexer;
+    chunker::ChunkerConfig chunker;
+    uint64_t chunk_cache_bytes = 256ull * 1024 * 1024;
+    bool index_identifiers = true;              // Build the search index at startup
+    uint32_t debounce_ms = 20;                  // Quiet time before applying watch events
+    uint32_t poll_interval_ms = 2000;           // Rescan interval without a watch
+    uint32_t change_log_limit = 65536;          // Changes kept for DIFF
+    uint32_t max_clients = 64;
+    std::string shared_index;                   // SharedFileIndex segment to publish to (empty = off)
+};
+
+/**
+ * @brief Indexing daemon
+ *
+ * start() binds the socket and indexes the root; run() serves requests
+ * on the calling thread until SHUTDOWN or stop(). Requests are handled
+ * one at a time, after pending watch events are applied, so every reply
+ * reflects the tree as of the request.
+ *
+ * Every applied batch of changes bumps the generation; DIFF returns the
+ * changes since a generation, coalesced per path, as long as they are
+ * still in the change log.
+ */
+class Daemon {
+public:
+    explicit Daemon(const DaemonConfig& config);
+    ~Daemon();
+
+    /**
+     * @brief Bind the socket and build the initial index
+     * @param error Receives the reason on failure
+     * @return true on success
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief Serve until SHUTDOWN or stop()
+     * @return 0 on a clean shutdown
+     */
+    int run();
+
+    /**
+     * @brief Ask run() to return (async-signal-safe)
+     */
+    void stop();
+
+    /**
+     * @brief Handle one request without a socket
+     * @return The complete reply frame
+     */
+    std::string dispatch(uint8_t opcode, uint32_t request_id, std::string_view payload);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace daemon
+} // namespace archicore
+
+#endif // ARCHICORE_DAEMON_H
@@ -0,0 +1,960 @@
+/**
+ * @file daemon.cpp
+ * @brief Indexing daemon: hot index state and the Unix socket server
+ * @version 1.0.0
+ *
+ * One thread serves every connection from a poll() loop:
+ * - Watch events are collected as they arrive and applied after a short
+ *   quiet period, or right away when a request comes in
+ * - Changed files are re-digested and diffed with Indexer::diff, so
+ *   renames and format-only edits are classified as in a full scan
+ * - Applied changes go to a bounded change log that answers DIFF
+ */
+
+#include "daemon.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace archicore {
+namespace daemon {
+
+using indexer::ChangeKind;
+using indexer::ChangeType;
+using indexer::DiffResult;
+using indexer::FileChange;
+using indexer::FileEntry;
+using indexer::ScanResult;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint8_t NOISE_FLAGS = FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY | FILE_FLAG_MINIFIED | FILE_FLAG_GENERATED;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+struct LoggedChange {
+    uint64_t generation;
+    FileChange change;
+};
+
+struct Connection {
+    int fd = -1;
+    std::string in;
+    std::string out;
+    bool closed = false;
+};
+
+uint64_t elapsed_ms(Clock::time_point since) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since).count());
+}
+
+bool set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return false;
+    return fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+bool under(const std::string& path, const std::string& dir) {
+    return path.size() > dir.size() && path[dir.size()] == '/' && path.compare(0, dir.size(), dir) == 0;
+}
+
+std::string normalize_path(std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');
+    while (path.compare(0, 2, "./") == 0) path.erase(0, 2);
+    while (!path.empty() && path.back() == '/') path.pop_back();
+    return path;
+}
+
+std::string error_frame(uint32_t request_id, const std::string& message) {
+    PayloadWriter writer;
+    writer.str(message);
+    return encode_frame(static_cast<uint8_t>(ReplyStatus::ERROR), request_id, writer.data());
+}
+
+/**
+ * @brief State of one path across a span of the change log
+ */
+struct PathSpan {
+    bool existed = false;       // Before the span
+    uint64_t old_hash = 0;
+    bool exists = false;        // After the span
+    uint64_t new_hash = 0;
+    bool format_only = true;    // Every step was a FORMAT_ONLY modification
+};
+
+} // namespace
+
+struct Daemon::Impl {
+    DaemonConfig config;
+    std::string root;
+    indexer::Indexer indexer;
+    indexer::FileHasher hasher;
+    indexer::FileIndex files;
+    indexer::SharedFileIndex shared;
+    chunker::Chunker chunker;
+    std::shared_ptr<chunker::ChunkCache> chunk_cache;
+    std::shared_ptr<chunker::IdentifierIndex> identifiers;
+    std::unique_ptr<TreeWatcher> watcher;
+    std::vector<GlobMatcher> include_matchers;
+    std::vector<GlobMatcher> exclude_matchers;
+
+    int listen_fd = -1;
+    int wake_fds[2] = {-1, -1};
+    std::atomic<bool> stopping{false};
+    std::vector<Connection> connections;
+
+    // Watch events not yet applied
+    std::unordered_set<std::string> dirty;
+    std::vector<std::string> removed_dirs;
+    bool rescan_needed = false;
+    Clock::time_point last_event;
+    Clock::time_point last_rescan;
+
+    // Generations start at the startup time in ms, so a generation handed
+    // out by an earlier daemon falls below the log and reads as incomplete
+    uint64_t generation = 0;
+    uint64_t log_floor = 0;
+    std::deque<LoggedChange> change_log;
+
+    Clock::time_point started;
+    uint64_t startup_ms = 0;
+
+    explicit Impl(const DaemonConfig& cfg)
+        : config(cfg)
+        , indexer(cfg.indexer)
+        , chunker(cfg.chunker)
+        , chunk_cache(std::make_shared<chunker::ChunkCache>(cfg.chunk_cache_bytes))
+        , identifiers(std::make_shared<chunker::IdentifierIndex>())
+    {
+        chunker.set_cache(chunk_cache);
+        // The indexer fills in the default excludes; match exactly what it scans
+        const indexer::IndexerConfig& effective = indexer.get_config();
+        for (const auto& pattern : effective.include_patterns) include_matchers.emplace_back(pattern);
+        for (const auto& pattern : effective.exclude_patterns) exclude_matchers.emplace_back(pattern);
+    }
+
+    ~Impl() {
+        for (auto& connection : connections) close(connection.fd);
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            unlink(config.socket_path.c_str());
+        }
+        if (wake_fds[0] >= 0) close(wake_fds[0]);
+        if (wake_fds[1] >= 0) close(wake_fds[1]);
+        if (shared.is_writer()) {
+            // Attached readers keep their mapping; new ones must not find a stale index.
+            // A segment taken over from an earlier writer is left where it was found
+            bool created = shared.created();
+            shared.close();
+            if (created) indexer::SharedFileIndex::unlink(config.shared_index);
+        }
+    }
+
+    std::string absolute(const std::string& rel) const {
+        return root + "/" + rel;
+    }
+
+    bool excluded(const std::string& rel) const {
+        for (const auto& matcher : exclude_matchers) {
+            if (matcher.match(rel)) return true;
+        }
+        return false;
+    }
+
+    bool included(const std::string& rel) const {
+        if (include_matchers.empty()) return true;
+        for (const auto& matcher : include_matchers) {
+            if (matcher.match(rel)) return true;
+        }
+        return false;
+    }
+
+    // Directories whose every file would be excluded ("**/node_modules/**")
+    bool skip_dir(const std::string& rel) const {
+        return excluded(rel + "/");
+    }
+
+    // ===== Startup =====
+
+    bool listen_on_socket(std::string& error) {
+        const std::string& path = config.socket_path;
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            error = "Socket path is empty or too long: " + path;
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        // Only a socket is ours to replace; refuse to delete anything else at the path
+        struct stat st{};
+        bool exists = lstat(path.c_str(), &st) == 0;
+        if (exists && !S_ISSOCK(st.st_mode)) {
+            error = path + " exists and is not a socket";
+            return false;
+        }
+
+        // A socket file nobody answers on is left over from a crash
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (probe >= 0) {
+            bool alive = connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+            close(probe);
+            if (alive) {
+                error = "A daemon is already listening on " + path;
+                return false;
+            }
+        }
+        if (exists) unlink(path.c_str());
+
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0 || !set_nonblocking(listen_fd)) {
+            error = std::string("Cannot create socket: ") + std::strerror(errno);
+            return false;
+        }
+        mode_t mask = umask(077);
+        int bound = bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        umask(mask);
+        if (bound < 0 || listen(listen_fd, 64) < 0) {
+            error = "Cannot listen on " + path + ": " + std::strerror(errno);
+            close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+
+        if (pipe(wake_fds) < 0 || !set_nonblocking(wake_fds[0]) || !set_nonblocking(wake_fds[1])) {
+            error = std::string("Cannot create wake pipe: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool initial_index(std::string& error) {
+        started = Clock::now();
+
+        ScanResult scan = indexer.scan(root);
+        if (!scan.error.empty()) {
+            error = scan.error;
+            return false;
+        }
+        for (const auto& entry : scan.files) files.add(entry);
+
+        if (!config.shared_index.empty() &&
+            (!shared.create(config.shared_index, 0, error) || !shared.publish(files, error))) {
+            return false;
+        }
+
+        watcher = std::make_unique<TreeWatcher>(root);
+        std::vector<std::string> ignored;
+        watcher->add_tree("", [this](const std::string& rel) { return skip_dir(rel); }, ignored);
+
+        if (config.index_identifiers) index_identifiers(scan.files);
+
+        generation = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        log_floor = generation;
+        last_rescan = Clock::now();
+        startup_ms = elapsed_ms(started);
+        return true;
+    }
+
+    // Reads each file and records its identifiers, on a worker pool
+    void index_identifiers(const std::vector<FileEntry>& entries) {
+        std::vector<const FileEntry*> work;
+        for (const auto& entry : entries) {
+            if (entry.flags & NOISE_FLAGS) {
+                identifiers->remove_file(entry.path);
+            } else {
+                work.push_back(&entry);
+            }
+        }
+        if (work.empty()) return;
+
+        uint32_t num_workers = std::max(1u, std::min(config.indexer.parallel_workers,
+                                                     std::thread::hardware_concurrency()));
+        num_workers = static_cast<uint32_t>(std::min<size_t>(num_workers, work.size()));
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            size_t idx;
+            while ((idx = next.fetch_add(1)) < work.size()) {
+                const FileEntry& entry = *work[idx];
+                MappedFile file;
+                if (!file.open(absolute(entry.path))) {
+                    identifiers->remove_file(entry.path);
+                    continue;
+                }
+                std::string source(file.data(), file.size());
+                file.close();
+                identifiers->update_file(entry.path, source, entry.language, entry.content_hash,
+                                         nullptr, nullptr, entry.flags);
+            }
+        };
+
+        if (num_workers <= 1) {
+            worker();
+        } else {
+            std::vector<std::future<void>> futures;
+            for (uint32_t w = 0; w < num_workers; w++) futures.push_back(std::async(std::launch::async, worker));
+            for (auto& f : futures) f.wait();
+        }
+    }
+
+    // ===== Watch events =====
+
+    void collect_events() {
+        if (!watcher || !watcher->available()) return;
+
+        std::vector<WatchEvent> events;
+        if (!watcher->read_events(events)) rescan_needed = true;
+        if (events.empty()) return;
+
+        for (auto& event : events) {
+            if (!event.is_dir) {
+                dirty.insert(std::move(event.path));
+            } else if (event.removed) {
+                removed_dirs.push_back(std::move(event.path));
+            } else if (!skip_dir(event.path)) {
+                // Files may have landed before the watch did; take them all
+                std::vector<std::string> found;
+                bool watching = watcher->add_tree(event.path,
+                    [this](const std::string& rel) { return skip_dir(rel); }, found);
+                if (!watching) rescan_needed = true;
+                for (auto& path : found) dirty.insert(std::move(path));
+            }
+        }
+        last_event = Clock::now();
+    }
+
+    bool has_pending() const {
+        return rescan_needed || !dirty.empty() || !removed_dirs.empty();
+    }
+
+    // Apply everything known so far; without a watch, rescan at most once per interval
+    void sync() {
+        collect_events();
+        bool watching = watcher && watcher->available();
+        if (!watching && elapsed_ms(last_rescan) >= config.poll_interval_ms) rescan_needed = true;
+
+        if (rescan_needed) {
+            full_rescan();
+        } else if (!dirty.empty() || !removed_dirs.empty()) {
+            refresh_paths();
+        }
+        dirty.clear();
+        removed_dirs.clear();
+        rescan_needed = false;
+    }
+
+    void full_rescan() {
+        ScanResult after = indexer.scan(root);
+        if (!after.error.empty()) return;   // Root unreadable for now; keep the last state
+
+        ScanResult before;
+        before.files = files.get_all();
+        apply(before, after);
+
+        if (watcher && watcher->available()) {
+            // Directories created while events were lost have no watch yet
+            std::vector<std::string> ignored;
+            watcher->add_tree("", [this](const std::string& rel) { return skip_dir(rel); }, ignored);
+        }
+        last_rescan = Clock::now();
+    }
+
+    void refresh_paths() {
+        if (!removed_dirs.empty()) {
+            for (const auto& entry : files.get_all()) {
+                for (const auto& dir : removed_dirs) {
+                    if (under(entry.path, dir)) {
+                        dirty.insert(entry.path);
+                        break;
+                    }
+                }
+            }
+        }
+
+        ScanResult before;
+        ScanResult after;
+        std::vector<std::string> rel_paths;
+        std::vector<std::string> abs_paths;
+        const indexer::IndexerConfig& cfg = indexer.get_config();
+
+        for (const auto& rel : dirty) {
+            const FileEntry* known = files.get(rel);
+            if (known) before.files.push_back(*known);
+
+            if (excluded(rel) || !included(rel)) continue;
+            std::error_code ec;
+            std::string abs = absolute(rel);
+            if (!fs::is_regular_file(abs, ec)) continue;
+            uint64_t size = fs::file_size(abs, ec);
+            if (ec || size > cfg.max_file_size) continue;
+            rel_paths.push_back(rel);
+            abs_paths.push_back(std::move(abs));
+        }
+
+        std::vector<indexer::FileDigest> digests;
+        if (cfg.compute_content_hash) {
+            digests = hasher.digest_files_parallel(abs_paths, cfg.parallel_workers, cfg.compute_semantic_hash);
+        } else {
+            digests.resize(abs_paths.size());
+            for (size_t i = 0; i < abs_paths.size(); i++) digests[i].language = detect_language(abs_paths[i]);
+        }
+
+        for (size_t i = 0; i < rel_paths.size(); i++) {
+            FileEntry entry;
+            entry.path = rel_paths[i];
+            entry.content_hash = digests[i].content_hash;
+            std::error_code ec;
+            entry.size = fs::file_size(abs_paths[i], ec);
+            if (ec) entry.size = 0;
+            auto mtime = fs::last_write_time(abs_paths[i], ec);
+            entry.mtime = ec ? 0 : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                mtime.time_since_epoch()).count());
+            entry.language = digests[i].language;
+            entry.flags = digests[i].flags;
+            entry.semantic_hash = digests[i].semantic_hash;
+            entry.is_indexed = false;
+            after.files.push_back(std::move(entry));
+        }
+
+        apply(before, after);
+    }
+
+    // Bring the index from `before` to `after` (both cover the same paths)
+    void apply(const ScanResult& before, const ScanResult& after) {
+        DiffResult diff = indexer.diff(before, after);
+
+        std::unordered_map<std::string, const FileEntry*> present;
+        for (const auto& entry : after.files) present.emplace(entry.path, &entry);
+        for (const auto& entry : before.files) {
+            if (!present.count(entry.path)) files.remove(entry.path);
+        }
+        // Unchanged content still refreshes size and mtime
+        for (const auto& entry : after.files) files.add(entry);
+
+        // A failed publish leaves readers on the previous snapshot until the next one
+        std::string error;
+        if (shared.is_writer()) shared.publish(files, error);
+
+        if (diff.changes.empty()) return;
+
+        std::vector<FileEntry> reindex;
+        if (config.index_identifiers) {
+            for (const auto& change : diff.changes) {
+                switch (change.type) {
+                    case ChangeType::DELETED:
+                        identifiers->remove_file(change.path);
+                        break;
+                    case ChangeType::RENAMED:
+                        identifiers->rename_file(change.old_path, change.path);
+                        break;
+                    case ChangeType::ADDED:
+                    case ChangeType::MODIFIED: {
+                        auto it = present.find(change.path);
+                        if (it != present.end()) reindex.push_back(*it->second);
+                        break;
+                    }
+                }
+            }
+            index_identifiers(reindex);
+        }
+
+        generation++;
+        for (auto& change : diff.changes) change_log.push_back({generation, std::move(change)});
+        while (change_log.size() > config.change_log_limit) {
+            log_floor = change_log.front().generation;
+            change_log.pop_front();
+        }
+    }
+
+    // ===== Requests =====
+
+    std::string handle(Opcode opcode, PayloadReader& reader, PayloadWriter& writer) {
+        switch (opcode) {
+            case Opcode::PING:
+                writer.varint(PROTOCOL_VERSION);
+                writer.varint(static_cast<uint64_t>(getpid()));
+                return "";
+            case Opcode::STATUS:
+                return handle_status(writer);
+            case Opcode::SCAN:
+                return handle_scan(reader, writer);
+            case Opcode::DIFF:
+                return handle_diff(reader, writer);
+            case Opcode::CHUNK:
+                return handle_chunk(reader, writer);
+            case Opcode::SEARCH:
+                return handle_search(reader, writer);
+            case Opcode::SHUTDOWN:
+                stopping = true;
+                return "";
+        }
+        return "Unknown opcode " + std::to_string(static_cast<int>(opcode));
+    }
+
+    std::string handle_status(PayloadWriter& writer) {
+        chunker::IdentifierIndexStats ident = identifiers->stats();
+        chunker::ChunkCacheStats cache = chunk_cache->stats();
+        writer.str(root);
+        writer.varint(generation);
+        writer.varint(files.size());
+        writer.u64(files.merkle_hash());
+        writer.u8(watcher && watcher->available() ? 1 : 0);
+        writer.varint(watcher ? watcher->watch_count() : 0);
+        writer.varint(ident.file_count);
+        writer.varint(ident.identifier_count);
+        writer.varint(ident.occurrence_count);
+        writer.varint(cache.hits + cache.spill_hits);
+        writer.varint(cache.misses);
+        writer.varint(cache.entries);
+        writer.varint(elapsed_ms(started));
+        writer.varint(startup_ms);
+        // Options as given at startup, so a client can tell whether they match its own
+        writer.varint(config.indexer.include_patterns.size());
+        for (const auto& pattern : config.indexer.include_patterns) writer.str(pattern);
+        writer.varint(config.indexer.exclude_patterns.size());
+        for (const auto& pattern : config.indexer.exclude_patterns) writer.str(pattern);
+        writer.u8(config.indexer.compute_semantic_hash ? 1 : 0);
+        writer.u8(config.index_identifiers ? 1 : 0);
+        writer.str(config.shared_index);
+        return "";
+    }
+
+    std::string handle_scan(PayloadReader& reader, PayloadWriter& writer) {
+        std::string prefix;
+        if (!reader.str(prefix)) return "Malformed SCAN request";
+        prefix = normalize_path(prefix);
+
+        std::vector<FileEntry> entries = files.get_all();
+        if (!prefix.empty()) {
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const FileEntry& e) {
+                return e.path != prefix && !under(e.path, prefix);
+            }), entries.end());
+        }
+        std::sort(entries.begin(), entries.end(), [](const FileEntry& a, const FileEntry& b) {
+            return a.path < b.path;
+        });
+
+        writer.varint(generation);
+        writer.u64(files.merkle_hash());
+        writer.varint(entries.size());
+        for (const auto& entry : entries) {
+            writer.str(entry.path);
+            writer.u64(entry.content_hash);
+            writer.varint(entry.size);
+            writer.varint(entry.mtime);
+            writer.u8(static_cast<uint8_t>(entry.language));
+            writer.u8(entry.flags);
+            writer.u64(entry.semantic_hash);
+        }
+        return "";
+    }
+
+    std::string handle_diff(PayloadReader& reader, PayloadWriter& writer) {
+        uint64_t since;
+        if (!reader.varint(since)) return "Malformed DIFF request";
+
+        writer.varint(generation);
+        if (since < log_floor || since > generation) {
+            writer.u8(0);
+            writer.varint(0);
+            return "";
+        }
+
+        // Net effect per path over the span, in path order
+        std::map<std::string, PathSpan> spans;
+        auto touch = [&](const std::string& path, bool existed, uint64_t hash) -> PathSpan& {
+            auto inserted = spans.try_emplace(path);
+            PathSpan& span = inserted.first->second;
+            if (inserted.second) {
+                span.existed = span.exists = existed;
+                span.old_hash = span.new_hash = hash;
+            }
+            return span;
+        };
+
+        auto first = std::upper_bound(change_log.begin(), change_log.end(), since,
+            [](uint64_t g, const LoggedChange& logged) { return g < logged.generation; });
+        for (auto it = first; it != change_log.end(); ++it) {
+            const FileChange& change = it->change;
+            switch (change.type) {
+                case ChangeType::ADDED: {
+                    PathSpan& span = touch(change.path, false, 0);
+                    span.exists = true;
+                    span.new_hash = change.new_hash;
+                    span.format_only = false;
+                    break;
+                }
+                case ChangeType::MODIFIED: {
+                    PathSpan& span = touch(change.path, true, change.old_hash);
+                    span.exists = true;
+                    span.new_hash = change.new_hash;
+                    if (change.kind != ChangeKind::FORMAT_ONLY) span.format_only = false;
+                    break;
+                }
+                case ChangeType::DELETED: {
+                    PathSpan& span = touch(change.path, true, change.old_hash);
+                    span.exists = false;
+                    span.format_only = false;
+                    break;
+                }
+                case ChangeType::RENAMED: {
+                    PathSpan& from = touch(change.old_path, true, change.old_hash);
+                    from.exists = false;
+                    from.format_only = false;
+                    PathSpan& to = touch(change.path, false, 0);
+                    to.exists = true;
+                    to.new_hash = change.new_hash;
+                    to.format_only = false;
+                    break;
+                }
+            }
+        }
+
+        std::vector<FileChange> changes;
+        std::unordered_multimap<uint64_t, size_t> deleted_by_hash;
+        for (const auto& [path, span] : spans) {
+            FileChange change;
+            change.path = path;
+            change.old_hash = span.existed ? span.old_hash : 0;
+            change.new_hash = span.exists ? span.new_hash : 0;
+            if (!span.existed && span.exists) {
+                change.type = ChangeType::ADDED;
+            } else if (span.existed && !span.exists) {
+                change.type = ChangeType::DELETED;
+                deleted_by_hash.emplace(span.old_hash, changes.size());
+            } else if (span.existed && span.old_hash != span.new_hash) {
+                change.type = ChangeType::MODIFIED;
+                change.kind = span.format_only ? ChangeKind::FORMAT_ONLY : ChangeKind::SEMANTIC;
+            } else {
+                continue;
+            }
+            changes.push_back(std::move(change));
+        }
+
+        // A path that disappeared and one that appeared with its content moved
+        if (indexer.get_config().detect_renames && !deleted_by_hash.empty()) {
+            std::vector<bool> dropped(changes.size(), false);
+            for (auto& change : changes) {
+                if (change.type != ChangeType::ADDED || change.new_hash == 0) continue;
+                auto it = deleted_by_hash.find(change.new_hash);
+                if (it == deleted_by_hash.end()) continue;
+                change.type = ChangeType::RENAMED;
+                change.old_path = changes[it->second].path;
+                change.old_hash = change.new_hash;
+                dropped[it->second] = true;
+                deleted_by_hash.erase(it);
+            }
+            size_t kept = 0;
+            for (size_t i = 0; i < changes.size(); i++) {
+                if (dropped[i]) continue;
+                if (kept != i) changes[kept] = std::move(changes[i]);
+                kept++;
+            }
+            changes.resize(kept);
+        }
+
+        writer.u8(1);
+        writer.varint(changes.size());
+        for (const auto& change : changes) {
+            writer.u8(static_cast<uint8_t>(change.type));
+            writer.u8(static_cast<uint8_t>(change.kind));
+            writer.str(change.path);
+            writer.str(change.old_path);
+            writer.u64(change.old_hash);
+            writer.u64(change.new_hash);
+        }
+        return "";
+    }
+
+    std::string handle_chunk(PayloadReader& reader, PayloadWriter& writer) {
+        std::string path;
+        if (!reader.str(path)) return "Malformed CHUNK request";
+        path = normalize_path(path);
+        if (under(path, root)) path.erase(0, root.size() + 1);
+
+        const FileEntry* known = files.get(path);
+        if (!known) return "Not indexed: " + path;
+        FileEntry entry = *known;
+
+        chunker::ChunkResult result = chunker.chunk_file(absolute(entry.path), entry.content_hash, entry.flags);
+        if (!result.error.empty()) return result.error;
+
+        uint8_t result_flags = (result.skipped ? CHUNK_SKIPPED : 0) | (result.degraded ? CHUNK_DEGRADED : 0);
+        writer.u8(static_cast<uint8_t>(result.language));
+        writer.u8(result.file_flags);
+        writer.u8(result_flags);
+        writer.varint(result.total_tokens);
+        writer.varint(result.total_lines);
+        writer.varint(static_cast<uint64_t>(std::max(0.0, result.chunking_time_ms) * 1000.0));
+        writer.varint(result.chunks.size());
+        for (const auto& chunk : result.chunks) {
+            writer.str(chunk.content);
+            writer.varint(chunk.token_count);
+            writer.varint(chunk.location.line_start);
+            writer.varint(chunk.location.line_end);
+            writer.varint(chunk.location.column_start);
+            writer.varint(chunk.location.column_end);
+            writer.varint(chunk.location.byte_offset);
+            writer.varint(chunk.location.byte_length);
+            writer.u8(static_cast<uint8_t>(chunk.type));
+            writer.str(chunk.context.parent_name);
+            writer.str(chunk.context.namespace_name);
+            writer.varint(chunk.context.imports.size());
+            for (const auto& import : chunk.context.imports) writer.str(import);
+            writer.varint(chunk.chunk_index);
+            writer.str(chunk.hash);
+            writer.str(chunk.id);
+        }
+        return "";
+    }
+
+    std::string handle_search(PayloadReader& reader, PayloadWriter& writer) {
+        std::string name;
+        std::string path;
+        uint8_t mode;
+        uint8_t roles;
+        uint64_t limit;
+        if (!reader.str(name) || !reader.u8(mode) || !reader.u8(roles) || !reader.str(path) || !reader.varint(limit)) {
+            return "Malformed SEARCH request";
+        }
+        if (!config.index_identifiers) return "Search index disabled";
+        path = normalize_path(path);
+        if (roles == 0) roles = chunker::IdentifierIndex::ALL_ROLES;
+
+        std::unordered_map<uint32_t, std::string> paths;
+        auto file_path = [&](uint32_t file) -> const std::string& {
+            auto it = paths.find(file);
+            if (it == paths.end()) it = paths.emplace(file, identifiers->file_path(file)).first;
+            return it->second;
+        };
+
+        if (mode == static_cast<uint8_t>(SearchMode::OCCURRENCES)) {
+            auto hits = identifiers->occurrences(name, roles, path);
+            size_t count = limit == 0 ? hits.size() : std::min<size_t>(hits.size(), limit);
+            writer.varint(hits.size());
+            writer.varint(count);
+            for (size_t i = 0; i < count; i++) {
+                writer.str(file_path(hits[i].file));
+                writer.varint(hits[i].offset);
+                writer.varint(hits[i].line);
+                writer.varint(hits[i].column);
+                writer.u8(static_cast<uint8_t>(hits[i].role));
+                writer.str("");
+                writer.str("");
+            }
+        } else if (mode == static_cast<uint8_t>(SearchMode::CALL_SITES) ||
+                   mode == static_cast<uint8_t>(SearchMode::CALLEES)) {
+            auto calls = mode == static_cast<uint8_t>(SearchMode::CALL_SITES)
+                ? identifiers->call_sites(name, path)
+                : identifiers->callees(name, path);
+            size_t count = limit == 0 ? calls.size() : std::min<size_t>(calls.size(), limit);
+            writer.varint(calls.size());
+            writer.varint(count);
+            for (size_t i = 0; i < count; i++) {
+                writer.str(file_path(calls[i].file));
+                writer.varint(calls[i].offset);
+                writer.varint(calls[i].line);
+                writer.varint(calls[i].column);
+                writer.u8(static_cast<uint8_t>(chunker::OccurrenceRole::REFERENCE));
+                writer.str(calls[i].callee);
+                writer.str(calls[i].caller);
+            }
+        } else {
+            return "Unknown search mode " + std::to_string(mode);
+        }
+        return "";
+    }
+
+    // ===== Connections =====
+
+    void accept_connections() {
+        for (;;) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0) return;
+            if (connections.size() >= config.max_clients || !set_nonblocking(fd)) {
+                close(fd);
+                continue;
+            }
+            Connection connection;
+            connection.fd = fd;
+            connections.push_back(std::move(connection));
+        }
+    }
+
+    void read_from(Connection& connection, Daemon& daemon) {
+        char buffer[64 * 1024];
+        for (;;) {
+            ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                connection.in.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) connection.closed = true;
+            if (n < 0 && errno == EINTR) continue;
+            break;
+        }
+
+        size_t consumed = 0;
+        FrameHeader header;
+        while (read_frame_header(connection.in.data() + consumed, connection.in.size() - consumed, header)) {
+            if (header.length > MAX_FRAME_SIZE) {
+                connection.closed = true;
+                break;
+            }
+            if (connection.in.size() - consumed < FRAME_HEADER_SIZE + header.length) break;
+            std::string_view payload(connection.in.data() + consumed + FRAME_HEADER_SIZE, header.length);
+            connection.out += daemon.dispatch(header.code, header.request_id, payload);
+            consumed += FRAME_HEADER_SIZE + header.length;
+        }
+        connection.in.erase(0, consumed);
+    }
+
+    void write_to(Connection& connection) {
+        size_t sent = 0;
+        while (sent < connection.out.size()) {
+            ssize_t n = send(connection.fd, connection.out.data() + sent, connection.out.size() - sent, SEND_FLAGS);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) connection.closed = true;
+                break;
+            }
+        }
+        connection.out.erase(0, sent);
+    }
+};
+
+Daemon::Daemon(const DaemonConfig& config) : impl_(std::make_unique<Impl>(config)) {}
+
+Daemon::~Daemon() = default;
+
+bool Daemon::start(std::string& error) {
+    std::error_code ec;
+    fs::path root = fs::canonical(impl_->config.root, ec);
+    if (ec || !fs::is_directory(root, ec)) {
+        error = "Invalid directory: " + impl_->config.root;
+        return false;
+    }
+    impl_->root = root.string();
+
+    // Listen first: clients that connect during indexing wait in the backlog
+    if (!impl_->listen_on_socket(error)) return false;
+    return impl_->initial_index(error);
+}
+
+int Daemon::run() {
+    Impl& d = *impl_;
+    std::vector<pollfd> fds;
+
+    while (!d.stopping) {
+        fds.clear();
+        fds.push_back({d.wake_fds[0], POLLIN, 0});
+        fds.push_back({d.listen_fd, POLLIN, 0});
+        int watch_fd = d.watcher ? d.watcher->fd() : -1;
+        fds.push_back({watch_fd, POLLIN, 0});
+        for (const auto& connection : d.connections) {
+            short events = POLLIN;
+            if (!connection.out.empty()) events |= POLLOUT;
+            fds.push_back({connection.fd, events, 0});
+        }
+
+        int timeout = -1;
+        if (d.has_pending()) {
+            uint64_t quiet = elapsed_ms(d.last_event);
+            timeout = quiet >= d.config.debounce_ms ? 0 : static_cast<int>(d.config.debounce_ms - quiet);
+        }
+
+        if (poll(fds.data(), fds.size(), timeout) < 0) {
+            if (errno == EINTR) continue;
+            return 1;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(d.wake_fds[0], drain, sizeof(drain)) > 0) {}
+        }
+        if (watch_fd >= 0 && (fds[2].revents & POLLIN)) d.collect_events();
+        if (d.has_pending() && elapsed_ms(d.last_event) >= d.config.debounce_ms) d.sync();
+
+        // Connections accepted below have no slot in fds yet
+        size_t polled = d.connections.size();
+        for (size_t i = 0; i < polled; i++) {
+            Connection& connection = d.connections[i];
+            short revents = fds[3 + i].revents;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) d.read_from(connection, *this);
+            if (!connection.out.empty()) d.write_to(connection);
+        }
+        if (fds[1].revents & POLLIN) d.accept_connections();
+
+        d.connections.erase(std::remove_if(d.connections.begin(), d.connections.end(), [](const Connection& c) {
+            if (c.closed) close(c.fd);
+            return c.closed;
+        }), d.connections.end());
+    }
+
+    // Replies to SHUTDOWN (and anything else queued) go out before the socket closes
+    for (auto& connection : d.connections) {
+        if (!connection.out.empty()) d.write_to(connection);
+    }
+    return 0;
+}
+
+void Daemon::stop() {
+    impl_->stopping = true;
+    if (impl_->wake_fds[1] >= 0) {
+        char byte = 1;
+        ssize_t written = write(impl_->wake_fds[1], &byte, 1);
+        (void)written;
+    }
+}
+
+std::string Daemon::dispatch(uint8_t opcode, uint32_t request_id, std::string_view payload) {
+    Opcode op = static_cast<Opcode>(opcode);
+    if (opcode < static_cast<uint8_t>(Opcode::PING) || opcode > static_cast<uint8_t>(Opcode::SHUTDOWN)) {
+        return error_frame(request_id, "Unknown opcode " + std::to_string(opcode));
+    }
+
+    try {
+        if (op != Opcode::PING && op != Opcode::SHUTDOWN) impl_->sync();
+
+        PayloadReader reader(payload);
+        PayloadWriter writer;
+        std::string error = impl_->handle(op, reader, writer);
+        if (!error.empty()) return error_frame(request_id, error);
+        return encode_frame(static_cast<uint8_t>(ReplyStatus::OK), request_id, writer.data());
+    } catch (const std::exception& e) {
+        return error_frame(request_id, std::string("Request failed: ") + e.what());
+    }
+}
+
+} // namespace daemon
+} // namespace archicore
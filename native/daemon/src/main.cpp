@@ -0,0 +1,88 @@
+/**
+ * @file main.cpp
+ * @brief archicore_daemon executable
+ * @version 1.0.0
+ *
+ * Usage: archicore_daemon <root> --socket <path> [options]
+ *   --include <glob>     Only index matching files (repeatable)
+ *   --exclude <glob>     Skip matching files (repeatable; replaces the defaults)
+ *   --workers <n>        Hashing and indexing threads
+ *   --cache-mb <n>       Chunk cache budget
+ *   --semantic-hash      Classify format-only modifications
+ *   --no-search          Skip the identifier index
+ *   --shared-index <name>  Publish the file index to a shared segment
+ *                          ("shm:<name>" or a file path) for other processes
+ */
+
+#include "daemon.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+archicore::daemon::Daemon* g_daemon = nullptr;
+
+void on_signal(int) {
+    if (g_daemon) g_daemon->stop();
+}
+
+int usage() {
+    std::fprintf(stderr,
+        "Usage: archicore_daemon <root> --socket <path> [--include <glob>] [--exclude <glob>]\n"
+        "                        [--workers <n>] [--cache-mb <n>] [--semantic-hash] [--no-search]\n"
+        "                        [--shared-index <name>]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    archicore::daemon::DaemonConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(arg, "--socket") == 0 && has_value) {
+            config.socket_path = argv[++i];
+        } else if (std::strcmp(arg, "--include") == 0 && has_value) {
+            config.indexer.include_patterns.push_back(argv[++i]);
+        } else if (std::strcmp(arg, "--exclude") == 0 && has_value) {
+            config.indexer.exclude_patterns.push_back(argv[++i]);
+        } else if (std::strcmp(arg, "--workers") == 0 && has_value) {
+            config.indexer.parallel_workers = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(arg, "--cache-mb") == 0 && has_value) {
+            config.chunk_cache_bytes = static_cast<uint64_t>(std::max(1, std::atoi(argv[++i]))) * 1024 * 1024;
+        } else if (std::strcmp(arg, "--semantic-hash") == 0) {
+            config.indexer.compute_semantic_hash = true;
+        } else if (std::strcmp(arg, "--no-search") == 0) {
+            config.index_identifiers = false;
+        } else if (std::strcmp(arg, "--shared-index") == 0 && has_value) {
+            config.shared_index = argv[++i];
+        } else if (arg[0] != '-' && config.root.empty()) {
+            config.root = arg;
+        } else {
+            return usage();
+        }
+    }
+    if (config.root.empty() || config.socket_path.empty()) return usage();
+
+    archicore::daemon::Daemon daemon(config);
+    std::string error;
+    if (!daemon.start(error)) {
+        std::fprintf(stderr, "archicore_daemon: %s\n", error.c_str());
+        return 1;
+    }
+
+    g_daemon = &daemon;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGHUP, SIG_IGN);
+
+    int status = daemon.run();
+    g_daemon = nullptr;
+    return status;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file protocol.cpp
+ * @brief Frame and payload encoding of the daemon protocol
+ * @version 1.0.0
+ */
+
+#include "daemon.h"
+
+namespace archicore {
+namespace daemon {
+
+namespace {
+
+void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+uint32_t get_u32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    return value;
+}
+
+} // namespace
+
+bool read_frame_header(const char* data, size_t size, FrameHeader& out) {
+    if (size < FRAME_HEADER_SIZE) return false;
+    out.length = get_u32(data);
+    out.code = static_cast<uint8_t>(data[4]);
+    out.request_id = get_u32(data + 5);
+    return true;
+}
+
+std::string encode_frame(uint8_t code, uint32_t request_id, std::string_view payload) {
+    std::string frame;
+    frame.reserve(FRAME_HEADER_SIZE + payload.size());
+    put_u32(frame, static_cast<uint32_t>(payload.size()));
+    frame.push_back(static_cast<char>(code));
+    put_u32(frame, request_id);
+    frame.append(payload.data(), payload.size());
+    return frame;
+}
+
+void PayloadWriter::u8(uint8_t value) {
+    data_.push_back(static_cast<char>(value));
+}
+
+void PayloadWriter::u64(uint64_t value) {
+    for (int i = 0; i < 8; i++) data_.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void PayloadWriter::varint(uint64_t value) {
+    while (value >= 0x80) {
+        data_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+}
+
+void PayloadWriter::str(std::string_view value) {
+    varint(value.size());
+    data_.append(value.data(), value.size());
+}
+
+bool PayloadReader::u8(uint8_t& value) {
+    if (pos_ >= data_.size()) return false;
+    value = static_cast<uint8_t>(data_[pos_++]);
+    return true;
+}
+
+bool PayloadReader::u64(uint64_t& value) {
+    if (data_.size() - pos_ < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_ + i])) << (8 * i);
+    }
+    pos_ += 8;
+    return true;
+}
+
+bool PayloadReader::varint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos_ >= data_.size()) return false;
+        uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool PayloadReader::str(std::string& value) {
+    uint64_t length;
+    if (!varint(length) || length > data_.size() - pos_) return false;
+    value.assign(data_.data() + pos_, static_cast<size_t>(length));
+    pos_ += static_cast<size_t>(length);
+    return true;
+}
+
+} // namespace daemon
+} // namespace archicore
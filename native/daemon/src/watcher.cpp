@@ -0,0 +1,196 @@
+/**
+ * @file watcher.cpp
+ * @brief Recursive directory watch over inotify
+ * @version 1.0.0
+ */
+
+#include "daemon.h"
+#include <filesystem>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace archicore {
+namespace daemon {
+
+#ifdef __linux__
+
+namespace {
+
+std::string join(const std::string& dir, const std::string& name) {
+    return dir.empty() ? name : dir + "/" + name;
+}
+
+bool under(const std::string& path, const std::string& dir) {
+    return path == dir || (path.size() > dir.size() && path[dir.size()] == '/' &&
+                           path.compare(0, dir.size(), dir) == 0);
+}
+
+} // namespace
+
+struct TreeWatcher::Impl {
+    std::string root;
+    int fd = -1;
+    std::unordered_map<int, std::string> dirs;     // wd -> directory relative to root
+
+    static constexpr uint32_t MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+                                     IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                                     IN_MOVE_SELF | IN_DONT_FOLLOW | IN_ONLYDIR;
+
+    void drop_tree(const std::string& rel_dir) {
+        for (auto it = dirs.begin(); it != dirs.end();) {
+            if (under(it->second, rel_dir)) {
+                inotify_rm_watch(fd, it->first);
+                it = dirs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+TreeWatcher::TreeWatcher(const std::string& root) : impl_(std::make_unique<Impl>()) {
+    impl_->root = root;
+    impl_->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+TreeWatcher::~TreeWatcher() {
+    if (impl_->fd >= 0) close(impl_->fd);
+}
+
+bool TreeWatcher::available() const {
+    return impl_->fd >= 0;
+}
+
+int TreeWatcher::fd() const {
+    return impl_->fd;
+}
+
+bool TreeWatcher::add_tree(const std::string& rel_dir,
+                           const std::function<bool(const std::string&)>& skip_dir,
+                           std::vector<std::string>& files) {
+    if (impl_->fd < 0) return false;
+
+    // Watch before listing, so files created in between are not missed
+    std::vector<std::string> pending{rel_dir};
+    while (!pending.empty()) {
+        std::string dir = std::move(pending.back());
+        pending.pop_back();
+
+        std::string abs = dir.empty() ? impl_->root : impl_->root + "/" + dir;
+        int wd = inotify_add_watch(impl_->fd, abs.c_str(), Impl::MASK);
+        if (wd < 0) {
+            if (errno == ENOSPC || errno == ENOMEM) {
+                close(impl_->fd);
+                impl_->fd = -1;
+                impl_->dirs.clear();
+                return false;
+            }
+            continue;   // Vanished or unreadable
+        }
+        impl_->dirs[wd] = dir;
+
+        std::error_code ec;
+        for (fs::directory_iterator it(abs, ec), end; !ec && it != end; it.increment(ec)) {
+            std::string rel = join(dir, it->path().filename().string());
+            std::error_code type_ec;
+            if (it->is_symlink(type_ec)) {
+                if (it->is_regular_file(type_ec)) files.push_back(rel);
+            } else if (it->is_directory(type_ec)) {
+                if (!skip_dir(rel)) pending.push_back(rel);
+            } else if (it->is_regular_file(type_ec)) {
+                files.push_back(rel);
+            }
+        }
+    }
+    return true;
+}
+
+bool TreeWatcher::read_events(std::vector<WatchEvent>& events) {
+    if (impl_->fd < 0) return true;
+
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    bool complete = true;
+    for (;;) {
+        ssize_t n = read(impl_->fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+
+        for (char* p = buffer; p < buffer + n;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                complete = false;
+                continue;
+            }
+            auto it = impl_->dirs.find(event->wd);
+            if (it == impl_->dirs.end()) continue;
+
+            if (event->mask & IN_IGNORED) {
+                impl_->dirs.erase(it);
+                continue;
+            }
+            if (event->mask & IN_MOVE_SELF) {
+                // The directory lives elsewhere now; its parent reports the move
+                impl_->drop_tree(it->second);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            WatchEvent change;
+            change.is_dir = (event->mask & IN_ISDIR) != 0;
+            if (change.is_dir && !(event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO))) {
+                continue;   // Attribute changes of subdirectories
+            }
+            change.path = join(it->second, event->name);
+            change.removed = (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+            if (change.is_dir && change.removed) impl_->drop_tree(change.path);
+            events.push_back(std::move(change));
+        }
+    }
+    return complete;
+}
+
+size_t TreeWatcher::watch_count() const {
+    return impl_->dirs.size();
+}
+
+#else
+
+struct TreeWatcher::Impl {};
+
+TreeWatcher::TreeWatcher(const std::string&) : impl_(std::make_unique<Impl>()) {}
+
+TreeWatcher::~TreeWatcher() = default;
+
+bool TreeWatcher::available() const {
+    return false;
+}
+
+int TreeWatcher::fd() const {
+    return -1;
+}
+
+bool TreeWatcher::add_tree(const std::string&, const std::function<bool(const std::string&)>&,
+                           std::vector<std::string>&) {
+    return false;
+}
+
+bool TreeWatcher::read_events(std::vector<WatchEvent>&) {
+    return true;
+}
+
+size_t TreeWatcher::watch_count() const {
+    return 0;
+}
+
+#endif
+
+} // namespace daemon
+} // namespace archicore
@@ -0,0 +1,703 @@
+/**
+ * @file graph.h
+ * @brief Dependency Graph Engine for ArchiCore
+ * @version 1.0.0
+ *
+ * Native queries over the code dependency graph:
+ * - Reachability index (SCC condensation + bitset transitive closure)
+ * - Depth-bounded dependent search for impact analysis
+ * - Incremental edge and node updates
+ * - Parallel analytics over a CSR graph (PageRank, betweenness, SCC, k-core)
+ * - Bounded cycle enumeration per strongly connected component
+ * - Incremental architecture rule evaluation over node group bitsets
+ * - Streaming JSON / GraphML / CSV export from a compact graph copy
+ * - Import of exported documents through a SIMD structural index
+ */
+
+#ifndef ARCHICORE_GRAPH_H
+#define ARCHICORE_GRAPH_H
+
+#include "common.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+
+namespace archicore {
+namespace graph {
+
+/**
+ * @brief Marker for a node id that is not in the graph
+ */
+static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+/**
+ * @brief Iterative Tarjan strongly connected components
+ *
+ * Components are numbered in completion order, so every component comes
+ * after all components it has edges into (dependencies first).
+ * @param n Node count
+ * @param successors successors(node) returns an iterable range of node indices
+ * @param component Output: component index per node
+ * @return Number of components
+ */
+template <typename Successors>
+uint32_t tarjan_scc(uint32_t n, const Successors& successors, std::vector<uint32_t>& component) {
+    constexpr uint32_t unvisited = UINT32_MAX;
+    component.assign(n, unvisited);
+
+    std::vector<uint32_t> index(n, unvisited);
+    std::vector<uint32_t> low(n, 0);
+    std::vector<bool> on_stack(n, false);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> calls;  // (node, next successor)
+    uint32_t counter = 0;
+    uint32_t count = 0;
+
+    for (uint32_t root = 0; root < n; root++) {
+        if (index[root] != unvisited) continue;
+        calls.push_back({root, 0});
+
+        while (!calls.empty()) {
+            uint32_t node = calls.back().first;
+            uint32_t edge = calls.back().second;
+            if (edge == 0) {
+                index[node] = low[node] = counter++;
+                stack.push_back(node);
+                on_stack[node] = true;
+            }
+
+            const auto& next_nodes = successors(node);
+            auto it = std::begin(next_nodes) + edge;
+            if (it != std::end(next_nodes)) {
+                uint32_t next = *it;
+                // edge is past 0 from here on, so the node is not re-entered
+                calls.back().second = edge + 1;
+                if (index[next] == unvisited) {
+                    calls.push_back({next, 0});
+                } else if (on_stack[next]) {
+                    low[node] = std::min(low[node], index[next]);
+                }
+                continue;
+            }
+
+            if (low[node] == index[node]) {
+                uint32_t member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    component[member] = count;
+                } while (member != node);
+                count++;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                uint32_t parent = calls.back().first;
+                low[parent] = std::min(low[parent], low[node]);
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief A node reached by a dependent search
+ */
+struct AffectedNode {
+    uint32_t node;          // Dense node index
+    uint32_t distance;      // Edges from the nearest changed node (0 = changed itself)
+};
+
+/**
+ * @brief Reachability index statistics
+ */
+struct ReachabilityStats {
+    uint32_t node_count = 0;
+    uint64_t edge_count = 0;
+    uint32_t component_count = 0;   // Strongly connected components
+    uint32_t largest_component = 0; // Nodes in the largest cycle group
+    bool has_closure = false;       // Bitset closure built (component count within the limit)
+    uint64_t closure_bytes = 0;
+    uint32_t rebuilds = 0;          // Full rebuilds since construction
+    double build_time_ms = 0;       // Duration of the last rebuild
+};
+
+/**
+ * @brief Configuration for the reachability index
+ */
+struct ReachabilityConfig {
+    uint32_t closure_limit = 16384;  // Max components for the bitset closure (limit^2/8 bytes)
+};
+
+/**
+ * @brief Reachability index over a directed dependency graph
+ *
+ * An edge from -> to means "from depends on to"; changing `to` affects
+ * `from`. Nodes are interned string ids with dense indices.
+ *
+ * The graph is condensed into strongly connected components (Tarjan), and
+ * for up to closure_limit components each component keeps a bitset of the
+ * components that transitively depend on it. depends_on() is then a single
+ * bit test and affected_set() an OR of rows. Depth-bounded searches with
+ * distances run a BFS over reverse adjacency lists, touching only the
+ * nodes they return.
+ *
+ * Adding an edge that keeps the condensation acyclic updates the closure
+ * in place; adding a node appends a row. Removing an edge, or an edge that
+ * closes a cycle, marks the index stale and it is rebuilt on the next
+ * query. All methods are thread-safe.
+ */
+class ReachabilityIndex {
+public:
+    explicit ReachabilityIndex(const ReachabilityConfig& config = ReachabilityConfig{});
+    ~ReachabilityIndex();
+
+    /**
+     * @brief Add a node, or find it if present
+     * @param id Node id
+     * @return Dense node index
+     */
+    uint32_t add_node(const std::string& id);
+
+    /**
+     * @brief Find a node
+     * @param id Node id
+     * @return Dense node index, or NO_NODE
+     */
+    uint32_t find_node(const std::string& id) const;
+
+    /**
+     * @brief Id of a node
+     * @param node Dense node index
+     * @return Node id (empty if out of range)
+     */
+    std::string node_id(uint32_t node) const;
+
+    /**
+     * @brief Add a dependency edge, adding missing nodes
+     * @param from Dependent node id
+     * @param to Dependency node id
+     * @return false if the edge already existed
+     */
+    bool add_edge(const std::string& from, const std::string& to);
+
+    /**
+     * @brief Remove a dependency edge
+     * @return false if the edge did not exist
+     */
+    bool remove_edge(const std::string& from, const std::string& to);
+
+    /**
+     * @brief Remove all nodes and edges
+     */
+    void clear();
+
+    /**
+     * @brief Whether from transitively depends on to (a node depends on itself)
+     */
+    bool depends_on(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Nodes affected by changing the given nodes, with distances
+     * @param changed Changed node indices (distance 0)
+     * @param max_depth Maximum distance (0 = unbounded)
+     * @return Affected nodes in BFS order, each at its shortest distance
+     */
+    std::vector<AffectedNode> affected(const std::vector<uint32_t>& changed, uint32_t max_depth) const;
+
+    /**
+     * @brief All nodes that transitively depend on any of the given nodes
+     *
+     * Answered from the closure when it is built; the changed nodes are
+     * included.
+     * @param changed Changed node indices
+     * @return Node indices, ascending
+     */
+    std::vector<uint32_t> affected_set(const std::vector<uint32_t>& changed) const;
+
+    /**
+     * @brief Strongly connected component index of a node
+     *
+     * Nodes in a dependency cycle share a component. Indices are stable
+     * until the next rebuild.
+     */
+    uint32_t component_of(uint32_t node) const;
+
+    /**
+     * @brief Node and edge counts, component and closure figures
+     */
+    ReachabilityStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Compressed sparse row adjacency
+ */
+struct CsrGraph {
+    std::vector<uint32_t> offsets;  // Node -> first entry in targets (node_count + 1)
+    std::vector<uint32_t> targets;  // Neighbours, ascending per node
+
+    struct Range {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    uint32_t node_count() const { return offsets.empty() ? 0 : static_cast<uint32_t>(offsets.size() - 1); }
+    size_t edge_count() const { return targets.size(); }
+    uint32_t degree(uint32_t node) const { return offsets[node + 1] - offsets[node]; }
+    Range neighbors(uint32_t node) const {
+        return {targets.data() + offsets[node], targets.data() + offsets[node + 1]};
+    }
+
+    /**
+     * @brief Build from an edge list; duplicate edges and self-loops are dropped
+     * @param n Node count
+     * @param edges (source, target) pairs
+     * @param reverse Store target -> source instead
+     */
+    static CsrGraph from_edges(uint32_t n, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                               bool reverse = false);
+};
+
+/**
+ * @brief A node with an analytics score
+ */
+struct RankedNode {
+    uint32_t node;
+    double score;
+};
+
+/**
+ * @brief Configuration for graph analytics
+ */
+struct AnalyticsConfig {
+    uint32_t num_workers = 4;
+    double damping = 0.85;              // PageRank damping factor
+    uint32_t max_iterations = 100;      // PageRank iteration cap
+    double tolerance = 1e-6;            // PageRank L1 convergence threshold
+    uint32_t betweenness_samples = 128; // Brandes sources (0 or >= node count = exact)
+    uint64_t seed = 42;                 // Source sampling seed
+};
+
+/**
+ * @brief Analytics run statistics
+ */
+struct AnalyticsStats {
+    uint32_t node_count = 0;
+    uint64_t edge_count = 0;
+    uint32_t pagerank_iterations = 0;   // Iterations of the last PageRank run
+    uint32_t betweenness_sources = 0;   // Sources of the last betweenness run
+    double build_time_ms = 0;           // CSR build
+    double last_run_ms = 0;             // Last analytics call
+};
+
+/**
+ * @brief Whole-graph analytics for hotspot ranking
+ *
+ * Edges are collected as added and frozen into forward and reverse CSR
+ * arrays on the first query (again after further additions). An edge
+ * from -> to means "from depends on to", so rank flows from dependents
+ * to their dependencies.
+ *
+ * Scores are indexed by dense node index. PageRank and betweenness split
+ * their work across num_workers threads. Calls are serialized by a mutex.
+ */
+class GraphAnalytics {
+public:
+    explicit GraphAnalytics(const AnalyticsConfig& config = AnalyticsConfig{});
+    ~GraphAnalytics();
+
+    uint32_t add_node(const std::string& id);
+    uint32_t find_node(const std::string& id) const;
+    std::string node_id(uint32_t node) const;
+
+    /**
+     * @brief Add a dependency edge, adding missing nodes
+     */
+    void add_edge(const std::string& from, const std::string& to);
+
+    void clear();
+
+    /**
+     * @brief PageRank; dangling mass is spread evenly. Scores sum to 1.
+     */
+    std::vector<double> pagerank();
+
+    /**
+     * @brief Directed betweenness centrality (Brandes)
+     *
+     * With fewer sampled sources than nodes, the sum over samples is scaled
+     * by node_count / samples to estimate the exact value.
+     */
+    std::vector<double> betweenness();
+
+    /**
+     * @brief Strongly connected components
+     * @param count Output: number of components
+     * @return Component index per node
+     */
+    std::vector<uint32_t> strongly_connected(uint32_t& count);
+
+    /**
+     * @brief Core number per node of the undirected graph (k-core decomposition)
+     */
+    std::vector<uint32_t> core_numbers();
+
+    AnalyticsStats stats() const;
+
+    /**
+     * @brief Highest scores first; ties by node index
+     * @param limit Maximum results (0 = all)
+     */
+    static std::vector<RankedNode> top(const std::vector<double>& scores, size_t limit);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Limits for cycle enumeration
+ */
+struct CycleConfig {
+    uint32_t max_cycles = 50;               // Total cycles returned
+    uint32_t max_cycles_per_component = 10; // Cycles kept per strongly connected component
+    uint32_t max_length = 0;                // Max nodes in a cycle (0 = unbounded)
+    uint64_t max_steps = 2000000;           // Edge visits across the whole search
+};
+
+/**
+ * @brief Cycle enumeration result
+ */
+struct CycleResult {
+    std::vector<std::vector<uint32_t>> cycles;  // Node sequences; the first node is not repeated
+    uint32_t cyclic_components = 0;             // Components with at least one cycle
+    uint64_t steps = 0;                         // Edge visits used
+    bool truncated = false;                     // A limit stopped the search early
+};
+
+/**
+ * @brief Enumerate simple cycles, shortest first per component
+ *
+ * Only strongly connected components with two or more nodes can hold a
+ * cycle, so each is searched on its own, largest first. Every component
+ * first gets its shortest cycle from breadth-first searches, then one
+ * pass of Johnson's algorithm (iterative, with blocking sets) keeps the
+ * component's share of shortest cycles up to max_length, within an even
+ * share of the remaining steps. Cycles of a component are returned by
+ * increasing length and rotated to start at their smallest node.
+ *
+ * @param graph Forward adjacency (self-loops are not reported)
+ * @param config Count, length and step limits
+ */
+CycleResult find_cycles(const CsrGraph& graph, const CycleConfig& config = CycleConfig{});
+
+/**
+ * @brief Kinds of architecture rule checked natively
+ */
+enum class RuleKind : uint8_t {
+    FORBIDDEN_DEPENDENCY,   // No edge from the source group into the target group
+    LAYER_BOUNDARY,         // Edges between layers must be allowed
+    MAX_DEPENDENCIES        // At most `limit` dependencies per node
+};
+
+/**
+ * @brief A rule violation found by the evaluator
+ */
+struct RuleViolation {
+    uint32_t rule;              // Rule index
+    uint32_t from;              // Source node
+    uint32_t to;                // Target node (NO_NODE for node rules)
+    uint32_t source_layer;      // Layer rules: layer index of from
+    uint32_t target_layer;      // Layer rules: layer index of to
+    uint32_t count;             // Max-dependency rules: dependencies of from
+};
+
+/**
+ * @brief Rule evaluator statistics
+ */
+struct RuleEvaluatorStats {
+    uint32_t node_count = 0;
+    uint64_t edge_count = 0;
+    uint32_t group_count = 0;
+    uint32_t rule_count = 0;
+    uint32_t rules_evaluated = 0;   // Rules with work in the last evaluate()
+    uint32_t nodes_rechecked = 0;   // Source nodes checked in the last evaluate()
+    uint32_t violation_count = 0;
+    double eval_time_ms = 0;        // Duration of the last evaluate()
+};
+
+/**
+ * @brief Incremental evaluator for dependency and layer rules
+ *
+ * Nodes carry a path and belong to groups, each a bitset over nodes:
+ * glob groups match node paths with compiled GlobMatchers (on add and on
+ * path change), explicit groups are maintained by the caller. Rules refer
+ * to groups; every rule keeps its violations per source node.
+ *
+ * Changing a node's dependencies marks it dirty; changing its group
+ * membership marks it and its dependents dirty. evaluate() re-checks only
+ * dirty nodes within each rule's source scope, and rules added since the
+ * last call in full. All methods are thread-safe.
+ */
+class RuleEvaluator {
+public:
+    static constexpr uint32_t MAX_LAYERS = 64;
+
+    RuleEvaluator();
+    ~RuleEvaluator();
+
+    /**
+     * @brief Add a node, or update the path of an existing one
+     * @param id Node id
+     * @param path Path matched by glob groups
+     * @return Dense node index
+     */
+    uint32_t add_node(const std::string& id, const std::string& path);
+
+    uint32_t find_node(const std::string& id) const;
+    std::string node_id(uint32_t node) const;
+
+    /**
+     * @brief Replace the dependencies of a node, adding missing nodes
+     *
+     * Targets are stored deduplicated; the count of targets as given is
+     * what max-dependency rules compare.
+     * @param from Dependent node id
+     * @param targets Dependency node ids
+     */
+    void set_dependencies(const std::string& from, const std::vector<std::string>& targets);
+
+    /**
+     * @brief Add a group of nodes whose path matches any of the globs
+     * @return Group index
+     */
+    uint32_t add_glob_group(const std::vector<std::string>& globs);
+
+    /**
+     * @brief Add an empty group maintained with set_member()
+     * @return Group index
+     */
+    uint32_t add_group();
+
+    /**
+     * @brief Add or remove a node from an explicit group
+     * @return false if the group is unknown or a glob group
+     */
+    bool set_member(uint32_t group, uint32_t node, bool member);
+
+    /**
+     * @brief Forbid dependencies from source_group into target_group
+     * @return Rule index, or NO_NODE for unknown groups
+     */
+    uint32_t add_forbidden_rule(uint32_t source_group, uint32_t target_group);
+
+    /**
+     * @brief Layer boundary rule
+     *
+     * A node belongs to the first layer whose group contains it. An edge
+     * between two different layers is a violation unless bit t of
+     * allowed[s] is set for source layer s and target layer t.
+     * @param layer_groups Group per layer (at most MAX_LAYERS)
+     * @param allowed Allowed target layers per layer, as bit masks
+     * @return Rule index, or NO_NODE for an invalid definition
+     */
+    uint32_t add_layer_rule(const std::vector<uint32_t>& layer_groups, const std::vector<uint64_t>& allowed);
+
+    /**
+     * @brief Limit the dependency count of nodes (in group, or all with NO_NODE)
+     * @return Rule index, or NO_NODE for an unknown group
+     */
+    uint32_t add_max_dependencies_rule(uint32_t limit, uint32_t group = NO_NODE);
+
+    /**
+     * @brief Re-check dirty nodes and return all current violations
+     * @return Violations ordered by rule, source node and target node
+     */
+    std::vector<RuleViolation> evaluate();
+
+    /**
+     * @brief Remove all nodes, groups and rules
+     */
+    void clear();
+
+    RuleEvaluatorStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Output formats of GraphExporter
+ */
+enum class ExportFormat : uint8_t {
+    JSON,       // {"nodes":{id:node},"edges":{from:[edge]}}, compact
+    GRAPHML,    // Node label/type and edge type data, as ExportManager writes it
+    CSV         // Edge list: from,to,type,weight
+};
+
+/**
+ * @brief A node as passed to GraphExporter
+ */
+struct ExportNode {
+    std::string id;
+    std::string type;
+    std::string file_path;
+    std::string name;
+    std::string domain;             // metadata.domain ("" = absent)
+    double lines_of_code = -1;      // metadata.linesOfCode (negative = absent)
+    double complexity = -1;         // metadata.complexity (negative = absent)
+};
+
+/**
+ * @brief An edge as passed to GraphExporter
+ */
+struct ExportEdge {
+    std::string to;
+    std::string type;
+    double weight = 1;
+};
+
+/**
+ * @brief Exporter statistics
+ */
+struct GraphExporterStats {
+    uint32_t node_count = 0;
+    uint64_t edge_count = 0;
+    uint64_t memory_bytes = 0;      // Estimated size of the graph copy
+    uint64_t bytes_written = 0;     // Output of the current or last export
+};
+
+/**
+ * @brief Streaming exporter over a compact copy of the dependency graph
+ *
+ * Ids are interned once; an edge is a fixed-size record, so a graph with
+ * millions of edges costs a few dozen bytes per edge instead of one JS
+ * object each. Output is produced record by record: read() appends
+ * chunks of bounded size (for piping through compression), write_file()
+ * streams to a file through one reusable buffer. Strings are escaped for
+ * the format with 16-byte SSE2 scans where available.
+ *
+ * Adding nodes or edges ends an export in progress. Thread-safe.
+ */
+class GraphExporter {
+public:
+    GraphExporter();
+    ~GraphExporter();
+
+    /**
+     * @brief Add a node; an existing id is updated in place
+     */
+    void add_node(const ExportNode& node);
+
+    /**
+     * @brief Append the outgoing edges of one source (one group per call, like DependencyGraph.edges)
+     */
+    void add_edges(const std::string& from, const std::vector<ExportEdge>& edges);
+
+    /**
+     * @brief Start an export; read() then yields its output
+     */
+    void begin(ExportFormat format);
+
+    /**
+     * @brief Append the next records of the export to out
+     * @param out Receives at least one record unless the export is finished
+     * @param max_bytes Stop once out holds this many bytes
+     * @return false if the export was already finished
+     */
+    bool read(std::string& out, size_t max_bytes);
+
+    /**
+     * @brief Export the whole graph to a file
+     * @return Bytes written, or -1 if the file could not be written
+     */
+    int64_t write_file(const std::string& path, ExportFormat format);
+
+    void clear();
+
+    GraphExporterStats stats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Graph tables read from an exported analysis document
+ *
+ * Every string (ids, paths, names, types) is stored once in a UTF-8 pool;
+ * the columns hold pool indices. Edges keep document order, so runs with
+ * the same edge_from are the edge lists of the export.
+ */
+struct ImportedGraph {
+    std::string strings;                    // UTF-8 pool
+    std::vector<uint32_t> string_offsets;   // Start of string i in the pool; size = count + 1
+
+    std::vector<uint32_t> node_id;
+    std::vector<uint32_t> node_type;
+    std::vector<uint32_t> node_file_path;
+    std::vector<uint32_t> node_name;
+    std::vector<uint32_t> node_domain;      // NO_NODE = absent
+    std::vector<double> node_lines_of_code; // NaN = absent
+    std::vector<double> node_complexity;    // NaN = absent
+
+    std::vector<uint32_t> edge_from;
+    std::vector<uint32_t> edge_to;
+    std::vector<uint32_t> edge_type;
+    std::vector<double> edge_weight;
+};
+
+/**
+ * @brief A top-level value of the document other than the graph, as raw JSON
+ */
+struct ExportSection {
+    std::string key;
+    std::string json;
+};
+
+/**
+ * @brief Result of reading an exported analysis document
+ */
+struct ExportDocument {
+    bool has_graph = false;
+    ImportedGraph graph;
+    std::vector<ExportSection> sections;
+    std::string error;                      // Empty on success
+    uint64_t error_offset = 0;              // Byte offset of the error
+};
+
+/**
+ * @brief Read an export produced by ExportManager (pretty-printed or streamed)
+ *
+ * A 64-byte-block structural index (quotes and brackets outside strings,
+ * found with SSE2 compares and prefix XOR) is built one window at a time,
+ * and a pull parser walks it: graph nodes and edges go straight into
+ * ImportedGraph, other sections are skipped bracket to bracket and kept
+ * as raw JSON. Memory beyond the input is the tables plus one window.
+ *
+ * @return false on malformed input (see ExportDocument::error)
+ */
+bool read_export(std::string_view json, ExportDocument& out);
+
+/**
+ * @brief read_export over a memory-mapped file
+ */
+bool read_export_file(const std::string& path, ExportDocument& out);
+
+} // namespace graph
+} // namespace archicore
+
+#endif // ARCHICORE_GRAPH_H
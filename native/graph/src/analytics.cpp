@@ -0,0 +1,442 @@
+/**
+ * @file analytics.cpp
+ * @brief Parallel graph analytics over CSR adjacency for hotspot ranking
+ * @version 1.0.0
+ */
+
+#include "graph.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace archicore {
+namespace graph {
+
+// Nodes per work item; fixed so reductions sum in the same order for any
+// worker count
+static constexpr uint32_t CHUNK_SIZE = 4096;
+
+/**
+ * @brief Run work(chunk, begin, end) over [0, count) in CHUNK_SIZE pieces
+ * @return Number of chunks
+ */
+template<typename Work>
+static size_t run_chunks(uint32_t count, uint32_t num_workers, Work work) {
+    size_t chunks = (static_cast<size_t>(count) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    num_workers = std::min(num_workers, std::thread::hardware_concurrency());
+    num_workers = std::max(num_workers, 1u);
+    num_workers = static_cast<uint32_t>(std::min<size_t>(num_workers, chunks));
+
+    auto run = [&](size_t chunk) {
+        uint32_t begin = static_cast<uint32_t>(chunk * CHUNK_SIZE);
+        uint32_t end = std::min(count, begin + CHUNK_SIZE);
+        work(chunk, begin, end);
+    };
+
+    if (num_workers <= 1) {
+        for (size_t chunk = 0; chunk < chunks; chunk++) run(chunk);
+        return chunks;
+    }
+
+    std::vector<std::future<void>> futures;
+    std::atomic<size_t> next_chunk{0};
+    for (uint32_t w = 0; w < num_workers; w++) {
+        futures.push_back(std::async(std::launch::async, [&]() {
+            size_t chunk;
+            while ((chunk = next_chunk.fetch_add(1)) < chunks) run(chunk);
+        }));
+    }
+    for (auto& f : futures) f.wait();
+    return chunks;
+}
+
+CsrGraph CsrGraph::from_edges(uint32_t n, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                              bool reverse) {
+    CsrGraph csr;
+    csr.offsets.assign(static_cast<size_t>(n) + 1, 0);
+
+    for (const auto& [a, b] : edges) {
+        if (a == b) continue;
+        csr.offsets[(reverse ? b : a) + 1]++;
+    }
+    for (uint32_t node = 0; node < n; node++) csr.offsets[node + 1] += csr.offsets[node];
+
+    csr.targets.resize(csr.offsets[n]);
+    std::vector<uint32_t> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+    for (const auto& [a, b] : edges) {
+        if (a == b) continue;
+        uint32_t source = reverse ? b : a;
+        csr.targets[cursor[source]++] = reverse ? a : b;
+    }
+
+    // Sort and deduplicate each row, compacting in place
+    uint32_t write = 0;
+    for (uint32_t node = 0; node < n; node++) {
+        uint32_t* first = csr.targets.data() + csr.offsets[node];
+        uint32_t* last = csr.targets.data() + csr.offsets[node + 1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        csr.offsets[node] = write;
+        for (uint32_t* it = first; it != last; ++it) csr.targets[write++] = *it;
+    }
+    csr.offsets[n] = write;
+    csr.targets.resize(write);
+    csr.targets.shrink_to_fit();
+
+    return csr;
+}
+
+struct GraphAnalytics::Impl {
+    AnalyticsConfig config;
+
+    std::vector<std::string> ids;
+    std::unordered_map<std::string, uint32_t> index_of;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    // Frozen on the first query after a change
+    bool dirty = true;
+    CsrGraph out;   // Dependencies of each node
+    CsrGraph in;    // Dependents of each node
+
+    AnalyticsStats stats;
+    mutable std::mutex mutex;
+
+    explicit Impl(const AnalyticsConfig& cfg) : config(cfg) {}
+
+    uint32_t add_node(const std::string& id) {
+        auto it = index_of.find(id);
+        if (it != index_of.end()) return it->second;
+
+        uint32_t node = static_cast<uint32_t>(ids.size());
+        ids.push_back(id);
+        index_of.emplace(id, node);
+        dirty = true;
+        return node;
+    }
+
+    void freeze() {
+        if (!dirty) return;
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        uint32_t n = static_cast<uint32_t>(ids.size());
+        out = CsrGraph::from_edges(n, edges);
+        in = CsrGraph::from_edges(n, edges, true);
+        dirty = false;
+
+        auto end_time = std::chrono::high_resolution_clock::now();
+        stats.node_count = n;
+        stats.edge_count = out.edge_count();
+        stats.build_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    }
+
+    std::vector<double> pagerank() {
+        uint32_t n = out.node_count();
+        stats.pagerank_iterations = 0;
+        if (n == 0) return {};
+
+        double d = config.damping;
+        std::vector<double> rank(n, 1.0 / n);
+        std::vector<double> next(n);
+        std::vector<double> contribution(n);
+        std::vector<double> partial((n + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+        for (uint32_t iteration = 0; iteration < config.max_iterations; iteration++) {
+            // Share of each node per dependency; dangling nodes keep theirs
+            size_t chunks = run_chunks(n, config.num_workers, [&](size_t chunk, uint32_t begin, uint32_t end) {
+                double dangling = 0;
+                for (uint32_t u = begin; u < end; u++) {
+                    uint32_t degree = out.degree(u);
+                    if (degree == 0) {
+                        dangling += rank[u];
+                        contribution[u] = 0;
+                    } else {
+                        contribution[u] = rank[u] / degree;
+                    }
+                }
+                partial[chunk] = dangling;
+            });
+            double dangling = std::accumulate(partial.begin(), partial.begin() + chunks, 0.0);
+            double base = (1.0 - d) / n + d * dangling / n;
+
+            run_chunks(n, config.num_workers, [&](size_t chunk, uint32_t begin, uint32_t end) {
+                double delta = 0;
+                for (uint32_t v = begin; v < end; v++) {
+                    double sum = 0;
+                    for (uint32_t u : in.neighbors(v)) sum += contribution[u];
+                    next[v] = base + d * sum;
+                    delta += std::fabs(next[v] - rank[v]);
+                }
+                partial[chunk] = delta;
+            });
+
+            rank.swap(next);
+            stats.pagerank_iterations = iteration + 1;
+            if (std::accumulate(partial.begin(), partial.begin() + chunks, 0.0) < config.tolerance) break;
+        }
+
+        return rank;
+    }
+
+    std::vector<double> betweenness() {
+        uint32_t n = out.node_count();
+        std::vector<double> centrality(n, 0.0);
+        stats.betweenness_sources = 0;
+        if (n == 0) return centrality;
+
+        std::vector<uint32_t> sources(n);
+        std::iota(sources.begin(), sources.end(), 0);
+        uint32_t samples = config.betweenness_samples;
+        if (samples > 0 && samples < n) {
+            // Partial Fisher-Yates: the first `samples` entries are a uniform sample
+            std::mt19937_64 rng(config.seed);
+            for (uint32_t i = 0; i < samples; i++) {
+                std::uniform_int_distribution<uint32_t> pick(i, n - 1);
+                std::swap(sources[i], sources[pick(rng)]);
+            }
+            sources.resize(samples);
+        }
+        stats.betweenness_sources = static_cast<uint32_t>(sources.size());
+
+        uint32_t num_workers = std::min(config.num_workers, std::thread::hardware_concurrency());
+        num_workers = std::max(num_workers, 1u);
+        num_workers = std::min<uint32_t>(num_workers, static_cast<uint32_t>(sources.size()));
+
+        // Sources are striped over workers, each with its own accumulator
+        std::vector<std::vector<double>> partials(num_workers);
+        auto work = [&](uint32_t worker) {
+            std::vector<double>& local = partials[worker];
+            local.assign(n, 0.0);
+            std::vector<double> sigma(n, 0.0);
+            std::vector<double> delta(n, 0.0);
+            std::vector<int32_t> dist(n, -1);
+            std::vector<uint32_t> order;
+            order.reserve(n);
+
+            for (size_t i = worker; i < sources.size(); i += num_workers) {
+                uint32_t s = sources[i];
+                order.clear();
+                sigma[s] = 1;
+                dist[s] = 0;
+                order.push_back(s);
+
+                // order doubles as the BFS queue
+                for (size_t head = 0; head < order.size(); head++) {
+                    uint32_t v = order[head];
+                    for (uint32_t w : out.neighbors(v)) {
+                        if (dist[w] < 0) {
+                            dist[w] = dist[v] + 1;
+                            order.push_back(w);
+                        }
+                        if (dist[w] == dist[v] + 1) sigma[w] += sigma[v];
+                    }
+                }
+
+                // Predecessors are the dependents one level closer to s
+                for (size_t k = order.size(); k-- > 1;) {
+                    uint32_t w = order[k];
+                    double share = (1.0 + delta[w]) / sigma[w];
+                    for (uint32_t v : in.neighbors(w)) {
+                        if (dist[v] == dist[w] - 1) delta[v] += sigma[v] * share;
+                    }
+                    local[w] += delta[w];
+                }
+
+                for (uint32_t v : order) {
+                    sigma[v] = 0;
+                    delta[v] = 0;
+                    dist[v] = -1;
+                }
+            }
+        };
+
+        if (num_workers <= 1) {
+            work(0);
+        } else {
+            std::vector<std::future<void>> futures;
+            for (uint32_t w = 0; w < num_workers; w++) {
+                futures.push_back(std::async(std::launch::async, work, w));
+            }
+            for (auto& f : futures) f.wait();
+        }
+
+        double scale = sources.size() < n ? static_cast<double>(n) / sources.size() : 1.0;
+        for (const auto& local : partials) {
+            for (uint32_t v = 0; v < n; v++) centrality[v] += local[v];
+        }
+        for (double& value : centrality) value *= scale;
+
+        return centrality;
+    }
+
+    /**
+     * @brief Batagelj-Zaversnik bucket decomposition, O(V + E)
+     */
+    std::vector<uint32_t> core_numbers() {
+        uint32_t n = out.node_count();
+
+        // Undirected neighbours: union of the sorted dependency and dependent rows
+        CsrGraph undirected;
+        undirected.offsets.assign(static_cast<size_t>(n) + 1, 0);
+        undirected.targets.reserve(out.edge_count() * 2);
+        for (uint32_t u = 0; u < n; u++) {
+            auto a = out.neighbors(u);
+            auto b = in.neighbors(u);
+            std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(undirected.targets));
+            undirected.offsets[u + 1] = static_cast<uint32_t>(undirected.targets.size());
+        }
+
+        std::vector<uint32_t> degree(n);
+        uint32_t max_degree = 0;
+        for (uint32_t u = 0; u < n; u++) {
+            degree[u] = undirected.degree(u);
+            max_degree = std::max(max_degree, degree[u]);
+        }
+
+        // Nodes sorted by degree, with bucket starts and each node's position
+        std::vector<uint32_t> bucket(static_cast<size_t>(max_degree) + 2, 0);
+        for (uint32_t u = 0; u < n; u++) bucket[degree[u] + 1]++;
+        for (uint32_t k = 0; k <= max_degree; k++) bucket[k + 1] += bucket[k];
+        std::vector<uint32_t> order(n);
+        std::vector<uint32_t> position(n);
+        std::vector<uint32_t> cursor(bucket.begin(), bucket.end() - 1);
+        for (uint32_t u = 0; u < n; u++) {
+            position[u] = cursor[degree[u]]++;
+            order[position[u]] = u;
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t v = order[i];
+            for (uint32_t u : undirected.neighbors(v)) {
+                if (degree[u] <= degree[v]) continue;
+
+                // Move u to the front of its bucket, then shrink it by one
+                uint32_t du = degree[u];
+                uint32_t front = bucket[du];
+                uint32_t w = order[front];
+                if (u != w) {
+                    std::swap(order[position[u]], order[front]);
+                    position[w] = position[u];
+                    position[u] = front;
+                }
+                bucket[du]++;
+                degree[u]--;
+            }
+        }
+
+        return degree;
+    }
+
+    template<typename Result, typename Run>
+    Result timed(Run run) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        freeze();
+        Result result = run();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        stats.last_run_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+        return result;
+    }
+};
+
+GraphAnalytics::GraphAnalytics(const AnalyticsConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+GraphAnalytics::~GraphAnalytics() = default;
+
+uint32_t GraphAnalytics::add_node(const std::string& id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->add_node(id);
+}
+
+uint32_t GraphAnalytics::find_node(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->index_of.find(id);
+    return it == impl_->index_of.end() ? NO_NODE : it->second;
+}
+
+std::string GraphAnalytics::node_id(uint32_t node) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return node < impl_->ids.size() ? impl_->ids[node] : std::string();
+}
+
+void GraphAnalytics::add_edge(const std::string& from, const std::string& to) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint32_t a = impl_->add_node(from);
+    uint32_t b = impl_->add_node(to);
+    impl_->edges.push_back({a, b});
+    impl_->dirty = true;
+}
+
+void GraphAnalytics::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->ids.clear();
+    impl_->index_of.clear();
+    impl_->edges.clear();
+    impl_->out = CsrGraph();
+    impl_->in = CsrGraph();
+    impl_->stats = AnalyticsStats();
+    impl_->dirty = true;
+}
+
+std::vector<double> GraphAnalytics::pagerank() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->timed<std::vector<double>>([this]() { return impl_->pagerank(); });
+}
+
+std::vector<double> GraphAnalytics::betweenness() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->timed<std::vector<double>>([this]() { return impl_->betweenness(); });
+}
+
+std::vector<uint32_t> GraphAnalytics::strongly_connected(uint32_t& count) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->timed<std::vector<uint32_t>>([this, &count]() {
+        std::vector<uint32_t> component;
+        const CsrGraph& out = impl_->out;
+        count = tarjan_scc(out.node_count(), [&out](uint32_t node) { return out.neighbors(node); },
+                           component);
+        return component;
+    });
+}
+
+std::vector<uint32_t> GraphAnalytics::core_numbers() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->timed<std::vector<uint32_t>>([this]() { return impl_->core_numbers(); });
+}
+
+AnalyticsStats GraphAnalytics::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    AnalyticsStats stats = impl_->stats;
+    if (impl_->dirty) {
+        stats.node_count = static_cast<uint32_t>(impl_->ids.size());
+        stats.edge_count = impl_->edges.size();
+    }
+    return stats;
+}
+
+std::vector<RankedNode> GraphAnalytics::top(const std::vector<double>& scores, size_t limit) {
+    std::vector<RankedNode> ranked(scores.size());
+    for (size_t i = 0; i < scores.size(); i++) {
+        ranked[i] = {static_cast<uint32_t>(i), scores[i]};
+    }
+
+    auto higher = [](const RankedNode& a, const RankedNode& b) {
+        return a.score != b.score ? a.score > b.score : a.node < b.node;
+    };
+    if (limit == 0 || limit >= ranked.size()) {
+        std::sort(ranked.begin(), ranked.end(), higher);
+    } else {
+        std::partial_sort(ranked.begin(), ranked.begin() + limit, ranked.end(), higher);
+        ranked.resize(limit);
+    }
+    return ranked;
+}
+
+} // namespace graph
+} // namespace archicore
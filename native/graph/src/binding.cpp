@@ -0,0 +1,1061 @@
+/**
+ * @file binding.cpp
+ * @brief N-API bindings for ArchiCore Dependency Graph Engine
+ * @version 1.0.0
+ */
+
+#include <napi.h>
+#include "graph.h"
+#include <cstring>
+
+namespace archicore {
+namespace graph {
+
+/**
+ * @brief Convert ReachabilityConfig from JS object
+ */
+ReachabilityConfig reachability_config_from_js(const Napi::Object& obj) {
+    ReachabilityConfig config;
+
+    if (obj.Has("closureLimit")) {
+        config.closure_limit = obj.Get("closureLimit").As<Napi::Number>().Uint32Value();
+    }
+
+    return config;
+}
+
+/**
+ * @brief Convert ReachabilityStats to JS object
+ */
+Napi::Object reachability_stats_to_js(Napi::Env env, const ReachabilityStats& stats) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("nodeCount", Napi::Number::New(env, stats.node_count));
+    obj.Set("edgeCount", Napi::Number::New(env, static_cast<double>(stats.edge_count)));
+    obj.Set("componentCount", Napi::Number::New(env, stats.component_count));
+    obj.Set("largestComponent", Napi::Number::New(env, stats.largest_component));
+    obj.Set("hasClosure", Napi::Boolean::New(env, stats.has_closure));
+    obj.Set("closureBytes", Napi::Number::New(env, static_cast<double>(stats.closure_bytes)));
+    obj.Set("rebuilds", Napi::Number::New(env, stats.rebuilds));
+    obj.Set("buildTimeMs", Napi::Number::New(env, stats.build_time_ms));
+    return obj;
+}
+
+/**
+ * @brief Convert AnalyticsConfig from JS object
+ */
+AnalyticsConfig analytics_config_from_js(const Napi::Object& obj) {
+    AnalyticsConfig config;
+
+    if (obj.Has("workers")) {
+        config.num_workers = obj.Get("workers").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("damping")) {
+        config.damping = obj.Get("damping").As<Napi::Number>().DoubleValue();
+    }
+    if (obj.Has("maxIterations")) {
+        config.max_iterations = obj.Get("maxIterations").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("tolerance")) {
+        config.tolerance = obj.Get("tolerance").As<Napi::Number>().DoubleValue();
+    }
+    if (obj.Has("betweennessSamples")) {
+        config.betweenness_samples = obj.Get("betweennessSamples").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("seed")) {
+        config.seed = static_cast<uint64_t>(obj.Get("seed").As<Napi::Number>().Int64Value());
+    }
+
+    return config;
+}
+
+/**
+ * @brief Convert AnalyticsStats to JS object
+ */
+Napi::Object analytics_stats_to_js(Napi::Env env, const AnalyticsStats& stats) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("nodeCount", Napi::Number::New(env, stats.node_count));
+    obj.Set("edgeCount", Napi::Number::New(env, static_cast<double>(stats.edge_count)));
+    obj.Set("pageRankIterations", Napi::Number::New(env, stats.pagerank_iterations));
+    obj.Set("betweennessSources", Napi::Number::New(env, stats.betweenness_sources));
+    obj.Set("buildTimeMs", Napi::Number::New(env, stats.build_time_ms));
+    obj.Set("lastRunMs", Napi::Number::New(env, stats.last_run_ms));
+    return obj;
+}
+
+/**
+ * @brief Wrapper for ReachabilityIndex
+ */
+class ReachabilityIndexWrapper : public Napi::ObjectWrap<ReachabilityIndexWrapper> {
+public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "ReachabilityIndex", {
+            InstanceMethod("addNodes", &ReachabilityIndexWrapper::AddNodes),
+            InstanceMethod("addEdge", &ReachabilityIndexWrapper::AddEdge),
+            InstanceMethod("addEdges", &ReachabilityIndexWrapper::AddEdges),
+            InstanceMethod("removeEdge", &ReachabilityIndexWrapper::RemoveEdge),
+            InstanceMethod("clear", &ReachabilityIndexWrapper::Clear),
+            InstanceMethod("hasNode", &ReachabilityIndexWrapper::HasNode),
+            InstanceMethod("dependsOn", &ReachabilityIndexWrapper::DependsOn),
+            InstanceMethod("affected", &ReachabilityIndexWrapper::Affected),
+            InstanceMethod("affectedSet", &ReachabilityIndexWrapper::AffectedSet),
+            InstanceMethod("stats", &ReachabilityIndexWrapper::Stats),
+        });
+
+        Napi::FunctionReference* constructor = new Napi::FunctionReference();
+        *constructor = Napi::Persistent(func);
+        exports.Set("ReachabilityIndex", func);
+
+        return exports;
+    }
+
+    ReachabilityIndexWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<ReachabilityIndexWrapper>(info) {
+        ReachabilityConfig config;
+        if (info.Length() > 0 && info[0].IsObject()) {
+            config = reachability_config_from_js(info[0].As<Napi::Object>());
+        }
+
+        index_ = std::make_unique<ReachabilityIndex>(config);
+    }
+
+private:
+    std::unique_ptr<ReachabilityIndex> index_;
+
+    // Known node indices of a JS id array; unknown ids are skipped
+    std::vector<uint32_t> nodes_from_js(const Napi::Array& ids) {
+        std::vector<uint32_t> nodes;
+        nodes.reserve(ids.Length());
+        for (uint32_t i = 0; i < ids.Length(); i++) {
+            Napi::Value id = ids.Get(i);
+            if (!id.IsString()) continue;
+            uint32_t node = index_->find_node(id.As<Napi::String>().Utf8Value());
+            if (node != NO_NODE) nodes.push_back(node);
+        }
+        return nodes;
+    }
+
+    Napi::Value AddNodes(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array ids = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < ids.Length(); i++) {
+            index_->add_node(ids.Get(i).As<Napi::String>().Utf8Value());
+        }
+
+        return env.Undefined();
+    }
+
+    Napi::Value AddEdge(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+            Napi::TypeError::New(env, "From and to node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        bool added = index_->add_edge(info[0].As<Napi::String>().Utf8Value(),
+                                      info[1].As<Napi::String>().Utf8Value());
+        return Napi::Boolean::New(env, added);
+    }
+
+    /**
+     * @brief addEdges(edges: Array<{ from, to }>): number of new edges
+     */
+    Napi::Value AddEdges(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of edges expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array edges = info[0].As<Napi::Array>();
+        uint32_t added = 0;
+        for (uint32_t i = 0; i < edges.Length(); i++) {
+            Napi::Object edge = edges.Get(i).As<Napi::Object>();
+            if (index_->add_edge(edge.Get("from").As<Napi::String>().Utf8Value(),
+                                 edge.Get("to").As<Napi::String>().Utf8Value())) {
+                added++;
+            }
+        }
+
+        return Napi::Number::New(env, added);
+    }
+
+    Napi::Value RemoveEdge(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+            Napi::TypeError::New(env, "From and to node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        bool removed = index_->remove_edge(info[0].As<Napi::String>().Utf8Value(),
+                                           info[1].As<Napi::String>().Utf8Value());
+        return Napi::Boolean::New(env, removed);
+    }
+
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        index_->clear();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value HasNode(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Node id expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        return Napi::Boolean::New(env, index_->find_node(info[0].As<Napi::String>().Utf8Value()) != NO_NODE);
+    }
+
+    Napi::Value DependsOn(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+            Napi::TypeError::New(env, "From and to node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint32_t from = index_->find_node(info[0].As<Napi::String>().Utf8Value());
+        uint32_t to = index_->find_node(info[1].As<Napi::String>().Utf8Value());
+        return Napi::Boolean::New(env, from != NO_NODE && to != NO_NODE && index_->depends_on(from, to));
+    }
+
+    /**
+     * @brief affected(changed: string[], maxDepth?: number): Array<{ id, distance }>
+     */
+    Napi::Value Affected(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of changed node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint32_t max_depth = 0;
+        if (info.Length() > 1 && info[1].IsNumber()) {
+            max_depth = info[1].As<Napi::Number>().Uint32Value();
+        }
+
+        std::vector<AffectedNode> affected = index_->affected(nodes_from_js(info[0].As<Napi::Array>()), max_depth);
+
+        Napi::Array arr = Napi::Array::New(env, affected.size());
+        for (size_t i = 0; i < affected.size(); i++) {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("id", Napi::String::New(env, index_->node_id(affected[i].node)));
+            obj.Set("distance", Napi::Number::New(env, affected[i].distance));
+            arr.Set(i, obj);
+        }
+        return arr;
+    }
+
+    /**
+     * @brief affectedSet(changed: string[]): string[]
+     */
+    Napi::Value AffectedSet(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of changed node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::vector<uint32_t> nodes = index_->affected_set(nodes_from_js(info[0].As<Napi::Array>()));
+
+        Napi::Array arr = Napi::Array::New(env, nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            arr.Set(i, Napi::String::New(env, index_->node_id(nodes[i])));
+        }
+        return arr;
+    }
+
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        return reachability_stats_to_js(info.Env(), index_->stats());
+    }
+};
+
+/**
+ * @brief Wrapper for GraphAnalytics
+ */
+class GraphAnalyticsWrapper : public Napi::ObjectWrap<GraphAnalyticsWrapper> {
+public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "GraphAnalytics", {
+            InstanceMethod("addNodes", &GraphAnalyticsWrapper::AddNodes),
+            InstanceMethod("addEdges", &GraphAnalyticsWrapper::AddEdges),
+            InstanceMethod("clear", &GraphAnalyticsWrapper::Clear),
+            InstanceMethod("pageRank", &GraphAnalyticsWrapper::PageRank),
+            InstanceMethod("betweenness", &GraphAnalyticsWrapper::Betweenness),
+            InstanceMethod("coreNumbers", &GraphAnalyticsWrapper::CoreNumbers),
+            InstanceMethod("stronglyConnected", &GraphAnalyticsWrapper::StronglyConnected),
+            InstanceMethod("stats", &GraphAnalyticsWrapper::Stats),
+        });
+
+        Napi::FunctionReference* constructor = new Napi::FunctionReference();
+        *constructor = Napi::Persistent(func);
+        exports.Set("GraphAnalytics", func);
+
+        return exports;
+    }
+
+    GraphAnalyticsWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<GraphAnalyticsWrapper>(info) {
+        AnalyticsConfig config;
+        if (info.Length() > 0 && info[0].IsObject()) {
+            config = analytics_config_from_js(info[0].As<Napi::Object>());
+        }
+
+        analytics_ = std::make_unique<GraphAnalytics>(config);
+    }
+
+private:
+    std::unique_ptr<GraphAnalytics> analytics_;
+
+    static size_t limit_from_js(const Napi::CallbackInfo& info) {
+        if (info.Length() > 0 && info[0].IsNumber()) {
+            return info[0].As<Napi::Number>().Uint32Value();
+        }
+        return 0;
+    }
+
+    Napi::Array ranked_to_js(Napi::Env env, const std::vector<RankedNode>& ranked) {
+        Napi::Array arr = Napi::Array::New(env, ranked.size());
+        for (size_t i = 0; i < ranked.size(); i++) {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("id", Napi::String::New(env, analytics_->node_id(ranked[i].node)));
+            obj.Set("score", Napi::Number::New(env, ranked[i].score));
+            arr.Set(i, obj);
+        }
+        return arr;
+    }
+
+    Napi::Value AddNodes(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array ids = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < ids.Length(); i++) {
+            analytics_->add_node(ids.Get(i).As<Napi::String>().Utf8Value());
+        }
+
+        return env.Undefined();
+    }
+
+    /**
+     * @brief addEdges(edges: Array<{ from, to }>)
+     */
+    Napi::Value AddEdges(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of edges expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array edges = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < edges.Length(); i++) {
+            Napi::Object edge = edges.Get(i).As<Napi::Object>();
+            analytics_->add_edge(edge.Get("from").As<Napi::String>().Utf8Value(),
+                                 edge.Get("to").As<Napi::String>().Utf8Value());
+        }
+
+        return env.Undefined();
+    }
+
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        analytics_->clear();
+        return info.Env().Undefined();
+    }
+
+    /**
+     * @brief pageRank(limit?: number): Array<{ id, score }>, highest first
+     */
+    Napi::Value PageRank(const Napi::CallbackInfo& info) {
+        return ranked_to_js(info.Env(), GraphAnalytics::top(analytics_->pagerank(), limit_from_js(info)));
+    }
+
+    /**
+     * @brief betweenness(limit?: number): Array<{ id, score }>, highest first
+     */
+    Napi::Value Betweenness(const Napi::CallbackInfo& info) {
+        return ranked_to_js(info.Env(), GraphAnalytics::top(analytics_->betweenness(), limit_from_js(info)));
+    }
+
+    /**
+     * @brief coreNumbers(limit?: number): Array<{ id, score }>, highest core first
+     */
+    Napi::Value CoreNumbers(const Napi::CallbackInfo& info) {
+        std::vector<uint32_t> cores = analytics_->core_numbers();
+        std::vector<double> scores(cores.begin(), cores.end());
+        return ranked_to_js(info.Env(), GraphAnalytics::top(scores, limit_from_js(info)));
+    }
+
+    /**
+     * @brief stronglyConnected(minSize = 2): string[][], largest first
+     */
+    Napi::Value StronglyConnected(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        uint32_t min_size = 2;
+        if (info.Length() > 0 && info[0].IsNumber()) {
+            min_size = info[0].As<Napi::Number>().Uint32Value();
+        }
+
+        uint32_t count = 0;
+        std::vector<uint32_t> component = analytics_->strongly_connected(count);
+
+        std::vector<std::vector<uint32_t>> groups(count);
+        for (uint32_t node = 0; node < component.size(); node++) {
+            groups[component[node]].push_back(node);
+        }
+        groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                    [min_size](const std::vector<uint32_t>& g) { return g.size() < min_size; }),
+                     groups.end());
+        std::stable_sort(groups.begin(), groups.end(),
+                         [](const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+                             return a.size() > b.size();
+                         });
+
+        Napi::Array arr = Napi::Array::New(env, groups.size());
+        for (size_t i = 0; i < groups.size(); i++) {
+            Napi::Array members = Napi::Array::New(env, groups[i].size());
+            for (size_t j = 0; j < groups[i].size(); j++) {
+                members.Set(j, Napi::String::New(env, analytics_->node_id(groups[i][j])));
+            }
+            arr.Set(i, members);
+        }
+        return arr;
+    }
+
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        return analytics_stats_to_js(info.Env(), analytics_->stats());
+    }
+};
+
+/**
+ * @brief Rule index or group index for JS; -1 for NO_NODE
+ */
+Napi::Number index_to_js(Napi::Env env, uint32_t index) {
+    return Napi::Number::New(env, index == NO_NODE ? -1.0 : static_cast<double>(index));
+}
+
+/**
+ * @brief Node.js wrapper for RuleEvaluator
+ */
+class RuleEvaluatorWrapper : public Napi::ObjectWrap<RuleEvaluatorWrapper> {
+public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "RuleEvaluator", {
+            InstanceMethod("addNodes", &RuleEvaluatorWrapper::AddNodes),
+            InstanceMethod("setDependencies", &RuleEvaluatorWrapper::SetDependencies),
+            InstanceMethod("addGlobGroup", &RuleEvaluatorWrapper::AddGlobGroup),
+            InstanceMethod("addGroup", &RuleEvaluatorWrapper::AddGroup),
+            InstanceMethod("updateGroup", &RuleEvaluatorWrapper::UpdateGroup),
+            InstanceMethod("addForbiddenRule", &RuleEvaluatorWrapper::AddForbiddenRule),
+            InstanceMethod("addLayerRule", &RuleEvaluatorWrapper::AddLayerRule),
+            InstanceMethod("addMaxDependenciesRule", &RuleEvaluatorWrapper::AddMaxDependenciesRule),
+            InstanceMethod("evaluate", &RuleEvaluatorWrapper::Evaluate),
+            InstanceMethod("clear", &RuleEvaluatorWrapper::Clear),
+            InstanceMethod("stats", &RuleEvaluatorWrapper::Stats),
+        });
+
+        Napi::FunctionReference* constructor = new Napi::FunctionReference();
+        *constructor = Napi::Persistent(func);
+        exports.Set("RuleEvaluator", func);
+
+        return exports;
+    }
+
+    RuleEvaluatorWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<RuleEvaluatorWrapper>(info) {
+        evaluator_ = std::make_unique<RuleEvaluator>();
+    }
+
+private:
+    std::unique_ptr<RuleEvaluator> evaluator_;
+
+    static std::vector<std::string> strings_from_js(const Napi::Value& value) {
+        std::vector<std::string> result;
+        if (!value.IsArray()) return result;
+        Napi::Array arr = value.As<Napi::Array>();
+        result.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            result.push_back(arr.Get(i).As<Napi::String>().Utf8Value());
+        }
+        return result;
+    }
+
+    /**
+     * @brief addNodes(nodes: Array<{ id, path }>)
+     */
+    Napi::Value AddNodes(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of nodes expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array nodes = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < nodes.Length(); i++) {
+            Napi::Object node = nodes.Get(i).As<Napi::Object>();
+            std::string id = node.Get("id").As<Napi::String>().Utf8Value();
+            std::string path = node.Has("path") ? node.Get("path").As<Napi::String>().Utf8Value() : id;
+            evaluator_->add_node(id, path);
+        }
+
+        return env.Undefined();
+    }
+
+    /**
+     * @brief setDependencies(from: string, targets: string[])
+     */
+    Napi::Value SetDependencies(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+            Napi::TypeError::New(env, "Node id and array of dependency ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        evaluator_->set_dependencies(info[0].As<Napi::String>().Utf8Value(), strings_from_js(info[1]));
+        return env.Undefined();
+    }
+
+    /**
+     * @brief addGlobGroup(globs: string[]): number
+     */
+    Napi::Value AddGlobGroup(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of globs expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        return index_to_js(env, evaluator_->add_glob_group(strings_from_js(info[0])));
+    }
+
+    Napi::Value AddGroup(const Napi::CallbackInfo& info) {
+        return index_to_js(info.Env(), evaluator_->add_group());
+    }
+
+    /**
+     * @brief updateGroup(group: number, add: string[], remove?: string[]): boolean
+     *
+     * Unknown node ids are skipped.
+     */
+    Napi::Value UpdateGroup(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsArray()) {
+            Napi::TypeError::New(env, "Group index and array of node ids expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint32_t group = info[0].As<Napi::Number>().Uint32Value();
+        bool ok = true;
+        auto apply = [&](const std::vector<std::string>& ids, bool member) {
+            for (const auto& id : ids) {
+                uint32_t node = evaluator_->find_node(id);
+                if (node != NO_NODE) ok = evaluator_->set_member(group, node, member) && ok;
+            }
+        };
+        apply(strings_from_js(info[1]), true);
+        if (info.Length() > 2) apply(strings_from_js(info[2]), false);
+
+        return Napi::Boolean::New(env, ok);
+    }
+
+    /**
+     * @brief addForbiddenRule(sourceGroup: number, targetGroup: number): number
+     */
+    Napi::Value AddForbiddenRule(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+            Napi::TypeError::New(env, "Source and target group expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        return index_to_js(env, evaluator_->add_forbidden_rule(info[0].As<Napi::Number>().Uint32Value(),
+                                                               info[1].As<Napi::Number>().Uint32Value()));
+    }
+
+    /**
+     * @brief addLayerRule(layers: Array<{ group, allowed: number[] }>): number
+     *
+     * allowed lists the indices of layers this layer may depend on.
+     */
+    Napi::Value AddLayerRule(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of layers expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array layers = info[0].As<Napi::Array>();
+        std::vector<uint32_t> groups;
+        std::vector<uint64_t> allowed;
+        for (uint32_t i = 0; i < layers.Length(); i++) {
+            Napi::Object layer = layers.Get(i).As<Napi::Object>();
+            groups.push_back(layer.Get("group").As<Napi::Number>().Uint32Value());
+
+            uint64_t mask = 0;
+            if (layer.Has("allowed") && layer.Get("allowed").IsArray()) {
+                Napi::Array targets = layer.Get("allowed").As<Napi::Array>();
+                for (uint32_t j = 0; j < targets.Length(); j++) {
+                    uint32_t target = targets.Get(j).As<Napi::Number>().Uint32Value();
+                    if (target < RuleEvaluator::MAX_LAYERS) mask |= uint64_t(1) << target;
+                }
+            }
+            allowed.push_back(mask);
+        }
+
+        return index_to_js(env, evaluator_->add_layer_rule(groups, allowed));
+    }
+
+    /**
+     * @brief addMaxDependenciesRule(limit: number, group?: number): number
+     */
+    Napi::Value AddMaxDependenciesRule(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsNumber()) {
+            Napi::TypeError::New(env, "Dependency limit expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint32_t group = NO_NODE;
+        if (info.Length() > 1 && info[1].IsNumber()) {
+            group = info[1].As<Napi::Number>().Uint32Value();
+        }
+
+        return index_to_js(env, evaluator_->add_max_dependencies_rule(info[0].As<Napi::Number>().Uint32Value(), group));
+    }
+
+    /**
+     * @brief evaluate(): Array<{ rule, from, to?, sourceLayer?, targetLayer?, count? }>
+     */
+    Napi::Value Evaluate(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::vector<RuleViolation> violations = evaluator_->evaluate();
+
+        Napi::Array arr = Napi::Array::New(env, violations.size());
+        for (size_t i = 0; i < violations.size(); i++) {
+            const RuleViolation& v = violations[i];
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("rule", Napi::Number::New(env, v.rule));
+            obj.Set("from", Napi::String::New(env, evaluator_->node_id(v.from)));
+            if (v.to != NO_NODE) {
+                obj.Set("to", Napi::String::New(env, evaluator_->node_id(v.to)));
+                obj.Set("sourceLayer", Napi::Number::New(env, v.source_layer));
+                obj.Set("targetLayer", Napi::Number::New(env, v.target_layer));
+            } else {
+                obj.Set("count", Napi::Number::New(env, v.count));
+            }
+            arr.Set(i, obj);
+        }
+        return arr;
+    }
+
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        evaluator_->clear();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        RuleEvaluatorStats stats = evaluator_->stats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("nodeCount", Napi::Number::New(env, stats.node_count));
+        obj.Set("edgeCount", Napi::Number::New(env, static_cast<double>(stats.edge_count)));
+        obj.Set("groupCount", Napi::Number::New(env, stats.group_count));
+        obj.Set("ruleCount", Napi::Number::New(env, stats.rule_count));
+        obj.Set("rulesEvaluated", Napi::Number::New(env, stats.rules_evaluated));
+        obj.Set("nodesRechecked", Napi::Number::New(env, stats.nodes_rechecked));
+        obj.Set("violationCount", Napi::Number::New(env, stats.violation_count));
+        obj.Set("evalTimeMs", Napi::Number::New(env, stats.eval_time_ms));
+        return obj;
+    }
+};
+
+/**
+ * @brief Parse 'json' | 'graphml' | 'csv'; false for anything else
+ */
+bool export_format_from_js(const Napi::Value& value, ExportFormat& format) {
+    if (!value.IsString()) return false;
+    std::string name = value.As<Napi::String>().Utf8Value();
+    if (name == "json") {
+        format = ExportFormat::JSON;
+    } else if (name == "graphml") {
+        format = ExportFormat::GRAPHML;
+    } else if (name == "csv") {
+        format = ExportFormat::CSV;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Node.js wrapper for GraphExporter
+ */
+class GraphExporterWrapper : public Napi::ObjectWrap<GraphExporterWrapper> {
+public:
+    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "GraphExporter", {
+            InstanceMethod("addNodes", &GraphExporterWrapper::AddNodes),
+            InstanceMethod("addEdges", &GraphExporterWrapper::AddEdges),
+            InstanceMethod("begin", &GraphExporterWrapper::Begin),
+            InstanceMethod("read", &GraphExporterWrapper::Read),
+            InstanceMethod("writeFile", &GraphExporterWrapper::WriteFile),
+            InstanceMethod("clear", &GraphExporterWrapper::Clear),
+            InstanceMethod("stats", &GraphExporterWrapper::Stats),
+        });
+
+        Napi::FunctionReference* constructor = new Napi::FunctionReference();
+        *constructor = Napi::Persistent(func);
+        exports.Set("GraphExporter", func);
+
+        return exports;
+    }
+
+    GraphExporterWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<GraphExporterWrapper>(info) {
+        exporter_ = std::make_unique<GraphExporter>();
+    }
+
+private:
+    std::unique_ptr<GraphExporter> exporter_;
+
+    static std::string string_field(const Napi::Object& obj, const char* key) {
+        Napi::Value value = obj.Get(key);
+        return value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+    }
+
+    /**
+     * @brief addNodes(nodes: Array<{ id, type, filePath, name, metadata? }>)
+     */
+    Napi::Value AddNodes(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsArray()) {
+            Napi::TypeError::New(env, "Array of nodes expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array nodes = info[0].As<Napi::Array>();
+        for (uint32_t i = 0; i < nodes.Length(); i++) {
+            Napi::Object obj = nodes.Get(i).As<Napi::Object>();
+            ExportNode node;
+            node.id = string_field(obj, "id");
+            node.type = string_field(obj, "type");
+            node.file_path = string_field(obj, "filePath");
+            node.name = string_field(obj, "name");
+
+            Napi::Value metadata = obj.Get("metadata");
+            if (metadata.IsObject()) {
+                Napi::Object meta = metadata.As<Napi::Object>();
+                node.domain = string_field(meta, "domain");
+                Napi::Value loc = meta.Get("linesOfCode");
+                if (loc.IsNumber()) node.lines_of_code = loc.As<Napi::Number>().DoubleValue();
+                Napi::Value complexity = meta.Get("complexity");
+                if (complexity.IsNumber()) node.complexity = complexity.As<Napi::Number>().DoubleValue();
+            }
+            exporter_->add_node(node);
+        }
+
+        return env.Undefined();
+    }
+
+    /**
+     * @brief addEdges(from: string, edges: Array<{ to, type, weight }>)
+     */
+    Napi::Value AddEdges(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+            Napi::TypeError::New(env, "Source id and array of edges expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Array arr = info[1].As<Napi::Array>();
+        std::vector<ExportEdge> edges;
+        edges.reserve(arr.Length());
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            Napi::Object obj = arr.Get(i).As<Napi::Object>();
+            ExportEdge edge;
+            edge.to = string_field(obj, "to");
+            edge.type = string_field(obj, "type");
+            Napi::Value weight = obj.Get("weight");
+            edge.weight = weight.IsNumber() ? weight.As<Napi::Number>().DoubleValue() : 1.0;
+            edges.push_back(std::move(edge));
+        }
+        exporter_->add_edges(info[0].As<Napi::String>().Utf8Value(), edges);
+
+        return env.Undefined();
+    }
+
+    /**
+     * @brief begin(format: 'json' | 'graphml' | 'csv')
+     */
+    Napi::Value Begin(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        ExportFormat format;
+        if (info.Length() < 1 || !export_format_from_js(info[0], format)) {
+            Napi::TypeError::New(env, "Format 'json', 'graphml' or 'csv' expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        exporter_->begin(format);
+        return env.Undefined();
+    }
+
+    /**
+     * @brief read(maxBytes?: number): Buffer | null (null once the export is finished)
+     */
+    Napi::Value Read(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        size_t max_bytes = 64 * 1024;
+        if (info.Length() > 0 && info[0].IsNumber()) {
+            max_bytes = std::max<size_t>(1, info[0].As<Napi::Number>().Uint32Value());
+        }
+
+        std::string chunk;
+        chunk.reserve(max_bytes + 1024);
+        if (!exporter_->read(chunk, max_bytes)) return env.Null();
+        return Napi::Buffer<char>::Copy(env, chunk.data(), chunk.size());
+    }
+
+    /**
+     * @brief writeFile(path: string, format): number of bytes written, -1 on failure
+     */
+    Napi::Value WriteFile(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        ExportFormat format;
+        if (info.Length() < 2 || !info[0].IsString() || !export_format_from_js(info[1], format)) {
+            Napi::TypeError::New(env, "Path and format 'json', 'graphml' or 'csv' expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        int64_t bytes = exporter_->write_file(info[0].As<Napi::String>().Utf8Value(), format);
+        return Napi::Number::New(env, static_cast<double>(bytes));
+    }
+
+    Napi::Value Clear(const Napi::CallbackInfo& info) {
+        exporter_->clear();
+        return info.Env().Undefined();
+    }
+
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        GraphExporterStats stats = exporter_->stats();
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("nodeCount", Napi::Number::New(env, stats.node_count));
+        obj.Set("edgeCount", Napi::Number::New(env, static_cast<double>(stats.edge_count)));
+        obj.Set("memoryBytes", Napi::Number::New(env, static_cast<double>(stats.memory_bytes)));
+        obj.Set("bytesWritten", Napi::Number::New(env, static_cast<double>(stats.bytes_written)));
+        return obj;
+    }
+};
+
+/**
+ * @brief findCycles(edges: Array<{ from, to }>, options?): { cycles, cyclicComponents, truncated }
+ */
+Napi::Value FindCycles(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "Array of edges expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    CycleConfig config;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object obj = info[1].As<Napi::Object>();
+        if (obj.Has("maxCycles")) {
+            config.max_cycles = obj.Get("maxCycles").As<Napi::Number>().Uint32Value();
+        }
+        if (obj.Has("maxCyclesPerComponent")) {
+            config.max_cycles_per_component = obj.Get("maxCyclesPerComponent").As<Napi::Number>().Uint32Value();
+        }
+        if (obj.Has("maxLength")) {
+            config.max_length = obj.Get("maxLength").As<Napi::Number>().Uint32Value();
+        }
+        if (obj.Has("maxSteps")) {
+            config.max_steps = static_cast<uint64_t>(obj.Get("maxSteps").As<Napi::Number>().Int64Value());
+        }
+    }
+
+    // Intern ids in order of appearance
+    std::vector<std::string> ids;
+    std::unordered_map<std::string, uint32_t> index_of;
+    auto intern = [&](std::string id) {
+        auto it = index_of.find(id);
+        if (it != index_of.end()) return it->second;
+        uint32_t node = static_cast<uint32_t>(ids.size());
+        index_of.emplace(id, node);
+        ids.push_back(std::move(id));
+        return node;
+    };
+
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(arr.Length());
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Object edge = arr.Get(i).As<Napi::Object>();
+        uint32_t from = intern(edge.Get("from").As<Napi::String>().Utf8Value());
+        uint32_t to = intern(edge.Get("to").As<Napi::String>().Utf8Value());
+        edges.push_back({from, to});
+    }
+
+    CycleResult result = find_cycles(CsrGraph::from_edges(static_cast<uint32_t>(ids.size()), edges), config);
+
+    Napi::Array cycles = Napi::Array::New(env, result.cycles.size());
+    for (size_t i = 0; i < result.cycles.size(); i++) {
+        Napi::Array cycle = Napi::Array::New(env, result.cycles[i].size());
+        for (size_t j = 0; j < result.cycles[i].size(); j++) {
+            cycle.Set(j, Napi::String::New(env, ids[result.cycles[i][j]]));
+        }
+        cycles.Set(i, cycle);
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("cycles", cycles);
+    obj.Set("cyclicComponents", Napi::Number::New(env, result.cyclic_components));
+    obj.Set("truncated", Napi::Boolean::New(env, result.truncated));
+    return obj;
+}
+
+template<typename T>
+static Napi::TypedArrayOf<T> column_to_js(Napi::Env env, const std::vector<T>& column) {
+    Napi::TypedArrayOf<T> arr = Napi::TypedArrayOf<T>::New(env, column.size());
+    if (!column.empty()) std::memcpy(arr.Data(), column.data(), column.size() * sizeof(T));
+    return arr;
+}
+
+/**
+ * @brief readExport(source: Buffer | path): { graph, sections: [{ key, json }] } | { error, errorOffset }
+ *
+ * The graph comes back as columns over one UTF-8 string pool; other
+ * top-level sections as raw JSON text.
+ */
+Napi::Value ReadExport(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    ExportDocument doc;
+    bool ok;
+    if (info.Length() > 0 && info[0].IsBuffer()) {
+        Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+        ok = read_export(std::string_view(buffer.Data(), buffer.Length()), doc);
+    } else if (info.Length() > 0 && info[0].IsString()) {
+        ok = read_export_file(info[0].As<Napi::String>().Utf8Value(), doc);
+    } else {
+        Napi::TypeError::New(env, "Buffer or file path expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    if (!ok) {
+        obj.Set("error", Napi::String::New(env, doc.error));
+        obj.Set("errorOffset", Napi::Number::New(env, static_cast<double>(doc.error_offset)));
+        return obj;
+    }
+
+    if (doc.has_graph) {
+        const ImportedGraph& g = doc.graph;
+        Napi::Object graph = Napi::Object::New(env);
+        graph.Set("strings", Napi::Buffer<char>::Copy(env, g.strings.data(), g.strings.size()));
+        graph.Set("stringOffsets", column_to_js(env, g.string_offsets));
+        graph.Set("nodeId", column_to_js(env, g.node_id));
+        graph.Set("nodeType", column_to_js(env, g.node_type));
+        graph.Set("nodeFilePath", column_to_js(env, g.node_file_path));
+        graph.Set("nodeName", column_to_js(env, g.node_name));
+        graph.Set("nodeDomain", column_to_js(env, g.node_domain));
+        graph.Set("nodeLinesOfCode", column_to_js(env, g.node_lines_of_code));
+        graph.Set("nodeComplexity", column_to_js(env, g.node_complexity));
+        graph.Set("edgeFrom", column_to_js(env, g.edge_from));
+        graph.Set("edgeTo", column_to_js(env, g.edge_to));
+        graph.Set("edgeType", column_to_js(env, g.edge_type));
+        graph.Set("edgeWeight", column_to_js(env, g.edge_weight));
+        obj.Set("graph", graph);
+    } else {
+        obj.Set("graph", env.Null());
+    }
+
+    // An array rather than an object, so a "__proto__" key stays data
+    Napi::Array sections = Napi::Array::New(env, doc.sections.size());
+    for (size_t i = 0; i < doc.sections.size(); i++) {
+        Napi::Object section = Napi::Object::New(env);
+        section.Set("key", Napi::String::New(env, doc.sections[i].key));
+        section.Set("json", Napi::String::New(env, doc.sections[i].json));
+        sections.Set(i, section);
+    }
+    obj.Set("sections", sections);
+    return obj;
+}
+
+/**
+ * @brief Module initialization
+ */
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    ReachabilityIndexWrapper::Init(env, exports);
+    GraphAnalyticsWrapper::Init(env, exports);
+    RuleEvaluatorWrapper::Init(env, exports);
+    GraphExporterWrapper::Init(env, exports);
+
+    exports.Set("findCycles", Napi::Function::New(env, FindCycles));
+    exports.Set("readExport", Napi::Function::New(env, ReadExport));
+
+    // Version info
+    exports.Set("version", Napi::String::New(env, "1.0.0"));
+
+    return exports;
+}
+
+NODE_API_MODULE(archicore_graph, Init)
+
+} // namespace graph
+} // namespace archicore
@@ -0,0 +1,325 @@
+/**
+ * @file cycles.cpp
+ * @brief Bounded cycle enumeration (Johnson's algorithm per SCC)
+ * @version 1.0.0
+ */
+
+#include "graph.h"
+
+namespace archicore {
+namespace graph {
+
+// Components up to this size get a breadth-first search from every node
+// when looking for their shortest cycle; larger ones from the best-connected
+static constexpr uint32_t EXACT_GIRTH_LIMIT = 256;
+static constexpr uint32_t GIRTH_SOURCES = 32;
+
+namespace {
+
+// Shortest first, then by node sequence; Johnson cycles already start at
+// their smallest node
+bool shorter_cycle(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+/**
+ * @brief A strongly connected component as its own small graph
+ */
+struct Component {
+    std::vector<uint32_t> nodes;    // Global node indices, ascending (local id = position)
+    CsrGraph local;                 // Edges that stay inside the component
+};
+
+class CycleSearch {
+public:
+    explicit CycleSearch(CycleResult& result) : result_(result) {}
+
+    /**
+     * @brief Shortest cycle found by breadth-first searches, as local ids
+     */
+    std::vector<uint32_t> shortest_cycle(const Component& component, uint64_t budget) {
+        const CsrGraph& g = component.local;
+        uint32_t k = g.node_count();
+
+        std::vector<uint32_t> sources(k);
+        for (uint32_t i = 0; i < k; i++) sources[i] = i;
+        if (k > EXACT_GIRTH_LIMIT) {
+            // Well-connected nodes are the likeliest to sit on short cycles
+            std::vector<uint32_t> degree(k, 0);
+            for (uint32_t u = 0; u < k; u++) {
+                degree[u] += g.degree(u);
+                for (uint32_t w : g.neighbors(u)) degree[w]++;
+            }
+            std::partial_sort(sources.begin(), sources.begin() + GIRTH_SOURCES, sources.end(),
+                              [&degree](uint32_t a, uint32_t b) {
+                                  return degree[a] != degree[b] ? degree[a] > degree[b] : a < b;
+                              });
+            sources.resize(GIRTH_SOURCES);
+        }
+
+        std::vector<uint32_t> best;
+        std::vector<uint32_t> parent(k, NO_NODE);
+        std::vector<uint32_t> queue;
+        queue.reserve(k);
+        uint64_t limit = result_.steps + budget;
+
+        for (uint32_t source : sources) {
+            if (best.size() == 2 || result_.steps >= limit) break;
+
+            queue.clear();
+            queue.push_back(source);
+            parent[source] = source;
+            uint32_t closing = NO_NODE;
+
+            for (size_t head = 0; head < queue.size() && closing == NO_NODE; head++) {
+                uint32_t u = queue[head];
+                for (uint32_t w : g.neighbors(u)) {
+                    result_.steps++;
+                    if (w == source) {
+                        closing = u;
+                        break;
+                    }
+                    if (parent[w] == NO_NODE) {
+                        parent[w] = u;
+                        queue.push_back(w);
+                    }
+                }
+            }
+
+            if (closing != NO_NODE) {
+                std::vector<uint32_t> cycle;
+                for (uint32_t v = closing; v != source; v = parent[v]) cycle.push_back(v);
+                cycle.push_back(source);
+                std::reverse(cycle.begin(), cycle.end());
+                if (best.empty() || cycle.size() < best.size()) best = std::move(cycle);
+            }
+
+            for (uint32_t v : queue) parent[v] = NO_NODE;
+        }
+
+        if (!best.empty()) {
+            std::rotate(best.begin(), std::min_element(best.begin(), best.end()), best.end());
+        }
+        return best;
+    }
+
+    /**
+     * @brief The shortest cycles within a length bound, as local ids
+     *
+     * One pass of Johnson's circuit enumeration. Found cycles are pruned to
+     * the shortest `keep` whenever twice that many pile up, and from then
+     * on the bound shrinks to the longest one kept, so the search skips
+     * paths that could not make the cut. A search cut short by the bound
+     * cannot prove that a node is off every cycle, so it counts as closing
+     * one and the node is unblocked; blocking stays sound and no cycle
+     * within the bound is missed.
+     * @param complete Output: the pass finished within the budget and no
+     *                 cycle within the bound was dropped
+     * @return At most keep cycles, shortest first
+     */
+    std::vector<std::vector<uint32_t>> johnson(const Component& component, uint32_t max_length,
+                                               size_t keep, uint64_t budget, bool& complete) {
+        const CsrGraph& g = component.local;
+        uint32_t k = g.node_count();
+        uint64_t limit = result_.steps + budget;
+        uint32_t bound = max_length;
+        bool dropped = false;
+
+        std::vector<std::vector<uint32_t>> cycles;
+        std::vector<char> blocked(k, 0);
+        std::vector<std::vector<uint32_t>> blockers(k);  // B(w): nodes to unblock with w
+        std::vector<uint32_t> touched;
+        std::vector<uint32_t> path;
+        std::vector<uint32_t> unblock_stack;
+
+        struct Frame {
+            uint32_t node;
+            uint32_t edge;      // Next entry in local.targets
+            bool closed;        // Reached the start (or was cut by the length bound)
+        };
+        std::vector<Frame> frames;
+
+        auto unblock = [&](uint32_t node) {
+            unblock_stack.push_back(node);
+            while (!unblock_stack.empty()) {
+                uint32_t x = unblock_stack.back();
+                unblock_stack.pop_back();
+                blocked[x] = 0;
+                for (uint32_t y : blockers[x]) {
+                    if (blocked[y]) unblock_stack.push_back(y);
+                }
+                blockers[x].clear();
+            }
+        };
+
+        auto enter = [&](uint32_t node) {
+            blocked[node] = 1;
+            touched.push_back(node);
+            path.push_back(node);
+            frames.push_back({node, g.offsets[node], false});
+        };
+
+        auto prune = [&]() {
+            std::sort(cycles.begin(), cycles.end(), shorter_cycle);
+            cycles.resize(keep);
+            bound = static_cast<uint32_t>(cycles.back().size());
+            dropped = true;
+        };
+
+        for (uint32_t s = 0; s < k; s++) {
+            if (result_.steps >= limit) break;
+            enter(s);
+
+            while (!frames.empty()) {
+                Frame& frame = frames.back();
+                if (frame.edge < g.offsets[frame.node + 1]) {
+                    uint32_t w = g.targets[frame.edge++];
+                    result_.steps++;
+                    if (w < s) continue;
+
+                    if (w == s) {
+                        if (bound == 0 || path.size() <= bound) cycles.push_back(path);
+                        frame.closed = true;
+                        if (cycles.size() >= 2 * keep) prune();
+                    } else if (!blocked[w]) {
+                        if (bound == 0 || path.size() < bound) {
+                            enter(w);
+                        } else {
+                            frame.closed = true;
+                        }
+                    }
+                    if (result_.steps >= limit) break;
+                    continue;
+                }
+
+                uint32_t v = frame.node;
+                bool closed = frame.closed;
+                if (closed) {
+                    unblock(v);
+                } else {
+                    for (uint32_t w : g.neighbors(v)) {
+                        if (w < s) continue;
+                        auto& list = blockers[w];
+                        if (std::find(list.begin(), list.end(), v) == list.end()) list.push_back(v);
+                    }
+                }
+
+                frames.pop_back();
+                path.pop_back();
+                if (!frames.empty() && closed) frames.back().closed = true;
+            }
+
+            // Abandoned searches leave frames behind; reset everything touched
+            frames.clear();
+            path.clear();
+            for (uint32_t node : touched) {
+                blocked[node] = 0;
+                blockers[node].clear();
+            }
+            touched.clear();
+        }
+
+        std::sort(cycles.begin(), cycles.end(), shorter_cycle);
+        if (cycles.size() > keep) {
+            cycles.resize(keep);
+            dropped = true;
+        }
+        complete = !dropped && result_.steps < limit;
+        return cycles;
+    }
+
+private:
+    CycleResult& result_;
+};
+
+} // namespace
+
+CycleResult find_cycles(const CsrGraph& graph, const CycleConfig& config) {
+    CycleResult result;
+    uint32_t n = graph.node_count();
+    if (n == 0 || config.max_cycles == 0) return result;
+
+    std::vector<uint32_t> component_of;
+    uint32_t count = tarjan_scc(n, [&graph](uint32_t node) { return graph.neighbors(node); }, component_of);
+
+    // Group nodes by component; singletons cannot hold a cycle without a self-loop
+    std::vector<std::vector<uint32_t>> groups(count);
+    for (uint32_t node = 0; node < n; node++) groups[component_of[node]].push_back(node);
+    groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                [](const std::vector<uint32_t>& g) { return g.size() < 2; }),
+                 groups.end());
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+                         return a.size() > b.size();
+                     });
+    result.cyclic_components = static_cast<uint32_t>(groups.size());
+
+    size_t take = std::min<size_t>(groups.size(), config.max_cycles);
+    if (take < groups.size()) result.truncated = true;
+
+    // Local graphs: members keep their relative order, edges leaving the
+    // component are dropped
+    std::vector<Component> components(take);
+    std::vector<uint32_t> local_id(n, NO_NODE);
+    for (size_t c = 0; c < take; c++) {
+        Component& component = components[c];
+        component.nodes = std::move(groups[c]);
+        for (uint32_t i = 0; i < component.nodes.size(); i++) local_id[component.nodes[i]] = i;
+
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        for (uint32_t i = 0; i < component.nodes.size(); i++) {
+            for (uint32_t w : graph.neighbors(component.nodes[i])) {
+                if (component_of[w] == component_of[component.nodes[i]]) edges.push_back({i, local_id[w]});
+            }
+        }
+        component.local = CsrGraph::from_edges(static_cast<uint32_t>(component.nodes.size()), edges);
+    }
+
+    CycleSearch search(result);
+    size_t per_component = std::max<uint32_t>(config.max_cycles_per_component, 1);
+
+    // Every component gets a representative before any gets more; budgets
+    // are an even share of what is left
+    std::vector<std::vector<std::vector<uint32_t>>> found(take);
+    for (size_t c = 0; c < take; c++) {
+        uint64_t left = config.max_steps > result.steps ? config.max_steps - result.steps : 0;
+        std::vector<uint32_t> shortest = search.shortest_cycle(components[c], left / (2 * (take - c)));
+        if (!shortest.empty() && (config.max_length == 0 || shortest.size() <= config.max_length)) {
+            found[c].push_back(std::move(shortest));
+        }
+    }
+
+    size_t remaining = config.max_cycles;
+    size_t c = 0;
+    for (; c < take && remaining > 0; c++) {
+        size_t keep = std::min(per_component, remaining);
+        auto& cycles = found[c];
+
+        // One bounded pass; a complete one holds the shortest cycles, an
+        // incomplete one tops up the breadth-first representative
+        uint64_t left = config.max_steps > result.steps ? config.max_steps - result.steps : 0;
+        bool complete = false;
+        auto pass = search.johnson(components[c], config.max_length, keep, left / (take - c), complete);
+        if (!complete) result.truncated = true;
+        cycles.insert(cycles.end(), std::make_move_iterator(pass.begin()), std::make_move_iterator(pass.end()));
+
+        std::sort(cycles.begin(), cycles.end(), shorter_cycle);
+        cycles.erase(std::unique(cycles.begin(), cycles.end()), cycles.end());
+        if (cycles.size() > keep) {
+            cycles.resize(keep);
+            result.truncated = true;
+        }
+
+        for (auto& cycle : cycles) {
+            for (uint32_t& node : cycle) node = components[c].nodes[node];
+            result.cycles.push_back(std::move(cycle));
+        }
+        remaining -= cycles.size();
+    }
+
+    if (c < take || result.steps >= config.max_steps) result.truncated = true;
+    return result;
+}
+
+} // namespace graph
+} // namespace archicore
@@ -0,0 +1,606 @@
+/**
+ * @file export.cpp
+ * @brief Streaming graph export (JSON, GraphML, CSV edge list)
+ * @version 1.0.0
+ *
+ * Serialises the dependency graph without materialising the document:
+ * - Compact graph copy: interned ids and types, fixed-size edge records
+ * - Record-at-a-time output into bounded chunks or a buffered file
+ * - SSE2 scans skip runs of bytes that need no escaping
+ */
+
+#include "graph.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARCHICORE_EXPORT_SSE2 1
+#endif
+
+namespace archicore {
+namespace graph {
+
+static constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+static const char GRAPHML_HEADER[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\"\n"
+    "         xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+    "         xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns\n"
+    "         http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">\n"
+    "\n"
+    "  <key id=\"d0\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+    "  <key id=\"d1\" for=\"node\" attr.name=\"type\" attr.type=\"string\"/>\n"
+    "  <key id=\"d2\" for=\"edge\" attr.name=\"type\" attr.type=\"string\"/>\n"
+    "\n"
+    "  <graph id=\"G\" edgedefault=\"directed\">\n";
+
+static const char GRAPHML_FOOTER[] = "  </graph>\n</graphml>";
+
+namespace {
+
+// ============================================================================
+// Escaping
+// ============================================================================
+
+inline bool is_xml_special(unsigned char c) {
+    return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
+
+inline bool is_json_special(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+inline bool is_csv_special(unsigned char c) {
+    return c == ',' || c == '"' || c == '\n' || c == '\r';
+}
+
+/**
+ * @brief Offset of the first byte in [from, n) that needs escaping, or n
+ */
+size_t next_xml_special(const char* s, size_t n, size_t from) {
+    size_t i = from;
+#ifdef ARCHICORE_EXPORT_SSE2
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i apos = _mm_set1_epi8('\'');
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, gt),
+                                                _mm_or_si128(_mm_cmpeq_epi8(v, quot), _mm_cmpeq_epi8(v, apos))));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask) return i + static_cast<size_t>(trailing_zeros(mask));
+    }
+#endif
+    for (; i < n; i++) {
+        if (is_xml_special(static_cast<unsigned char>(s[i]))) return i;
+    }
+    return n;
+}
+
+size_t next_json_special(const char* s, size_t n, size_t from) {
+    size_t i = from;
+#ifdef ARCHICORE_EXPORT_SSE2
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // Unsigned v <= 0x1F: min(v, 0x1F) == v
+        __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, control), v);
+        __m128i hit = _mm_or_si128(low, _mm_or_si128(_mm_cmpeq_epi8(v, quot), _mm_cmpeq_epi8(v, backslash)));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (mask) return i + static_cast<size_t>(trailing_zeros(mask));
+    }
+#endif
+    for (; i < n; i++) {
+        if (is_json_special(static_cast<unsigned char>(s[i]))) return i;
+    }
+    return n;
+}
+
+bool needs_csv_quotes(const char* s, size_t n) {
+    size_t i = 0;
+#ifdef ARCHICORE_EXPORT_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quot = _mm_set1_epi8('"');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quot)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        if (_mm_movemask_epi8(hit)) return true;
+    }
+#endif
+    for (; i < n; i++) {
+        if (is_csv_special(static_cast<unsigned char>(s[i]))) return true;
+    }
+    return false;
+}
+
+void append_xml(std::string& out, std::string_view s) {
+    size_t done = 0;
+    size_t i;
+    while ((i = next_xml_special(s.data(), s.size(), done)) < s.size()) {
+        out.append(s.data() + done, i - done);
+        switch (s[i]) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += "&apos;"; break;
+        }
+        done = i + 1;
+    }
+    out.append(s.data() + done, s.size() - done);
+}
+
+/**
+ * @brief Append s as a JSON string literal, escaped as JSON.stringify does
+ */
+void append_json(std::string& out, std::string_view s) {
+    static const char HEX[] = "0123456789abcdef";
+    out += '"';
+    size_t done = 0;
+    size_t i;
+    while ((i = next_json_special(s.data(), s.size(), done)) < s.size()) {
+        out.append(s.data() + done, i - done);
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+                break;
+        }
+        done = i + 1;
+    }
+    out.append(s.data() + done, s.size() - done);
+    out += '"';
+}
+
+void append_csv(std::string& out, std::string_view s) {
+    if (!needs_csv_quotes(s.data(), s.size())) {
+        out.append(s.data(), s.size());
+        return;
+    }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/**
+ * @brief Append a number as JSON; integers print exactly, others round-trip
+ */
+void append_number(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char buf[32];
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        std::snprintf(buf, sizeof(buf), "%.0f", value);
+        out += (std::strcmp(buf, "-0") == 0) ? "0" : buf;
+        return;
+    }
+    for (int precision = 15; precision <= 17; precision++) {
+        std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        if (precision == 17 || std::strtod(buf, nullptr) == value) break;
+    }
+    out += buf;
+}
+
+/**
+ * @brief Node id as ExportManager.sanitizeId: non [A-Za-z0-9_] UTF-16 units become '_'
+ */
+void append_sanitized_id(std::string& out, std::string_view s) {
+    for (size_t i = 0; i < s.size();) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c < 0x80) {
+            bool keep = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+            out += keep ? static_cast<char>(c) : '_';
+            i++;
+        } else if (c >= 0xF0) {
+            out += "__";    // Supplementary code point: a surrogate pair in JS
+            i += 4;
+        } else {
+            out += '_';
+            i += (c >= 0xE0) ? 3 : 2;
+        }
+    }
+}
+
+std::string_view basename_of(std::string_view path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string_view base = (slash == std::string_view::npos) ? path : path.substr(slash + 1);
+    return base.empty() ? path : base;
+}
+
+} // namespace
+
+// ============================================================================
+// GraphExporter
+// ============================================================================
+
+struct GraphExporter::Impl {
+    struct Node {
+        uint32_t id;                // Index into ids
+        uint32_t type;              // Index into types
+        uint32_t file_path;         // Offset into pool (length-prefixed strings)
+        uint32_t name;
+        uint32_t domain;            // UINT32_MAX = absent
+        double lines_of_code;       // Negative = absent
+        double complexity;
+    };
+
+    struct Edge {
+        uint32_t to;                // Index into ids
+        uint32_t type;
+        double weight;
+    };
+
+    struct Group {
+        uint32_t from;
+        uint32_t first;             // Range in edges
+        uint32_t count;
+    };
+
+    enum class Phase : uint8_t { HEADER, NODES, EDGES_START, EDGES, FOOTER, DONE };
+
+    // Interned ids: the deque keeps string storage stable for the views
+    std::deque<std::string> ids;
+    std::unordered_map<std::string_view, uint32_t> id_lookup;
+    std::vector<std::string> types;
+    std::unordered_map<std::string, uint32_t> type_lookup;
+    std::string pool;
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint32_t, uint32_t> node_of_id;
+    std::vector<Edge> edges;
+    std::vector<Group> groups;
+
+    // Export cursor
+    ExportFormat format = ExportFormat::JSON;
+    Phase phase = Phase::DONE;
+    size_t node_pos = 0;
+    size_t group_pos = 0;
+    size_t edge_pos = 0;            // Position within the current group
+    uint64_t edge_serial = 0;       // GraphML edge ids
+    uint64_t bytes_written = 0;
+
+    mutable std::mutex mutex;
+
+    uint32_t intern_id(const std::string& id) {
+        auto it = id_lookup.find(id);
+        if (it != id_lookup.end()) return it->second;
+        uint32_t idx = static_cast<uint32_t>(ids.size());
+        ids.push_back(id);
+        id_lookup.emplace(std::string_view(ids.back()), idx);
+        return idx;
+    }
+
+    uint32_t intern_type(const std::string& type) {
+        auto inserted = type_lookup.emplace(type, static_cast<uint32_t>(types.size()));
+        if (inserted.second) types.push_back(type);
+        return inserted.first->second;
+    }
+
+    uint32_t store(const std::string& s) {
+        uint32_t offset = static_cast<uint32_t>(pool.size());
+        uint32_t length = static_cast<uint32_t>(s.size());
+        pool.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        pool += s;
+        return offset;
+    }
+
+    std::string_view stored(uint32_t offset) const {
+        uint32_t length;
+        memcpy(&length, pool.data() + offset, sizeof(length));
+        return std::string_view(pool.data() + offset + sizeof(length), length);
+    }
+
+    // ------------------------------------------------------------------------
+    // Records
+    // ------------------------------------------------------------------------
+
+    void emit_header(std::string& out) {
+        switch (format) {
+            case ExportFormat::JSON: out += "{\"nodes\":{"; break;
+            case ExportFormat::GRAPHML: out += GRAPHML_HEADER; break;
+            case ExportFormat::CSV: out += "from,to,type,weight\n"; break;
+        }
+    }
+
+    void emit_node(std::string& out, const Node& node) {
+        const std::string& id = ids[node.id];
+        if (format == ExportFormat::GRAPHML) {
+            out += "    <node id=\"";
+            append_sanitized_id(out, id);
+            out += "\">\n      <data key=\"d0\">";
+            append_xml(out, basename_of(stored(node.file_path)));
+            out += "</data>\n      <data key=\"d1\">";
+            append_xml(out, types[node.type]);
+            out += "</data>\n    </node>\n";
+            return;
+        }
+
+        if (node_pos > 0) out += ',';
+        append_json(out, id);
+        out += ":{\"id\":";
+        append_json(out, id);
+        out += ",\"type\":";
+        append_json(out, types[node.type]);
+        out += ",\"filePath\":";
+        append_json(out, stored(node.file_path));
+        out += ",\"name\":";
+        append_json(out, stored(node.name));
+        out += ",\"metadata\":{";
+        bool first = true;
+        if (node.lines_of_code >= 0) {
+            out += "\"linesOfCode\":";
+            append_number(out, node.lines_of_code);
+            first = false;
+        }
+        if (node.complexity >= 0) {
+            out += first ? "\"complexity\":" : ",\"complexity\":";
+            append_number(out, node.complexity);
+            first = false;
+        }
+        if (node.domain != UINT32_MAX) {
+            out += first ? "\"domain\":" : ",\"domain\":";
+            append_json(out, stored(node.domain));
+        }
+        out += "}}";
+    }
+
+    void emit_edge(std::string& out, const Group& group, const Edge& edge) {
+        const std::string& from = ids[group.from];
+        const std::string& to = ids[edge.to];
+        switch (format) {
+            case ExportFormat::JSON:
+                if (edge_pos > 0) out += ',';
+                out += "{\"from\":";
+                append_json(out, from);
+                out += ",\"to\":";
+                append_json(out, to);
+                out += ",\"type\":";
+                append_json(out, types[edge.type]);
+                out += ",\"weight\":";
+                append_number(out, edge.weight);
+                out += '}';
+                break;
+            case ExportFormat::GRAPHML:
+                out += "    <edge id=\"e";
+                out += std::to_string(edge_serial);
+                out += "\" source=\"";
+                append_sanitized_id(out, from);
+                out += "\" target=\"";
+                append_sanitized_id(out, to);
+                out += "\">\n      <data key=\"d2\">";
+                append_xml(out, types[edge.type]);
+                out += "</data>\n    </edge>\n";
+                break;
+            case ExportFormat::CSV:
+                append_csv(out, from);
+                out += ',';
+                append_csv(out, to);
+                out += ',';
+                append_csv(out, types[edge.type]);
+                out += ',';
+                append_number(out, edge.weight);
+                out += '\n';
+                break;
+        }
+        edge_serial++;
+    }
+
+    /**
+     * @brief Emit the next record; returns false once the export is finished
+     */
+    bool step(std::string& out) {
+        switch (phase) {
+            case Phase::HEADER:
+                emit_header(out);
+                phase = format == ExportFormat::CSV ? Phase::EDGES_START : Phase::NODES;
+                return true;
+
+            case Phase::NODES:
+                if (node_pos < nodes.size()) {
+                    emit_node(out, nodes[node_pos]);
+                    node_pos++;
+                    return true;
+                }
+                if (format == ExportFormat::JSON) out += "},\"edges\":{";
+                phase = Phase::EDGES_START;
+                return true;
+
+            case Phase::EDGES_START:
+                if (group_pos >= groups.size()) {
+                    phase = Phase::FOOTER;
+                    return true;
+                }
+                if (format == ExportFormat::JSON) {
+                    if (group_pos > 0) out += ',';
+                    append_json(out, ids[groups[group_pos].from]);
+                    out += ":[";
+                }
+                edge_pos = 0;
+                phase = Phase::EDGES;
+                return true;
+
+            case Phase::EDGES: {
+                const Group& group = groups[group_pos];
+                if (edge_pos < group.count) {
+                    emit_edge(out, group, edges[group.first + edge_pos]);
+                    edge_pos++;
+                    return true;
+                }
+                if (format == ExportFormat::JSON) out += ']';
+                group_pos++;
+                phase = Phase::EDGES_START;
+                return true;
+            }
+
+            case Phase::FOOTER:
+                if (format == ExportFormat::JSON) out += "}}";
+                if (format == ExportFormat::GRAPHML) out += GRAPHML_FOOTER;
+                phase = Phase::DONE;
+                return true;
+
+            case Phase::DONE:
+                return false;
+        }
+        return false;
+    }
+
+    void begin(ExportFormat f) {
+        format = f;
+        phase = Phase::HEADER;
+        node_pos = 0;
+        group_pos = 0;
+        edge_pos = 0;
+        edge_serial = 0;
+        bytes_written = 0;
+    }
+
+    bool read(std::string& out, size_t max_bytes) {
+        size_t start = out.size();
+        if (phase == Phase::DONE) return false;
+        while (phase != Phase::DONE && out.size() - start < max_bytes) {
+            step(out);
+        }
+        bytes_written += out.size() - start;
+        return true;
+    }
+};
+
+GraphExporter::GraphExporter()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+GraphExporter::~GraphExporter() = default;
+
+void GraphExporter::add_node(const ExportNode& node) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->phase = Impl::Phase::DONE;
+
+    Impl::Node record;
+    record.id = impl_->intern_id(node.id);
+    record.type = impl_->intern_type(node.type);
+    record.file_path = impl_->store(node.file_path);
+    record.name = impl_->store(node.name);
+    record.domain = node.domain.empty() ? UINT32_MAX : impl_->store(node.domain);
+    record.lines_of_code = node.lines_of_code;
+    record.complexity = node.complexity;
+
+    auto inserted = impl_->node_of_id.emplace(record.id, static_cast<uint32_t>(impl_->nodes.size()));
+    if (inserted.second) {
+        impl_->nodes.push_back(record);
+    } else {
+        // Map.set semantics: the node keeps its position, the old strings stay in the pool
+        impl_->nodes[inserted.first->second] = record;
+    }
+}
+
+void GraphExporter::add_edges(const std::string& from, const std::vector<ExportEdge>& edges) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->phase = Impl::Phase::DONE;
+
+    Impl::Group group;
+    group.from = impl_->intern_id(from);
+    group.first = static_cast<uint32_t>(impl_->edges.size());
+    group.count = static_cast<uint32_t>(edges.size());
+    for (const auto& edge : edges) {
+        impl_->edges.push_back({impl_->intern_id(edge.to), impl_->intern_type(edge.type), edge.weight});
+    }
+    impl_->groups.push_back(group);
+}
+
+void GraphExporter::begin(ExportFormat format) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->begin(format);
+}
+
+bool GraphExporter::read(std::string& out, size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->read(out, max_bytes);
+}
+
+int64_t GraphExporter::write_file(const std::string& path, ExportFormat format) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return -1;
+    // Output goes through our own buffer; stdio buffering would only add a copy
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    std::string buffer;
+    buffer.reserve(WRITE_BUFFER_SIZE + 4096);
+    impl_->begin(format);
+    bool ok = true;
+    while (ok && impl_->read(buffer, WRITE_BUFFER_SIZE)) {
+        ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        buffer.clear();
+    }
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) {
+        impl_->phase = Impl::Phase::DONE;
+        std::remove(path.c_str());
+        return -1;
+    }
+    return static_cast<int64_t>(impl_->bytes_written);
+}
+
+void GraphExporter::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->ids.clear();
+    impl_->id_lookup.clear();
+    impl_->types.clear();
+    impl_->type_lookup.clear();
+    impl_->pool.clear();
+    impl_->nodes.clear();
+    impl_->node_of_id.clear();
+    impl_->edges.clear();
+    impl_->groups.clear();
+    impl_->phase = Impl::Phase::DONE;
+    impl_->bytes_written = 0;
+}
+
+GraphExporterStats GraphExporter::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    GraphExporterStats s;
+    s.node_count = static_cast<uint32_t>(impl_->nodes.size());
+    s.edge_count = impl_->edges.size();
+    s.bytes_written = impl_->bytes_written;
+
+    uint64_t memory = impl_->pool.capacity();
+    for (const auto& id : impl_->ids) memory += id.capacity() + sizeof(std::string) + 32;
+    memory += impl_->nodes.capacity() * sizeof(Impl::Node);
+    memory += impl_->node_of_id.size() * 24;
+    memory += impl_->edges.capacity() * sizeof(Impl::Edge);
+    memory += impl_->groups.capacity() * sizeof(Impl::Group);
+    s.memory_bytes = memory;
+    return s;
+}
+
+} // namespace graph
+} // namespace archicore
@@ -0,0 +1,806 @@
+/**
+ * @file import.cpp
+ * @brief Reader for exported analysis documents
+ * @version 1.0.0
+ *
+ * Restores a saved analysis without building a JS object tree:
+ * - Stage 1 marks quotes and brackets outside strings per 64-byte block
+ *   (SSE2 compares, backslash runs, prefix XOR for string ranges)
+ * - Stage 2 pulls tokens in order; strings end at the next indexed quote,
+ *   skipped sections jump from bracket to bracket
+ * - Graph nodes and edges land in interned columnar tables
+ */
+
+#include "graph.h"
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARCHICORE_IMPORT_SSE2 1
+#endif
+
+namespace archicore {
+namespace graph {
+
+// Bytes indexed per refill of the structural window
+static constexpr size_t INDEX_WINDOW = 64 * 1024;
+
+namespace {
+
+struct BlockMasks {
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t structural;    // { } [ ] : ,
+};
+
+inline bool is_structural_char(unsigned char c) {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+/**
+ * @brief Character masks of one 64-byte block
+ */
+BlockMasks classify_block(const unsigned char* p) {
+    BlockMasks m{0, 0, 0};
+#ifdef ARCHICORE_IMPORT_SSE2
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i open_bracket = _mm_set1_epi8('[');
+    const __m128i close_bracket = _mm_set1_epi8(']');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        __m128i s = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, open_brace), _mm_cmpeq_epi8(v, close_brace)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, open_bracket), _mm_cmpeq_epi8(v, close_bracket)));
+        s = _mm_or_si128(s, _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        int shift = i * 16;
+        m.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+        m.quote |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        m.structural |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(s))) << shift;
+    }
+#else
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = 1ULL << i;
+        if (p[i] == '\\') m.backslash |= bit;
+        if (p[i] == '"') m.quote |= bit;
+        if (is_structural_char(p[i])) m.structural |= bit;
+    }
+#endif
+    return m;
+}
+
+/**
+ * @brief Bits of characters escaped by a backslash
+ * @param carry In: bit 0 escaped by the previous block; out: same for the next
+ */
+uint64_t escaped_bits(uint64_t backslash, uint64_t& carry) {
+    uint64_t escaped = carry;
+    backslash &= ~carry;
+    carry = 0;
+    // Backslash runs are rare and short: resolve them left to right
+    while (backslash) {
+        int i = trailing_zeros(backslash);
+        backslash &= backslash - 1;
+        if (i == 63) {
+            carry = 1;
+        } else {
+            uint64_t next = 1ULL << (i + 1);
+            escaped |= next;
+            backslash &= ~next;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief Inclusive prefix XOR: bit i = xor of bits 0..i
+ */
+inline uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * @brief Positions of unescaped quotes and of brackets, colons and commas
+ *        outside strings, produced in order one window at a time
+ */
+class StructuralIndex {
+public:
+    static constexpr size_t END = std::numeric_limits<size_t>::max();
+
+    explicit StructuralIndex(std::string_view json) : json_(json) {}
+
+    size_t peek() {
+        while (head_ == positions_.size() && scanned_ < json_.size()) refill();
+        return head_ < positions_.size() ? positions_[head_] : END;
+    }
+
+    size_t take() {
+        size_t p = peek();
+        if (p != END) head_++;
+        return p;
+    }
+
+private:
+    std::string_view json_;
+    size_t scanned_ = 0;
+    std::vector<size_t> positions_;
+    size_t head_ = 0;
+    uint64_t in_string_ = 0;    // All ones while a string continues into the next block
+    uint64_t escape_carry_ = 0;
+
+    void refill() {
+        positions_.clear();
+        head_ = 0;
+        size_t end = std::min(json_.size(), scanned_ + INDEX_WINDOW);
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(json_.data());
+
+        for (; scanned_ < end; scanned_ += 64) {
+            BlockMasks m;
+            if (scanned_ + 64 <= json_.size()) {
+                m = classify_block(data + scanned_);
+            } else {
+                unsigned char tail[64];
+                std::memset(tail, ' ', sizeof(tail));
+                std::memcpy(tail, data + scanned_, json_.size() - scanned_);
+                m = classify_block(tail);
+            }
+
+            uint64_t quotes = m.quote & ~escaped_bits(m.backslash, escape_carry_);
+            uint64_t inside = prefix_xor(quotes) ^ in_string_;
+            in_string_ = 0 - (inside >> 63);
+
+            uint64_t bits = (m.structural & ~inside) | quotes;
+            while (bits) {
+                positions_.push_back(scanned_ + static_cast<size_t>(trailing_zeros(bits)));
+                bits &= bits - 1;
+            }
+        }
+        scanned_ = std::max(scanned_, end);
+    }
+};
+
+/**
+ * @brief Open-addressing interner over ImportedGraph's string pool
+ *
+ * Probes compare stored hashes and then the compact pool, so lookups
+ * stay out of the (much larger) document.
+ */
+class StringPool {
+public:
+    explicit StringPool(ImportedGraph& graph) : graph_(graph), slots_(1024, 0) {
+        graph_.string_offsets.assign(1, 0);
+    }
+
+    uint32_t intern(std::string_view s) {
+        uint64_t h = hash(s);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            uint32_t slot = slots_[i];
+            if (slot == 0) break;
+            uint32_t index = slot - 1;
+            if (hashes_[index] == h && view(index) == s) return index;
+        }
+
+        uint32_t index = static_cast<uint32_t>(hashes_.size());
+        graph_.strings.append(s.data(), s.size());
+        graph_.string_offsets.push_back(static_cast<uint32_t>(graph_.strings.size()));
+        hashes_.push_back(h);
+        if (hashes_.size() * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        } else {
+            insert(index);
+        }
+        return index;
+    }
+
+private:
+    ImportedGraph& graph_;
+    std::vector<uint32_t> slots_;   // 1 + string index, 0 = empty
+    std::vector<uint64_t> hashes_;
+
+    static uint64_t hash(std::string_view s) {
+        // FNV-1a
+        uint64_t h = 0xCBF29CE484222325ULL;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001B3ULL;
+        }
+        return h ^ (h >> 29);
+    }
+
+    std::string_view view(uint32_t index) const {
+        uint32_t begin = graph_.string_offsets[index];
+        return std::string_view(graph_.strings.data() + begin, graph_.string_offsets[index + 1] - begin);
+    }
+
+    void insert(uint32_t index) {
+        size_t mask = slots_.size() - 1;
+        size_t i = hashes_[index] & mask;
+        while (slots_[i] != 0) i = (i + 1) & mask;
+        slots_[i] = index + 1;
+    }
+
+    void rehash(size_t size) {
+        slots_.assign(size, 0);
+        for (uint32_t index = 0; index < hashes_.size(); index++) insert(index);
+    }
+};
+
+enum class Token : uint8_t {
+    OBJECT_START, OBJECT_END, ARRAY_START, ARRAY_END,
+    STRING, NUMBER, LITERAL, END, ERROR
+};
+
+inline bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+bool read_hex4(std::string_view s, size_t pos, uint32_t& value) {
+    if (pos + 4 > s.size()) return false;
+    value = 0;
+    for (size_t i = pos; i < pos + 4; i++) {
+        char c = s[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decode the body of a JSON string literal; lone surrogates become U+FFFD
+ */
+bool unescape(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        char c = raw[i];
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (++i >= raw.size()) return false;
+        switch (raw[i]) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!read_hex4(raw, i + 1, cp)) return false;
+                i += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low;
+                    if (i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u' &&
+                        read_hex4(raw, i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    cp = 0xFFFD;
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pull parser over the structural index
+ *
+ * Commas and colons are consumed silently; callers know from context
+ * whether a string is a key or a value. Bracket nesting is checked.
+ */
+class JsonCursor {
+public:
+    explicit JsonCursor(std::string_view json) : json_(json), index_(json) {
+        // UTF-8 byte order mark
+        if (json_.size() >= 3 && json_.compare(0, 3, "\xEF\xBB\xBF") == 0) pos_ = 3;
+    }
+
+    Token next() {
+        for (;;) {
+            size_t p = pos_;
+            while (p < json_.size() && is_space(json_[p])) p++;
+            if (p >= json_.size()) {
+                if (!stack_.empty()) return fail(p, "Unexpected end of input");
+                return Token::END;
+            }
+
+            char c = json_[p];
+            begin_ = p;
+            if (c == '"' || is_structural_char(static_cast<unsigned char>(c))) {
+                if (index_.take() != p) return fail(p, "Unexpected character");
+                pos_ = p + 1;
+                end_ = pos_;
+                switch (c) {
+                    case ',':
+                    case ':':
+                        continue;
+                    case '{':
+                        stack_.push_back('{');
+                        return Token::OBJECT_START;
+                    case '[':
+                        stack_.push_back('[');
+                        return Token::ARRAY_START;
+                    case '}':
+                    case ']':
+                        if (stack_.empty() || stack_.back() != (c == '}' ? '{' : '[')) {
+                            return fail(p, "Mismatched bracket");
+                        }
+                        stack_.pop_back();
+                        return c == '}' ? Token::OBJECT_END : Token::ARRAY_END;
+                    default: {
+                        size_t close = index_.take();
+                        if (close == StructuralIndex::END || json_[close] != '"') {
+                            return fail(p, "Unterminated string");
+                        }
+                        raw_ = json_.substr(p + 1, close - p - 1);
+                        pos_ = close + 1;
+                        end_ = pos_;
+                        return Token::STRING;
+                    }
+                }
+            }
+            return scalar(p);
+        }
+    }
+
+    /**
+     * @brief Skip the rest of a container whose start token was just read
+     */
+    bool skip_container() {
+        size_t depth = 1;
+        while (depth > 0) {
+            size_t p = index_.take();
+            if (p == StructuralIndex::END) {
+                fail(json_.size(), "Unexpected end of input");
+                return false;
+            }
+            char c = json_[p];
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+            } else if (c == '"') {
+                index_.take();    // Closing quote
+            }
+            pos_ = p + 1;
+        }
+        stack_.pop_back();
+        end_ = pos_;
+        return true;
+    }
+
+    /**
+     * @brief Skip a value whose first token was just read
+     */
+    bool skip(Token first) {
+        if (first == Token::OBJECT_START || first == Token::ARRAY_START) return skip_container();
+        return first != Token::ERROR && first != Token::END;
+    }
+
+    /**
+     * @brief Body of the last string token, unescaped into scratch if needed
+     */
+    bool string_value(std::string& scratch, std::string_view& value) {
+        if (raw_.find('\\') == std::string_view::npos) {
+            value = raw_;
+            return true;
+        }
+        if (!unescape(raw_, scratch)) {
+            fail(begin_, "Invalid escape sequence");
+            return false;
+        }
+        value = scratch;
+        return true;
+    }
+
+    double number() const { return number_; }
+    size_t begin() const { return begin_; }
+    size_t end() const { return end_; }
+    std::string_view text(size_t from, size_t to) const { return json_.substr(from, to - from); }
+
+    const std::string& error() const { return error_; }
+    size_t error_offset() const { return error_offset_; }
+
+    Token fail(size_t offset, const char* message) {
+        if (error_.empty()) {
+            error_ = message;
+            error_offset_ = offset;
+        }
+        return Token::ERROR;
+    }
+
+private:
+    std::string_view json_;
+    StructuralIndex index_;
+    std::vector<char> stack_;
+    size_t pos_ = 0;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    std::string_view raw_;
+    double number_ = 0;
+    std::string error_;
+    size_t error_offset_ = 0;
+
+    Token scalar(size_t p) {
+        size_t e = p;
+        while (e < json_.size() && !is_space(json_[e]) && json_[e] != '"' &&
+               !is_structural_char(static_cast<unsigned char>(json_[e]))) {
+            e++;
+        }
+        std::string_view token = json_.substr(p, e - p);
+        pos_ = e;
+        end_ = e;
+
+        if (token == "true" || token == "false" || token == "null") {
+            number_ = token == "true" ? 1 : 0;
+            return Token::LITERAL;
+        }
+
+        char buf[64];
+        bool numeric = !token.empty() && token.size() < sizeof(buf) &&
+                       (token[0] == '-' || (token[0] >= '0' && token[0] <= '9'));
+        if (numeric) {
+            std::memcpy(buf, token.data(), token.size());
+            buf[token.size()] = '\0';
+            char* parsed_end = nullptr;
+            number_ = std::strtod(buf, &parsed_end);
+            numeric = parsed_end == buf + token.size();
+        }
+        if (!numeric) return fail(p, "Invalid value");
+        return Token::NUMBER;
+    }
+};
+
+/**
+ * @brief Export format on top of the cursor: graph into tables, the rest raw
+ */
+class ExportReader {
+public:
+    ExportReader(std::string_view json, ExportDocument& out)
+        : cursor_(json), doc_(out), graph_(out.graph), pool_(out.graph) {}
+
+    bool read() {
+        if (cursor_.next() != Token::OBJECT_START) return fail("Export document must be an object");
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == Token::OBJECT_END) break;
+            std::string_view key;
+            if (!read_key(t, key)) return false;
+
+            std::string name(key);
+            Token value = cursor_.next();
+            if (name == "graph" && value == Token::OBJECT_START) {
+                doc_.has_graph = true;
+                if (!read_graph()) return false;
+                continue;
+            }
+
+            size_t begin = cursor_.begin();
+            if (!cursor_.skip(value)) return fail("Invalid value");
+            std::string_view json = cursor_.text(begin, cursor_.end());
+            doc_.sections.push_back({std::move(name), std::string(json)});
+        }
+
+        if (cursor_.next() != Token::END) return fail("Trailing data after the document");
+        return true;
+    }
+
+    bool failed() const { return !cursor_.error().empty(); }
+    const JsonCursor& cursor() const { return cursor_; }
+
+private:
+    JsonCursor cursor_;
+    ExportDocument& doc_;
+    ImportedGraph& graph_;
+
+    StringPool pool_;
+    std::string scratch_;
+
+    bool fail(const char* message) {
+        cursor_.fail(cursor_.begin(), message);
+        return false;
+    }
+
+    /**
+     * @brief Key of the last string token; valid until the next string is read
+     */
+    bool read_key(Token t, std::string_view& key) {
+        if (t != Token::STRING) return fail("Object key expected");
+        return cursor_.string_value(scratch_, key);
+    }
+
+    /**
+     * @brief Pool index of the last string token
+     */
+    bool intern(uint32_t& index) {
+        std::string_view value;
+        if (!cursor_.string_value(scratch_, value)) return false;
+        index = pool_.intern(value);
+        return true;
+    }
+
+    /**
+     * @brief index, or the pool index of "" for a missing string
+     */
+    uint32_t or_empty(uint32_t index) {
+        return index != NO_NODE ? index : pool_.intern(std::string_view());
+    }
+
+    bool read_string_field(uint32_t& index) {
+        Token t = cursor_.next();
+        if (t == Token::STRING) return intern(index);
+        return cursor_.skip(t) || fail("Invalid value");
+    }
+
+    bool read_number_field(double& value) {
+        Token t = cursor_.next();
+        if (t == Token::NUMBER) {
+            value = cursor_.number();
+            return true;
+        }
+        return cursor_.skip(t) || fail("Invalid value");
+    }
+
+    bool read_graph() {
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == Token::OBJECT_END) return true;
+            std::string_view key;
+            if (!read_key(t, key)) return false;
+
+            Token value = cursor_.next();
+            bool ok;
+            if (key == "nodes" && (value == Token::OBJECT_START || value == Token::ARRAY_START)) {
+                ok = read_nodes(value == Token::OBJECT_START);
+            } else if (key == "edges" && (value == Token::OBJECT_START || value == Token::ARRAY_START)) {
+                ok = read_edges(value == Token::OBJECT_START);
+            } else {
+                ok = cursor_.skip(value) || fail("Invalid value");
+            }
+            if (!ok) return false;
+        }
+    }
+
+    /**
+     * @brief { id: node } as exported, or [node] with ids in the records
+     */
+    bool read_nodes(bool keyed) {
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == (keyed ? Token::OBJECT_END : Token::ARRAY_END)) return true;
+
+            uint32_t id = NO_NODE;
+            if (keyed) {
+                if (t != Token::STRING) return fail("Object key expected");
+                if (!intern(id)) return false;
+                t = cursor_.next();
+            }
+            if (t != Token::OBJECT_START) {
+                if (!cursor_.skip(t)) return fail("Invalid value");
+                continue;
+            }
+            if (!read_node(id)) return false;
+        }
+    }
+
+    bool read_node(uint32_t id) {
+        const double absent = std::numeric_limits<double>::quiet_NaN();
+        uint32_t field_id = NO_NODE;
+        uint32_t type = NO_NODE;
+        uint32_t file_path = NO_NODE;
+        uint32_t name = NO_NODE;
+        uint32_t domain = NO_NODE;
+        double lines_of_code = absent;
+        double complexity = absent;
+
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == Token::OBJECT_END) break;
+            std::string_view key;
+            if (!read_key(t, key)) return false;
+
+            bool ok;
+            if (key == "id") {
+                ok = read_string_field(field_id);
+            } else if (key == "type") {
+                ok = read_string_field(type);
+            } else if (key == "filePath") {
+                ok = read_string_field(file_path);
+            } else if (key == "name") {
+                ok = read_string_field(name);
+            } else if (key == "metadata") {
+                ok = read_metadata(lines_of_code, complexity, domain);
+            } else {
+                ok = cursor_.skip(cursor_.next()) || fail("Invalid value");
+            }
+            if (!ok) return false;
+        }
+
+        // The map key wins over the record's own id, as in the JS Map
+        if (id == NO_NODE) id = field_id;
+        if (id == NO_NODE) return true;
+
+        graph_.node_id.push_back(id);
+        graph_.node_type.push_back(or_empty(type));
+        graph_.node_file_path.push_back(or_empty(file_path));
+        graph_.node_name.push_back(or_empty(name));
+        graph_.node_domain.push_back(domain);
+        graph_.node_lines_of_code.push_back(lines_of_code);
+        graph_.node_complexity.push_back(complexity);
+        return true;
+    }
+
+    bool read_metadata(double& lines_of_code, double& complexity, uint32_t& domain) {
+        Token t = cursor_.next();
+        if (t != Token::OBJECT_START) return cursor_.skip(t) || fail("Invalid value");
+
+        for (;;) {
+            t = cursor_.next();
+            if (t == Token::OBJECT_END) return true;
+            std::string_view key;
+            if (!read_key(t, key)) return false;
+
+            bool ok;
+            if (key == "linesOfCode") {
+                ok = read_number_field(lines_of_code);
+            } else if (key == "complexity") {
+                ok = read_number_field(complexity);
+            } else if (key == "domain") {
+                ok = read_string_field(domain);
+            } else {
+                ok = cursor_.skip(cursor_.next()) || fail("Invalid value");
+            }
+            if (!ok) return false;
+        }
+    }
+
+    /**
+     * @brief { from: [edge] } as exported, or a flat [edge]
+     */
+    bool read_edges(bool keyed) {
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == (keyed ? Token::OBJECT_END : Token::ARRAY_END)) return true;
+
+            if (!keyed) {
+                if (t == Token::OBJECT_START) {
+                    if (!read_edge(NO_NODE)) return false;
+                } else if (!cursor_.skip(t)) {
+                    return fail("Invalid value");
+                }
+                continue;
+            }
+
+            uint32_t from;
+            if (t != Token::STRING) return fail("Object key expected");
+            if (!intern(from)) return false;
+
+            t = cursor_.next();
+            if (t != Token::ARRAY_START) {
+                if (!cursor_.skip(t)) return fail("Invalid value");
+                continue;
+            }
+            for (;;) {
+                t = cursor_.next();
+                if (t == Token::ARRAY_END) break;
+                if (t == Token::OBJECT_START) {
+                    if (!read_edge(from)) return false;
+                } else if (!cursor_.skip(t)) {
+                    return fail("Invalid value");
+                }
+            }
+        }
+    }
+
+    bool read_edge(uint32_t from) {
+        uint32_t field_from = NO_NODE;
+        uint32_t to = NO_NODE;
+        uint32_t type = NO_NODE;
+        double weight = 1;
+
+        for (;;) {
+            Token t = cursor_.next();
+            if (t == Token::OBJECT_END) break;
+            std::string_view key;
+            if (!read_key(t, key)) return false;
+
+            bool ok;
+            if (key == "from") {
+                ok = read_string_field(field_from);
+            } else if (key == "to") {
+                ok = read_string_field(to);
+            } else if (key == "type") {
+                ok = read_string_field(type);
+            } else if (key == "weight") {
+                ok = read_number_field(weight);
+            } else {
+                ok = cursor_.skip(cursor_.next()) || fail("Invalid value");
+            }
+            if (!ok) return false;
+        }
+
+        if (from == NO_NODE) from = field_from;
+        if (from == NO_NODE || to == NO_NODE) return true;
+
+        graph_.edge_from.push_back(from);
+        graph_.edge_to.push_back(to);
+        graph_.edge_type.push_back(or_empty(type));
+        graph_.edge_weight.push_back(weight);
+        return true;
+    }
+};
+
+} // namespace
+
+bool read_export(std::string_view json, ExportDocument& out) {
+    out = ExportDocument();
+    if (json.size() >= UINT32_MAX) {
+        out.error = "Document too large";
+        return false;
+    }
+
+    ExportReader reader(json, out);
+    bool ok = reader.read() && !reader.failed();
+    if (!ok) {
+        out.error = reader.cursor().error().empty() ? "Invalid document" : reader.cursor().error();
+        out.error_offset = reader.cursor().error_offset();
+    }
+    return ok;
+}
+
+bool read_export_file(const std::string& path, ExportDocument& out) {
+    MappedFile file;
+    if (!file.open(path)) {
+        out = ExportDocument();
+        out.error = "Cannot open file";
+        return false;
+    }
+    return read_export(std::string_view(file.data(), file.size()), out);
+}
+
+} // namespace graph
+} // namespace archicore
@@ -0,0 +1,375 @@
+/**
+ * @file reachability.cpp
+ * @brief SCC condensation and bitset transitive closure for impact queries
+ * @version 1.0.0
+ */
+
+#include "graph.h"
+#include <algorithm>
+#include <chrono>
+
+namespace archicore {
+namespace graph {
+
+// Edges added in place after a rebuild before the next one is cheaper
+static constexpr uint32_t MAX_INCREMENTAL_EDGES = 64;
+
+struct ReachabilityIndex::Impl {
+    ReachabilityConfig config;
+
+    std::vector<std::string> ids;
+    std::unordered_map<std::string, uint32_t> index_of;
+    std::vector<std::vector<uint32_t>> out;  // Dependencies of each node
+    std::vector<std::vector<uint32_t>> in;   // Dependents of each node
+    uint64_t edge_count = 0;
+
+    // Derived on rebuild
+    bool stale = true;
+    std::vector<uint32_t> component;        // Node -> component
+    uint32_t component_count = 0;
+    uint32_t largest_component = 0;
+    std::vector<uint32_t> member_offsets;   // Component -> first entry in members
+    std::vector<uint32_t> members;          // Nodes grouped by component
+    bool has_closure = false;
+    size_t words = 0;                       // Row width of the closure in 64-bit words
+    std::vector<uint64_t> closure;          // Row c: components depending on c (c included)
+    uint32_t incremental_edges = 0;
+    uint32_t rebuilds = 0;
+    double build_time_ms = 0;
+
+    // BFS scratch: a node is seen when seen[node] == epoch
+    std::vector<uint32_t> seen;
+    uint32_t epoch = 0;
+
+    mutable std::mutex mutex;
+
+    explicit Impl(const ReachabilityConfig& cfg) : config(cfg) {}
+
+    uint32_t add_node(const std::string& id) {
+        auto it = index_of.find(id);
+        if (it != index_of.end()) return it->second;
+
+        uint32_t node = static_cast<uint32_t>(ids.size());
+        ids.push_back(id);
+        index_of.emplace(id, node);
+        out.emplace_back();
+        in.emplace_back();
+        seen.push_back(0);
+
+        // A new node is a component of its own; the closure grows a row
+        // while the row width still has room
+        if (!stale) {
+            uint32_t c = component_count++;
+            component.push_back(c);
+            members.push_back(node);
+            member_offsets.push_back(static_cast<uint32_t>(members.size()));
+            if (has_closure) {
+                if (c < words * 64 && component_count <= config.closure_limit) {
+                    closure.resize(closure.size() + words, 0);
+                    set_bit(row(c), c);
+                } else {
+                    stale = true;
+                }
+            }
+        }
+        return node;
+    }
+
+    uint64_t* row(uint32_t c) { return closure.data() + c * words; }
+
+    static void set_bit(uint64_t* bits, uint32_t i) { bits[i >> 6] |= uint64_t{1} << (i & 63); }
+    static bool test_bit(const uint64_t* bits, uint32_t i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+
+    uint32_t next_epoch() {
+        if (++epoch == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            epoch = 1;
+        }
+        return epoch;
+    }
+
+    void on_add_edge(uint32_t from, uint32_t to) {
+        if (stale) return;
+        if (!has_closure || ++incremental_edges > MAX_INCREMENTAL_EDGES) {
+            // Components may merge; Tarjan is cheaper than tracking it here
+            stale = true;
+            return;
+        }
+
+        uint32_t cf = component[from];
+        uint32_t ct = component[to];
+        if (cf == ct) return;
+
+        // to already depends on from: the edge closes a cycle
+        if (test_bit(row(cf), ct)) {
+            stale = true;
+            return;
+        }
+
+        // Everything `to` depends on (its row contains ct) now also has
+        // from's dependents
+        std::vector<uint64_t> gained(row(cf), row(cf) + words);
+        for (uint32_t c = 0; c < component_count; c++) {
+            uint64_t* r = row(c);
+            if (!test_bit(r, ct)) continue;
+            for (size_t w = 0; w < words; w++) r[w] |= gained[w];
+        }
+    }
+
+    void ensure() {
+        if (stale) rebuild();
+    }
+
+    void rebuild() {
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        condense();
+        build_closure();
+
+        stale = false;
+        incremental_edges = 0;
+        rebuilds++;
+        auto end_time = std::chrono::high_resolution_clock::now();
+        build_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    }
+
+    /**
+     * @brief Tarjan condensation; components come out dependencies first
+     */
+    void condense() {
+        uint32_t n = static_cast<uint32_t>(ids.size());
+        component_count = tarjan_scc(n, [this](uint32_t node) -> const std::vector<uint32_t>& {
+            return out[node];
+        }, component);
+
+        // Group members by component (counting sort)
+        member_offsets.assign(component_count + 1, 0);
+        for (uint32_t node = 0; node < n; node++) member_offsets[component[node] + 1]++;
+        for (uint32_t c = 0; c < component_count; c++) member_offsets[c + 1] += member_offsets[c];
+        members.assign(n, 0);
+        std::vector<uint32_t> cursor(member_offsets.begin(), member_offsets.end() - 1);
+        for (uint32_t node = 0; node < n; node++) members[cursor[component[node]]++] = node;
+
+        largest_component = 0;
+        for (uint32_t c = 0; c < component_count; c++) {
+            largest_component = std::max(largest_component, member_offsets[c + 1] - member_offsets[c]);
+        }
+    }
+
+    void build_closure() {
+        has_closure = component_count > 0 && component_count <= config.closure_limit;
+        if (!has_closure) {
+            words = 0;
+            closure.clear();
+            closure.shrink_to_fit();
+            return;
+        }
+
+        // Leave room for a few nodes added later without a rebuild
+        words = (component_count + 64) / 64;
+        closure.assign(component_count * words, 0);
+
+        // Dependents of c were emitted after c, so their rows are complete
+        for (uint32_t c = component_count; c-- > 0;) {
+            uint64_t* r = row(c);
+            set_bit(r, c);
+            for (uint32_t m = member_offsets[c]; m < member_offsets[c + 1]; m++) {
+                for (uint32_t dependent : in[members[m]]) {
+                    uint32_t d = component[dependent];
+                    if (d == c) continue;
+                    const uint64_t* dr = row(d);
+                    for (size_t w = 0; w < words; w++) r[w] |= dr[w];
+                }
+            }
+        }
+    }
+};
+
+ReachabilityIndex::ReachabilityIndex(const ReachabilityConfig& config)
+    : impl_(std::make_unique<Impl>(config)) {}
+
+ReachabilityIndex::~ReachabilityIndex() = default;
+
+uint32_t ReachabilityIndex::add_node(const std::string& id) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->add_node(id);
+}
+
+uint32_t ReachabilityIndex::find_node(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->index_of.find(id);
+    return it == impl_->index_of.end() ? NO_NODE : it->second;
+}
+
+std::string ReachabilityIndex::node_id(uint32_t node) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return node < impl_->ids.size() ? impl_->ids[node] : std::string();
+}
+
+bool ReachabilityIndex::add_edge(const std::string& from, const std::string& to) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint32_t f = impl_->add_node(from);
+    uint32_t t = impl_->add_node(to);
+
+    auto& deps = impl_->out[f];
+    if (std::find(deps.begin(), deps.end(), t) != deps.end()) return false;
+    deps.push_back(t);
+    impl_->in[t].push_back(f);
+    impl_->edge_count++;
+
+    impl_->on_add_edge(f, t);
+    return true;
+}
+
+bool ReachabilityIndex::remove_edge(const std::string& from, const std::string& to) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto fi = impl_->index_of.find(from);
+    auto ti = impl_->index_of.find(to);
+    if (fi == impl_->index_of.end() || ti == impl_->index_of.end()) return false;
+
+    auto& deps = impl_->out[fi->second];
+    auto it = std::find(deps.begin(), deps.end(), ti->second);
+    if (it == deps.end()) return false;
+    deps.erase(it);
+
+    auto& dependents = impl_->in[ti->second];
+    dependents.erase(std::find(dependents.begin(), dependents.end(), fi->second));
+    impl_->edge_count--;
+
+    // A removal can split components and shrink rows: rebuild lazily
+    impl_->stale = true;
+    return true;
+}
+
+void ReachabilityIndex::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    ReachabilityConfig config = impl_->config;
+    uint32_t rebuilds = impl_->rebuilds;
+    impl_ = std::make_unique<Impl>(config);
+    impl_->rebuilds = rebuilds;
+}
+
+bool ReachabilityIndex::depends_on(uint32_t from, uint32_t to) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& impl = *impl_;
+    if (from >= impl.ids.size() || to >= impl.ids.size()) return false;
+    if (from == to) return true;
+
+    impl.ensure();
+    uint32_t cf = impl.component[from];
+    uint32_t ct = impl.component[to];
+    if (cf == ct) return true;
+    if (impl.has_closure) return Impl::test_bit(impl.row(ct), cf);
+
+    // No closure: search dependencies of from
+    uint32_t epoch = impl.next_epoch();
+    std::vector<uint32_t> queue{from};
+    impl.seen[from] = epoch;
+    for (size_t head = 0; head < queue.size(); head++) {
+        for (uint32_t next : impl.out[queue[head]]) {
+            if (next == to) return true;
+            if (impl.seen[next] == epoch) continue;
+            impl.seen[next] = epoch;
+            queue.push_back(next);
+        }
+    }
+    return false;
+}
+
+std::vector<AffectedNode> ReachabilityIndex::affected(const std::vector<uint32_t>& changed,
+                                                      uint32_t max_depth) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& impl = *impl_;
+    std::vector<AffectedNode> result;
+
+    // Multi-source BFS over dependents; needs no derived state
+    uint32_t epoch = impl.next_epoch();
+    for (uint32_t node : changed) {
+        if (node >= impl.ids.size() || impl.seen[node] == epoch) continue;
+        impl.seen[node] = epoch;
+        result.push_back({node, 0});
+    }
+
+    for (size_t head = 0; head < result.size(); head++) {
+        AffectedNode current = result[head];
+        if (max_depth != 0 && current.distance >= max_depth) continue;
+        for (uint32_t dependent : impl.in[current.node]) {
+            if (impl.seen[dependent] == epoch) continue;
+            impl.seen[dependent] = epoch;
+            result.push_back({dependent, current.distance + 1});
+        }
+    }
+
+    return result;
+}
+
+std::vector<uint32_t> ReachabilityIndex::affected_set(const std::vector<uint32_t>& changed) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& impl = *impl_;
+    std::vector<uint32_t> result;
+
+    impl.ensure();
+    if (!impl.has_closure) {
+        // No closure: one unbounded search over dependents
+        uint32_t epoch = impl.next_epoch();
+        for (uint32_t node : changed) {
+            if (node >= impl.ids.size() || impl.seen[node] == epoch) continue;
+            impl.seen[node] = epoch;
+            result.push_back(node);
+        }
+        for (size_t head = 0; head < result.size(); head++) {
+            for (uint32_t dependent : impl.in[result[head]]) {
+                if (impl.seen[dependent] == epoch) continue;
+                impl.seen[dependent] = epoch;
+                result.push_back(dependent);
+            }
+        }
+    } else {
+        std::vector<uint64_t> acc(impl.words, 0);
+        for (uint32_t node : changed) {
+            if (node >= impl.ids.size()) continue;
+            const uint64_t* r = impl.row(impl.component[node]);
+            for (size_t w = 0; w < impl.words; w++) acc[w] |= r[w];
+        }
+        for (size_t w = 0; w < impl.words; w++) {
+            uint64_t bits = acc[w];
+            while (bits) {
+                uint32_t c = static_cast<uint32_t>(w * 64 + trailing_zeros(bits));
+                bits &= bits - 1;
+                for (uint32_t m = impl.member_offsets[c]; m < impl.member_offsets[c + 1]; m++) {
+                    result.push_back(impl.members[m]);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+uint32_t ReachabilityIndex::component_of(uint32_t node) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (node >= impl_->ids.size()) return NO_NODE;
+    impl_->ensure();
+    return impl_->component[node];
+}
+
+ReachabilityStats ReachabilityIndex::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& impl = *impl_;
+    impl.ensure();
+
+    ReachabilityStats stats;
+    stats.node_count = static_cast<uint32_t>(impl.ids.size());
+    stats.edge_count = impl.edge_count;
+    stats.component_count = impl.component_count;
+    stats.largest_component = impl.largest_component;
+    stats.has_closure = impl.has_closure;
+    stats.closure_bytes = impl.closure.size() * sizeof(uint64_t);
+    stats.rebuilds = impl.rebuilds;
+    stats.build_time_ms = impl.build_time_ms;
+    return stats;
+}
+
+} // namespace graph
+} // namespace archicore
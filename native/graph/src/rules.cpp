@@ -0,0 +1,402 @@
+/**
+ * @file rules.cpp
+ * @brief Incremental architecture rule evaluation over node group bitsets
+ * @version 1.0.0
+ */
+
+#include "graph.h"
+#include <chrono>
+
+namespace archicore {
+namespace graph {
+
+namespace {
+
+/**
+ * @brief A set of nodes as a bitset, grown as nodes are added
+ */
+struct Group {
+    std::vector<GlobMatcher> globs;     // Empty for explicit groups
+    bool explicit_members = false;
+    std::vector<uint64_t> bits;
+
+    bool test(uint32_t node) const {
+        size_t word = node >> 6;
+        return word < bits.size() && ((bits[word] >> (node & 63)) & 1);
+    }
+
+    // Returns whether the membership changed
+    bool assign(uint32_t node, bool member) {
+        size_t word = node >> 6;
+        if (word >= bits.size()) bits.resize(word + 1, 0);
+        uint64_t mask = uint64_t(1) << (node & 63);
+        bool was = (bits[word] & mask) != 0;
+        if (member) bits[word] |= mask;
+        else bits[word] &= ~mask;
+        return was != member;
+    }
+
+    bool matches(const std::string& path) const {
+        for (const auto& glob : globs) {
+            if (glob.match(path)) return true;
+        }
+        return false;
+    }
+};
+
+struct Rule {
+    RuleKind kind;
+    uint32_t source_group = NO_NODE;    // Forbidden source / max-dependency scope
+    uint32_t target_group = NO_NODE;
+    uint32_t limit = 0;
+    std::vector<uint32_t> layers;       // Group per layer
+    std::vector<uint64_t> allowed;      // Allowed target layers per layer
+
+    bool stale = true;                  // Needs a full evaluation
+    std::unordered_map<uint32_t, std::vector<RuleViolation>> by_node;
+    std::vector<RuleViolation> sorted;  // by_node flattened; rebuilt when the rule is re-checked
+};
+
+} // namespace
+
+struct RuleEvaluator::Impl {
+    std::vector<std::string> ids;
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, uint32_t> index_of;
+
+    std::vector<std::vector<uint32_t>> out;     // Dependencies, ascending and unique
+    std::vector<std::vector<uint32_t>> in;      // Dependents, unordered
+    std::vector<uint32_t> dependency_count;     // Dependencies as given
+    uint64_t edge_count = 0;
+
+    std::vector<Group> groups;
+    std::vector<Rule> rules;
+
+    std::vector<uint32_t> dirty;
+    std::vector<char> is_dirty;
+
+    RuleEvaluatorStats stats;
+    mutable std::mutex mutex;
+
+    void mark_dirty(uint32_t node) {
+        if (is_dirty[node]) return;
+        is_dirty[node] = 1;
+        dirty.push_back(node);
+    }
+
+    // A node entering or leaving a group changes its own edges' verdicts
+    // and those of every edge into it
+    void membership_changed(uint32_t node) {
+        mark_dirty(node);
+        for (uint32_t dependent : in[node]) mark_dirty(dependent);
+    }
+
+    uint32_t add_node(const std::string& id, const std::string& path) {
+        auto it = index_of.find(id);
+        if (it != index_of.end()) {
+            uint32_t node = it->second;
+            if (paths[node] == path) return node;
+
+            paths[node] = path;
+            bool changed = false;
+            for (auto& group : groups) {
+                if (group.explicit_members) continue;
+                changed = group.assign(node, group.matches(path)) || changed;
+            }
+            if (changed) membership_changed(node);
+            return node;
+        }
+
+        uint32_t node = static_cast<uint32_t>(ids.size());
+        ids.push_back(id);
+        paths.push_back(path);
+        index_of.emplace(id, node);
+        out.emplace_back();
+        in.emplace_back();
+        dependency_count.push_back(0);
+        is_dirty.push_back(0);
+
+        for (auto& group : groups) {
+            group.assign(node, !group.explicit_members && group.matches(path));
+        }
+        mark_dirty(node);
+        return node;
+    }
+
+    uint32_t layer_of(const Rule& rule, uint32_t node) const {
+        for (uint32_t layer = 0; layer < rule.layers.size(); layer++) {
+            if (groups[rule.layers[layer]].test(node)) return layer;
+        }
+        return NO_NODE;
+    }
+
+    /**
+     * @brief Check one source node against a rule
+     * @return false if the node is outside the rule's source scope
+     */
+    bool check(uint32_t rule_index, uint32_t node, std::vector<RuleViolation>& found) const {
+        const Rule& rule = rules[rule_index];
+        switch (rule.kind) {
+            case RuleKind::FORBIDDEN_DEPENDENCY: {
+                if (!groups[rule.source_group].test(node)) return false;
+                const Group& target = groups[rule.target_group];
+                for (uint32_t dep : out[node]) {
+                    if (target.test(dep)) found.push_back({rule_index, node, dep, 0, 0, 0});
+                }
+                return true;
+            }
+            case RuleKind::LAYER_BOUNDARY: {
+                uint32_t source_layer = layer_of(rule, node);
+                if (source_layer == NO_NODE) return false;
+                for (uint32_t dep : out[node]) {
+                    uint32_t target_layer = layer_of(rule, dep);
+                    if (target_layer == NO_NODE || target_layer == source_layer) continue;
+                    if ((rule.allowed[source_layer] >> target_layer) & 1) continue;
+                    found.push_back({rule_index, node, dep, source_layer, target_layer, 0});
+                }
+                return true;
+            }
+            case RuleKind::MAX_DEPENDENCIES: {
+                if (rule.source_group != NO_NODE && !groups[rule.source_group].test(node)) return false;
+                if (dependency_count[node] > rule.limit) {
+                    found.push_back({rule_index, node, NO_NODE, 0, 0, dependency_count[node]});
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void recheck(uint32_t rule_index, uint32_t node) {
+        Rule& rule = rules[rule_index];
+        rule.by_node.erase(node);
+        std::vector<RuleViolation> found;
+        if (check(rule_index, node, found) && !found.empty()) rule.by_node.emplace(node, std::move(found));
+    }
+
+    uint32_t add_rule(Rule rule) {
+        uint32_t index = static_cast<uint32_t>(rules.size());
+        rules.push_back(std::move(rule));
+        return index;
+    }
+};
+
+RuleEvaluator::RuleEvaluator() : impl_(std::make_unique<Impl>()) {}
+RuleEvaluator::~RuleEvaluator() = default;
+
+uint32_t RuleEvaluator::add_node(const std::string& id, const std::string& path) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->add_node(id, path);
+}
+
+uint32_t RuleEvaluator::find_node(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto it = impl_->index_of.find(id);
+    return it == impl_->index_of.end() ? NO_NODE : it->second;
+}
+
+std::string RuleEvaluator::node_id(uint32_t node) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return node < impl_->ids.size() ? impl_->ids[node] : std::string();
+}
+
+void RuleEvaluator::set_dependencies(const std::string& from, const std::vector<std::string>& targets) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+
+    // Missing nodes are matched by their id until given a path
+    uint32_t source = d.index_of.count(from) ? d.index_of[from] : d.add_node(from, from);
+    std::vector<uint32_t> deps;
+    deps.reserve(targets.size());
+    for (const auto& target : targets) {
+        auto it = d.index_of.find(target);
+        deps.push_back(it != d.index_of.end() ? it->second : d.add_node(target, target));
+    }
+    std::sort(deps.begin(), deps.end());
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+    uint32_t count = static_cast<uint32_t>(targets.size());
+    std::vector<uint32_t>& old = d.out[source];
+    if (deps == old && d.dependency_count[source] == count) return;
+
+    // Both lists are sorted: walk them together to patch reverse adjacency
+    size_t i = 0, j = 0;
+    while (i < old.size() || j < deps.size()) {
+        if (j == deps.size() || (i < old.size() && old[i] < deps[j])) {
+            auto& list = d.in[old[i++]];
+            list.erase(std::find(list.begin(), list.end(), source));
+        } else if (i == old.size() || deps[j] < old[i]) {
+            d.in[deps[j++]].push_back(source);
+        } else {
+            i++;
+            j++;
+        }
+    }
+
+    d.edge_count = d.edge_count - old.size() + deps.size();
+    old = std::move(deps);
+    d.dependency_count[source] = count;
+    d.mark_dirty(source);
+}
+
+uint32_t RuleEvaluator::add_glob_group(const std::vector<std::string>& globs) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+
+    Group group;
+    for (const auto& glob : globs) group.globs.emplace_back(glob);
+    group.bits.assign((d.ids.size() + 63) / 64, 0);
+    for (uint32_t node = 0; node < d.ids.size(); node++) {
+        if (group.matches(d.paths[node])) group.assign(node, true);
+    }
+
+    d.groups.push_back(std::move(group));
+    return static_cast<uint32_t>(d.groups.size() - 1);
+}
+
+uint32_t RuleEvaluator::add_group() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Group group;
+    group.explicit_members = true;
+    group.bits.assign((impl_->ids.size() + 63) / 64, 0);
+    impl_->groups.push_back(std::move(group));
+    return static_cast<uint32_t>(impl_->groups.size() - 1);
+}
+
+bool RuleEvaluator::set_member(uint32_t group, uint32_t node, bool member) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    if (group >= d.groups.size() || !d.groups[group].explicit_members || node >= d.ids.size()) return false;
+
+    if (d.groups[group].assign(node, member)) d.membership_changed(node);
+    return true;
+}
+
+uint32_t RuleEvaluator::add_forbidden_rule(uint32_t source_group, uint32_t target_group) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (source_group >= impl_->groups.size() || target_group >= impl_->groups.size()) return NO_NODE;
+
+    Rule rule;
+    rule.kind = RuleKind::FORBIDDEN_DEPENDENCY;
+    rule.source_group = source_group;
+    rule.target_group = target_group;
+    return impl_->add_rule(std::move(rule));
+}
+
+uint32_t RuleEvaluator::add_layer_rule(const std::vector<uint32_t>& layer_groups,
+                                       const std::vector<uint64_t>& allowed) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (layer_groups.size() > MAX_LAYERS || allowed.size() != layer_groups.size()) return NO_NODE;
+    for (uint32_t group : layer_groups) {
+        if (group >= impl_->groups.size()) return NO_NODE;
+    }
+
+    Rule rule;
+    rule.kind = RuleKind::LAYER_BOUNDARY;
+    rule.layers = layer_groups;
+    rule.allowed = allowed;
+    return impl_->add_rule(std::move(rule));
+}
+
+uint32_t RuleEvaluator::add_max_dependencies_rule(uint32_t limit, uint32_t group) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (group != NO_NODE && group >= impl_->groups.size()) return NO_NODE;
+
+    Rule rule;
+    rule.kind = RuleKind::MAX_DEPENDENCIES;
+    rule.source_group = group;
+    rule.limit = limit;
+    return impl_->add_rule(std::move(rule));
+}
+
+std::vector<RuleViolation> RuleEvaluator::evaluate() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    uint32_t rules_evaluated = 0;
+    uint32_t nodes_rechecked = 0;
+    uint32_t node_count = static_cast<uint32_t>(d.ids.size());
+
+    std::vector<RuleViolation> violations;
+    for (uint32_t r = 0; r < d.rules.size(); r++) {
+        Rule& rule = d.rules[r];
+        bool changed = false;
+        if (rule.stale) {
+            rule.by_node.clear();
+            for (uint32_t node = 0; node < node_count; node++) d.recheck(r, node);
+            rule.stale = false;
+            rules_evaluated++;
+            nodes_rechecked += node_count;
+            changed = true;
+        } else {
+            // Dirty nodes that left the scope still drop their old violations
+            bool touched = false;
+            std::vector<RuleViolation> found;
+            for (uint32_t node : d.dirty) {
+                changed = rule.by_node.erase(node) > 0 || changed;
+                found.clear();
+                if (!d.check(r, node, found)) continue;
+                touched = true;
+                nodes_rechecked++;
+                if (!found.empty()) {
+                    rule.by_node.emplace(node, found);
+                    changed = true;
+                }
+            }
+            if (touched) rules_evaluated++;
+        }
+
+        if (changed) {
+            rule.sorted.clear();
+            for (const auto& entry : rule.by_node) {
+                rule.sorted.insert(rule.sorted.end(), entry.second.begin(), entry.second.end());
+            }
+            std::sort(rule.sorted.begin(), rule.sorted.end(),
+                      [](const RuleViolation& a, const RuleViolation& b) {
+                          return a.from != b.from ? a.from < b.from : a.to < b.to;
+                      });
+        }
+        violations.insert(violations.end(), rule.sorted.begin(), rule.sorted.end());
+    }
+
+    for (uint32_t node : d.dirty) d.is_dirty[node] = 0;
+    d.dirty.clear();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    d.stats.rules_evaluated = rules_evaluated;
+    d.stats.nodes_rechecked = nodes_rechecked;
+    d.stats.violation_count = static_cast<uint32_t>(violations.size());
+    d.stats.eval_time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return violations;
+}
+
+void RuleEvaluator::clear() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    Impl& d = *impl_;
+    d.ids.clear();
+    d.paths.clear();
+    d.index_of.clear();
+    d.out.clear();
+    d.in.clear();
+    d.dependency_count.clear();
+    d.edge_count = 0;
+    d.groups.clear();
+    d.rules.clear();
+    d.dirty.clear();
+    d.is_dirty.clear();
+    d.stats = RuleEvaluatorStats{};
+}
+
+RuleEvaluatorStats RuleEvaluator::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    RuleEvaluatorStats s = impl_->stats;
+    s.node_count = static_cast<uint32_t>(impl_->ids.size());
+    s.edge_count = impl_->edge_count;
+    s.group_count = static_cast<uint32_t>(impl_->groups.size());
+    s.rule_count = static_cast<uint32_t>(impl_->rules.size());
+    return s;
+}
+
+} // namespace graph
+} // namespace archicore
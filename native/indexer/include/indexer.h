@@ -39,6 +39,18 @@ struct FileEntry {
     uint64_t mtime;             // Last modification time (ms since epoch)
     Language language;          // Detected language
     bool is_indexed;            // Whether content has been indexed
+    uint8_t flags = 0;          // FileFlags from classify_content (0 = not classified)
+    uint64_t semantic_hash = 0; // Hash ignoring whitespace and comments (0 = not computed)
+};
+
+/**
+ * @brief Facts gathered about a file while it is mapped for hashing
+ */
+struct FileDigest {
+    uint64_t content_hash = 0;              // xxHash64 of content
+    Language language = Language::UNKNOWN;  // Extension table + content sniffing
+    uint8_t flags = 0;                      // FileFlags (binary, minified, generated, ...)
+    uint64_t semantic_hash = 0;             // Whitespace/comment-insensitive hash (if requested)
 };
 
 /**
@@ -61,6 +73,14 @@ enum class ChangeType {
     RENAMED
 };
 
+/**
+ * @brief What a modification changed
+ */
+enum class ChangeKind {
+    SEMANTIC,       // Token stream changed (or could not be compared)
+    FORMAT_ONLY     // Only whitespace, indentation or comments changed
+};
+
 /**
  * @brief Represents a detected file change
  */
@@ -70,6 +90,7 @@ struct FileChange {
     std::string old_path;       // For renames
     uint64_t old_hash;
     uint64_t new_hash;
+    ChangeKind kind = ChangeKind::SEMANTIC;
 };
 
 /**
@@ -94,6 +115,7 @@ struct DiffResult {
     uint32_t modified_count;
     uint32_t deleted_count;
     uint32_t renamed_count;
+    uint32_t format_only_count = 0;  // Modifications that are FORMAT_ONLY
     double diff_time_ms;
     std::string error;
 };
@@ -107,10 +129,43 @@ struct IndexerConfig {
     bool follow_symlinks = false;
     bool compute_content_hash = true;
     bool detect_renames = true;
+    bool compute_semantic_hash = false;  // Also hash the whitespace/comment-free token stream
     uint32_t max_file_size = 10 * 1024 * 1024;  // 10MB default
     uint32_t parallel_workers = 4;
 };
 
+/**
+ * @brief Part of a tree scanned on its own (one machine, job or process)
+ *
+ * Paths are relative to the repository root. A shard covers every path
+ * under one of its roots and under none of its excludes.
+ */
+struct ShardSpec {
+    std::vector<std::string> roots;     // Subtrees to scan ("" or none = the whole tree)
+    std::vector<std::string> exclude;   // Subtrees left to other shards
+};
+
+/**
+ * @brief Partial index of one shard, input of merge_partials()
+ */
+struct IndexPartial {
+    ShardSpec shard;
+    const FileIndex* index = nullptr;
+};
+
+/**
+ * @brief Result of merging partial indexes
+ */
+struct MergeResult {
+    bool success = false;
+    uint64_t merkle_root = 0;
+    uint32_t total_files = 0;
+    uint32_t overlap_files = 0;             // Files reported by more than one shard
+    std::vector<std::string> conflicts;     // Paths overlapping shards disagree on (sorted)
+    double merge_time_ms = 0;
+    std::string error;
+};
+
 /**
  * @brief Callback for progress reporting
  */
@@ -148,6 +203,39 @@ public:
         uint32_t num_workers = 4
     );
 
+    /**
+     * @brief Hash a file, detect its language and classify it in the same mapping
+     * @param path File path
+     * @param semantic Also compute the semantic hash from the same mapping
+     * @return File digest (zero hash on error)
+     */
+    FileDigest digest_file(const std::string& path, bool semantic = false);
+
+    /**
+     * @brief Hash content with whitespace and comments stripped
+     *
+     * Two sources that differ only in formatting or comments hash equal.
+     * Falls back to the content hash for Language::UNKNOWN and for binary or
+     * high-entropy content.
+     * @param content Source text
+     * @param language Language, selecting the comment and string syntax
+     * @return Semantic hash
+     */
+    uint64_t hash_semantic(std::string_view content, Language language);
+
+    /**
+     * @brief Digest multiple files in parallel
+     * @param paths File paths
+     * @param num_workers Number of worker threads
+     * @param semantic Also compute semantic hashes
+     * @return Vector of digests, in the order of paths
+     */
+    std::vector<FileDigest> digest_files_parallel(
+        const std::vector<std::string>& paths,
+        uint32_t num_workers = 4,
+        bool semantic = false
+    );
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -236,6 +324,35 @@ public:
         ProgressCallback progress = nullptr
     );
 
+    /**
+     * @brief Scan one shard of a directory
+     *
+     * Paths stay relative to root_path and the include/exclude patterns
+     * apply to them exactly as in scan(), so shards that together cover
+     * the tree merge into the index a full scan would build.
+     * @param root_path Repository root
+     * @param shard Subtrees to scan
+     * @param progress Optional progress callback
+     * @return Scan result with the shard's files
+     */
+    ScanResult scan_shard(
+        const std::string& root_path,
+        const ShardSpec& shard,
+        ProgressCallback progress = nullptr
+    );
+
+    /**
+     * @brief Split a directory into shards of similar file counts
+     *
+     * Top-level directories are balanced across the shards; the first
+     * shard also takes the files in the root and excludes the others.
+     * Counting walks the tree without hashing anything.
+     * @param root_path Repository root
+     * @param count Desired number of shards
+     * @return Disjoint shards covering the tree (fewer if there are few directories)
+     */
+    std::vector<ShardSpec> plan_shards(const std::string& root_path, uint32_t count);
+
     /**
      * @brief Compute diff between two scans
      * @param old_scan Previous scan result
@@ -280,7 +397,10 @@ private:
     IndexerConfig config_;
     std::unique_ptr<MerkleTree> merkle_tree_;
     std::unique_ptr<FileHasher> hasher_;
+    std::vector<GlobMatcher> include_matchers_;
+    std::vector<GlobMatcher> exclude_matchers_;
 
+    void compile_patterns();
     bool should_include(const std::string& path) const;
     bool should_exclude(const std::string& path) const;
     std::vector<FileChange> detect_renames(
@@ -367,6 +487,161 @@ public:
      */
     uint64_t merkle_hash() const;
 
+    /**
+     * @brief Get Merkle hash of a directory
+     * @param dir_path Directory path ("" = root)
+     * @return Merkle hash, 0 if the directory holds no files
+     */
+    uint64_t subtree_hash(const std::string& dir_path) const;
+
+    /**
+     * @brief Check the Merkle tree against the entries
+     *
+     * The tree is persisted next to the entries; a loaded index can
+     * disagree with itself after corruption or a partial write.
+     * @return Paths whose hashes disagree (empty = consistent)
+     */
+    std::vector<std::string> verify() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Merge partial indexes of shards into one index
+ *
+ * Shards may be disjoint or overlap (the same subtree scanned twice, or a
+ * subtree inside another shard's root). Every partial is first checked
+ * against its own Merkle tree; overlapping shards must then agree on the
+ * content of every path they share and on which paths exist. Entries
+ * that differ only in metadata (mtime, ...) resolve the same way
+ * regardless of partial order, so the merge is deterministic, and its
+ * Merkle root equals that of a single scan of the whole tree.
+ *
+ * Runs in time linear in the number of entries.
+ * @param partials Partial indexes with the shards they cover
+ * @param out Receives the merged index (only on success)
+ * @return Merge result
+ */
+MergeResult merge_partials(const std::vector<IndexPartial>& partials, FileIndex& out);
+
+/**
+ * @brief FileIndex snapshot shared between processes
+ *
+ * The segment is a POSIX shared-memory object ("shm:<name>") or any other
+ * path, mapped by one writer and any number of readers. The writer
+ * publishes whole snapshots into two alternating regions; entries are
+ * offset-based (sorted records, a path hash table and a string pool), so
+ * readers use the mapping directly without rebuilding anything.
+ *
+ * Readers never block the writer and take no cross-process lock: they
+ * read the region of the last published epoch and retry only when the
+ * writer has started reusing that region meanwhile (epoch versioning).
+ * A writer that dies mid-publish leaves the previous snapshot readable,
+ * also while it grows the segment: the new snapshot is written past both
+ * old regions before the layout switches. Only a writer killed between
+ * the final header stores of a grow leaves readers with nothing (reads
+ * fail) until the next writer takes the segment over.
+ *
+ * Not supported on Windows; create() and open() report an error there.
+ */
+class SharedFileIndex {
+public:
+    SharedFileIndex();
+    ~SharedFileIndex();
+
+    SharedFileIndex(const SharedFileIndex&) = delete;
+    SharedFileIndex& operator=(const SharedFileIndex&) = delete;
+
+    /**
+     * @brief Create or take over a segment as its single writer
+     * @param name "shm:<name>" for shared memory, otherwise a file path
+     * @param capacity Initial bytes per snapshot region (grows on demand)
+     * @param error Receives the reason on failure
+     * @return true on success; fails while another writer holds the segment
+     *         and for an existing non-empty file that is not a shared index
+     */
+    bool create(const std::string& name, uint64_t capacity, std::string& error);
+
+    /**
+     * @brief Attach to an existing segment as a reader
+     * @param name Segment name as given to create()
+     * @param error Receives the reason on failure
+     * @return true on success
+     */
+    bool open(const std::string& name, std::string& error);
+
+    /**
+     * @brief Unmap the segment (the writer also releases its lock)
+     */
+    void close();
+
+    /**
+     * @brief Publish a snapshot of an index (writer only)
+     * @param index Index to copy into the segment
+     * @param error Receives the reason on failure
+     * @return true once readers see the new snapshot
+     */
+    bool publish(const FileIndex& index, std::string& error);
+
+    /**
+     * @brief Remove a named segment (the file or shared-memory object)
+     * @param name Segment name
+     * @return true if something was removed
+     */
+    static bool unlink(const std::string& name);
+
+    /**
+     * @brief Look up a file entry
+     * @param path File path
+     * @param out Receives the entry
+     * @return true if found
+     */
+    bool get(const std::string& path, FileEntry& out) const;
+
+    /**
+     * @brief Check if file exists in the snapshot
+     */
+    bool contains(const std::string& path) const;
+
+    /**
+     * @brief Get all file entries, sorted by path
+     */
+    std::vector<FileEntry> get_all() const;
+
+    /**
+     * @brief Get files by language, sorted by path
+     */
+    std::vector<FileEntry> get_by_language(Language language) const;
+
+    /**
+     * @brief Number of files in the snapshot
+     */
+    size_t size() const;
+
+    /**
+     * @brief Merkle root of the snapshot
+     */
+    uint64_t merkle_hash() const;
+
+    /**
+     * @brief Epoch of the last published snapshot (0 = none yet)
+     *
+     * Grows with every publish; polling it is the cheap way to notice
+     * changes.
+     */
+    uint64_t epoch() const;
+
+    bool is_open() const;
+    bool is_writer() const;
+
+    /**
+     * @brief Whether create() made the segment, rather than taking over one
+     *        left by an earlier writer (only its creator should unlink it)
+     */
+    bool created() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -380,6 +655,13 @@ private:
  */
 bool glob_match(const std::string& path, const std::string& pattern);
 
+/**
+ * @brief Utility: Shard path as the scan produces it
+ * @param path Shard root or exclude, possibly with '\\', "./" or a trailing '/'
+ * @return '/'-separated path without "./" or trailing '/' ("" for the whole tree)
+ */
+std::string normalize_shard_path(std::string path);
+
 } // namespace indexer
 } // namespace archicore
 
@@ -10,6 +10,13 @@
 namespace archicore {
 namespace indexer {
 
+/**
+ * @brief Per-environment addon data
+ */
+struct AddonData {
+    Napi::FunctionReference file_index_constructor;
+};
+
 /**
  * @brief Convert IndexerConfig from JS object
  */
@@ -42,6 +49,10 @@ IndexerConfig config_from_js(const Napi::Object& obj) {
         config.detect_renames = obj.Get("detectRenames").As<Napi::Boolean>().Value();
     }
 
+    if (obj.Has("computeSemanticHash")) {
+        config.compute_semantic_hash = obj.Get("computeSemanticHash").As<Napi::Boolean>().Value();
+    }
+
     if (obj.Has("maxFileSize")) {
         config.max_file_size = obj.Get("maxFileSize").As<Napi::Number>().Uint32Value();
     }
@@ -53,28 +64,6 @@ IndexerConfig config_from_js(const Napi::Object& obj) {
     return config;
 }
 
-/**
- * @brief Convert Language to string
- */
-std::string language_to_string(Language lang) {
-    switch (lang) {
-        case Language::JAVASCRIPT: return "javascript";
-        case Language::TYPESCRIPT: return "typescript";
-        case Language::PYTHON: return "python";
-        case Language::RUST: return "rust";
-        case Language::GO: return "go";
-        case Language::JAVA: return "java";
-        case Language::CPP: return "cpp";
-        case Language::C: return "c";
-        case Language::CSHARP: return "csharp";
-        case Language::RUBY: return "ruby";
-        case Language::PHP: return "php";
-        case Language::SWIFT: return "swift";
-        case Language::KOTLIN: return "kotlin";
-        default: return "unknown";
-    }
-}
-
 /**
  * @brief Convert FileEntry to JS object
  */
@@ -86,6 +75,59 @@ Napi::Object file_entry_to_js(Napi::Env env, const FileEntry& entry) {
     obj.Set("mtime", Napi::Number::New(env, static_cast<double>(entry.mtime)));
     obj.Set("language", Napi::String::New(env, language_to_string(entry.language)));
     obj.Set("isIndexed", Napi::Boolean::New(env, entry.is_indexed));
+    obj.Set("flags", Napi::Number::New(env, entry.flags));
+    if (entry.semantic_hash != 0) {
+        obj.Set("semanticHash", Napi::String::New(env, std::to_string(entry.semantic_hash)));
+    }
+    return obj;
+}
+
+/**
+ * @brief Read the optional semanticHash string of a JS FileEntry (0 if absent)
+ */
+uint64_t semantic_hash_from_js(const Napi::Object& obj) {
+    if (!obj.Has("semanticHash") || !obj.Get("semanticHash").IsString()) return 0;
+    return std::stoull(obj.Get("semanticHash").As<Napi::String>().Utf8Value());
+}
+
+/**
+ * @brief Read an optional string array property (empty if absent)
+ */
+std::vector<std::string> strings_from_js(const Napi::Object& obj, const char* key) {
+    std::vector<std::string> out;
+    if (!obj.Has(key) || !obj.Get(key).IsArray()) return out;
+    Napi::Array arr = obj.Get(key).As<Napi::Array>();
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        out.push_back(arr.Get(i).As<Napi::String>().Utf8Value());
+    }
+    return out;
+}
+
+/**
+ * @brief Convert ShardSpec from JS object
+ */
+ShardSpec shard_from_js(const Napi::Object& obj) {
+    ShardSpec shard;
+    shard.roots = strings_from_js(obj, "roots");
+    shard.exclude = strings_from_js(obj, "exclude");
+    return shard;
+}
+
+/**
+ * @brief Convert ShardSpec to JS object
+ */
+Napi::Object shard_to_js(Napi::Env env, const ShardSpec& shard) {
+    Napi::Object obj = Napi::Object::New(env);
+    Napi::Array roots = Napi::Array::New(env, shard.roots.size());
+    for (size_t i = 0; i < shard.roots.size(); i++) {
+        roots.Set(i, Napi::String::New(env, shard.roots[i]));
+    }
+    Napi::Array exclude = Napi::Array::New(env, shard.exclude.size());
+    for (size_t i = 0; i < shard.exclude.size(); i++) {
+        exclude.Set(i, Napi::String::New(env, shard.exclude[i]));
+    }
+    obj.Set("roots", roots);
+    obj.Set("exclude", exclude);
     return obj;
 }
 
@@ -124,6 +166,11 @@ Napi::Object file_change_to_js(Napi::Env env, const FileChange& change) {
     obj.Set("oldHash", Napi::String::New(env, std::to_string(change.old_hash)));
     obj.Set("newHash", Napi::String::New(env, std::to_string(change.new_hash)));
 
+    if (change.type == ChangeType::MODIFIED) {
+        obj.Set("kind", Napi::String::New(env,
+            change.kind == ChangeKind::FORMAT_ONLY ? "format_only" : "semantic"));
+    }
+
     return obj;
 }
 
@@ -173,6 +220,7 @@ Napi::Object diff_result_to_js(Napi::Env env, const DiffResult& result) {
     obj.Set("modifiedCount", Napi::Number::New(env, result.modified_count));
     obj.Set("deletedCount", Napi::Number::New(env, result.deleted_count));
     obj.Set("renamedCount", Napi::Number::New(env, result.renamed_count));
+    obj.Set("formatOnlyCount", Napi::Number::New(env, result.format_only_count));
     obj.Set("diffTimeMs", Napi::Number::New(env, result.diff_time_ms));
 
     if (!result.error.empty()) {
@@ -187,7 +235,7 @@ Napi::Object diff_result_to_js(Napi::Env env, const DiffResult& result) {
  */
 class FileIndexWrapper : public Napi::ObjectWrap<FileIndexWrapper> {
 public:
-    static Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
         Napi::Function func = DefineClass(env, "FileIndex", {
             InstanceMethod("add", &FileIndexWrapper::Add),
             InstanceMethod("remove", &FileIndexWrapper::Remove),
@@ -200,13 +248,12 @@ public:
             InstanceMethod("save", &FileIndexWrapper::Save),
             InstanceMethod("load", &FileIndexWrapper::Load),
             InstanceMethod("merkleHash", &FileIndexWrapper::MerkleHash),
+            InstanceMethod("subtreeHash", &FileIndexWrapper::SubtreeHash),
+            InstanceMethod("verify", &FileIndexWrapper::Verify),
         });
 
-        Napi::FunctionReference* constructor = new Napi::FunctionReference();
-        *constructor = Napi::Persistent(func);
         exports.Set("FileIndex", func);
-
-        return exports;
+        return func;
     }
 
     FileIndexWrapper(const Napi::CallbackInfo& info)
@@ -235,6 +282,14 @@ private:
         entry.size = static_cast<uint64_t>(obj.Get("size").As<Napi::Number>().DoubleValue());
         entry.mtime = static_cast<uint64_t>(obj.Get("mtime").As<Napi::Number>().DoubleValue());
         entry.is_indexed = obj.Get("isIndexed").As<Napi::Boolean>().Value();
+        entry.language = Language::UNKNOWN;
+        if (obj.Has("language") && obj.Get("language").IsString()) {
+            entry.language = language_from_string(obj.Get("language").As<Napi::String>().Utf8Value());
+        }
+        if (obj.Has("flags") && obj.Get("flags").IsNumber()) {
+            entry.flags = static_cast<uint8_t>(obj.Get("flags").As<Napi::Number>().Uint32Value());
+        }
+        entry.semantic_hash = semantic_hash_from_js(obj);
 
         index_->add(entry);
 
@@ -309,17 +364,7 @@ private:
         }
 
         std::string lang_str = info[0].As<Napi::String>().Utf8Value();
-        Language lang = Language::UNKNOWN;
-
-        if (lang_str == "javascript") lang = Language::JAVASCRIPT;
-        else if (lang_str == "typescript") lang = Language::TYPESCRIPT;
-        else if (lang_str == "python") lang = Language::PYTHON;
-        else if (lang_str == "rust") lang = Language::RUST;
-        else if (lang_str == "go") lang = Language::GO;
-        else if (lang_str == "java") lang = Language::JAVA;
-        else if (lang_str == "cpp") lang = Language::CPP;
-        else if (lang_str == "c") lang = Language::C;
-        else if (lang_str == "csharp") lang = Language::CSHARP;
+        Language lang = language_from_string(lang_str);
 
         auto entries = index_->get_by_language(lang);
 
@@ -376,6 +421,232 @@ private:
         uint64_t hash = index_->merkle_hash();
         return Napi::String::New(env, std::to_string(hash));
     }
+
+    /**
+     * @brief subtreeHash(dir: string): string
+     */
+    Napi::Value SubtreeHash(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Directory path expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint64_t hash = index_->subtree_hash(info[0].As<Napi::String>().Utf8Value());
+        return Napi::String::New(env, std::to_string(hash));
+    }
+
+    /**
+     * @brief verify(): string[] - paths whose Merkle hashes disagree with the entries
+     */
+    Napi::Value Verify(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        auto mismatched = index_->verify();
+
+        Napi::Array result = Napi::Array::New(env, mismatched.size());
+        for (size_t i = 0; i < mismatched.size(); i++) {
+            result.Set(i, Napi::String::New(env, mismatched[i]));
+        }
+
+        return result;
+    }
+};
+
+/**
+ * @brief Wrapper for SharedFileIndex
+ */
+class SharedFileIndexWrapper : public Napi::ObjectWrap<SharedFileIndexWrapper> {
+public:
+    static Napi::Function Init(Napi::Env env, Napi::Object exports) {
+        Napi::Function func = DefineClass(env, "SharedFileIndex", {
+            InstanceMethod("create", &SharedFileIndexWrapper::Create),
+            InstanceMethod("open", &SharedFileIndexWrapper::Open),
+            InstanceMethod("close", &SharedFileIndexWrapper::Close),
+            InstanceMethod("publish", &SharedFileIndexWrapper::Publish),
+            InstanceMethod("get", &SharedFileIndexWrapper::Get),
+            InstanceMethod("contains", &SharedFileIndexWrapper::Contains),
+            InstanceMethod("getAll", &SharedFileIndexWrapper::GetAll),
+            InstanceMethod("getByLanguage", &SharedFileIndexWrapper::GetByLanguage),
+            InstanceMethod("size", &SharedFileIndexWrapper::Size),
+            InstanceMethod("merkleHash", &SharedFileIndexWrapper::MerkleHash),
+            InstanceMethod("epoch", &SharedFileIndexWrapper::Epoch),
+            InstanceMethod("isWriter", &SharedFileIndexWrapper::IsWriter),
+            StaticMethod("unlink", &SharedFileIndexWrapper::Unlink),
+        });
+
+        exports.Set("SharedFileIndex", func);
+        return func;
+    }
+
+    SharedFileIndexWrapper(const Napi::CallbackInfo& info)
+        : Napi::ObjectWrap<SharedFileIndexWrapper>(info)
+        , index_(std::make_unique<SharedFileIndex>()) {}
+
+private:
+    std::unique_ptr<SharedFileIndex> index_;
+
+    /**
+     * @brief create(name: string, capacityBytes?: number): void
+     */
+    Napi::Value Create(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Segment name expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        uint64_t capacity = 0;
+        if (info.Length() > 1 && info[1].IsNumber()) {
+            capacity = static_cast<uint64_t>(info[1].As<Napi::Number>().DoubleValue());
+        }
+
+        std::string error;
+        if (!index_->create(info[0].As<Napi::String>().Utf8Value(), capacity, error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    /**
+     * @brief open(name: string): void
+     */
+    Napi::Value Open(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Segment name expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string error;
+        if (!index_->open(info[0].As<Napi::String>().Utf8Value(), error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    Napi::Value Close(const Napi::CallbackInfo& info) {
+        index_->close();
+        return info.Env().Undefined();
+    }
+
+    /**
+     * @brief publish(index: FileIndex): void
+     */
+    Napi::Value Publish(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        AddonData* data = env.GetInstanceData<AddonData>();
+        if (info.Length() < 1 || !info[0].IsObject() ||
+            !info[0].As<Napi::Object>().InstanceOf(data->file_index_constructor.Value())) {
+            Napi::TypeError::New(env, "FileIndex instance expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        FileIndexWrapper* wrapper = FileIndexWrapper::Unwrap(info[0].As<Napi::Object>());
+        std::string error;
+        if (!index_->publish(wrapper->get_index(), error)) {
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    Napi::Value Get(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Path string expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        FileEntry entry;
+        if (!index_->get(info[0].As<Napi::String>().Utf8Value(), entry)) {
+            return env.Null();
+        }
+        return file_entry_to_js(env, entry);
+    }
+
+    Napi::Value Contains(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            return Napi::Boolean::New(env, false);
+        }
+
+        return Napi::Boolean::New(env, index_->contains(info[0].As<Napi::String>().Utf8Value()));
+    }
+
+    Napi::Value GetAll(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        auto entries = index_->get_all();
+
+        Napi::Array result = Napi::Array::New(env, entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            result.Set(i, file_entry_to_js(env, entries[i]));
+        }
+
+        return result;
+    }
+
+    Napi::Value GetByLanguage(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Language string expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Language lang = language_from_string(info[0].As<Napi::String>().Utf8Value());
+        auto entries = index_->get_by_language(lang);
+
+        Napi::Array result = Napi::Array::New(env, entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            result.Set(i, file_entry_to_js(env, entries[i]));
+        }
+
+        return result;
+    }
+
+    Napi::Value Size(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), static_cast<double>(index_->size()));
+    }
+
+    Napi::Value MerkleHash(const Napi::CallbackInfo& info) {
+        return Napi::String::New(info.Env(), std::to_string(index_->merkle_hash()));
+    }
+
+    Napi::Value Epoch(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), static_cast<double>(index_->epoch()));
+    }
+
+    Napi::Value IsWriter(const Napi::CallbackInfo& info) {
+        return Napi::Boolean::New(info.Env(), index_->is_writer());
+    }
+
+    /**
+     * @brief SharedFileIndex.unlink(name: string): boolean
+     */
+    static Napi::Value Unlink(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 1 || !info[0].IsString()) {
+            Napi::TypeError::New(env, "Segment name expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        return Napi::Boolean::New(env, SharedFileIndex::unlink(info[0].As<Napi::String>().Utf8Value()));
+    }
 };
 
 /**
@@ -388,6 +659,8 @@ public:
             InstanceMethod("scan", &IndexerWrapper::Scan),
             InstanceMethod("diff", &IndexerWrapper::Diff),
             InstanceMethod("setConfig", &IndexerWrapper::SetConfig),
+            InstanceMethod("scanShard", &IndexerWrapper::ScanShard),
+            InstanceMethod("planShards", &IndexerWrapper::PlanShards),
             InstanceMethod("getConfig", &IndexerWrapper::GetConfig),
         });
 
@@ -444,6 +717,56 @@ private:
         return scan_result_to_js(env, result);
     }
 
+    /**
+     * @brief scanShard(rootPath: string, shard: ShardSpec): ScanResult
+     */
+    Napi::Value ScanShard(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsObject()) {
+            Napi::TypeError::New(env, "Root path and shard spec expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string root_path = info[0].As<Napi::String>().Utf8Value();
+        ShardSpec shard = shard_from_js(info[1].As<Napi::Object>());
+
+        ScanResult result = indexer_->scan_shard(root_path, shard);
+
+        if (!result.error.empty()) {
+            Napi::Error::New(env, result.error).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        return scan_result_to_js(env, result);
+    }
+
+    /**
+     * @brief planShards(rootPath: string, count: number): ShardSpec[]
+     */
+    Napi::Value PlanShards(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
+            Napi::TypeError::New(env, "Root path and shard count expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        std::string root_path = info[0].As<Napi::String>().Utf8Value();
+        uint32_t count = info[1].As<Napi::Number>().Uint32Value();
+
+        auto shards = indexer_->plan_shards(root_path, count);
+
+        Napi::Array result = Napi::Array::New(env, shards.size());
+        for (size_t i = 0; i < shards.size(); i++) {
+            result.Set(i, shard_to_js(env, shards[i]));
+        }
+
+        return result;
+    }
+
     Napi::Value Diff(const Napi::CallbackInfo& info) {
         Napi::Env env = info.Env();
 
@@ -467,6 +790,7 @@ private:
                 FileEntry entry;
                 entry.path = f.Get("path").As<Napi::String>().Utf8Value();
                 entry.content_hash = std::stoull(f.Get("contentHash").As<Napi::String>().Utf8Value());
+                entry.semantic_hash = semantic_hash_from_js(f);
                 old_scan.files.push_back(entry);
             }
         }
@@ -479,6 +803,7 @@ private:
                 FileEntry entry;
                 entry.path = f.Get("path").As<Napi::String>().Utf8Value();
                 entry.content_hash = std::stoull(f.Get("contentHash").As<Napi::String>().Utf8Value());
+                entry.semantic_hash = semantic_hash_from_js(f);
                 new_scan.files.push_back(entry);
             }
         }
@@ -620,17 +945,82 @@ Napi::Value GlobMatch(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, glob_match(path, pattern));
 }
 
+/**
+ * @brief Merge partial indexes of a sharded scan
+ * mergeIndexes(partials: {index: FileIndex, roots?: string[], exclude?: string[]}[], out: FileIndex): MergeResult
+ */
+Napi::Value MergeIndexes(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    AddonData* data = env.GetInstanceData<AddonData>();
+    Napi::Function file_index = data->file_index_constructor.Value();
+
+    if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsObject() ||
+        !info[1].As<Napi::Object>().InstanceOf(file_index)) {
+        Napi::TypeError::New(env, "Partials array and output FileIndex expected")
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Array arr = info[0].As<Napi::Array>();
+    std::vector<IndexPartial> partials;
+    partials.reserve(arr.Length());
+
+    for (uint32_t i = 0; i < arr.Length(); i++) {
+        Napi::Value item = arr.Get(i);
+        if (!item.IsObject() || !item.As<Napi::Object>().Get("index").IsObject() ||
+            !item.As<Napi::Object>().Get("index").As<Napi::Object>().InstanceOf(file_index)) {
+            Napi::TypeError::New(env, "Partial " + std::to_string(i) + ": FileIndex expected")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+
+        Napi::Object obj = item.As<Napi::Object>();
+        IndexPartial partial;
+        partial.shard = shard_from_js(obj);
+        partial.index = &FileIndexWrapper::Unwrap(obj.Get("index").As<Napi::Object>())->get_index();
+        partials.push_back(std::move(partial));
+    }
+
+    FileIndexWrapper* out = FileIndexWrapper::Unwrap(info[1].As<Napi::Object>());
+    MergeResult result = merge_partials(partials, out->get_index());
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("success", Napi::Boolean::New(env, result.success));
+    obj.Set("merkleRoot", Napi::String::New(env, std::to_string(result.merkle_root)));
+    obj.Set("totalFiles", Napi::Number::New(env, result.total_files));
+    obj.Set("overlapFiles", Napi::Number::New(env, result.overlap_files));
+
+    Napi::Array conflicts = Napi::Array::New(env, result.conflicts.size());
+    for (size_t i = 0; i < result.conflicts.size(); i++) {
+        conflicts.Set(i, Napi::String::New(env, result.conflicts[i]));
+    }
+    obj.Set("conflicts", conflicts);
+    obj.Set("mergeTimeMs", Napi::Number::New(env, result.merge_time_ms));
+
+    if (!result.error.empty()) {
+        obj.Set("error", Napi::String::New(env, result.error));
+    }
+
+    return obj;
+}
+
 /**
  * @brief Module initialization
  */
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     IndexerWrapper::Init(env, exports);
-    FileIndexWrapper::Init(env, exports);
+
+    AddonData* data = new AddonData();
+    data->file_index_constructor = Napi::Persistent(FileIndexWrapper::Init(env, exports));
+    env.SetInstanceData(data);
+
+    SharedFileIndexWrapper::Init(env, exports);
 
     exports.Set("hashFile", Napi::Function::New(env, HashFile));
     exports.Set("hashString", Napi::Function::New(env, HashString));
     exports.Set("scan", Napi::Function::New(env, ScanDirectory));
     exports.Set("globMatch", Napi::Function::New(env, GlobMatch));
+    exports.Set("mergeIndexes", Napi::Function::New(env, MergeIndexes));
 
     // Version info
     exports.Set("version", Napi::String::New(env, "1.0.0"));
@@ -9,6 +9,8 @@
 #endif
 
 #include "indexer.h"
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <thread>
 #include <future>
@@ -261,6 +263,37 @@ private:
     size_t mem_size_;
 };
 
+/**
+ * @brief xxHash64 of a source's normalized token stream (see TokenNormalizer)
+ */
+class SemanticHasher {
+public:
+    explicit SemanticHasher(Language language) : language_(language) {}
+
+    uint64_t hash(std::string_view src) {
+        TokenNormalizer<SemanticHasher> normalizer(language_, *this);
+        normalizer.run(src);
+        flush();
+        return stream_.finalize();
+    }
+
+    void put(char c) {
+        buffer_[length_++] = c;
+        if (length_ == sizeof(buffer_)) flush();
+    }
+
+private:
+    Language language_;
+    XXHash64Stream stream_;
+    char buffer_[4096];
+    size_t length_ = 0;
+
+    void flush() {
+        stream_.update(buffer_, length_);
+        length_ = 0;
+    }
+};
+
 struct FileHasher::Impl {
     static constexpr size_t BUFFER_SIZE = 64 * 1024;  // 64KB buffer
 
@@ -289,38 +322,90 @@ struct FileHasher::Impl {
 
         return hasher.finalize();
     }
-};
 
-FileHasher::FileHasher() : impl_(std::make_unique<Impl>()) {}
+    FileDigest digest_file_impl(const std::string& path, bool semantic) {
+        FileDigest digest;
 
-FileHasher::~FileHasher() = default;
+        // Hash, sniff and classify from the same mapping
+        MappedFile mapped;
+        if (mapped.open(path)) {
+            if (mapped.size() == 0) {
+                digest.language = detect_language(path);
+                digest.flags = classify_content(path, {});
+                return digest;
+            }
+            digest.content_hash = XXHash64::hash(mapped.data(), mapped.size());
+            digest.language = detect_language(path, mapped.view());
+            digest.flags = classify_content(path, mapped.view());
+            if (semantic) {
+                digest.semantic_hash = semantic_hash(mapped.view(), digest.language, digest.flags, digest.content_hash);
+            }
+            return digest;
+        }
 
-uint64_t FileHasher::hash_file(const std::string& path) {
-    return impl_->hash_file_impl(path);
-}
+        // Fall back to streaming, sniffing and classifying the first buffer;
+        // the semantic hash needs the whole text, so it is kept when asked for
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return digest;
 
-uint64_t FileHasher::hash_string(const std::string& content) {
-    return XXHash64::hash(content.data(), content.size());
-}
+        XXHash64Stream hasher;
+        char buffer[BUFFER_SIZE];
+        bool first = true;
+        std::string content;
 
-std::vector<uint64_t> FileHasher::hash_files_parallel(
-    const std::vector<std::string>& paths,
-    uint32_t num_workers
-) {
-    std::vector<uint64_t> results(paths.size(), 0);
+        while (file) {
+            file.read(buffer, BUFFER_SIZE);
+            std::streamsize bytes_read = file.gcount();
+            if (bytes_read > 0) {
+                if (first) {
+                    std::string_view head(buffer, static_cast<size_t>(bytes_read));
+                    digest.language = detect_language(path, head);
+                    digest.flags = classify_content(path, head);
+                    first = false;
+                }
+                hasher.update(buffer, static_cast<size_t>(bytes_read));
+                if (semantic) content.append(buffer, static_cast<size_t>(bytes_read));
+            }
+        }
 
-    if (paths.empty()) return results;
+        if (first) {
+            digest.language = detect_language(path);
+            digest.flags = classify_content(path, {});
+        }
+        digest.content_hash = hasher.finalize();
+        if (semantic && !first) {
+            digest.semantic_hash = semantic_hash(content, digest.language, digest.flags, digest.content_hash);
+        }
+        return digest;
+    }
+
+    // Languages without a known lexical syntax, and binary content, have no
+    // token stream to normalize: their semantic hash is the content hash
+    static uint64_t semantic_hash(std::string_view content, Language language, uint8_t flags,
+                                  uint64_t content_hash) {
+        if (language == Language::UNKNOWN || (flags & (FILE_FLAG_BINARY | FILE_FLAG_HIGH_ENTROPY))) {
+            return content_hash;
+        }
+        return SemanticHasher(language).hash(content);
+    }
+};
 
+/**
+ * @brief Run work(local_hasher, index) for every index on a worker pool
+ */
+template<typename Work>
+static void run_parallel(size_t count, uint32_t num_workers, Work work) {
     // Limit workers to actual CPU count
     num_workers = std::min(num_workers, std::thread::hardware_concurrency());
     num_workers = std::max(num_workers, 1u);
 
     // For small number of files, use single thread
-    if (paths.size() <= num_workers) {
-        for (size_t i = 0; i < paths.size(); i++) {
-            results[i] = hash_file(paths[i]);
+    if (count <= num_workers) {
+        FileHasher hasher;
+        for (size_t i = 0; i < count; i++) {
+            work(hasher, i);
         }
-        return results;
+        return;
     }
 
     // Parallel hashing with thread pool
@@ -331,8 +416,8 @@ std::vector<uint64_t> FileHasher::hash_files_parallel(
         futures.push_back(std::async(std::launch::async, [&]() {
             FileHasher local_hasher;
             size_t idx;
-            while ((idx = next_index.fetch_add(1)) < paths.size()) {
-                results[idx] = local_hasher.hash_file(paths[idx]);
+            while ((idx = next_index.fetch_add(1)) < count) {
+                work(local_hasher, idx);
             }
         }));
     }
@@ -340,6 +425,52 @@ std::vector<uint64_t> FileHasher::hash_files_parallel(
     for (auto& f : futures) {
         f.wait();
     }
+}
+
+FileHasher::FileHasher() : impl_(std::make_unique<Impl>()) {}
+
+FileHasher::~FileHasher() = default;
+
+uint64_t FileHasher::hash_file(const std::string& path) {
+    return impl_->hash_file_impl(path);
+}
+
+uint64_t FileHasher::hash_string(const std::string& content) {
+    return XXHash64::hash(content.data(), content.size());
+}
+
+std::vector<uint64_t> FileHasher::hash_files_parallel(
+    const std::vector<std::string>& paths,
+    uint32_t num_workers
+) {
+    std::vector<uint64_t> results(paths.size(), 0);
+
+    run_parallel(paths.size(), num_workers, [&](FileHasher& hasher, size_t idx) {
+        results[idx] = hasher.hash_file(paths[idx]);
+    });
+
+    return results;
+}
+
+FileDigest FileHasher::digest_file(const std::string& path, bool semantic) {
+    return impl_->digest_file_impl(path, semantic);
+}
+
+uint64_t FileHasher::hash_semantic(std::string_view content, Language language) {
+    return Impl::semantic_hash(content, language, classify_content({}, content),
+                               XXHash64::hash(content.data(), content.size()));
+}
+
+std::vector<FileDigest> FileHasher::digest_files_parallel(
+    const std::vector<std::string>& paths,
+    uint32_t num_workers,
+    bool semantic
+) {
+    std::vector<FileDigest> results(paths.size());
+
+    run_parallel(paths.size(), num_workers, [&](FileHasher& hasher, size_t idx) {
+        results[idx] = hasher.digest_file(paths[idx], semantic);
+    });
 
     return results;
 }
@@ -8,7 +8,6 @@
 #include <filesystem>
 #include <algorithm>
 #include <chrono>
-#include <regex>
 #include <fstream>
 
 namespace fs = std::filesystem;
@@ -18,57 +17,34 @@ namespace indexer {
 
 /**
  * @brief Simple glob pattern matching
+ *
+ * Compiles the pattern on every call; Indexer keeps its include and
+ * exclude patterns compiled.
  */
 bool glob_match(const std::string& path, const std::string& pattern) {
-    // Convert glob to regex
-    std::string regex_str;
-    regex_str.reserve(pattern.size() * 2);
-
-    for (size_t i = 0; i < pattern.size(); i++) {
-        char c = pattern[i];
-        switch (c) {
-            case '*':
-                if (i + 1 < pattern.size() && pattern[i + 1] == '*') {
-                    // ** matches any path
-                    regex_str += ".*";
-                    i++;
-                } else {
-                    // * matches anything except /
-                    regex_str += "[^/\\\\]*";
-                }
-                break;
-            case '?':
-                regex_str += "[^/\\\\]";
-                break;
-            case '.':
-            case '(':
-            case ')':
-            case '[':
-            case ']':
-            case '{':
-            case '}':
-            case '+':
-            case '^':
-            case '$':
-            case '|':
-            case '\\':
-                regex_str += '\\';
-                regex_str += c;
-                break;
-            default:
-                regex_str += c;
-                break;
-        }
-    }
+    return GlobMatcher(pattern).match(path);
+}
 
-    try {
-        std::regex rx(regex_str, std::regex::icase);
-        return std::regex_match(path, rx);
-    } catch (...) {
-        return false;
-    }
+std::string normalize_shard_path(std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');
+    while (path.compare(0, 2, "./") == 0) path.erase(0, 2);
+    while (!path.empty() && path.back() == '/') path.pop_back();
+    return path == "." ? std::string() : path;
 }
 
+namespace {
+
+/**
+ * @brief Whether path is dir or lies below it ("" contains everything)
+ */
+bool path_under(const std::string& path, const std::string& dir) {
+    if (dir.empty()) return true;
+    return path.size() >= dir.size() && path.compare(0, dir.size(), dir) == 0 &&
+           (path.size() == dir.size() || path[dir.size()] == '/');
+}
+
+} // namespace
+
 /**
  * @brief FileIndex implementation
  */
@@ -150,7 +126,7 @@ bool FileIndex::save(const std::string& path) const {
 
     // Write magic and version
     uint32_t magic = 0x4649444E;  // "FIDN"
-    uint32_t version = 1;
+    uint32_t version = 3;
     file.write(reinterpret_cast<const char*>(&magic), 4);
     file.write(reinterpret_cast<const char*>(&version), 4);
 
@@ -170,6 +146,8 @@ bool FileIndex::save(const std::string& path) const {
         file.write(reinterpret_cast<const char*>(&lang), 1);
         uint8_t indexed = entry.is_indexed ? 1 : 0;
         file.write(reinterpret_cast<const char*>(&indexed), 1);
+        file.write(reinterpret_cast<const char*>(&entry.flags), 1);
+        file.write(reinterpret_cast<const char*>(&entry.semantic_hash), 8);
     }
 
     // Write Merkle tree
@@ -192,7 +170,9 @@ bool FileIndex::load(const std::string& path) {
     file.read(reinterpret_cast<char*>(&magic), 4);
     file.read(reinterpret_cast<char*>(&version), 4);
 
-    if (magic != 0x4649444E || version != 1) return false;
+    // Version 1 predates file flags and version 2 semantic hashes; older
+    // entries load as unclassified and without a semantic hash
+    if (magic != 0x4649444E || version < 1 || version > 3) return false;
 
     // Read entries
     uint32_t count;
@@ -216,6 +196,12 @@ bool FileIndex::load(const std::string& path) {
         uint8_t indexed;
         file.read(reinterpret_cast<char*>(&indexed), 1);
         entry.is_indexed = (indexed != 0);
+        if (version >= 2) {
+            file.read(reinterpret_cast<char*>(&entry.flags), 1);
+        }
+        if (version >= 3) {
+            file.read(reinterpret_cast<char*>(&entry.semantic_hash), 8);
+        }
 
         impl_->entries[entry.path] = entry;
     }
@@ -237,6 +223,25 @@ uint64_t FileIndex::merkle_hash() const {
     return impl_->merkle->root_hash();
 }
 
+uint64_t FileIndex::subtree_hash(const std::string& dir_path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->merkle->compute_hash(dir_path);
+}
+
+std::vector<std::string> FileIndex::verify() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    MerkleTree expected;
+    for (const auto& [path, entry] : impl_->entries) {
+        expected.add_file(path, entry.content_hash);
+    }
+    if (expected.root_hash() == impl_->merkle->root_hash()) return {};
+
+    auto paths = impl_->merkle->diff(expected);
+    if (paths.empty()) paths.push_back("");   // Only the stored root hash is off
+    return paths;
+}
+
 /**
  * @brief Indexer implementation
  */
@@ -260,6 +265,14 @@ Indexer::Indexer(const IndexerConfig& config)
             "**/target/**"
         };
     }
+    compile_patterns();
+}
+
+void Indexer::compile_patterns() {
+    include_matchers_.clear();
+    for (const auto& pattern : config_.include_patterns) include_matchers_.emplace_back(pattern);
+    exclude_matchers_.clear();
+    for (const auto& pattern : config_.exclude_patterns) exclude_matchers_.emplace_back(pattern);
 }
 
 Indexer::~Indexer() = default;
@@ -267,15 +280,15 @@ Indexer::~Indexer() = default;
 bool Indexer::should_include(const std::string& path) const {
     if (config_.include_patterns.empty()) return true;
 
-    for (const auto& pattern : config_.include_patterns) {
-        if (glob_match(path, pattern)) return true;
+    for (const auto& matcher : include_matchers_) {
+        if (matcher.match(path)) return true;
     }
     return false;
 }
 
 bool Indexer::should_exclude(const std::string& path) const {
-    for (const auto& pattern : config_.exclude_patterns) {
-        if (glob_match(path, pattern)) return true;
+    for (const auto& matcher : exclude_matchers_) {
+        if (matcher.match(path)) return true;
     }
     return false;
 }
@@ -283,6 +296,14 @@ bool Indexer::should_exclude(const std::string& path) const {
 ScanResult Indexer::scan(
     const std::string& root_path,
     ProgressCallback progress
+) {
+    return scan_shard(root_path, ShardSpec{}, progress);
+}
+
+ScanResult Indexer::scan_shard(
+    const std::string& root_path,
+    const ShardSpec& shard,
+    ProgressCallback progress
 ) {
     auto start_time = std::chrono::high_resolution_clock::now();
 
@@ -297,36 +318,76 @@ ScanResult Indexer::scan(
         return result;
     }
 
+    // Paths are taken lexically, so a symlinked file keeps the path it was
+    // found under and stays in the shard that found it
+    fs::path base = root;
+    if (!base.has_filename() && base.has_relative_path()) base = base.parent_path();
+
+    // A shard without roots (or with the root "") walks the whole tree
+    std::vector<std::string> roots;
+    for (const auto& shard_root : shard.roots) roots.push_back(normalize_shard_path(shard_root));
+    std::sort(roots.begin(), roots.end());
+    if (roots.empty() || roots.front().empty()) roots.assign(1, "");
+
+    std::vector<std::string> excluded;
+    for (const auto& shard_exclude : shard.exclude) excluded.push_back(normalize_shard_path(shard_exclude));
+
     // First pass: collect all files
     std::vector<std::string> file_paths;
     std::vector<fs::path> dir_paths;
 
     try {
-        for (const auto& entry : fs::recursive_directory_iterator(
-            root,
-            config_.follow_symlinks ?
-                fs::directory_options::follow_directory_symlink :
-                fs::directory_options::none
-        )) {
-            std::string rel_path = fs::relative(entry.path(), root).string();
+        for (size_t r = 0; r < roots.size(); r++) {
+            // A root nested in an earlier one was walked with it
+            bool nested = false;
+            for (size_t q = 0; q < r; q++) nested = nested || path_under(roots[r], roots[q]);
+            if (nested) continue;
+
+            fs::path start = roots[r].empty() ? root : root / fs::path(roots[r]);
+            std::error_code ec;
+            if (!fs::is_directory(start, ec)) continue;
+            if (!roots[r].empty() && !should_exclude(roots[r])) {
+                // A full scan lists the shard root as one of its directories
+                dir_paths.push_back(start);
+                result.total_dirs++;
+            }
 
-            // Normalize path separators
-            std::replace(rel_path.begin(), rel_path.end(), '\\', '/');
+            for (fs::recursive_directory_iterator it(
+                    start,
+                    config_.follow_symlinks ?
+                        fs::directory_options::follow_directory_symlink :
+                        fs::directory_options::none
+                ), end; it != end; ++it) {
+                const auto& entry = *it;
+                std::string rel_path = entry.path().lexically_relative(base).string();
+
+                // Normalize path separators
+                std::replace(rel_path.begin(), rel_path.end(), '\\', '/');
+
+                bool left_to_other_shard = false;
+                for (const auto& ex : excluded) {
+                    left_to_other_shard = left_to_other_shard || path_under(rel_path, ex);
+                }
+                if (left_to_other_shard) {
+                    if (entry.is_directory()) it.disable_recursion_pending();
+                    continue;
+                }
 
-            if (should_exclude(rel_path)) continue;
+                if (should_exclude(rel_path)) continue;
 
-            if (entry.is_directory()) {
-                dir_paths.push_back(entry.path());
-                result.total_dirs++;
-            } else if (entry.is_regular_file()) {
-                if (!should_include(rel_path)) continue;
+                if (entry.is_directory()) {
+                    dir_paths.push_back(entry.path());
+                    result.total_dirs++;
+                } else if (entry.is_regular_file()) {
+                    if (!should_include(rel_path)) continue;
 
-                // Check file size
-                auto file_size = entry.file_size();
-                if (file_size > config_.max_file_size) continue;
+                    // Check file size
+                    auto file_size = entry.file_size();
+                    if (file_size > config_.max_file_size) continue;
 
-                file_paths.push_back(entry.path().string());
-                result.total_files++;
+                    file_paths.push_back(entry.path().string());
+                    result.total_files++;
+                }
             }
         }
     } catch (const std::exception& e) {
@@ -334,12 +395,17 @@ ScanResult Indexer::scan(
         return result;
     }
 
-    // Hash files in parallel
-    std::vector<uint64_t> hashes;
+    // Hash files in parallel, detecting language from the same mapping
+    std::vector<FileDigest> digests;
     if (config_.compute_content_hash) {
-        hashes = hasher_->hash_files_parallel(file_paths, config_.parallel_workers);
+        digests = hasher_->digest_files_parallel(
+            file_paths, config_.parallel_workers, config_.compute_semantic_hash
+        );
     } else {
-        hashes.resize(file_paths.size(), 0);
+        digests.resize(file_paths.size());
+        for (size_t i = 0; i < file_paths.size(); i++) {
+            digests[i].language = detect_language(file_paths[i]);
+        }
     }
 
     // Build file entries
@@ -347,12 +413,12 @@ ScanResult Indexer::scan(
 
     for (size_t i = 0; i < file_paths.size(); i++) {
         fs::path file_path(file_paths[i]);
-        std::string rel_path = fs::relative(file_path, root).string();
+        std::string rel_path = file_path.lexically_relative(base).string();
         std::replace(rel_path.begin(), rel_path.end(), '\\', '/');
 
         FileEntry entry;
         entry.path = rel_path;
-        entry.content_hash = hashes[i];
+        entry.content_hash = digests[i].content_hash;
 
         try {
             entry.size = fs::file_size(file_path);
@@ -365,7 +431,9 @@ ScanResult Indexer::scan(
             entry.mtime = 0;
         }
 
-        entry.language = detect_language(rel_path);
+        entry.language = digests[i].language;
+        entry.flags = digests[i].flags;
+        entry.semantic_hash = digests[i].semantic_hash;
         entry.is_indexed = false;
 
         result.files.push_back(entry);
@@ -380,7 +448,7 @@ ScanResult Indexer::scan(
 
     // Build directory entries
     for (const auto& dir_path : dir_paths) {
-        std::string rel_path = fs::relative(dir_path, root).string();
+        std::string rel_path = dir_path.lexically_relative(base).string();
         std::replace(rel_path.begin(), rel_path.end(), '\\', '/');
 
         DirEntry entry;
@@ -409,6 +477,104 @@ ScanResult Indexer::scan(
     return result;
 }
 
+std::vector<ShardSpec> Indexer::plan_shards(const std::string& root_path, uint32_t count) {
+    std::vector<ShardSpec> shards(1);
+    fs::path root(root_path);
+    std::error_code ec;
+    if (count <= 1 || !fs::is_directory(root, ec)) return shards;
+
+    constexpr size_t MAX_SPLIT_DEPTH = 4;
+    auto options = config_.follow_symlinks ?
+        fs::directory_options::follow_directory_symlink :
+        fs::directory_options::none;
+
+    // Count the files a scan would keep per directory, down to MAX_SPLIT_DEPTH
+    std::unordered_map<std::string, uint64_t> weights;
+    std::unordered_map<std::string, std::vector<std::string>> children;
+    std::vector<std::string> candidates;
+    uint64_t root_files = 0;
+    uint64_t total_files = 0;
+
+    for (fs::directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        std::error_code type_ec;
+        bool walkable = it->is_directory(type_ec) && (config_.follow_symlinks || !it->is_symlink(type_ec));
+        if (!walkable) {
+            root_files++;
+            total_files++;
+            continue;
+        }
+        if (should_exclude(name)) continue;
+
+        weights[name] = 0;
+        candidates.push_back(name);
+        std::error_code walk_ec;
+        for (fs::recursive_directory_iterator walk(it->path(), options, walk_ec), walk_end;
+             !walk_ec && walk != walk_end; walk.increment(walk_ec)) {
+            std::error_code file_ec;
+            if (!walk->is_regular_file(file_ec)) continue;
+            std::string rel = name + "/" + walk->path().lexically_relative(it->path()).generic_string();
+            if (should_exclude(rel) || !should_include(rel)) continue;
+
+            total_files++;
+            size_t depth = 0;
+            for (size_t pos = rel.find('/'); pos != std::string::npos && depth < MAX_SPLIT_DEPTH;
+                 pos = rel.find('/', pos + 1), depth++) {
+                auto [slot, inserted] = weights.try_emplace(rel.substr(0, pos), 0);
+                slot->second++;
+                if (inserted) {
+                    std::string dir = rel.substr(0, pos);
+                    children[dir.substr(0, dir.rfind('/'))].push_back(std::move(dir));
+                }
+            }
+        }
+    }
+
+    // Split directories heavier than one shard's share into their
+    // subdirectories; the files directly inside stay with the first shard
+    uint64_t share = std::max<uint64_t>(1, total_files / count);
+    std::vector<std::string> assignable;
+    while (!candidates.empty()) {
+        std::string dir = std::move(candidates.back());
+        candidates.pop_back();
+        auto kids = children.find(dir);
+        if (weights[dir] <= share || kids == children.end()) {
+            assignable.push_back(std::move(dir));
+            continue;
+        }
+        uint64_t nested = 0;
+        for (const auto& kid : kids->second) nested += weights[kid];
+        root_files += weights[dir] - nested;
+        candidates.insert(candidates.end(), kids->second.begin(), kids->second.end());
+    }
+
+    // Largest first onto the lightest shard; the first shard starts with the root files
+    std::sort(assignable.begin(), assignable.end(), [&weights](const std::string& a, const std::string& b) {
+        uint64_t wa = weights[a];
+        uint64_t wb = weights[b];
+        return wa != wb ? wa > wb : a < b;
+    });
+    std::vector<uint64_t> loads(count, 0);
+    loads[0] = root_files;
+    std::vector<std::vector<std::string>> assigned(count);
+    for (const auto& dir : assignable) {
+        size_t lightest = static_cast<size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+        loads[lightest] += weights[dir];
+        if (lightest > 0) assigned[lightest].push_back(dir);
+    }
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (assigned[i].empty()) continue;
+        std::sort(assigned[i].begin(), assigned[i].end());
+        shards[0].exclude.insert(shards[0].exclude.end(), assigned[i].begin(), assigned[i].end());
+        ShardSpec shard;
+        shard.roots = std::move(assigned[i]);
+        shards.push_back(std::move(shard));
+    }
+    std::sort(shards[0].exclude.begin(), shards[0].exclude.end());
+    return shards;
+}
+
 std::vector<FileChange> Indexer::detect_renames(
     const std::vector<FileEntry>& old_files,
     const std::vector<FileEntry>& new_files
@@ -525,6 +691,12 @@ DiffResult Indexer::diff(
                 change.path = path;
                 change.old_hash = old_entry->content_hash;
                 change.new_hash = new_entry->content_hash;
+                // Only comparable when both sides carry a semantic hash
+                if (old_entry->semantic_hash != 0 &&
+                    old_entry->semantic_hash == new_entry->semantic_hash) {
+                    change.kind = ChangeKind::FORMAT_ONLY;
+                    result.format_only_count++;
+                }
                 result.changes.push_back(change);
                 result.modified_count++;
             }
@@ -568,6 +740,7 @@ DiffResult Indexer::incremental_update(
 
 void Indexer::set_config(const IndexerConfig& config) {
     config_ = config;
+    compile_patterns();
 }
 
 const IndexerConfig& Indexer::get_config() const {
@@ -0,0 +1,171 @@
+/**
+ * @file merge.cpp
+ * @brief Merging partial indexes of sharded scans
+ * @version 1.0.0
+ */
+
+#include "indexer.h"
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
+namespace archicore {
+namespace indexer {
+
+namespace {
+
+/**
+ * @brief Shard roots and excludes of all partials, keyed by path
+ *
+ * A path is covered by a partial when one of its ancestors (or the path
+ * itself) is a root of that partial and none is an exclude; looking up
+ * the ancestors keeps the check proportional to path depth rather than
+ * to the number of shard paths.
+ */
+class CoverageMap {
+public:
+    explicit CoverageMap(const std::vector<IndexPartial>& partials) : partial_count_(partials.size()) {
+        for (size_t i = 0; i < partials.size(); i++) {
+            const ShardSpec& shard = partials[i].shard;
+            if (shard.roots.empty()) marks_[""].push_back({i, false});
+            for (const auto& root : shard.roots) marks_[normalize_shard_path(root)].push_back({i, false});
+            for (const auto& exclude : shard.exclude) marks_[normalize_shard_path(exclude)].push_back({i, true});
+        }
+        state_.resize(partial_count_);
+    }
+
+    /**
+     * @brief Mark the partials covering path; valid until the next call
+     */
+    const std::vector<uint8_t>& covering(const std::string& path) {
+        std::fill(state_.begin(), state_.end(), 0);
+        apply("");
+        for (size_t pos = path.find('/'); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+            apply(std::string_view(path).substr(0, pos));
+        }
+        apply(path);
+        for (auto& state : state_) state = (state == ROOT) ? 1 : 0;
+        return state_;
+    }
+
+private:
+    static constexpr uint8_t ROOT = 1;
+    static constexpr uint8_t EXCLUDED = 2;
+
+    struct Mark {
+        size_t partial;
+        bool exclude;
+    };
+
+    size_t partial_count_;
+    std::unordered_map<std::string, std::vector<Mark>> marks_;
+    std::vector<uint8_t> state_;
+
+    void apply(std::string_view prefix) {
+        if (marks_.empty()) return;
+        auto it = marks_.find(std::string(prefix));
+        if (it == marks_.end()) return;
+        for (const auto& mark : it->second) state_[mark.partial] |= mark.exclude ? EXCLUDED : ROOT;
+    }
+};
+
+/**
+ * @brief Order-independent choice between entries with equal content
+ *
+ * Shards scanned at different times may disagree on metadata only;
+ * the most recent observation wins, remaining ties break on the fields.
+ */
+bool replaces(const FileEntry& candidate, const FileEntry& current) {
+    auto key = [](const FileEntry& e) {
+        return std::make_tuple(e.mtime, e.size, e.semantic_hash, e.flags,
+                               static_cast<uint8_t>(e.language), e.is_indexed);
+    };
+    return key(candidate) > key(current);
+}
+
+struct Slot {
+    FileEntry entry;
+    uint32_t holders = 0;
+    bool conflict = false;
+};
+
+} // namespace
+
+MergeResult merge_partials(const std::vector<IndexPartial>& partials, FileIndex& out) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    MergeResult result;
+
+    if (partials.empty()) {
+        result.error = "No partial indexes to merge";
+        return result;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < partials.size(); i++) {
+        if (!partials[i].index) {
+            result.error = "Partial " + std::to_string(i) + " has no index";
+            return result;
+        }
+        total += partials[i].index->size();
+    }
+
+    CoverageMap coverage(partials);
+    std::unordered_map<std::string, Slot> merged;
+    merged.reserve(total);
+
+    for (size_t i = 0; i < partials.size(); i++) {
+        // A partial must agree with its own Merkle tree before it is trusted
+        auto mismatched = partials[i].index->verify();
+        if (!mismatched.empty()) {
+            result.error = "Partial " + std::to_string(i) + ": Merkle hash mismatch at '" +
+                           mismatched.front() + "'";
+            return result;
+        }
+
+        for (auto& entry : partials[i].index->get_all()) {
+            if (!coverage.covering(entry.path)[i]) {
+                result.error = "Partial " + std::to_string(i) + ": '" + entry.path +
+                               "' is outside its shard";
+                return result;
+            }
+
+            auto [it, inserted] = merged.try_emplace(entry.path);
+            Slot& slot = it->second;
+            slot.holders++;
+            if (inserted) {
+                slot.entry = std::move(entry);
+            } else if (slot.entry.content_hash != entry.content_hash) {
+                slot.conflict = true;
+            } else if (replaces(entry, slot.entry)) {
+                slot.entry = std::move(entry);
+            }
+        }
+    }
+
+    // Every shard covering a path must have seen it
+    for (const auto& [path, slot] : merged) {
+        uint32_t covering = 0;
+        for (uint8_t covers : coverage.covering(path)) covering += covers;
+        if (slot.conflict || slot.holders < covering) result.conflicts.push_back(path);
+        if (slot.holders > 1) result.overlap_files++;
+    }
+
+    if (!result.conflicts.empty()) {
+        std::sort(result.conflicts.begin(), result.conflicts.end());
+        result.error = std::to_string(result.conflicts.size()) +
+                       " path(s) differ between overlapping shards";
+    } else {
+        out.clear();
+        for (const auto& [path, slot] : merged) out.add(slot.entry);
+        result.success = true;
+        result.merkle_root = out.merkle_hash();
+        result.total_files = static_cast<uint32_t>(merged.size());
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.merge_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+    return result;
+}
+
+} // namespace indexer
+} // namespace archicore
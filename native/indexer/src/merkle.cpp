@@ -325,6 +325,9 @@ void MerkleTree::clear() {
 }
 
 std::vector<uint8_t> MerkleTree::serialize() const {
+    // Directory hashes are stored as is; bring them up to date first
+    root_hash();
+
     std::vector<uint8_t> data;
     // Write magic number
     uint32_t magic = 0x4D524B4C;  // "MRKL"
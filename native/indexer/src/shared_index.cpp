@@ -0,0 +1,734 @@
+/**
+ * @file shared_index.cpp
+ * @brief FileIndex snapshots in shared memory
+ * @version 1.0.0
+ *
+ * Segment layout:
+ *   [0, 4096)                 SegmentHeader (magic, epoch counters, region size)
+ *   [4096, 4096 + R)          region 0
+ *   [4096 + R, 4096 + 2R)     region 1
+ *
+ * Snapshot with epoch E lives in region E & 1. Each region holds a
+ * RegionHeader, a power-of-two table of path-hash buckets (record index + 1,
+ * 0 = empty, linear probing), the records sorted by path, and the string pool.
+ * All references inside a region are offsets, so every process can map the
+ * segment at a different address.
+ */
+
+#include "indexer.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <new>
+#endif
+
+namespace archicore {
+namespace indexer {
+
+#ifndef _WIN32
+
+namespace {
+
+constexpr uint64_t SEGMENT_MAGIC = 0x3158444948534341ULL;  // "ACSHIDX1"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr uint64_t HEADER_BYTES = 4096;
+constexpr uint64_t MIN_REGION_BYTES = 64 * 1024;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared index counters must be lock-free to live in shared memory");
+
+/**
+ * @brief Segment header, shared by the writer and all readers
+ */
+struct SegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    std::atomic<uint64_t> epoch;          // Last published snapshot
+    std::atomic<uint64_t> writing;        // Snapshot under construction (== epoch when idle)
+    std::atomic<uint64_t> region_bytes;   // Size of each of the two regions
+    std::atomic<uint64_t> writer_pid;     // Informational
+};
+
+static_assert(sizeof(SegmentHeader) <= HEADER_BYTES, "segment header must fit its page");
+
+/**
+ * @brief Start of a snapshot region
+ */
+struct RegionHeader {
+    uint64_t merkle_root;
+    uint64_t entry_count;
+    uint64_t bucket_count;      // Power of two
+    uint64_t records_offset;    // From the region start
+    uint64_t strings_offset;
+    uint64_t used_bytes;
+};
+
+/**
+ * @brief FileEntry with its path moved into the string pool
+ */
+struct Record {
+    uint64_t path_hash;
+    uint64_t content_hash;
+    uint64_t size;
+    uint64_t mtime;
+    uint64_t semantic_hash;
+    uint64_t path_offset;       // Into the string pool
+    uint32_t path_length;
+    uint8_t language;
+    uint8_t flags;
+    uint8_t is_indexed;
+    uint8_t reserved;
+};
+
+/**
+ * @brief FNV-1a; stable across processes and builds, unlike std::hash
+ */
+uint64_t path_hash(std::string_view path) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : path) {
+        hash ^= c;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+uint64_t bucket_count_for(size_t entries) {
+    uint64_t count = 16;
+    while (count < entries * 2) count <<= 1;
+    return count;
+}
+
+uint64_t image_bytes(const std::vector<FileEntry>& entries) {
+    uint64_t strings = 0;
+    for (const auto& entry : entries) strings += entry.path.size();
+    return sizeof(RegionHeader) + align8(bucket_count_for(entries.size()) * sizeof(uint32_t)) +
+           entries.size() * sizeof(Record) + strings;
+}
+
+/**
+ * @brief Write a snapshot image (entries sorted by path) into a region
+ */
+void write_image(char* region, const std::vector<FileEntry>& entries, uint64_t merkle_root) {
+    RegionHeader header{};
+    header.merkle_root = merkle_root;
+    header.entry_count = entries.size();
+    header.bucket_count = bucket_count_for(entries.size());
+    header.records_offset = sizeof(RegionHeader) + align8(header.bucket_count * sizeof(uint32_t));
+    header.strings_offset = header.records_offset + entries.size() * sizeof(Record);
+    header.used_bytes = image_bytes(entries);
+
+    auto* buckets = reinterpret_cast<uint32_t*>(region + sizeof(RegionHeader));
+    std::memset(buckets, 0, header.bucket_count * sizeof(uint32_t));
+
+    uint64_t mask = header.bucket_count - 1;
+    uint64_t string_pos = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        const FileEntry& entry = entries[i];
+
+        Record record{};
+        record.path_hash = path_hash(entry.path);
+        record.content_hash = entry.content_hash;
+        record.size = entry.size;
+        record.mtime = entry.mtime;
+        record.semantic_hash = entry.semantic_hash;
+        record.path_offset = string_pos;
+        record.path_length = static_cast<uint32_t>(entry.path.size());
+        record.language = static_cast<uint8_t>(entry.language);
+        record.flags = entry.flags;
+        record.is_indexed = entry.is_indexed ? 1 : 0;
+        std::memcpy(region + header.records_offset + i * sizeof(Record), &record, sizeof(Record));
+
+        std::memcpy(region + header.strings_offset + string_pos, entry.path.data(), entry.path.size());
+        string_pos += entry.path.size();
+
+        uint64_t slot = record.path_hash & mask;
+        while (buckets[slot] != 0) slot = (slot + 1) & mask;
+        buckets[slot] = static_cast<uint32_t>(i + 1);
+    }
+
+    std::memcpy(region, &header, sizeof(header));
+}
+
+/**
+ * @brief Bounds-checked access to one region
+ *
+ * A reader may look at a region the writer is rewriting; such reads are
+ * discarded after the epoch check, but must not run outside the mapping
+ * or loop forever on torn data.
+ */
+class RegionView {
+public:
+    RegionView(const char* base, uint64_t bytes) : base_(base), bytes_(bytes) {
+        if (bytes_ < sizeof(RegionHeader)) return;
+        std::memcpy(&header_, base_, sizeof(header_));
+
+        const RegionHeader& h = header_;
+        valid_ = h.bucket_count != 0 && (h.bucket_count & (h.bucket_count - 1)) == 0 &&
+                 h.bucket_count <= bytes_ / sizeof(uint32_t) &&
+                 h.records_offset >= sizeof(RegionHeader) + h.bucket_count * sizeof(uint32_t) &&
+                 h.records_offset <= bytes_ &&
+                 h.entry_count <= (bytes_ - h.records_offset) / sizeof(Record) &&
+                 h.strings_offset >= h.records_offset + h.entry_count * sizeof(Record) &&
+                 h.strings_offset <= bytes_;
+    }
+
+    bool valid() const { return valid_; }
+    const RegionHeader& header() const { return header_; }
+
+    bool record(uint64_t index, Record& out) const {
+        if (index >= header_.entry_count) return false;
+        std::memcpy(&out, base_ + header_.records_offset + index * sizeof(Record), sizeof(Record));
+        return true;
+    }
+
+    bool path(const Record& record, std::string_view& out) const {
+        uint64_t pool = bytes_ - header_.strings_offset;
+        if (record.path_offset > pool || record.path_length > pool - record.path_offset) return false;
+        out = std::string_view(base_ + header_.strings_offset + record.path_offset, record.path_length);
+        return true;
+    }
+
+    bool entry(const Record& record, FileEntry& out) const {
+        std::string_view path_view;
+        if (!path(record, path_view)) return false;
+        out.path.assign(path_view.data(), path_view.size());
+        out.content_hash = record.content_hash;
+        out.size = record.size;
+        out.mtime = record.mtime;
+        out.language = static_cast<Language>(record.language);
+        out.is_indexed = record.is_indexed != 0;
+        out.flags = record.flags;
+        out.semantic_hash = record.semantic_hash;
+        return true;
+    }
+
+    bool find(std::string_view path_key, Record& out) const {
+        uint64_t hash = path_hash(path_key);
+        uint64_t mask = header_.bucket_count - 1;
+        uint64_t slot = hash & mask;
+        for (uint64_t probe = 0; probe < header_.bucket_count; probe++) {
+            uint32_t value;
+            std::memcpy(&value, base_ + sizeof(RegionHeader) + slot * sizeof(uint32_t), sizeof(value));
+            if (value == 0) return false;
+
+            Record record;
+            std::string_view candidate;
+            if (!this->record(value - 1, record)) return false;
+            if (record.path_hash == hash && this->path(record, candidate) && candidate == path_key) {
+                out = record;
+                return true;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return false;
+    }
+
+private:
+    const char* base_;
+    uint64_t bytes_;
+    RegionHeader header_{};
+    bool valid_ = false;
+};
+
+/**
+ * @brief Map "shm:<name>" to a shared-memory object, anything else to a file
+ */
+bool is_shm_name(const std::string& name) {
+    return name.compare(0, 4, "shm:") == 0;
+}
+
+int open_segment(const std::string& name, int flags) {
+    if (is_shm_name(name)) {
+        std::string shm_name = "/" + name.substr(4);
+        return shm_open(shm_name.c_str(), flags, 0600);
+    }
+    return ::open(name.c_str(), flags | O_CLOEXEC, 0600);
+}
+
+/**
+ * @brief Open a segment for writing, creating it if absent
+ * @param created Set when this call created it
+ */
+int create_segment(const std::string& name, bool& created) {
+    for (;;) {
+        int fd = open_segment(name, O_RDWR | O_CREAT | O_EXCL);
+        if (fd >= 0 || errno != EEXIST) {
+            created = fd >= 0;
+            return fd;
+        }
+        fd = open_segment(name, O_RDWR);
+        if (fd >= 0 || errno != ENOENT) {
+            created = false;
+            return fd;
+        }
+        // Removed between the two opens; try again
+    }
+}
+
+std::string errno_message(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+struct SharedFileIndex::Impl {
+    int fd = -1;
+    char* base = nullptr;
+    uint64_t mapped_bytes = 0;
+    bool writer = false;
+    bool created = false;       // create() made the segment instead of taking one over
+    mutable std::mutex mutex;
+
+    SegmentHeader* header() const { return reinterpret_cast<SegmentHeader*>(base); }
+
+    bool map(uint64_t bytes) {
+        if (base) munmap(base, mapped_bytes);
+        int prot = writer ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* data = mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            base = nullptr;
+            mapped_bytes = 0;
+            return false;
+        }
+        base = static_cast<char*>(data);
+        mapped_bytes = bytes;
+        return true;
+    }
+
+    /**
+     * @brief Extend the mapping of a reader after the writer grew the segment
+     */
+    bool remap_to(uint64_t bytes) {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < bytes) return false;
+        uint64_t old_bytes = mapped_bytes;
+        if (map(bytes)) return true;
+        map(old_bytes);     // Keep the smaller mapping usable if the larger one failed
+        return false;
+    }
+
+    /**
+     * @brief Whether some process still holds the writer lock
+     */
+    bool writer_alive() const {
+        if (writer) return true;
+        if (flock(fd, LOCK_SH | LOCK_NB) != 0) return errno == EWOULDBLOCK;
+        flock(fd, LOCK_UN);
+        return false;
+    }
+
+    /**
+     * @brief Run fn over the current snapshot until it read a stable one
+     *
+     * fn must reset its outputs, since it is repeated when the writer
+     * started reusing the region during the read. Gives up when retries
+     * keep failing and no writer is left to finish the publish.
+     */
+    template <typename Fn>
+    bool read(Fn&& fn) const {
+        if (!base) return false;
+        auto* self = const_cast<Impl*>(this);
+
+        for (uint32_t attempt = 1;; attempt++) {
+            uint64_t epoch = header()->epoch.load(std::memory_order_acquire);
+            uint64_t region_bytes = header()->region_bytes.load(std::memory_order_acquire);
+
+            uint64_t needed = HEADER_BYTES + 2 * region_bytes;
+            bool mapped = region_bytes >= sizeof(RegionHeader) &&
+                          (needed <= mapped_bytes || self->remap_to(needed));
+            if (mapped) {
+                RegionView view(base + HEADER_BYTES + (epoch & 1) * region_bytes, region_bytes);
+                bool ok = view.valid() && fn(view);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (header()->writing.load(std::memory_order_relaxed) < epoch + 2 &&
+                    header()->region_bytes.load(std::memory_order_relaxed) == region_bytes) {
+                    return ok;
+                }
+            }
+            if (!base) return false;
+
+            if (attempt % 64 == 0) {
+                if (!writer_alive() || (!mapped && attempt >= 4096)) return false;
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void close() {
+        if (base) munmap(base, mapped_bytes);
+        if (fd >= 0) ::close(fd);   // Also drops the writer lock
+        fd = -1;
+        base = nullptr;
+        mapped_bytes = 0;
+        writer = false;
+        created = false;
+    }
+};
+
+SharedFileIndex::SharedFileIndex() : impl_(std::make_unique<Impl>()) {}
+
+SharedFileIndex::~SharedFileIndex() {
+    impl_->close();
+}
+
+bool SharedFileIndex::create(const std::string& name, uint64_t capacity, std::string& error) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->close();
+
+    bool created = false;
+    impl_->fd = create_segment(name, created);
+    if (impl_->fd < 0) {
+        error = errno_message("cannot open " + name);
+        return false;
+    }
+    if (flock(impl_->fd, LOCK_EX | LOCK_NB) != 0) {
+        error = errno == EWOULDBLOCK ? name + " already has a writer"
+                                     : errno_message("cannot lock " + name);
+        impl_->close();
+        return false;
+    }
+    impl_->writer = true;
+
+    struct stat st;
+    if (fstat(impl_->fd, &st) != 0) {
+        error = errno_message("cannot stat " + name);
+        impl_->close();
+        return false;
+    }
+
+    // Take over a segment left by a previous writer, keeping its epochs
+    // monotonic for readers that are still attached
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    bool reuse = false;
+    if (size >= HEADER_BYTES && impl_->map(HEADER_BYTES)) {
+        SegmentHeader* header = impl_->header();
+        uint64_t region_bytes = header->region_bytes.load(std::memory_order_relaxed);
+        reuse = header->magic == SEGMENT_MAGIC && header->version == SEGMENT_VERSION &&
+                region_bytes >= MIN_REGION_BYTES && size >= HEADER_BYTES + 2 * region_bytes;
+        if (reuse) reuse = impl_->map(HEADER_BYTES + 2 * region_bytes);
+    }
+
+    // Only a segment of our own making may be overwritten, never an unrelated file
+    if (!reuse && size > 0 && !created) {
+        bool ours = size >= HEADER_BYTES && impl_->base && impl_->header()->magic == SEGMENT_MAGIC;
+        if (!ours) {
+            error = name + " exists and is not a shared index";
+            impl_->close();
+            return false;
+        }
+    }
+
+    if (reuse) {
+        SegmentHeader* header = impl_->header();
+        uint64_t epoch = header->epoch.load(std::memory_order_relaxed);
+        uint64_t region_bytes = header->region_bytes.load(std::memory_order_relaxed);
+        if (header->writing.load(std::memory_order_relaxed) != epoch) {
+            // The previous writer died mid-publish; a grow may have left the
+            // current snapshot behind, so replace it with an empty one
+            header->writing.store(epoch + 2, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            write_image(impl_->base + HEADER_BYTES + (epoch & 1) * region_bytes, {}, 0);
+            header->epoch.store(epoch + 2, std::memory_order_release);
+        }
+        header->writer_pid.store(static_cast<uint64_t>(getpid()), std::memory_order_relaxed);
+        impl_->created = created;
+        return true;
+    }
+
+    uint64_t region_bytes = std::max(MIN_REGION_BYTES, (capacity + 4095) & ~uint64_t(4095));
+    if (ftruncate(impl_->fd, static_cast<off_t>(HEADER_BYTES + 2 * region_bytes)) != 0 ||
+        !impl_->map(HEADER_BYTES + 2 * region_bytes)) {
+        error = errno_message("cannot size " + name);
+        impl_->close();
+        return false;
+    }
+
+    auto* header = new (impl_->base) SegmentHeader();
+    header->version = SEGMENT_VERSION;
+    header->epoch.store(0, std::memory_order_relaxed);
+    header->writing.store(0, std::memory_order_relaxed);
+    header->region_bytes.store(region_bytes, std::memory_order_relaxed);
+    header->writer_pid.store(static_cast<uint64_t>(getpid()), std::memory_order_relaxed);
+    write_image(impl_->base + HEADER_BYTES, {}, 0);
+
+    // Readers recognise the segment only once it is complete
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SEGMENT_MAGIC;
+    impl_->created = created;
+    return true;
+}
+
+bool SharedFileIndex::open(const std::string& name, std::string& error) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->close();
+
+    impl_->fd = open_segment(name, O_RDONLY);
+    if (impl_->fd < 0) {
+        error = errno_message("cannot open " + name);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(impl_->fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < HEADER_BYTES ||
+        !impl_->map(static_cast<uint64_t>(st.st_size))) {
+        error = name + " is not a shared index";
+        impl_->close();
+        return false;
+    }
+
+    const SegmentHeader* header = impl_->header();
+    if (header->magic != SEGMENT_MAGIC) {
+        error = name + " is not a shared index";
+        impl_->close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->version != SEGMENT_VERSION) {
+        error = name + " has unsupported version " + std::to_string(header->version);
+        impl_->close();
+        return false;
+    }
+    return true;
+}
+
+void SharedFileIndex::close() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->close();
+}
+
+bool SharedFileIndex::publish(const FileIndex& index, std::string& error) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->writer) {
+        error = "shared index is not open for writing";
+        return false;
+    }
+
+    std::vector<FileEntry> entries = index.get_all();
+    uint64_t merkle_root = index.merkle_hash();
+    std::sort(entries.begin(), entries.end(),
+              [](const FileEntry& a, const FileEntry& b) { return a.path < b.path; });
+
+    SegmentHeader* header = impl_->header();
+    uint64_t epoch = header->epoch.load(std::memory_order_relaxed);
+    uint64_t region_bytes = header->region_bytes.load(std::memory_order_relaxed);
+    uint64_t needed = image_bytes(entries);
+    uint64_t target = epoch + 1;
+
+    if (needed > region_bytes) {
+        // Grow without disturbing the current snapshot: extend the segment,
+        // write into the new region 1, which lies past both old regions, and
+        // only then switch the layout. Readers keep the old snapshot until
+        // the three stores at the end; the target epoch is odd (region 1)
+        // and at least epoch + 2, so readers of the old layout retry.
+        uint64_t grown = std::max(needed + needed / 2, region_bytes * 2);
+        grown = (grown + 4095) & ~uint64_t(4095);
+        target = (epoch + 2) | 1;
+
+        if (ftruncate(impl_->fd, static_cast<off_t>(HEADER_BYTES + 2 * grown)) != 0 ||
+            !impl_->map(HEADER_BYTES + 2 * grown)) {
+            error = errno_message("cannot grow shared index");
+            if (!impl_->base) impl_->close();
+            return false;
+        }
+        header = impl_->header();
+        write_image(impl_->base + HEADER_BYTES + grown, entries, merkle_root);
+
+        header->writing.store(target, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header->region_bytes.store(grown, std::memory_order_relaxed);
+        header->epoch.store(target, std::memory_order_release);
+        return true;
+    }
+
+    header->writing.store(target, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    write_image(impl_->base + HEADER_BYTES + (target & 1) * region_bytes, entries, merkle_root);
+    header->epoch.store(target, std::memory_order_release);
+    return true;
+}
+
+bool SharedFileIndex::unlink(const std::string& name) {
+    if (is_shm_name(name)) {
+        std::string shm_name = "/" + name.substr(4);
+        return shm_unlink(shm_name.c_str()) == 0;
+    }
+    return ::unlink(name.c_str()) == 0;
+}
+
+bool SharedFileIndex::get(const std::string& path, FileEntry& out) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->read([&](const RegionView& view) {
+        Record record;
+        return view.find(path, record) && view.entry(record, out);
+    });
+}
+
+bool SharedFileIndex::contains(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->read([&](const RegionView& view) {
+        Record record;
+        return view.find(path, record);
+    });
+}
+
+std::vector<FileEntry> SharedFileIndex::get_all() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<FileEntry> result;
+    impl_->read([&](const RegionView& view) {
+        result.clear();
+        result.resize(view.header().entry_count);
+        Record record;
+        for (uint64_t i = 0; i < result.size(); i++) {
+            if (!view.record(i, record) || !view.entry(record, result[i])) return false;
+        }
+        return true;
+    });
+    return result;
+}
+
+std::vector<FileEntry> SharedFileIndex::get_by_language(Language language) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    std::vector<FileEntry> result;
+    impl_->read([&](const RegionView& view) {
+        result.clear();
+        Record record;
+        for (uint64_t i = 0; i < view.header().entry_count; i++) {
+            if (!view.record(i, record)) return false;
+            if (record.language != static_cast<uint8_t>(language)) continue;
+            result.emplace_back();
+            if (!view.entry(record, result.back())) return false;
+        }
+        return true;
+    });
+    return result;
+}
+
+size_t SharedFileIndex::size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint64_t count = 0;
+    impl_->read([&](const RegionView& view) {
+        count = view.header().entry_count;
+        return true;
+    });
+    return static_cast<size_t>(count);
+}
+
+uint64_t SharedFileIndex::merkle_hash() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    uint64_t root = 0;
+    impl_->read([&](const RegionView& view) {
+        root = view.header().merkle_root;
+        return true;
+    });
+    return root;
+}
+
+uint64_t SharedFileIndex::epoch() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->base) return 0;
+    return impl_->header()->epoch.load(std::memory_order_acquire);
+}
+
+bool SharedFileIndex::is_open() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->base != nullptr;
+}
+
+bool SharedFileIndex::is_writer() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->writer;
+}
+
+bool SharedFileIndex::created() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->created;
+}
+
+#else
+
+struct SharedFileIndex::Impl {};
+
+SharedFileIndex::SharedFileIndex() : impl_(std::make_unique<Impl>()) {}
+
+SharedFileIndex::~SharedFileIndex() = default;
+
+bool SharedFileIndex::create(const std::string&, uint64_t, std::string& error) {
+    error = "shared index is not supported on this platform";
+    return false;
+}
+
+bool SharedFileIndex::open(const std::string&, std::string& error) {
+    error = "shared index is not supported on this platform";
+    return false;
+}
+
+void SharedFileIndex::close() {}
+
+bool SharedFileIndex::publish(const FileIndex&, std::string& error) {
+    error = "shared index is not supported on this platform";
+    return false;
+}
+
+bool SharedFileIndex::unlink(const std::string&) {
+    return false;
+}
+
+bool SharedFileIndex::get(const std::string&, FileEntry&) const {
+    return false;
+}
+
+bool SharedFileIndex::contains(const std::string&) const {
+    return false;
+}
+
+std::vector<FileEntry> SharedFileIndex::get_all() const {
+    return {};
+}
+
+std::vector<FileEntry> SharedFileIndex::get_by_language(Language) const {
+    return {};
+}
+
+size_t SharedFileIndex::size() const {
+    return 0;
+}
+
+uint64_t SharedFileIndex::merkle_hash() const {
+    return 0;
+}
+
+uint64_t SharedFileIndex::epoch() const {
+    return 0;
+}
+
+bool SharedFileIndex::is_open() const {
+    return false;
+}
+
+bool SharedFileIndex::is_writer() const {
+    return false;
+}
+
+bool SharedFileIndex::created() const {
+    return false;
+}
+
+#endif
+
+} // namespace indexer
+} // namespace archicore
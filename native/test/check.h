@@ -0,0 +1,38 @@
+/**
+ * @file check.h
+ * @brief Minimal assertions for the native unit tests
+ */
+
+#ifndef ARCHICORE_TEST_CHECK_H
+#define ARCHICORE_TEST_CHECK_H
+
+#include <cstdio>
+
+namespace archicore {
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief Exit code for main: nonzero when any check failed
+ */
+inline int result() {
+    if (failures() > 0) std::fprintf(stderr, "%d check(s) failed\n", failures());
+    return failures() > 0 ? 1 : 0;
+}
+
+} // namespace test
+} // namespace archicore
+
+#define CHECK(cond)                                                                       \
+    do {                                                                                  \
+        if (!(cond)) {                                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++archicore::test::failures();                                                \
+        }                                                                                 \
+    } while (0)
+
+#endif // ARCHICORE_TEST_CHECK_H
@@ -0,0 +1,153 @@
+/**
+ * @file cycles_test.cpp
+ * @brief find_cycles against brute-force enumeration on random graphs
+ */
+
+#include "check.h"
+#include "graph.h"
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+
+using namespace archicore;
+using namespace archicore::graph;
+
+namespace {
+
+using Cycle = std::vector<uint32_t>;
+using Adjacency = std::vector<std::vector<uint32_t>>;
+
+bool shorter(const Cycle& a, const Cycle& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+// Every simple cycle up to max_length nodes, starting at its smallest node
+std::set<Cycle> brute_cycles(const Adjacency& adj, uint32_t max_length) {
+    uint32_t n = static_cast<uint32_t>(adj.size());
+    std::set<Cycle> out;
+    Cycle path;
+    std::vector<bool> on_path(n, false);
+
+    std::function<void(uint32_t, uint32_t)> dfs = [&](uint32_t start, uint32_t node) {
+        for (uint32_t next : adj[node]) {
+            if (next == start && path.size() >= 2) {
+                out.insert(path);
+            } else if (next > start && !on_path[next] && (max_length == 0 || path.size() < max_length)) {
+                on_path[next] = true;
+                path.push_back(next);
+                dfs(start, next);
+                path.pop_back();
+                on_path[next] = false;
+            }
+        }
+    };
+    for (uint32_t s = 0; s < n; s++) {
+        path = {s};
+        on_path[s] = true;
+        dfs(s, s);
+        on_path[s] = false;
+    }
+    return out;
+}
+
+struct RandomGraph {
+    CsrGraph csr;
+    Adjacency adj;
+};
+
+RandomGraph random_graph(std::mt19937& rng) {
+    uint32_t n = 1 + rng() % 12;
+    uint32_t m = rng() % (n * 3 + 1);
+    RandomGraph g;
+    g.adj.resize(n);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t a = rng() % n;
+        uint32_t b = rng() % n;
+        edges.push_back({a, b});
+        auto& list = g.adj[a];
+        if (a != b && std::find(list.begin(), list.end(), b) == list.end()) list.push_back(b);
+    }
+    g.csr = CsrGraph::from_edges(n, edges);
+    return g;
+}
+
+// With unlimited counts every cycle within the bound comes back, once
+void finds_every_cycle() {
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 400; trial++) {
+        RandomGraph g = random_graph(rng);
+        uint32_t max_length = trial % 3 == 0 ? 0 : 2 + rng() % 5;
+
+        CycleConfig config;
+        config.max_cycles = 1000000;
+        config.max_cycles_per_component = 1000000;
+        config.max_length = max_length;
+        config.max_steps = UINT64_MAX / 2;
+        CycleResult result = find_cycles(g.csr, config);
+
+        std::set<Cycle> expected = brute_cycles(g.adj, max_length);
+        std::set<Cycle> got(result.cycles.begin(), result.cycles.end());
+        CHECK(got == expected);
+        CHECK(got.size() == result.cycles.size());
+        CHECK(!result.truncated);
+    }
+}
+
+// With a per-component share, each component returns its shortest cycles
+void keeps_the_shortest() {
+    std::mt19937 rng(11);
+    for (int trial = 0; trial < 400; trial++) {
+        RandomGraph g = random_graph(rng);
+        uint32_t n = g.csr.node_count();
+
+        CycleConfig config;
+        config.max_cycles = 1000000;
+        config.max_cycles_per_component = 3;
+        config.max_steps = UINT64_MAX / 2;
+        CycleResult result = find_cycles(g.csr, config);
+
+        std::vector<uint32_t> component;
+        tarjan_scc(n, [&g](uint32_t node) { return g.csr.neighbors(node); }, component);
+        std::map<uint32_t, std::vector<Cycle>> expected;
+        for (const Cycle& cycle : brute_cycles(g.adj, 0)) expected[component[cycle[0]]].push_back(cycle);
+
+        std::map<uint32_t, std::vector<Cycle>> got;
+        for (const Cycle& cycle : result.cycles) got[component[cycle[0]]].push_back(cycle);
+
+        CHECK(got.size() == expected.size());
+        for (auto& entry : expected) {
+            std::vector<Cycle>& cycles = entry.second;
+            std::sort(cycles.begin(), cycles.end(), shorter);
+            if (cycles.size() > 3) cycles.resize(3);
+            CHECK(got[entry.first] == cycles);
+        }
+        CHECK(result.truncated == (result.cycles.size() < brute_cycles(g.adj, 0).size()));
+    }
+}
+
+// Default limits stop a dense graph within the step budget, shortest first
+void dense_graph_stays_in_budget() {
+    std::mt19937 rng(9);
+    uint32_t n = 20000;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < 200000; i++) edges.push_back({rng() % n, rng() % n});
+
+    CycleResult result = find_cycles(CsrGraph::from_edges(n, edges));
+    CycleConfig defaults;
+    CHECK(!result.cycles.empty());
+    CHECK(result.cycles.size() <= defaults.max_cycles_per_component);
+    CHECK(result.steps <= defaults.max_steps + n);
+    CHECK(result.truncated);
+    CHECK(std::is_sorted(result.cycles.begin(), result.cycles.end(), shorter));
+}
+
+} // namespace
+
+int main() {
+    finds_every_cycle();
+    keeps_the_shortest();
+    dense_graph_stays_in_budget();
+    return test::result();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file daemon_diff_test.cpp
+ * @brief DIFF coalesces the change log per path over the requested span
+ */
+
+#include "check.h"
+#include "daemon.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace archicore;
+using namespace archicore::daemon;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Change {
+    indexer::ChangeType type;
+    std::string old_path;
+    uint64_t old_hash = 0;
+    uint64_t new_hash = 0;
+};
+
+struct Diff {
+    uint64_t generation = 0;
+    bool complete = false;
+    std::map<std::string, Change> changes;
+};
+
+void write_file(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+PayloadReader reply(const std::string& frame) {
+    FrameHeader header;
+    bool ok = read_frame_header(frame.data(), frame.size(), header);
+    CHECK(ok && header.code == static_cast<uint8_t>(ReplyStatus::OK));
+    return PayloadReader(std::string_view(frame).substr(FRAME_HEADER_SIZE));
+}
+
+// Generation after applying pending changes
+uint64_t generation(Daemon& daemon) {
+    std::string frame = daemon.dispatch(static_cast<uint8_t>(Opcode::STATUS), 1, "");
+    PayloadReader reader = reply(frame);
+    std::string root;
+    uint64_t value = 0;
+    CHECK(reader.str(root) && reader.varint(value));
+    return value;
+}
+
+std::map<std::string, uint64_t> scan(Daemon& daemon) {
+    PayloadWriter request;
+    request.str("");
+    std::string frame = daemon.dispatch(static_cast<uint8_t>(Opcode::SCAN), 1, request.data());
+    PayloadReader reader = reply(frame);
+    uint64_t gen = 0, merkle = 0, count = 0;
+    CHECK(reader.varint(gen) && reader.u64(merkle) && reader.varint(count));
+    std::map<std::string, uint64_t> hashes;
+    for (uint64_t i = 0; i < count; i++) {
+        std::string path;
+        uint64_t hash = 0, size = 0, mtime = 0, semantic = 0;
+        uint8_t language = 0, flags = 0;
+        CHECK(reader.str(path) && reader.u64(hash) && reader.varint(size) && reader.varint(mtime) &&
+              reader.u8(language) && reader.u8(flags) && reader.u64(semantic));
+        hashes[path] = hash;
+    }
+    return hashes;
+}
+
+Diff diff(Daemon& daemon, uint64_t since) {
+    PayloadWriter request;
+    request.varint(since);
+    std::string frame = daemon.dispatch(static_cast<uint8_t>(Opcode::DIFF), 1, request.data());
+    PayloadReader reader = reply(frame);
+    Diff result;
+    uint8_t complete = 0;
+    uint64_t count = 0;
+    CHECK(reader.varint(result.generation) && reader.u8(complete) && reader.varint(count));
+    result.complete = complete != 0;
+    for (uint64_t i = 0; i < count; i++) {
+        uint8_t type = 0, kind = 0;
+        std::string path;
+        Change change;
+        CHECK(reader.u8(type) && reader.u8(kind) && reader.str(path) && reader.str(change.old_path) &&
+              reader.u64(change.old_hash) && reader.u64(change.new_hash));
+        change.type = static_cast<indexer::ChangeType>(type);
+        result.changes[path] = change;
+    }
+    CHECK(reader.at_end());
+    return result;
+}
+
+void test_span_coalescing(const fs::path& dir) {
+    const fs::path root = dir / "root";
+    fs::create_directories(root);
+    write_file(root / "a.js", "export const a = 1;\n");
+    write_file(root / "b.js", "export const b = 1;\n");
+    write_file(root / "c.js", "export function moved() { return 42; }\n");
+
+    DaemonConfig config;
+    config.root = root.string();
+    config.socket_path = (dir / "d.sock").string();
+    config.index_identifiers = false;
+    config.poll_interval_ms = 0;    // Rescan on every request when there is no watch
+
+    Daemon daemon(config);
+    std::string error;
+    bool started = daemon.start(error);
+    CHECK(started);
+    if (!started) {
+        std::fprintf(stderr, "start: %s\n", error.c_str());
+        return;
+    }
+
+    const uint64_t g0 = generation(daemon);
+    std::map<std::string, uint64_t> before = scan(daemon);
+
+    // a changes and changes back; d appears and disappears; b changes for good
+    write_file(root / "a.js", "export const a = 2;\n");
+    const uint64_t g1 = generation(daemon);
+    CHECK(g1 > g0);
+    write_file(root / "a.js", "export const a = 1;\n");
+    write_file(root / "d.js", "export const d = 1;\n");
+    const uint64_t g2 = generation(daemon);
+    fs::remove(root / "d.js");
+    write_file(root / "b.js", "export const b = 2;\n");
+    const uint64_t g3 = generation(daemon);
+    CHECK(g3 > g2 && g2 > g1);
+    std::map<std::string, uint64_t> after = scan(daemon);
+
+    Diff all = diff(daemon, g0);
+    CHECK(all.complete);
+    CHECK(all.generation == g3);
+    CHECK(all.changes.size() == 1);
+    CHECK(all.changes.count("b.js") == 1);
+    if (all.changes.count("b.js")) {
+        const Change& b = all.changes["b.js"];
+        CHECK(b.type == indexer::ChangeType::MODIFIED);
+        CHECK(b.old_hash == before["b.js"]);
+        CHECK(b.new_hash == after["b.js"]);
+    }
+
+    // From g1 the revert of a shows up, and d still nets out
+    Diff later = diff(daemon, g1);
+    CHECK(later.complete);
+    CHECK(later.changes.size() == 2);
+    CHECK(later.changes.count("a.js") == 1 && later.changes["a.js"].type == indexer::ChangeType::MODIFIED);
+    CHECK(later.changes["a.js"].new_hash == before["a.js"]);
+    CHECK(later.changes.count("d.js") == 0);
+
+    // From g2, d is a deletion of a file that existed at the start of the span
+    Diff deleted = diff(daemon, g2);
+    CHECK(deleted.changes.count("d.js") == 1 && deleted.changes["d.js"].type == indexer::ChangeType::DELETED);
+
+    // A move nets out to one rename
+    fs::rename(root / "c.js", root / "e.js");
+    const uint64_t g4 = generation(daemon);
+    Diff moved = diff(daemon, g3);
+    CHECK(moved.generation == g4);
+    CHECK(moved.changes.size() == 1);
+    CHECK(moved.changes.count("e.js") == 1);
+    if (moved.changes.count("e.js")) {
+        CHECK(moved.changes["e.js"].type == indexer::ChangeType::RENAMED);
+        CHECK(moved.changes["e.js"].old_path == "c.js");
+    }
+
+    // Nothing since the latest generation; generations before the log are incomplete
+    CHECK(diff(daemon, g4).changes.empty());
+    CHECK(!diff(daemon, g0 - 1).complete);
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / ("archicore_daemon_test_" + std::to_string(getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    test_span_coalescing(dir);
+
+    fs::remove_all(dir);
+    return test::result();
+}
@@ -0,0 +1,50 @@
+/**
+ * @file embedding_text_test.cpp
+ * @brief build_embedding_text: comments are stripped, literals are copied through
+ */
+
+#include "check.h"
+#include "chunker.h"
+
+using namespace archicore;
+using namespace archicore::chunker;
+
+namespace {
+
+Tokenizer tokenizer;
+
+// Embedding text of source as one chunk, without the context header
+std::string embed(Language language, const std::string& source) {
+    ChunkResult result;
+    CodeChunk chunk{};
+    chunk.content = source;
+    result.chunks.push_back(chunk);
+
+    ChunkerConfig config;
+    config.embed_context_header = false;
+    build_embedding_text(result, "", language, config, tokenizer);
+    const CodeChunk& out = result.chunks.front();
+    return result.embed_pool.substr(out.embed_offset, out.embed_length);
+}
+
+void comments_are_stripped() {
+    CHECK(embed(Language::JAVASCRIPT, "a(); // note\nb(); /* more */ c();") == "a();\nb(); c();");
+    CHECK(embed(Language::PYTHON, "x = 1  # one\ny = 2") == "x = 1\ny = 2");
+    CHECK(embed(Language::JAVASCRIPT, "s = \"// kept\";") == "s = \"// kept\";");
+}
+
+// A regex literal is a literal: its quotes and '//' open nothing
+void regex_literals_are_literals() {
+    CHECK(embed(Language::JAVASCRIPT, "const r = /\"[^\"]*\"/g; f(r); // x") == "const r = /\"[^\"]*\"/g; f(r);");
+    CHECK(embed(Language::TYPESCRIPT, "if (/\\/\\//.test(url)) go(url);") == "if (/\\/\\//.test(url)) go(url);");
+    CHECK(embed(Language::JAVASCRIPT, "return /'/.test(s) && ok(); // done") == "return /'/.test(s) && ok();");
+    CHECK(embed(Language::JAVASCRIPT, "x = a / b; // half") == "x = a / b;");
+}
+
+} // namespace
+
+int main() {
+    comments_are_stripped();
+    regex_literals_are_literals();
+    return test::result();
+}
@@ -0,0 +1,144 @@
+/**
+ * @file merge_test.cpp
+ * @brief merge_partials: the merged index matches a full scan whatever the partial order
+ */
+
+#include "check.h"
+#include "indexer.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <unistd.h>
+
+using namespace archicore;
+using namespace archicore::indexer;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void write_file(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+void fill(FileIndex& index, const ScanResult& scan) {
+    index.clear();
+    for (const auto& entry : scan.files) index.add(entry);
+}
+
+/**
+ * @brief Merge the partials in every order; all must give the full scan's root
+ */
+void check_all_orders(const std::vector<IndexPartial>& partials, const FileIndex& full) {
+    std::vector<size_t> order(partials.size());
+    std::iota(order.begin(), order.end(), 0);
+    size_t orders = 0;
+    do {
+        std::vector<IndexPartial> ordered;
+        for (size_t i : order) ordered.push_back(partials[i]);
+
+        FileIndex merged;
+        MergeResult result = merge_partials(ordered, merged);
+        CHECK(result.success);
+        if (!result.success) {
+            std::fprintf(stderr, "merge: %s\n", result.error.c_str());
+            return;
+        }
+        CHECK(result.merkle_root == full.merkle_hash());
+        CHECK(merged.merkle_hash() == full.merkle_hash());
+        CHECK(result.total_files == full.size());
+        orders++;
+    } while (std::next_permutation(order.begin(), order.end()));
+    CHECK(orders > 1);
+}
+
+void test_planned_shards(const fs::path& root, const FileIndex& full) {
+    Indexer indexer;
+    std::vector<ShardSpec> shards = indexer.plan_shards(root.string(), 3);
+    CHECK(shards.size() == 3);
+
+    std::vector<std::unique_ptr<FileIndex>> indexes;
+    std::vector<IndexPartial> partials;
+    for (const auto& shard : shards) {
+        indexes.push_back(std::make_unique<FileIndex>());
+        fill(*indexes.back(), indexer.scan_shard(root.string(), shard));
+        partials.push_back({shard, indexes.back().get()});
+    }
+    check_all_orders(partials, full);
+}
+
+void test_overlapping_shards(const fs::path& root, const FileIndex& full) {
+    // Spelled the way users write them; pkg1/a.ts is seen by two shards
+    std::vector<ShardSpec> shards = {
+        {{"./pkg1/"}, {}},
+        {{}, {"pkg1/sub", "pkg2\\"}},
+        {{"pkg2"}, {}},
+    };
+
+    Indexer indexer;
+    std::vector<std::unique_ptr<FileIndex>> indexes;
+    std::vector<IndexPartial> partials;
+    for (const auto& shard : shards) {
+        indexes.push_back(std::make_unique<FileIndex>());
+        fill(*indexes.back(), indexer.scan_shard(root.string(), shard));
+        partials.push_back({shard, indexes.back().get()});
+    }
+    check_all_orders(partials, full);
+
+    // Shards seeing the same content at different times: the newer one
+    // wins in every order, so merged entries don't depend on it either
+    FileEntry newer = *indexes[1]->get("pkg1/a.ts");
+    newer.mtime += 1000;
+    indexes[1]->add(newer);
+
+    std::vector<size_t> order(partials.size());
+    std::iota(order.begin(), order.end(), 0);
+    do {
+        std::vector<IndexPartial> ordered;
+        for (size_t i : order) ordered.push_back(partials[i]);
+        FileIndex merged;
+        MergeResult result = merge_partials(ordered, merged);
+        CHECK(result.success && result.overlap_files == 1);
+        CHECK(result.merkle_root == full.merkle_hash());
+        const FileEntry* entry = merged.get("pkg1/a.ts");
+        CHECK(entry && entry->mtime == newer.mtime);
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+void test_normalize_shard_path() {
+    CHECK(normalize_shard_path("./src/") == "src");
+    CHECK(normalize_shard_path("src\\lib\\") == "src/lib");
+    CHECK(normalize_shard_path("././a//") == "a");
+    CHECK(normalize_shard_path(".").empty());
+    CHECK(normalize_shard_path("./").empty());
+}
+
+} // namespace
+
+int main() {
+    const fs::path root = fs::temp_directory_path() / ("archicore_merge_test_" + std::to_string(getpid()));
+    fs::remove_all(root);
+
+    write_file(root / "index.ts", "export * from './pkg1/a';\n");
+    write_file(root / "pkg1/a.ts", "export const a = 1;\n");
+    write_file(root / "pkg1/sub/b.ts", "export const b = 2;\n");
+    write_file(root / "pkg2/c.ts", "export const c = 3;\n");
+    write_file(root / "pkg2/deep/d.ts", "export const d = 4;\n");
+    write_file(root / "pkg3/e.ts", "export const e = 5;\n");
+    write_file(root / "pkg4/f.ts", "export const f = 6;\n");
+
+    Indexer indexer;
+    FileIndex full;
+    fill(full, indexer.scan(root.string()));
+    CHECK(full.size() == 7);
+
+    test_planned_shards(root, full);
+    test_overlapping_shards(root, full);
+    test_normalize_shard_path();
+
+    fs::remove_all(root);
+    return test::result();
+}
@@ -0,0 +1,115 @@
+/**
+ * @file reachability_test.cpp
+ * @brief ReachabilityIndex against a brute-force BFS on random graphs under random updates
+ */
+
+#include "check.h"
+#include "graph.h"
+#include <map>
+#include <queue>
+#include <random>
+#include <set>
+
+using namespace archicore;
+using namespace archicore::graph;
+
+namespace {
+
+using EdgeSet = std::set<std::pair<int, int>>;
+
+std::string name(int i) {
+    return "n" + std::to_string(i);
+}
+
+// Distances from src over reverse edges: who is affected by changing src
+std::map<int, uint32_t> brute_affected(const EdgeSet& edges, int src) {
+    std::map<int, uint32_t> dist{{src, 0}};
+    std::queue<int> queue;
+    queue.push(src);
+    while (!queue.empty()) {
+        int node = queue.front();
+        queue.pop();
+        for (const auto& edge : edges) {
+            if (edge.second == node && dist.count(edge.first) == 0) {
+                dist[edge.first] = dist[node] + 1;
+                queue.push(edge.first);
+            }
+        }
+    }
+    return dist;
+}
+
+void check_queries(const ReachabilityIndex& index, const EdgeSet& edges, int n, std::mt19937& rng) {
+    int src = static_cast<int>(rng() % n);
+    uint32_t node = index.find_node(name(src));
+    std::map<int, uint32_t> dist = brute_affected(edges, src);
+
+    std::vector<AffectedNode> affected = index.affected({node}, 0);
+    CHECK(affected.size() == dist.size());
+    for (const AffectedNode& a : affected) {
+        int id = std::stoi(index.node_id(a.node).substr(1));
+        CHECK(dist.count(id) == 1 && dist[id] == a.distance);
+    }
+
+    CHECK(index.affected_set({node}).size() == dist.size());
+
+    int target = static_cast<int>(rng() % n);
+    CHECK(index.depends_on(index.find_node(name(target)), node) == (dist.count(target) == 1));
+
+    size_t within = 0;
+    for (const auto& entry : dist) {
+        if (entry.second <= 2) within++;
+    }
+    CHECK(index.affected({node}, 2).size() == within);
+}
+
+void random_graphs() {
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 400; trial++) {
+        // Every third graph exceeds the closure limit and takes the BFS path
+        ReachabilityConfig config;
+        config.closure_limit = trial % 3 == 0 ? 4 : 16384;
+        ReachabilityIndex index(config);
+
+        int n = 10 + trial % 50;
+        EdgeSet edges;
+        for (int i = 0; i < n; i++) index.add_node(name(i));
+        for (int k = 0; k < n * 2; k++) {
+            int a = static_cast<int>(rng() % n);
+            int b = static_cast<int>(rng() % n);
+            if (a != b && index.add_edge(name(a), name(b))) edges.insert({a, b});
+        }
+
+        for (int step = 0; step < 20; step++) {
+            switch (rng() % 4) {
+                case 0: {
+                    int a = static_cast<int>(rng() % n);
+                    int b = static_cast<int>(rng() % n);
+                    if (a != b && index.add_edge(name(a), name(b))) edges.insert({a, b});
+                    break;
+                }
+                case 1:
+                    if (!edges.empty()) {
+                        auto it = edges.begin();
+                        std::advance(it, rng() % edges.size());
+                        CHECK(index.remove_edge(name(it->first), name(it->second)));
+                        edges.erase(it);
+                    }
+                    break;
+                case 2:
+                    index.add_node(name(n++));
+                    break;
+                default:
+                    break;
+            }
+            check_queries(index, edges, n, rng);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    random_graphs();
+    return test::result();
+}
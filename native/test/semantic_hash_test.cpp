@@ -0,0 +1,70 @@
+/**
+ * @file semantic_hash_test.cpp
+ * @brief FileHasher::hash_semantic: formatting-only edits hash equal, token edits do not
+ */
+
+#include "check.h"
+#include "indexer.h"
+
+using namespace archicore;
+using namespace archicore::indexer;
+
+namespace {
+
+FileHasher hasher;
+
+bool same(Language language, std::string_view a, std::string_view b) {
+    return hasher.hash_semantic(a, language) == hasher.hash_semantic(b, language);
+}
+
+void formatting_is_ignored() {
+    CHECK(same(Language::JAVASCRIPT,
+               "function f(a, b) {\n  return a + b;\n}\n",
+               "// add\nfunction f(a,b){\n\n    return a+b; /* sum */\n}"));
+    CHECK(same(Language::JAVASCRIPT, "call(a,\n     b)\n", "call(a, b)\n"));
+    CHECK(same(Language::GO, "func f() {\n\treturn 1\n}\n", "func f() {\n    return 1 // one\n}\n"));
+    CHECK(same(Language::CPP, "int f() {\n  return 1;\n}\n", "int f() { return 1; }"));
+    CHECK(same(Language::PYTHON, "def f():\n    return 1\n", "def f():\n  # one\n  return 1\n"));
+    CHECK(!same(Language::JAVASCRIPT, "a - -b", "a--b"));
+}
+
+// Line breaks that end statements are tokens, not formatting
+void statement_newlines_are_kept() {
+    CHECK(!same(Language::JAVASCRIPT, "return\nx\n", "return x\n"));
+    CHECK(!same(Language::TYPESCRIPT, "let a = b\n(c)\n", "let a = b(c)\n"));
+    CHECK(!same(Language::GO, "x := f\n(y)\n", "x := f(y)\n"));
+    CHECK(!same(Language::KOTLIN, "val a = b\n-c\n", "val a = b -c\n"));
+    CHECK(!same(Language::SWIFT, "let a = b\n-c\n", "let a = b -c\n"));
+    CHECK(!same(Language::RUBY, "foo\nbar\n", "foo bar\n"));
+    CHECK(!same(Language::CPP, "#define A 1\nint x;\n", "#define A 1 int x;\n"));
+    CHECK(same(Language::CPP, "#define A \\\n  1\nint x;\n", "#define A 1\nint x;\n"));
+    CHECK(!same(Language::JAVASCRIPT, "a /*\n*/ b\n", "a /* */ b\n"));
+}
+
+// A regex literal is a literal: its '/*' and quotes open nothing
+void regex_literals_are_literals() {
+    CHECK(!same(Language::JAVASCRIPT, "const r = /[/*]/; const s = 1;\n",
+                                      "const r = /[/*]/; const s = 2;\n"));
+    CHECK(!same(Language::JAVASCRIPT, "if (/'/.test(s)) a = 1;\n",
+                                      "if (/'/.test(s)) a = 2;\n"));
+    CHECK(!same(Language::JAVASCRIPT, "x = /a  b/;", "x = /a b/;"));
+    CHECK(same(Language::JAVASCRIPT, "x = a / b / c;", "x = a/b/c;"));
+}
+
+// Binary and unknown content falls back to the content hash
+void opaque_content_uses_content_hash() {
+    std::string binary("\x01\x00\x02 \x03", 5);
+    std::string reformatted("\x01\x00\x02\x03", 4);
+    CHECK(!same(Language::JAVASCRIPT, binary, reformatted));
+    CHECK(!same(Language::UNKNOWN, "a b", "a  b"));
+}
+
+} // namespace
+
+int main() {
+    formatting_is_ignored();
+    statement_newlines_are_kept();
+    regex_literals_are_literals();
+    opaque_content_uses_content_hash();
+    return test::result();
+}
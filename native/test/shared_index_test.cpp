@@ -0,0 +1,202 @@
+/**
+ * @file shared_index_test.cpp
+ * @brief SharedFileIndex: consistent snapshots under concurrent publishes, takeover rules
+ */
+
+#include "check.h"
+#include "indexer.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace archicore;
+using namespace archicore::indexer;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Snapshot k has 10 + 37k entries, every one with content hash k + 1,
+// so a reader can tell a torn snapshot from a whole one
+constexpr size_t ENTRIES_BASE = 10;
+constexpr size_t ENTRIES_STEP = 37;
+
+void fill(FileIndex& index, uint64_t k) {
+    index.clear();
+    for (size_t i = 0; i < ENTRIES_BASE + ENTRIES_STEP * k; i++) {
+        FileEntry entry{};
+        entry.path = "src/file" + std::to_string(i) + ".ts";
+        entry.content_hash = k + 1;
+        entry.size = k;
+        entry.language = Language::TYPESCRIPT;
+        index.add(entry);
+    }
+}
+
+bool publish(SharedFileIndex& shared, uint64_t k, std::string& error) {
+    FileIndex index;
+    fill(index, k);
+    return shared.publish(index, error);
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+void test_refuses_foreign_files(const fs::path& dir) {
+    const fs::path foreign = dir / "notes.txt";
+    std::ofstream(foreign, std::ios::binary) << "not a shared index";
+
+    SharedFileIndex shared;
+    std::string error;
+    CHECK(!shared.create(foreign.string(), 0, error));
+    CHECK(!error.empty());
+    CHECK(read_file(foreign) == "not a shared index");
+
+    // An empty file carries nothing to lose
+    const fs::path empty = dir / "empty.idx";
+    std::ofstream(empty, std::ios::binary).flush();
+    CHECK(shared.create(empty.string(), 0, error));
+    CHECK(!shared.created());
+    shared.close();
+}
+
+void test_creator_and_takeover(const fs::path& dir) {
+    const std::string name = (dir / "owned.idx").string();
+    std::string error;
+
+    SharedFileIndex first;
+    CHECK(first.create(name, 0, error));
+    CHECK(first.created());
+    CHECK(publish(first, 1, error));
+
+    // A second writer is refused while the first holds the segment
+    SharedFileIndex second;
+    CHECK(!second.create(name, 0, error));
+    first.close();
+
+    // Taking over keeps the epochs and is not creating
+    CHECK(second.create(name, 0, error));
+    CHECK(!second.created());
+    CHECK(second.epoch() == 1);
+    CHECK(publish(second, 2, error));
+    CHECK(second.epoch() == 2);
+    second.close();
+}
+
+void test_concurrent_readers(const fs::path& dir) {
+    const std::string name = (dir / "live.idx").string();
+    std::string error;
+
+    SharedFileIndex writer;
+    CHECK(writer.create(name, 0, error));
+    CHECK(publish(writer, 0, error));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::atomic<int> reads{0};
+
+    auto read_loop = [&]() {
+        SharedFileIndex reader;
+        std::string open_error;
+        if (!reader.open(name, open_error)) {
+            torn++;
+            return;
+        }
+        uint64_t last = 0;
+        while (!done.load()) {
+            std::vector<FileEntry> entries = reader.get_all();
+            if (entries.empty()) {
+                torn++;
+                continue;
+            }
+            uint64_t k = entries[0].content_hash - 1;
+            bool whole = entries.size() == ENTRIES_BASE + ENTRIES_STEP * k;
+            for (const auto& entry : entries) {
+                if (entry.content_hash != k + 1 || entry.size != k) whole = false;
+            }
+            // Snapshots only move forward
+            if (!whole || k < last) torn++;
+            last = k;
+
+            FileEntry first;
+            if (!reader.get("src/file0.ts", first) || first.content_hash < k + 1) torn++;
+            reads++;
+        }
+    };
+
+    std::thread a(read_loop);
+    std::thread b(read_loop);
+
+    // Enough entries to grow the regions several times over
+    const uint64_t snapshots = 300;
+    for (uint64_t k = 1; k <= snapshots; k++) {
+        if (!publish(writer, k, error)) {
+            std::fprintf(stderr, "publish: %s\n", error.c_str());
+            torn++;
+            break;
+        }
+    }
+    done = true;
+    a.join();
+    b.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(reads.load() > 0);
+    CHECK(writer.epoch() > snapshots);     // Grows skip epochs
+
+    SharedFileIndex reader;
+    CHECK(reader.open(name, error));
+    CHECK(reader.size() == ENTRIES_BASE + ENTRIES_STEP * snapshots);
+    FileIndex last;
+    fill(last, snapshots);
+    CHECK(reader.merkle_hash() == last.merkle_hash());
+}
+
+void test_dead_writer_keeps_snapshot(const fs::path& dir) {
+    const std::string name = (dir / "crash.idx").string();
+
+    pid_t child = fork();
+    if (child == 0) {
+        SharedFileIndex writer;
+        std::string error;
+        bool ok = writer.create(name, 0, error) && publish(writer, 3, error);
+        _exit(ok ? 0 : 1);     // No close(): the lock goes with the process
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    SharedFileIndex reader;
+    std::string error;
+    CHECK(reader.open(name, error));
+    CHECK(reader.size() == ENTRIES_BASE + ENTRIES_STEP * 3);
+
+    SharedFileIndex next;
+    CHECK(next.create(name, 0, error));
+    CHECK(!next.created());
+    CHECK(reader.size() == ENTRIES_BASE + ENTRIES_STEP * 3);
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / ("archicore_shared_test_" + std::to_string(getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    test_refuses_foreign_files(dir);
+    test_creator_and_takeover(dir);
+    test_concurrent_readers(dir);
+    test_dead_writer_keeps_snapshot(dir);
+
+    fs::remove_all(dir);
+    return test::result();
+}
@@ -0,0 +1,76 @@
+/**
+ * @file stream_test.cpp
+ * @brief ChunkStream: windows of an extensionless script keep its language
+ */
+
+#include "check.h"
+#include "chunker.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace archicore;
+using namespace archicore::chunker;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+size_t count_functions(const std::vector<CodeChunk>& chunks) {
+    size_t count = 0;
+    for (const auto& chunk : chunks) {
+        if (chunk.type == ChunkType::FUNCTION) count++;
+    }
+    return count;
+}
+
+void test_shebang_script(const fs::path& dir) {
+    // No extension: only the shebang in the first window names the language
+    const fs::path path = dir / "serve";
+    std::string source = "#!/usr/bin/env node\n'use strict';\n\n";
+    for (int i = 0; i < 400; i++) {
+        source += "function handler" + std::to_string(i) + "(request, response) {\n"
+                  "    const value = request.params.id + " + std::to_string(i) + ";\n"
+                  "    response.send(value);\n"
+                  "}\n\n";
+    }
+    std::ofstream(path, std::ios::binary) << source;
+
+    ChunkerConfig config;
+    config.stream_window_bytes = 2048;
+    config.stream_lookahead_bytes = 512;
+
+    Chunker chunker(config);
+    ChunkResult whole = chunker.chunk(source, path.string());
+    CHECK(whole.language == Language::JAVASCRIPT);
+
+    ChunkStream stream(path.string(), config);
+    CHECK(stream.is_open());
+
+    std::vector<CodeChunk> all;
+    std::vector<CodeChunk> window;
+    size_t windows = 0;
+    size_t windows_with_functions = 0;
+    while (stream.next_window(window)) {
+        windows++;
+        if (count_functions(window) > 0) windows_with_functions++;
+        all.insert(all.end(), window.begin(), window.end());
+    }
+
+    CHECK(windows > 10);
+    CHECK(windows_with_functions == windows);
+    CHECK(count_functions(all) == count_functions(whole.chunks));
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / ("archicore_stream_test_" + std::to_string(getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    test_shebang_script(dir);
+
+    fs::remove_all(dir);
+    return test::result();
+}
@@ -7,6 +7,7 @@
 
 import { DependencyGraph, Symbol } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { countTokens, packContext, ContextSnippet, IdentifierIndex, isNativeAvailable } from '../native/chunker.js';
 
 // Типы намерений пользователя
 export type UserIntent =
@@ -277,16 +278,26 @@ export class ContextBuilder {
   private graph: DependencyGraph;
   private fileContents: Map<string, string>;
   private projectStats: ProjectContext['projectStats'];
+  // Индекс идентификаторов и вызовов (нативный), строится при первом запросе
+  private identifiers: IdentifierIndex | null;
+  // Смещения начал строк по файлам, для сниппетов без split('\n')
+  private lineOffsets = new Map<string, Uint32Array>();
 
+  /**
+   * @param identifiers Индекс, заполненный при чанкинге (SemanticChunker.setIdentifierIndex);
+   *                    без него индекс строится из fileContents
+   */
   constructor(
     symbols: Map<string, Symbol>,
     graph: DependencyGraph,
     fileContents: Map<string, string>,
-    projectStats?: Partial<ProjectContext['projectStats']>
+    projectStats?: Partial<ProjectContext['projectStats']>,
+    identifiers?: IdentifierIndex
   ) {
     this.symbols = symbols;
     this.graph = graph;
     this.fileContents = fileContents;
+    this.identifiers = identifiers ?? null;
     this.projectStats = {
       totalFiles: fileContents.size,
       totalSymbols: symbols.size,
@@ -476,9 +487,7 @@ export class ContextBuilder {
         const confidence = this.calculateMatchConfidence(nameLower, term);
 
         if (confidence > 0.3) {
-          const fileContent = this.fileContents.get(symbol.filePath) || '';
-          const lines = fileContent.split('\n');
-          const snippet = this.getSnippet(lines, symbol.location.startLine, 3);
+          const snippet = this.getSnippet(symbol.filePath, symbol.location.startLine, SNIPPET_CONTEXT);
 
           results.push({
             name,
@@ -539,24 +548,94 @@ export class ContextBuilder {
   /**
    * Получение сниппета кода вокруг строки
    */
-  private getSnippet(lines: string[], line: number, context: number): string {
-    const start = Math.max(0, line - context - 1);
-    const end = Math.min(lines.length, line + context);
+  private getSnippet(file: string, line: number, context: number): string {
+    return this.formatLines(file, Math.max(1, line - context), line + context, new Set([line]));
+  }
 
-    return lines
-      .slice(start, end)
+  /**
+   * Строки [start, end] с номерами; отмеченные строки помечаются стрелкой
+   */
+  private formatLines(file: string, start: number, end: number, marked: Set<number>): string {
+    return this.getLines(file, start, end)
       .map((l, i) => {
-        const lineNum = start + i + 1;
-        const marker = lineNum === line ? '→' : ' ';
+        const lineNum = start + i;
+        const marker = marked.has(lineNum) ? '→' : ' ';
         return `${marker}${lineNum.toString().padStart(4)}│ ${l}`;
       })
       .join('\n');
   }
 
+  /**
+   * Строки файла [from, to] (с 1) по таблице смещений строк
+   */
+  private getLines(file: string, from: number, to: number): string[] {
+    const content = this.fileContents.get(file) ?? '';
+    let starts = this.lineOffsets.get(file);
+    if (!starts) {
+      const offsets = [0];
+      for (let i = content.indexOf('\n'); i !== -1; i = content.indexOf('\n', i + 1)) {
+        offsets.push(i + 1);
+      }
+      starts = Uint32Array.from(offsets);
+      this.lineOffsets.set(file, starts);
+    }
+
+    const lines: string[] = [];
+    for (let line = Math.max(1, from); line <= Math.min(to, starts.length); line++) {
+      const end = line < starts.length ? starts[line] - 1 : content.length;
+      lines.push(content.slice(starts[line - 1], end));
+    }
+    return lines;
+  }
+
+  /**
+   * Нативный индекс идентификаторов; null, если нативный модуль недоступен
+   */
+  private getIdentifierIndex(): IdentifierIndex | null {
+    if (!isNativeAvailable()) return null;
+    if (!this.identifiers) {
+      this.identifiers = new IdentifierIndex();
+      for (const [file, content] of this.fileContents) {
+        this.identifiers.updateFile(file, content);
+      }
+    }
+    return this.identifiers;
+  }
+
   /**
    * Поиск мест использования символа
    */
   private findUsages(symbolName: string): Array<{ file: string; line: number; snippet: string }> {
+    const index = this.getIdentifierIndex();
+    if (!index) return this.scanUsages(symbolName);
+
+    const symbol = this.symbols.get(symbolName);
+    const usages: Array<{ file: string; line: number; snippet: string }> = [];
+    for (const occurrence of index.occurrences(symbol?.name ?? symbolName)) {
+      // Пропускаем определение самого символа (startLine с 0, occurrence.line с 1)
+      if (symbol && symbol.filePath === occurrence.file && symbol.location.startLine + 1 === occurrence.line) {
+        continue;
+      }
+      // Одна запись на строку, как при построчном поиске
+      const last = usages[usages.length - 1];
+      if (last && last.file === occurrence.file && last.line === occurrence.line) continue;
+
+      const [text = ''] = this.getLines(occurrence.file, occurrence.line, occurrence.line);
+      usages.push({
+        file: occurrence.file,
+        line: occurrence.line,
+        snippet: text.trim().substring(0, 100),
+      });
+      if (usages.length === 10) break;
+    }
+
+    return usages;
+  }
+
+  /**
+   * Поиск мест использования регулярным выражением (без нативного индекса)
+   */
+  private scanUsages(symbolName: string): Array<{ file: string; line: number; snippet: string }> {
     const usages: Array<{ file: string; line: number; snippet: string }> = [];
     const regex = new RegExp(`\\b${this.escapeRegex(symbolName)}\\b`, 'g');
 
@@ -567,7 +646,7 @@ export class ContextBuilder {
         if (regex.test(lines[i])) {
           // Пропускаем определение самого символа
           const symbol = this.symbols.get(symbolName);
-          if (symbol && symbol.filePath === file && symbol.location.startLine === i + 1) {
+          if (symbol && symbol.filePath === file && symbol.location.startLine === i) {
             continue;
           }
 
@@ -590,21 +669,28 @@ export class ContextBuilder {
     const symbol = this.symbols.get(symbolName);
     if (!symbol) return [];
 
-    const calls: string[] = [];
-    const node = this.graph.nodes.get(symbol.filePath);
+    // Функции, вызванные в теле символа
+    const index = this.getIdentifierIndex();
+    if (index) {
+      const callees = index.callees(symbol.name, { file: symbol.filePath }).map(call => call.callee);
+      return [...new Set(callees)].slice(0, 10);
+    }
 
-    if (node) {
-      const edges = this.graph.edges.get(symbol.filePath) || [];
-      for (const edge of edges) {
-        if (typeof edge === 'object' && 'target' in edge) {
-          calls.push((edge as { target: string }).target);
-        } else if (typeof edge === 'string') {
-          calls.push(edge);
-        }
+    // Без индекса — имена перед '(' в теле символа, как и у индекса
+    // (строки location с 0, getLines — с 1)
+    const { startLine, endLine } = symbol.location;
+    const calls = new Set<string>();
+    this.getLines(symbol.filePath, startLine + 1, Math.max(startLine, endLine) + 1).forEach((text, i) => {
+      for (const match of text.matchAll(CALL_PATTERN)) {
+        const callee = match[1];
+        if (NOT_CALLEES.has(callee)) continue;
+        // Объявление самого символа — не вызов
+        if (i === 0 && callee === symbol.name) continue;
+        calls.add(callee);
       }
-    }
+    });
 
-    return calls.slice(0, 10);
+    return [...calls].slice(0, 10);
   }
 
   /**
@@ -615,6 +701,12 @@ export class ContextBuilder {
     const symbol = this.symbols.get(symbolName);
     if (!symbol) return [];
 
+    // Файлы с вызовами символа
+    const index = this.getIdentifierIndex();
+    if (index) {
+      return [...new Set(index.callSites(symbol.name).map(call => call.file))].slice(0, 10);
+    }
+
     for (const [file, edges] of this.graph.edges) {
       for (const edge of edges) {
         const target = typeof edge === 'object' && 'to' in edge
@@ -1212,63 +1304,212 @@ export class ContextBuilder {
 
   /**
    * Форматирование контекста для LLM промпта
+   *
+   * Без бюджета выводятся первые элементы каждого раздела. С бюджетом
+   * (в токенах) разделы заполняются самыми релевантными элементами,
+   * которые помещаются целиком: стоимость считается точно, а
+   * пересекающиеся сниппеты символов одного файла сливаются в один.
    */
-  formatForLLM(context: ProjectContext): string {
+  formatForLLM(context: ProjectContext, tokenBudget?: number): string {
+    const header = [
+      `## Контекст проекта`,
+      `Языки: ${context.projectStats.languages.join(', ')}`,
+      `Файлов: ${context.projectStats.totalFiles}, Символов: ${context.projectStats.totalSymbols}`,
+      '',
+    ].join('\n');
+
+    const sections: Array<{ title: string; items: ContextSnippet[] }> = [
+      {
+        title: `## Найденные символы (${context.symbols.length})`,
+        items: this.symbolSnippets(context.symbols),
+      },
+      {
+        title: `## Найденные проблемы (${context.issues.length})`,
+        items: context.issues.map(issue => ({
+          text: this.formatIssue(issue),
+          score: SEVERITY_SCORE[issue.severity],
+        })),
+      },
+      {
+        title: `## Релевантные файлы`,
+        items: this.rankedFiles(context),
+      },
+      {
+        title: `## Зависимости`,
+        // Порядок зависимостей уже отражает их близость к запросу
+        items: context.dependencies.map((dep, i) => ({
+          text: `- ${dep.from} → ${dep.to}`,
+          score: 0.2 / (1 + i * 0.1),
+        })),
+      },
+    ];
+
+    if (tokenBudget === undefined) {
+      const limits = [5, 10, 5, 10];
+      const parts = [header];
+      sections.forEach((section, i) => {
+        if (section.items.length === 0) return;
+        parts.push(section.title);
+        parts.push(...section.items.slice(0, limits[i]).map(item => item.text));
+        // Список файлов отделяется пустой строкой, символы и проблемы несут её сами
+        if (i === 2) parts.push('');
+      });
+      return parts.join('\n');
+    }
+
+    // Заголовки разделов резервируются заранее, шапка проекта обязательна
+    const titles = sections.filter(s => s.items.length > 0).map(s => s.title);
+    const reserved = titles.reduce((sum, title) => sum + countTokens(title) + 1, 0);
+    const candidates: ContextSnippet[] = [{ text: header, score: 0, pinned: true }];
+    for (const section of sections) candidates.push(...section.items);
+
+    const packed = packContext(candidates, {
+      tokenBudget: Math.max(0, tokenBudget - reserved),
+      snippetOverhead: 1, // перевод строки между элементами
+    });
+    const selected = new Set(packed.selected);
+
     const parts: string[] = [];
+    if (selected.has(0)) parts.push(header);
+    let offset = 1;
+    sections.forEach((section, i) => {
+      const chosen = section.items.filter((_, j) => selected.has(offset + j));
+      offset += section.items.length;
+      if (chosen.length === 0) return;
+      parts.push(section.title);
+      parts.push(...chosen.map(item => item.text));
+      if (i === 2) parts.push('');
+    });
+    return parts.join('\n');
+  }
 
-    parts.push(`## Контекст проекта`);
-    parts.push(`Языки: ${context.projectStats.languages.join(', ')}`);
-    parts.push(`Файлов: ${context.projectStats.totalFiles}, Символов: ${context.projectStats.totalSymbols}`);
+  private formatSymbol(sym: SymbolMatch): string {
+    const parts = [
+      `### ${sym.type} ${sym.name}`,
+      `Файл: ${sym.file}:${sym.line}`,
+      '```',
+      sym.snippet,
+      '```',
+    ];
+    if (sym.usedIn.length > 0) {
+      parts.push(`Используется в: ${sym.usedIn.map(u => `${u.file}:${u.line}`).join(', ')}`);
+    }
     parts.push('');
+    return parts.join('\n');
+  }
 
-    if (context.symbols.length > 0) {
-      parts.push(`## Найденные символы (${context.symbols.length})`);
-      for (const sym of context.symbols.slice(0, 5)) {
-        parts.push(`### ${sym.type} ${sym.name}`);
-        parts.push(`Файл: ${sym.file}:${sym.line}`);
-        parts.push('```');
-        parts.push(sym.snippet);
-        parts.push('```');
-        if (sym.usedIn.length > 0) {
-          parts.push(`Используется в: ${sym.usedIn.map(u => `${u.file}:${u.line}`).join(', ')}`);
+  /**
+   * Сниппеты символов для упаковки
+   *
+   * Сниппет символа — строки вокруг объявления (см. getSnippet). Пересекающиеся
+   * диапазоны одного файла сливаются в один сниппет до упаковки, иначе соседние
+   * символы вытесняли бы друг друга из бюджета. Порядок — по лучшему символу группы.
+   */
+  private symbolSnippets(symbols: SymbolMatch[]): ContextSnippet[] {
+    type Group = { syms: SymbolMatch[]; start: number; end: number; rank: number };
+    const byFile = new Map<string, Array<{ sym: SymbolMatch; rank: number }>>();
+    symbols.forEach((sym, rank) => {
+      const list = byFile.get(sym.file) ?? [];
+      list.push({ sym, rank });
+      byFile.set(sym.file, list);
+    });
+
+    const groups: Group[] = [];
+    for (const list of byFile.values()) {
+      list.sort((a, b) => a.sym.line - b.sym.line);
+      let current: Group | null = null;
+      for (const { sym, rank } of list) {
+        const start = Math.max(1, sym.line - SNIPPET_CONTEXT);
+        const end = sym.line + SNIPPET_CONTEXT;
+        if (current && start <= current.end) {
+          current.syms.push(sym);
+          current.end = Math.max(current.end, end);
+          current.rank = Math.min(current.rank, rank);
+        } else {
+          current = { syms: [sym], start, end, rank };
+          groups.push(current);
         }
-        parts.push('');
-      }
-    }
-
-    if (context.issues.length > 0) {
-      parts.push(`## Найденные проблемы (${context.issues.length})`);
-      for (const issue of context.issues.slice(0, 10)) {
-        const icon = issue.severity === 'critical' ? '🔴' :
-                     issue.severity === 'high' ? '🟠' :
-                     issue.severity === 'medium' ? '🟡' : '🔵';
-        parts.push(`${icon} **${issue.message}** (${issue.severity})`);
-        parts.push(`   ${issue.file}:${issue.line}`);
-        parts.push(`   \`${issue.snippet}\``);
-        parts.push(`   💡 ${issue.suggestion}`);
-        parts.push('');
       }
     }
+    groups.sort((a, b) => a.rank - b.rank);
+
+    return groups.map(group => ({
+      text: group.syms.length === 1
+        ? this.formatSymbol(group.syms[0])
+        : this.formatSymbolGroup(group.syms, group.start, group.end),
+      score: Math.max(...group.syms.map(sym => sym.confidence)),
+      source: group.syms[0].file,
+      lineStart: group.start,
+      lineEnd: group.end,
+    }));
+  }
 
-    if (context.relevantFiles.length > 0) {
-      parts.push(`## Релевантные файлы`);
-      for (const file of context.relevantFiles.slice(0, 5)) {
-        parts.push(`- ${file.path}`);
+  /**
+   * Несколько символов одного файла с общим сниппетом
+   */
+  private formatSymbolGroup(group: SymbolMatch[], start: number, end: number): string {
+    const file = group[0].file;
+    const parts = group.map(sym => `### ${sym.type} ${sym.name}`);
+    parts.push(
+      `Файл: ${file}:${group.map(sym => sym.line).join(', ')}`,
+      '```',
+      this.formatLines(file, start, end, new Set(group.map(sym => sym.line))),
+      '```',
+    );
+    for (const sym of group) {
+      if (sym.usedIn.length > 0) {
+        parts.push(`${sym.name} используется в: ${sym.usedIn.map(u => `${u.file}:${u.line}`).join(', ')}`);
       }
-      parts.push('');
     }
+    parts.push('');
+    return parts.join('\n');
+  }
 
-    if (context.dependencies.length > 0) {
-      parts.push(`## Зависимости`);
-      for (const dep of context.dependencies.slice(0, 10)) {
-        parts.push(`- ${dep.from} → ${dep.to}`);
-      }
-    }
+  private formatIssue(issue: DetectedIssue): string {
+    const icon = issue.severity === 'critical' ? '🔴' :
+                 issue.severity === 'high' ? '🟠' :
+                 issue.severity === 'medium' ? '🟡' : '🔵';
+    return [
+      `${icon} **${issue.message}** (${issue.severity})`,
+      `   ${issue.file}:${issue.line}`,
+      `   \`${issue.snippet}\``,
+      `   💡 ${issue.suggestion}`,
+      '',
+    ].join('\n');
+  }
 
-    return parts.join('\n');
+  /**
+   * Файлы со шкалой релевантности, приведённой к символам (0..0.6)
+   */
+  private rankedFiles(context: ProjectContext): ContextSnippet[] {
+    const max = Math.max(0, ...context.relevantFiles.map(f => f.relevance));
+    return context.relevantFiles.map(file => ({
+      text: `- ${file.path}`,
+      score: max > 0 ? 0.6 * file.relevance / max : 0.1,
+    }));
   }
 }
 
+// Вызов в тексте: идентификатор перед '('
+const CALL_PATTERN = /([A-Za-z_$][\w$]*)\s*\(/g;
+
+// Ключевые слова, за которыми следует '(', но которые не являются вызовами
+const NOT_CALLEES = new Set([
+  'if', 'for', 'while', 'switch', 'catch', 'return', 'typeof', 'function',
+  'def', 'elif', 'with', 'await', 'yield', 'in', 'of', 'not', 'and', 'or',
+]);
+
+// Строк контекста вокруг объявления символа в сниппете
+const SNIPPET_CONTEXT = 3;
+
+// Вес проблемы при упаковке контекста по бюджету
+const SEVERITY_SCORE: Record<DetectedIssue['severity'], number> = {
+  critical: 1,
+  high: 0.8,
+  medium: 0.5,
+  low: 0.3,
+};
+
 /**
  * Создание билдера контекста из данных проекта
  */
@@ -1276,7 +1517,8 @@ export function createContextBuilder(
   symbols: Map<string, Symbol>,
   graph: DependencyGraph,
   fileContents: Map<string, string>,
-  projectStats?: Partial<ProjectContext['projectStats']>
+  projectStats?: Partial<ProjectContext['projectStats']>,
+  identifiers?: IdentifierIndex
 ): ContextBuilder {
-  return new ContextBuilder(symbols, graph, fileContents, projectStats);
+  return new ContextBuilder(symbols, graph, fileContents, projectStats, identifiers);
 }
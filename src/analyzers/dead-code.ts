@@ -11,6 +11,7 @@
 
 import { DependencyGraph, Symbol, SymbolKind } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { IdentifierIndex } from '../native/chunker.js';
 
 export interface DeadCodeResult {
   unusedExports: UnusedExport[];
@@ -69,6 +70,10 @@ export interface DeadCodeSummary {
 }
 
 export class DeadCodeDetector {
+  // Вхождения идентификаторов; между анализами переиндексируются только изменённые файлы
+  private identifiers = new IdentifierIndex();
+  private indexedContents = new Map<string, string>();
+
   /**
    * Check if file is a vendor/third-party file that should be skipped
    */
@@ -96,6 +101,8 @@ export class DeadCodeDetector {
       }
     }
 
+    this.syncIdentifiers(sourceFiles);
+
     const unusedExports = this.findUnusedExports(graph, symbols);
     const unusedVariables = this.findUnusedVariables(symbols, sourceFiles);
     const unreachableCode = this.findUnreachableCode(sourceFiles);
@@ -122,6 +129,23 @@ export class DeadCodeDetector {
     };
   }
 
+  /**
+   * Синхронизация индекса идентификаторов с содержимым файлов
+   */
+  private syncIdentifiers(fileContents: Map<string, string>): void {
+    for (const filePath of this.indexedContents.keys()) {
+      if (!fileContents.has(filePath)) {
+        this.identifiers.removeFile(filePath);
+        this.indexedContents.delete(filePath);
+      }
+    }
+    for (const [filePath, content] of fileContents) {
+      if (this.indexedContents.get(filePath) === content) continue;
+      this.identifiers.updateFile(filePath, content);
+      this.indexedContents.set(filePath, content);
+    }
+  }
+
   /**
    * Поиск неиспользуемых экспортов
    */
@@ -144,7 +168,8 @@ export class DeadCodeDetector {
       if (symbol.exports) {
         // Проверяем, используется ли символ
         const isUsed = usedSymbols.has(symbol.name) ||
-          usedSymbols.has(`${symbol.location.filePath}:${symbol.name}`);
+          usedSymbols.has(`${symbol.location.filePath}:${symbol.name}`) ||
+          this.isReferencedElsewhere(symbol.name, symbol.location.filePath);
 
         // Пропускаем entry points (index.ts, main.ts и т.д.)
         const isEntryPoint = symbol.location.filePath.match(/(index|main|app)\.(ts|js|tsx|jsx)$/);
@@ -164,6 +189,14 @@ export class DeadCodeDetector {
     return unusedExports;
   }
 
+  /**
+   * Импортируется или используется ли имя в другом файле
+   */
+  private isReferencedElsewhere(name: string, filePath: string): boolean {
+    return this.identifiers.files(name, { roles: ['import', 'reference'] })
+      .some(file => file !== filePath);
+  }
+
   // Vue lifecycle hooks and Composition API functions that should never be flagged as unused
   private readonly vueBuiltins = new Set([
     'onMounted', 'onUnmounted', 'onBeforeMount', 'onBeforeUnmount',
@@ -227,12 +260,11 @@ export class DeadCodeDetector {
 
       // Проверяем использование
       for (const [varName, line] of declaredVars) {
-        // Создаём regex для поиска использований (не объявлений)
-        const usagePattern = new RegExp(`(?<!(?:const|let|var|function)\\s+)\\b${varName}\\b`, 'g');
-        const usages = content.match(usagePattern);
+        // Использования (не объявления) из индекса; строки и комментарии не учитываются
+        const usages = this.identifiers.count(varName, { roles: ['import', 'reference'], file: filePath });
 
         // Если только одно вхождение (само объявление), то переменная не используется
-        if (!usages || usages.length <= 1) {
+        if (usages <= 1) {
           // For .vue files, check if variable is used in <template>
           if (templateContent) {
             const templateUsage = new RegExp(`\\b${varName}\\b`);
@@ -10,6 +10,7 @@ import ora from 'ora';
 import { config } from 'dotenv';
 import { ProjectManager } from './server/project-manager.js';
 import { loadLLMPlugin } from './plugins/index.js';
+import { startDaemon, connectDaemon, defaultSharedIndexPath } from './native/daemon.js';
 import * as ui from './cli/ui/index.js';
 
 config();
@@ -423,18 +424,24 @@ program
   .description('Export analysis report (json|html|markdown|csv|graphml)')
   .option('--root <dir>', 'Project directory to index first')
   .option('--output <file>', 'Output file path')
+  .option('--minify', 'Write JSON without indentation')
   .action(async (format: string, opts) => {
     if (opts.root) await ensureIndexed(opts.root);
     ui.header(`Export: ${format}`);
 
     try {
-      const result = await pm.exportAs(format as 'json' | 'html' | 'markdown' | 'csv' | 'graphml');
+      const exportFormat = format as 'json' | 'html' | 'markdown' | 'csv' | 'graphml';
 
       if (opts.output) {
-        const { writeFile } = await import('fs/promises');
-        await writeFile(opts.output, typeof result === 'string' ? result : JSON.stringify(result, null, 2));
+        // Streamed straight to disk; a .gz suffix compresses the output
+        const { createWriteStream } = await import('fs');
+        await pm.exportTo(exportFormat, createWriteStream(opts.output), {
+          gzip: opts.output.endsWith('.gz'),
+          minify: opts.minify === true,
+        });
         ui.success(`Exported to: ${opts.output}`);
       } else {
+        const result = await pm.exportAs(exportFormat);
         console.log(typeof result === 'string' ? result : JSON.stringify(result, null, 2));
       }
     } catch (error) {
@@ -443,6 +450,127 @@ program
     }
   });
 
+// ===== daemon =====
+const DAEMON_ACTIONS = ['start', 'stop', 'status', 'scan', 'diff', 'chunk', 'search'];
+
+program
+  .command('daemon <action> [arg]')
+  .description('Native indexing daemon (start|stop|status|scan|diff|chunk|search)')
+  .option('--root <dir>', 'Project directory the daemon serves', '.')
+  .option('--socket <path>', 'Socket path (default: derived from the root)')
+  .option('--shared-index <name>', 'start: shared segment to publish the file index to (shm:<name> or a path; default: next to the socket)')
+  .option('--calls', 'search: call sites of a function')
+  .option('--callees', 'search: calls made inside a function')
+  .option('--limit <n>', 'Result limit', '20')
+  .action(async (action: string, arg: string | undefined, opts) => {
+    // Checked before connecting, so a typo never spawns a daemon
+    if (!DAEMON_ACTIONS.includes(action)) {
+      ui.error(`Unknown daemon action: ${action}. Use: ${DAEMON_ACTIONS.join('|')}`);
+      process.exit(1);
+    }
+    const rootDir = resolve(opts.root);
+    const limit = parseInt(opts.limit);
+
+    try {
+      if (action === 'stop' || action === 'status') {
+        const client = await connectDaemon(rootDir, opts.socket);
+        if (!client) {
+          ui.info(`No daemon running for ${rootDir}`);
+          return;
+        }
+        if (action === 'stop') {
+          await client.shutdown();
+          ui.success('Daemon stopped');
+        } else {
+          const status = await client.status();
+          ui.header(`Daemon: ${status.root}`);
+          ui.table(['Metric', 'Value'], [
+            ['Files', String(status.files)],
+            ['Generation', String(status.generation)],
+            ['Merkle Root', status.merkleRoot],
+            ['Watching', status.watching ? `yes (${status.watches} dirs)` : 'no (rescans on demand)'],
+            ['Search Index', `${status.identifierFiles} files, ${status.identifiers} identifiers`],
+            ['Chunk Cache', `${status.chunkCacheEntries} entries, ${status.chunkCacheHits} hits, ${status.chunkCacheMisses} misses`],
+            ['Startup', `${status.startupMs} ms`],
+            ['Uptime', `${Math.round(status.uptimeMs / 1000)} s`],
+          ]);
+        }
+        client.close();
+        return;
+      }
+
+      // Queries use whichever daemon serves the root; start also checks that its options match
+      const running = action === 'start' ? null : await connectDaemon(rootDir, opts.socket);
+      const spinner = running ? null : ora(`Starting daemon for ${rootDir}...`).start();
+      const client = running ?? await startDaemon(rootDir, {
+        socketPath: opts.socket,
+        // Published where ProjectManager looks for it (see attachSharedIndex)
+        sharedIndex: opts.sharedIndex ?? defaultSharedIndexPath(rootDir),
+      });
+      spinner?.succeed('Daemon ready');
+
+      switch (action) {
+        case 'start': {
+          const status = await client.status();
+          ui.info(`${status.files} files indexed in ${status.startupMs} ms`);
+          break;
+        }
+        case 'scan': {
+          const scan = await client.scan(arg ?? '');
+          ui.table(['File', 'Language', 'Size'], scan.files.slice(0, limit).map(f => [f.path, f.language, String(f.size)]));
+          ui.info(`${scan.files.length} file(s), generation ${scan.generation}`);
+          break;
+        }
+        case 'diff': {
+          if (!arg) { ui.error('Generation required (see: archicore daemon status)'); process.exit(1); }
+          const diff = await client.diff(Number(arg));
+          if (!diff.complete) {
+            ui.warning('Changes since that generation are no longer logged; rescan instead');
+          } else {
+            ui.table(['Change', 'File'], diff.changes.map(c => [
+              c.kind === 'format_only' ? 'modified (format)' : c.type,
+              c.oldPath ? `${c.oldPath} → ${c.path}` : c.path,
+            ]));
+          }
+          ui.info(`Now at generation ${diff.generation}`);
+          break;
+        }
+        case 'chunk': {
+          if (!arg) { ui.error('File path required'); process.exit(1); }
+          const result = await client.chunk(arg);
+          ui.table(['Lines', 'Type', 'Tokens', 'Scope'], result.chunks.map(c => [
+            `${c.location.lineStart}-${c.location.lineEnd}`, c.type, String(c.tokenCount), c.context.parentName,
+          ]));
+          ui.info(`${result.chunks.length} chunk(s), ${result.totalTokens} tokens`);
+          break;
+        }
+        case 'search': {
+          if (!arg) { ui.error('Identifier required'); process.exit(1); }
+          if (opts.calls || opts.callees) {
+            const result = opts.callees
+              ? await client.callees(arg, { limit })
+              : await client.callSites(arg, { limit });
+            ui.table(['File', 'Line', 'Callee', 'Caller'], result.hits.map(h => [
+              h.file, String(h.line), h.callee, h.caller ?? '',
+            ]));
+            ui.info(`${result.total} call(s)`);
+          } else {
+            const result = await client.occurrences(arg, { limit });
+            ui.table(['File', 'Line', 'Column', 'Role'], result.hits.map(h => [
+              h.file, String(h.line), String(h.column), h.role,
+            ]));
+            ui.info(`${result.total} occurrence(s)`);
+          }
+          break;
+        }
+      }
+      client.close();
+    } catch (error) {
+      ui.error(`Daemon ${action} failed: ${error instanceof Error ? error.message : error}`);
+      process.exit(1);
+    }
+  });
+
 // ===== server =====
 program
   .command('server')
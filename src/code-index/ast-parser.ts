@@ -2,19 +2,148 @@ import Parser from 'tree-sitter';
 import TypeScript from 'tree-sitter-typescript';
 import JavaScript from 'tree-sitter-javascript';
 import Python from 'tree-sitter-python';
+import { createRequire } from 'module';
+import { existsSync, readFileSync } from 'fs';
+import path from 'path';
 import { ASTNode, Location } from '../types/index.js';
 import { FileUtils } from '../utils/file-utils.js';
 import { Logger } from '../utils/logger.js';
+import { AstArena, AstNodeInfo, ParseCache, AST_NODE_STRIDE, AST_NO_NODE, AST_ERROR_BIT } from '../native/chunker.js';
+import { hashString } from '../native/indexer.js';
 
 // Tree-sitter handles large files well. 1MB limit covers even monolithic Vue SFC files
 // like App.vue (420KB script section). Previous 200KB limit forced regex fallback on those.
 const MAX_TREE_SITTER_SIZE = 1000000;
 
+// Node types whose name is taken from the text when there is no 'name' field
+const NAME_FROM_TEXT_TYPES = new Set([
+  // JS/TS
+  'function_declaration',
+  'class_declaration',
+  'interface_declaration',
+  'type_alias_declaration',
+  'variable_declaration',
+  // Python
+  'function_definition',
+  'class_definition',
+  'async_function_definition'
+]);
+
+function nameFromText(text: string): string {
+  const match = text.match(/(?:def|class|function|async\s+def)\s+(\w+)/);
+  if (match) return match[1];
+  return text.split(/[\s({:]/)[1] || 'anonymous';
+}
+
+// Bump when the flattened tree layout or the regex patterns change,
+// so that parse cache entries from older versions are ignored
+const PARSE_FORMAT_VERSION = 1;
+
+// Grammar packages behind each tree-sitter parser; their versions are part of
+// the parse cache fingerprint, so a grammar upgrade invalidates cached trees
+const GRAMMAR_PACKAGES: Record<string, string> = {
+  typescript: 'tree-sitter-typescript',
+  javascript: 'tree-sitter-javascript',
+  python: 'tree-sitter-python',
+};
+
+const require = createRequire(import.meta.url);
+
+/**
+ * Installed version of a package, found by walking up from its entry point
+ * (grammar packages do not always export their package.json)
+ */
+function packageVersion(name: string): string {
+  try {
+    let dir = path.dirname(require.resolve(name));
+    for (;;) {
+      const manifest = path.join(dir, 'package.json');
+      if (existsSync(manifest)) {
+        const pkg = JSON.parse(readFileSync(manifest, 'utf8'));
+        if (pkg.name === name) return String(pkg.version);
+      }
+      const parent = path.dirname(dir);
+      if (parent === dir) break;
+      dir = parent;
+    }
+  } catch {
+    // Not resolvable: fall through
+  }
+  return 'unknown';
+}
+
+/**
+ * Parser and grammar versions used for a language, or '' for regex-only languages
+ */
+function grammarVersion(language: string): string {
+  const grammar = GRAMMAR_PACKAGES[language];
+  if (!grammar) return '';
+  return `tree-sitter@${packageVersion('tree-sitter')}:${grammar}@${packageVersion(grammar)}`;
+}
+
+// Parse cache payload tags
+const PAYLOAD_TREE = 1;
+const PAYLOAD_REGEX = 2;
+
+interface ParseCacheKey {
+  contentHash: string;
+  fingerprint: string;
+}
+
+// Regex fallback symbol: [type, name, startLine, endLine, text]
+type RegexSymbol = [string, string, number, number, string];
+
+/**
+ * Tree payload: tag, kind names as JSON, then the node array 4-byte aligned
+ */
+function encodeTree(kinds: string[], nodes: Uint32Array): Buffer {
+  const kindsJson = Buffer.from(JSON.stringify(kinds), 'utf8');
+  const offset = (5 + kindsJson.length + 3) & ~3;
+  const payload = Buffer.alloc(offset + nodes.byteLength);
+  payload[0] = PAYLOAD_TREE;
+  payload.writeUInt32LE(kindsJson.length, 1);
+  kindsJson.copy(payload, 5);
+  Buffer.from(nodes.buffer, nodes.byteOffset, nodes.byteLength).copy(payload, offset);
+  return payload;
+}
+
+function decodeTree(payload: Buffer): { kinds: string[]; nodes: Uint32Array } {
+  const kindsLength = payload.readUInt32LE(1);
+  const kinds = JSON.parse(payload.toString('utf8', 5, 5 + kindsLength)) as string[];
+  const offset = (5 + kindsLength + 3) & ~3;
+  // Copy: the payload buffer is not guaranteed to be 4-byte aligned
+  const nodes = new Uint32Array((payload.length - offset) >>> 2);
+  new Uint8Array(nodes.buffer).set(payload.subarray(offset, offset + nodes.byteLength));
+  return { kinds, nodes };
+}
+
+/**
+ * Regex payload: tag, then line count and symbols as JSON (paths are not stored,
+ * so a renamed file with the same content still hits)
+ */
+function encodeRegex(lineCount: number, symbols: RegexSymbol[]): Buffer {
+  return Buffer.concat([Buffer.from([PAYLOAD_REGEX]), Buffer.from(JSON.stringify([lineCount, symbols]), 'utf8')]);
+}
+
+function decodeRegex(payload: Buffer): { lineCount: number; symbols: RegexSymbol[] } {
+  const [lineCount, symbols] = JSON.parse(payload.toString('utf8', 1)) as [number, RegexSymbol[]];
+  return { lineCount, symbols };
+}
+
 export class ASTParser {
   private parsers: Map<string, Parser>;
-
-  constructor() {
+  // Tree-sitter trees are kept flat in the arena instead of as ASTNode objects
+  private arena: AstArena | null;
+  private diskFiles = new Set<string>();
+  // Persistent parse results by content hash; trees are only cached with an arena
+  private cache: ParseCache | null;
+  private cacheFingerprints = new Map<string, string>();
+  private cacheHashes = new Set<string>();
+
+  constructor(arena?: AstArena, cache?: ParseCache) {
     this.parsers = new Map();
+    this.arena = arena ?? null;
+    this.cache = cache?.isEnabled() ? cache : null;
     this.initializeParsers();
   }
 
@@ -68,7 +197,7 @@ export class ASTParser {
       }
 
       const tree = parser.parse(processedContent);
-      return this.convertToASTNode(tree.rootNode, virtualPath);
+      return this.toASTNode(tree.rootNode, processedContent, virtualPath);
     } catch {
       // Try regex fallback
       try {
@@ -113,21 +242,30 @@ export class ASTParser {
         return null;
       }
 
+      // Unchanged content: reuse the tree or symbols from a previous run
+      const key = this.cache ? this.cacheKey(content, language) : null;
+      if (key) {
+        const cached = this.loadCached(key, content, filePath);
+        if (cached) return cached;
+      }
+
       // For large files, use regex-based fallback
       if (content.length > MAX_TREE_SITTER_SIZE) {
         Logger.debug(`Large file (${content.length} bytes), using regex fallback: ${filePath}`);
-        return this.parseWithRegex(content, filePath, language);
+        return this.parseWithRegex(content, filePath, language, key);
       }
 
       const parser = this.parsers.get(language);
 
       if (!parser) {
         // Use regex fallback for unsupported languages
-        return this.parseWithRegex(content, filePath, language);
+        return this.parseWithRegex(content, filePath, language, key);
       }
 
       const tree = parser.parse(content);
-      return this.convertToASTNode(tree.rootNode, filePath);
+      const ast = this.toASTNode(tree.rootNode, content, filePath, key);
+      if (this.arena) this.diskFiles.add(filePath);
+      return ast;
     } catch (error) {
       // Try regex fallback on parse error
       try {
@@ -142,9 +280,46 @@ export class ASTParser {
     }
   }
 
+  private cacheKey(content: string, language: string): ParseCacheKey {
+    let fingerprint = this.cacheFingerprints.get(language);
+    if (fingerprint === undefined) {
+      fingerprint = hashString(
+        `${PARSE_FORMAT_VERSION}:${MAX_TREE_SITTER_SIZE}:${language}:${grammarVersion(language)}`
+      );
+      this.cacheFingerprints.set(language, fingerprint);
+    }
+    const contentHash = hashString(content);
+    this.cacheHashes.add(contentHash);
+    return { contentHash, fingerprint };
+  }
+
+  /**
+   * Restore a cached parse result, or null when absent or unusable
+   */
+  private loadCached(key: ParseCacheKey, content: string, filePath: string): ASTNode | null {
+    const payload = this.cache!.get(key.contentHash, key.fingerprint);
+    if (!payload || payload.length === 0) return null;
+
+    try {
+      if (payload[0] === PAYLOAD_TREE && this.arena) {
+        const { kinds, nodes } = decodeTree(payload);
+        this.arena.setFile(filePath, content, kinds, nodes);
+        this.diskFiles.add(filePath);
+        return new ArenaASTNode(this.arena, filePath, this.arena.node(filePath, 0)!);
+      }
+      if (payload[0] === PAYLOAD_REGEX) {
+        const { lineCount, symbols } = decodeRegex(payload);
+        return this.buildRegexAST(filePath, lineCount, symbols);
+      }
+    } catch (error) {
+      Logger.debug(`Ignoring unreadable parse cache entry for ${filePath}: ${error}`);
+    }
+    return null;
+  }
+
   // Regex-based fallback for large files or unsupported languages
-  private parseWithRegex(content: string, filePath: string, language: string): ASTNode {
-    const children: ASTNode[] = [];
+  private parseWithRegex(content: string, filePath: string, language: string, key?: ParseCacheKey | null): ASTNode {
+    const symbols: RegexSymbol[] = [];
     const lines = content.split('\n');
 
     // Patterns for different languages
@@ -454,32 +629,41 @@ export class ASTParser {
             }
           }
 
-          children.push({
-            id: `${filePath}:${name}:${index}`,
-            type,
-            name,
-            filePath,
-            startLine: index,
-            endLine: endLineIndex,
-            children: [],
-            metadata: {
-              text: codeContext.substring(0, 2000), // Увеличено с 200 до 2000
-              hasErrors: false,
-              regexParsed: true
-            }
-          });
+          symbols.push([type, name, index, endLineIndex, codeContext.substring(0, 2000)]); // Увеличено с 200 до 2000
           break; // One match per line
         }
       }
     });
 
+    if (key) {
+      this.cache!.put(key.contentHash, key.fingerprint, encodeRegex(lines.length, symbols));
+    }
+    return this.buildRegexAST(filePath, lines.length, symbols);
+  }
+
+  private buildRegexAST(filePath: string, lineCount: number, symbols: RegexSymbol[]): ASTNode {
+    const children: ASTNode[] = symbols.map(([type, name, startLine, endLine, text]) => ({
+      id: `${filePath}:${name}:${startLine}`,
+      type,
+      name,
+      filePath,
+      startLine,
+      endLine,
+      children: [],
+      metadata: {
+        text,
+        hasErrors: false,
+        regexParsed: true
+      }
+    }));
+
     return {
       id: `${filePath}:0:0`,
       type: 'program',
       name: filePath.split(/[/\\]/).pop() || '',
       filePath,
       startLine: 0,
-      endLine: lines.length,
+      endLine: lineCount,
       children,
       metadata: {
         text: `File: ${filePath}`,
@@ -568,10 +752,121 @@ export class ASTParser {
       }
     }
 
+    // Trees of files that are gone or no longer parse with tree-sitter
+    if (this.arena) {
+      for (const file of this.diskFiles) {
+        if (!(asts.get(file) instanceof ArenaASTNode)) {
+          this.arena.removeFile(file);
+          this.diskFiles.delete(file);
+        }
+      }
+    }
+
+    if (this.cache) {
+      // Rewrite the store once most of it belongs to content that is gone
+      const { entries, hits } = this.cache.stats();
+      if (entries > this.cacheHashes.size * 2) {
+        const dropped = this.cache.compact(Array.from(this.cacheHashes));
+        Logger.debug(`Parse cache: dropped ${dropped} stale entries`);
+      }
+      this.cache.flush();
+      Logger.debug(`Parse cache: ${hits} hits of ${this.cacheHashes.size} files`);
+      this.cacheHashes.clear();
+    }
+
     Logger.success(`Parsed ${asts.size} files successfully`);
     return asts;
   }
 
+  private toASTNode(root: Parser.SyntaxNode, content: string, filePath: string, key?: ParseCacheKey | null): ASTNode {
+    return this.arena ? this.storeInArena(root, content, filePath, key) : this.convertToASTNode(root, filePath);
+  }
+
+  /**
+   * Flatten a tree into the arena in preorder with a cursor, so no JS
+   * object is created per node; returns a lazy view of the root
+   */
+  private storeInArena(root: Parser.SyntaxNode, content: string, filePath: string, key?: ParseCacheKey | null): ASTNode {
+    const arena = this.arena!;
+    const kinds: string[] = [];
+    const kindIds = new Map<string, number>();
+    let nodes = new Uint32Array(1024 * AST_NODE_STRIDE);
+    let count = 0;
+    const open: number[] = [];
+
+    const cursor = root.walk();
+    for (;;) {
+      const type = cursor.nodeType;
+      let kind = kindIds.get(type);
+      if (kind === undefined) {
+        kind = kinds.length;
+        kinds.push(type);
+        kindIds.set(type, kind);
+      }
+      if ((count + 1) * AST_NODE_STRIDE > nodes.length) {
+        const grown = new Uint32Array(nodes.length * 2);
+        grown.set(nodes);
+        nodes = grown;
+      }
+
+      const id = count++;
+      const base = id * AST_NODE_STRIDE;
+      const parent = open.length > 0 ? open[open.length - 1] : AST_NO_NODE;
+      const start = cursor.startPosition;
+      const end = cursor.endPosition;
+      nodes[base] = type === 'ERROR' || cursor.nodeIsMissing ? (kind | AST_ERROR_BIT) >>> 0 : kind;
+      nodes[base + 1] = parent;
+      nodes[base + 2] = cursor.startIndex;
+      nodes[base + 3] = cursor.endIndex;
+      nodes[base + 4] = start.row;
+      nodes[base + 5] = start.column;
+      nodes[base + 6] = end.row;
+      nodes[base + 7] = end.column;
+      nodes[base + 8] = AST_NO_NODE;
+      // First 'name' field child, as childForFieldName('name')
+      if (parent !== AST_NO_NODE && nodes[parent * AST_NODE_STRIDE + 8] === AST_NO_NODE &&
+          cursor.currentFieldName === 'name') {
+        nodes[parent * AST_NODE_STRIDE + 8] = id;
+      }
+
+      if (cursor.gotoFirstChild()) {
+        open.push(id);
+        continue;
+      }
+      let done = false;
+      while (!cursor.gotoNextSibling()) {
+        if (!cursor.gotoParent()) {
+          done = true;
+          break;
+        }
+        open.pop();
+      }
+      if (done) break;
+    }
+
+    // Python: decorated_definition is named after the wrapped definition
+    const decorated = kindIds.get('decorated_definition');
+    if (decorated !== undefined) {
+      const wrapped = new Set([kindIds.get('function_definition'), kindIds.get('class_definition')]);
+      for (let i = 1; i < count; i++) {
+        const base = i * AST_NODE_STRIDE;
+        const parentBase = nodes[base + 1] * AST_NODE_STRIDE;
+        if (((nodes[parentBase] & ~AST_ERROR_BIT) >>> 0) === decorated &&
+            nodes[parentBase + 8] === AST_NO_NODE &&
+            wrapped.has((nodes[base] & ~AST_ERROR_BIT) >>> 0)) {
+          nodes[parentBase + 8] = nodes[base + 8];
+        }
+      }
+    }
+
+    const flat = nodes.subarray(0, count * AST_NODE_STRIDE);
+    arena.setFile(filePath, content, kinds, flat);
+    if (key) {
+      this.cache!.put(key.contentHash, key.fingerprint, encodeTree(kinds, flat));
+    }
+    return new ArenaASTNode(arena, filePath, arena.node(filePath, 0)!);
+  }
+
   private convertToASTNode(node: Parser.SyntaxNode, filePath: string): ASTNode {
     const children: ASTNode[] = [];
 
@@ -615,24 +910,8 @@ export class ASTParser {
       }
     }
 
-    const interestingTypes = [
-      // JS/TS
-      'function_declaration',
-      'class_declaration',
-      'interface_declaration',
-      'type_alias_declaration',
-      'variable_declaration',
-      // Python
-      'function_definition',
-      'class_definition',
-      'async_function_definition'
-    ];
-
-    if (interestingTypes.includes(node.type)) {
-      // Try to extract name from text
-      const match = node.text.match(/(?:def|class|function|async\s+def)\s+(\w+)/);
-      if (match) return match[1];
-      return node.text.split(/[\s({:]/)[1] || 'anonymous';
+    if (NAME_FROM_TEXT_TYPES.has(node.type)) {
+      return nameFromText(node.text);
     }
 
     return '';
@@ -648,3 +927,68 @@ export class ASTParser {
     };
   }
 }
+
+/**
+ * ASTNode view of a node stored in an AstArena
+ * Children and metadata are resolved on access and not retained, so a
+ * tree only occupies memory while it is being walked. find() answers
+ * kind queries over the subtree without building views for the rest.
+ */
+export class ArenaASTNode implements ASTNode {
+  readonly id: string;
+  readonly type: string;
+  readonly name: string;
+  readonly filePath: string;
+  readonly startLine: number;
+  readonly endLine: number;
+  private arena: AstArena;
+  private info: AstNodeInfo;
+
+  constructor(arena: AstArena, filePath: string, info: AstNodeInfo) {
+    this.arena = arena;
+    this.info = info;
+    this.id = `${filePath}:${info.startLine}:${info.startColumn}`;
+    this.type = info.type;
+    this.filePath = filePath;
+    this.startLine = info.startLine;
+    this.endLine = info.endLine;
+    this.name = info.name || (NAME_FROM_TEXT_TYPES.has(info.type)
+      ? nameFromText(arena.text(filePath, info.id))
+      : '');
+  }
+
+  /** Index of the node in its file's arena tree */
+  get nodeId(): number {
+    return this.info.id;
+  }
+
+  get children(): ASTNode[] {
+    return Array.from(this.arena.children(this.filePath, this.info.id), id => this.view(id));
+  }
+
+  get metadata(): Record<string, unknown> {
+    const text = this.arena.text(this.filePath, this.info.id, 201);
+    return {
+      text: text.length > 200 ? text.substring(0, 200) + '...' : text,
+      hasErrors: this.info.hasError
+    };
+  }
+
+  /**
+   * Nodes of the given types in this subtree (including this node), in preorder
+   */
+  find(types: string[], firstOnly = false): ArenaASTNode[] {
+    return Array.from(this.arena.find(this.filePath, types, this.info.id, firstOnly), id => this.view(id));
+  }
+
+  /**
+   * Full source text of the node
+   */
+  text(): string {
+    return this.arena.text(this.filePath, this.info.id);
+  }
+
+  private view(id: number): ArenaASTNode {
+    return new ArenaASTNode(this.arena, this.filePath, this.arena.node(this.filePath, id)!);
+  }
+}
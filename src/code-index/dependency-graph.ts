@@ -7,6 +7,7 @@ import {
   ASTNode
 } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { ArenaASTNode } from './ast-parser.js';
 import { readFileSync, existsSync } from 'fs';
 import path from 'path';
 
@@ -30,7 +31,8 @@ export class DependencyGraphBuilder {
 
     const graph: DependencyGraph = {
       nodes: new Map(),
-      edges: new Map()
+      edges: new Map(),
+      version: 0
     };
 
     this.buildNodes(symbols, asts, graph);
@@ -243,6 +245,7 @@ export class DependencyGraphBuilder {
         }
       };
       graph.nodes.set(filePath, fileNode);
+      graph.version = (graph.version ?? 0) + 1;
     }
 
     for (const symbol of symbols.values()) {
@@ -254,6 +257,7 @@ export class DependencyGraphBuilder {
         metadata: {}
       };
       graph.nodes.set(symbol.id, node);
+      graph.version = (graph.version ?? 0) + 1;
     }
   }
 
@@ -474,6 +478,17 @@ export class DependencyGraphBuilder {
     // Tree-sitter node types for imports
     const importTypes = ['import_statement', 'import_declaration', 'import_from_statement'];
 
+    // Дерево в арене: поиск по типу без обхода всех узлов
+    if (node instanceof ArenaASTNode) {
+      for (const importNode of node.find(importTypes)) {
+        const importPath = this.extractImportPath(importNode);
+        if (importPath) {
+          imports.push(importPath);
+        }
+      }
+      return imports;
+    }
+
     if (importTypes.includes(node.type)) {
       const importPath = this.extractImportPath(node);
       if (importPath) {
@@ -617,6 +632,7 @@ export class DependencyGraphBuilder {
       graph.edges.set(edge.from, []);
     }
     graph.edges.get(edge.from)!.push(edge);
+    graph.version = (graph.version ?? 0) + 1;
   }
 
   private findSymbolsBySource(
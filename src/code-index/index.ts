@@ -14,9 +14,20 @@ import { DependencyGraphBuilder } from './dependency-graph.js';
 import { SourceMapExtractor, VirtualFile, ExtractionResult } from './source-map-extractor.js';
 import { DependencyGraph, Symbol, ASTNode } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { AstArena, ParseCache } from '../native/chunker.js';
+import { mkdirSync } from 'fs';
+import path from 'path';
+
+export interface CodeIndexOptions {
+  /** Файл постоянного кэша разбора; без него каждый запуск разбирает все файлы */
+  parseCachePath?: string;
+}
 
 export class CodeIndex {
   private astParser: ASTParser;
+  // Плоское хранилище деревьев; asts содержит только ленивые представления узлов
+  private astArena: AstArena;
+  private parseCache: ParseCache | null = null;
   private symbolExtractor: SymbolExtractor;
   private graphBuilder: DependencyGraphBuilder;
   private sourceMapExtractor: SourceMapExtractor;
@@ -27,9 +38,18 @@ export class CodeIndex {
   private graph: DependencyGraph | null = null;
   private virtualFiles: VirtualFile[] = [];
 
-  constructor(rootDir?: string) {
+  constructor(rootDir?: string, options: CodeIndexOptions = {}) {
     this.rootDir = rootDir || process.cwd();
-    this.astParser = new ASTParser();
+    this.astArena = new AstArena();
+    if (options.parseCachePath) {
+      try {
+        mkdirSync(path.dirname(options.parseCachePath), { recursive: true });
+        this.parseCache = new ParseCache({ path: options.parseCachePath });
+      } catch (error) {
+        Logger.warn(`Parse cache disabled: ${error}`);
+      }
+    }
+    this.astParser = new ASTParser(this.astArena, this.parseCache ?? undefined);
     this.symbolExtractor = new SymbolExtractor();
     this.graphBuilder = new DependencyGraphBuilder();
     this.sourceMapExtractor = new SourceMapExtractor();
@@ -131,6 +151,14 @@ export class CodeIndex {
     return this.asts;
   }
 
+  getASTArena(): AstArena {
+    return this.astArena;
+  }
+
+  getParseCache(): ParseCache | null {
+    return this.parseCache;
+  }
+
   findSymbol(name: string): Symbol | null {
     for (const symbol of this.symbols.values()) {
       if (symbol.name === name) {
@@ -1,5 +1,8 @@
 import { ASTNode, Symbol, SymbolKind, Reference, Import } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { ArenaASTNode } from './ast-parser.js';
+import { FileUtils } from '../utils/file-utils.js';
+import { buildSymbolTable, isNativeAvailable, SymbolTable, ChunkType } from '../native/chunker.js';
 
 export class SymbolExtractor {
   // Минимальная длина имени символа (фильтрует шум)
@@ -22,17 +25,48 @@ export class SymbolExtractor {
     'abstract', 'final', 'async', 'await', 'yield', 'with', 'debugger'
   ]);
 
+  // Языки, для которых нативные детекторы находят функции и типы точнее regex-фоллбэка.
+  // Java и C/C++ сюда не входят: их детекторы не сообщают о методах и свободных функциях
+  private static TABLE_LANGUAGES = new Set(['go', 'rust', 'python']);
+
   extractSymbols(asts: Map<string, ASTNode>): Map<string, Symbol> {
     const symbols = new Map<string, Symbol>();
     const symbolsPerFile = new Map<string, number>();
+    const tableFiles: string[] = [];
 
     Logger.progress('Extracting symbols from AST...');
 
     for (const [filePath, ast] of asts) {
       symbolsPerFile.set(filePath, 0);
+      if (ast instanceof ArenaASTNode) {
+        // Только узлы-символы, в том же порядке (preorder), что и рекурсивный обход
+        for (const node of ast.find(SymbolExtractor.SYMBOL_NODE_TYPES)) {
+          if (!this.addSymbol(node, filePath, symbols, symbolsPerFile)) break;
+        }
+        continue;
+      }
+      if (this.useSymbolTable(ast, filePath)) {
+        tableFiles.push(filePath);
+        continue;
+      }
       this.extractFromNode(ast, filePath, symbols, symbolsPerFile);
     }
 
+    // Файлы без дерева tree-sitter: символы за один параллельный нативный проход
+    if (tableFiles.length > 0) {
+      const table = buildSymbolTable(tableFiles);
+      const failed = new Set(table.columns.errors.map(e => e.filepath));
+      for (let f = 0; f < tableFiles.length; f++) {
+        const filePath = tableFiles[f];
+        if (failed.has(filePath)) {
+          // Например, виртуальные файлы из source maps: их нет на диске
+          this.extractFromNode(asts.get(filePath)!, filePath, symbols, symbolsPerFile);
+        } else {
+          this.addTableSymbols(table, f, symbols, symbolsPerFile);
+        }
+      }
+    }
+
     // Статистика по типам символов
     const kindCounts: Record<string, number> = {};
     for (const sym of symbols.values()) {
@@ -47,6 +81,66 @@ export class SymbolExtractor {
     return symbols;
   }
 
+  private useSymbolTable(ast: ASTNode, filePath: string): boolean {
+    return ast.metadata.regexParsed === true &&
+      SymbolExtractor.TABLE_LANGUAGES.has(FileUtils.getLanguageFromExtension(filePath)) &&
+      isNativeAvailable();
+  }
+
+  /**
+   * Добавляет символы одного файла из нативной таблицы (с теми же фильтрами и лимитом)
+   */
+  private addTableSymbols(
+    table: SymbolTable,
+    fileIndex: number,
+    symbols: Map<string, Symbol>,
+    symbolsPerFile: Map<string, number>
+  ): void {
+    const filePath = table.files[fileIndex];
+    const { lineStart, lineEnd } = table.columns;
+    const [start, end] = table.rows(fileIndex);
+    let count = symbolsPerFile.get(filePath) || 0;
+
+    for (let row = start; row < end && count < SymbolExtractor.MAX_SYMBOLS_PER_FILE; row++) {
+      const chunkType = table.kind(row);
+      const kind = SymbolExtractor.TABLE_KINDS[chunkType];
+      // Go: package — не объявление
+      if (!kind || (chunkType === 'module' && table.columns.languages[fileIndex] === 'go')) continue;
+      const name = table.name(row);
+      if (!this.isValidSymbolName(name)) continue;
+
+      const startLine = lineStart[row] - 1;
+      const symbol: Symbol = {
+        id: `${filePath}:${name}:${startLine}`,
+        name,
+        kind,
+        filePath,
+        location: {
+          filePath,
+          startLine,
+          endLine: lineEnd[row] - 1,
+          startColumn: 0,
+          endColumn: 0
+        },
+        references: [],
+        exports: table.isExported(row),
+        imports: []
+      };
+      symbols.set(symbol.id, symbol);
+      count++;
+    }
+    symbolsPerFile.set(filePath, count);
+  }
+
+  private static TABLE_KINDS: Partial<Record<ChunkType, SymbolKind>> = {
+    'function': SymbolKind.Function,
+    'class': SymbolKind.Class,
+    'struct': SymbolKind.Class,
+    'interface': SymbolKind.Interface,
+    'enum': SymbolKind.Type,
+    'module': SymbolKind.Namespace
+  };
+
   private isValidSymbolName(name: string): boolean {
     // Фильтруем короткие имена
     if (name.length < SymbolExtractor.MIN_SYMBOL_NAME_LENGTH) return false;
@@ -69,12 +163,30 @@ export class SymbolExtractor {
     symbols: Map<string, Symbol>,
     symbolsPerFile: Map<string, number>
   ): void {
+    if (!this.addSymbol(node, filePath, symbols, symbolsPerFile)) {
+      return; // Достигнут лимит для этого файла
+    }
+
+    for (const child of node.children) {
+      this.extractFromNode(child, filePath, symbols, symbolsPerFile);
+    }
+  }
+
+  /**
+   * Добавляет символ для узла; false, если достигнут лимит файла
+   */
+  private addSymbol(
+    node: ASTNode,
+    filePath: string,
+    symbols: Map<string, Symbol>,
+    symbolsPerFile: Map<string, number>
+  ): boolean {
     const symbolKind = this.getSymbolKind(node.type);
 
     // Проверяем лимит на файл
     const currentCount = symbolsPerFile.get(filePath) || 0;
     if (currentCount >= SymbolExtractor.MAX_SYMBOLS_PER_FILE) {
-      return; // Достигнут лимит для этого файла
+      return false;
     }
 
     if (symbolKind && node.name && this.isValidSymbolName(node.name)) {
@@ -97,70 +209,79 @@ export class SymbolExtractor {
       symbols.set(symbol.id, symbol);
       symbolsPerFile.set(filePath, currentCount + 1);
     }
-
-    for (const child of node.children) {
-      this.extractFromNode(child, filePath, symbols, symbolsPerFile);
-    }
+    return true;
   }
 
   private getSymbolKind(nodeType: string): SymbolKind | null {
-    const mapping: Record<string, SymbolKind> = {
-      // JavaScript/TypeScript
-      'function_declaration': SymbolKind.Function,
-      'method_definition': SymbolKind.Function,
-      'arrow_function': SymbolKind.Function,
-      'class_declaration': SymbolKind.Class,
-      'interface_declaration': SymbolKind.Interface,
-      'type_alias_declaration': SymbolKind.Type,
-      'variable_declaration': SymbolKind.Variable,
-      'const_declaration': SymbolKind.Constant,
-      'lexical_declaration': SymbolKind.Variable,
-      // Python
-      'function_definition': SymbolKind.Function,
-      'class_definition': SymbolKind.Class,
-      'decorated_definition': SymbolKind.Function,
-      'async_function_definition': SymbolKind.Function,
-      // Go
-      'method_declaration': SymbolKind.Function,
-      'type_declaration': SymbolKind.Type,
-      // Rust
-      'function_item': SymbolKind.Function,
-      'impl_item': SymbolKind.Class,
-      'struct_item': SymbolKind.Class,
-      'enum_item': SymbolKind.Type,
-      'trait_item': SymbolKind.Interface,
-      // PHP and general
-      'namespace_definition': SymbolKind.Namespace,
-      'namespace_use_declaration': SymbolKind.Variable,
-      'trait_declaration': SymbolKind.Interface,
-      'property_declaration': SymbolKind.Variable,
-      'enum_declaration': SymbolKind.Type,
-      'enum_declaration_list': SymbolKind.Type,
-      'module_declaration': SymbolKind.Namespace,  // For regex-parsed namespaces
-      'struct_declaration': SymbolKind.Class,       // For regex-parsed structs
-      'impl_declaration': SymbolKind.Class,         // For regex-parsed impl blocks
-      // Java
-      'constructor_declaration': SymbolKind.Function,
-      'field_declaration': SymbolKind.Variable,
-      'annotation_type_declaration': SymbolKind.Interface,
-      // C/C++
-      'struct_specifier': SymbolKind.Class,
-      'union_specifier': SymbolKind.Class,
-      'enum_specifier': SymbolKind.Type,
-      'preproc_function_def': SymbolKind.Function,
-      // Ruby
-      'method': SymbolKind.Function,
-      'singleton_method': SymbolKind.Function,
-      'module': SymbolKind.Namespace,
-      'class': SymbolKind.Class
-    };
-
-    return mapping[nodeType] || null;
+    return SymbolExtractor.SYMBOL_KINDS[nodeType] || null;
   }
 
+  private static SYMBOL_KINDS: Record<string, SymbolKind> = {
+    // JavaScript/TypeScript
+    'function_declaration': SymbolKind.Function,
+    'method_definition': SymbolKind.Function,
+    'arrow_function': SymbolKind.Function,
+    'class_declaration': SymbolKind.Class,
+    'interface_declaration': SymbolKind.Interface,
+    'type_alias_declaration': SymbolKind.Type,
+    'variable_declaration': SymbolKind.Variable,
+    'const_declaration': SymbolKind.Constant,
+    'lexical_declaration': SymbolKind.Variable,
+    // Python
+    'function_definition': SymbolKind.Function,
+    'class_definition': SymbolKind.Class,
+    'decorated_definition': SymbolKind.Function,
+    'async_function_definition': SymbolKind.Function,
+    // Go
+    'method_declaration': SymbolKind.Function,
+    'type_declaration': SymbolKind.Type,
+    // Rust
+    'function_item': SymbolKind.Function,
+    'impl_item': SymbolKind.Class,
+    'struct_item': SymbolKind.Class,
+    'enum_item': SymbolKind.Type,
+    'trait_item': SymbolKind.Interface,
+    // PHP and general
+    'namespace_definition': SymbolKind.Namespace,
+    'namespace_use_declaration': SymbolKind.Variable,
+    'trait_declaration': SymbolKind.Interface,
+    'property_declaration': SymbolKind.Variable,
+    'enum_declaration': SymbolKind.Type,
+    'enum_declaration_list': SymbolKind.Type,
+    'module_declaration': SymbolKind.Namespace,  // For regex-parsed namespaces
+    'struct_declaration': SymbolKind.Class,       // For regex-parsed structs
+    'impl_declaration': SymbolKind.Class,         // For regex-parsed impl blocks
+    // Java
+    'constructor_declaration': SymbolKind.Function,
+    'field_declaration': SymbolKind.Variable,
+    'annotation_type_declaration': SymbolKind.Interface,
+    // C/C++
+    'struct_specifier': SymbolKind.Class,
+    'union_specifier': SymbolKind.Class,
+    'enum_specifier': SymbolKind.Type,
+    'preproc_function_def': SymbolKind.Function,
+    // Ruby
+    'method': SymbolKind.Function,
+    'singleton_method': SymbolKind.Function,
+    'module': SymbolKind.Namespace,
+    'class': SymbolKind.Class
+  };
+
+  private static SYMBOL_NODE_TYPES = Object.keys(SymbolExtractor.SYMBOL_KINDS);
+
   private extractImports(node: ASTNode): Import[] {
     const imports: Import[] = [];
 
+    if (node instanceof ArenaASTNode) {
+      for (const importNode of node.find(['import_statement', 'import_declaration'])) {
+        const parsed = this.parseImportNode(importNode);
+        if (parsed) {
+          imports.push(parsed);
+        }
+      }
+      return imports;
+    }
+
     if (node.type === 'import_statement' || node.type === 'import_declaration') {
       const importNode = this.parseImportNode(node);
       if (importNode) {
@@ -240,6 +361,12 @@ export class SymbolExtractor {
     Logger.progress('Building reference graph...');
 
     for (const [filePath, ast] of asts) {
+      if (ast instanceof ArenaASTNode) {
+        for (const identifier of ast.find(['identifier'])) {
+          this.addReferences(identifier, symbols, filePath);
+        }
+        continue;
+      }
       this.findReferences(ast, symbols, filePath);
     }
 
@@ -251,7 +378,21 @@ export class SymbolExtractor {
     symbols: Map<string, Symbol>,
     currentFile: string
   ): void {
-    if (node.type === 'identifier' && node.name) {
+    if (node.type === 'identifier') {
+      this.addReferences(node, symbols, currentFile);
+    }
+
+    for (const child of node.children) {
+      this.findReferences(child, symbols, currentFile);
+    }
+  }
+
+  private addReferences(
+    node: ASTNode,
+    symbols: Map<string, Symbol>,
+    currentFile: string
+  ): void {
+    if (node.name) {
       for (const symbol of symbols.values()) {
         if (symbol.name === node.name) {
           const ref: Reference = {
@@ -268,10 +409,6 @@ export class SymbolExtractor {
         }
       }
     }
-
-    for (const child of node.children) {
-      this.findReferences(child, symbols, currentFile);
-    }
   }
 
   private inferReferenceKind(node: ASTNode): 'read' | 'write' | 'call' | 'type' {
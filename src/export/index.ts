@@ -10,13 +10,24 @@
  * - GraphML (граф зависимостей)
  */
 
-import { DependencyGraph, Symbol } from '../types/index.js';
+import { DependencyGraph, GraphNode, GraphEdge, EdgeType, Symbol } from '../types/index.js';
 import { ProjectMetrics } from '../metrics/index.js';
 import { RulesCheckResult } from '../rules-engine/index.js';
 import { DeadCodeResult } from '../analyzers/dead-code.js';
 import { DuplicationResult } from '../analyzers/duplication.js';
 import { SecurityResult } from '../analyzers/security.js';
 import { Logger } from '../utils/logger.js';
+import {
+  GraphExporter,
+  readExport,
+  isNativeAvailable as isGraphNativeAvailable,
+  type ExportReadResult,
+  type ImportedGraphTables
+} from '../native/graph.js';
+import { readFile } from 'fs/promises';
+import { Readable, Transform, type Writable } from 'stream';
+import { pipeline } from 'stream/promises';
+import { createGzip } from 'zlib';
 
 export interface ExportData {
   projectName: string;
@@ -41,6 +52,17 @@ export interface ExportOptions {
   includeDuplication?: boolean;
   includeSecurity?: boolean;
   language?: 'en' | 'ru';
+  /** Таблица CSV: метрики файлов (по умолчанию) или список рёбер графа */
+  csvTable?: 'metrics' | 'edges';
+}
+
+export interface StreamExportOptions {
+  /** Сжимать вывод gzip */
+  gzip?: boolean;
+  /** Примерный размер порции вывода в байтах (по умолчанию 64 КБ) */
+  chunkSize?: number;
+  /** JSON без отступов (по умолчанию — с отступом 2, как exportJSON) */
+  minify?: boolean;
 }
 
 export interface ImportResult {
@@ -49,6 +71,21 @@ export interface ImportResult {
   errors?: string[];
 }
 
+/**
+ * Ключ JSON-объекта на уровне вложенности depth (как у JSON.stringify(value, null, 2))
+ */
+function jsonField(key: string, depth: number, minify: boolean): string {
+  return minify ? `${JSON.stringify(key)}:` : `\n${'  '.repeat(depth)}${JSON.stringify(key)}: `;
+}
+
+/**
+ * Значение JSON, вложенное на уровень depth
+ */
+function jsonValue(value: unknown, depth: number, minify: boolean): string {
+  if (minify) return JSON.stringify(value);
+  return JSON.stringify(value, null, 2).replace(/\n/g, `\n${'  '.repeat(depth)}`);
+}
+
 const translations = {
   en: {
     reportTitle: 'Architecture Analysis Report',
@@ -139,6 +176,16 @@ export class ExportManager {
   async export(data: ExportData, options: ExportOptions): Promise<string> {
     Logger.progress(`Exporting to ${options.format}...`);
 
+    const result = this.render(data, options);
+
+    Logger.success(`Export completed (${result.length} bytes)`);
+    return result;
+  }
+
+  /**
+   * Построение документа целиком
+   */
+  private render(data: ExportData, options: ExportOptions): string {
     let result: string;
 
     switch (options.format) {
@@ -152,7 +199,7 @@ export class ExportManager {
         result = this.exportMarkdown(data, options);
         break;
       case 'csv':
-        result = this.exportCSV(data);
+        result = options.csvTable === 'edges' ? this.exportEdgesCSV(data) : this.exportCSV(data);
         break;
       case 'graphml':
         result = this.exportGraphML(data);
@@ -161,18 +208,195 @@ export class ExportManager {
         throw new Error(`Unsupported export format: ${options.format}`);
     }
 
-    Logger.success(`Export completed (${result.length} bytes)`);
     return result;
   }
 
+  /**
+   * Потоковый экспорт: документ пишется в output порциями и не собирается
+   * в одну строку. Граф сериализуется GraphExporter (нативно, если доступен),
+   * символы — по одному. Возвращает число байт до сжатия.
+   */
+  async exportToStream(
+    data: ExportData,
+    options: ExportOptions,
+    output: Writable,
+    streamOptions: StreamExportOptions = {}
+  ): Promise<number> {
+    Logger.progress(`Streaming export to ${options.format}...`);
+
+    let bytes = 0;
+    const source = Readable.from(this.exportChunks(data, options, streamOptions));
+    const counter = new Transform({
+      transform(chunk: Buffer, _encoding, callback) {
+        bytes += chunk.length;
+        callback(null, chunk);
+      }
+    });
+
+    if (streamOptions.gzip) {
+      await pipeline(source, counter, createGzip(), output);
+    } else {
+      await pipeline(source, counter, output);
+    }
+
+    Logger.success(`Export completed (${bytes} bytes)`);
+    return bytes;
+  }
+
+  /**
+   * Порции документа для потокового экспорта
+   */
+  private *exportChunks(
+    data: ExportData,
+    options: ExportOptions,
+    streamOptions: StreamExportOptions
+  ): Generator<string | Buffer> {
+    const chunkSize = streamOptions.chunkSize ?? 64 * 1024;
+    switch (options.format) {
+      case 'json':
+        yield* this.jsonChunks(data, options, chunkSize, streamOptions.minify ?? false);
+        return;
+      case 'graphml':
+        if (!data.graph) {
+          yield this.exportGraphML(data);
+          return;
+        }
+        yield* GraphExporter.fromGraph(data.graph).chunks('graphml', chunkSize);
+        return;
+      case 'csv':
+        if (options.csvTable === 'edges') {
+          if (data.graph) yield* GraphExporter.fromGraph(data.graph).chunks('csv', chunkSize);
+          return;
+        }
+        yield* this.batched(this.csvRows(data), chunkSize);
+        return;
+      default:
+        // HTML и Markdown содержат только сводки — их размер ограничен
+        yield this.render(data, options);
+    }
+  }
+
+  /**
+   * JSON порциями: заголовок, граф и символы пишутся по записям.
+   * По умолчанию с теми же отступами, что и exportJSON; в сжатом виде
+   * граф сериализует GraphExporter (нативно, если доступен).
+   */
+  private *jsonChunks(
+    data: ExportData,
+    options: ExportOptions,
+    chunkSize: number,
+    minify: boolean
+  ): Generator<string | Buffer> {
+    yield `{${jsonField('projectName', 1, minify)}${jsonValue(data.projectName, 1, minify)},` +
+      `${jsonField('exportDate', 1, minify)}${jsonValue(data.exportDate, 1, minify)},` +
+      `${jsonField('version', 1, minify)}${jsonValue(this.version, 1, minify)}`;
+
+    if (options.includeGraph && data.graph) {
+      yield `,${jsonField('graph', 1, minify)}`;
+      if (minify) {
+        yield* GraphExporter.fromGraph(data.graph).chunks('json', chunkSize);
+      } else {
+        yield `{${jsonField('nodes', 2, minify)}`;
+        yield* this.jsonEntries(data.graph.nodes, 2, chunkSize, minify);
+        yield `,${jsonField('edges', 2, minify)}`;
+        yield* this.jsonEntries(data.graph.edges, 2, chunkSize, minify);
+        yield '\n  }';
+      }
+    }
+
+    if (options.includeSymbols && data.symbols) {
+      yield `,${jsonField('symbols', 1, minify)}`;
+      yield* this.jsonEntries(data.symbols, 1, chunkSize, minify);
+    }
+
+    const sections: Array<[string, boolean | undefined, unknown]> = [
+      ['metrics', options.includeMetrics, data.metrics],
+      ['rules', options.includeRules, data.rules],
+      ['deadCode', options.includeDeadCode, data.deadCode],
+      ['duplication', options.includeDuplication, data.duplication],
+      ['security', options.includeSecurity, data.security]
+    ];
+    for (const [key, include, value] of sections) {
+      if (include && value) yield `,${jsonField(key, 1, minify)}${jsonValue(value, 1, minify)}`;
+    }
+
+    yield minify ? '}' : '\n}';
+  }
+
+  /**
+   * JSON-объект из записей Map на уровне вложенности depth, порциями около chunkSize
+   */
+  private *jsonEntries(
+    entries: Iterable<[string, unknown]>,
+    depth: number,
+    chunkSize: number,
+    minify: boolean
+  ): Generator<string> {
+    let chunk = '{';
+    let first = true;
+    for (const [key, value] of entries) {
+      chunk += `${first ? '' : ','}${jsonField(key, depth + 1, minify)}${jsonValue(value, depth + 1, minify)}`;
+      first = false;
+      if (chunk.length >= chunkSize) {
+        yield chunk;
+        chunk = '';
+      }
+    }
+    yield chunk + (first || minify ? '}' : `\n${'  '.repeat(depth)}}`);
+  }
+
+  /**
+   * Склейка мелких записей в порции около chunkSize
+   */
+  private *batched(records: Iterable<string>, chunkSize: number): Generator<string> {
+    let chunk = '';
+    for (const record of records) {
+      chunk += record;
+      if (chunk.length >= chunkSize) {
+        yield chunk;
+        chunk = '';
+      }
+    }
+    if (chunk) yield chunk;
+  }
+
   /**
    * Импорт данных из JSON
    */
-  async import(jsonString: string): Promise<ImportResult> {
+  async import(source: string | Buffer): Promise<ImportResult> {
     Logger.progress('Importing data...');
 
+    return this.restore(() => {
+      if (isGraphNativeAvailable()) {
+        const result = readExport(typeof source === 'string' ? Buffer.from(source, 'utf8') : source);
+        if (result) return this.fromNativeRead(result);
+      }
+      return this.fromParsed(JSON.parse(source.toString()));
+    });
+  }
+
+  /**
+   * Импорт из файла: нативный ридер отображает файл в память и не строит
+   * промежуточных JS-объектов для графа
+   */
+  async importFile(filePath: string): Promise<ImportResult> {
+    Logger.progress(`Importing ${filePath}...`);
+
+    const result = readExport(filePath);
+    if (result) {
+      return this.restore(() => this.fromNativeRead(result));
+    }
+
+    const text = await readFile(filePath, 'utf8');
+    return this.restore(() => this.fromParsed(JSON.parse(text)));
+  }
+
+  /**
+   * Валидация прочитанного документа
+   */
+  private restore(read: () => Record<string, unknown>): ImportResult {
     try {
-      const parsed = JSON.parse(jsonString);
+      const parsed = read();
 
       // Валидация
       const errors: string[] = [];
@@ -185,17 +409,12 @@ export class ExportManager {
         errors.push('Missing exportDate');
       }
 
-      // Восстанавливаем Map из объектов
-      if (parsed.symbols && typeof parsed.symbols === 'object') {
-        parsed.symbols = new Map(Object.entries(parsed.symbols));
-      }
-
       if (errors.length > 0) {
         return { success: false, errors };
       }
 
       Logger.success('Import completed');
-      return { success: true, data: parsed as ExportData };
+      return { success: true, data: parsed as unknown as ExportData };
     } catch (error) {
       return {
         success: false,
@@ -204,6 +423,99 @@ export class ExportManager {
     }
   }
 
+  /**
+   * Документ после JSON.parse: восстанавливаем Map из объектов
+   */
+  private fromParsed(parsed: Record<string, unknown>): Record<string, unknown> {
+    const graph = parsed.graph as { nodes?: Record<string, GraphNode>; edges?: Record<string, GraphEdge[]> } | null;
+    if (graph && typeof graph === 'object') {
+      parsed.graph = {
+        nodes: new Map(Object.entries(graph.nodes ?? {})),
+        edges: new Map(Object.entries(graph.edges ?? {}))
+      };
+    }
+
+    if (parsed.symbols && typeof parsed.symbols === 'object') {
+      parsed.symbols = new Map(Object.entries(parsed.symbols as Record<string, Symbol>));
+    }
+
+    return parsed;
+  }
+
+  /**
+   * Документ из нативного ридера: граф из колонок, остальные секции — JSON.parse
+   */
+  private fromNativeRead(result: ExportReadResult): Record<string, unknown> {
+    if (result.error) {
+      throw new Error(`${result.error} at byte ${result.errorOffset ?? 0}`);
+    }
+
+    const parsed: Record<string, unknown> = {};
+    for (const section of result.sections ?? []) {
+      if (section.key === '__proto__') continue;
+      parsed[section.key] = JSON.parse(section.json);
+    }
+
+    if (parsed.symbols && typeof parsed.symbols === 'object') {
+      parsed.symbols = new Map(Object.entries(parsed.symbols as Record<string, Symbol>));
+    }
+
+    if (result.graph) {
+      parsed.graph = this.graphFromTables(result.graph);
+    }
+
+    return parsed;
+  }
+
+  /**
+   * Сборка DependencyGraph из колонок нативного ридера
+   */
+  private graphFromTables(tables: ImportedGraphTables): DependencyGraph {
+    const { stringOffsets } = tables;
+    const strings: string[] = new Array(stringOffsets.length - 1);
+    for (let i = 0; i < strings.length; i++) {
+      strings[i] = tables.strings.toString('utf8', stringOffsets[i], stringOffsets[i + 1]);
+    }
+
+    const nodes = new Map<string, GraphNode>();
+    for (let i = 0; i < tables.nodeId.length; i++) {
+      const metadata: GraphNode['metadata'] = {};
+      if (!Number.isNaN(tables.nodeLinesOfCode[i])) metadata.linesOfCode = tables.nodeLinesOfCode[i];
+      if (!Number.isNaN(tables.nodeComplexity[i])) metadata.complexity = tables.nodeComplexity[i];
+      if (tables.nodeDomain[i] !== 0xFFFFFFFF) metadata.domain = strings[tables.nodeDomain[i]];
+
+      const id = strings[tables.nodeId[i]];
+      nodes.set(id, {
+        id,
+        type: strings[tables.nodeType[i]] as GraphNode['type'],
+        filePath: strings[tables.nodeFilePath[i]],
+        name: strings[tables.nodeName[i]],
+        metadata
+      });
+    }
+
+    const edges = new Map<string, GraphEdge[]>();
+    let list: GraphEdge[] = [];
+    let listFrom = -1;
+    for (let e = 0; e < tables.edgeFrom.length; e++) {
+      // Рёбра одного источника идут подряд
+      if (tables.edgeFrom[e] !== listFrom) {
+        listFrom = tables.edgeFrom[e];
+        const from = strings[listFrom];
+        list = edges.get(from) ?? [];
+        edges.set(from, list);
+      }
+      list.push({
+        from: strings[listFrom],
+        to: strings[tables.edgeTo[e]],
+        type: strings[tables.edgeType[e]] as EdgeType,
+        weight: tables.edgeWeight[e]
+      });
+    }
+
+    return { nodes, edges };
+  }
+
   /**
    * Экспорт в JSON
    */
@@ -216,7 +528,7 @@ export class ExportManager {
 
     if (options.includeGraph && data.graph) {
       exportObj.graph = {
-        nodes: data.graph.nodes,
+        nodes: Object.fromEntries(data.graph.nodes),
         edges: Object.fromEntries(data.graph.edges)
       };
     }
@@ -628,15 +940,20 @@ ${data.security.vulnerabilities.slice(0, 20).map(v =>
    * Экспорт метрик в CSV
    */
   private exportCSV(data: ExportData): string {
-    const rows: string[] = [];
+    return Array.from(this.csvRows(data)).join('');
+  }
 
+  /**
+   * Строки CSV метрик (с переводом строки перед каждой, кроме первой)
+   */
+  private *csvRows(data: ExportData): Generator<string> {
     // Header
-    rows.push('File,LOC,SLOC,Comments,Complexity,Cognitive,Maintainability,Afferent,Efferent,Instability');
+    yield 'File,LOC,SLOC,Comments,Complexity,Cognitive,Maintainability,Afferent,Efferent,Instability';
 
     // Data
     if (data.metrics?.files) {
       for (const fileMetrics of data.metrics.files) {
-        rows.push([
+        yield '\n' + [
           `"${fileMetrics.filePath}"`,
           fileMetrics.loc.total,
           fileMetrics.loc.code,
@@ -647,11 +964,17 @@ ${data.security.vulnerabilities.slice(0, 20).map(v =>
           fileMetrics.coupling.afferentCoupling,
           fileMetrics.coupling.efferentCoupling,
           fileMetrics.coupling.instability.toFixed(2)
-        ].join(','));
+        ].join(',');
       }
     }
+  }
 
-    return rows.join('\n');
+  /**
+   * Экспорт рёбер графа в CSV
+   */
+  private exportEdgesCSV(data: ExportData): string {
+    if (!data.graph) return '';
+    return Array.from(GraphExporter.fromGraph(data.graph).chunks('csv')).join('');
   }
 
   /**
@@ -774,3 +1097,8 @@ export async function importFromJSON(jsonString: string): Promise<ImportResult>
   const manager = new ExportManager();
   return manager.import(jsonString);
 }
+
+export async function importFromFile(filePath: string): Promise<ImportResult> {
+  const manager = new ExportManager();
+  return manager.importFile(filePath);
+}
@@ -4,6 +4,8 @@
 
 import { Neo4jClient } from './neo4j-client.js';
 import { GraphStore } from './graph-store.js';
+import { GraphAnalytics, findCycles } from '../native/graph.js';
+import type { GraphEdge } from '../types/index.js';
 
 export interface QueryResult {
   file: string;
@@ -13,9 +15,16 @@ export interface QueryResult {
   count?: number;
 }
 
+export type RankMetric = 'pagerank' | 'betweenness' | 'core';
+
 export class GraphQueries {
   private client: Neo4jClient;
   private store: GraphStore;
+  // Analytics over the in-memory graph, reused until the store's graph version changes
+  private analytics: {
+    version: number;
+    engine: GraphAnalytics;
+  } | null = null;
 
   constructor(client: Neo4jClient, store: GraphStore) {
     this.client = client;
@@ -125,6 +134,27 @@ export class GraphQueries {
     return this.memHubFiles(limit);
   }
 
+  /**
+   * Files ranked by graph centrality: PageRank (transitively depended on),
+   * betweenness (on many dependency paths) or k-core (in a dense cluster)
+   */
+  async rankFiles(metric: RankMetric = 'pagerank', limit = 10): Promise<Array<{ file: string; score: number }>> {
+    const { engine, fileOf } = await this.loadAnalytics();
+    const ranked =
+      metric === 'betweenness' ? engine.betweenness(limit) :
+      metric === 'core' ? engine.coreNumbers(limit) :
+      engine.pageRank(limit);
+    return ranked.map(r => ({ file: fileOf(r.id), score: r.score }));
+  }
+
+  /**
+   * Groups of files that transitively depend on each other, largest first
+   */
+  async dependencyClusters(minSize = 2): Promise<Array<{ files: string[] }>> {
+    const { engine, fileOf } = await this.loadAnalytics();
+    return engine.stronglyConnected(minSize).map(group => ({ files: group.map(fileOf) }));
+  }
+
   /**
    * Files with no dependencies (orphans)
    */
@@ -176,6 +206,34 @@ export class GraphQueries {
     };
   }
 
+  private async loadAnalytics(): Promise<{ engine: GraphAnalytics; fileOf: (id: string) => string }> {
+    if (this.client.connected) {
+      const edges = await this.client.run(
+        `MATCH (a:File)-[]->(b:File)
+         RETURN DISTINCT a.filePath AS from, b.filePath AS to`
+      ) as Array<{ from: string; to: string }>;
+      const engine = new GraphAnalytics();
+      engine.addEdges(edges);
+      return { engine, fileOf: id => id };
+    }
+    return this.memAnalytics();
+  }
+
+  private memAnalytics(): { engine: GraphAnalytics; fileOf: (id: string) => string } {
+    const graph = this.store.getInMemoryGraph();
+    const fileOf = (id: string) => graph.nodes.get(id)?.filePath || id;
+    const version = graph.version ?? 0;
+
+    const cached = this.analytics;
+    if (cached && cached.version === version) {
+      return { engine: cached.engine, fileOf };
+    }
+
+    const engine = GraphAnalytics.fromGraph(graph);
+    this.analytics = { version, engine };
+    return { engine, fileOf };
+  }
+
   // ===== In-memory fallbacks =====
 
   private memDependentsOf(file: string): QueryResult[] {
@@ -238,58 +296,16 @@ export class GraphQueries {
 
   private memFindCycles(): Array<{ cycle: string[] }> {
     const graph = this.store.getInMemoryGraph();
-    const cycles: Array<{ cycle: string[] }> = [];
-    const visited = new Set<string>();
-
-    const buildAdjacency = () => {
-      const adj = new Map<string, string[]>();
-      for (const [, edges] of graph.edges) {
-        for (const edge of edges) {
-          if (edge.type === 'import') {
-            const list = adj.get(edge.from) || [];
-            list.push(edge.to);
-            adj.set(edge.from, list);
-          }
-        }
-      }
-      return adj;
-    };
-
-    const adj = buildAdjacency();
-    const path: string[] = [];
-    const inPath = new Set<string>();
-
-    const dfs = (node: string) => {
-      if (inPath.has(node)) {
-        const cycleStart = path.indexOf(node);
-        if (cycleStart >= 0) {
-          cycles.push({ cycle: [...path.slice(cycleStart), node] });
-        }
-        return;
-      }
-      if (visited.has(node)) return;
-
-      visited.add(node);
-      inPath.add(node);
-      path.push(node);
-
-      for (const neighbor of adj.get(node) || []) {
-        dfs(neighbor);
-        if (cycles.length >= 50) return;
-      }
-
-      path.pop();
-      inPath.delete(node);
-    };
-
-    for (const nodeId of graph.nodes.keys()) {
-      if (!visited.has(nodeId)) {
-        dfs(nodeId);
-        if (cycles.length >= 50) break;
+    const imports: GraphEdge[] = [];
+    for (const [, edges] of graph.edges) {
+      for (const edge of edges) {
+        if (edge.type === 'import') imports.push(edge);
       }
     }
 
-    return cycles;
+    // Shortest cycles per strongly connected component, closed like a Cypher path
+    const { cycles } = findCycles(imports, { maxCycles: 50 });
+    return cycles.map(cycle => ({ cycle: [...cycle, cycle[0]] }));
   }
 
   private memShortestPath(from: string, to: string): { path: string[]; length: number } | null {
@@ -329,6 +345,10 @@ export class GraphQueries {
     return null;
   }
 
+  /**
+   * Hubs ordered by PageRank, so a file that many files depend on
+   * transitively outranks one with more direct but peripheral dependents
+   */
   private memHubFiles(limit: number): Array<{ file: string; dependentCount: number }> {
     const graph = this.store.getInMemoryGraph();
     const dependentCounts = new Map<string, number>();
@@ -339,13 +359,15 @@ export class GraphQueries {
       }
     }
 
-    return Array.from(dependentCounts.entries())
-      .map(([nodeId, count]) => ({
-        file: graph.nodes.get(nodeId)?.filePath || nodeId,
-        dependentCount: count,
-      }))
-      .sort((a, b) => b.dependentCount - a.dependentCount)
-      .slice(0, limit);
+    const { engine, fileOf } = this.memAnalytics();
+    const hubs: Array<{ file: string; dependentCount: number }> = [];
+    for (const { id } of engine.pageRank()) {
+      const dependentCount = dependentCounts.get(id);
+      if (!dependentCount) continue;
+      hubs.push({ file: fileOf(id), dependentCount });
+      if (hubs.length === limit) break;
+    }
+    return hubs;
   }
 
   private memOrphanFiles(): QueryResult[] {
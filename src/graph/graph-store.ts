@@ -12,6 +12,8 @@ export class GraphStore {
   private memNodes = new Map<string, GraphNode>();
   private memEdges = new Map<string, GraphEdge[]>();
   private memSymbols = new Map<string, Symbol>();
+  // Bumped whenever the in-memory graph changes
+  private memVersion = 0;
 
   constructor(client: Neo4jClient) {
     this.client = client;
@@ -103,6 +105,7 @@ export class GraphStore {
   private syncToMemory(graph: DependencyGraph, symbols?: Symbol[]): void {
     this.memNodes = new Map(graph.nodes);
     this.memEdges = new Map(graph.edges);
+    this.memVersion++;
     if (symbols) {
       for (const sym of symbols) {
         this.memSymbols.set(sym.id, sym);
@@ -121,6 +124,7 @@ export class GraphStore {
     this.memNodes.clear();
     this.memEdges.clear();
     this.memSymbols.clear();
+    this.memVersion++;
   }
 
   /**
@@ -149,6 +153,7 @@ export class GraphStore {
           }
         }
       }
+      this.memVersion++;
     }
 
     // Re-sync the changed parts
@@ -159,7 +164,7 @@ export class GraphStore {
    * Get the in-memory graph (for query fallback)
    */
   getInMemoryGraph(): DependencyGraph {
-    return { nodes: this.memNodes, edges: this.memEdges };
+    return { nodes: this.memNodes, edges: this.memEdges, version: this.memVersion };
   }
 
   getInMemorySymbols(): Symbol[] {
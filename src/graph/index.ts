@@ -6,7 +6,7 @@ export { Neo4jClient } from './neo4j-client.js';
 export type { Neo4jConfig } from './neo4j-client.js';
 export { GraphStore } from './graph-store.js';
 export { GraphQueries } from './graph-queries.js';
-export type { QueryResult } from './graph-queries.js';
+export type { QueryResult, RankMetric } from './graph-queries.js';
 
 import { Neo4jClient } from './neo4j-client.js';
 import { GraphStore } from './graph-store.js';
@@ -21,8 +21,18 @@ import {
   ArchitectureModel
 } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { ReachabilityIndex } from '../native/graph.js';
+
+const MAX_IMPACT_DISTANCE = 5;
+
+interface CachedReachability {
+  index: ReachabilityIndex;
+  version: number;
+}
 
 export class ImpactEngine {
+  private reachability = new WeakMap<DependencyGraph, CachedReachability>();
+
   analyzeChange(
     change: Change,
     graph: DependencyGraph,
@@ -53,12 +63,23 @@ export class ImpactEngine {
     symbols: Map<string, Symbol>
   ): AffectedNode[] {
     const affected: AffectedNode[] = [];
-    const visited = new Set<string>();
-
     const changedNodes = this.getChangedNodes(change, graph, symbols);
-
-    for (const nodeId of changedNodes) {
-      this.traverseDependents(nodeId, graph, affected, visited, 0);
+    const index = this.getReachabilityIndex(graph);
+
+    // BFS over dependents: each node once, at its shortest distance
+    for (const { id, distance } of index.affected([...changedNodes], MAX_IMPACT_DISTANCE)) {
+      const node = graph.nodes.get(id);
+      if (!node) continue;
+
+      affected.push({
+        id,
+        name: node.name,
+        type: node.type,
+        filePath: node.filePath,
+        impactLevel: this.calculateImpactLevel(distance, node.type),
+        reason: this.generateImpactReason(distance, node.type),
+        distance
+      });
     }
 
     affected.sort((a, b) => {
@@ -69,6 +90,22 @@ export class ImpactEngine {
     return affected;
   }
 
+  /**
+   * Reachability index for a graph, reused across analyses until the
+   * graph's version changes
+   */
+  private getReachabilityIndex(graph: DependencyGraph): ReachabilityIndex {
+    const version = graph.version ?? 0;
+    const cached = this.reachability.get(graph);
+    if (cached && cached.version === version) {
+      return cached.index;
+    }
+
+    const index = ReachabilityIndex.fromGraph(graph);
+    this.reachability.set(graph, { index, version });
+    return index;
+  }
+
   private getChangedNodes(
     change: Change,
     graph: DependencyGraph,
@@ -94,56 +131,6 @@ export class ImpactEngine {
     return nodes;
   }
 
-  private traverseDependents(
-    nodeId: string,
-    graph: DependencyGraph,
-    affected: AffectedNode[],
-    visited: Set<string>,
-    distance: number,
-    maxDistance: number = 5
-  ): void {
-    if (visited.has(nodeId) || distance > maxDistance) {
-      return;
-    }
-
-    visited.add(nodeId);
-    const node = graph.nodes.get(nodeId);
-
-    if (!node) return;
-
-    const impactLevel = this.calculateImpactLevel(distance, node.type);
-
-    affected.push({
-      id: nodeId,
-      name: node.name,
-      type: node.type,
-      filePath: node.filePath,
-      impactLevel,
-      reason: this.generateImpactReason(distance, node.type),
-      distance
-    });
-
-    const dependents = this.findDependents(nodeId, graph);
-
-    for (const dependent of dependents) {
-      this.traverseDependents(dependent, graph, affected, visited, distance + 1, maxDistance);
-    }
-  }
-
-  private findDependents(nodeId: string, graph: DependencyGraph): string[] {
-    const dependents: string[] = [];
-
-    for (const [from, edges] of graph.edges) {
-      for (const edge of edges) {
-        if (edge.to === nodeId) {
-          dependents.push(from);
-        }
-      }
-    }
-
-    return dependents;
-  }
-
   private calculateImpactLevel(
     distance: number,
     nodeType: string
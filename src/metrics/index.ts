@@ -12,6 +12,7 @@
 
 import { DependencyGraph, Symbol, ASTNode, SymbolKind } from '../types/index.js';
 import { Logger } from '../utils/logger.js';
+import { GraphAnalytics } from '../native/graph.js';
 
 export interface FileMetrics {
   filePath: string;
@@ -112,7 +113,7 @@ export class MetricsCalculator {
     }
 
     const summary = this.calculateSummary(fileMetrics);
-    const hotspots = this.identifyHotspots(fileMetrics);
+    const hotspots = this.identifyHotspots(fileMetrics, this.fileCentrality(graph));
 
     Logger.success(`Metrics calculated for ${fileMetrics.length} files`);
 
@@ -647,11 +648,32 @@ export class MetricsCalculator {
     };
   }
 
+  /**
+   * PageRank per file (symbol nodes count towards their file), relative to
+   * the most central file: 1 for the file most depended on transitively
+   */
+  private fileCentrality(graph: DependencyGraph): Map<string, number> {
+    const centrality = new Map<string, number>();
+    let max = 0;
+
+    for (const { id, score } of GraphAnalytics.fromGraph(graph).pageRank()) {
+      const file = graph.nodes.get(id)?.filePath || id;
+      const total = (centrality.get(file) || 0) + score;
+      centrality.set(file, total);
+      max = Math.max(max, total);
+    }
+
+    if (max > 0) {
+      for (const [file, score] of centrality) centrality.set(file, score / max);
+    }
+    return centrality;
+  }
+
   /**
    * Определение "горячих точек"
    * Score 0-100 using logarithmic scaling for better distribution
    */
-  private identifyHotspots(files: FileMetrics[]): Hotspot[] {
+  private identifyHotspots(files: FileMetrics[], centrality: Map<string, number>): Hotspot[] {
     const hotspots: Hotspot[] = [];
 
     for (const file of files) {
@@ -686,10 +708,17 @@ export class MetricsCalculator {
         reasons.push(`Low maintainability (${file.maintainability})`);
       }
 
+      // Центральность (max 20 points, only alongside another reason)
+      const rank = centrality.get(file.filePath) || 0;
+      if (reasons.length > 0 && rank >= 0.25) {
+        score += 20 * rank;
+        reasons.push(`Central dependency (PageRank ${Math.round(rank * 100)}% of the top file)`);
+      }
+
       if (reasons.length > 0) {
         hotspots.push({
           filePath: file.filePath,
-          score: Math.round(score), // No longer need Math.min(100) as max is ~100
+          score: Math.min(100, Math.round(score)),
           reasons
         });
       }
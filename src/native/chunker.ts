@@ -8,6 +8,8 @@ import * as path from 'path';
 import { fileURLToPath } from 'url';
 import { dirname } from 'path';
 import { createRequire } from 'module';
+import { FileFlags } from './indexer.js';
+import type { DiffResult } from './indexer.js';
 
 // ESM compatibility: get __dirname and require equivalents
 const __filename = fileURLToPath(import.meta.url);
@@ -38,6 +40,64 @@ export interface CodeChunk {
   context: ChunkContext;
   chunkIndex: number;
   hash: string;
+  /** Stable identity: hash of path, semantic name and normalized content */
+  id: string;
+  /** Slice of ChunkResult.embedText (present when embedText is enabled) */
+  embedOffset?: number;
+  embedLength?: number;
+  embedTokenCount?: number;
+  /** Embedding text of a streamed chunk (streamChunks with embedText) */
+  embedText?: string;
+}
+
+/**
+ * Changes between two chunkings of one file, keyed by chunk id
+ */
+export interface ChunkDelta {
+  /** New ids: embed and upsert */
+  upserts: CodeChunk[];
+  /** Known ids whose location or exact content changed: refresh payload */
+  updates: CodeChunk[];
+  /** Ids no longer present */
+  deletes: string[];
+  unchanged: number;
+}
+
+/**
+ * Format-insensitive hash of one function, class or method
+ */
+export interface SymbolHash {
+  name: string;
+  /** Enclosing symbols joined by '.', with '#n' on repeated names */
+  qualifiedName: string;
+  type: ChunkType;
+  lineStart: number;
+  lineEnd: number;
+  byteOffset: number;
+  byteLength: number;
+  /** Body token stream without whitespace and comments (16 hex digits) */
+  hash: string;
+}
+
+/**
+ * A symbol present in both versions of a file
+ */
+export interface SymbolChange {
+  before: SymbolHash;
+  after: SymbolHash;
+}
+
+/**
+ * Symbol-level changes between two versions of a file
+ */
+export interface SymbolDelta {
+  added: SymbolHash[];
+  removed: SymbolHash[];
+  /** Same qualified name, different body */
+  changed: SymbolChange[];
+  /** Same body, new location or new qualified name */
+  moved: SymbolChange[];
+  unchanged: number;
 }
 
 export type ChunkType =
@@ -78,6 +138,25 @@ export interface ChunkerConfig {
   includeContext?: boolean;
   preserveImports?: boolean;
   language?: Language;
+  streamWindowBytes?: number;
+  streamLookaheadBytes?: number;
+  /** Build normalized embedding text for each chunk */
+  embedText?: boolean;
+  embedStripComments?: boolean;
+  embedCollapseWhitespace?: boolean;
+  /** Prefix file path, scope and imports */
+  embedContextHeader?: boolean;
+  /** Per-file boundary detection time in ms before falling back (0 = unlimited) */
+  boundaryTimeBudgetMs?: number;
+  /** Per-file boundary pattern attempts before falling back (0 = unlimited) */
+  boundaryStepBudget?: number;
+  /**
+   * Skip binary files and use plain windows for minified/generated ones
+   * (default false). Also splits windows inside lines over 512 bytes.
+   */
+  classifyFiles?: boolean;
+  /** Hash each function, class and method into ChunkResult.symbols (native only) */
+  hashSymbols?: boolean;
 }
 
 export interface ChunkResult {
@@ -86,24 +165,305 @@ export interface ChunkResult {
   totalLines: number;
   chunkingTimeMs: number;
   error?: string;
+  language?: Language;
+  /** Embedding texts of all chunks, back to back (UTF-8) */
+  embedText?: Buffer;
+  /** Boundary detection ran out of budget; chunks follow braces or lines */
+  degraded?: boolean;
+  /** FileFlags the file was chunked with (see indexer FileFlags) */
+  fileFlags?: number;
+  /** Binary or high-entropy file; no chunks were produced */
+  skipped?: boolean;
+  /** Per-symbol hashes in file order (hashSymbols) */
+  symbols?: SymbolHash[];
+}
+
+/**
+ * Embedding texts of many files packed into one buffer
+ * Chunk i spans text[offsets[i], offsets[i + 1])
+ */
+export interface EmbeddingBatch {
+  text: Buffer;
+  offsets: Uint32Array;
+  tokenCounts: Uint32Array;
+  /** Index into the input file list, per chunk */
+  fileIndex: Uint32Array;
+  ids: string[];
+  errors: { filepath: string; error: string }[];
+}
+
+export interface SymbolTableOptions {
+  numWorkers?: number;
+  boundaryTimeBudgetMs?: number;
+  boundaryStepBudget?: number;
+  maxFileSize?: number;
+}
+
+/**
+ * Symbols of a batch of files as columns, one row per symbol
+ * Rows of file f are [fileOffsets[f], fileOffsets[f + 1]); the name of row i
+ * is names[nameOffsets[i], nameOffsets[i + 1]); parent is a row (-1 at top level)
+ */
+export interface SymbolTableColumns {
+  file: Uint32Array;
+  kind: Uint8Array;
+  flags: Uint8Array;
+  parent: Int32Array;
+  /** 1-based */
+  lineStart: Uint32Array;
+  lineEnd: Uint32Array;
+  byteOffset: Uint32Array;
+  byteLength: Uint32Array;
+  nameOffsets: Uint32Array;
+  names: Buffer;
+  fileOffsets: Uint32Array;
+  /** FileFlags classification per file */
+  fileFlags: Uint8Array;
+  languages: Language[];
+  errors: { filepath: string; error: string }[];
+}
+
+/** Set in SymbolTableColumns.flags for symbols visible outside their file */
+export const SYMBOL_FLAG_EXPORTED = 1;
+
+// ChunkType by its native enum value
+const CHUNK_TYPES: ChunkType[] = [
+  'unknown', 'function', 'class', 'struct', 'interface', 'enum',
+  'module', 'import', 'export', 'comment', 'block', 'statement',
+];
+
+export interface ChunkCacheOptions {
+  byteBudget?: number;
+  spillPath?: string;
+  /** Spill store size bound in bytes (default 4 x byteBudget) */
+  spillBudget?: number;
+}
+
+export interface ChunkCacheStats {
+  hits: number;
+  spillHits: number;
+  misses: number;
+  evictions: number;
+  bytesUsed: number;
+  byteBudget: number;
+  entries: number;
+  spilled: number;
+  spillBytes: number;
+  compactions: number;
+}
+
+export interface ParseCacheOptions {
+  /** Store file, created when missing (its directory must exist) */
+  path: string;
+}
+
+export interface ParseCacheStats {
+  hits: number;
+  misses: number;
+  stores: number;
+  entries: number;
+  fileBytes: number;
+}
+
+export type OccurrenceRole = 'definition' | 'import' | 'reference';
+
+export interface IdentifierOccurrence {
+  file: string;
+  offset: number;
+  /** 1-based */
+  line: number;
+  /** 1-based */
+  column: number;
+  role: OccurrenceRole;
+}
+
+export interface IdentifierQuery {
+  /** Roles to include (default: all) */
+  roles?: OccurrenceRole[];
+  /** Only this file */
+  file?: string;
+}
+
+export interface CallSite {
+  file: string;
+  offset: number;
+  /** 1-based */
+  line: number;
+  /** 1-based */
+  column: number;
+  callee: string;
+  /** Innermost enclosing function, null outside functions */
+  caller: string | null;
+}
+
+export interface IdentifierIndexStats {
+  files: number;
+  identifiers: number;
+  occurrences: number;
+  /** Occurrences that are call sites (native only) */
+  calls: number;
+  updates: number;
+  skippedUpdates: number;
+  indexTimeMs: number;
+}
+
+export interface AstNodeInfo {
+  id: number;
+  type: string;
+  name: string;
+  /** -1 for the root */
+  parent: number;
+  /** -1 when there are no children */
+  firstChild: number;
+  /** -1 for the last child */
+  nextSibling: number;
+  /** One past the last descendant; the subtree is [id, subtreeEnd) */
+  subtreeEnd: number;
+  childCount: number;
+  /** UTF-16 offsets into the source */
+  start: number;
+  end: number;
+  /** 0-based, as reported by tree-sitter */
+  startLine: number;
+  startColumn: number;
+  endLine: number;
+  endColumn: number;
+  hasError: boolean;
+}
+
+export interface AstArenaStats {
+  files: number;
+  nodes: number;
+  kinds: number;
+  names: number;
+  sourceBytes: number;
+  nodeBytes: number;
+}
+
+/** Values per node in the array passed to AstArena.setFile */
+export const AST_NODE_STRIDE = 9;
+/** "No node" in parent and name node slots */
+export const AST_NO_NODE = 0xffffffff;
+/** Set on the kind slot of ERROR and missing nodes */
+export const AST_ERROR_BIT = 0x80000000;
+
+export interface ContextSnippet {
+  text: string;
+  /** Relevance; higher is better */
+  score: number;
+  /** File the snippet comes from; snippets of one file never overlap in the result */
+  source?: string;
+  /** 1-based line range in source */
+  lineStart?: number;
+  lineEnd?: number;
+  /** Always included while it fits */
+  pinned?: boolean;
+}
+
+export interface PackOptions {
+  tokenBudget: number;
+  /** Tokens added per selected snippet (headers, fences) */
+  snippetOverhead?: number;
+}
+
+export interface PackResult {
+  /** Indices into the input, ascending */
+  selected: Uint32Array;
+  /** Token count of every input snippet (without overhead) */
+  tokenCounts: Uint32Array;
+  /** Including overhead */
+  totalTokens: number;
+  totalScore: number;
+  /** Snippets dropped as exact duplicates */
+  duplicates: number;
+  /** The selection is provably optimal */
+  exact: boolean;
 }
 
 // Native module interface
+type SymbolSource = SymbolHash[] | ChunkResult | Buffer;
+
 interface NativeChunkerModule {
   Chunker: new (config?: ChunkerConfig) => NativeChunker;
+  ChunkCache: new (options?: ChunkCacheOptions) => NativeChunkCache;
+  ChunkStream: new (filepath: string, config?: ChunkerConfig) => NativeChunkStream;
+  IdentifierIndex: new () => NativeIdentifierIndex;
+  AstArena: new () => NativeAstArena;
+  ParseCache: new (options: ParseCacheOptions) => NativeParseCache;
   chunk: (source: string, options?: ChunkerConfig & { filepath?: string }) => ChunkResult;
   chunkFile: (filepath: string, options?: ChunkerConfig) => ChunkResult;
   countTokens: (text: string) => number;
+  exportChunks: (result: ChunkResult | Buffer, filepath: string) => Buffer;
+  importChunks: (data: Buffer) => ChunkResult & { filepath: string };
+  diffChunks: (before: ChunkResult | Buffer, after: ChunkResult | Buffer) => ChunkDelta;
+  diffSymbols: (before: SymbolSource, after: SymbolSource) => SymbolDelta;
+  buildSymbolTable: (filepaths: string[], options?: SymbolTableOptions) => SymbolTableColumns;
+  packContext: (snippets: ContextSnippet[], options: PackOptions) => PackResult;
   version: string;
 }
 
 interface NativeChunker {
-  chunk(source: string, filepath?: string): ChunkResult;
-  chunkFile(filepath: string): ChunkResult;
+  chunk(source: string, filepath?: string, contentHash?: string, fileFlags?: number): ChunkResult;
+  chunkFile(filepath: string, contentHash?: string, fileFlags?: number): ChunkResult;
+  chunkFileExport(filepath: string, contentHash?: string, fileFlags?: number): Buffer;
+  embedFiles(filepaths: string[], contentHashes?: string[], fileFlags?: number[]): EmbeddingBatch;
+  setCache(cache: NativeChunkCache | null): void;
+  setIdentifierIndex(index: NativeIdentifierIndex | null): void;
   setConfig(config: ChunkerConfig): void;
   getConfig(): ChunkerConfig;
 }
 
+interface NativeIdentifierIndex {
+  updateFile(path: string, source: string, language?: Language, contentHash?: string): boolean;
+  removeFile(path: string): boolean;
+  renameFile(oldPath: string, newPath: string): boolean;
+  occurrences(name: string, query?: IdentifierQuery): IdentifierOccurrence[];
+  count(name: string, query?: IdentifierQuery): number;
+  files(name: string, query?: IdentifierQuery): string[];
+  callSites(name: string, query?: Pick<IdentifierQuery, 'file'>): CallSite[];
+  callees(name: string, query?: Pick<IdentifierQuery, 'file'>): CallSite[];
+  stats(): IdentifierIndexStats;
+  clear(): void;
+}
+
+interface NativeAstArena {
+  setFile(path: string, source: string, kinds: string[], nodes: Uint32Array): void;
+  removeFile(path: string): boolean;
+  hasFile(path: string): boolean;
+  files(): string[];
+  nodeCount(path: string): number;
+  node(path: string, id: number): AstNodeInfo | null;
+  children(path: string, id: number): Uint32Array;
+  find(path: string, kinds: string[], root?: number, firstOnly?: boolean): Uint32Array;
+  walk(path: string, root: number, maxDepth?: number): { ids: Uint32Array; depths: Uint32Array };
+  text(path: string, id: number, maxLength?: number): string;
+  stats(): AstArenaStats;
+  clear(): void;
+}
+
+interface NativeChunkCache {
+  stats(): ChunkCacheStats;
+  flush(): boolean;
+  clear(): void;
+}
+
+interface NativeParseCache {
+  get(contentHash: string, fingerprint: string): Buffer | null;
+  has(contentHash: string, fingerprint: string): boolean;
+  put(contentHash: string, fingerprint: string, payload: Buffer): boolean;
+  flush(): boolean;
+  clear(): void;
+  compact(liveHashes: string[]): number;
+  stats(): ParseCacheStats;
+}
+
+interface NativeChunkStream {
+  nextBatch(): Promise<CodeChunk[] | null>;
+  bytesConsumed(): number;
+  totalBytes(): number;
+  degraded(): boolean;
+}
+
 // Try to load native module, fall back to JS implementation
 let nativeModule: NativeChunkerModule | null = null;
 let loadError: Error | null = null;
@@ -215,10 +575,60 @@ function jsCountTokens(text: string): number {
   return count;
 }
 
+// Classified as content with nothing worth chunking
+const FILE_FLAG_CLASSIFIED = FileFlags.CLASSIFIED;
+const FILE_FLAGS_SKIPPED = FileFlags.BINARY | FileFlags.HIGH_ENTROPY;
+
+const CHUNK_TYPES: ChunkType[] = [
+  'unknown', 'function', 'class', 'struct', 'interface', 'enum',
+  'module', 'import', 'export', 'comment', 'block', 'statement',
+];
+
+const FNV_PRIME = 1099511628211n;
+const FNV_MASK = 0xffffffffffffffffn;
+
+function fnvByte(hash: bigint, byte: number): bigint {
+  return ((hash ^ BigInt(byte)) * FNV_PRIME) & FNV_MASK;
+}
+
+function fnvString(hash: bigint, text: string): bigint {
+  for (const byte of Buffer.from(text, 'utf-8')) {
+    hash = fnvByte(hash, byte);
+  }
+  return fnvByte(hash, 0);
+}
+
+/**
+ * Deterministic chunk ids, matching the native ChunkIdAssigner
+ */
+function jsAssignChunkIds(chunks: CodeChunk[], filepath: string): void {
+  const occurrences = new Map<bigint, number>();
+
+  for (const chunk of chunks) {
+    let hash = fnvString(14695981039346656037n, filepath);
+    hash = fnvByte(hash, Math.max(0, CHUNK_TYPES.indexOf(chunk.type)));
+    hash = fnvString(hash, chunk.context.parentName);
+
+    // Whitespace runs collapse to one space; leading/trailing whitespace is dropped
+    const normalized = chunk.content.replace(/[ \t\n\r\f\v]+/g, ' ').replace(/^ | $/g, '');
+    for (const byte of Buffer.from(normalized, 'utf-8')) {
+      hash = fnvByte(hash, byte);
+    }
+
+    const ordinal = occurrences.get(hash) ?? 0;
+    occurrences.set(hash, ordinal + 1);
+    for (let i = 0; i < 4; i++) {
+      hash = fnvByte(hash, (ordinal >>> (i * 8)) & 0xff);
+    }
+
+    chunk.id = hash.toString(16).padStart(16, '0');
+  }
+}
+
 /**
  * Simple JavaScript chunker fallback
  */
-function jsChunk(source: string, options: ChunkerConfig = {}): ChunkResult {
+function jsChunk(source: string, options: ChunkerConfig = {}, filepath = ''): ChunkResult {
   const startTime = performance.now();
 
   const maxTokens = options.maxChunkTokens ?? 512;
@@ -257,6 +667,7 @@ function jsChunk(source: string, options: ChunkerConfig = {}): ChunkResult {
         },
         chunkIndex: chunkIndex++,
         hash: '',
+        id: '',
       });
 
       // Start new chunk with overlap
@@ -298,9 +709,11 @@ function jsChunk(source: string, options: ChunkerConfig = {}): ChunkResult {
       },
       chunkIndex: chunkIndex++,
       hash: '',
+      id: '',
     });
   }
 
+  jsAssignChunkIds(chunks, filepath);
   const endTime = performance.now();
 
   return {
@@ -311,6 +724,748 @@ function jsChunk(source: string, options: ChunkerConfig = {}): ChunkResult {
   };
 }
 
+/**
+ * Cache of chunking results keyed by file content hash
+ * Only effective with the native chunker; a no-op in the JS fallback
+ */
+export class ChunkCache {
+  private nativeCache: NativeChunkCache | null = null;
+
+  constructor(options: ChunkCacheOptions = {}) {
+    if (nativeModule) {
+      this.nativeCache = new nativeModule.ChunkCache(options);
+    }
+  }
+
+  stats(): ChunkCacheStats {
+    if (this.nativeCache) {
+      return this.nativeCache.stats();
+    }
+    return {
+      hits: 0,
+      spillHits: 0,
+      misses: 0,
+      evictions: 0,
+      bytesUsed: 0,
+      byteBudget: 0,
+      entries: 0,
+      spilled: 0,
+      spillBytes: 0,
+      compactions: 0,
+    };
+  }
+
+  /**
+   * Persist resident entries to the spill store (if configured)
+   */
+  flush(): boolean {
+    return this.nativeCache ? this.nativeCache.flush() : true;
+  }
+
+  clear(): void {
+    this.nativeCache?.clear();
+  }
+
+  /** @internal */
+  getNative(): NativeChunkCache | null {
+    return this.nativeCache;
+  }
+}
+
+/**
+ * Persistent store of parse results keyed by file content hash
+ * Payloads are opaque buffers; hashes are decimal strings from hashString().
+ * Only effective with the native chunker; a no-op in the JS fallback
+ */
+export class ParseCache {
+  private nativeCache: NativeParseCache | null = null;
+
+  constructor(options: ParseCacheOptions) {
+    if (nativeModule) {
+      this.nativeCache = new nativeModule.ParseCache(options);
+    }
+  }
+
+  /**
+   * Whether lookups can ever hit (false in the JS fallback)
+   */
+  isEnabled(): boolean {
+    return this.nativeCache !== null;
+  }
+
+  get(contentHash: string, fingerprint: string): Buffer | null {
+    return this.nativeCache ? this.nativeCache.get(contentHash, fingerprint) : null;
+  }
+
+  has(contentHash: string, fingerprint: string): boolean {
+    return this.nativeCache ? this.nativeCache.has(contentHash, fingerprint) : false;
+  }
+
+  /**
+   * Store a payload; existing entries for the same key are kept
+   */
+  put(contentHash: string, fingerprint: string, payload: Buffer): boolean {
+    return this.nativeCache ? this.nativeCache.put(contentHash, fingerprint, payload) : false;
+  }
+
+  flush(): boolean {
+    return this.nativeCache ? this.nativeCache.flush() : true;
+  }
+
+  clear(): void {
+    this.nativeCache?.clear();
+  }
+
+  /**
+   * Drop entries whose content hash is no longer in the project
+   * @returns Number of dropped entries
+   */
+  compact(liveHashes: string[]): number {
+    return this.nativeCache ? this.nativeCache.compact(liveHashes) : 0;
+  }
+
+  stats(): ParseCacheStats {
+    if (this.nativeCache) {
+      return this.nativeCache.stats();
+    }
+    return { hits: 0, misses: 0, stores: 0, entries: 0, fileBytes: 0 };
+  }
+}
+
+// JS fallback identifier scan: literals and comments are dropped whole
+const IDENT_TOKEN_RE =
+  /\/\/[^\n]*|#[^\n]*|\/\*[\s\S]*?\*\/|"(?:\\.|[^"\\\n])*"|'(?:\\.|[^'\\\n])*'|`(?:\\.|[^`\\])*`|[A-Za-z_$][\w$]*|\n|[^\s\w$]/g;
+
+const DEFINITION_KEYWORDS = new Set([
+  'const', 'let', 'var', 'function', 'class', 'interface', 'type', 'enum', 'struct',
+  'trait', 'union', 'def', 'fn', 'func', 'fun', 'val', 'module', 'mod', 'namespace', 'record',
+]);
+const IMPORT_KEYWORDS = new Set(['import', 'use', 'from']);
+const PLAIN_KEYWORDS = new Set([
+  'if', 'else', 'elif', 'for', 'while', 'do', 'return', 'switch', 'case', 'default', 'break',
+  'continue', 'new', 'delete', 'this', 'self', 'super', 'true', 'false', 'null', 'nullptr',
+  'undefined', 'None', 'True', 'False', 'try', 'catch', 'except', 'finally', 'throw', 'throws',
+  'raise', 'async', 'await', 'yield', 'typeof', 'instanceof', 'in', 'of', 'is', 'not', 'and',
+  'or', 'void', 'static', 'public', 'private', 'protected', 'internal', 'readonly', 'abstract',
+  'final', 'override', 'virtual', 'extends', 'implements', 'package', 'pub', 'mut', 'ref',
+  'where', 'match', 'with', 'as', 'lambda', 'pass', 'global', 'nonlocal', 'go', 'defer',
+  'chan', 'select', 'range', 'goto', 'sizeof', 'extern', 'inline', 'export', 'impl', 'crate',
+  'using', 'template', 'typename', 'require', 'end', 'then', 'unless', 'begin',
+]);
+
+type ScannedIdentifier = Omit<IdentifierOccurrence, 'file'> & { name: string };
+
+function jsScanIdentifiers(source: string): ScannedIdentifier[] {
+  const found: ScannedIdentifier[] = [];
+  let line = 1;
+  let lineStart = 0;
+  let afterDefinition = false;
+  let blankGap = true;
+  let member = false;
+  let inImport = false;
+  let importDepth = 0;
+  let statementStart = true;
+
+  IDENT_TOKEN_RE.lastIndex = 0;
+  let m: RegExpExecArray | null;
+  while ((m = IDENT_TOKEN_RE.exec(source)) !== null) {
+    const token = m[0];
+    const first = token[0];
+
+    if (token === '\n') {
+      line++;
+      lineStart = m.index + 1;
+      if (inImport && importDepth <= 0) inImport = false;
+      statementStart = true;
+      continue;
+    }
+    if (!/[A-Za-z_$]/.test(first)) {
+      // Literal, comment or punctuation
+      for (let i = token.indexOf('\n'); i !== -1; i = token.indexOf('\n', i + 1)) {
+        line++;
+        lineStart = m.index + i + 1;
+      }
+      blankGap = false;
+      member = token === '.';
+      if (token === ';') {
+        inImport = false;
+        statementStart = true;
+      } else if (inImport && (token === '{' || token === '(')) {
+        importDepth++;
+      } else if (inImport && (token === '}' || token === ')')) {
+        importDepth--;
+      }
+      continue;
+    }
+
+    const wasStatementStart = statementStart;
+    const wasMember = member;
+    const wasBlank = blankGap;
+    statementStart = false;
+    member = false;
+    blankGap = true;
+
+    if (!wasMember) {
+      if (DEFINITION_KEYWORDS.has(token)) {
+        afterDefinition = true;
+        continue;
+      }
+      if (IMPORT_KEYWORDS.has(token)) {
+        if (!inImport && (token !== 'from' || wasStatementStart)) {
+          importDepth = 0;
+          inImport = true;
+        }
+        afterDefinition = false;
+        continue;
+      }
+      if (PLAIN_KEYWORDS.has(token)) {
+        afterDefinition = false;
+        continue;
+      }
+    }
+
+    let role: OccurrenceRole = 'reference';
+    if (inImport) {
+      role = 'import';
+    } else if (afterDefinition && wasBlank && !wasMember) {
+      role = 'definition';
+    }
+    afterDefinition = false;
+
+    found.push({ name: token, offset: m.index, line, column: m.index - lineStart + 1, role });
+  }
+
+  return found;
+}
+
+function roleFilter(query?: IdentifierQuery): (role: OccurrenceRole) => boolean {
+  if (!query?.roles) return () => true;
+  const roles = new Set(query.roles);
+  return role => roles.has(role);
+}
+
+/**
+ * Cross-reference index of identifier definitions, imports and references
+ * Attach to a SemanticChunker to index every chunked file, or update it
+ * from FileIndex diffs with applyDiff(). The JS fallback scans with a
+ * regex tokenizer, does not look inside template interpolations and
+ * records no call sites.
+ */
+export class IdentifierIndex {
+  private nativeIndex: NativeIdentifierIndex | null = null;
+  // JS fallback: name -> file -> occurrences
+  private byName = new Map<string, Map<string, IdentifierOccurrence[]>>();
+  private byFile = new Map<string, { hash?: string; names: Set<string> }>();
+  private jsStats: IdentifierIndexStats = {
+    files: 0, identifiers: 0, occurrences: 0, calls: 0, updates: 0, skippedUpdates: 0, indexTimeMs: 0,
+  };
+
+  constructor() {
+    if (nativeModule) {
+      this.nativeIndex = new nativeModule.IdentifierIndex();
+    }
+  }
+
+  /**
+   * Index or re-index a file
+   * @param contentHash FileEntry content hash; an unchanged file is skipped
+   * @returns false if skipped
+   */
+  updateFile(path: string, source: string, language?: Language, contentHash?: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.updateFile(path, source, language, contentHash);
+    }
+
+    const existing = this.byFile.get(path);
+    if (contentHash && existing?.hash === contentHash) {
+      this.jsStats.skippedUpdates++;
+      return false;
+    }
+    const start = performance.now();
+    this.removeFile(path);
+
+    const names = new Set<string>();
+    for (const { name, ...occurrence } of jsScanIdentifiers(source)) {
+      let files = this.byName.get(name);
+      if (!files) {
+        files = new Map();
+        this.byName.set(name, files);
+      }
+      let list = files.get(path);
+      if (!list) {
+        list = [];
+        files.set(path, list);
+      }
+      list.push({ file: path, ...occurrence });
+      names.add(name);
+      this.jsStats.occurrences++;
+    }
+    this.byFile.set(path, { hash: contentHash, names });
+    this.jsStats.updates++;
+    this.jsStats.indexTimeMs += performance.now() - start;
+    return true;
+  }
+
+  removeFile(path: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.removeFile(path);
+    }
+    const entry = this.byFile.get(path);
+    if (!entry) return false;
+    for (const name of entry.names) {
+      const files = this.byName.get(name)!;
+      this.jsStats.occurrences -= files.get(path)?.length ?? 0;
+      files.delete(path);
+      if (files.size === 0) this.byName.delete(name);
+    }
+    this.byFile.delete(path);
+    return true;
+  }
+
+  renameFile(oldPath: string, newPath: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.renameFile(oldPath, newPath);
+    }
+    const entry = this.byFile.get(oldPath);
+    if (!entry) return false;
+    if (oldPath === newPath) return true;
+    this.removeFile(newPath);
+    for (const name of entry.names) {
+      const files = this.byName.get(name)!;
+      const list = files.get(oldPath)!;
+      for (const occurrence of list) occurrence.file = newPath;
+      files.delete(oldPath);
+      files.set(newPath, list);
+    }
+    this.byFile.delete(oldPath);
+    this.byFile.set(newPath, entry);
+    return true;
+  }
+
+  /**
+   * Apply a FileIndex diff: re-index added and modified files, move renamed
+   * ones and drop deleted ones
+   * @param readFile Returns the current content of a path (null if unreadable)
+   * @returns Number of files re-indexed
+   */
+  applyDiff(diff: DiffResult, readFile: (path: string) => string | null): number {
+    let updated = 0;
+    for (const change of diff.changes) {
+      if (change.type === 'deleted') {
+        this.removeFile(change.path);
+        continue;
+      }
+      if (change.type === 'renamed' && change.oldPath) {
+        this.renameFile(change.oldPath, change.path);
+        if (change.oldHash === change.newHash) continue;
+      }
+      const source = readFile(change.path);
+      if (source === null) {
+        this.removeFile(change.path);
+      } else if (this.updateFile(change.path, source, undefined, change.newHash)) {
+        updated++;
+      }
+    }
+    return updated;
+  }
+
+  /**
+   * Occurrences of a name, grouped by file in index order
+   */
+  occurrences(name: string, query?: IdentifierQuery): IdentifierOccurrence[] {
+    if (this.nativeIndex) {
+      return this.nativeIndex.occurrences(name, query);
+    }
+    const files = this.byName.get(name);
+    if (!files) return [];
+    const accept = roleFilter(query);
+    const lists = query?.file !== undefined ? [files.get(query.file) ?? []] : Array.from(files.values());
+    return lists.flatMap(list => list.filter(o => accept(o.role)).map(o => ({ ...o })));
+  }
+
+  count(name: string, query?: IdentifierQuery): number {
+    if (this.nativeIndex) {
+      return this.nativeIndex.count(name, query);
+    }
+    return this.occurrences(name, query).length;
+  }
+
+  /**
+   * Files with at least one occurrence of a name in the given roles
+   */
+  files(name: string, query?: Pick<IdentifierQuery, 'roles'>): string[] {
+    if (this.nativeIndex) {
+      return this.nativeIndex.files(name, query);
+    }
+    const files = this.byName.get(name);
+    if (!files) return [];
+    const accept = roleFilter(query);
+    return Array.from(files.entries())
+      .filter(([, list]) => list.some(o => accept(o.role)))
+      .map(([file]) => file);
+  }
+
+  /**
+   * Calls of a name, each with its enclosing function
+   * Native only: the JS fallback returns no call sites
+   */
+  callSites(name: string, query?: Pick<IdentifierQuery, 'file'>): CallSite[] {
+    return this.nativeIndex ? this.nativeIndex.callSites(name, query) : [];
+  }
+
+  /**
+   * Calls made inside functions with this name
+   * Native only: the JS fallback returns no call sites
+   */
+  callees(name: string, query?: Pick<IdentifierQuery, 'file'>): CallSite[] {
+    return this.nativeIndex ? this.nativeIndex.callees(name, query) : [];
+  }
+
+  stats(): IdentifierIndexStats {
+    if (this.nativeIndex) {
+      return this.nativeIndex.stats();
+    }
+    return { ...this.jsStats, files: this.byFile.size, identifiers: this.byName.size };
+  }
+
+  clear(): void {
+    if (this.nativeIndex) {
+      this.nativeIndex.clear();
+      return;
+    }
+    this.byName.clear();
+    this.byFile.clear();
+    this.jsStats = { files: 0, identifiers: 0, occurrences: 0, calls: 0, updates: 0, skippedUpdates: 0, indexTimeMs: 0 };
+  }
+
+  /** @internal */
+  getNative(): NativeIdentifierIndex | null {
+    return this.nativeIndex;
+  }
+}
+
+// JS fallback tree storage: the same preorder arrays as the native arena
+interface JsAstFile {
+  source: string;
+  kind: Uint16Array;
+  error: Uint8Array;
+  parent: Uint32Array;
+  firstChild: Uint32Array;
+  nextSibling: Uint32Array;
+  subtreeEnd: Uint32Array;
+  nodes: Uint32Array;
+  name: Uint32Array;
+}
+
+function astIndex(value: number): number {
+  return value === AST_NO_NODE ? -1 : value;
+}
+
+/**
+ * Flat storage for the syntax trees of many files
+ * Nodes are kept per file in preorder as parallel arrays, so a subtree is
+ * the index range [id, subtreeEnd) and queries never build node objects
+ * for the parts of a tree they skip. Kind names and node names are
+ * interned across files.
+ */
+export class AstArena {
+  private nativeArena: NativeAstArena | null = null;
+  // JS fallback
+  private jsFiles = new Map<string, JsAstFile>();
+  private kindNames: string[] = [];
+  private kindIndex = new Map<string, number>();
+  private names: string[] = [];
+  private nameIndex = new Map<string, number>();
+
+  constructor() {
+    if (nativeModule) {
+      this.nativeArena = new nativeModule.AstArena();
+    }
+  }
+
+  /**
+   * Store or replace the tree of a file
+   * @param kinds Kind names referenced by the kind slots
+   * @param nodes AST_NODE_STRIDE values per node in preorder: kind
+   *   (| AST_ERROR_BIT), parent, start, end, startLine, startColumn,
+   *   endLine, endColumn, nameNode; AST_NO_NODE for none
+   * @throws if the nodes are not a valid preorder tree
+   */
+  setFile(path: string, source: string, kinds: string[], nodes: Uint32Array): void {
+    if (this.nativeArena) {
+      this.nativeArena.setFile(path, source, kinds, nodes);
+      return;
+    }
+
+    const n = nodes.length / AST_NODE_STRIDE;
+    if (!Number.isInteger(n) || n === 0) {
+      throw new Error('Node array length must be a non-zero multiple of 9');
+    }
+    const file: JsAstFile = {
+      source,
+      kind: new Uint16Array(n),
+      error: new Uint8Array(n),
+      parent: new Uint32Array(n),
+      firstChild: new Uint32Array(n).fill(AST_NO_NODE),
+      nextSibling: new Uint32Array(n).fill(AST_NO_NODE),
+      subtreeEnd: new Uint32Array(n),
+      nodes: Uint32Array.from(nodes),
+      name: new Uint32Array(n).fill(AST_NO_NODE),
+    };
+
+    const open: number[] = [];
+    const lastChild = new Uint32Array(n).fill(AST_NO_NODE);
+    for (let i = 0; i < n; i++) {
+      const base = i * AST_NODE_STRIDE;
+      const kind = (nodes[base] & ~AST_ERROR_BIT) >>> 0;
+      const parent = nodes[base + 1];
+      if (kind >= kinds.length) throw new Error(`Node ${i} has an unknown kind`);
+      if (nodes[base + 2] > nodes[base + 3] || nodes[base + 3] > source.length) {
+        throw new Error(`Node ${i} is out of the source range`);
+      }
+      const nameNode = nodes[base + 8];
+      if (nameNode !== AST_NO_NODE && nameNode >= n) throw new Error(`Node ${i} has an unknown name node`);
+
+      if (i === 0) {
+        if (parent !== AST_NO_NODE) throw new Error('The first node must be the root');
+      } else {
+        while (open.length > 0 && open[open.length - 1] !== parent) {
+          file.subtreeEnd[open.pop()!] = i;
+        }
+        if (open.length === 0) throw new Error(`Node ${i} is not in preorder`);
+        if (lastChild[parent] === AST_NO_NODE) {
+          file.firstChild[parent] = i;
+        } else {
+          file.nextSibling[lastChild[parent]] = i;
+        }
+        lastChild[parent] = i;
+      }
+      open.push(i);
+      file.parent[i] = parent;
+      file.error[i] = nodes[base] & AST_ERROR_BIT ? 1 : 0;
+    }
+    for (const id of open) file.subtreeEnd[id] = n;
+    for (let i = n - 1; i > 0; i--) {
+      if (file.error[i]) file.error[file.parent[i]] = 1;
+    }
+
+    const kindMap = kinds.map(name => {
+      let id = this.kindIndex.get(name);
+      if (id === undefined) {
+        id = this.kindNames.length;
+        this.kindNames.push(name);
+        this.kindIndex.set(name, id);
+      }
+      return id;
+    });
+    for (let i = 0; i < n; i++) {
+      const base = i * AST_NODE_STRIDE;
+      file.kind[i] = kindMap[(nodes[base] & ~AST_ERROR_BIT) >>> 0];
+      const nameNode = nodes[base + 8];
+      if (nameNode !== AST_NO_NODE) {
+        const nameBase = nameNode * AST_NODE_STRIDE;
+        const name = source.slice(nodes[nameBase + 2], nodes[nameBase + 3]);
+        let id = this.nameIndex.get(name);
+        if (id === undefined) {
+          id = this.names.length;
+          this.names.push(name);
+          this.nameIndex.set(name, id);
+        }
+        file.name[i] = id;
+      }
+    }
+
+    this.jsFiles.set(path, file);
+  }
+
+  removeFile(path: string): boolean {
+    if (this.nativeArena) {
+      return this.nativeArena.removeFile(path);
+    }
+    return this.jsFiles.delete(path);
+  }
+
+  hasFile(path: string): boolean {
+    if (this.nativeArena) {
+      return this.nativeArena.hasFile(path);
+    }
+    return this.jsFiles.has(path);
+  }
+
+  files(): string[] {
+    if (this.nativeArena) {
+      return this.nativeArena.files();
+    }
+    return Array.from(this.jsFiles.keys());
+  }
+
+  nodeCount(path: string): number {
+    if (this.nativeArena) {
+      return this.nativeArena.nodeCount(path);
+    }
+    return this.jsFiles.get(path)?.kind.length ?? 0;
+  }
+
+  /**
+   * Resolve one node (null if the file or node is unknown)
+   */
+  node(path: string, id: number): AstNodeInfo | null {
+    if (this.nativeArena) {
+      return this.nativeArena.node(path, id);
+    }
+    const file = this.jsFiles.get(path);
+    if (!file || id < 0 || id >= file.kind.length) return null;
+
+    let childCount = 0;
+    for (let c = file.firstChild[id]; c !== AST_NO_NODE; c = file.nextSibling[c]) childCount++;
+    const base = id * AST_NODE_STRIDE;
+    return {
+      id,
+      type: this.kindNames[file.kind[id]],
+      name: file.name[id] === AST_NO_NODE ? '' : this.names[file.name[id]],
+      parent: astIndex(file.parent[id]),
+      firstChild: astIndex(file.firstChild[id]),
+      nextSibling: astIndex(file.nextSibling[id]),
+      subtreeEnd: file.subtreeEnd[id],
+      childCount,
+      start: file.nodes[base + 2],
+      end: file.nodes[base + 3],
+      startLine: file.nodes[base + 4],
+      startColumn: file.nodes[base + 5],
+      endLine: file.nodes[base + 6],
+      endColumn: file.nodes[base + 7],
+      hasError: file.error[id] === 1,
+    };
+  }
+
+  /**
+   * Direct children of a node, in order
+   */
+  children(path: string, id: number): Uint32Array {
+    if (this.nativeArena) {
+      return this.nativeArena.children(path, id);
+    }
+    const file = this.jsFiles.get(path);
+    const result: number[] = [];
+    if (file && id >= 0 && id < file.kind.length) {
+      for (let c = file.firstChild[id]; c !== AST_NO_NODE; c = file.nextSibling[c]) result.push(c);
+    }
+    return Uint32Array.from(result);
+  }
+
+  /**
+   * Nodes of the given kinds in a subtree, in preorder
+   * @param root Subtree root (0 = whole file)
+   * @param firstOnly Stop at the first match
+   */
+  find(path: string, kinds: string[], root = 0, firstOnly = false): Uint32Array {
+    if (this.nativeArena) {
+      return this.nativeArena.find(path, kinds, root, firstOnly);
+    }
+    const file = this.jsFiles.get(path);
+    const result: number[] = [];
+    if (!file || root < 0 || root >= file.kind.length) return Uint32Array.from(result);
+
+    const wanted = new Set<number>();
+    for (const kind of kinds) {
+      const id = this.kindIndex.get(kind);
+      if (id !== undefined) wanted.add(id);
+    }
+    for (let id = root, stop = file.subtreeEnd[root]; id < stop && wanted.size > 0; id++) {
+      if (!wanted.has(file.kind[id])) continue;
+      result.push(id);
+      if (firstOnly) break;
+    }
+    return Uint32Array.from(result);
+  }
+
+  /**
+   * Nodes of a subtree in preorder with their depth below root
+   * @param maxDepth Deepest level to include (default: all)
+   */
+  walk(path: string, root = 0, maxDepth?: number): { ids: Uint32Array; depths: Uint32Array } {
+    if (this.nativeArena) {
+      return this.nativeArena.walk(path, root, maxDepth);
+    }
+    const file = this.jsFiles.get(path);
+    const ids: number[] = [];
+    const depths: number[] = [];
+    if (file && root >= 0 && root < file.kind.length) {
+      const limit = maxDepth ?? Infinity;
+      const ends: number[] = [];
+      for (let id = root, stop = file.subtreeEnd[root]; id < stop;) {
+        while (ends.length > 0 && ends[ends.length - 1] <= id) ends.pop();
+        const depth = ends.length;
+        ids.push(id);
+        depths.push(depth);
+        if (depth >= limit) {
+          id = file.subtreeEnd[id];
+          continue;
+        }
+        ends.push(file.subtreeEnd[id]);
+        id++;
+      }
+    }
+    return { ids: Uint32Array.from(ids), depths: Uint32Array.from(depths) };
+  }
+
+  /**
+   * Source text of a node, cut to maxLength code units (default: all)
+   */
+  text(path: string, id: number, maxLength?: number): string {
+    if (this.nativeArena) {
+      return this.nativeArena.text(path, id, maxLength);
+    }
+    const file = this.jsFiles.get(path);
+    if (!file || id < 0 || id >= file.kind.length) return '';
+    const base = id * AST_NODE_STRIDE;
+    const start = file.nodes[base + 2];
+    const end = file.nodes[base + 3];
+    return file.source.slice(start, maxLength ? Math.min(end, start + maxLength) : end);
+  }
+
+  stats(): AstArenaStats {
+    if (this.nativeArena) {
+      return this.nativeArena.stats();
+    }
+    let nodes = 0;
+    let sourceBytes = 0;
+    let nodeBytes = 0;
+    for (const file of this.jsFiles.values()) {
+      nodes += file.kind.length;
+      sourceBytes += file.source.length * 2;
+      nodeBytes += file.kind.length * (2 + 1 + 4 * (5 + AST_NODE_STRIDE));
+    }
+    return {
+      files: this.jsFiles.size,
+      nodes,
+      kinds: this.kindNames.length,
+      names: this.names.length,
+      sourceBytes,
+      nodeBytes,
+    };
+  }
+
+  clear(): void {
+    if (this.nativeArena) {
+      this.nativeArena.clear();
+      return;
+    }
+    this.jsFiles.clear();
+    this.kindNames = [];
+    this.kindIndex.clear();
+    this.names = [];
+    this.nameIndex.clear();
+  }
+
+  /**
+   * Check if using native implementation
+   */
+  isNative(): boolean {
+    return this.nativeArena !== null;
+  }
+}
+
 /**
  * Semantic Code Chunker class
  * Uses native implementation when available, falls back to JS
@@ -318,6 +1473,7 @@ function jsChunk(source: string, options: ChunkerConfig = {}): ChunkResult {
 export class SemanticChunker {
   private config: ChunkerConfig;
   private nativeChunker: NativeChunker | null = null;
+  private identifierIndex: IdentifierIndex | null = null;
 
   constructor(config: ChunkerConfig = {}) {
     this.config = {
@@ -337,20 +1493,31 @@ export class SemanticChunker {
 
   /**
    * Chunk source code into semantic pieces
+   * @param contentHash FileEntry content hash; enables the attached cache
+   * @param fileFlags FileEntry flags; saves classifying the file again
    */
-  chunk(source: string, filepath?: string): ChunkResult {
+  chunk(source: string, filepath?: string, contentHash?: string, fileFlags?: number): ChunkResult {
     if (this.nativeChunker) {
-      return this.nativeChunker.chunk(source, filepath);
+      return this.nativeChunker.chunk(source, filepath, contentHash, fileFlags);
     }
-    return jsChunk(source, this.config);
+    if (this.identifierIndex && filepath) {
+      this.identifierIndex.updateFile(filepath, source, this.config.language, contentHash);
+    }
+    return jsChunk(source, this.config, filepath);
   }
 
   /**
    * Chunk a file using memory-mapped reading
+   * @param contentHash FileEntry content hash; a cache hit skips reading the file
+   * @param fileFlags FileEntry flags; binary files are skipped without reading
    */
-  chunkFile(filepath: string): ChunkResult {
+  chunkFile(filepath: string, contentHash?: string, fileFlags?: number): ChunkResult {
     if (this.nativeChunker) {
-      return this.nativeChunker.chunkFile(filepath);
+      return this.nativeChunker.chunkFile(filepath, contentHash, fileFlags);
+    }
+    if (this.config.classifyFiles === true && fileFlags !== undefined &&
+        (fileFlags & FILE_FLAG_CLASSIFIED) && (fileFlags & FILE_FLAGS_SKIPPED)) {
+      return { chunks: [], totalTokens: 0, totalLines: 0, chunkingTimeMs: 0, fileFlags, skipped: true };
     }
     // JS fallback: read file normally
     const fs = require('fs');
@@ -358,6 +1525,85 @@ export class SemanticChunker {
     return this.chunk(source, filepath);
   }
 
+  /**
+   * Chunk a file and return the compact binary export (see exportChunks)
+   * Avoids materializing chunk objects when only a delta is needed
+   */
+  chunkFileExport(filepath: string, contentHash?: string, fileFlags?: number): Buffer {
+    if (this.nativeChunker) {
+      return this.nativeChunker.chunkFileExport(filepath, contentHash, fileFlags);
+    }
+    return exportChunks(this.chunkFile(filepath, contentHash, fileFlags), filepath);
+  }
+
+  /**
+   * Chunk files and pack the embedding text of all chunks into one buffer
+   * The JS fallback only collapses whitespace and adds the file path
+   */
+  embedFiles(filepaths: string[], contentHashes?: string[], fileFlags?: number[]): EmbeddingBatch {
+    if (this.nativeChunker) {
+      return this.nativeChunker.embedFiles(filepaths, contentHashes, fileFlags);
+    }
+
+    const texts: Buffer[] = [];
+    const tokenCounts: number[] = [];
+    const fileIndex: number[] = [];
+    const ids: string[] = [];
+    const errors: { filepath: string; error: string }[] = [];
+
+    filepaths.forEach((filepath, i) => {
+      let result: ChunkResult;
+      try {
+        result = this.chunkFile(filepath, undefined, fileFlags?.[i]);
+      } catch (e) {
+        errors.push({ filepath, error: (e as Error).message });
+        return;
+      }
+      for (const c of result.chunks) {
+        const body = c.content.split('\n').map(l => l.trim()).filter(Boolean).join('\n');
+        const text = this.config.embedContextHeader === false ? body : `File: ${filepath}\n\n${body}`;
+        texts.push(Buffer.from(text, 'utf-8'));
+        tokenCounts.push(jsCountTokens(text));
+        fileIndex.push(i);
+        ids.push(c.id);
+      }
+    });
+
+    const offsets = new Uint32Array(texts.length + 1);
+    for (let i = 0; i < texts.length; i++) {
+      offsets[i + 1] = offsets[i] + texts[i].length;
+    }
+
+    return {
+      text: Buffer.concat(texts),
+      offsets,
+      tokenCounts: Uint32Array.from(tokenCounts),
+      fileIndex: Uint32Array.from(fileIndex),
+      ids,
+      errors,
+    };
+  }
+
+  /**
+   * Attach a chunk cache (null detaches)
+   */
+  setCache(cache: ChunkCache | null): void {
+    if (this.nativeChunker) {
+      this.nativeChunker.setCache(cache ? cache.getNative() : null);
+    }
+  }
+
+  /**
+   * Record identifier occurrences of every chunked file (null detaches)
+   * Cache hits still index files the index has not seen at that content hash
+   */
+  setIdentifierIndex(index: IdentifierIndex | null): void {
+    this.identifierIndex = index;
+    if (this.nativeChunker) {
+      this.nativeChunker.setIdentifierIndex(index ? index.getNative() : null);
+    }
+  }
+
   /**
    * Update configuration
    */
@@ -390,7 +1636,7 @@ export function chunk(source: string, options?: ChunkerConfig & { filepath?: str
   if (nativeModule) {
     return nativeModule.chunk(source, options);
   }
-  return jsChunk(source, options);
+  return jsChunk(source, options, options?.filepath);
 }
 
 /**
@@ -402,7 +1648,292 @@ export function chunkFile(filepath: string, options?: ChunkerConfig): ChunkResul
   }
   const fs = require('fs');
   const source = fs.readFileSync(filepath, 'utf-8');
-  return jsChunk(source, options);
+  return jsChunk(source, options, filepath);
+}
+
+/**
+ * Stream chunks of a file with bounded memory
+ *
+ * The native implementation chunks the memory-mapped file one window at a
+ * time; the JS fallback reads the whole file.
+ */
+export async function* streamChunks(
+  filepath: string,
+  options?: ChunkerConfig
+): AsyncGenerator<CodeChunk, void, undefined> {
+  if (nativeModule) {
+    const stream = new nativeModule.ChunkStream(filepath, options);
+    let batch: CodeChunk[] | null;
+    while ((batch = await stream.nextBatch()) !== null) {
+      yield* batch;
+    }
+    return;
+  }
+  const result = chunkFile(filepath, options);
+  const pool = result.embedText;
+  for (const chunk of result.chunks) {
+    if (pool && chunk.embedOffset !== undefined && chunk.embedLength !== undefined) {
+      chunk.embedText = pool.toString('utf-8', chunk.embedOffset, chunk.embedOffset + chunk.embedLength);
+    }
+    yield chunk;
+  }
+}
+
+/**
+ * Export a file's chunks in a compact binary form to keep between runs
+ * The JS fallback encodes JSON; buffers are not interchangeable with native ones
+ */
+export function exportChunks(result: ChunkResult, filepath: string): Buffer {
+  if (nativeModule) {
+    return nativeModule.exportChunks(result, filepath);
+  }
+  return Buffer.from(JSON.stringify({ ...result, filepath }), 'utf-8');
+}
+
+/**
+ * Read a buffer produced by exportChunks or chunkFileExport
+ */
+export function importChunks(data: Buffer): ChunkResult & { filepath: string } {
+  if (nativeModule) {
+    return nativeModule.importChunks(data);
+  }
+  return JSON.parse(data.toString('utf-8'));
+}
+
+/**
+ * Compute upsert/update/delete sets between two chunkings of one file
+ * Either side may be a ChunkResult or an exported buffer
+ */
+export function diffChunks(before: ChunkResult | Buffer, after: ChunkResult | Buffer): ChunkDelta {
+  if (nativeModule) {
+    return nativeModule.diffChunks(before, after);
+  }
+
+  const oldChunks = Buffer.isBuffer(before) ? importChunks(before).chunks : before.chunks;
+  const newChunks = Buffer.isBuffer(after) ? importChunks(after).chunks : after.chunks;
+  const oldById = new Map(oldChunks.map(c => [c.id, c]));
+  const seen = new Set<string>();
+  const delta: ChunkDelta = { upserts: [], updates: [], deletes: [], unchanged: 0 };
+
+  for (const chunk of newChunks) {
+    seen.add(chunk.id);
+    const old = oldById.get(chunk.id);
+    if (!old) {
+      delta.upserts.push(chunk);
+    } else if (
+      old.hash !== chunk.hash ||
+      old.location.lineStart !== chunk.location.lineStart ||
+      old.location.lineEnd !== chunk.location.lineEnd ||
+      old.location.byteOffset !== chunk.location.byteOffset ||
+      old.location.byteLength !== chunk.location.byteLength ||
+      old.context.namespaceName !== chunk.context.namespaceName
+    ) {
+      delta.updates.push(chunk);
+    } else {
+      delta.unchanged++;
+    }
+  }
+
+  for (const chunk of oldChunks) {
+    if (!seen.has(chunk.id)) {
+      delta.deletes.push(chunk.id);
+    }
+  }
+
+  return delta;
+}
+
+/**
+ * Compare the symbol hashes of two versions of one file
+ * Either side may be a symbol list, a ChunkResult or an exported buffer
+ */
+export function diffSymbols(before: SymbolSource, after: SymbolSource): SymbolDelta {
+  if (nativeModule) {
+    return nativeModule.diffSymbols(before, after);
+  }
+
+  const symbolsOf = (source: SymbolSource): SymbolHash[] => {
+    if (Array.isArray(source)) return source;
+    if (Buffer.isBuffer(source)) return importChunks(source).symbols ?? [];
+    return source.symbols ?? [];
+  };
+  const oldSymbols = symbolsOf(before);
+  const newSymbols = symbolsOf(after);
+  const oldByName = new Map<string, number>();
+  oldSymbols.forEach((s, i) => oldByName.set(s.qualifiedName, i));
+
+  const delta: SymbolDelta = { added: [], removed: [], changed: [], moved: [], unchanged: 0 };
+  const matched = new Set<number>();
+  const unmatched: SymbolHash[] = [];
+
+  for (const symbol of newSymbols) {
+    const i = oldByName.get(symbol.qualifiedName);
+    if (i === undefined || matched.has(i)) {
+      unmatched.push(symbol);
+      continue;
+    }
+    const old = oldSymbols[i];
+    matched.add(i);
+    if (old.hash !== symbol.hash) {
+      delta.changed.push({ before: old, after: symbol });
+    } else if (old.lineStart !== symbol.lineStart || old.lineEnd !== symbol.lineEnd) {
+      delta.moved.push({ before: old, after: symbol });
+    } else {
+      delta.unchanged++;
+    }
+  }
+
+  // Leftovers with an equal body moved to another scope
+  for (const symbol of unmatched) {
+    const i = oldSymbols.findIndex((s, j) => !matched.has(j) && s.hash === symbol.hash);
+    if (i >= 0) {
+      matched.add(i);
+      delta.moved.push({ before: oldSymbols[i], after: symbol });
+    } else {
+      delta.added.push(symbol);
+    }
+  }
+
+  oldSymbols.forEach((s, i) => {
+    if (!matched.has(i)) delta.removed.push(s);
+  });
+
+  return delta;
+}
+
+/**
+ * Row accessors over SymbolTableColumns
+ */
+export class SymbolTable {
+  readonly files: string[];
+  readonly columns: SymbolTableColumns;
+
+  constructor(files: string[], columns: SymbolTableColumns) {
+    this.files = files;
+    this.columns = columns;
+  }
+
+  get size(): number {
+    return this.columns.kind.length;
+  }
+
+  name(row: number): string {
+    const { names, nameOffsets } = this.columns;
+    return names.toString('utf-8', nameOffsets[row], nameOffsets[row + 1]);
+  }
+
+  kind(row: number): ChunkType {
+    return CHUNK_TYPES[this.columns.kind[row]] ?? 'unknown';
+  }
+
+  isExported(row: number): boolean {
+    return (this.columns.flags[row] & SYMBOL_FLAG_EXPORTED) !== 0;
+  }
+
+  /** Enclosing symbol row, -1 at top level */
+  parent(row: number): number {
+    return this.columns.parent[row];
+  }
+
+  filePath(row: number): string {
+    return this.files[this.columns.file[row]];
+  }
+
+  /** Rows of one input file: [start, end) */
+  rows(fileIndex: number): [number, number] {
+    const { fileOffsets } = this.columns;
+    return [fileOffsets[fileIndex], fileOffsets[fileIndex + 1]];
+  }
+}
+
+/**
+ * Extract the symbols of many files in parallel, without building ASTs
+ * Native only: the JS fallback returns an empty table, so callers should
+ * keep their own extraction when isNativeAvailable() is false
+ */
+export function buildSymbolTable(filepaths: string[], options?: SymbolTableOptions): SymbolTable {
+  if (nativeModule) {
+    return new SymbolTable(filepaths, nativeModule.buildSymbolTable(filepaths, options));
+  }
+  return new SymbolTable(filepaths, {
+    file: new Uint32Array(0),
+    kind: new Uint8Array(0),
+    flags: new Uint8Array(0),
+    parent: new Int32Array(0),
+    lineStart: new Uint32Array(0),
+    lineEnd: new Uint32Array(0),
+    byteOffset: new Uint32Array(0),
+    byteLength: new Uint32Array(0),
+    nameOffsets: new Uint32Array(1),
+    names: Buffer.alloc(0),
+    fileOffsets: new Uint32Array(filepaths.length + 1),
+    fileFlags: new Uint8Array(filepaths.length),
+    languages: filepaths.map(() => 'unknown' as Language),
+    errors: [],
+  });
+}
+
+/**
+ * Select the highest-scoring snippets that fit a token budget
+ * Native: exact token counts, greedy refined by a knapsack DP.
+ * JS fallback: estimated token counts, greedy by score density.
+ */
+export function packContext(snippets: ContextSnippet[], options: PackOptions): PackResult {
+  if (nativeModule) {
+    return nativeModule.packContext(snippets, options);
+  }
+
+  const overhead = options.snippetOverhead ?? 0;
+  const tokenCounts = Uint32Array.from(snippets, (s) => jsCountTokens(s.text));
+  const cost = (i: number): number => tokenCounts[i] + overhead;
+
+  // Keep one copy of identical text: pinned first, then the best score
+  const kept = new Map<string, number>();
+  const pinned = snippets.map((s) => s.pinned === true);
+  let duplicates = 0;
+  snippets.forEach((s, i) => {
+    const j = kept.get(s.text);
+    if (j === undefined) {
+      kept.set(s.text, i);
+      return;
+    }
+    duplicates++;
+    const pin = pinned[i] || pinned[j];
+    const best = (pinned[i] && !pinned[j]) || (pinned[i] === pinned[j] && s.score > snippets[j].score) ? i : j;
+    pinned[best] = pin;
+    kept.set(s.text, best);
+  });
+  const alive = [...kept.values()];
+
+  const overlaps = (a: ContextSnippet, b: ContextSnippet): boolean =>
+    !!a.source && a.source === b.source && !!a.lineStart && !!b.lineStart &&
+    a.lineStart <= Math.max(b.lineStart, b.lineEnd ?? 0) && b.lineStart <= Math.max(a.lineStart, a.lineEnd ?? 0);
+
+  const selected: number[] = [];
+  let totalTokens = 0;
+  let totalScore = 0;
+  const tryAdd = (i: number): void => {
+    if (totalTokens + cost(i) > options.tokenBudget) return;
+    if (selected.some((j) => overlaps(snippets[i], snippets[j]))) return;
+    selected.push(i);
+    totalTokens += cost(i);
+    totalScore += snippets[i].score;
+  };
+
+  alive.filter((i) => pinned[i]).sort((a, b) => a - b).forEach(tryAdd);
+  alive
+    .filter((i) => !pinned[i] && snippets[i].score > 0)
+    .sort((a, b) => snippets[b].score / Math.max(cost(b), 1) - snippets[a].score / Math.max(cost(a), 1) || a - b)
+    .forEach(tryAdd);
+
+  return {
+    selected: Uint32Array.from(selected.sort((a, b) => a - b)),
+    tokenCounts,
+    totalTokens,
+    totalScore,
+    duplicates,
+    exact: false,
+  };
 }
 
 /**
@@ -427,8 +1958,17 @@ export function getVersion(): string {
 
 export default {
   SemanticChunker,
+  ChunkCache,
+  ParseCache,
   chunk,
   chunkFile,
+  streamChunks,
+  exportChunks,
+  importChunks,
+  diffChunks,
+  diffSymbols,
+  buildSymbolTable,
+  packContext,
   countTokens,
   isNativeAvailable,
   getNativeLoadError,
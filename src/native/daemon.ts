@@ -0,0 +1,739 @@
+/**
+ * @file daemon.ts
+ * @description Client for the native indexing daemon
+ * @version 1.0.0
+ *
+ * The daemon (native/daemon) keeps a repository's file index, Merkle tree,
+ * chunk cache and identifier index hot, refreshed from an inotify watch, and
+ * answers over a Unix socket. One daemon serves one root; the socket path is
+ * derived from the root, so every CLI invocation finds the same daemon.
+ * Sockets live in $XDG_RUNTIME_DIR or a private 0700 directory under the
+ * temp dir, never directly in the shared temp dir.
+ */
+
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as net from 'net';
+import * as os from 'os';
+import * as path from 'path';
+import { spawn } from 'child_process';
+import { fileURLToPath } from 'url';
+import { dirname } from 'path';
+import { SharedFileIndex } from './indexer.js';
+import type { FileEntry, FileChange, ChangeType, Language } from './indexer.js';
+import type { ChunkResult, ChunkType, IdentifierOccurrence, CallSite, OccurrenceRole } from './chunker.js';
+
+// ESM compatibility: get __dirname equivalent
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+
+// Types
+export interface DaemonOptions {
+  /** Socket path (default: derived from the root, see defaultSocketPath) */
+  socketPath?: string;
+  /** Only index matching files */
+  includePatterns?: string[];
+  /** Skip matching files (replaces the indexer defaults) */
+  excludePatterns?: string[];
+  /** Hashing and indexing threads */
+  workers?: number;
+  /** Chunk cache budget in MB (default 256) */
+  cacheMb?: number;
+  /** Classify format-only modifications in diffs */
+  semanticHash?: boolean;
+  /** Build the identifier index for search (default true) */
+  search?: boolean;
+  /** Also publish the file index to this SharedFileIndex segment ("shm:<name>" or a path) */
+  sharedIndex?: string;
+  /** How long to wait for the initial index, in ms (default 120000) */
+  startTimeoutMs?: number;
+}
+
+export interface DaemonStatus {
+  root: string;
+  generation: number;
+  files: number;
+  merkleRoot: string;
+  /** false when the tree is rescanned on demand instead (no inotify, or watch limit reached) */
+  watching: boolean;
+  watches: number;
+  identifierFiles: number;
+  identifiers: number;
+  occurrences: number;
+  chunkCacheHits: number;
+  chunkCacheMisses: number;
+  chunkCacheEntries: number;
+  uptimeMs: number;
+  startupMs: number;
+  /** Options the daemon was started with */
+  includePatterns: string[];
+  excludePatterns: string[];
+  semanticHash: boolean;
+  search: boolean;
+  sharedIndex: string;
+}
+
+export interface DaemonScan {
+  /** Pass to diff() to get the changes after this scan */
+  generation: number;
+  merkleRoot: string;
+  files: FileEntry[];
+}
+
+export interface DaemonDiff {
+  generation: number;
+  /** false when the changes since that generation are no longer logged: scan() again */
+  complete: boolean;
+  changes: FileChange[];
+}
+
+export interface DaemonSearchOptions {
+  /** Roles to include (default: all) */
+  roles?: OccurrenceRole[];
+  /** Only this file */
+  file?: string;
+  /** Max hits returned (default: all) */
+  limit?: number;
+}
+
+export interface DaemonSearchResult<T> {
+  /** Hits before the limit */
+  total: number;
+  hits: T[];
+}
+
+// Wire protocol, see native/daemon/include/daemon.h
+const PROTOCOL_VERSION = 2;
+const FRAME_HEADER_SIZE = 9;
+
+const Opcode = {
+  PING: 1,
+  STATUS: 2,
+  SCAN: 3,
+  DIFF: 4,
+  CHUNK: 5,
+  SEARCH: 6,
+  SHUTDOWN: 7,
+} as const;
+
+const SearchMode = {
+  OCCURRENCES: 0,
+  CALL_SITES: 1,
+  CALLEES: 2,
+} as const;
+
+const CHUNK_SKIPPED = 1;
+const CHUNK_DEGRADED = 2;
+
+// Native enum values
+const LANGUAGES: Language[] = [
+  'unknown', 'javascript', 'typescript', 'python', 'rust', 'go', 'java',
+  'cpp', 'c', 'csharp', 'ruby', 'php', 'swift', 'kotlin',
+];
+
+const CHUNK_TYPES: ChunkType[] = [
+  'unknown', 'function', 'class', 'struct', 'interface', 'enum',
+  'module', 'import', 'export', 'comment', 'block', 'statement',
+];
+
+const CHANGE_TYPES: ChangeType[] = ['added', 'modified', 'deleted', 'renamed'];
+
+const ROLE_BITS: Record<OccurrenceRole, number> = { reference: 1, definition: 2, import: 4 };
+
+function roleName(bits: number): OccurrenceRole {
+  if (bits === ROLE_BITS.definition) return 'definition';
+  if (bits === ROLE_BITS.import) return 'import';
+  return 'reference';
+}
+
+class PayloadWriter {
+  private parts: Buffer[] = [];
+
+  u8(value: number): this {
+    this.parts.push(Buffer.from([value & 0xff]));
+    return this;
+  }
+
+  varint(value: number): this {
+    const bytes: number[] = [];
+    let rest = Math.max(0, Math.floor(value));
+    while (rest >= 0x80) {
+      bytes.push((rest % 0x80) | 0x80);
+      rest = Math.floor(rest / 0x80);
+    }
+    bytes.push(rest);
+    this.parts.push(Buffer.from(bytes));
+    return this;
+  }
+
+  str(value: string): this {
+    const bytes = Buffer.from(value, 'utf-8');
+    this.varint(bytes.length);
+    this.parts.push(bytes);
+    return this;
+  }
+
+  data(): Buffer {
+    return Buffer.concat(this.parts);
+  }
+}
+
+class PayloadReader {
+  private pos = 0;
+
+  constructor(private readonly data: Buffer) {}
+
+  u8(): number {
+    if (this.pos >= this.data.length) throw new Error('Truncated daemon reply');
+    return this.data[this.pos++];
+  }
+
+  /** Fixed 8-byte hash as a decimal string, like FileEntry.contentHash */
+  u64(): string {
+    if (this.pos + 8 > this.data.length) throw new Error('Truncated daemon reply');
+    const value = this.data.readBigUInt64LE(this.pos);
+    this.pos += 8;
+    return value.toString();
+  }
+
+  varint(): number {
+    let value = 0;
+    let scale = 1;
+    for (;;) {
+      const byte = this.u8();
+      value += (byte & 0x7f) * scale;
+      if (byte < 0x80) return value;
+      scale *= 0x80;
+    }
+  }
+
+  str(): string {
+    const length = this.varint();
+    if (this.pos + length > this.data.length) throw new Error('Truncated daemon reply');
+    const value = this.data.toString('utf-8', this.pos, this.pos + length);
+    this.pos += length;
+    return value;
+  }
+
+  /** Varint count, then that many strings */
+  strings(): string[] {
+    const values: string[] = [];
+    for (let n = this.varint(); n > 0; n--) values.push(this.str());
+    return values;
+  }
+}
+
+interface PendingRequest {
+  resolve: (reply: PayloadReader) => void;
+  reject: (error: Error) => void;
+}
+
+/**
+ * Whether the daemon can run on this platform (Unix sockets)
+ */
+export function isDaemonSupported(): boolean {
+  return process.platform !== 'win32';
+}
+
+/**
+ * Whether a directory exists, is not a symlink, belongs to uid and is closed to others
+ */
+function isPrivateDir(dir: string, uid: number): boolean {
+  try {
+    const stat = fs.lstatSync(dir);
+    return stat.isDirectory() && stat.uid === uid && (stat.mode & 0o077) === 0;
+  } catch {
+    return false;
+  }
+}
+
+/**
+ * Directory for daemon sockets, private to the user
+ * $XDG_RUNTIME_DIR when it is usable, otherwise <tmpdir>/archicore-<uid>,
+ * created 0700. A directory another user created first is refused.
+ */
+function socketDir(): string {
+  const uid = typeof process.getuid === 'function' ? process.getuid() : 0;
+  const runtimeDir = process.env.XDG_RUNTIME_DIR;
+  if (runtimeDir && path.isAbsolute(runtimeDir) && isPrivateDir(runtimeDir, uid)) {
+    return runtimeDir;
+  }
+
+  const dir = path.join(os.tmpdir(), `archicore-${uid}`);
+  try {
+    fs.mkdirSync(dir, { mode: 0o700 });
+  } catch (error) {
+    if ((error as NodeJS.ErrnoException).code !== 'EEXIST') throw error;
+  }
+  if (!isPrivateDir(dir, uid)) {
+    throw new Error(`${dir} is not a private directory owned by this user; remove it or set XDG_RUNTIME_DIR`);
+  }
+  return dir;
+}
+
+/**
+ * Socket path for a root: short enough for sun_path, private to the user
+ */
+export function defaultSocketPath(root: string): string {
+  const digest = crypto.createHash('sha1').update(path.resolve(root)).digest('hex').slice(0, 16);
+  return path.join(socketDir(), `archicore-${digest}.sock`);
+}
+
+/**
+ * Shared index segment for a root, next to its socket
+ * The CLI starts daemons publishing here, and readers look for it here.
+ */
+export function defaultSharedIndexPath(root: string): string {
+  const digest = crypto.createHash('sha1').update(path.resolve(root)).digest('hex').slice(0, 16);
+  return path.join(socketDir(), `archicore-${digest}.idx`);
+}
+
+/**
+ * Attach to the file index a running daemon publishes for a root
+ * @returns null if no daemon serves the root or it publishes nothing there
+ */
+export async function attachSharedIndex(root: string, name?: string): Promise<SharedFileIndex | null> {
+  if (!isDaemonSupported()) return null;
+  const segment = name ?? defaultSharedIndexPath(root);
+  if (!segment.startsWith('shm:') && !fs.existsSync(segment)) return null;
+
+  // A segment outlives a crashed daemon; only trust one whose writer answers
+  const client = await connectDaemon(root);
+  if (!client) return null;
+  try {
+    const status = await client.status();
+    if (status.sharedIndex !== segment) return null;
+    const index = SharedFileIndex.open(segment);
+    if (index && index.epoch() === 0) {
+      index.close();
+      return null;
+    }
+    return index;
+  } catch {
+    return null;
+  } finally {
+    client.close();
+  }
+}
+
+/**
+ * Options of a running daemon that differ from the requested ones
+ */
+function optionMismatches(status: DaemonStatus, options: DaemonOptions): string[] {
+  const same = (a: string[], b: string[]): boolean =>
+    a.length === b.length && a.every((value, i) => value === b[i]);
+  const mismatches: string[] = [];
+  if (!same(status.includePatterns, options.includePatterns ?? [])) mismatches.push('includePatterns');
+  if (!same(status.excludePatterns, options.excludePatterns ?? [])) mismatches.push('excludePatterns');
+  if (status.semanticHash !== (options.semanticHash ?? false)) mismatches.push('semanticHash');
+  if (status.search !== (options.search ?? true)) mismatches.push('search');
+  if (status.sharedIndex !== (options.sharedIndex ?? '')) mismatches.push('sharedIndex');
+  return mismatches;
+}
+
+/**
+ * Locate the archicore_daemon executable built by node-gyp or CMake
+ */
+export function findDaemonBinary(): string | null {
+  const possiblePaths = [
+    '../native/build/Release/archicore_daemon',
+    '../native/build/Debug/archicore_daemon',
+    '../native/build/daemon/archicore_daemon',
+    '../../native/build/Release/archicore_daemon',
+    '../../native/build/Debug/archicore_daemon',
+    '../../native/build/daemon/archicore_daemon',
+  ];
+
+  for (const modulePath of possiblePaths) {
+    const fullPath = path.resolve(__dirname, modulePath);
+    if (fs.existsSync(fullPath)) return fullPath;
+  }
+  return null;
+}
+
+/**
+ * Connection to a running daemon
+ * Requests are pipelined over one socket and answered in order.
+ */
+export class DaemonClient {
+  private pending = new Map<number, PendingRequest>();
+  private buffered: Buffer = Buffer.alloc(0);
+  private nextId = 1;
+  private closedError: Error | null = null;
+
+  private constructor(private readonly socket: net.Socket) {
+    socket.on('data', (data: Buffer) => this.onData(data));
+    socket.on('error', (error: Error) => this.fail(error));
+    socket.on('close', () => this.fail(new Error('Daemon connection closed')));
+  }
+
+  /**
+   * Connect to a daemon socket
+   * @returns null if no daemon is listening
+   */
+  static connect(socketPath: string, timeoutMs = 1000): Promise<DaemonClient | null> {
+    return new Promise(resolve => {
+      const socket = net.createConnection(socketPath);
+      const timer = setTimeout(() => {
+        socket.destroy();
+        resolve(null);
+      }, timeoutMs);
+      socket.once('connect', () => {
+        clearTimeout(timer);
+        resolve(new DaemonClient(socket));
+      });
+      socket.once('error', () => {
+        clearTimeout(timer);
+        resolve(null);
+      });
+    });
+  }
+
+  async ping(): Promise<{ version: number; pid: number }> {
+    const reply = await this.request(Opcode.PING);
+    return { version: reply.varint(), pid: reply.varint() };
+  }
+
+  async status(): Promise<DaemonStatus> {
+    const r = await this.request(Opcode.STATUS);
+    return {
+      root: r.str(),
+      generation: r.varint(),
+      files: r.varint(),
+      merkleRoot: r.u64(),
+      watching: r.u8() !== 0,
+      watches: r.varint(),
+      identifierFiles: r.varint(),
+      identifiers: r.varint(),
+      occurrences: r.varint(),
+      chunkCacheHits: r.varint(),
+      chunkCacheMisses: r.varint(),
+      chunkCacheEntries: r.varint(),
+      uptimeMs: r.varint(),
+      startupMs: r.varint(),
+      includePatterns: r.strings(),
+      excludePatterns: r.strings(),
+      semanticHash: r.u8() !== 0,
+      search: r.u8() !== 0,
+      sharedIndex: r.str(),
+    };
+  }
+
+  /**
+   * Indexed files, sorted by path
+   * @param prefix Only files under this directory (relative to the root)
+   */
+  async scan(prefix = ''): Promise<DaemonScan> {
+    const r = await this.request(Opcode.SCAN, new PayloadWriter().str(prefix).data());
+    const generation = r.varint();
+    const merkleRoot = r.u64();
+    const count = r.varint();
+    const files: FileEntry[] = [];
+    for (let i = 0; i < count; i++) {
+      const filePath = r.str();
+      const contentHash = r.u64();
+      const size = r.varint();
+      const mtime = r.varint();
+      const language = LANGUAGES[r.u8()] ?? 'unknown';
+      const flags = r.u8();
+      const semanticHash = r.u64();
+      files.push({
+        path: filePath,
+        contentHash,
+        size,
+        mtime,
+        language,
+        isIndexed: false,
+        flags,
+        ...(semanticHash !== '0' ? { semanticHash } : {}),
+      });
+    }
+    return { generation, merkleRoot, files };
+  }
+
+  /**
+   * Net changes since a generation from scan(), diff() or status()
+   */
+  async diff(since: number): Promise<DaemonDiff> {
+    const r = await this.request(Opcode.DIFF, new PayloadWriter().varint(since).data());
+    const generation = r.varint();
+    const complete = r.u8() !== 0;
+    const count = r.varint();
+    const changes: FileChange[] = [];
+    for (let i = 0; i < count; i++) {
+      const type = CHANGE_TYPES[r.u8()] ?? 'modified';
+      const kind = r.u8();
+      const filePath = r.str();
+      const oldPath = r.str();
+      const change: FileChange = { type, path: filePath, oldHash: r.u64(), newHash: r.u64() };
+      if (oldPath) change.oldPath = oldPath;
+      if (type === 'modified') change.kind = kind === 1 ? 'format_only' : 'semantic';
+      changes.push(change);
+    }
+    return { generation, complete, changes };
+  }
+
+  /**
+   * Chunk an indexed file (relative or absolute path), from cache when unchanged
+   */
+  async chunk(file: string): Promise<ChunkResult> {
+    const r = await this.request(Opcode.CHUNK, new PayloadWriter().str(file).data());
+    const language = LANGUAGES[r.u8()] ?? 'unknown';
+    const fileFlags = r.u8();
+    const resultFlags = r.u8();
+    const totalTokens = r.varint();
+    const totalLines = r.varint();
+    const chunkingTimeMs = r.varint() / 1000;
+    const count = r.varint();
+    const chunks: ChunkResult['chunks'] = [];
+    for (let i = 0; i < count; i++) {
+      const content = r.str();
+      const tokenCount = r.varint();
+      const location = {
+        lineStart: r.varint(),
+        lineEnd: r.varint(),
+        columnStart: r.varint(),
+        columnEnd: r.varint(),
+        byteOffset: r.varint(),
+        byteLength: r.varint(),
+      };
+      const type = CHUNK_TYPES[r.u8()] ?? 'unknown';
+      const parentName = r.str();
+      const namespaceName = r.str();
+      const imports: string[] = [];
+      for (let n = r.varint(); n > 0; n--) imports.push(r.str());
+      const chunkIndex = r.varint();
+      const hash = r.str();
+      const id = r.str();
+      chunks.push({
+        content,
+        tokenCount,
+        location,
+        type,
+        context: { parentName, namespaceName, imports },
+        chunkIndex,
+        hash,
+        id,
+      });
+    }
+    return {
+      chunks,
+      totalTokens,
+      totalLines,
+      chunkingTimeMs,
+      language,
+      fileFlags,
+      degraded: (resultFlags & CHUNK_DEGRADED) !== 0,
+      skipped: (resultFlags & CHUNK_SKIPPED) !== 0,
+    };
+  }
+
+  /**
+   * Occurrences of an identifier across the repository
+   */
+  async occurrences(name: string, options: DaemonSearchOptions = {}): Promise<DaemonSearchResult<IdentifierOccurrence>> {
+    const roles = (options.roles ?? []).reduce((bits, role) => bits | ROLE_BITS[role], 0);
+    const r = await this.search(name, SearchMode.OCCURRENCES, roles, options);
+    const total = r.varint();
+    const hits: IdentifierOccurrence[] = [];
+    for (let n = r.varint(); n > 0; n--) {
+      const file = r.str();
+      const offset = r.varint();
+      const line = r.varint();
+      const column = r.varint();
+      const role = roleName(r.u8());
+      r.str();
+      r.str();
+      hits.push({ file, offset, line, column, role });
+    }
+    return { total, hits };
+  }
+
+  /**
+   * Calls of a function
+   */
+  async callSites(name: string, options: DaemonSearchOptions = {}): Promise<DaemonSearchResult<CallSite>> {
+    return this.calls(name, SearchMode.CALL_SITES, options);
+  }
+
+  /**
+   * Calls made inside functions with this name
+   */
+  async callees(name: string, options: DaemonSearchOptions = {}): Promise<DaemonSearchResult<CallSite>> {
+    return this.calls(name, SearchMode.CALLEES, options);
+  }
+
+  /**
+   * Stop the daemon; the connection closes once it has answered
+   */
+  async shutdown(): Promise<void> {
+    await this.request(Opcode.SHUTDOWN);
+  }
+
+  close(): void {
+    this.socket.end();
+  }
+
+  private async calls(name: string, mode: number, options: DaemonSearchOptions): Promise<DaemonSearchResult<CallSite>> {
+    const r = await this.search(name, mode, 0, options);
+    const total = r.varint();
+    const hits: CallSite[] = [];
+    for (let n = r.varint(); n > 0; n--) {
+      const file = r.str();
+      const offset = r.varint();
+      const line = r.varint();
+      const column = r.varint();
+      r.u8();
+      const callee = r.str();
+      const caller = r.str();
+      hits.push({ file, offset, line, column, callee, caller: caller || null });
+    }
+    return { total, hits };
+  }
+
+  private search(name: string, mode: number, roles: number, options: DaemonSearchOptions): Promise<PayloadReader> {
+    const payload = new PayloadWriter()
+      .str(name)
+      .u8(mode)
+      .u8(roles)
+      .str(options.file ?? '')
+      .varint(options.limit ?? 0)
+      .data();
+    return this.request(Opcode.SEARCH, payload);
+  }
+
+  private request(opcode: number, payload: Buffer = Buffer.alloc(0)): Promise<PayloadReader> {
+    if (this.closedError) return Promise.reject(this.closedError);
+
+    const id = this.nextId;
+    this.nextId = (this.nextId % 0xffffffff) + 1;
+    const header = Buffer.alloc(FRAME_HEADER_SIZE);
+    header.writeUInt32LE(payload.length, 0);
+    header.writeUInt8(opcode, 4);
+    header.writeUInt32LE(id, 5);
+
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { resolve, reject });
+      this.socket.write(Buffer.concat([header, payload]));
+    });
+  }
+
+  private onData(data: Buffer): void {
+    this.buffered = this.buffered.length === 0 ? data : Buffer.concat([this.buffered, data]);
+
+    let offset = 0;
+    while (this.buffered.length - offset >= FRAME_HEADER_SIZE) {
+      const length = this.buffered.readUInt32LE(offset);
+      if (this.buffered.length - offset < FRAME_HEADER_SIZE + length) break;
+      const status = this.buffered.readUInt8(offset + 4);
+      const id = this.buffered.readUInt32LE(offset + 5);
+      const body = this.buffered.subarray(offset + FRAME_HEADER_SIZE, offset + FRAME_HEADER_SIZE + length);
+      offset += FRAME_HEADER_SIZE + length;
+
+      const request = this.pending.get(id);
+      if (!request) continue;
+      this.pending.delete(id);
+      const reader = new PayloadReader(body);
+      if (status === 0) {
+        request.resolve(reader);
+      } else {
+        request.reject(new Error(`Daemon: ${reader.str()}`));
+      }
+    }
+    this.buffered = this.buffered.subarray(offset);
+  }
+
+  private fail(error: Error): void {
+    if (!this.closedError) this.closedError = error;
+    for (const request of this.pending.values()) request.reject(error);
+    this.pending.clear();
+  }
+}
+
+/**
+ * Connect to the daemon serving a root, if one is running
+ */
+export async function connectDaemon(root: string, socketPath?: string): Promise<DaemonClient | null> {
+  if (!isDaemonSupported()) return null;
+  return DaemonClient.connect(socketPath ?? defaultSocketPath(root));
+}
+
+/**
+ * Connect to the daemon serving a root, starting one if none is running
+ * Resolves once the initial index is built.
+ */
+export async function startDaemon(root: string, options: DaemonOptions = {}): Promise<DaemonClient> {
+  if (!isDaemonSupported()) {
+    throw new Error('The indexing daemon needs Unix domain sockets');
+  }
+  const rootDir = path.resolve(root);
+  const socketPath = options.socketPath ?? defaultSocketPath(rootDir);
+  const timeoutMs = options.startTimeoutMs ?? 120000;
+
+  const existing = await DaemonClient.connect(socketPath);
+  if (existing) {
+    const { version } = await existing.ping();
+    if (version !== PROTOCOL_VERSION) {
+      existing.close();
+      throw new Error(`Daemon on ${socketPath} speaks protocol ${version}, expected ${PROTOCOL_VERSION}`);
+    }
+    // Its index reflects the options it was started with; serving other ones silently would be wrong
+    const mismatches = optionMismatches(await existing.status(), options);
+    if (mismatches.length > 0) {
+      existing.close();
+      throw new Error(
+        `Daemon on ${socketPath} was started with different options (${mismatches.join(', ')}); ` +
+        'shut it down first or pass another socketPath'
+      );
+    }
+    return existing;
+  }
+
+  const binary = findDaemonBinary();
+  if (!binary) {
+    throw new Error('archicore_daemon is not built (run: npm run build:native)');
+  }
+
+  const args = [rootDir, '--socket', socketPath];
+  for (const pattern of options.includePatterns ?? []) args.push('--include', pattern);
+  for (const pattern of options.excludePatterns ?? []) args.push('--exclude', pattern);
+  if (options.workers) args.push('--workers', String(options.workers));
+  if (options.cacheMb) args.push('--cache-mb', String(options.cacheMb));
+  if (options.semanticHash) args.push('--semantic-hash');
+  if (options.search === false) args.push('--no-search');
+  if (options.sharedIndex) args.push('--shared-index', options.sharedIndex);
+
+  const child = spawn(binary, args, { detached: true, stdio: ['ignore', 'ignore', 'pipe'] });
+  let stderr = '';
+  const exit: { code: number | null } = { code: null };
+  child.stderr?.on('data', (data: Buffer) => { stderr += data.toString(); });
+  child.on('exit', code => { exit.code = code ?? 1; });
+
+  try {
+    // The socket accepts as soon as it is bound; PING is answered once the index is built
+    const deadline = Date.now() + timeoutMs;
+    while (Date.now() < deadline) {
+      if (exit.code !== null) {
+        throw new Error(stderr.trim() || `archicore_daemon exited with code ${exit.code}`);
+      }
+      const client = await DaemonClient.connect(socketPath, 250);
+      if (client) {
+        let timer: NodeJS.Timeout | undefined;
+        const ready = await Promise.race([
+          client.ping().then(() => true, () => false),
+          new Promise<false>(resolve => { timer = setTimeout(() => resolve(false), Math.max(0, deadline - Date.now())); }),
+        ]);
+        clearTimeout(timer);
+        if (ready) return client;
+        client.close();
+        continue;
+      }
+      await new Promise(resolve => setTimeout(resolve, 50));
+    }
+    child.kill();
+    throw new Error(`archicore_daemon did not become ready within ${timeoutMs} ms`);
+  } finally {
+    child.stderr?.destroy();
+    child.unref();
+  }
+}
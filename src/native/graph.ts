@@ -0,0 +1,1469 @@
+/**
+ * @file graph.ts
+ * @description TypeScript wrapper for native Dependency Graph Engine
+ * @version 1.0.0
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import { fileURLToPath } from 'url';
+import { dirname } from 'path';
+import { createRequire } from 'module';
+
+// ESM compatibility: get __dirname and require equivalents
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const require = createRequire(import.meta.url);
+
+// Types
+export interface ReachabilityConfig {
+  /** Max strongly connected components for the bitset closure (default 16384) */
+  closureLimit?: number;
+}
+
+export interface ReachabilityEdge {
+  /** Dependent node */
+  from: string;
+  /** Dependency node */
+  to: string;
+}
+
+export interface AffectedEntry {
+  id: string;
+  /** Edges from the nearest changed node (0 = changed itself) */
+  distance: number;
+}
+
+export interface ReachabilityStats {
+  nodeCount: number;
+  edgeCount: number;
+  componentCount: number;
+  largestComponent: number;
+  hasClosure: boolean;
+  closureBytes: number;
+  rebuilds: number;
+  buildTimeMs: number;
+}
+
+export interface AnalyticsConfig {
+  /** Worker threads for PageRank and betweenness (default 4) */
+  workers?: number;
+  /** PageRank damping factor (default 0.85) */
+  damping?: number;
+  /** PageRank iteration cap (default 100) */
+  maxIterations?: number;
+  /** PageRank L1 convergence threshold (default 1e-6) */
+  tolerance?: number;
+  /** Sampled betweenness sources; 0 = exact (default 128) */
+  betweennessSamples?: number;
+  /** Source sampling seed (default 42) */
+  seed?: number;
+}
+
+export interface RankedNode {
+  id: string;
+  score: number;
+}
+
+export interface AnalyticsStats {
+  nodeCount: number;
+  edgeCount: number;
+  pageRankIterations: number;
+  betweennessSources: number;
+  buildTimeMs: number;
+  lastRunMs: number;
+}
+
+export interface CycleOptions {
+  /** Total cycles returned (default 50) */
+  maxCycles?: number;
+  /** Cycles kept per strongly connected component (default 10) */
+  maxCyclesPerComponent?: number;
+  /** Max files in a cycle; 0 = unbounded (default 0; maxSteps still bounds the search) */
+  maxLength?: number;
+  /** Edge visits across the whole search (default 2,000,000) */
+  maxSteps?: number;
+}
+
+export interface CycleResult {
+  /** Node sequences, shortest first per component; the first node is not repeated */
+  cycles: string[][];
+  /** Strongly connected components with at least one cycle */
+  cyclicComponents: number;
+  /** A limit stopped the search early */
+  truncated: boolean;
+}
+
+export interface RuleNode {
+  id: string;
+  /** Path matched by glob groups (default: the id) */
+  path?: string;
+}
+
+export interface RuleLayer {
+  /** Group holding the layer's nodes; a node is in the first layer that matches */
+  group: number;
+  /** Indices of layers this layer may depend on */
+  allowed: number[];
+}
+
+export interface RuleHit {
+  /** Rule index */
+  rule: number;
+  from: string;
+  /** Edge rules: the dependency */
+  to?: string;
+  /** Layer rules: layer indices of from and to */
+  sourceLayer?: number;
+  targetLayer?: number;
+  /** Max-dependency rules: dependencies of from */
+  count?: number;
+}
+
+export interface RuleEvaluatorStats {
+  nodeCount: number;
+  edgeCount: number;
+  groupCount: number;
+  ruleCount: number;
+  rulesEvaluated: number;
+  nodesRechecked: number;
+  violationCount: number;
+  evalTimeMs: number;
+}
+
+export type GraphExportFormat = 'json' | 'graphml' | 'csv';
+
+export interface ExportGraphNode {
+  id: string;
+  type: string;
+  filePath: string;
+  name: string;
+  metadata?: {
+    linesOfCode?: number;
+    complexity?: number;
+    domain?: string;
+  };
+}
+
+export interface ExportGraphEdge {
+  to: string;
+  type: string;
+  /** Default 1 */
+  weight?: number;
+}
+
+export interface GraphExporterStats {
+  nodeCount: number;
+  edgeCount: number;
+  /** Estimated size of the exporter's graph copy */
+  memoryBytes: number;
+  /** Output of the current or last export */
+  bytesWritten: number;
+}
+
+/**
+ * Graph of an exported document as columns over one UTF-8 string pool.
+ * String i is strings[stringOffsets[i] .. stringOffsets[i + 1]).
+ */
+export interface ImportedGraphTables {
+  strings: Buffer;
+  stringOffsets: Uint32Array;
+  nodeId: Uint32Array;
+  nodeType: Uint32Array;
+  nodeFilePath: Uint32Array;
+  nodeName: Uint32Array;
+  /** 0xFFFFFFFF = absent */
+  nodeDomain: Uint32Array;
+  /** NaN = absent */
+  nodeLinesOfCode: Float64Array;
+  /** NaN = absent */
+  nodeComplexity: Float64Array;
+  edgeFrom: Uint32Array;
+  edgeTo: Uint32Array;
+  edgeType: Uint32Array;
+  edgeWeight: Float64Array;
+}
+
+export interface ExportReadResult {
+  graph?: ImportedGraphTables | null;
+  /** Other top-level values of the document as raw JSON */
+  sections?: Array<{ key: string; json: string }>;
+  error?: string;
+  errorOffset?: number;
+}
+
+// Native module interface
+interface NativeGraphModule {
+  ReachabilityIndex: new (config?: ReachabilityConfig) => NativeReachabilityIndex;
+  GraphAnalytics: new (config?: AnalyticsConfig) => NativeGraphAnalytics;
+  RuleEvaluator: new () => NativeRuleEvaluator;
+  GraphExporter: new () => NativeGraphExporter;
+  findCycles: (edges: ReachabilityEdge[], options?: CycleOptions) => CycleResult;
+  readExport: (source: Buffer | string) => ExportReadResult;
+  version: string;
+}
+
+interface NativeReachabilityIndex {
+  addNodes(ids: string[]): void;
+  addEdge(from: string, to: string): boolean;
+  addEdges(edges: ReachabilityEdge[]): number;
+  removeEdge(from: string, to: string): boolean;
+  clear(): void;
+  hasNode(id: string): boolean;
+  dependsOn(from: string, to: string): boolean;
+  affected(changed: string[], maxDepth?: number): AffectedEntry[];
+  affectedSet(changed: string[]): string[];
+  stats(): ReachabilityStats;
+}
+
+interface NativeGraphAnalytics {
+  addNodes(ids: string[]): void;
+  addEdges(edges: ReachabilityEdge[]): void;
+  clear(): void;
+  pageRank(limit?: number): RankedNode[];
+  betweenness(limit?: number): RankedNode[];
+  coreNumbers(limit?: number): RankedNode[];
+  stronglyConnected(minSize?: number): string[][];
+  stats(): AnalyticsStats;
+}
+
+interface NativeRuleEvaluator {
+  addNodes(nodes: RuleNode[]): void;
+  setDependencies(from: string, targets: string[]): void;
+  addGlobGroup(globs: string[]): number;
+  addGroup(): number;
+  updateGroup(group: number, add: string[], remove?: string[]): boolean;
+  addForbiddenRule(sourceGroup: number, targetGroup: number): number;
+  addLayerRule(layers: RuleLayer[]): number;
+  addMaxDependenciesRule(limit: number, group?: number): number;
+  evaluate(): RuleHit[];
+  clear(): void;
+  stats(): RuleEvaluatorStats;
+}
+
+interface NativeGraphExporter {
+  addNodes(nodes: ExportGraphNode[]): void;
+  addEdges(from: string, edges: ExportGraphEdge[]): void;
+  begin(format: GraphExportFormat): void;
+  read(maxBytes?: number): Buffer | null;
+  writeFile(filePath: string, format: GraphExportFormat): number;
+  clear(): void;
+  stats(): GraphExporterStats;
+}
+
+// Try to load native module
+let nativeModule: NativeGraphModule | null = null;
+let loadError: Error | null = null;
+
+try {
+  const possiblePaths = [
+    '../native/build/Release/archicore_graph.node',
+    '../native/build/Debug/archicore_graph.node',
+    '../../native/build/Release/archicore_graph.node',
+    '../../native/build/Debug/archicore_graph.node',
+  ];
+
+  for (const modulePath of possiblePaths) {
+    try {
+      const fullPath = path.resolve(__dirname, modulePath);
+      nativeModule = require(fullPath);
+      break;
+    } catch {
+      // Try next path
+    }
+  }
+} catch (e) {
+  loadError = e as Error;
+}
+
+/**
+ * Check if native graph engine is available
+ */
+export function isNativeAvailable(): boolean {
+  return nativeModule !== null;
+}
+
+/**
+ * Get native module load error if any
+ */
+export function getNativeLoadError(): Error | null {
+  return loadError;
+}
+
+/**
+ * Reachability index over a dependency graph.
+ *
+ * An edge from -> to means "from depends on to", so changing `to` affects
+ * `from`. The native index condenses cycles and keeps a transitive closure
+ * for instant dependsOn/affectedSet answers; the fallback keeps reverse
+ * adjacency lists and answers every query with a breadth-first search.
+ */
+export class ReachabilityIndex {
+  private dependents: Map<string, Set<string>> = new Map();
+  private edgeCount = 0;
+  private nativeIndex: NativeReachabilityIndex | null = null;
+
+  constructor(config?: ReachabilityConfig) {
+    if (nativeModule) {
+      this.nativeIndex = new nativeModule.ReachabilityIndex(config);
+    }
+  }
+
+  /**
+   * Build an index from a dependency graph's nodes and edges
+   */
+  static fromGraph(
+    graph: { nodes: Map<string, unknown>; edges: Map<string, ReachabilityEdge[]> },
+    config?: ReachabilityConfig
+  ): ReachabilityIndex {
+    const index = new ReachabilityIndex(config);
+    index.addNodes(Array.from(graph.nodes.keys()));
+    for (const edges of graph.edges.values()) {
+      index.addEdges(edges);
+    }
+    return index;
+  }
+
+  addNodes(ids: string[]): void {
+    if (this.nativeIndex) {
+      this.nativeIndex.addNodes(ids);
+      return;
+    }
+    for (const id of ids) {
+      if (!this.dependents.has(id)) this.dependents.set(id, new Set());
+    }
+  }
+
+  /**
+   * Add a dependency edge; returns false if it already existed
+   */
+  addEdge(from: string, to: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.addEdge(from, to);
+    }
+    this.addNodes([from, to]);
+    const set = this.dependents.get(to)!;
+    if (set.has(from)) return false;
+    set.add(from);
+    this.edgeCount++;
+    return true;
+  }
+
+  /**
+   * Add dependency edges; returns the number of new edges
+   */
+  addEdges(edges: ReachabilityEdge[]): number {
+    if (this.nativeIndex) {
+      return this.nativeIndex.addEdges(edges);
+    }
+    let added = 0;
+    for (const edge of edges) {
+      if (this.addEdge(edge.from, edge.to)) added++;
+    }
+    return added;
+  }
+
+  removeEdge(from: string, to: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.removeEdge(from, to);
+    }
+    const removed = this.dependents.get(to)?.delete(from) ?? false;
+    if (removed) this.edgeCount--;
+    return removed;
+  }
+
+  clear(): void {
+    if (this.nativeIndex) {
+      this.nativeIndex.clear();
+    } else {
+      this.dependents.clear();
+      this.edgeCount = 0;
+    }
+  }
+
+  hasNode(id: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.hasNode(id);
+    }
+    return this.dependents.has(id);
+  }
+
+  /**
+   * Whether `from` transitively depends on `to` (a node depends on itself)
+   */
+  dependsOn(from: string, to: string): boolean {
+    if (this.nativeIndex) {
+      return this.nativeIndex.dependsOn(from, to);
+    }
+    if (!this.dependents.has(from) || !this.dependents.has(to)) return false;
+    return this.jsAffected([to], 0).some((e) => e.id === from);
+  }
+
+  /**
+   * Nodes affected by the changed nodes, in BFS order at their shortest
+   * distance. maxDepth 0 or omitted means unbounded.
+   */
+  affected(changed: string[], maxDepth = 0): AffectedEntry[] {
+    if (this.nativeIndex) {
+      return this.nativeIndex.affected(changed, maxDepth);
+    }
+    return this.jsAffected(changed, maxDepth);
+  }
+
+  /**
+   * All nodes that transitively depend on any changed node, including the
+   * changed nodes themselves
+   */
+  affectedSet(changed: string[]): string[] {
+    if (this.nativeIndex) {
+      return this.nativeIndex.affectedSet(changed);
+    }
+    return this.jsAffected(changed, 0).map((e) => e.id);
+  }
+
+  stats(): ReachabilityStats {
+    if (this.nativeIndex) {
+      return this.nativeIndex.stats();
+    }
+    return {
+      nodeCount: this.dependents.size,
+      edgeCount: this.edgeCount,
+      componentCount: 0,
+      largestComponent: 0,
+      hasClosure: false,
+      closureBytes: 0,
+      rebuilds: 0,
+      buildTimeMs: 0,
+    };
+  }
+
+  isNative(): boolean {
+    return this.nativeIndex !== null;
+  }
+
+  private jsAffected(changed: string[], maxDepth: number): AffectedEntry[] {
+    const result: AffectedEntry[] = [];
+    const seen = new Set<string>();
+
+    for (const id of changed) {
+      if (this.dependents.has(id) && !seen.has(id)) {
+        seen.add(id);
+        result.push({ id, distance: 0 });
+      }
+    }
+
+    // result doubles as the BFS queue
+    for (let head = 0; head < result.length; head++) {
+      const { id, distance } = result[head];
+      if (maxDepth > 0 && distance >= maxDepth) continue;
+      for (const dependent of this.dependents.get(id)!) {
+        if (seen.has(dependent)) continue;
+        seen.add(dependent);
+        result.push({ id: dependent, distance: distance + 1 });
+      }
+    }
+
+    return result;
+  }
+}
+
+/**
+ * Iterative Tarjan over dense node indices; member lists per component
+ */
+function tarjanComponents(successors: Array<Iterable<number>>): number[][] {
+  const n = successors.length;
+  const index = new Int32Array(n).fill(-1);
+  const low = new Int32Array(n);
+  const onStack = new Uint8Array(n);
+  const stack: number[] = [];
+  const groups: number[][] = [];
+  let counter = 0;
+
+  for (let root = 0; root < n; root++) {
+    if (index[root] >= 0) continue;
+    const calls: Array<{ node: number; next: Iterator<number> }> = [];
+    const enter = (node: number) => {
+      index[node] = low[node] = counter++;
+      stack.push(node);
+      onStack[node] = 1;
+      calls.push({ node, next: successors[node][Symbol.iterator]() });
+    };
+    enter(root);
+
+    while (calls.length > 0) {
+      const frame = calls[calls.length - 1];
+      const step = frame.next.next();
+      if (!step.done) {
+        const next = step.value;
+        if (index[next] < 0) {
+          enter(next);
+        } else if (onStack[next]) {
+          low[frame.node] = Math.min(low[frame.node], index[next]);
+        }
+        continue;
+      }
+
+      if (low[frame.node] === index[frame.node]) {
+        const group: number[] = [];
+        let member: number;
+        do {
+          member = stack.pop()!;
+          onStack[member] = 0;
+          group.push(member);
+        } while (member !== frame.node);
+        groups.push(group);
+      }
+
+      calls.pop();
+      if (calls.length > 0) {
+        const parent = calls[calls.length - 1].node;
+        low[parent] = Math.min(low[parent], low[frame.node]);
+      }
+    }
+  }
+
+  return groups;
+}
+
+/**
+ * Whole-graph analytics for hotspot ranking.
+ *
+ * PageRank (rank flows from dependents to dependencies), sampled Brandes
+ * betweenness, strongly connected components and k-core numbers. The
+ * native engine runs over CSR arrays on several threads; the fallback
+ * computes the same results in JavaScript. Duplicate edges and self-loops
+ * are ignored.
+ */
+export class GraphAnalytics {
+  private config: Required<AnalyticsConfig>;
+  private ids: string[] = [];
+  private indexOf: Map<string, number> = new Map();
+  private dependencies: Set<number>[] = [];
+  private dependents: Set<number>[] = [];
+  private nativeAnalytics: NativeGraphAnalytics | null = null;
+
+  constructor(config?: AnalyticsConfig) {
+    this.config = {
+      workers: 4,
+      damping: 0.85,
+      maxIterations: 100,
+      tolerance: 1e-6,
+      betweennessSamples: 128,
+      seed: 42,
+      ...config,
+    };
+    if (nativeModule) {
+      this.nativeAnalytics = new nativeModule.GraphAnalytics(config);
+    }
+  }
+
+  /**
+   * Load a dependency graph's nodes and edges
+   */
+  static fromGraph(
+    graph: { nodes: Map<string, unknown>; edges: Map<string, ReachabilityEdge[]> },
+    config?: AnalyticsConfig
+  ): GraphAnalytics {
+    const analytics = new GraphAnalytics(config);
+    analytics.addNodes(Array.from(graph.nodes.keys()));
+    for (const edges of graph.edges.values()) {
+      analytics.addEdges(edges);
+    }
+    return analytics;
+  }
+
+  addNodes(ids: string[]): void {
+    if (this.nativeAnalytics) {
+      this.nativeAnalytics.addNodes(ids);
+      return;
+    }
+    for (const id of ids) this.node(id);
+  }
+
+  addEdges(edges: ReachabilityEdge[]): void {
+    if (this.nativeAnalytics) {
+      this.nativeAnalytics.addEdges(edges);
+      return;
+    }
+    for (const edge of edges) {
+      const from = this.node(edge.from);
+      const to = this.node(edge.to);
+      if (from === to) continue;
+      this.dependencies[from].add(to);
+      this.dependents[to].add(from);
+    }
+  }
+
+  clear(): void {
+    if (this.nativeAnalytics) {
+      this.nativeAnalytics.clear();
+      return;
+    }
+    this.ids = [];
+    this.indexOf.clear();
+    this.dependencies = [];
+    this.dependents = [];
+  }
+
+  /**
+   * PageRank scores, highest first (limit 0 = all)
+   */
+  pageRank(limit = 0): RankedNode[] {
+    if (this.nativeAnalytics) {
+      return this.nativeAnalytics.pageRank(limit);
+    }
+    return this.rank(this.jsPageRank(), limit);
+  }
+
+  /**
+   * Betweenness centrality, highest first (limit 0 = all)
+   */
+  betweenness(limit = 0): RankedNode[] {
+    if (this.nativeAnalytics) {
+      return this.nativeAnalytics.betweenness(limit);
+    }
+    return this.rank(this.jsBetweenness(), limit);
+  }
+
+  /**
+   * Core numbers of the undirected graph, highest first (limit 0 = all)
+   */
+  coreNumbers(limit = 0): RankedNode[] {
+    if (this.nativeAnalytics) {
+      return this.nativeAnalytics.coreNumbers(limit);
+    }
+    return this.rank(this.jsCoreNumbers(), limit);
+  }
+
+  /**
+   * Strongly connected components with at least minSize members, largest first
+   */
+  stronglyConnected(minSize = 2): string[][] {
+    if (this.nativeAnalytics) {
+      return this.nativeAnalytics.stronglyConnected(minSize);
+    }
+    return tarjanComponents(this.dependencies)
+      .filter((group) => group.length >= minSize)
+      .sort((a, b) => b.length - a.length)
+      .map((group) => group.map((node) => this.ids[node]));
+  }
+
+  stats(): AnalyticsStats {
+    if (this.nativeAnalytics) {
+      return this.nativeAnalytics.stats();
+    }
+    let edgeCount = 0;
+    for (const set of this.dependencies) edgeCount += set.size;
+    return {
+      nodeCount: this.ids.length,
+      edgeCount,
+      pageRankIterations: 0,
+      betweennessSources: 0,
+      buildTimeMs: 0,
+      lastRunMs: 0,
+    };
+  }
+
+  isNative(): boolean {
+    return this.nativeAnalytics !== null;
+  }
+
+  private node(id: string): number {
+    let node = this.indexOf.get(id);
+    if (node === undefined) {
+      node = this.ids.length;
+      this.ids.push(id);
+      this.indexOf.set(id, node);
+      this.dependencies.push(new Set());
+      this.dependents.push(new Set());
+    }
+    return node;
+  }
+
+  private rank(scores: ArrayLike<number>, limit: number): RankedNode[] {
+    const ranked: RankedNode[] = [];
+    for (let i = 0; i < scores.length; i++) {
+      ranked.push({ id: this.ids[i], score: scores[i] });
+    }
+    ranked.sort((a, b) => b.score - a.score);
+    return limit > 0 ? ranked.slice(0, limit) : ranked;
+  }
+
+  private jsPageRank(): Float64Array {
+    const n = this.ids.length;
+    const { damping, maxIterations, tolerance } = this.config;
+    let rank = new Float64Array(n).fill(1 / n);
+    let next = new Float64Array(n);
+
+    for (let iteration = 0; iteration < maxIterations; iteration++) {
+      let dangling = 0;
+      next.fill(0);
+      for (let u = 0; u < n; u++) {
+        const degree = this.dependencies[u].size;
+        if (degree === 0) {
+          dangling += rank[u];
+          continue;
+        }
+        for (const v of this.dependencies[u]) next[v] += rank[u] / degree;
+      }
+
+      const base = (1 - damping) / n + (damping * dangling) / n;
+      let delta = 0;
+      for (let v = 0; v < n; v++) {
+        next[v] = base + damping * next[v];
+        delta += Math.abs(next[v] - rank[v]);
+      }
+      [rank, next] = [next, rank];
+      if (delta < tolerance) break;
+    }
+
+    return rank;
+  }
+
+  private jsBetweenness(): Float64Array {
+    const n = this.ids.length;
+    const centrality = new Float64Array(n);
+    const sources = Array.from({ length: n }, (_, i) => i);
+    const samples = this.config.betweennessSamples;
+
+    if (samples > 0 && samples < n) {
+      // Partial Fisher-Yates with a seeded LCG
+      let state = this.config.seed >>> 0;
+      for (let i = 0; i < samples; i++) {
+        state = (Math.imul(state, 1664525) + 1013904223) >>> 0;
+        const j = i + (state % (n - i));
+        [sources[i], sources[j]] = [sources[j], sources[i]];
+      }
+      sources.length = samples;
+    }
+
+    const sigma = new Float64Array(n);
+    const delta = new Float64Array(n);
+    const dist = new Int32Array(n).fill(-1);
+
+    for (const s of sources) {
+      const order = [s];
+      sigma[s] = 1;
+      dist[s] = 0;
+
+      for (let head = 0; head < order.length; head++) {
+        const v = order[head];
+        for (const w of this.dependencies[v]) {
+          if (dist[w] < 0) {
+            dist[w] = dist[v] + 1;
+            order.push(w);
+          }
+          if (dist[w] === dist[v] + 1) sigma[w] += sigma[v];
+        }
+      }
+
+      for (let k = order.length - 1; k > 0; k--) {
+        const w = order[k];
+        const share = (1 + delta[w]) / sigma[w];
+        for (const v of this.dependents[w]) {
+          if (dist[v] === dist[w] - 1) delta[v] += sigma[v] * share;
+        }
+        centrality[w] += delta[w];
+      }
+
+      for (const v of order) {
+        sigma[v] = 0;
+        delta[v] = 0;
+        dist[v] = -1;
+      }
+    }
+
+    if (sources.length < n) {
+      const scale = n / sources.length;
+      for (let v = 0; v < n; v++) centrality[v] *= scale;
+    }
+    return centrality;
+  }
+
+  private jsCoreNumbers(): Int32Array {
+    const n = this.ids.length;
+    const neighbors = this.dependencies.map((set, u) => new Set([...set, ...this.dependents[u]]));
+    const degree = new Int32Array(n);
+    let maxDegree = 0;
+    for (let u = 0; u < n; u++) {
+      degree[u] = neighbors[u].size;
+      maxDegree = Math.max(maxDegree, degree[u]);
+    }
+
+    // Batagelj-Zaversnik bucket decomposition
+    const bucket = new Int32Array(maxDegree + 2);
+    for (let u = 0; u < n; u++) bucket[degree[u] + 1]++;
+    for (let k = 0; k <= maxDegree; k++) bucket[k + 1] += bucket[k];
+    const order = new Int32Array(n);
+    const position = new Int32Array(n);
+    const cursor = bucket.slice(0, maxDegree + 1);
+    for (let u = 0; u < n; u++) {
+      position[u] = cursor[degree[u]]++;
+      order[position[u]] = u;
+    }
+
+    for (let i = 0; i < n; i++) {
+      const v = order[i];
+      for (const u of neighbors[v]) {
+        if (degree[u] <= degree[v]) continue;
+        const du = degree[u];
+        const front = bucket[du];
+        const w = order[front];
+        if (u !== w) {
+          order[position[u]] = w;
+          order[front] = u;
+          position[w] = position[u];
+          position[u] = front;
+        }
+        bucket[du]++;
+        degree[u]--;
+      }
+    }
+
+    return degree;
+  }
+}
+
+type JsRule =
+  | { kind: 'forbidden'; source: number; target: number }
+  | { kind: 'layers'; layers: RuleLayer[] }
+  | { kind: 'max'; limit: number; group: number };
+
+/**
+ * Glob as an anchored, case-insensitive regex: `**` crosses directories,
+ * `*` and `?` stay within one path segment
+ */
+function globToRegExp(glob: string): RegExp {
+  let source = '';
+  for (let i = 0; i < glob.length; i++) {
+    const c = glob[i];
+    if (c === '*') {
+      if (glob[i + 1] === '*') {
+        source += '.*';
+        i++;
+      } else {
+        source += '[^/\\\\]*';
+      }
+    } else if (c === '?') {
+      source += '[^/\\\\]';
+    } else {
+      source += c.replace(/[.+^${}()|[\]\\]/g, '\\$&');
+    }
+  }
+  return new RegExp(`^${source}$`, 'i');
+}
+
+/**
+ * Incremental evaluator for dependency and layer rules.
+ *
+ * Nodes belong to groups: glob groups match node paths, explicit groups
+ * are maintained with updateGroup(). Rules forbid edges between groups,
+ * enforce allowed dependencies between layers or cap dependency counts.
+ * The native engine keeps groups as bitsets and per-rule results, and
+ * evaluate() re-checks only nodes whose dependencies or membership changed
+ * since the last call; the fallback re-evaluates everything. Violations
+ * are ordered by rule, then by node in order of first appearance.
+ */
+export class RuleEvaluator {
+  private ids: string[] = [];
+  private indexOf: Map<string, number> = new Map();
+  private paths: string[] = [];
+  private dependencies: number[][] = [];
+  private groups: Array<{ globs: RegExp[] | null; members: Set<number> }> = [];
+  private rules: JsRule[] = [];
+  private violationCount = 0;
+  private nativeEvaluator: NativeRuleEvaluator | null = null;
+
+  constructor() {
+    if (nativeModule) {
+      this.nativeEvaluator = new nativeModule.RuleEvaluator();
+    }
+  }
+
+  /**
+   * Add nodes, or update the paths of existing ones
+   */
+  addNodes(nodes: RuleNode[]): void {
+    if (this.nativeEvaluator) {
+      this.nativeEvaluator.addNodes(nodes);
+      return;
+    }
+    for (const node of nodes) {
+      const index = this.node(node.id);
+      this.paths[index] = node.path ?? node.id;
+    }
+  }
+
+  /**
+   * Replace a node's dependencies; missing nodes are added with their id as path
+   */
+  setDependencies(from: string, targets: string[]): void {
+    if (this.nativeEvaluator) {
+      this.nativeEvaluator.setDependencies(from, targets);
+      return;
+    }
+    const source = this.node(from);
+    this.dependencies[source] = targets.map((target) => this.node(target));
+  }
+
+  /**
+   * Group of nodes whose path matches any glob
+   */
+  addGlobGroup(globs: string[]): number {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.addGlobGroup(globs);
+    }
+    this.groups.push({ globs: globs.map(globToRegExp), members: new Set() });
+    return this.groups.length - 1;
+  }
+
+  /**
+   * Empty group maintained with updateGroup()
+   */
+  addGroup(): number {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.addGroup();
+    }
+    this.groups.push({ globs: null, members: new Set() });
+    return this.groups.length - 1;
+  }
+
+  /**
+   * Add and remove members of an explicit group; unknown ids are skipped
+   */
+  updateGroup(group: number, add: string[], remove: string[] = []): boolean {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.updateGroup(group, add, remove);
+    }
+    const target = this.groups[group];
+    if (!target || target.globs) return false;
+    for (const id of add) {
+      const node = this.indexOf.get(id);
+      if (node !== undefined) target.members.add(node);
+    }
+    for (const id of remove) {
+      const node = this.indexOf.get(id);
+      if (node !== undefined) target.members.delete(node);
+    }
+    return true;
+  }
+
+  /**
+   * Forbid dependencies from sourceGroup into targetGroup; -1 for unknown groups
+   */
+  addForbiddenRule(sourceGroup: number, targetGroup: number): number {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.addForbiddenRule(sourceGroup, targetGroup);
+    }
+    if (!this.groups[sourceGroup] || !this.groups[targetGroup]) return -1;
+    this.rules.push({ kind: 'forbidden', source: sourceGroup, target: targetGroup });
+    return this.rules.length - 1;
+  }
+
+  /**
+   * Layer boundary rule (at most 64 layers); -1 for an invalid definition
+   */
+  addLayerRule(layers: RuleLayer[]): number {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.addLayerRule(layers);
+    }
+    if (layers.length > 64 || layers.some((layer) => !this.groups[layer.group])) return -1;
+    this.rules.push({ kind: 'layers', layers });
+    return this.rules.length - 1;
+  }
+
+  /**
+   * Cap the dependency count of nodes in group (all nodes without one)
+   */
+  addMaxDependenciesRule(limit: number, group?: number): number {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.addMaxDependenciesRule(limit, group);
+    }
+    if (group !== undefined && !this.groups[group]) return -1;
+    this.rules.push({ kind: 'max', limit, group: group ?? -1 });
+    return this.rules.length - 1;
+  }
+
+  /**
+   * All current violations
+   */
+  evaluate(): RuleHit[] {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.evaluate();
+    }
+
+    const inGroup = (group: number, node: number): boolean => {
+      const { globs, members } = this.groups[group];
+      return globs ? globs.some((glob) => glob.test(this.paths[node])) : members.has(node);
+    };
+    const distinct = (node: number) =>
+      Array.from(new Set(this.dependencies[node] ?? [])).sort((a, b) => a - b);
+
+    const hits: RuleHit[] = [];
+    this.rules.forEach((rule, index) => {
+      for (let node = 0; node < this.ids.length; node++) {
+        if (rule.kind === 'forbidden') {
+          if (!inGroup(rule.source, node)) continue;
+          for (const dep of distinct(node)) {
+            if (inGroup(rule.target, dep)) hits.push({ rule: index, from: this.ids[node], to: this.ids[dep] });
+          }
+        } else if (rule.kind === 'layers') {
+          const layerOf = (n: number) => rule.layers.findIndex((layer) => inGroup(layer.group, n));
+          const sourceLayer = layerOf(node);
+          if (sourceLayer < 0) continue;
+          for (const dep of distinct(node)) {
+            const targetLayer = layerOf(dep);
+            if (targetLayer < 0 || targetLayer === sourceLayer) continue;
+            if (rule.layers[sourceLayer].allowed.includes(targetLayer)) continue;
+            hits.push({ rule: index, from: this.ids[node], to: this.ids[dep], sourceLayer, targetLayer });
+          }
+        } else {
+          if (rule.group >= 0 && !inGroup(rule.group, node)) continue;
+          const count = this.dependencies[node]?.length ?? 0;
+          if (count > rule.limit) hits.push({ rule: index, from: this.ids[node], count });
+        }
+      }
+    });
+    this.violationCount = hits.length;
+    return hits;
+  }
+
+  clear(): void {
+    if (this.nativeEvaluator) {
+      this.nativeEvaluator.clear();
+      return;
+    }
+    this.ids = [];
+    this.indexOf.clear();
+    this.paths = [];
+    this.dependencies = [];
+    this.groups = [];
+    this.rules = [];
+    this.violationCount = 0;
+  }
+
+  stats(): RuleEvaluatorStats {
+    if (this.nativeEvaluator) {
+      return this.nativeEvaluator.stats();
+    }
+    let edgeCount = 0;
+    for (const deps of this.dependencies) edgeCount += deps ? new Set(deps).size : 0;
+    return {
+      nodeCount: this.ids.length,
+      edgeCount,
+      groupCount: this.groups.length,
+      ruleCount: this.rules.length,
+      rulesEvaluated: this.rules.length,
+      nodesRechecked: this.ids.length * this.rules.length,
+      violationCount: this.violationCount,
+      evalTimeMs: 0,
+    };
+  }
+
+  private node(id: string): number {
+    let node = this.indexOf.get(id);
+    if (node === undefined) {
+      node = this.ids.length;
+      this.ids.push(id);
+      this.indexOf.set(id, node);
+      this.paths.push(id);
+      this.dependencies.push([]);
+    }
+    return node;
+  }
+}
+
+const GRAPHML_HEADER = `<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns"
+         xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance"
+         xsi:schemaLocation="http://graphml.graphdrawing.org/xmlns
+         http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd">
+
+  <key id="d0" for="node" attr.name="label" attr.type="string"/>
+  <key id="d1" for="node" attr.name="type" attr.type="string"/>
+  <key id="d2" for="edge" attr.name="type" attr.type="string"/>
+
+  <graph id="G" edgedefault="directed">
+`;
+
+function escapeXml(str: string): string {
+  return str
+    .replace(/&/g, '&amp;')
+    .replace(/</g, '&lt;')
+    .replace(/>/g, '&gt;')
+    .replace(/"/g, '&quot;')
+    .replace(/'/g, '&apos;');
+}
+
+function sanitizeId(str: string): string {
+  return str.replace(/[^a-zA-Z0-9_]/g, '_');
+}
+
+function csvField(str: string): string {
+  return /[",\r\n]/.test(str) ? `"${str.replace(/"/g, '""')}"` : str;
+}
+
+/**
+ * Streaming exporter for a dependency graph (JSON, GraphML, CSV edge list).
+ *
+ * The native exporter keeps a compact copy of the graph (interned ids,
+ * fixed-size edge records) and produces the document in bounded chunks
+ * with SIMD escaping, so a large graph never becomes one JS string. The
+ * fallback walks the same records in JS. Output is identical apart from
+ * the spelling of non-integer numbers in JSON.
+ */
+export class GraphExporter {
+  private nodes: Map<string, ExportGraphNode> = new Map();
+  private edges: Array<[string, ExportGraphEdge[]]> = [];
+  private edgeCount = 0;
+  private records: Iterator<string> | null = null;
+  private bytesWritten = 0;
+  private nativeExporter: NativeGraphExporter | null = null;
+
+  constructor() {
+    if (nativeModule) {
+      this.nativeExporter = new nativeModule.GraphExporter();
+    }
+  }
+
+  /**
+   * Build an exporter from a dependency graph's nodes and edge lists
+   */
+  static fromGraph(graph: {
+    nodes: Map<string, ExportGraphNode>;
+    edges: Map<string, ExportGraphEdge[]>;
+  }): GraphExporter {
+    const exporter = new GraphExporter();
+    // Batches keep the transient JS arrays small for large graphs
+    let batch: ExportGraphNode[] = [];
+    for (const node of graph.nodes.values()) {
+      batch.push(node);
+      if (batch.length === 4096) {
+        exporter.addNodes(batch);
+        batch = [];
+      }
+    }
+    exporter.addNodes(batch);
+    for (const [from, edges] of graph.edges) {
+      exporter.addEdges(from, edges);
+    }
+    return exporter;
+  }
+
+  /**
+   * Add nodes; an existing id is updated in place
+   */
+  addNodes(nodes: ExportGraphNode[]): void {
+    if (this.nativeExporter) {
+      this.nativeExporter.addNodes(nodes);
+      return;
+    }
+    this.records = null;
+    for (const node of nodes) this.nodes.set(node.id, node);
+  }
+
+  /**
+   * Append the outgoing edges of one source
+   */
+  addEdges(from: string, edges: ExportGraphEdge[]): void {
+    if (this.nativeExporter) {
+      this.nativeExporter.addEdges(from, edges);
+      return;
+    }
+    this.records = null;
+    this.edges.push([from, edges.slice()]);
+    this.edgeCount += edges.length;
+  }
+
+  /**
+   * Start an export; read() then yields its output
+   */
+  begin(format: GraphExportFormat): void {
+    if (this.nativeExporter) {
+      this.nativeExporter.begin(format);
+      return;
+    }
+    this.records = this.jsRecords(format);
+    this.bytesWritten = 0;
+  }
+
+  /**
+   * Next chunk of the export (about maxBytes), or null once it is finished
+   */
+  read(maxBytes = 64 * 1024): Buffer | null {
+    if (this.nativeExporter) {
+      return this.nativeExporter.read(maxBytes);
+    }
+    if (!this.records) return null;
+
+    let chunk = '';
+    let done = false;
+    while (chunk.length < maxBytes) {
+      const next = this.records.next();
+      if (next.done) {
+        done = true;
+        break;
+      }
+      chunk += next.value;
+    }
+    if (done) this.records = null;
+    if (done && chunk.length === 0) return null;
+
+    const buffer = Buffer.from(chunk, 'utf8');
+    this.bytesWritten += buffer.length;
+    return buffer;
+  }
+
+  /**
+   * Export chunks as an iterable, e.g. for Readable.from()
+   */
+  *chunks(format: GraphExportFormat, maxBytes = 64 * 1024): Generator<Buffer> {
+    this.begin(format);
+    let chunk: Buffer | null;
+    while ((chunk = this.read(maxBytes)) !== null) {
+      yield chunk;
+    }
+  }
+
+  /**
+   * Export the whole graph to a file; returns bytes written, -1 on failure
+   */
+  writeFile(filePath: string, format: GraphExportFormat): number {
+    if (this.nativeExporter) {
+      return this.nativeExporter.writeFile(filePath, format);
+    }
+    let fd: number | null = null;
+    try {
+      fd = fs.openSync(filePath, 'w');
+      for (const chunk of this.chunks(format, 1 << 20)) {
+        fs.writeSync(fd, chunk);
+      }
+      return this.bytesWritten;
+    } catch {
+      return -1;
+    } finally {
+      if (fd !== null) fs.closeSync(fd);
+    }
+  }
+
+  clear(): void {
+    if (this.nativeExporter) {
+      this.nativeExporter.clear();
+      return;
+    }
+    this.nodes.clear();
+    this.edges = [];
+    this.edgeCount = 0;
+    this.records = null;
+    this.bytesWritten = 0;
+  }
+
+  stats(): GraphExporterStats {
+    if (this.nativeExporter) {
+      return this.nativeExporter.stats();
+    }
+    return {
+      nodeCount: this.nodes.size,
+      edgeCount: this.edgeCount,
+      memoryBytes: 0,
+      bytesWritten: this.bytesWritten,
+    };
+  }
+
+  private *jsRecords(format: GraphExportFormat): Generator<string> {
+    if (format === 'csv') {
+      yield 'from,to,type,weight\n';
+    } else if (format === 'graphml') {
+      yield GRAPHML_HEADER;
+    } else {
+      yield '{"nodes":{';
+    }
+
+    if (format !== 'csv') {
+      let first = true;
+      for (const [id, node] of this.nodes) {
+        if (format === 'graphml') {
+          const label = node.filePath.split(/[/\\]/).pop() || node.filePath;
+          yield `    <node id="${sanitizeId(id)}">
+      <data key="d0">${escapeXml(label)}</data>
+      <data key="d1">${escapeXml(node.type)}</data>
+    </node>
+`;
+        } else {
+          const metadata: Record<string, unknown> = {};
+          if (node.metadata?.linesOfCode !== undefined) metadata.linesOfCode = node.metadata.linesOfCode;
+          if (node.metadata?.complexity !== undefined) metadata.complexity = node.metadata.complexity;
+          if (node.metadata?.domain) metadata.domain = node.metadata.domain;
+          const record = { id, type: node.type, filePath: node.filePath, name: node.name, metadata };
+          yield `${first ? '' : ','}${JSON.stringify(id)}:${JSON.stringify(record)}`;
+        }
+        first = false;
+      }
+      if (format === 'json') yield '},"edges":{';
+    }
+
+    let edgeId = 0;
+    for (let g = 0; g < this.edges.length; g++) {
+      const [from, edges] = this.edges[g];
+      if (format === 'json') yield `${g > 0 ? ',' : ''}${JSON.stringify(from)}:[`;
+      for (let e = 0; e < edges.length; e++) {
+        const edge = edges[e];
+        const weight = edge.weight ?? 1;
+        if (format === 'json') {
+          yield `${e > 0 ? ',' : ''}${JSON.stringify({ from, to: edge.to, type: edge.type, weight })}`;
+        } else if (format === 'graphml') {
+          yield `    <edge id="e${edgeId}" source="${sanitizeId(from)}" target="${sanitizeId(edge.to)}">
+      <data key="d2">${escapeXml(edge.type)}</data>
+    </edge>
+`;
+        } else {
+          yield `${csvField(from)},${csvField(edge.to)},${csvField(edge.type)},${weight}\n`;
+        }
+        edgeId++;
+      }
+      if (format === 'json') yield ']';
+    }
+
+    if (format === 'json') {
+      yield '}}';
+    } else if (format === 'graphml') {
+      yield `  </graph>
+</graphml>`;
+    }
+  }
+}
+
+/**
+ * Cycles in a dependency graph, searched per strongly connected component.
+ *
+ * The largest components come first, each with its shortest cycles. The
+ * native engine enumerates with a bounded Johnson's algorithm; the
+ * fallback keeps the shortest cycle through each member found by
+ * breadth-first search, which is enough for representative cycles.
+ */
+export function findCycles(edges: ReachabilityEdge[], options?: CycleOptions): CycleResult {
+  if (nativeModule) {
+    return nativeModule.findCycles(edges, options);
+  }
+  return jsFindCycles(edges, options);
+}
+
+function jsFindCycles(edges: ReachabilityEdge[], options?: CycleOptions): CycleResult {
+  const maxCycles = options?.maxCycles ?? 50;
+  const perComponent = Math.max(options?.maxCyclesPerComponent ?? 10, 1);
+  const maxLength = options?.maxLength ?? 0;
+  const maxSteps = options?.maxSteps ?? 2_000_000;
+
+  const ids: string[] = [];
+  const indexOf = new Map<string, number>();
+  const successors: Set<number>[] = [];
+  const intern = (id: string) => {
+    let node = indexOf.get(id);
+    if (node === undefined) {
+      node = ids.length;
+      ids.push(id);
+      indexOf.set(id, node);
+      successors.push(new Set());
+    }
+    return node;
+  };
+  for (const edge of edges) {
+    const from = intern(edge.from);
+    const to = intern(edge.to);
+    if (from !== to) successors[from].add(to);
+  }
+
+  const groups = tarjanComponents(successors)
+    .filter((group) => group.length >= 2)
+    .sort((a, b) => b.length - a.length);
+
+  const cycles: string[][] = [];
+  const component = new Int32Array(ids.length).fill(-1);
+  const parent = new Int32Array(ids.length).fill(-1);
+  let steps = 0;
+  let truncated = groups.length > maxCycles;
+
+  for (let c = 0; c < groups.length && cycles.length < maxCycles; c++) {
+    const members = groups[c].sort((a, b) => a - b);
+    for (const node of members) component[node] = c;
+
+    // Shortest cycle through each member, deduplicated by its rotation
+    const found = new Map<string, number[]>();
+    for (const source of members) {
+      if (steps >= maxSteps) {
+        truncated = true;
+        break;
+      }
+      const queue = [source];
+      parent[source] = source;
+      let closing = -1;
+      for (let head = 0; head < queue.length && closing < 0; head++) {
+        const u = queue[head];
+        for (const w of successors[u]) {
+          steps++;
+          if (component[w] !== c) continue;
+          if (w === source) {
+            closing = u;
+            break;
+          }
+          if (parent[w] < 0) {
+            parent[w] = u;
+            queue.push(w);
+          }
+        }
+      }
+
+      if (closing >= 0) {
+        const cycle: number[] = [];
+        for (let v = closing; v !== source; v = parent[v]) cycle.push(v);
+        cycle.push(source);
+        cycle.reverse();
+        const start = cycle.indexOf(Math.min(...cycle));
+        const rotated = [...cycle.slice(start), ...cycle.slice(0, start)];
+        if (maxLength === 0 || rotated.length <= maxLength) found.set(rotated.join(','), rotated);
+      }
+      for (const v of queue) parent[v] = -1;
+    }
+
+    const keep = Math.min(perComponent, maxCycles - cycles.length);
+    const shortest = Array.from(found.values()).sort((a, b) => a.length - b.length);
+    if (shortest.length > keep) truncated = true;
+    for (const cycle of shortest.slice(0, keep)) {
+      cycles.push(cycle.map((node) => ids[node]));
+    }
+  }
+
+  return { cycles, cyclicComponents: groups.length, truncated };
+}
+
+/**
+ * Read an exported analysis document (a Buffer, or a file path that is
+ * memory-mapped) without JSON.parse: graph nodes and edges come back as
+ * typed columns, everything else as raw JSON per top-level key.
+ * Returns null without the native engine; callers fall back to JSON.parse.
+ */
+export function readExport(source: Buffer | string): ExportReadResult | null {
+  if (nativeModule) {
+    return nativeModule.readExport(source);
+  }
+  return null;
+}
+
+export function getVersion(): string {
+  if (nativeModule) {
+    return `native-${nativeModule.version}`;
+  }
+  return 'js-fallback-1.0.0';
+}
+
+export default {
+  ReachabilityIndex,
+  GraphAnalytics,
+  RuleEvaluator,
+  GraphExporter,
+  findCycles,
+  readExport,
+  isNativeAvailable,
+  getNativeLoadError,
+  getVersion,
+};
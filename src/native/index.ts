@@ -6,16 +6,34 @@
  * Provides high-performance native modules for ArchiCore:
  * - Semantic Code Chunker: Fast code chunking with semantic boundary detection
  * - Incremental Indexer: Efficient file indexing with Merkle tree diff detection
+ * - Dependency Graph Engine: Reachability index for impact analysis
+ * - Indexing Daemon: Hot index served over a Unix socket (client only)
  *
- * Both modules have JavaScript fallbacks for environments where native
+ * All modules have JavaScript fallbacks for environments where native
  * compilation is not available.
  */
 
 // Re-export chunker
 export {
   SemanticChunker,
+  ChunkCache,
+  ParseCache,
+  IdentifierIndex,
+  AstArena,
+  AST_NODE_STRIDE,
+  AST_NO_NODE,
+  AST_ERROR_BIT,
+  SymbolTable,
+  SYMBOL_FLAG_EXPORTED,
   chunk,
   chunkFile,
+  streamChunks,
+  exportChunks,
+  importChunks,
+  diffChunks,
+  diffSymbols,
+  buildSymbolTable,
+  packContext,
   countTokens,
   isNativeAvailable as isChunkerNativeAvailable,
   getNativeLoadError as getChunkerLoadError,
@@ -29,16 +47,40 @@ export type {
   ChunkerConfig,
   ChunkType,
   SourceLocation,
+  ChunkCacheOptions,
+  ChunkCacheStats,
+  ParseCacheOptions,
+  ParseCacheStats,
+  ChunkDelta,
+  SymbolHash,
+  SymbolChange,
+  SymbolDelta,
+  EmbeddingBatch,
+  OccurrenceRole,
+  IdentifierOccurrence,
+  CallSite,
+  IdentifierQuery,
+  IdentifierIndexStats,
+  AstNodeInfo,
+  AstArenaStats,
+  SymbolTableOptions,
+  SymbolTableColumns,
+  ContextSnippet,
+  PackOptions,
+  PackResult,
 } from './chunker.js';
 
 // Re-export indexer
 export {
   FileIndex,
+  SharedFileIndex,
+  FileFlags,
   IncrementalIndexer,
   hashFile,
   hashString,
   scan,
   globMatch,
+  mergeIndexes,
   isNativeAvailable as isIndexerNativeAvailable,
   getNativeLoadError as getIndexerLoadError,
   getVersion as getIndexerVersion,
@@ -51,19 +93,80 @@ export type {
   ScanResult,
   DiffResult,
   IndexerConfig,
+  ShardSpec,
+  IndexPartial,
+  MergeResult,
   ChangeType,
+  ChangeKind,
   Language,
 } from './indexer.js';
 
+// Re-export graph engine
+export {
+  ReachabilityIndex,
+  GraphAnalytics,
+  RuleEvaluator,
+  GraphExporter,
+  findCycles,
+  readExport,
+  isNativeAvailable as isGraphNativeAvailable,
+  getNativeLoadError as getGraphLoadError,
+  getVersion as getGraphVersion,
+} from './graph.js';
+
+export type {
+  ReachabilityConfig,
+  ReachabilityEdge,
+  ReachabilityStats,
+  AffectedEntry,
+  AnalyticsConfig,
+  AnalyticsStats,
+  RankedNode,
+  CycleOptions,
+  CycleResult,
+  RuleNode,
+  RuleLayer,
+  RuleHit,
+  RuleEvaluatorStats,
+  GraphExportFormat,
+  ExportGraphNode,
+  ExportGraphEdge,
+  GraphExporterStats,
+  ImportedGraphTables,
+  ExportReadResult,
+} from './graph.js';
+
+// Re-export daemon client
+export {
+  DaemonClient,
+  startDaemon,
+  connectDaemon,
+  attachSharedIndex,
+  defaultSocketPath,
+  defaultSharedIndexPath,
+  findDaemonBinary,
+  isDaemonSupported,
+} from './daemon.js';
+
+export type {
+  DaemonOptions,
+  DaemonStatus,
+  DaemonScan,
+  DaemonDiff,
+  DaemonSearchOptions,
+  DaemonSearchResult,
+} from './daemon.js';
+
 // Combined availability check
 import { isNativeAvailable as isChunkerNative } from './chunker.js';
 import { isNativeAvailable as isIndexerNative } from './indexer.js';
+import { isNativeAvailable as isGraphNative } from './graph.js';
 
 /**
  * Check if all native modules are available
  */
 export function isFullyNative(): boolean {
-  return isChunkerNative() && isIndexerNative();
+  return isChunkerNative() && isIndexerNative() && isGraphNative();
 }
 
 /**
@@ -72,14 +175,17 @@ export function isFullyNative(): boolean {
 export function getNativeStatus(): {
   chunker: boolean;
   indexer: boolean;
+  graph: boolean;
   fullyNative: boolean;
 } {
   const chunker = isChunkerNative();
   const indexer = isIndexerNative();
+  const graph = isGraphNative();
   return {
     chunker,
     indexer,
-    fullyNative: chunker && indexer,
+    graph,
+    fullyNative: chunker && indexer && graph,
   };
 }
 
@@ -91,5 +197,6 @@ export function printNativeStatus(): void {
   console.log('ArchiCore Native Modules Status:');
   console.log(`  Chunker: ${status.chunker ? '✓ Native' : '✗ JS Fallback'}`);
   console.log(`  Indexer: ${status.indexer ? '✓ Native' : '✗ JS Fallback'}`);
+  console.log(`  Graph:   ${status.graph ? '✓ Native' : '✗ JS Fallback'}`);
   console.log(`  Overall: ${status.fullyNative ? '✓ Fully Native' : '⚠ Partial JS Fallback'}`);
 }
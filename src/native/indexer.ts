@@ -40,8 +40,28 @@ export interface FileEntry {
   mtime: number;
   language: Language;
   isIndexed: boolean;
+  /** FileFlags bits (0 = not classified) */
+  flags?: number;
+  /** Hash ignoring whitespace and comments (native scans with computeSemanticHash) */
+  semanticHash?: string;
 }
 
+/**
+ * File classification bits of FileEntry.flags
+ */
+export const FileFlags = {
+  /** NUL bytes or mostly control bytes */
+  BINARY: 1 << 0,
+  /** Very long lines (bundles, minified code) */
+  MINIFIED: 1 << 1,
+  /** Generated-code marker, lockfile or generated stub name */
+  GENERATED: 1 << 2,
+  /** Near-random bytes (compressed or encoded data) */
+  HIGH_ENTROPY: 1 << 3,
+  /** Classification ran; the other bits are meaningful */
+  CLASSIFIED: 1 << 7,
+} as const;
+
 export interface DirEntry {
   path: string;
   merkleHash: string;
@@ -51,12 +71,17 @@ export interface DirEntry {
 
 export type ChangeType = 'added' | 'modified' | 'deleted' | 'renamed';
 
+/** 'format_only' when only whitespace, indentation or comments changed */
+export type ChangeKind = 'semantic' | 'format_only';
+
 export interface FileChange {
   type: ChangeType;
   path: string;
   oldPath?: string;
   oldHash: string;
   newHash: string;
+  /** Set on 'modified' changes */
+  kind?: ChangeKind;
 }
 
 export interface ScanResult {
@@ -75,6 +100,8 @@ export interface DiffResult {
   modifiedCount: number;
   deletedCount: number;
   renamedCount: number;
+  /** Modifications classified as 'format_only' */
+  formatOnlyCount?: number;
   diffTimeMs: number;
   error?: string;
 }
@@ -85,23 +112,62 @@ export interface IndexerConfig {
   followSymlinks?: boolean;
   computeContentHash?: boolean;
   detectRenames?: boolean;
+  /** Also hash the whitespace/comment-free token stream (native only) */
+  computeSemanticHash?: boolean;
   maxFileSize?: number;
   parallelWorkers?: number;
 }
 
+/**
+ * Part of the tree one shard indexes: everything under `roots` (all of it
+ * when empty or when one root is '') minus everything under `exclude`.
+ * Paths are relative to the scan root.
+ */
+export interface ShardSpec {
+  roots: string[];
+  exclude: string[];
+}
+
+export interface IndexPartial extends Partial<ShardSpec> {
+  index: FileIndex;
+}
+
+export interface MergeResult {
+  success: boolean;
+  /** Merkle root of the merged index */
+  merkleRoot: string;
+  totalFiles: number;
+  /** Paths indexed by more than one shard */
+  overlapFiles: number;
+  /** Paths overlapping shards disagree on (sorted) */
+  conflicts: string[];
+  mergeTimeMs: number;
+  error?: string;
+}
+
 // Native module interface
 interface NativeIndexerModule {
   Indexer: new (config?: IndexerConfig) => NativeIndexer;
   FileIndex: new () => NativeFileIndex;
+  SharedFileIndex: {
+    new (): NativeSharedFileIndex;
+    unlink(name: string): boolean;
+  };
   hashFile: (path: string) => string;
   hashString: (content: string) => string;
   scan: (rootPath: string, config?: IndexerConfig) => ScanResult;
   globMatch: (path: string, pattern: string) => boolean;
+  mergeIndexes: (
+    partials: Array<{ index: NativeFileIndex; roots?: string[]; exclude?: string[] }>,
+    out: NativeFileIndex
+  ) => MergeResult;
   version: string;
 }
 
 interface NativeIndexer {
   scan(rootPath: string): ScanResult;
+  scanShard(rootPath: string, shard: ShardSpec): ScanResult;
+  planShards(rootPath: string, count: number): ShardSpec[];
   diff(oldScan: ScanResult, newScan: ScanResult): DiffResult;
   setConfig(config: IndexerConfig): void;
   getConfig(): IndexerConfig;
@@ -119,6 +185,23 @@ interface NativeFileIndex {
   save(path: string): boolean;
   load(path: string): boolean;
   merkleHash(): string;
+  subtreeHash(dir: string): string;
+  verify(): string[];
+}
+
+interface NativeSharedFileIndex {
+  create(name: string, capacityBytes?: number): void;
+  open(name: string): void;
+  close(): void;
+  publish(index: NativeFileIndex): void;
+  get(path: string): FileEntry | null;
+  contains(path: string): boolean;
+  getAll(): FileEntry[];
+  getByLanguage(language: Language): FileEntry[];
+  size(): number;
+  merkleHash(): string;
+  epoch(): number;
+  isWriter(): boolean;
 }
 
 // Try to load native module
@@ -216,7 +299,8 @@ function detectLanguage(filePath: string): Language {
     '.cc': 'cpp',
     '.cxx': 'cpp',
     '.hpp': 'cpp',
-    '.h': 'cpp',
+    '.hh': 'cpp',
+    '.h': 'c',
     '.c': 'c',
     '.cs': 'csharp',
     '.rb': 'ruby',
@@ -242,6 +326,91 @@ function jsHashFile(filePath: string): string {
   }
 }
 
+const CLASSIFY_SNIFF_BYTES = 8192;
+
+const LOCKFILES = new Set([
+  'package-lock.json', 'yarn.lock', 'pnpm-lock.yaml', 'Cargo.lock',
+  'Gemfile.lock', 'poetry.lock', 'composer.lock', 'go.sum', 'Pipfile.lock',
+]);
+
+const GENERATED_SUFFIXES = [
+  '.pb.go', '.pb.cc', '.pb.h', '_pb2.py', '_pb2_grpc.py', '.pb.ts',
+  '_pb.js', '_pb.d.ts', '.g.dart', '.designer.cs', '.generated.ts',
+];
+
+const GENERATED_MARKERS = [
+  '@generated', 'DO NOT EDIT', 'Code generated by', 'auto-generated',
+  'autogenerated', '<auto-generated', 'Generated by the protocol buffer compiler',
+];
+
+/**
+ * Valid UTF-8 with at least one multi-byte sequence (a sequence cut off at the end counts)
+ */
+function isMultibyteUtf8(bytes: Uint8Array): boolean {
+  let multibyte = false;
+  let i = 0;
+  while (i < bytes.length) {
+    const c = bytes[i];
+    const len = c < 0x80 ? 1 : (c >> 5) === 0x6 ? 2 : (c >> 4) === 0xe ? 3 : (c >> 3) === 0x1e ? 4 : 0;
+    if (len === 0) return false;
+    for (let k = 1; k < len; k++) {
+      if (i + k >= bytes.length) return multibyte;
+      if ((bytes[i + k] & 0xc0) !== 0x80) return false;
+    }
+    multibyte = multibyte || len > 1;
+    i += len;
+  }
+  return multibyte;
+}
+
+/**
+ * Classify a file from its name and first bytes (JS fallback of classify_content)
+ */
+function jsClassify(filePath: string, content: Buffer): number {
+  let flags: number = FileFlags.CLASSIFIED;
+  const name = path.basename(filePath);
+  if (LOCKFILES.has(name) || GENERATED_SUFFIXES.some(s => name.endsWith(s))) flags |= FileFlags.GENERATED;
+  if (filePath.includes('.min.') || filePath.includes('-min.')) flags |= FileFlags.MINIFIED;
+
+  const head = content.subarray(0, CLASSIFY_SNIFF_BYTES);
+  if (head.length === 0) return flags;
+
+  const histogram = new Uint32Array(256);
+  for (const byte of head) histogram[byte]++;
+
+  let control = 0;
+  for (let c = 1; c < 32; c++) {
+    if (c !== 9 && c !== 10 && c !== 13 && c !== 12 && c !== 27) control += histogram[c];
+  }
+  if (histogram[0] > 0 || control * 10 > head.length) return flags | FileFlags.BINARY;
+
+  // Multi-byte text (e.g. CJK) has high byte entropy without being a blob
+  if (head.length >= 1024 && !isMultibyteUtf8(head)) {
+    let entropy = 0;
+    for (const count of histogram) {
+      if (count === 0) continue;
+      const p = count / head.length;
+      entropy -= p * Math.log2(p);
+    }
+    const whitespace = histogram[32] + histogram[9] + histogram[10];
+    if (entropy > 6.2 || (entropy > 5.7 && whitespace * 100 < head.length)) flags |= FileFlags.HIGH_ENTROPY;
+  }
+
+  const text = head.toString('latin1');
+  const lines = histogram[10];
+  if (lines === 0) {
+    if (head.length === CLASSIFY_SNIFF_BYTES) flags |= FileFlags.MINIFIED;
+  } else {
+    const longest = Math.max(...text.split('\n').map(l => l.length));
+    if (head.length / lines > 250 && longest >= 1000) flags |= FileFlags.MINIFIED;
+  }
+
+  const top = text.slice(0, 1024);
+  if (GENERATED_MARKERS.some(m => top.includes(m))) flags |= FileFlags.GENERATED;
+
+  return flags;
+}
+
 function jsHashString(content: string): string {
   const hash = crypto.createHash('sha256').update(content).digest('hex');
   return BigInt('0x' + hash.slice(0, 16)).toString();
@@ -301,13 +470,24 @@ async function jsScan(rootPath: string, config: IndexerConfig = {}): Promise<Sca
           const stat = await fs.promises.stat(fullPath);
           if (stat.size > maxFileSize) continue;
 
+          let contentHash = '0';
+          let flags = 0;
+          if (computeHash) {
+            // Hash and classify from one read
+            const content = await fs.promises.readFile(fullPath);
+            const hash = crypto.createHash('sha256').update(content).digest('hex');
+            contentHash = BigInt('0x' + hash.slice(0, 16)).toString();
+            flags = jsClassify(relPath, content);
+          }
+
           files.push({
             path: relPath,
-            contentHash: computeHash ? jsHashFile(fullPath) : '0',
+            contentHash,
             size: stat.size,
             mtime: stat.mtimeMs,
             language: detectLanguage(relPath),
             isIndexed: false,
+            flags,
           });
 
           totalSize += stat.size;
@@ -355,6 +535,7 @@ function jsDiff(oldScan: ScanResult, newScan: ScanResult, detectRenames = true):
   let modifiedCount = 0;
   let deletedCount = 0;
   let renamedCount = 0;
+  let formatOnlyCount = 0;
 
   const oldFiles = new Map<string, FileEntry>();
   const newFiles = new Map<string, FileEntry>();
@@ -429,13 +610,17 @@ function jsDiff(oldScan: ScanResult, newScan: ScanResult, detectRenames = true):
       });
       addedCount++;
     } else if (oldFile.contentHash !== newFile.contentHash) {
+      const formatOnly = oldFile.semanticHash !== undefined &&
+        oldFile.semanticHash === newFile.semanticHash;
       changes.push({
         type: 'modified',
         path,
         oldHash: oldFile.contentHash,
         newHash: newFile.contentHash,
+        kind: formatOnly ? 'format_only' : 'semantic',
       });
       modifiedCount++;
+      if (formatOnly) formatOnlyCount++;
     }
   }
 
@@ -462,10 +647,121 @@ function jsDiff(oldScan: ScanResult, newScan: ScanResult, detectRenames = true):
     modifiedCount,
     deletedCount,
     renamedCount,
+    formatOnlyCount,
     diffTimeMs: endTime - startTime,
   };
 }
 
+function normalizeShardPath(p: string): string {
+  const normalized = p.replace(/\\/g, '/').replace(/^(\.\/)+/, '').replace(/\/+$/, '');
+  return normalized === '.' ? '' : normalized;
+}
+
+function pathUnder(p: string, dir: string): boolean {
+  return dir === '' || p === dir || p.startsWith(dir + '/');
+}
+
+function shardCovers(shard: Partial<ShardSpec>, p: string): boolean {
+  const roots = (shard.roots ?? []).map(normalizeShardPath);
+  const inRoots = roots.length === 0 || roots.some((r) => pathUnder(p, r));
+  return inRoots && !(shard.exclude ?? []).some((x) => pathUnder(p, normalizeShardPath(x)));
+}
+
+/** Language in native enum order (tie-break of mergeIndexes) */
+const LANGUAGE_ORDER: Language[] = [
+  'unknown', 'javascript', 'typescript', 'python', 'rust', 'go', 'java',
+  'cpp', 'c', 'csharp', 'ruby', 'php', 'swift', 'kotlin',
+];
+
+/**
+ * Order-independent choice between entries with equal content, as in
+ * the native merge: newest mtime wins, remaining ties break on
+ * (size, semanticHash, flags, language, isIndexed)
+ */
+function replacesEntry(candidate: FileEntry, current: FileEntry): boolean {
+  const key = (e: FileEntry): Array<number | bigint> => [
+    e.mtime,
+    e.size,
+    BigInt(e.semanticHash ?? '0'),
+    e.flags ?? 0,
+    Math.max(0, LANGUAGE_ORDER.indexOf(e.language)),
+    e.isIndexed ? 1 : 0,
+  ];
+  const a = key(candidate);
+  const b = key(current);
+  for (let i = 0; i < a.length; i++) {
+    if (a[i] !== b[i]) return a[i] > b[i];
+  }
+  return false;
+}
+
+/**
+ * JavaScript merge fallback (same rules as the native merge)
+ */
+function jsMergeIndexes(partials: IndexPartial[], out: FileIndex): MergeResult {
+  const startTime = Date.now();
+  const fail = (error: string, conflicts: string[] = []): MergeResult => ({
+    success: false,
+    merkleRoot: '0',
+    totalFiles: 0,
+    overlapFiles: 0,
+    conflicts,
+    mergeTimeMs: Date.now() - startTime,
+    error,
+  });
+
+  if (partials.length === 0) return fail('No partial indexes to merge');
+
+  const merged = new Map<string, { entry: FileEntry; holders: number; conflict: boolean }>();
+  for (let i = 0; i < partials.length; i++) {
+    const mismatched = partials[i].index.verify();
+    if (mismatched.length > 0) {
+      return fail(`Partial ${i}: Merkle hash mismatch at '${mismatched[0]}'`);
+    }
+
+    for (const entry of partials[i].index.getAll()) {
+      if (!shardCovers(partials[i], entry.path)) {
+        return fail(`Partial ${i}: '${entry.path}' is outside its shard`);
+      }
+      const slot = merged.get(entry.path);
+      if (!slot) {
+        merged.set(entry.path, { entry, holders: 1, conflict: false });
+        continue;
+      }
+      slot.holders++;
+      if (slot.entry.contentHash !== entry.contentHash) {
+        slot.conflict = true;
+      } else if (replacesEntry(entry, slot.entry)) {
+        slot.entry = entry;
+      }
+    }
+  }
+
+  const conflicts: string[] = [];
+  let overlapFiles = 0;
+  for (const [p, slot] of merged) {
+    const covering = partials.filter((partial) => shardCovers(partial, p)).length;
+    if (slot.conflict || slot.holders < covering) conflicts.push(p);
+    if (slot.holders > 1) overlapFiles++;
+  }
+
+  if (conflicts.length > 0) {
+    conflicts.sort();
+    return { ...fail(`${conflicts.length} path(s) differ between overlapping shards`, conflicts), overlapFiles };
+  }
+
+  out.clear();
+  for (const slot of merged.values()) out.add(slot.entry);
+  return {
+    success: true,
+    merkleRoot: out.merkleHash(),
+    totalFiles: merged.size,
+    overlapFiles,
+    conflicts,
+    mergeTimeMs: Date.now() - startTime,
+  };
+}
+
 /**
  * File Index class (in-memory with persistence)
  */
@@ -580,9 +876,134 @@ export class FileIndex {
     return jsHashString(hashes);
   }
 
+  /**
+   * Hash of one directory subtree ('' = whole index)
+   */
+  subtreeHash(dir: string): string {
+    if (this.nativeIndex) {
+      return this.nativeIndex.subtreeHash(dir);
+    }
+    const prefix = normalizeShardPath(dir);
+    const hashes = this.getAll()
+      .filter((e) => pathUnder(e.path, prefix))
+      .map((e) => e.contentHash)
+      .sort()
+      .join('');
+    return jsHashString(hashes);
+  }
+
+  /**
+   * Paths whose stored Merkle hashes disagree with the entries (empty = consistent).
+   * The JS fallback keeps no Merkle tree, so there is nothing to disagree with.
+   */
+  verify(): string[] {
+    if (this.nativeIndex) {
+      return this.nativeIndex.verify();
+    }
+    return [];
+  }
+
   isNative(): boolean {
     return this.nativeIndex !== null;
   }
+
+  /** @internal */
+  getNative(): NativeFileIndex | null {
+    return this.nativeIndex;
+  }
+}
+
+/**
+ * FileIndex snapshot shared between processes
+ * The segment is a shared-memory object ("shm:<name>") or a file path. One
+ * writer publishes snapshots; readers in any process see the latest one
+ * without locks, rescans or copies of the index. Native only and not on
+ * Windows: create() and open() return null without the native module.
+ */
+export class SharedFileIndex {
+  private nativeIndex: NativeSharedFileIndex;
+
+  private constructor(nativeIndex: NativeSharedFileIndex) {
+    this.nativeIndex = nativeIndex;
+  }
+
+  /**
+   * Become the single writer of a segment (throws if another process is)
+   */
+  static create(name: string, capacityBytes?: number): SharedFileIndex | null {
+    if (!nativeModule) return null;
+    const index = new nativeModule.SharedFileIndex();
+    index.create(name, capacityBytes);
+    return new SharedFileIndex(index);
+  }
+
+  /**
+   * Attach to a segment as a reader (throws if it does not exist)
+   */
+  static open(name: string): SharedFileIndex | null {
+    if (!nativeModule) return null;
+    const index = new nativeModule.SharedFileIndex();
+    index.open(name);
+    return new SharedFileIndex(index);
+  }
+
+  /**
+   * Remove a segment; attached processes keep their mapping
+   */
+  static unlink(name: string): boolean {
+    return nativeModule ? nativeModule.SharedFileIndex.unlink(name) : false;
+  }
+
+  /**
+   * Copy a native FileIndex into the segment (writer only)
+   */
+  publish(index: FileIndex): void {
+    const nativeIndex = index.getNative();
+    if (!nativeIndex) {
+      throw new Error('SharedFileIndex needs a native FileIndex');
+    }
+    this.nativeIndex.publish(nativeIndex);
+  }
+
+  get(path: string): FileEntry | null {
+    return this.nativeIndex.get(path);
+  }
+
+  contains(path: string): boolean {
+    return this.nativeIndex.contains(path);
+  }
+
+  /** Entries sorted by path */
+  getAll(): FileEntry[] {
+    return this.nativeIndex.getAll();
+  }
+
+  getByLanguage(language: Language): FileEntry[] {
+    return this.nativeIndex.getByLanguage(language);
+  }
+
+  size(): number {
+    return this.nativeIndex.size();
+  }
+
+  merkleHash(): string {
+    return this.nativeIndex.merkleHash();
+  }
+
+  /**
+   * Grows with every publish (0 = nothing published yet)
+   */
+  epoch(): number {
+    return this.nativeIndex.epoch();
+  }
+
+  isWriter(): boolean {
+    return this.nativeIndex.isWriter();
+  }
+
+  close(): void {
+    this.nativeIndex.close();
+  }
 }
 
 /**
@@ -615,6 +1036,37 @@ export class IncrementalIndexer {
     return jsScan(rootPath, this.config);
   }
 
+  /**
+   * Scan only the part of the tree covered by a shard
+   */
+  async scanShard(rootPath: string, shard: ShardSpec): Promise<ScanResult> {
+    if (this.nativeIndexer) {
+      return this.nativeIndexer.scanShard(rootPath, shard);
+    }
+    const result = await jsScan(rootPath, this.config);
+    const files = result.files.filter((f) => shardCovers(shard, f.path));
+    const directories = result.directories.filter((d) => shardCovers(shard, d.path));
+    return {
+      ...result,
+      files,
+      directories,
+      totalFiles: files.length,
+      totalDirs: directories.length,
+      totalSize: files.reduce((sum, f) => sum + f.size, 0),
+    };
+  }
+
+  /**
+   * Split the tree into up to `count` shards of similar file counts.
+   * The JS fallback does not split: one shard covers everything.
+   */
+  planShards(rootPath: string, count: number): ShardSpec[] {
+    if (this.nativeIndexer) {
+      return this.nativeIndexer.planShards(rootPath, count);
+    }
+    return [{ roots: [], exclude: [] }];
+  }
+
   diff(oldScan: ScanResult, newScan: ScanResult): DiffResult {
     if (this.nativeIndexer) {
       return this.nativeIndexer.diff(oldScan, newScan);
@@ -682,6 +1134,24 @@ export function globMatch(filePath: string, pattern: string): boolean {
   return jsGlobMatch(filePath, pattern);
 }
 
+/**
+ * Merge partial indexes of a sharded scan into `out`.
+ * Each partial must pass verify() and hold only paths inside its shard;
+ * overlapping shards must agree on every path they share. On failure
+ * `out` is left untouched and `conflicts` lists the disputed paths.
+ */
+export function mergeIndexes(partials: IndexPartial[], out: FileIndex): MergeResult {
+  const outNative = out.getNative();
+  const natives = partials.map((p) => p.index.getNative());
+  if (nativeModule && outNative && natives.every((n) => n !== null)) {
+    return nativeModule.mergeIndexes(
+      partials.map((p, i) => ({ index: natives[i]!, roots: p.roots, exclude: p.exclude })),
+      outNative
+    );
+  }
+  return jsMergeIndexes(partials, out);
+}
+
 export function getVersion(): string {
   if (nativeModule) {
     return `native-${nativeModule.version}`;
@@ -691,11 +1161,13 @@ export function getVersion(): string {
 
 export default {
   FileIndex,
+  SharedFileIndex,
   IncrementalIndexer,
   hashFile,
   hashString,
   scan,
   globMatch,
+  mergeIndexes,
   isNativeAvailable,
   getNativeLoadError,
   getVersion,
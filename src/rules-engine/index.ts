@@ -9,6 +9,7 @@
  */
 
 import { DependencyGraph, Symbol, SymbolKind } from '../types/index.js';
+import { RuleEvaluator } from '../native/graph.js';
 import { Logger } from '../utils/logger.js';
 
 export type RuleType =
@@ -179,8 +180,30 @@ export const DEFAULT_RULES: ArchitectureRule[] = [
   }
 ];
 
+// Правила, проверяемые по графу через RuleEvaluator
+const GRAPH_RULE_TYPES: ReadonlySet<RuleType> = new Set<RuleType>(['no-import', 'layer-boundary', 'max-dependencies']);
+
+// Предел слоёв в одном layer-boundary правиле (битовая маска RuleEvaluator)
+const MAX_RULE_LAYERS = 64;
+
+/**
+ * Состояние RuleEvaluator, синхронизированное с графом между проверками
+ */
+interface GraphRuleState {
+  graph: DependencyGraph;
+  version: number;                              // graph.version при последней синхронизации
+  signature: string;
+  evaluator: RuleEvaluator;
+  rules: ArchitectureRule[];                    // Индекс правила в evaluator -> правило
+  rejected: Array<{ rule: ArchitectureRule; reason: string }>; // Правила, которые evaluator не принял
+  groups: Array<{ regex: RegExp; group: number }>;
+  paths: Map<string, string>;                   // Узел -> filePath при последней синхронизации
+  targets: Map<string, string[]>;               // Узел -> зависимости при последней синхронизации
+}
+
 export class RulesEngine {
   private rules: Map<string, ArchitectureRule> = new Map();
+  private graphState: GraphRuleState | null = null;
 
   constructor(customRules?: ArchitectureRule[]) {
     // Загружаем дефолтные правила
@@ -232,19 +255,30 @@ export class RulesEngine {
 
   /**
    * Проверить проект на соответствие правилам
+   *
+   * @param changed Узлы, у которых с прошлой проверки добавились, изменились
+   *   или удалились сам узел или исходящие рёбра. Если передан, графовые
+   *   правила синхронизируют только их, даже для нового объекта графа.
    */
   async check(
     graph: DependencyGraph,
     symbols: Map<string, Symbol>,
-    fileContents: Map<string, string>
+    fileContents: Map<string, string>,
+    changed?: Iterable<string>
   ): Promise<RulesCheckResult> {
     const violations: RuleViolation[] = [];
     const enabledRules = this.getEnabledRules();
 
     Logger.progress(`Checking ${enabledRules.length} architecture rules...`);
 
+    const graphViolations = this.checkGraphRules(
+      enabledRules.filter(rule => GRAPH_RULE_TYPES.has(rule.type)),
+      graph,
+      changed
+    );
+
     for (const rule of enabledRules) {
-      const ruleViolations = await this.checkRule(rule, graph, symbols, fileContents);
+      const ruleViolations = graphViolations.get(rule) ?? await this.checkRule(rule, graph, symbols, fileContents);
       violations.push(...ruleViolations);
     }
 
@@ -278,12 +312,6 @@ export class RulesEngine {
     switch (rule.type) {
       case 'no-circular':
         return this.checkNoCircular(rule, graph);
-      case 'no-import':
-        return this.checkNoImport(rule, graph);
-      case 'layer-boundary':
-        return this.checkLayerBoundary(rule, graph);
-      case 'max-dependencies':
-        return this.checkMaxDependencies(rule, graph);
       case 'max-file-size':
         return this.checkMaxFileSize(rule, fileContents);
       case 'max-function-length':
@@ -356,109 +384,223 @@ export class RulesEngine {
   }
 
   /**
-   * Проверка запрета импорта
+   * Проверка no-import, layer-boundary и max-dependencies.
+   *
+   * Пути файлов классифицируются по regex один раз на узел, граф и
+   * группы передаются в RuleEvaluator дельтами, так что повторная
+   * проверка после правки перепроверяет только изменённые узлы.
    */
-  private checkNoImport(rule: ArchitectureRule, graph: DependencyGraph): RuleViolation[] {
-    const violations: RuleViolation[] = [];
-    const { sourcePattern, targetPattern } = rule.config;
-
-    if (!sourcePattern || !targetPattern) return violations;
-
-    const sourceRegex = new RegExp(sourcePattern, 'i');
-    const targetRegex = new RegExp(targetPattern, 'i');
+  private checkGraphRules(
+    rules: ArchitectureRule[],
+    graph: DependencyGraph,
+    changed?: Iterable<string>
+  ): Map<ArchitectureRule, RuleViolation[]> {
+    const results = new Map<ArchitectureRule, RuleViolation[]>();
+    for (const rule of rules) results.set(rule, []);
+    if (rules.length === 0) return results;
+
+    const state = this.syncGraphState(rules, graph, changed);
+
+    // Правило, которое evaluator отверг, не должно молча проходить
+    for (const { rule, reason } of state.rejected) {
+      results.get(rule)!.push({
+        ruleId: rule.id,
+        ruleName: rule.name,
+        severity: 'error',
+        message: `Rule cannot be evaluated: ${reason}`,
+        file: '',
+        suggestion: 'Исправьте конфигурацию правила'
+      });
+    }
 
-    for (const [nodeId, edges] of graph.edges) {
-      const sourceNode = graph.nodes.get(nodeId);
-      if (!sourceNode || !sourceRegex.test(sourceNode.filePath)) continue;
+    for (const hit of state.evaluator.evaluate()) {
+      const rule = state.rules[hit.rule];
+      const sourceNode = graph.nodes.get(hit.from);
+      const targetNode = hit.to !== undefined ? graph.nodes.get(hit.to) : undefined;
+      const list = results.get(rule)!;
 
-      for (const edge of edges) {
-        const targetNode = graph.nodes.get(edge.to);
-        if (targetNode && targetRegex.test(targetNode.filePath)) {
-          violations.push({
-            ruleId: rule.id,
-            ruleName: rule.name,
-            severity: rule.severity,
-            message: `Forbidden import: ${sourceNode.filePath} -> ${targetNode.filePath}`,
-            file: sourceNode.filePath,
-            suggestion: `Перенесите необходимую логику или используйте dependency injection`
-          });
-        }
+      if (rule.type === 'no-import' && sourceNode && targetNode) {
+        list.push({
+          ruleId: rule.id,
+          ruleName: rule.name,
+          severity: rule.severity,
+          message: `Forbidden import: ${sourceNode.filePath} -> ${targetNode.filePath}`,
+          file: sourceNode.filePath,
+          suggestion: `Перенесите необходимую логику или используйте dependency injection`
+        });
+      } else if (rule.type === 'layer-boundary' && sourceNode && targetNode) {
+        const layers = rule.config.layers!;
+        const sourceLayer = layers[hit.sourceLayer!];
+        const targetLayer = layers[hit.targetLayer!];
+        list.push({
+          ruleId: rule.id,
+          ruleName: rule.name,
+          severity: rule.severity,
+          message: `Layer violation: ${sourceLayer.name} -> ${targetLayer.name} (${sourceNode.filePath} -> ${targetNode.filePath})`,
+          file: sourceNode.filePath,
+          suggestion: `Слой "${sourceLayer.name}" не должен зависеть от "${targetLayer.name}". Разрешено: ${sourceLayer.allowedDependencies.join(', ') || 'ничего'}`
+        });
+      } else if (rule.type === 'max-dependencies') {
+        const maxDeps = rule.config.maxValue || 10;
+        list.push({
+          ruleId: rule.id,
+          ruleName: rule.name,
+          severity: rule.severity,
+          message: `Too many dependencies: ${hit.count} (max: ${maxDeps})`,
+          file: sourceNode?.filePath || hit.from,
+          suggestion: 'Рассмотрите разделение модуля на более мелкие части или использование фасада'
+        });
       }
     }
 
-    return violations;
+    return results;
   }
 
   /**
-   * Проверка границ слоёв
+   * Создать или обновить RuleEvaluator для графа и набора правил
+   *
+   * Без изменений (тот же граф и graph.version) ничего не обходится; с
+   * changed обходятся только перечисленные узлы; иначе весь граф.
    */
-  private checkLayerBoundary(rule: ArchitectureRule, graph: DependencyGraph): RuleViolation[] {
-    const violations: RuleViolation[] = [];
-    const { layers } = rule.config;
-
-    if (!layers) return violations;
-
-    // Определяем слой для каждого файла
-    const getLayer = (filePath: string): LayerDefinition | undefined => {
-      return layers.find(layer => new RegExp(layer.pattern, 'i').test(filePath));
-    };
-
-    for (const [nodeId, edges] of graph.edges) {
-      const sourceNode = graph.nodes.get(nodeId);
-      if (!sourceNode) continue;
-
-      const sourceLayer = getLayer(sourceNode.filePath);
-      if (!sourceLayer) continue;
-
-      for (const edge of edges) {
-        const targetNode = graph.nodes.get(edge.to);
-        if (!targetNode) continue;
-
-        const targetLayer = getLayer(targetNode.filePath);
-        if (!targetLayer) continue;
+  private syncGraphState(
+    rules: ArchitectureRule[],
+    graph: DependencyGraph,
+    changed?: Iterable<string>
+  ): GraphRuleState {
+    const signature = JSON.stringify(rules.map(rule => [rule.id, rule.type, rule.config]));
+    const version = graph.version ?? 0;
+    let state = this.graphState;
+
+    if (!state || state.signature !== signature || (state.graph !== graph && !changed)) {
+      const evaluator = new RuleEvaluator();
+      const groups: GraphRuleState['groups'] = [];
+      const groupOf = new Map<string, number>();
+      const group = (pattern: string): number => {
+        let index = groupOf.get(pattern);
+        if (index === undefined) {
+          index = evaluator.addGroup();
+          groupOf.set(pattern, index);
+          groups.push({ regex: new RegExp(pattern, 'i'), group: index });
+        }
+        return index;
+      };
+
+      const evaluatorRules: ArchitectureRule[] = [];
+      const rejected: GraphRuleState['rejected'] = [];
+      for (const rule of rules) {
+        let index = -1;
+        let reason = 'invalid configuration';
+        if (rule.type === 'no-import') {
+          const { sourcePattern, targetPattern } = rule.config;
+          if (!sourcePattern || !targetPattern) continue;
+          index = evaluator.addForbiddenRule(group(sourcePattern), group(targetPattern));
+        } else if (rule.type === 'layer-boundary') {
+          const { layers } = rule.config;
+          if (!layers) continue;
+          if (layers.length > MAX_RULE_LAYERS) {
+            reason = `${layers.length} layers (at most ${MAX_RULE_LAYERS} supported)`;
+          }
+          // Зависимость внутри слоя с тем же именем всегда разрешена
+          index = evaluator.addLayerRule(layers.map(layer => ({
+            group: group(layer.pattern),
+            allowed: layers
+              .map((other, i) => (other.name === layer.name || layer.allowedDependencies.includes(other.name) ? i : -1))
+              .filter(i => i >= 0)
+          })));
+        } else {
+          index = evaluator.addMaxDependenciesRule(rule.config.maxValue || 10);
+        }
 
-        // Проверяем, разрешена ли зависимость
-        if (
-          sourceLayer.name !== targetLayer.name &&
-          !sourceLayer.allowedDependencies.includes(targetLayer.name)
-        ) {
-          violations.push({
-            ruleId: rule.id,
-            ruleName: rule.name,
-            severity: rule.severity,
-            message: `Layer violation: ${sourceLayer.name} -> ${targetLayer.name} (${sourceNode.filePath} -> ${targetNode.filePath})`,
-            file: sourceNode.filePath,
-            suggestion: `Слой "${sourceLayer.name}" не должен зависеть от "${targetLayer.name}". Разрешено: ${sourceLayer.allowedDependencies.join(', ') || 'ничего'}`
-          });
+        if (index < 0) {
+          Logger.error(`Rule ${rule.id} cannot be evaluated: ${reason}`);
+          rejected.push({ rule, reason });
+          continue;
         }
+        evaluatorRules[index] = rule;
       }
+
+      state = {
+        graph,
+        version: -1,
+        signature,
+        evaluator,
+        rules: evaluatorRules,
+        rejected,
+        groups,
+        paths: new Map(),
+        targets: new Map()
+      };
+      this.graphState = state;
+      // Новый evaluator: синхронизируется весь граф
+      changed = undefined;
+    } else if (!changed && state.version === version) {
+      return state;
     }
 
-    return violations;
-  }
+    const { evaluator, groups, paths, targets } = state;
+    const delta = changed ? Array.from(new Set(changed)) : null;
+
+    // Узлы: новые и переименованные классифицируются заново
+    const changedNodes: Array<{ id: string; path: string }> = [];
+    const removedNodes: string[] = [];
+    const syncNode = (id: string) => {
+      const node = graph.nodes.get(id);
+      if (node) {
+        if (paths.get(id) !== node.filePath) changedNodes.push({ id, path: node.filePath });
+      } else if (paths.has(id)) {
+        removedNodes.push(id);
+      }
+    };
+    if (delta) {
+      delta.forEach(syncNode);
+    } else {
+      for (const id of graph.nodes.keys()) syncNode(id);
+      for (const id of paths.keys()) {
+        if (!graph.nodes.has(id)) removedNodes.push(id);
+      }
+    }
 
-  /**
-   * Проверка максимального количества зависимостей
-   */
-  private checkMaxDependencies(rule: ArchitectureRule, graph: DependencyGraph): RuleViolation[] {
-    const violations: RuleViolation[] = [];
-    const maxDeps = rule.config.maxValue || 10;
+    evaluator.addNodes(changedNodes);
+    for (const { regex, group } of groups) {
+      const add: string[] = [];
+      const remove: string[] = [...removedNodes];
+      for (const { id, path } of changedNodes) {
+        (regex.test(path) ? add : remove).push(id);
+      }
+      if (add.length > 0 || remove.length > 0) evaluator.updateGroup(group, add, remove);
+    }
+    for (const { id, path } of changedNodes) paths.set(id, path);
+    for (const id of removedNodes) paths.delete(id);
+
+    // Рёбра: передаются только изменившиеся списки зависимостей
+    const syncEdges = (nodeId: string) => {
+      const edges = graph.edges.get(nodeId);
+      const previous = targets.get(nodeId);
+      if (!edges) {
+        if (previous) {
+          evaluator.setDependencies(nodeId, []);
+          targets.delete(nodeId);
+        }
+        return;
+      }
+      if (previous && previous.length === edges.length && edges.every((edge, i) => edge.to === previous[i])) return;
 
-    for (const [nodeId, edges] of graph.edges) {
-      if (edges.length > maxDeps) {
-        const node = graph.nodes.get(nodeId);
-        violations.push({
-          ruleId: rule.id,
-          ruleName: rule.name,
-          severity: rule.severity,
-          message: `Too many dependencies: ${edges.length} (max: ${maxDeps})`,
-          file: node?.filePath || nodeId,
-          suggestion: 'Рассмотрите разделение модуля на более мелкие части или использование фасада'
-        });
+      const next = edges.map(edge => edge.to);
+      evaluator.setDependencies(nodeId, next);
+      targets.set(nodeId, next);
+    };
+    if (delta) {
+      delta.forEach(syncEdges);
+    } else {
+      for (const nodeId of graph.edges.keys()) syncEdges(nodeId);
+      for (const nodeId of Array.from(targets.keys())) {
+        if (!graph.edges.has(nodeId)) syncEdges(nodeId);
       }
     }
 
-    return violations;
+    state.graph = graph;
+    state.version = version;
+    return state;
   }
 
   /**
@@ -10,16 +10,36 @@ import { SecurityAnalyzer } from '../analyzers/security.js';
 import { DeadCodeDetector } from '../analyzers/dead-code.js';
 import { DuplicationDetector } from '../analyzers/duplication.js';
 import { AINarrator } from '../analyzers/ai-narrator.js';
-import { ExportManager, type ExportData } from '../export/index.js';
+import { ExportManager, type ExportData, type StreamExportOptions } from '../export/index.js';
 import { createGraphStore, type GraphModule } from '../graph/index.js';
+import { attachSharedIndex } from '../native/daemon.js';
+import type { SharedFileIndex } from '../native/indexer.js';
 import { SearchIndex } from '../search/index.js';
 import { FileUtils } from '../utils/file-utils.js';
 import { Logger } from '../utils/logger.js';
 import type { DependencyGraph, Symbol, ChangeImpact, Change, ASTNode } from '../types/index.js';
 import type { LLMPlugin } from '../plugins/types.js';
+import type { Writable } from 'stream';
 import { readFileSync, existsSync } from 'fs';
+import { createHash } from 'crypto';
+import os from 'os';
 import path from 'path';
 
+/**
+ * Server data directory: caches live here, never inside the analysed repository
+ */
+function dataDir(): string {
+  return process.env.ARCHICORE_DATA_DIR || path.join(os.homedir(), '.archicore');
+}
+
+/**
+ * Per-project cache directory, keyed by the absolute project path
+ */
+function projectCacheDir(rootDir: string): string {
+  const key = createHash('sha256').update(path.resolve(rootDir)).digest('hex').slice(0, 16);
+  return path.join(dataDir(), 'cache', key);
+}
+
 export interface ProjectStatus {
   indexed: boolean;
   rootDir: string | null;
@@ -44,6 +64,8 @@ export class ProjectManager {
 
   private graphModule: GraphModule | null = null;
   private rootDir: string | null = null;
+  // Index published by a daemon serving rootDir, if any
+  private sharedIndex: SharedFileIndex | null = null;
   private graph: DependencyGraph | null = null;
   private symbolsMap = new Map<string, Symbol>();
   private astsMap = new Map<string, ASTNode>();
@@ -60,6 +82,20 @@ export class ProjectManager {
     this.graphModule = await createGraphStore();
   }
 
+  /**
+   * Files to analyse: from the daemon's shared index when a daemon serves
+   * the root, so the tree is not walked again, otherwise from a scan
+   */
+  private async listFiles(rootDir: string): Promise<string[]> {
+    this.sharedIndex?.close();
+    this.sharedIndex = await attachSharedIndex(rootDir);
+    if (this.sharedIndex) {
+      Logger.info(`Using the daemon's shared index (epoch ${this.sharedIndex.epoch()})`);
+      return FileUtils.filesFromIndex(rootDir, this.sharedIndex.getAll());
+    }
+    return FileUtils.getAllFiles(rootDir);
+  }
+
   /**
    * Index a project directory
    */
@@ -71,11 +107,13 @@ export class ProjectManager {
     };
 
     report('Scanning files...');
-    const files = await FileUtils.getAllFiles(rootDir);
+    const files = await this.listFiles(rootDir);
     report(`Found ${files.length} files`);
 
     report('Parsing ASTs...');
-    this.codeIndex = new CodeIndex(rootDir);
+    this.codeIndex = new CodeIndex(rootDir, {
+      parseCachePath: path.join(projectCacheDir(rootDir), 'parse-cache.bin'),
+    });
     this.astsMap = await this.codeIndex.parseProject((current, total, file) => {
       report(`Parsing [${current}/${total}]: ${file}`);
     });
@@ -195,17 +233,30 @@ export class ProjectManager {
   // ===== Export =====
 
   async exportAs(format: 'json' | 'html' | 'markdown' | 'csv' | 'graphml') {
+    return this.exportManager.export(this.exportData(), { format });
+  }
+
+  /**
+   * Stream an export into `output` without building the document in memory
+   */
+  async exportTo(
+    format: 'json' | 'html' | 'markdown' | 'csv' | 'graphml',
+    output: Writable,
+    options: StreamExportOptions = {}
+  ): Promise<number> {
+    return this.exportManager.exportToStream(this.exportData(), { format }, output, options);
+  }
+
+  private exportData(): ExportData {
     if (!this.graph) throw new Error('Project not indexed');
 
-    const data: ExportData = {
+    return {
       projectName: this.rootDir || 'unknown',
       exportDate: new Date().toISOString(),
       version: '1.0.0',
       graph: this.graph,
       symbols: this.symbolsMap,
     };
-
-    return this.exportManager.export(data, { format });
   }
 
   // ===== Status =====
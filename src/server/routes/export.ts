@@ -20,8 +20,6 @@ export function exportRoutes(pm: ProjectManager): Router {
     }
 
     try {
-      const result = await pm.exportAs(format);
-
       const contentTypes: Record<string, string> = {
         json: 'application/json',
         html: 'text/html',
@@ -30,15 +28,25 @@ export function exportRoutes(pm: ProjectManager): Router {
         graphml: 'application/xml',
       };
 
-      res.setHeader('Content-Type', contentTypes[format] || 'text/plain');
+      // ?gzip=true downloads a .gz file; otherwise the compression middleware
+      // negotiates transfer encoding as for any other response
+      const gzip = req.query.gzip === 'true';
+      res.setHeader('Content-Type', gzip ? 'application/gzip' : contentTypes[format] || 'text/plain');
 
-      if (req.query.download === 'true') {
+      if (req.query.download === 'true' || gzip) {
         const ext = format === 'markdown' ? 'md' : format;
-        res.setHeader('Content-Disposition', `attachment; filename="archicore-report.${ext}"`);
+        res.setHeader('Content-Disposition', `attachment; filename="archicore-report.${ext}${gzip ? '.gz' : ''}"`);
       }
 
-      res.send(result);
+      // ?minify=true drops JSON indentation
+      await pm.exportTo(format, res, { gzip, minify: req.query.minify === 'true' });
     } catch (error) {
+      // Once streaming has started the status line is gone; just drop the connection
+      if (res.headersSent) {
+        res.destroy();
+        return;
+      }
+      res.removeHeader('Content-Disposition');
       res.status(500).json({ error: String(error) });
     }
   });
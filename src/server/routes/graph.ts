@@ -4,6 +4,7 @@
 
 import { Router, type Request, type Response } from 'express';
 import type { ProjectManager } from '../project-manager.js';
+import type { RankMetric } from '../../graph/graph-queries.js';
 
 export function graphRoutes(pm: ProjectManager): Router {
   const router = Router();
@@ -45,6 +46,26 @@ export function graphRoutes(pm: ProjectManager): Router {
     res.json(results);
   });
 
+  router.get('/ranking', async (req: Request, res: Response): Promise<void> => {
+    const queries = pm.getGraphQueries();
+    if (!queries) { res.status(503).json({ error: 'Graph not initialized' }); return; }
+    const metric = (req.query.metric as string || 'pagerank') as RankMetric;
+    if (metric !== 'pagerank' && metric !== 'betweenness' && metric !== 'core') {
+      res.status(400).json({ error: 'metric must be pagerank, betweenness or core' });
+      return;
+    }
+    const limit = parseInt(req.query.limit as string) || 10;
+    const results = await queries.rankFiles(metric, limit);
+    res.json(results);
+  });
+
+  router.get('/clusters', async (_req: Request, res: Response): Promise<void> => {
+    const queries = pm.getGraphQueries();
+    if (!queries) { res.status(503).json({ error: 'Graph not initialized' }); return; }
+    const results = await queries.dependencyClusters();
+    res.json(results);
+  });
+
   router.get('/orphans', async (_req: Request, res: Response): Promise<void> => {
     const queries = pm.getGraphQueries();
     if (!queries) { res.status(503).json({ error: 'Graph not initialized' }); return; }
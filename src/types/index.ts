@@ -61,6 +61,8 @@ export interface Import {
 export interface DependencyGraph {
   nodes: Map<string, GraphNode>;
   edges: Map<string, GraphEdge[]>;
+  /** Bumped on every node or edge mutation; caches keyed on the graph compare it */
+  version?: number;
 }
 
 export interface GraphNode {
@@ -546,6 +546,121 @@ const LIBRARY_IGNORE_PATTERNS = [
   '**/*.eot',
 ];
 
+/**
+ * Glob (*, **, ?) как фрагмент регулярного выражения; пути относительно корня
+ */
+function globSource(pattern: string): string {
+  let source = '';
+  for (let i = 0; i < pattern.length; i++) {
+    const c = pattern[i];
+    if (c === '*' && pattern[i + 1] === '*') {
+      // '**/' — любое число каталогов, в том числе ни одного
+      if (pattern[i + 2] === '/') {
+        source += '(?:.*/)?';
+        i += 2;
+      } else {
+        source += '.*';
+        i += 1;
+      }
+    } else if (c === '*') {
+      source += '[^/]*';
+    } else if (c === '?') {
+      source += '[^/]';
+    } else {
+      source += c.replace(/[.+^${}()|[\]\\]/g, '\\$&');
+    }
+  }
+  return source;
+}
+
+/**
+ * Один RegExp на весь список шаблонов: проверка пути за один проход
+ */
+function compileGlobs(patterns: string[]): RegExp {
+  return new RegExp(`^(?:${patterns.map(globSource).join('|')})$`);
+}
+
+// Файлы, которые анализируются (getAllFiles по умолчанию)
+const SOURCE_FILE_PATTERNS = [
+  // JavaScript/TypeScript ecosystem
+  '**/*.ts', '**/*.js', '**/*.tsx', '**/*.jsx', '**/*.mjs', '**/*.cjs',
+  '**/*.vue', '**/*.svelte', '**/*.astro',
+
+  // Python
+  '**/*.py', '**/*.pyw', '**/*.pyi',
+
+  // Systems languages
+  '**/*.go',                                       // Go
+  '**/*.rs',                                       // Rust
+  '**/*.zig',                                      // Zig
+  '**/*.nim',                                      // Nim
+  '**/*.c', '**/*.h', '**/*.cpp', '**/*.hpp', '**/*.cc', '**/*.cxx', '**/*.hh', // C/C++
+
+  // JVM languages
+  '**/*.java',                                     // Java
+  '**/*.kt', '**/*.kts',                          // Kotlin
+  '**/*.scala', '**/*.sc',                        // Scala
+  '**/*.groovy', '**/*.gradle',                   // Groovy
+  '**/*.clj', '**/*.cljs', '**/*.cljc',          // Clojure
+
+  // .NET languages
+  '**/*.cs',                                       // C#
+  '**/*.fs', '**/*.fsx',                          // F#
+  '**/*.vb',                                       // Visual Basic
+
+  // Web/scripting
+  '**/*.php',                                      // PHP
+  '**/*.rb', '**/*.erb', '**/*.rake',            // Ruby
+  '**/*.pl', '**/*.pm',                          // Perl
+  '**/*.lua',                                      // Lua
+
+  // Mobile
+  '**/*.swift',                                    // Swift
+  '**/*.dart',                                     // Dart/Flutter
+  '**/*.m', '**/*.mm',                           // Objective-C
+
+  // Functional languages
+  '**/*.hs', '**/*.lhs',                          // Haskell
+  '**/*.ml', '**/*.mli',                          // OCaml
+  '**/*.erl', '**/*.hrl',                         // Erlang
+  '**/*.ex', '**/*.exs',                          // Elixir
+  '**/*.jl',                                       // Julia
+  '**/*.r', '**/*.R',                             // R
+
+  // Other compiled
+  '**/*.cr',                                       // Crystal
+
+  // Markup/styles
+  '**/*.html', '**/*.htm',                         // HTML
+  '**/*.css', '**/*.scss', '**/*.sass', '**/*.less', '**/*.styl', // CSS
+  '**/*.xml', '**/*.xsl', '**/*.xslt',            // XML
+
+  // Data/config
+  '**/*.json',                                     // JSON
+  '**/*.yaml', '**/*.yml',                         // YAML
+  '**/*.toml',                                     // TOML
+  '**/*.ini', '**/*.cfg', '**/*.conf',            // INI/Config
+
+  // Database/query
+  '**/*.sql', '**/*.prisma',                      // SQL/Prisma
+  '**/*.graphql', '**/*.gql',                     // GraphQL
+
+  // Infrastructure
+  '**/*.tf', '**/*.tfvars',                       // Terraform
+  '**/*.proto',                                    // Protobuf
+  '**/Dockerfile', '**/*.dockerfile',             // Docker
+  '**/Makefile', '**/*.mk',                       // Make
+  '**/CMakeLists.txt', '**/*.cmake',              // CMake
+
+  // Shell/scripting
+  '**/*.sh', '**/*.bash', '**/*.zsh',             // Unix shell
+  '**/*.ps1', '**/*.psm1', '**/*.psd1',           // PowerShell
+  '**/*.bat', '**/*.cmd',                          // Windows batch
+
+  // Documentation
+  '**/*.md', '**/*.markdown', '**/*.mdx', '**/*.rst'  // Markdown/RST
+];
+
 export class FileUtils {
   static async readFileContent(filePath: string): Promise<string> {
     return await readFile(filePath, 'utf-8');
@@ -558,85 +673,7 @@ export class FileUtils {
 
   static async getAllFiles(
     rootDir: string,
-    patterns: string[] = [
-      // JavaScript/TypeScript ecosystem
-      '**/*.ts', '**/*.js', '**/*.tsx', '**/*.jsx', '**/*.mjs', '**/*.cjs',
-      '**/*.vue', '**/*.svelte', '**/*.astro',
-
-      // Python
-      '**/*.py', '**/*.pyw', '**/*.pyi',
-
-      // Systems languages
-      '**/*.go',                                       // Go
-      '**/*.rs',                                       // Rust
-      '**/*.zig',                                      // Zig
-      '**/*.nim',                                      // Nim
-      '**/*.c', '**/*.h', '**/*.cpp', '**/*.hpp', '**/*.cc', '**/*.cxx', '**/*.hh', // C/C++
-
-      // JVM languages
-      '**/*.java',                                     // Java
-      '**/*.kt', '**/*.kts',                          // Kotlin
-      '**/*.scala', '**/*.sc',                        // Scala
-      '**/*.groovy', '**/*.gradle',                   // Groovy
-      '**/*.clj', '**/*.cljs', '**/*.cljc',          // Clojure
-
-      // .NET languages
-      '**/*.cs',                                       // C#
-      '**/*.fs', '**/*.fsx',                          // F#
-      '**/*.vb',                                       // Visual Basic
-
-      // Web/scripting
-      '**/*.php',                                      // PHP
-      '**/*.rb', '**/*.erb', '**/*.rake',            // Ruby
-      '**/*.pl', '**/*.pm',                          // Perl
-      '**/*.lua',                                      // Lua
-
-      // Mobile
-      '**/*.swift',                                    // Swift
-      '**/*.dart',                                     // Dart/Flutter
-      '**/*.m', '**/*.mm',                           // Objective-C
-
-      // Functional languages
-      '**/*.hs', '**/*.lhs',                          // Haskell
-      '**/*.ml', '**/*.mli',                          // OCaml
-      '**/*.erl', '**/*.hrl',                         // Erlang
-      '**/*.ex', '**/*.exs',                          // Elixir
-      '**/*.jl',                                       // Julia
-      '**/*.r', '**/*.R',                             // R
-
-      // Other compiled
-      '**/*.cr',                                       // Crystal
-
-      // Markup/styles
-      '**/*.html', '**/*.htm',                         // HTML
-      '**/*.css', '**/*.scss', '**/*.sass', '**/*.less', '**/*.styl', // CSS
-      '**/*.xml', '**/*.xsl', '**/*.xslt',            // XML
-
-      // Data/config
-      '**/*.json',                                     // JSON
-      '**/*.yaml', '**/*.yml',                         // YAML
-      '**/*.toml',                                     // TOML
-      '**/*.ini', '**/*.cfg', '**/*.conf',            // INI/Config
-
-      // Database/query
-      '**/*.sql', '**/*.prisma',                      // SQL/Prisma
-      '**/*.graphql', '**/*.gql',                     // GraphQL
-
-      // Infrastructure
-      '**/*.tf', '**/*.tfvars',                       // Terraform
-      '**/*.proto',                                    // Protobuf
-      '**/Dockerfile', '**/*.dockerfile',             // Docker
-      '**/Makefile', '**/*.mk',                       // Make
-      '**/CMakeLists.txt', '**/*.cmake',              // CMake
-
-      // Shell/scripting
-      '**/*.sh', '**/*.bash', '**/*.zsh',             // Unix shell
-      '**/*.ps1', '**/*.psm1', '**/*.psd1',           // PowerShell
-      '**/*.bat', '**/*.cmd',                          // Windows batch
-
-      // Documentation
-      '**/*.md', '**/*.markdown', '**/*.mdx', '**/*.rst'  // Markdown/RST
-    ]
+    patterns: string[] = SOURCE_FILE_PATTERNS
   ): Promise<string[]> {
     // Resolve to absolute path
     const resolvedPath = resolve(rootDir);
@@ -725,6 +762,23 @@ export class FileUtils {
     return filteredFiles;
   }
 
+  /**
+   * Те же файлы, что и getAllFiles, но из готового индекса (например,
+   * SharedFileIndex демона) вместо обхода дерева
+   */
+  static filesFromIndex(
+    rootDir: string,
+    entries: Array<{ path: string; size: number }>,
+    patterns: string[] = SOURCE_FILE_PATTERNS
+  ): string[] {
+    const resolvedPath = resolve(rootDir);
+    const include = compileGlobs(patterns);
+    const ignore = compileGlobs(LIBRARY_IGNORE_PATTERNS);
+    return entries
+      .filter(entry => entry.size <= MAX_FILE_SIZE && include.test(entry.path) && !ignore.test(entry.path))
+      .map(entry => join(resolvedPath, entry.path));
+  }
+
   static getLanguageFromExtension(filePath: string): string {
     const ext = extname(filePath).toLowerCase();
     const filename = filePath.split(/[/\\]/).pop()?.toLowerCase() || '';